@@ -31,8 +31,8 @@ function Write-Status($msg) {
     Write-Host $msg
 }
 
-function Build-Object($source, $extraFlags) {
-    $objName = [System.IO.Path]::GetFileNameWithoutExtension($source)
+function Build-Object($source, $extraFlags, $objSuffix = "") {
+    $objName = [System.IO.Path]::GetFileNameWithoutExtension($source) + $objSuffix
     $objPath = "$BuildDir\$objName.o"
 
     Write-Status "Compiling $source..."
@@ -103,14 +103,18 @@ try {
     Write-Status "Built: $BinDir\simple_am_receiver.exe"
 
     #==========================================================================
-    # 2. waterfall.exe (22 object files)
+    # 2. waterfall.exe (33 object files)
     #==========================================================================
     Write-Status "Building waterfall..."
     $kissObj = Build-Object "src\kiss_fft.c" @()
     $wwvClockObj = Build-Object "tools\wwv_clock.c" @()
-    $channelFiltersObj = Build-Object "tools\channel_filters.c" @()
+    $fftFilterBankObj = Build-Object "tools\fft_filter_bank.c" @()
+    $detectorRateObj = Build-Object "tools\detector_rate.c" @()
+    $blockNormObj = Build-Object "tools\block_normalizer.c" @()
+    $cmdTableObj = Build-Object "src\cmd_table.c" @()
     $tickCombFilterObj = Build-Object "tools\tick_comb_filter.c" @()
     $tickDetectorObj = Build-Object "tools\tick_detector.c" @()
+    $dualStationObj = Build-Object "tools\dual_station_detector.c" @()
     $markerDetectorObj = Build-Object "tools\marker_detector.c" @()
     $slowMarkerDetectorObj = Build-Object "tools\slow_marker_detector.c" @()
     $markerCorrelatorObj = Build-Object "tools\marker_correlator.c" @()
@@ -119,6 +123,7 @@ try {
     $tickCorrelatorObj = Build-Object "tools\tick_correlator.c" @()
     $subcarrierDetectorObj = Build-Object "tools\subcarrier_detector.c" @()
     $bcdEnvelopeObj = Build-Object "tools\bcd_envelope.c" @()
+    $subcarrierFrontendObj = Build-Object "tools\subcarrier_frontend.c" @()
     $bcdDecoderObj = Build-Object "tools\bcd_decoder.c" @()
     $bcdTimeDetectorObj = Build-Object "tools\bcd_time_detector.c" @()
     $bcdFreqDetectorObj = Build-Object "tools\bcd_freq_detector.c" @()
@@ -127,14 +132,24 @@ try {
     $waterfallDspObj = Build-Object "tools\waterfall_dsp.c" @()
     $waterfallAudioObj = Build-Object "tools\waterfall_audio.c" @()
     $waterfallTelemObj = Build-Object "tools\waterfall_telemetry.c" @()
+    $detectorParamsObj = Build-Object "tools\detector_params.c" @()
+    $eventMergeObj = Build-Object "tools\event_merge.c" @()
+    $iqEventsObj = Build-Object "src\iq_events.c" @()
+    $iqClientObj = Build-Object "src\iq_client.c" @()
+    $relayMcastObj = Build-Object "src\relay_mcast.c" @()
+    $iqEncodingObj = Build-Object "src\iq_encoding.c" @()
+    $dspQ15Obj = Build-Object "src\dsp_q15.c" @()
     $waterfallObj = Build-Object "tools\waterfall.c" @("-I`"$SDL2Include`"")
 
     Write-Status "Linking waterfall.exe..."
     $waterfallObjs = @(
         "`"$waterfallObj`"",
-        "`"$channelFiltersObj`"",
+        "`"$fftFilterBankObj`"",
+        "`"$detectorRateObj`"",
+        "`"$blockNormObj`"",
         "`"$tickCombFilterObj`"",
         "`"$tickDetectorObj`"",
+        "`"$dualStationObj`"",
         "`"$markerDetectorObj`"",
         "`"$slowMarkerDetectorObj`"",
         "`"$markerCorrelatorObj`"",
@@ -143,6 +158,7 @@ try {
         "`"$tickCorrelatorObj`"",
         "`"$subcarrierDetectorObj`"",
         "`"$bcdEnvelopeObj`"",
+        "`"$subcarrierFrontendObj`"",
         "`"$bcdDecoderObj`"",
         "`"$bcdTimeDetectorObj`"",
         "`"$bcdFreqDetectorObj`"",
@@ -152,6 +168,13 @@ try {
         "`"$waterfallDspObj`"",
         "`"$waterfallAudioObj`"",
         "`"$waterfallTelemObj`"",
+        "`"$detectorParamsObj`"",
+        "`"$eventMergeObj`"",
+        "`"$iqEventsObj`"",
+        "`"$iqClientObj`"",
+        "`"$relayMcastObj`"",
+        "`"$iqEncodingObj`"",
+        "`"$cmdTableObj`"",
         "`"$kissObj`""
     )
     $waterfallLdflags = @("-L`"$SDL2Lib`"", "-lmingw32", "-lSDL2main", "-lSDL2", "-lm", "-lws2_32", "-lwinmm")
@@ -178,15 +201,18 @@ try {
     #==========================================================================
     Write-Status "Building signal_splitter..."
     $signalSplitterObj = Build-Object "tools\signal_splitter.c" @()
+    $splitStageObj = Build-Object "tools\split_stage.c" @()
+    $noiseBlankerObj = Build-Object "src\noise_blanker.c" @()
 
     Write-Status "Linking signal_splitter.exe..."
-    $cmd = @($CC, "-o", "`"$BinDir\signal_splitter.exe`"", "`"$signalSplitterObj`"", "`"$waterfallDspObj`"", "-lm", "-lws2_32")
+    $cmd = @($CC, "-o", "`"$BinDir\signal_splitter.exe`"", "`"$signalSplitterObj`"", "`"$splitStageObj`"", "`"$noiseBlankerObj`"", "`"$waterfallDspObj`"", "`"$iqEventsObj`"", "`"$iqClientObj`"", "`"$relayMcastObj`"", "`"$iqEncodingObj`"", "`"$dspQ15Obj`"", "-lm", "-lws2_32")
     & $cmd[0] $cmd[1..($cmd.Length-1)]
     if ($LASTEXITCODE -ne 0) { throw "Linking failed for signal_splitter" }
     Write-Status "Built: $BinDir\signal_splitter.exe"
 
     #==========================================================================
-    # 5. test_tcp_commands.exe
+    # 5. test_tcp_commands.exe, test_cmd_table.exe, test_rtl_tcp.exe, test_notify_queue.exe, test_iq_events.exe,
+    #    test_iq_framer.exe, test_iq_client.exe, test_relay_mcast.exe, test_iq_encoding.exe, test_dsp_q15.exe
     #==========================================================================
     Write-Status "Building test_tcp_commands..."
     $tcpCmdObj = Build-Object "src\tcp_commands.c" @()
@@ -194,11 +220,95 @@ try {
     $sdrStubsObj = Build-Object "test\sdr_stubs.c" @()
 
     Write-Status "Linking test_tcp_commands.exe..."
-    $cmd = @($CC, "-o", "`"$BinDir\test_tcp_commands.exe`"", "`"$testTcpObj`"", "`"$tcpCmdObj`"", "`"$sdrStubsObj`"", "-lm")
+    $cmd = @($CC, "-o", "`"$BinDir\test_tcp_commands.exe`"", "`"$testTcpObj`"", "`"$tcpCmdObj`"", "`"$cmdTableObj`"", "`"$sdrStubsObj`"", "-lm")
     & $cmd[0] $cmd[1..($cmd.Length-1)]
     if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_tcp_commands" }
     Write-Status "Built: $BinDir\test_tcp_commands.exe"
 
+    Write-Status "Building test_cmd_table..."
+    $testCmdTableObj = Build-Object "test\test_cmd_table.c" @()
+
+    Write-Status "Linking test_cmd_table.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_cmd_table.exe`"", "`"$testCmdTableObj`"", "`"$cmdTableObj`"", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_cmd_table" }
+    Write-Status "Built: $BinDir\test_cmd_table.exe"
+
+    Write-Status "Building test_rtl_tcp..."
+    $rtlTcpObj = Build-Object "src\rtl_tcp.c" @()
+    $testRtlTcpObj = Build-Object "test\test_rtl_tcp.c" @()
+
+    Write-Status "Linking test_rtl_tcp.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_rtl_tcp.exe`"", "`"$testRtlTcpObj`"", "`"$rtlTcpObj`"", "`"$tcpCmdObj`"", "`"$cmdTableObj`"", "`"$sdrStubsObj`"", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_rtl_tcp" }
+    Write-Status "Built: $BinDir\test_rtl_tcp.exe"
+
+    Write-Status "Building test_notify_queue..."
+    $notifyQueueObj = Build-Object "src\notify_queue.c" @()
+    $testNotifyObj = Build-Object "test\test_notify_queue.c" @()
+
+    Write-Status "Linking test_notify_queue.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_notify_queue.exe`"", "`"$testNotifyObj`"", "`"$notifyQueueObj`"", "-lpthread")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_notify_queue" }
+    Write-Status "Built: $BinDir\test_notify_queue.exe"
+
+    Write-Status "Building test_iq_events..."
+    $testIqEventsObj = Build-Object "test\test_iq_events.c" @()
+
+    Write-Status "Linking test_iq_events.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_iq_events.exe`"", "`"$testIqEventsObj`"", "`"$iqEventsObj`"", "-lm", "-lpthread")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_iq_events" }
+    Write-Status "Built: $BinDir\test_iq_events.exe"
+
+    Write-Status "Building test_iq_framer..."
+    $iqFramerObj = Build-Object "src\iq_framer.c" @()
+    $testIqFramerObj = Build-Object "test\test_iq_framer.c" @()
+
+    Write-Status "Linking test_iq_framer.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_iq_framer.exe`"", "`"$testIqFramerObj`"", "`"$iqFramerObj`"", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_iq_framer" }
+    Write-Status "Built: $BinDir\test_iq_framer.exe"
+
+    Write-Status "Building test_iq_client..."
+    $testIqClientObj = Build-Object "test\test_iq_client.c" @()
+
+    Write-Status "Linking test_iq_client.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_iq_client.exe`"", "`"$testIqClientObj`"", "`"$iqClientObj`"", "`"$relayMcastObj`"", "`"$iqEncodingObj`"", "-lws2_32", "-lpthread")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_iq_client" }
+    Write-Status "Built: $BinDir\test_iq_client.exe"
+
+    Write-Status "Building test_relay_mcast..."
+    $testRelayMcastObj = Build-Object "test\test_relay_mcast.c" @()
+
+    Write-Status "Linking test_relay_mcast.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_relay_mcast.exe`"", "`"$testRelayMcastObj`"", "`"$relayMcastObj`"", "`"$iqClientObj`"", "`"$iqEncodingObj`"", "-lws2_32", "-lpthread")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_relay_mcast" }
+    Write-Status "Built: $BinDir\test_relay_mcast.exe"
+
+    Write-Status "Building test_iq_encoding..."
+    $testIqEncodingObj = Build-Object "test\test_iq_encoding.c" @()
+
+    Write-Status "Linking test_iq_encoding.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_iq_encoding.exe`"", "`"$testIqEncodingObj`"", "`"$iqEncodingObj`"", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_iq_encoding" }
+    Write-Status "Built: $BinDir\test_iq_encoding.exe"
+
+    Write-Status "Building test_dsp_q15..."
+    $testDspQ15Obj = Build-Object "test\test_dsp_q15.c" @()
+
+    Write-Status "Linking test_dsp_q15.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_dsp_q15.exe`"", "`"$testDspQ15Obj`"", "`"$dspQ15Obj`"", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_dsp_q15" }
+    Write-Status "Built: $BinDir\test_dsp_q15.exe"
+
     #==========================================================================
     # 6. test_telemetry.exe
     #==========================================================================
@@ -221,7 +331,7 @@ try {
 
     Write-Status "Linking sdr_server.exe..."
     $serverLdflags = @("-lws2_32", "-lm", "-lwinmm")
-    $cmd = @($CC, "-o", "`"$BinDir\sdr_server.exe`"", "`"$sdrServerObj`"", "`"$tcpCmdObj`"", "`"$sdrStreamObj`"", "`"$sdrDeviceObj`"", "`"$sdrplayStubObj`"") + $serverLdflags
+    $cmd = @($CC, "-o", "`"$BinDir\sdr_server.exe`"", "`"$sdrServerObj`"", "`"$tcpCmdObj`"", "`"$cmdTableObj`"", "`"$rtlTcpObj`"", "`"$notifyQueueObj`"", "`"$iqEventsObj`"", "`"$iqFramerObj`"", "`"$sdrStreamObj`"", "`"$sdrDeviceObj`"", "`"$sdrplayStubObj`"") + $serverLdflags
     & $cmd[0] $cmd[1..($cmd.Length-1)]
     if ($LASTEXITCODE -ne 0) { throw "Linking failed for sdr_server" }
     Write-Status "Built: $BinDir\sdr_server.exe"
@@ -238,7 +348,278 @@ try {
     if ($LASTEXITCODE -ne 0) { throw "Linking failed for telem_logger" }
     Write-Status "Built: $BinDir\telem_logger.exe"
 
-    Write-Status "CI Build complete (8 tools)."
+    #==========================================================================
+    # 9. iqr_convert.exe, test_iqr_export.exe, test_decimator.exe
+    #==========================================================================
+    Write-Status "Building iqr_convert..."
+    $iqrExportObj = Build-Object "src\iqr_export.c" @()
+    $iqrMetaObj = Build-Object "src\iqr_meta.c" @()
+    $decimatorObj = Build-Object "src\decimator.c" @()
+    $iqrConvertObj = Build-Object "tools\iqr_convert.c" @()
+
+    Write-Status "Linking iqr_convert.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\iqr_convert.exe`"", "`"$iqrConvertObj`"", "`"$iqrExportObj`"", "`"$iqrMetaObj`"", "`"$decimatorObj`"", "-lm", "-lpthread")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for iqr_convert" }
+    Write-Status "Built: $BinDir\iqr_convert.exe"
+
+    Write-Status "Building test_iqr_export..."
+    $testIqrExportObj = Build-Object "test\test_iqr_export.c" @()
+
+    Write-Status "Linking test_iqr_export.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_iqr_export.exe`"", "`"$testIqrExportObj`"", "`"$iqrExportObj`"", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_iqr_export" }
+    Write-Status "Built: $BinDir\test_iqr_export.exe"
+
+    Write-Status "Building test_decimator..."
+    $testDecimatorObj = Build-Object "test\test_decimator.c" @()
+
+    Write-Status "Linking test_decimator.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_decimator.exe`"", "`"$testDecimatorObj`"", "`"$decimatorObj`"", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_decimator" }
+    Write-Status "Built: $BinDir\test_decimator.exe"
+
+    #==========================================================================
+    # 10. iq_client_bench.exe
+    #==========================================================================
+    Write-Status "Building iq_client_bench..."
+    $iqClientBenchObj = Build-Object "tools\iq_client_bench.c" @()
+
+    Write-Status "Linking iq_client_bench.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\iq_client_bench.exe`"", "`"$iqClientBenchObj`"", "`"$iqClientObj`"", "`"$relayMcastObj`"", "`"$iqEncodingObj`"", "-lws2_32", "-lpthread")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for iq_client_bench" }
+    Write-Status "Built: $BinDir\iq_client_bench.exe"
+
+    #==========================================================================
+    # 11. iq_encoding_bench.exe
+    #==========================================================================
+    Write-Status "Building iq_encoding_bench..."
+    $iqEncodingBenchObj = Build-Object "tools\iq_encoding_bench.c" @()
+
+    Write-Status "Linking iq_encoding_bench.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\iq_encoding_bench.exe`"", "`"$iqEncodingBenchObj`"", "`"$iqEncodingObj`"", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for iq_encoding_bench" }
+    Write-Status "Built: $BinDir\iq_encoding_bench.exe"
+
+    #==========================================================================
+    # 12. bcd_subband_bench.exe, test_iq_recorder.exe, test_crc32c.exe
+    #==========================================================================
+    Write-Status "Building bcd_subband_bench..."
+    $iqRecorderObj = Build-Object "src\iq_recorder.c" @()
+    $crc32cObj = Build-Object "src\crc32c.c" @()
+    $bcdSubbandBenchObj = Build-Object "tools\bcd_subband_bench.c" @()
+
+    Write-Status "Linking bcd_subband_bench.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\bcd_subband_bench.exe`"", "`"$bcdSubbandBenchObj`"", "`"$fftFilterBankObj`"", "`"$detectorRateObj`"", "`"$bcdTimeDetectorObj`"", "`"$bcdFreqDetectorObj`"", "`"$waterfallDspObj`"", "`"$waterfallTelemObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"", "`"$kissObj`"", "-lws2_32", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for bcd_subband_bench" }
+    Write-Status "Built: $BinDir\bcd_subband_bench.exe"
+
+    Write-Status "Building test_iq_recorder..."
+    $testIqRecorderObj = Build-Object "test\test_iq_recorder.c" @()
+
+    Write-Status "Linking test_iq_recorder.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_iq_recorder.exe`"", "`"$testIqRecorderObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_iq_recorder" }
+    Write-Status "Built: $BinDir\test_iq_recorder.exe"
+
+    Write-Status "Building test_crc32c..."
+    $testCrc32cObj = Build-Object "test\test_crc32c.c" @()
+
+    Write-Status "Linking test_crc32c.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_crc32c.exe`"", "`"$testCrc32cObj`"", "`"$crc32cObj`"")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_crc32c" }
+    Write-Status "Built: $BinDir\test_crc32c.exe"
+
+    #==========================================================================
+    # 13. normalizer_bench.exe
+    #==========================================================================
+    Write-Status "Building normalizer_bench..."
+    $normalizerBenchObj = Build-Object "tools\normalizer_bench.c" @()
+
+    Write-Status "Linking normalizer_bench.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\normalizer_bench.exe`"", "`"$normalizerBenchObj`"", "`"$blockNormObj`"", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for normalizer_bench" }
+    Write-Status "Built: $BinDir\normalizer_bench.exe"
+
+    #==========================================================================
+    # 14. cmd_bench.exe
+    #==========================================================================
+    Write-Status "Building cmd_bench..."
+    $cmdBenchObj = Build-Object "tools\cmd_bench.c" @()
+
+    Write-Status "Linking cmd_bench.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\cmd_bench.exe`"", "`"$cmdBenchObj`"", "`"$cmdTableObj`"", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for cmd_bench" }
+    Write-Status "Built: $BinDir\cmd_bench.exe"
+
+    #==========================================================================
+    # 15. iqr_verify.exe
+    #==========================================================================
+    Write-Status "Building iqr_verify..."
+    $iqrVerifyObj = Build-Object "tools\iqr_verify.c" @()
+
+    Write-Status "Linking iqr_verify.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\iqr_verify.exe`"", "`"$iqrVerifyObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"", "-lm", "-lpthread")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for iqr_verify" }
+    Write-Status "Built: $BinDir\iqr_verify.exe"
+
+    #==========================================================================
+    # 16. iqr_detect.exe, phoenix_detect.dll
+    #==========================================================================
+    Write-Status "Building iqr_detect..."
+    $wwvBlocksObj = Build-Object "tools\wwv_blocks.c" @()
+    $iqrDetectObj = Build-Object "tools\iqr_detect.c" @()
+    $detectObjs = @("`"$wwvBlocksObj`"", "`"$tickDetectorObj`"", "`"$markerDetectorObj`"", "`"$bcdTimeDetectorObj`"", "`"$bcdFreqDetectorObj`"", "`"$fftFilterBankObj`"", "`"$blockNormObj`"", "`"$waterfallDspObj`"", "`"$detectorRateObj`"", "`"$tickCombFilterObj`"", "`"$wwvClockObj`"", "`"$waterfallTelemObj`"", "`"$kissObj`"")
+
+    Write-Status "Linking iqr_detect.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\iqr_detect.exe`"", "`"$iqrDetectObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"") + $detectObjs + @("-lws2_32", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for iqr_detect" }
+    Write-Status "Built: $BinDir\iqr_detect.exe"
+
+    Write-Status "Linking phoenix_detect.dll..."
+    $cmd = @($CC, "-shared", "-o", "`"$BinDir\phoenix_detect.dll`"") + $detectObjs + @("-lws2_32", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for phoenix_detect.dll" }
+    Write-Status "Built: $BinDir\phoenix_detect.dll"
+
+    #==========================================================================
+    # 17. test_sdr_manager.exe, sdr_multi.exe
+    #==========================================================================
+    Write-Status "Building test_sdr_manager..."
+    $sdrManagerObj = Build-Object "src\sdr_manager.c" @()
+    $testSdrManagerObj = Build-Object "test\test_sdr_manager.c" @()
+
+    Write-Status "Linking test_sdr_manager.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_sdr_manager.exe`"", "`"$testSdrManagerObj`"", "`"$sdrManagerObj`"", "`"$tcpCmdObj`"", "`"$cmdTableObj`"", "`"$decimatorObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"", "`"$iqClientObj`"", "`"$relayMcastObj`"", "`"$iqEncodingObj`"", "`"$sdrStubsObj`"", "-lws2_32", "-lpthread", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_sdr_manager" }
+    Write-Status "Built: $BinDir\test_sdr_manager.exe"
+
+    Write-Status "Building sdr_multi..."
+    $sdrMultiObj = Build-Object "tools\sdr_multi.c" @()
+
+    Write-Status "Linking sdr_multi.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\sdr_multi.exe`"", "`"$sdrMultiObj`"", "`"$sdrManagerObj`"", "`"$tcpCmdObj`"", "`"$cmdTableObj`"", "`"$decimatorObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"", "`"$sdrStreamObj`"", "`"$sdrDeviceObj`"", "`"$sdrplayStubObj`"", "-lpthread") + $serverLdflags
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for sdr_multi" }
+    Write-Status "Built: $BinDir\sdr_multi.exe"
+
+    #==========================================================================
+    # 18. test_pipe_queue.exe, test_pipeline.exe, sdr_pipeline.exe, pipeline_bench.exe
+    #==========================================================================
+    Write-Status "Building test_pipe_queue..."
+    $pipeQueueObj = Build-Object "src\pipe_queue.c" @()
+    $testPipeQueueObj = Build-Object "test\test_pipe_queue.c" @()
+
+    Write-Status "Linking test_pipe_queue.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_pipe_queue.exe`"", "`"$testPipeQueueObj`"", "`"$pipeQueueObj`"", "-lpthread")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_pipe_queue" }
+    Write-Status "Built: $BinDir\test_pipe_queue.exe"
+
+    Write-Status "Building test_pipeline..."
+    $relayFanoutObj = Build-Object "src\relay_fanout.c" @()
+    $pipelineObj = Build-Object "tools\pipeline.c" @()
+    $testPipelineObj = Build-Object "test\test_pipeline.c" @()
+    $pipelineLinkObjs = @("`"$pipelineObj`"", "`"$splitStageObj`"", "`"$noiseBlankerObj`"", "`"$waterfallDspObj`"", "`"$dspQ15Obj`"", "`"$pipeQueueObj`"", "`"$relayFanoutObj`"", "`"$sdrManagerObj`"", "`"$tcpCmdObj`"", "`"$cmdTableObj`"", "`"$decimatorObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"", "`"$iqClientObj`"", "`"$relayMcastObj`"", "`"$iqEncodingObj`"", "`"$iqEventsObj`"")
+
+    Write-Status "Linking test_pipeline.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_pipeline.exe`"", "`"$testPipelineObj`"") + $pipelineLinkObjs + @("`"$sdrStubsObj`"", "-lws2_32", "-lpthread", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_pipeline" }
+    Write-Status "Built: $BinDir\test_pipeline.exe"
+
+    Write-Status "Building sdr_pipeline..."
+    $sdrPipelineObj = Build-Object "tools\sdr_pipeline.c" @()
+
+    Write-Status "Linking sdr_pipeline.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\sdr_pipeline.exe`"", "`"$sdrPipelineObj`"") + $pipelineLinkObjs + @("`"$sdrStreamObj`"", "`"$sdrDeviceObj`"", "`"$sdrplayStubObj`"", "-lpthread") + $serverLdflags
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for sdr_pipeline" }
+    Write-Status "Built: $BinDir\sdr_pipeline.exe"
+
+    Write-Status "Building pipeline_bench..."
+    $pipelineBenchObj = Build-Object "tools\pipeline_bench.c" @()
+
+    Write-Status "Linking pipeline_bench.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\pipeline_bench.exe`"", "`"$pipelineBenchObj`"") + $pipelineLinkObjs + @("`"$sdrStreamObj`"", "`"$sdrDeviceObj`"", "`"$sdrplayStubObj`"", "-lpthread") + $serverLdflags
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for pipeline_bench" }
+    Write-Status "Built: $BinDir\pipeline_bench.exe"
+
+    #==========================================================================
+    # 19. test_noise_blanker.exe
+    #==========================================================================
+    Write-Status "Building test_noise_blanker..."
+    $testNoiseBlankerObj = Build-Object "test\test_noise_blanker.c" @()
+
+    Write-Status "Linking test_noise_blanker.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_noise_blanker.exe`"", "`"$testNoiseBlankerObj`"", "`"$noiseBlankerObj`"", "`"$splitStageObj`"", "`"$waterfallDspObj`"", "`"$dspQ15Obj`"", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_noise_blanker" }
+    Write-Status "Built: $BinDir\test_noise_blanker.exe"
+
+    #==========================================================================
+    # 20. test_dual_station_detector.exe
+    #==========================================================================
+    Write-Status "Building test_dual_station_detector..."
+    $testDualStationObj = Build-Object "test\test_dual_station_detector.c" @()
+
+    Write-Status "Linking test_dual_station_detector.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_dual_station_detector.exe`"", "`"$testDualStationObj`"", "`"$dualStationObj`"", "`"$waterfallTelemObj`"", "`"$wwvClockObj`"", "`"$kissObj`"", "-lws2_32", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_dual_station_detector" }
+    Write-Status "Built: $BinDir\test_dual_station_detector.exe"
+
+    #==========================================================================
+    # 21. signal_splitter_q15.exe, test_pipeline_q15.exe (-DPHOENIX_FIXED_POINT)
+    #     Only split_stage.c, signal_splitter.c and test_pipeline.c read the
+    #     define; everything else links the objects built above
+    #==========================================================================
+    Write-Status "Building fixed-point (Q15) split stage..."
+    $q15Flags = @("-DPHOENIX_FIXED_POINT")
+    $splitStageQ15Obj = Build-Object "tools\split_stage.c" $q15Flags "_q15"
+    $signalSplitterQ15Obj = Build-Object "tools\signal_splitter.c" $q15Flags "_q15"
+    $testPipelineQ15Obj = Build-Object "test\test_pipeline.c" $q15Flags "_q15"
+
+    Write-Status "Linking signal_splitter_q15.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\signal_splitter_q15.exe`"", "`"$signalSplitterQ15Obj`"", "`"$splitStageQ15Obj`"", "`"$noiseBlankerObj`"", "`"$waterfallDspObj`"", "`"$iqEventsObj`"", "`"$iqClientObj`"", "`"$relayMcastObj`"", "`"$iqEncodingObj`"", "`"$dspQ15Obj`"", "-lm", "-lws2_32")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for signal_splitter_q15" }
+    Write-Status "Built: $BinDir\signal_splitter_q15.exe"
+
+    Write-Status "Linking test_pipeline_q15.exe..."
+    $pipelineQ15LinkObjs = $pipelineLinkObjs | ForEach-Object { if ($_ -eq "`"$splitStageObj`"") { "`"$splitStageQ15Obj`"" } else { $_ } }
+    $cmd = @($CC, "-o", "`"$BinDir\test_pipeline_q15.exe`"", "`"$testPipelineQ15Obj`"") + $pipelineQ15LinkObjs + @("`"$sdrStubsObj`"", "-lws2_32", "-lpthread", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_pipeline_q15" }
+    Write-Status "Built: $BinDir\test_pipeline_q15.exe"
+
+    #==========================================================================
+    # 22. test_wwv_detector_manager.exe
+    #==========================================================================
+    Write-Status "Building test_wwv_detector_manager..."
+    $detectorMgrObj = Build-Object "tools\wwv_detector_manager.c" @()
+    $testDetectorMgrObj = Build-Object "test\test_wwv_detector_manager.c" @()
+
+    Write-Status "Linking test_wwv_detector_manager.exe..."
+    $cmd = @($CC, "-o", "`"$BinDir\test_wwv_detector_manager.exe`"", "`"$testDetectorMgrObj`"", "`"$detectorMgrObj`"", "`"$tickDetectorObj`"", "`"$tickCombFilterObj`"", "`"$detectorRateObj`"", "`"$markerDetectorObj`"", "`"$slowMarkerDetectorObj`"", "`"$markerCorrelatorObj`"", "`"$syncDetectorObj`"", "`"$toneTrackerObj`"", "`"$tickCorrelatorObj`"", "`"$waterfallTelemObj`"", "`"$wwvClockObj`"", "`"$kissObj`"", "-lws2_32", "-lm")
+    & $cmd[0] $cmd[1..($cmd.Length-1)]
+    if ($LASTEXITCODE -ne 0) { throw "Linking failed for test_wwv_detector_manager" }
+    Write-Status "Built: $BinDir\test_wwv_detector_manager.exe"
+
+    Write-Status "CI Build complete (22 tools)."
 }
 catch {
     Write-Host "BUILD FAILED: $_" -ForegroundColor Red
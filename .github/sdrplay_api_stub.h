@@ -297,9 +297,11 @@ typedef struct {
 } sdrplay_api_EventParamsT;
 
 typedef struct {
-    uint32_t fsHz;
-    uint8_t syncUpdate;
-    uint8_t reCal;
+    unsigned int firstSampleNum;
+    int grChanged;
+    int rfChanged;
+    int fsChanged;
+    unsigned int numSamples;
 } sdrplay_api_StreamCbParamsT;
 
 // Callback function types
@@ -4,6 +4,7 @@
 param(
     [switch]$Clean,
     [switch]$Release,
+    [switch]$FixedPoint,
     [ValidateSet("major", "minor", "patch")]
     [string]$Increment
 )
@@ -204,6 +205,11 @@ try {
         Write-Status "Debug build"
     }
 
+    if ($FixedPoint) {
+        $CFLAGS += @("-DPHOENIX_FIXED_POINT")
+        Write-Status "Fixed-point (Q15) signal_splitter front end"
+    }
+
     $LDFLAGS = @(
         "-L`"$SDRplayLib`"",
         "-lsdrplay_api",
@@ -240,9 +246,13 @@ try {
 
     $kissObj = Build-Object "src\kiss_fft.c" @()
     $wwvClockObj = Build-Object "tools\wwv_clock.c" @()
-    $channelFiltersObj = Build-Object "tools\channel_filters.c" @()
+    $fftFilterBankObj = Build-Object "tools\fft_filter_bank.c" @()
+    $detectorRateObj = Build-Object "tools\detector_rate.c" @()
+    $blockNormObj = Build-Object "tools\block_normalizer.c" @()
+    $cmdTableObj = Build-Object "src\cmd_table.c" @()
     $tickCombFilterObj = Build-Object "tools\tick_comb_filter.c" @()
     $tickDetectorObj = Build-Object "tools\tick_detector.c" @()
+    $dualStationObj = Build-Object "tools\dual_station_detector.c" @()
     $markerDetectorObj = Build-Object "tools\marker_detector.c" @()
     $slowMarkerDetectorObj = Build-Object "tools\slow_marker_detector.c" @()
     $markerCorrelatorObj = Build-Object "tools\marker_correlator.c" @()
@@ -251,6 +261,7 @@ try {
     $tickCorrelatorObj = Build-Object "tools\tick_correlator.c" @()
     $subcarrierDetectorObj = Build-Object "tools\subcarrier_detector.c" @()
     $bcdEnvelopeObj = Build-Object "tools\bcd_envelope.c" @()
+    $subcarrierFrontendObj = Build-Object "tools\subcarrier_frontend.c" @()
     $bcdDecoderObj = Build-Object "tools\bcd_decoder.c" @()
     $bcdTimeDetectorObj = Build-Object "tools\bcd_time_detector.c" @()
     $bcdFreqDetectorObj = Build-Object "tools\bcd_freq_detector.c" @()
@@ -259,6 +270,13 @@ try {
     $waterfallDspObj = Build-Object "tools\waterfall_dsp.c" @()
     $waterfallAudioObj = Build-Object "tools\waterfall_audio.c" @()
     $waterfallTelemObj = Build-Object "tools\waterfall_telemetry.c" @()
+    $detectorParamsObj = Build-Object "tools\detector_params.c" @()
+    $eventMergeObj = Build-Object "tools\event_merge.c" @()
+    $iqEventsObj = Build-Object "src\iq_events.c" @()
+    $iqClientObj = Build-Object "src\iq_client.c" @()
+    $relayMcastObj = Build-Object "src\relay_mcast.c" @()
+    $iqEncodingObj = Build-Object "src\iq_encoding.c" @()
+    $dspQ15Obj = Build-Object "src\dsp_q15.c" @()
     $waterfallObj = Build-Object "tools\waterfall.c" @("-I`"$SDL2Include`"")
 
     Write-Status "Linking waterfall.exe..."
@@ -271,7 +289,7 @@ try {
         "-lws2_32",
         "-lwinmm"
     )
-    $allArgs = @("-o", "`"$BinDir\waterfall.exe`"", "`"$waterfallObj`"", "`"$channelFiltersObj`"", "`"$tickCombFilterObj`"", "`"$tickDetectorObj`"", "`"$markerDetectorObj`"", "`"$slowMarkerDetectorObj`"", "`"$markerCorrelatorObj`"", "`"$syncDetectorObj`"", "`"$toneTrackerObj`"", "`"$tickCorrelatorObj`"", "`"$subcarrierDetectorObj`"", "`"$bcdEnvelopeObj`"", "`"$bcdDecoderObj`"", "`"$bcdTimeDetectorObj`"", "`"$bcdFreqDetectorObj`"", "`"$bcdCorrelatorObj`"", "`"$waterfallFlashObj`"", "`"$wwvClockObj`"", "`"$waterfallDspObj`"", "`"$waterfallAudioObj`"", "`"$waterfallTelemObj`"", "`"$kissObj`"") + $waterfallLdflags
+    $allArgs = @("-o", "`"$BinDir\waterfall.exe`"", "`"$waterfallObj`"", "`"$fftFilterBankObj`"", "`"$tickCombFilterObj`"", "`"$tickDetectorObj`"", "`"$detectorRateObj`"", "`"$blockNormObj`"", "`"$dualStationObj`"", "`"$markerDetectorObj`"", "`"$slowMarkerDetectorObj`"", "`"$markerCorrelatorObj`"", "`"$syncDetectorObj`"", "`"$toneTrackerObj`"", "`"$tickCorrelatorObj`"", "`"$subcarrierDetectorObj`"", "`"$bcdEnvelopeObj`"", "`"$subcarrierFrontendObj`"", "`"$bcdDecoderObj`"", "`"$bcdTimeDetectorObj`"", "`"$bcdFreqDetectorObj`"", "`"$bcdCorrelatorObj`"", "`"$waterfallFlashObj`"", "`"$wwvClockObj`"", "`"$waterfallDspObj`"", "`"$waterfallAudioObj`"", "`"$waterfallTelemObj`"", "`"$detectorParamsObj`"", "`"$eventMergeObj`"", "`"$iqEventsObj`"", "`"$iqClientObj`"", "`"$relayMcastObj`"", "`"$iqEncodingObj`"", "`"$cmdTableObj`"", "`"$kissObj`"") + $waterfallLdflags
     $argString = $allArgs -join " "
     $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
     if ($process.ExitCode -ne 0) { throw "Linking failed for waterfall" }
@@ -307,13 +325,15 @@ try {
     Write-Status "Building signal_splitter..."
 
     $signalSplitterObj = Build-Object "tools\signal_splitter.c" @()
+    $splitStageObj = Build-Object "tools\split_stage.c" @()
+    $noiseBlankerObj = Build-Object "src\noise_blanker.c" @()
 
     Write-Status "Linking signal_splitter.exe..."
     $signalSplitterLdflags = @(
         "-lm",
         "-lws2_32"
     )
-    $allArgs = @("-o", "`"$BinDir\signal_splitter.exe`"", "`"$signalSplitterObj`"", "`"$waterfallDspObj`"") + $signalSplitterLdflags
+    $allArgs = @("-o", "`"$BinDir\signal_splitter.exe`"", "`"$signalSplitterObj`"", "`"$splitStageObj`"", "`"$noiseBlankerObj`"", "`"$waterfallDspObj`"", "`"$iqEventsObj`"", "`"$iqClientObj`"", "`"$relayMcastObj`"", "`"$iqEncodingObj`"", "`"$dspQ15Obj`"") + $signalSplitterLdflags
     $argString = $allArgs -join " "
     $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
     if ($process.ExitCode -ne 0) { throw "Linking failed for signal_splitter" }
@@ -328,12 +348,242 @@ try {
 
     Write-Status "Linking test_tcp_commands.exe..."
     $testLdflags = @("-lm")
-    $allArgs = @("-o", "`"$BinDir\test_tcp_commands.exe`"", "`"$testTcpObj`"", "`"$tcpCmdObj`"", "`"$sdrStubsObj`"") + $testLdflags
+    $allArgs = @("-o", "`"$BinDir\test_tcp_commands.exe`"", "`"$testTcpObj`"", "`"$tcpCmdObj`"", "`"$cmdTableObj`"", "`"$sdrStubsObj`"") + $testLdflags
     $argString = $allArgs -join " "
     $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
     if ($process.ExitCode -ne 0) { throw "Linking failed for test_tcp_commands" }
     Write-Status "Built: $BinDir\test_tcp_commands.exe"
 
+    # Build test_cmd_table (shared command grammar / perfect-hash parser tests)
+    Write-Status "Building test_cmd_table..."
+
+    $testCmdTableObj = Build-Object "test\test_cmd_table.c" @()
+
+    Write-Status "Linking test_cmd_table.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_cmd_table.exe`"", "`"$testCmdTableObj`"", "`"$cmdTableObj`"") + $testLdflags
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_cmd_table" }
+    Write-Status "Built: $BinDir\test_cmd_table.exe"
+
+    # Build test_rtl_tcp (rtl_tcp protocol and U8 conversion unit tests)
+    Write-Status "Building test_rtl_tcp..."
+
+    $rtlTcpObj = Build-Object "src\rtl_tcp.c" @()
+    $testRtlTcpObj = Build-Object "test\test_rtl_tcp.c" @()
+
+    Write-Status "Linking test_rtl_tcp.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_rtl_tcp.exe`"", "`"$testRtlTcpObj`"", "`"$rtlTcpObj`"", "`"$tcpCmdObj`"", "`"$cmdTableObj`"", "`"$sdrStubsObj`"") + $testLdflags
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_rtl_tcp" }
+    Write-Status "Built: $BinDir\test_rtl_tcp.exe"
+
+    # Build test_notify_queue (sdr_server notification hand-off tests)
+    Write-Status "Building test_notify_queue..."
+
+    $notifyQueueObj = Build-Object "src\notify_queue.c" @()
+    $testNotifyObj = Build-Object "test\test_notify_queue.c" @()
+
+    Write-Status "Linking test_notify_queue.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_notify_queue.exe`"", "`"$testNotifyObj`"", "`"$notifyQueueObj`"", "-lpthread")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_notify_queue" }
+    Write-Status "Built: $BinDir\test_notify_queue.exe"
+
+    # Build test_iq_events (in-band I/Q event marker tests)
+    Write-Status "Building test_iq_events..."
+
+    $testIqEventsObj = Build-Object "test\test_iq_events.c" @()
+
+    Write-Status "Linking test_iq_events.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_iq_events.exe`"", "`"$testIqEventsObj`"", "`"$iqEventsObj`"", "-lm", "-lpthread")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_iq_events" }
+    Write-Status "Built: $BinDir\test_iq_events.exe"
+
+    # Build test_iq_framer (sdr_server adaptive I/Q framing tests)
+    Write-Status "Building test_iq_framer..."
+
+    $iqFramerObj = Build-Object "src\iq_framer.c" @()
+    $testIqFramerObj = Build-Object "test\test_iq_framer.c" @()
+
+    Write-Status "Linking test_iq_framer.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_iq_framer.exe`"", "`"$testIqFramerObj`"", "`"$iqFramerObj`"", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_iq_framer" }
+    Write-Status "Built: $BinDir\test_iq_framer.exe"
+
+    # Build test_iq_client (buffered PHXI/FT32 client tests, loopback server)
+    Write-Status "Building test_iq_client..."
+
+    $testIqClientObj = Build-Object "test\test_iq_client.c" @()
+
+    Write-Status "Linking test_iq_client.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_iq_client.exe`"", "`"$testIqClientObj`"", "`"$iqClientObj`"", "`"$relayMcastObj`"", "`"$iqEncodingObj`"", "-lws2_32", "-lpthread")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_iq_client" }
+    Write-Status "Built: $BinDir\test_iq_client.exe"
+
+    # Build test_relay_mcast (multicast packetizer/reassembly, parity repair)
+    Write-Status "Building test_relay_mcast..."
+
+    $testRelayMcastObj = Build-Object "test\test_relay_mcast.c" @()
+
+    Write-Status "Linking test_relay_mcast.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_relay_mcast.exe`"", "`"$testRelayMcastObj`"", "`"$relayMcastObj`"", "`"$iqClientObj`"", "`"$iqEncodingObj`"", "-lws2_32", "-lpthread")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath $CC -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_relay_mcast" }
+    Write-Status "Built: $BinDir\test_relay_mcast.exe"
+
+    # Build test_iq_encoding (relay sample encodings, vector vs. scalar)
+    Write-Status "Building test_iq_encoding..."
+
+    $testIqEncodingObj = Build-Object "test\test_iq_encoding.c" @()
+
+    Write-Status "Linking test_iq_encoding.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_iq_encoding.exe`"", "`"$testIqEncodingObj`"", "`"$iqEncodingObj`"", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath $CC -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_iq_encoding" }
+    Write-Status "Built: $BinDir\test_iq_encoding.exe"
+
+    # Build test_dsp_q15 (fixed-point front end against the float path)
+    Write-Status "Building test_dsp_q15..."
+
+    $testDspQ15Obj = Build-Object "test\test_dsp_q15.c" @()
+
+    Write-Status "Linking test_dsp_q15.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_dsp_q15.exe`"", "`"$testDspQ15Obj`"", "`"$dspQ15Obj`"", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath $CC -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_dsp_q15" }
+    Write-Status "Built: $BinDir\test_dsp_q15.exe"
+
+    # Build iq_client_bench (iq_client vs. per-field recv throughput)
+    Write-Status "Building iq_client_bench..."
+
+    $iqClientBenchObj = Build-Object "tools\iq_client_bench.c" @()
+
+    Write-Status "Linking iq_client_bench.exe..."
+    $allArgs = @("-o", "`"$BinDir\iq_client_bench.exe`"", "`"$iqClientBenchObj`"", "`"$iqClientObj`"", "`"$relayMcastObj`"", "`"$iqEncodingObj`"", "-lws2_32", "-lpthread")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for iq_client_bench" }
+    Write-Status "Built: $BinDir\iq_client_bench.exe"
+
+    # Build iq_encoding_bench (relay encodings: quality vs. bandwidth, throughput)
+    Write-Status "Building iq_encoding_bench..."
+
+    $iqEncodingBenchObj = Build-Object "tools\iq_encoding_bench.c" @()
+
+    Write-Status "Linking iq_encoding_bench.exe..."
+    $allArgs = @("-o", "`"$BinDir\iq_encoding_bench.exe`"", "`"$iqEncodingBenchObj`"", "`"$iqEncodingObj`"", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath $CC -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for iq_encoding_bench" }
+    Write-Status "Built: $BinDir\iq_encoding_bench.exe"
+
+    # Build bcd_subband_bench (BCD detectors at 50 kHz vs. on the data subband)
+    Write-Status "Building bcd_subband_bench..."
+
+    $iqRecorderObj = Build-Object "src\iq_recorder.c" @()
+    $crc32cObj = Build-Object "src\crc32c.c" @()
+    $bcdSubbandBenchObj = Build-Object "tools\bcd_subband_bench.c" @()
+
+    Write-Status "Linking bcd_subband_bench.exe..."
+    $allArgs = @("-o", "`"$BinDir\bcd_subband_bench.exe`"", "`"$bcdSubbandBenchObj`"", "`"$fftFilterBankObj`"", "`"$detectorRateObj`"", "`"$bcdTimeDetectorObj`"", "`"$bcdFreqDetectorObj`"", "`"$waterfallDspObj`"", "`"$waterfallTelemObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"", "`"$kissObj`"", "-lws2_32", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath $CC -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for bcd_subband_bench" }
+    Write-Status "Built: $BinDir\bcd_subband_bench.exe"
+
+    # Build test_iq_recorder (recording, playback and timing track tests)
+    Write-Status "Building test_iq_recorder..."
+
+    $testIqRecorderObj = Build-Object "test\test_iq_recorder.c" @()
+
+    Write-Status "Linking test_iq_recorder.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_iq_recorder.exe`"", "`"$testIqRecorderObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath $CC -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_iq_recorder" }
+    Write-Status "Built: $BinDir\test_iq_recorder.exe"
+
+    # Build test_crc32c (CRC-32C check values, hardware vs. table)
+    Write-Status "Building test_crc32c..."
+
+    $testCrc32cObj = Build-Object "test\test_crc32c.c" @()
+
+    Write-Status "Linking test_crc32c.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_crc32c.exe`"", "`"$testCrc32cObj`"", "`"$crc32cObj`"")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath $CC -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_crc32c" }
+    Write-Status "Built: $BinDir\test_crc32c.exe"
+
+    # Build iqr_verify (parallel block CRC check of .iqr archives)
+    Write-Status "Building iqr_verify..."
+
+    $iqrVerifyObj = Build-Object "tools\iqr_verify.c" @()
+
+    Write-Status "Linking iqr_verify.exe..."
+    $allArgs = @("-o", "`"$BinDir\iqr_verify.exe`"", "`"$iqrVerifyObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"", "-lm", "-lpthread")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath $CC -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for iqr_verify" }
+    Write-Status "Built: $BinDir\iqr_verify.exe"
+
+    # Build iqr_detect and phoenix_detect.dll (detector blocks for the Python bindings)
+    Write-Status "Building iqr_detect..."
+
+    $wwvBlocksObj = Build-Object "tools\wwv_blocks.c" @()
+    $iqrDetectObj = Build-Object "tools\iqr_detect.c" @()
+    $detectObjs = @("`"$wwvBlocksObj`"", "`"$tickDetectorObj`"", "`"$markerDetectorObj`"", "`"$bcdTimeDetectorObj`"", "`"$bcdFreqDetectorObj`"", "`"$fftFilterBankObj`"", "`"$blockNormObj`"", "`"$waterfallDspObj`"", "`"$detectorRateObj`"", "`"$tickCombFilterObj`"", "`"$wwvClockObj`"", "`"$waterfallTelemObj`"", "`"$kissObj`"")
+
+    Write-Status "Linking iqr_detect.exe..."
+    $allArgs = @("-o", "`"$BinDir\iqr_detect.exe`"", "`"$iqrDetectObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"") + $detectObjs + @("-lws2_32", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath $CC -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for iqr_detect" }
+    Write-Status "Built: $BinDir\iqr_detect.exe"
+
+    Write-Status "Linking phoenix_detect.dll..."
+    $allArgs = @("-shared", "-o", "`"$BinDir\phoenix_detect.dll`"") + $detectObjs + @("-lws2_32", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath $CC -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for phoenix_detect.dll" }
+    Write-Status "Built: $BinDir\phoenix_detect.dll"
+
+    # Build normalizer_bench (block slow AGC vs. per-sample normalize())
+    Write-Status "Building normalizer_bench..."
+
+    $normalizerBenchObj = Build-Object "tools\normalizer_bench.c" @()
+
+    Write-Status "Linking normalizer_bench.exe..."
+    $allArgs = @("-o", "`"$BinDir\normalizer_bench.exe`"", "`"$normalizerBenchObj`"", "`"$blockNormObj`"", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath $CC -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for normalizer_bench" }
+    Write-Status "Built: $BinDir\normalizer_bench.exe"
+
+    # Build cmd_bench (command parser throughput over a command corpus)
+    Write-Status "Building cmd_bench..."
+
+    $cmdBenchObj = Build-Object "tools\cmd_bench.c" @()
+
+    Write-Status "Linking cmd_bench.exe..."
+    $allArgs = @("-o", "`"$BinDir\cmd_bench.exe`"", "`"$cmdBenchObj`"", "`"$cmdTableObj`"", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath $CC -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for cmd_bench" }
+    Write-Status "Built: $BinDir\cmd_bench.exe"
+
     # Build test_telemetry (UDP telemetry unit tests)
     Write-Status "Building test_telemetry..."
 
@@ -357,7 +607,7 @@ try {
     Write-Status "Building sdr_server..."
 
     $sdrServerObj = Build-Object "tools\sdr_server.c" @()
-    # Reuse tcpCmdObj from above
+    # Reuse tcpCmdObj, rtlTcpObj, notifyQueueObj, iqEventsObj and iqFramerObj from above
 
     Write-Status "Linking sdr_server.exe..."
     $serverLdflags = @(
@@ -367,7 +617,7 @@ try {
         "-lm",
         "-lwinmm"
     )
-    $allArgs = @("-o", "`"$BinDir\sdr_server.exe`"", "`"$sdrServerObj`"", "`"$tcpCmdObj`"", "`"$sdrStreamObj`"", "`"$sdrDeviceObj`"") + $serverLdflags
+    $allArgs = @("-o", "`"$BinDir\sdr_server.exe`"", "`"$sdrServerObj`"", "`"$tcpCmdObj`"", "`"$cmdTableObj`"", "`"$rtlTcpObj`"", "`"$notifyQueueObj`"", "`"$iqEventsObj`"", "`"$iqFramerObj`"", "`"$sdrStreamObj`"", "`"$sdrDeviceObj`"") + $serverLdflags
     $argString = $allArgs -join " "
     $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
     if ($process.ExitCode -ne 0) { throw "Linking failed for sdr_server" }
@@ -386,6 +636,159 @@ try {
     if ($process.ExitCode -ne 0) { throw "Linking failed for telem_logger" }
     Write-Status "Built: $BinDir\telem_logger.exe"
 
+    # Build iqr_convert (bulk IQR <-> WAV/SigMF/raw conversion)
+    Write-Status "Building iqr_convert..."
+
+    $iqrExportObj = Build-Object "src\iqr_export.c" @()
+    $iqrMetaObj = Build-Object "src\iqr_meta.c" @()
+    $decimatorObj = Build-Object "src\decimator.c" @()
+    $iqrConvertObj = Build-Object "tools\iqr_convert.c" @()
+
+    Write-Status "Linking iqr_convert.exe..."
+    $allArgs = @("-o", "`"$BinDir\iqr_convert.exe`"", "`"$iqrConvertObj`"", "`"$iqrExportObj`"", "`"$iqrMetaObj`"", "`"$decimatorObj`"", "-lm", "-lpthread")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for iqr_convert" }
+    Write-Status "Built: $BinDir\iqr_convert.exe"
+
+    # Build test_iqr_export (format, conversion and slicing unit tests)
+    Write-Status "Building test_iqr_export..."
+
+    $testIqrExportObj = Build-Object "test\test_iqr_export.c" @()
+
+    Write-Status "Linking test_iqr_export.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_iqr_export.exe`"", "`"$testIqrExportObj`"", "`"$iqrExportObj`"", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_iqr_export" }
+    Write-Status "Built: $BinDir\test_iqr_export.exe"
+
+    # Build test_decimator (2 MSPS -> 48 kHz tone amplitude and frequency)
+    Write-Status "Building test_decimator..."
+
+    $testDecimatorObj = Build-Object "test\test_decimator.c" @()
+
+    Write-Status "Linking test_decimator.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_decimator.exe`"", "`"$testDecimatorObj`"", "`"$decimatorObj`"", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_decimator" }
+    Write-Status "Built: $BinDir\test_decimator.exe"
+
+    # Build test_sdr_manager (multi-device manager: tone/replay backends, ports, DEV commands)
+    Write-Status "Building test_sdr_manager..."
+
+    $sdrManagerObj = Build-Object "src\sdr_manager.c" @()
+    $testSdrManagerObj = Build-Object "test\test_sdr_manager.c" @()
+
+    Write-Status "Linking test_sdr_manager.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_sdr_manager.exe`"", "`"$testSdrManagerObj`"", "`"$sdrManagerObj`"", "`"$tcpCmdObj`"", "`"$cmdTableObj`"", "`"$decimatorObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"", "`"$iqClientObj`"", "`"$relayMcastObj`"", "`"$iqEncodingObj`"", "`"$sdrStubsObj`"", "-lws2_32", "-lpthread", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_sdr_manager" }
+    Write-Status "Built: $BinDir\test_sdr_manager.exe"
+
+    # Build sdr_multi (several receivers behind one control port)
+    Write-Status "Building sdr_multi..."
+
+    $sdrMultiObj = Build-Object "tools\sdr_multi.c" @()
+
+    Write-Status "Linking sdr_multi.exe..."
+    $allArgs = @("-o", "`"$BinDir\sdr_multi.exe`"", "`"$sdrMultiObj`"", "`"$sdrManagerObj`"", "`"$tcpCmdObj`"", "`"$cmdTableObj`"", "`"$decimatorObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"", "`"$sdrStreamObj`"", "`"$sdrDeviceObj`"", "-lpthread") + $serverLdflags
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for sdr_multi" }
+    Write-Status "Built: $BinDir\sdr_multi.exe"
+
+    # Build test_pipe_queue (single-producer, single-consumer block queue)
+    Write-Status "Building test_pipe_queue..."
+
+    $pipeQueueObj = Build-Object "src\pipe_queue.c" @()
+    $testPipeQueueObj = Build-Object "test\test_pipe_queue.c" @()
+
+    Write-Status "Linking test_pipe_queue.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_pipe_queue.exe`"", "`"$testPipeQueueObj`"", "`"$pipeQueueObj`"", "-lpthread")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_pipe_queue" }
+    Write-Status "Built: $BinDir\test_pipe_queue.exe"
+
+    # Build test_pipeline (descriptions, split stage, queue/TCP/phxi pipelines bit-identical)
+    Write-Status "Building test_pipeline..."
+
+    $relayFanoutObj = Build-Object "src\relay_fanout.c" @()
+    $pipelineObj = Build-Object "tools\pipeline.c" @()
+    $testPipelineObj = Build-Object "test\test_pipeline.c" @()
+    $pipelineLinkObjs = @("`"$pipelineObj`"", "`"$splitStageObj`"", "`"$noiseBlankerObj`"", "`"$waterfallDspObj`"", "`"$dspQ15Obj`"", "`"$pipeQueueObj`"", "`"$relayFanoutObj`"", "`"$sdrManagerObj`"", "`"$tcpCmdObj`"", "`"$cmdTableObj`"", "`"$decimatorObj`"", "`"$iqRecorderObj`"", "`"$crc32cObj`"", "`"$iqClientObj`"", "`"$relayMcastObj`"", "`"$iqEncodingObj`"", "`"$iqEventsObj`"")
+
+    Write-Status "Linking test_pipeline.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_pipeline.exe`"", "`"$testPipelineObj`"") + $pipelineLinkObjs + @("`"$sdrStubsObj`"", "-lws2_32", "-lpthread", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_pipeline" }
+    Write-Status "Built: $BinDir\test_pipeline.exe"
+
+    # Build sdr_pipeline (sdr_server, signal_splitter and signal_relay in one process)
+    Write-Status "Building sdr_pipeline..."
+
+    $sdrPipelineObj = Build-Object "tools\sdr_pipeline.c" @()
+
+    Write-Status "Linking sdr_pipeline.exe..."
+    $allArgs = @("-o", "`"$BinDir\sdr_pipeline.exe`"", "`"$sdrPipelineObj`"") + $pipelineLinkObjs + @("`"$sdrStreamObj`"", "`"$sdrDeviceObj`"", "-lpthread") + $serverLdflags
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for sdr_pipeline" }
+    Write-Status "Built: $BinDir\sdr_pipeline.exe"
+
+    # Build pipeline_bench (CPU per MSPS: TCP-linked vs. queue-linked stages)
+    Write-Status "Building pipeline_bench..."
+
+    $pipelineBenchObj = Build-Object "tools\pipeline_bench.c" @()
+
+    Write-Status "Linking pipeline_bench.exe..."
+    $allArgs = @("-o", "`"$BinDir\pipeline_bench.exe`"", "`"$pipelineBenchObj`"") + $pipelineLinkObjs + @("`"$sdrStreamObj`"", "`"$sdrDeviceObj`"", "-lpthread") + $serverLdflags
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for pipeline_bench" }
+    Write-Status "Built: $BinDir\pipeline_bench.exe"
+
+    # Build test_noise_blanker (synthetic impulses on the tone; any block split, vector = scalar)
+    Write-Status "Building test_noise_blanker..."
+
+    $testNoiseBlankerObj = Build-Object "test\test_noise_blanker.c" @()
+
+    Write-Status "Linking test_noise_blanker.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_noise_blanker.exe`"", "`"$testNoiseBlankerObj`"", "`"$noiseBlankerObj`"", "`"$splitStageObj`"", "`"$waterfallDspObj`"", "`"$dspQ15Obj`"", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_noise_blanker" }
+    Write-Status "Built: $BinDir\test_noise_blanker.exe"
+
+    # Build test_dual_station_detector (WWV/WWVH separation, relative delay)
+    Write-Status "Building test_dual_station_detector..."
+
+    $testDualStationObj = Build-Object "test\test_dual_station_detector.c" @()
+
+    Write-Status "Linking test_dual_station_detector.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_dual_station_detector.exe`"", "`"$testDualStationObj`"", "`"$dualStationObj`"", "`"$waterfallTelemObj`"", "`"$wwvClockObj`"", "`"$kissObj`"", "-lws2_32", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_dual_station_detector" }
+    Write-Status "Built: $BinDir\test_dual_station_detector.exe"
+
+    # Build test_wwv_detector_manager (detector orchestration, per-rate config)
+    Write-Status "Building test_wwv_detector_manager..."
+
+    $detectorMgrObj = Build-Object "tools\wwv_detector_manager.c" @()
+    $testDetectorMgrObj = Build-Object "test\test_wwv_detector_manager.c" @()
+
+    Write-Status "Linking test_wwv_detector_manager.exe..."
+    $allArgs = @("-o", "`"$BinDir\test_wwv_detector_manager.exe`"", "`"$testDetectorMgrObj`"", "`"$detectorMgrObj`"", "`"$tickDetectorObj`"", "`"$tickCombFilterObj`"", "`"$detectorRateObj`"", "`"$markerDetectorObj`"", "`"$slowMarkerDetectorObj`"", "`"$markerCorrelatorObj`"", "`"$syncDetectorObj`"", "`"$toneTrackerObj`"", "`"$tickCorrelatorObj`"", "`"$waterfallTelemObj`"", "`"$wwvClockObj`"", "`"$kissObj`"", "-lws2_32", "-lm")
+    $argString = $allArgs -join " "
+    $process = Start-Process -FilePath "`"$CC`"" -ArgumentList $argString -NoNewWindow -Wait -PassThru
+    if ($process.ExitCode -ne 0) { throw "Linking failed for test_wwv_detector_manager" }
+    Write-Status "Built: $BinDir\test_wwv_detector_manager.exe"
+
     Write-Status "Done."
 }
 catch {
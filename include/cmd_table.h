@@ -0,0 +1,132 @@
+/**
+ * @file cmd_table.h
+ * @brief Table-driven text command parser shared by sdr_server and waterfall
+ *
+ * A program describes its commands once as a static cmd_spec_t table: name,
+ * id, argument count and the type of each argument (word, integer, float,
+ * optional range or list of accepted words). cmd_table_build() computes a
+ * perfect hash (hash and displace) that puts every name in its own slot, so
+ * a lookup is one pass over the name, one probe and one compare.
+ *
+ * cmd_table_parse() tokenizes the caller's line in place (separators are
+ * overwritten with NUL) and converts and validates every argument. Nothing
+ * is allocated; the parsed tokens point into the line.
+ *
+ * Names and word arguments match case-insensitively.
+ */
+
+#ifndef CMD_TABLE_H
+#define CMD_TABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define CMD_TABLE_MAX_ARGS      8
+#define CMD_TABLE_MAX_SLOTS     256     /* Hash slots; tables up to 128 commands */
+
+/*============================================================================
+ * Grammar
+ *============================================================================*/
+
+typedef enum {
+    CMD_ARG_WORD = 0,       /* Any token, or one of choices */
+    CMD_ARG_INT,            /* Decimal integer, whole token */
+    CMD_ARG_FLOAT           /* strtod() number, whole token, finite */
+} cmd_arg_type_t;
+
+typedef struct {
+    cmd_arg_type_t type;
+    double min;                     /* INT/FLOAT: inclusive range, checked if min < max */
+    double max;
+    const char *const *choices;     /* WORD: NULL-terminated list, NULL = any word */
+} cmd_arg_spec_t;
+
+/* Argument initializers for spec tables */
+#define CMD_SPEC_INT(lo, hi)        { CMD_ARG_INT, (lo), (hi), NULL }
+#define CMD_SPEC_FLOAT(lo, hi)      { CMD_ARG_FLOAT, (lo), (hi), NULL }
+#define CMD_SPEC_WORD               { CMD_ARG_WORD, 0, 0, NULL }
+#define CMD_SPEC_CHOICE(list)       { CMD_ARG_WORD, 0, 0, (list) }
+#define CMD_SPEC_NO_ARGS            CMD_SPEC_WORD
+
+typedef struct {
+    const char *name;
+    int id;                         /* Caller's command code */
+    int min_args;
+    int max_args;
+    cmd_arg_spec_t args[CMD_TABLE_MAX_ARGS];
+    const void *data;               /* Caller's per-command context */
+} cmd_spec_t;
+
+typedef struct {
+    const cmd_spec_t *specs;
+    int count;
+    uint32_t mask;
+    uint8_t disp[CMD_TABLE_MAX_SLOTS];  /* Per-bucket displacement */
+    uint8_t slot[CMD_TABLE_MAX_SLOTS];  /* Spec index + 1, 0 = empty */
+} cmd_table_t;
+
+/*============================================================================
+ * Parse Result
+ *============================================================================*/
+
+typedef enum {
+    CMD_TABLE_OK = 0,
+    CMD_TABLE_ERR_EMPTY,        /* Blank line */
+    CMD_TABLE_ERR_UNKNOWN,      /* Name not in the table */
+    CMD_TABLE_ERR_ARGC,         /* Too few or too many arguments */
+    CMD_TABLE_ERR_TYPE,         /* Argument is not a number */
+    CMD_TABLE_ERR_RANGE,        /* Number outside [min, max] */
+    CMD_TABLE_ERR_CHOICE        /* Word not in choices */
+} cmd_table_status_t;
+
+typedef struct {
+    const char *text;           /* Token, inside the parsed line */
+    long i;                     /* CMD_ARG_INT */
+    double f;                   /* CMD_ARG_INT and CMD_ARG_FLOAT */
+    int choice;                 /* CMD_ARG_WORD with choices: index, else -1 */
+} cmd_value_t;
+
+typedef struct {
+    const cmd_spec_t *spec;     /* Set once the name is found */
+    const char *name;           /* First token, NULL on an empty line */
+    int argc;
+    int bad_arg;                /* Argument index for TYPE/RANGE/CHOICE, else -1 */
+    cmd_value_t argv[CMD_TABLE_MAX_ARGS];
+} cmd_parsed_t;
+
+/*============================================================================
+ * Public API
+ *============================================================================*/
+
+/**
+ * Index count specs (kept by reference). Fails on duplicate names or more
+ * commands than the slot table can hold.
+ */
+bool cmd_table_build(cmd_table_t *t, const cmd_spec_t *specs, int count);
+
+/** Spec for a name of len characters, or NULL */
+const cmd_spec_t *cmd_table_find(const cmd_table_t *t, const char *name, size_t len);
+
+/**
+ * Tokenize line in place (stops at CR/LF) and validate it against the table.
+ * On argument errors out->spec is set and out->bad_arg names the argument.
+ */
+cmd_table_status_t cmd_table_parse(const cmd_table_t *t, char *line, cmd_parsed_t *out);
+
+/** Short name for a status ("OK", "UNKNOWN", ...) */
+const char *cmd_table_status_name(cmd_table_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMD_TABLE_H */
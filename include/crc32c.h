@@ -0,0 +1,38 @@
+/**
+ * @file crc32c.h
+ * @brief CRC-32C (Castagnoli) checksums
+ *
+ * The iSCSI/ext4 polynomial, chosen because x86 (SSE4.2) and ARMv8 both
+ * compute it in hardware. crc32c() uses the CPU instruction when present
+ * (checked at run time on x86, at compile time on ARM) and a byte-wise
+ * table otherwise; both give the same result.
+ *
+ * Chaining works like zlib's crc32(): start from 0 and pass the previous
+ * result back in, so crc32c(crc32c(0, a, n), b, m) is the CRC of a then b.
+ */
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** CRC-32C of len bytes, continuing from crc (0 to start) */
+uint32_t crc32c(uint32_t crc, const void *data, size_t len);
+
+/** Table-driven reference, same result as crc32c() */
+uint32_t crc32c_sw(uint32_t crc, const void *data, size_t len);
+
+/** True if crc32c() runs on the CPU's CRC instruction */
+bool crc32c_hw_available(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC32C_H */
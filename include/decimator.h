@@ -5,7 +5,8 @@
  * Converts 2 MSPS I/Q from SDRplay to 48kHz complex baseband for modem input.
  * Uses cascaded half-band filters for efficient decimation.
  * 
- * STATUS: WIP - Not yet tested. Awaiting modem team input on interface.
+ * STATUS: WIP - Awaiting modem team input on interface. Tested by
+ * test/test_decimator.c.
  */
 
 #ifndef DECIMATOR_H
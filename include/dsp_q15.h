@@ -0,0 +1,168 @@
+/**
+ * @file dsp_q15.h
+ * @brief Q15 fixed-point receive front end for low-power nodes
+ *
+ * Integer version of the 2 MHz -> 50 kHz / 12 kHz reduction, for nodes
+ * without a fast FPU (signal_splitter built with -DPHOENIX_FIXED_POINT):
+ *
+ *   int16 I/Q -> CIC decimator (÷R, order N, wrapping int32)
+ *             -> channel FIR (Q15 taps, int32 accumulate, ÷M)
+ *             -> optional DC blocker (error feedback)
+ *             -> int16 I/Q at input_rate / (R * M)
+ *
+ * The float path's 5 kHz biquad does not carry over: at 2 MHz its poles
+ * sit about 0.01 from z = 1, where the loop amplifies coefficient and
+ * rounding error far beyond Q15 resolution. The CIC does the bulk
+ * reduction with exact integer arithmetic and the FIR sets the passband
+ * at a rate where short Q15 taps are enough.
+ *
+ * Samples are Q15: int16 x stands for x / 32768, as in the S16 streams.
+ * The FIR uses compiler vector extensions (GCC >= 9, clang) and plain C
+ * elsewhere; the _scalar variant gives identical output for testing.
+ */
+
+#ifndef DSP_Q15_H
+#define DSP_Q15_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define Q15_ONE                 32768
+#define Q15_CIC_MAX_ORDER       4
+#define Q15_CIC_MAX_GAIN        65536       /* R^N: int16 * gain fits int32 */
+#define Q15_FIR_MAX_TAPS        256
+#define Q15_FIR_LANES           8           /* Taps are padded to a multiple */
+
+#define Q15_FE_DEFAULT_TAPS     64
+#define Q15_FE_DEFAULT_CUTOFF   5000.0f     /* Same corner as the float path */
+
+/*============================================================================
+ * DC Blocker
+ *============================================================================*/
+
+/**
+ * y[n] = x[n] - x[n-1] + alpha * y[n-1] per channel. The truncation error
+ * of each output is carried into the next, so an alpha close to 1 leaves
+ * no DC residue and no limit cycle.
+ */
+typedef struct {
+    int32_t alpha;          /* Q15 */
+    int32_t x1[2];
+    int32_t y1[2];
+    int32_t err[2];
+} q15_dc_block_t;
+
+void q15_dc_block_init(q15_dc_block_t *dc, float alpha);
+
+/** Filter interleaved I/Q in place or into out (count = I/Q pairs) */
+void q15_dc_block_process(q15_dc_block_t *dc, const int16_t *iq, int16_t *out, size_t count);
+
+/*============================================================================
+ * CIC Decimator
+ *============================================================================*/
+
+typedef struct {
+    int decimation;
+    int order;
+    int phase;
+    int64_t norm;           /* 2^31 / R^N, rounded */
+    uint32_t integ[Q15_CIC_MAX_ORDER][2];
+    uint32_t comb[Q15_CIC_MAX_ORDER][2];
+} q15_cic_t;
+
+/**
+ * @return false unless 1 <= order <= Q15_CIC_MAX_ORDER and
+ *         decimation^order <= Q15_CIC_MAX_GAIN
+ */
+bool q15_cic_init(q15_cic_t *cic, int decimation, int order);
+
+/**
+ * Decimate interleaved I/Q; output has unity DC gain
+ * @param out  Room for count / decimation + 1 pairs
+ * @return     Pairs written
+ */
+size_t q15_cic_process(q15_cic_t *cic, const int16_t *iq, size_t count, int16_t *out);
+
+/*============================================================================
+ * Goertzel Energy
+ *============================================================================*/
+
+/** 2 * cos(2 * pi * freq / rate) in Q14 */
+int32_t q15_goertzel_coeff(float freq_hz, float sample_rate);
+
+/**
+ * Energy |X(f)|^2 of count samples taken every stride int16s
+ * @return Energy scaled by 2^30 (the float Goertzel on x / 32768, times 2^30),
+ *         or -1 if count >= 2^15 * |sin(2 pi f / rate)|, where the int32
+ *         state could overflow (100 Hz at 2400 Hz allows 8482 samples)
+ */
+int64_t q15_goertzel_energy(const int16_t *x, size_t count, size_t stride, int32_t coeff);
+
+/*============================================================================
+ * Front End
+ *============================================================================*/
+
+typedef struct q15_frontend q15_frontend_t;
+
+typedef struct {
+    int input_rate;
+    int cic_decimation;
+    int cic_order;
+    int fir_decimation;
+    int fir_taps;           /* Rounded up to Q15_FIR_LANES */
+    float cutoff_hz;
+    float dc_alpha;         /* 0 = no DC blocker */
+} q15_frontend_config_t;
+
+/**
+ * Split input_rate / output_rate (truncated, as the float path does) into
+ * a CIC of the highest order <= 3 that fits and a ÷2 FIR when the ratio
+ * is even: 2 MHz -> 50 kHz is CIC 20 x3 + FIR 2, -> 12 kHz is CIC 83 x2 + FIR 2
+ */
+void q15_frontend_default_config(q15_frontend_config_t *cfg, int input_rate, int output_rate);
+
+/**
+ * Windowed-sinc (Blackman) lowpass with unity DC gain - the float design
+ * the front end quantizes
+ */
+void q15_design_lowpass(float *taps, int num_taps, float cutoff_hz, float sample_rate);
+
+/** @return NULL on a config the integer stages cannot hold */
+q15_frontend_t *q15_frontend_create(const q15_frontend_config_t *cfg);
+void q15_frontend_destroy(q15_frontend_t *fe);
+void q15_frontend_reset(q15_frontend_t *fe);
+
+/** Output rate in Hz */
+float q15_frontend_output_rate(const q15_frontend_t *fe);
+
+/** Quantized taps actually used (padded count) */
+const int16_t *q15_frontend_taps(const q15_frontend_t *fe, int *num_taps);
+
+/**
+ * Run interleaved int16 I/Q through the front end
+ * @param out      Output I/Q pairs
+ * @param out_max  Room in out, in pairs (count / total decimation + 1 is enough)
+ * @return         Pairs written
+ */
+size_t q15_frontend_process(q15_frontend_t *fe, const int16_t *iq, size_t count,
+                            int16_t *out, size_t out_max);
+size_t q15_frontend_process_scalar(q15_frontend_t *fe, const int16_t *iq, size_t count,
+                                   int16_t *out, size_t out_max);
+
+/** Saturating float [-1, 1) -> Q15 conversion for float sources */
+void q15_from_float(const float *in, int16_t *out, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DSP_Q15_H */
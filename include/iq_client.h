@@ -0,0 +1,180 @@
+/**
+ * @file iq_client.h
+ * @brief Buffered client for the PHXI (sdr_server) and FT32 (signal_splitter /
+ *        signal_relay) sample streams
+ *
+ * The client reads the socket in large chunks into one receive buffer and
+ * parses frames in place: a data frame comes back as pointers into that
+ * buffer (events and samples), with no per-frame copy and one recv() per
+ * chunk instead of three per frame.
+ *
+ * The protocol is recognized from the stream header magic:
+ *
+ *   PHXI header (32 bytes) | IQDQ frame | META update | IQDQ frame ...
+ *   FT32 header (16 bytes) | DATA frame | DATA frame ...
+ *
+ * Connection loss is handled inside iq_client_next(): the client closes the
+ * socket, waits out an exponential backoff and reconnects, reporting each
+ * state change to the caller so it can reset its DSP state. The call never
+ * blocks longer than the timeout it is given, so a UI loop stays responsive
+ * while the server is away.
+ *
+ * Sequence numbers are checked on every data frame; a jump is reported on
+ * the frame that follows the gap.
+ *
+ * FT32 streams may carry a compact encoding (S16, S8, mu-law - see
+ * iq_encoding.h); iq_client_set_encoding() requests one from signal_relay.
+ * Encoded frames are decoded into a client-owned buffer, so callers always
+ * see F32 samples.
+ *
+ * iq_client_create_mcast() reads the same FT32 stream from a signal_relay
+ * multicast group instead (see relay_mcast.h). Frames come back through the
+ * same calls; holes the parity packets could not repair are zero-filled and
+ * counted in samples_lost.
+ *
+ * Threading: one thread per client.
+ */
+
+#ifndef IQ_CLIENT_H
+#define IQ_CLIENT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "iq_events.h"
+#include "iq_encoding.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define IQ_CLIENT_RECV_BUFFER       (1024 * 1024)   /* Receive buffer (bytes) */
+#define IQ_CLIENT_MAX_FRAME_BYTES   (IQ_CLIENT_RECV_BUFFER / 2)
+#define IQ_CLIENT_BACKOFF_MIN_MS    500
+#define IQ_CLIENT_BACKOFF_MAX_MS    5000
+#define IQ_CLIENT_MCAST_IDLE_MS     3000    /* Multicast: silence before DISCONNECTED */
+
+/* Sample formats (match the PHXI sample_format field) */
+#define IQ_CLIENT_FORMAT_S16        1
+#define IQ_CLIENT_FORMAT_F32        2
+#define IQ_CLIENT_FORMAT_U8         3
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct iq_client iq_client_t;
+
+typedef enum {
+    IQ_CLIENT_PROTO_PHXI = 1,           /* sdr_server I/Q (PHXI / IQDQ / META) */
+    IQ_CLIENT_PROTO_FT32                /* Float32 relay stream (FT32 / DATA) */
+} iq_client_proto_t;
+
+typedef enum {
+    IQ_CLIENT_FRAME = 0,                /* Data frame returned */
+    IQ_CLIENT_META,                     /* Stream parameters changed (PHXI META) */
+    IQ_CLIENT_CONNECTED,                /* Stream header received - reset DSP state */
+    IQ_CLIENT_DISCONNECTED,             /* Connection lost or server not up (once per outage) */
+    IQ_CLIENT_TIMEOUT                   /* Nothing complete within the timeout, or still reconnecting */
+} iq_client_status_t;
+
+/** Stream parameters from the header and later META updates */
+typedef struct {
+    iq_client_proto_t proto;
+    uint32_t version;                   /* PHXI version (FT32: 0) */
+    uint32_t sample_rate;
+    uint32_t sample_format;             /* IQ_CLIENT_FORMAT_* (FT32: F32) */
+    uint64_t center_freq;               /* Hz (FT32: 0) */
+    uint32_t gain_reduction;            /* dB (FT32: 0) */
+    uint32_t lna_state;                 /* (FT32: 0) */
+    bool     events;                    /* Frames carry in-band event markers */
+    uint32_t encoding;                  /* FT32 wire encoding (iq_encoding_t); samples
+                                           are always handed out as F32 */
+} iq_client_stream_t;
+
+/** A data frame, parsed in place - pointers are valid until the next call */
+typedef struct {
+    uint32_t sequence;
+    uint32_t num_samples;               /* I/Q pairs */
+    uint32_t flags;
+    uint32_t frames_lost;               /* Sequence gap just before this frame */
+    uint32_t samples_lost;              /* Zero-filled I/Q pairs (multicast only) */
+    const void *samples;                /* Interleaved I/Q in stream->sample_format */
+    const iq_event_t *events;           /* NULL when n_events is 0 */
+    uint32_t n_events;
+} iq_client_frame_t;
+
+typedef struct {
+    uint64_t frames;
+    uint64_t bytes;
+    uint64_t recv_calls;
+    uint64_t sequence_gaps;
+    uint64_t frames_lost;
+    uint64_t resyncs;                   /* Bytes skipped hunting for a frame magic
+                                           (multicast: invalid datagrams) */
+    uint64_t realigned;                 /* Frames copied because they started off a
+                                           4-byte boundary (odd U8 frame before) */
+    uint64_t packets_recovered;         /* Multicast: datagrams rebuilt from parity */
+    uint64_t samples_lost;              /* Multicast: zero-filled I/Q pairs */
+    uint64_t connects;
+    uint64_t disconnects;
+} iq_client_stats_t;
+
+/*============================================================================
+ * API
+ *============================================================================*/
+
+/**
+ * @brief Create a client; the first connection is made by iq_client_next()
+ * @param expect  Protocol to accept, or 0 for either
+ */
+iq_client_t *iq_client_create(const char *host, int port, iq_client_proto_t expect);
+
+/**
+ * @brief Create a client that joins a signal_relay multicast group
+ * @param iface  Local interface address to join on, or NULL for the default
+ *
+ * CONNECTED is reported on the first packet and DISCONNECTED after
+ * IQ_CLIENT_MCAST_IDLE_MS without one (the relay beacons once a second).
+ */
+iq_client_t *iq_client_create_mcast(const char *group, int port, const char *iface);
+void iq_client_destroy(iq_client_t *c);
+
+/**
+ * @brief Ask an FT32 relay for a compact sample encoding (TCP only)
+ *
+ * Sent as an iq_enc_request_t on every connect from then on. The stream
+ * header reports what the server actually chose (stream->encoding).
+ */
+void iq_client_set_encoding(iq_client_t *c, iq_encoding_t encoding);
+
+/** Reconnect backoff: starts at min_ms, doubles per failure up to max_ms */
+void iq_client_set_backoff(iq_client_t *c, int min_ms, int max_ms);
+
+/**
+ * @brief Return the next frame or state change
+ *
+ * Waits at most timeout_ms for socket data or the reconnect backoff.
+ * IQ_CLIENT_FRAME fills *frame; all other results leave it untouched.
+ */
+iq_client_status_t iq_client_next(iq_client_t *c, iq_client_frame_t *frame, int timeout_ms);
+
+/** Drop the connection (e.g. the caller found the data unusable); reconnects after backoff */
+void iq_client_disconnect(iq_client_t *c);
+
+bool iq_client_connected(const iq_client_t *c);
+const iq_client_stream_t *iq_client_stream(const iq_client_t *c);
+void iq_client_get_stats(const iq_client_t *c, iq_client_stats_t *stats);
+
+/** Bytes per I/Q pair for a sample format (0 if unknown) */
+uint32_t iq_client_pair_bytes(uint32_t sample_format);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IQ_CLIENT_H */
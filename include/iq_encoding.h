@@ -0,0 +1,115 @@
+/**
+ * @file iq_encoding.h
+ * @brief Compact sample encodings for the FT32 relay streams
+ *
+ * The splitter/relay streams carry float32 I/Q: 8 bytes per pair, 400 kB/s
+ * for the 50 kHz detector stream. A client can ask for a smaller encoding;
+ * the frame layout stays FT32 / DATA and only the payload changes:
+ *
+ *   F32   8 B/pair   float32 I/Q, verbatim
+ *   S16   4 B/pair   int16, one float scale per frame
+ *   S8    ~2 B/pair  int8 block floating point: one exponent byte per
+ *                    IQ_ENC_S8_BLOCK pairs, so quiet blocks keep resolution
+ *   ULAW  2 B/pair   G.711 mu-law companded, one float scale per frame -
+ *                    constant ~38 dB SNR per sample over a wide range,
+ *                    below what a dB-scaled waterfall can show
+ *
+ * On the wire:
+ *   - the FT32 stream header's reserved1 field carries the encoding
+ *     (0 = F32, so existing streams are unchanged)
+ *   - each DATA frame's reserved field carries the frame scale as float32
+ *     bits (unused for F32 and S8)
+ *   - payloads are padded to a multiple of 4 bytes so frames stay aligned
+ *
+ * A client selects an encoding by sending an iq_enc_request_t right after
+ * connecting; clients that send nothing get F32.
+ *
+ * Encoders and decoders use SSE2 or NEON where available; the _scalar
+ * variants produce identical output and exist for testing and benchmarks.
+ */
+
+#ifndef IQ_ENCODING_H
+#define IQ_ENCODING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Encodings
+ *============================================================================*/
+
+typedef enum {
+    IQ_ENC_F32 = 0,
+    IQ_ENC_S16,
+    IQ_ENC_S8,
+    IQ_ENC_ULAW,
+    IQ_ENC_COUNT
+} iq_encoding_t;
+
+#define IQ_ENC_S8_BLOCK         16              /* I/Q pairs per S8 exponent */
+
+/*============================================================================
+ * Wire Format
+ *============================================================================*/
+
+#define IQ_ENC_REQUEST_MAGIC    0x454E4351      /* "ENCQ" - client encoding request */
+
+typedef struct {
+    uint32_t magic;             /* IQ_ENC_REQUEST_MAGIC */
+    uint32_t encoding;          /* iq_encoding_t */
+    uint32_t reserved1;
+    uint32_t reserved2;
+} iq_enc_request_t;
+
+/*============================================================================
+ * API
+ *============================================================================*/
+
+/** "f32", "s16", "s8", "ulaw" (NULL if unknown) */
+const char *iq_enc_name(iq_encoding_t enc);
+
+/** Parse a name as printed by iq_enc_name() (case-insensitive) */
+bool iq_enc_parse(const char *name, iq_encoding_t *enc);
+
+/** Payload bytes for a frame of num_samples I/Q pairs (0 if enc is unknown) */
+size_t iq_enc_payload_bytes(iq_encoding_t enc, uint32_t num_samples);
+
+/**
+ * @brief Encode one frame of interleaved float32 I/Q
+ * @param out    iq_enc_payload_bytes(enc, num_samples) bytes
+ * @param scale  Frame scale for the DATA header
+ * @return Payload bytes written
+ */
+size_t iq_enc_encode(iq_encoding_t enc, const float *iq, uint32_t num_samples,
+                     uint8_t *out, float *scale);
+
+/** Decode one frame back to interleaved float32 I/Q (2 * num_samples floats) */
+void iq_enc_decode(iq_encoding_t enc, const uint8_t *in, uint32_t num_samples,
+                   float scale, float *iq);
+
+size_t iq_enc_encode_scalar(iq_encoding_t enc, const float *iq, uint32_t num_samples,
+                            uint8_t *out, float *scale);
+void iq_enc_decode_scalar(iq_encoding_t enc, const uint8_t *in, uint32_t num_samples,
+                          float scale, float *iq);
+
+/** Quality vs. bandwidth for one encoding on a block of samples */
+typedef struct {
+    double bytes_per_pair;
+    double ratio;               /* Size relative to F32 */
+    double snr_db;              /* Signal / encoding error (inf for F32) */
+} iq_enc_quality_t;
+
+/** Encode, decode and compare; false on allocation failure */
+bool iq_enc_measure(iq_encoding_t enc, const float *iq, uint32_t num_samples,
+                    iq_enc_quality_t *quality);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IQ_ENCODING_H */
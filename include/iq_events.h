@@ -0,0 +1,173 @@
+/**
+ * @file iq_events.h
+ * @brief Sample-accurate event markers carried in-band in the I/Q stream
+ *
+ * With event markers enabled (sdr_server -E, stream header version 2), each
+ * IQDQ frame carries the number of markers in the top byte of its flags.
+ * The markers follow the 16-byte frame header, before the samples:
+ *
+ *   iq_data_frame_t | iq_event_t x IQ_EVENT_COUNT(flags) | samples
+ *
+ * Each marker names the first sample of the frame it applies to, so a
+ * consumer can rescale or blank exactly the affected samples.
+ *
+ * Producer side (sdr_server): iq_marker_queue_t collects markers against an
+ * absolute sample count from the SDRplay stream and event threads, and the
+ * I/Q thread takes the ones that fall inside each frame it sends.
+ *
+ * Consumer side (waterfall, signal_splitter): iq_conditioner_t applies the
+ * markers to a frame of float samples and reports which samples must not
+ * drive noise-floor or AGC adaptation.
+ */
+
+#ifndef IQ_EVENTS_H
+#define IQ_EVENTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Wire Format
+ *============================================================================*/
+
+#define IQ_STREAM_VERSION_EVENTS    2       /* PHXI version when markers are sent */
+
+#define IQ_EVENT_COUNT_SHIFT        24
+#define IQ_EVENT_COUNT(flags)       ((uint32_t)(flags) >> IQ_EVENT_COUNT_SHIFT)
+#define IQ_MAX_FRAME_EVENTS         32      /* Extra markers in one frame are dropped */
+
+typedef enum {
+    IQ_EVENT_GAIN = 1,                  /* Hardware gain took effect at this sample */
+    IQ_EVENT_OVERLOAD,                  /* ADC overload detected (value 1) or cleared (0) */
+    IQ_EVENT_FREQ,                      /* Tuner retuned at this sample */
+    IQ_EVENT_DISCONTINUITY              /* Samples lost or stream reset before this sample */
+} iq_event_type_t;
+
+#pragma pack(push, 1)
+typedef struct {
+    uint32_t offset;                    /* Sample index within the frame */
+    uint16_t type;                      /* iq_event_type_t */
+    int16_t  aux;                       /* GAIN: LNA gain reduction (dB) */
+    int32_t  value;                     /* GAIN: system gain (0.01 dB); OVERLOAD: 1/0;
+                                           FREQ: center frequency (Hz);
+                                           DISCONTINUITY: samples lost (0 = unknown) */
+    int32_t  delta;                     /* GAIN: change since the previous GAIN (0.01 dB) */
+} iq_event_t;
+#pragma pack(pop)
+
+/*============================================================================
+ * Producer: Marker Queue
+ *============================================================================*/
+
+typedef struct iq_marker_queue iq_marker_queue_t;
+
+/**
+ * @brief Create a marker queue
+ * @param capacity  Markers held (rounded up to a power of two)
+ */
+iq_marker_queue_t *iq_marker_queue_create(size_t capacity);
+
+void iq_marker_queue_destroy(iq_marker_queue_t *q);
+
+/**
+ * @brief Post a marker at an absolute sample position (any thread, lock-free)
+ *
+ * Markers must be posted in non-decreasing position order per producer.
+ *
+ * @return false if the queue was full and the marker was dropped
+ */
+bool iq_marker_queue_post(iq_marker_queue_t *q, uint64_t position,
+                          iq_event_type_t type, int16_t aux, int32_t value);
+
+/**
+ * @brief Take the markers that fall inside a frame (single consumer)
+ *
+ * Removes markers positioned before first_sample + num_samples and converts
+ * them to frame offsets. Markers older than the frame (their samples were
+ * dropped) land on offset 0.
+ *
+ * @param out  Room for max markers; extra markers are discarded
+ * @return Number of markers written
+ */
+int iq_marker_queue_take(iq_marker_queue_t *q, uint64_t first_sample,
+                         uint32_t num_samples, iq_event_t *out, int max);
+
+/**
+ * @brief Discard all pending markers (single consumer) - e.g. a new client
+ */
+void iq_marker_queue_clear(iq_marker_queue_t *q);
+
+/**
+ * @brief Markers dropped because the queue was full or a frame held too many
+ */
+uint64_t iq_marker_queue_dropped(iq_marker_queue_t *q);
+
+/*============================================================================
+ * Consumer: Conditioner
+ *============================================================================*/
+
+#define IQ_COND_GAIN_SETTLE_US      1000    /* Blanked after a gain step */
+#define IQ_COND_RETUNE_SETTLE_US    5000    /* Held after a retune or gap */
+#define IQ_COND_OVERLOAD_BLANK_MS   50      /* Longest overload span blanked */
+
+typedef struct {
+    /* Configuration (set by init, may be changed after) */
+    bool     rescale;                   /* Undo hardware gain steps */
+    uint32_t gain_settle;               /* Samples blanked after a gain step */
+    uint32_t retune_settle;             /* Samples held after a retune or gap */
+    uint32_t overload_max_blank;        /* Overload samples blanked before passing through */
+
+    /* State */
+    int32_t  gain_offset_cdb;           /* Gain compensation in effect (0.01 dB) */
+    float    scale;
+    uint32_t blank_left;
+    uint32_t hold_left;
+    bool     overloaded;
+    uint32_t overload_blanked;
+
+    /* Statistics */
+    uint64_t events;
+    uint64_t samples_blanked;
+    uint64_t samples_held;              /* Includes blanked samples */
+} iq_conditioner_t;
+
+/**
+ * @brief Initialize with default settle times for the given input rate
+ */
+void iq_conditioner_init(iq_conditioner_t *c, uint32_t sample_rate);
+
+/**
+ * @brief Clear state and statistics, keep configuration (e.g. reconnect)
+ */
+void iq_conditioner_reset(iq_conditioner_t *c);
+
+/**
+ * @brief Apply a frame's markers to its samples in place
+ *
+ * - GAIN: samples from the marker on are scaled to undo the step, and the
+ *   settle window after it is blanked (zeroed).
+ * - OVERLOAD: samples are blanked until the overload clears, up to
+ *   overload_max_blank; the whole span is held.
+ * - FREQ, DISCONTINUITY: the settle window after the marker is held.
+ *
+ * Blanking and holding carry over into following frames.
+ *
+ * @param iq      Interleaved float I/Q, num_samples pairs
+ * @param hold    Per-sample output: 1 where adaptation must freeze (may be NULL)
+ * @param events  Markers for this frame, in offset order (may be NULL if n_events is 0)
+ * @return Number of samples held in this frame
+ */
+uint32_t iq_conditioner_apply(iq_conditioner_t *c, float *iq, uint8_t *hold,
+                              uint32_t num_samples,
+                              const iq_event_t *events, uint32_t n_events);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IQ_EVENTS_H */
@@ -0,0 +1,162 @@
+/**
+ * @file iq_framer.h
+ * @brief Adaptive IQDQ framing and socket sizing for the sdr_server I/Q stream
+ *
+ * The I/Q thread used to send whatever the ring held each time it woke -
+ * one small frame per SDR callback, three send() calls each. The framer
+ * decides instead:
+ *
+ *   - Frame size: how many samples to wait for before a frame goes out.
+ *     It doubles while the socket is backed up or frames arrive well inside
+ *     the latency budget, and halves when a frame's oldest sample was over
+ *     budget by the time send() returned. It stays between
+ *     IQ_FRAMER_MIN_SAMPLES and the smaller of IQ_FRAMER_MAX_SAMPLES and
+ *     half the budget's worth of samples.
+ *   - Short frames: a frame goes out early once its oldest sample has waited
+ *     half the budget, so a slow rate or a stalled callback never holds
+ *     samples past it.
+ *   - Coalescing: while the socket is not writable, finished frames are
+ *     packed back to back and go out as one send() when it drains (or the
+ *     batch reaches IQ_FRAMER_BATCH_BYTES).
+ *   - Buffer sizes: SO_SNDBUF from the bandwidth-delay product and the
+ *     TCP_NOTSENT_LOWAT mark, so the kernel holds about one RTT of data in
+ *     flight and a couple of frames unsent instead of seconds of samples.
+ *
+ * Frames never exceed 8192 samples: waterfall, signal_splitter and
+ * iq_client size their buffers for that.
+ *
+ * Latency is measured from the SDR callback that delivered a sample to the
+ * return of the send() that carried it. The framer keeps the callback
+ * arrival times itself (iq_framer_arrived()); no clocks or sockets are
+ * touched here, the caller passes times in microseconds.
+ *
+ * Threading: iq_framer_arrived() from the SDR callback thread (wait-free),
+ * everything else from the I/Q thread.
+ */
+
+#ifndef IQ_FRAMER_H
+#define IQ_FRAMER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define IQ_FRAMER_MIN_SAMPLES           512
+#define IQ_FRAMER_MAX_SAMPLES           8192                /* Largest frame receivers accept */
+#define IQ_FRAMER_DEFAULT_LATENCY_MS    20
+#define IQ_FRAMER_BATCH_BYTES           (512 * 1024)        /* Largest coalesced send */
+#define IQ_FRAMER_ARRIVALS              256                 /* Callback arrival times kept */
+#define IQ_FRAMER_WINDOW_US             1000000             /* Statistics window */
+
+#define IQ_FRAMER_DEFAULT_RTT_US        50000               /* Until the socket reports one */
+#define IQ_FRAMER_SNDBUF_MIN            (64 * 1024)
+#define IQ_FRAMER_SNDBUF_MAX            (16 * 1024 * 1024)
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct iq_framer iq_framer_t;
+
+/** Last completed statistics window, plus running totals */
+typedef struct {
+    double   frames_per_sec;
+    double   sends_per_sec;
+    double   frames_per_send;
+    double   mbytes_per_sec;
+    double   syscalls_per_mb;           /* send() and socket probes/options per MB */
+    double   latency_avg_ms;            /* Oldest sample of each send, callback to send() return */
+    double   latency_max_ms;
+    uint32_t frame_samples;             /* Current target */
+    uint64_t frames;                    /* Totals since iq_framer_reset() */
+    uint64_t sends;
+    uint64_t bytes;
+    uint64_t late_sends;                /* Over the latency budget */
+} iq_framer_stats_t;
+
+/*============================================================================
+ * API
+ *============================================================================*/
+
+iq_framer_t *iq_framer_create(uint32_t latency_ms);
+
+void iq_framer_destroy(iq_framer_t *f);
+
+/** New stream: frame size back to the budget cap, statistics cleared */
+void iq_framer_reset(iq_framer_t *f);
+
+/** Stream rate; pair_bytes is the size of one I/Q pair on the wire */
+void iq_framer_set_rate(iq_framer_t *f, uint32_t sample_rate, uint32_t pair_bytes);
+
+uint32_t iq_framer_latency_ms(const iq_framer_t *f);
+
+/**
+ * @brief Note that samples up to stream position end arrived at now_us
+ *        (SDR callback thread, wait-free)
+ */
+void iq_framer_arrived(iq_framer_t *f, uint64_t end, uint64_t now_us);
+
+/**
+ * @brief Arrival time of the sample at stream position pos
+ * @return 0 if it has not arrived; the oldest kept time if it is older
+ */
+uint64_t iq_framer_arrival_us(const iq_framer_t *f, uint64_t pos);
+
+/**
+ * @brief Samples to put in the next frame, or 0 to keep waiting
+ * @param first      Stream position of the oldest sample not yet framed
+ * @param available  Samples waiting from first on
+ */
+uint32_t iq_framer_take(const iq_framer_t *f, uint64_t first, size_t available, uint64_t now_us);
+
+/**
+ * @brief Whether a batch should go out now
+ * @param batch_bytes  Bytes framed but not sent
+ * @param writable     The socket can take data without blocking
+ *
+ * True when the socket is writable, or when one more frame might not fit
+ * in IQ_FRAMER_BATCH_BYTES.
+ */
+bool iq_framer_should_send(const iq_framer_t *f, size_t batch_bytes, bool writable);
+
+/**
+ * @brief Account for one send() and adapt the frame size
+ * @param frames      IQDQ frames in the send
+ * @param bytes       Bytes sent (headers included)
+ * @param syscalls    Socket calls spent on it (send, probes, option changes)
+ * @param backed_up   The socket was not writable while the batch was built
+ * @param first       Stream position of the batch's oldest sample
+ * @return true when a statistics window closed (once per IQ_FRAMER_WINDOW_US)
+ */
+bool iq_framer_sent(iq_framer_t *f, uint32_t frames, size_t bytes, uint32_t syscalls,
+                    bool backed_up, uint64_t first, uint64_t now_us);
+
+/** Samples per frame the framer is aiming for now */
+uint32_t iq_framer_frame_samples(const iq_framer_t *f);
+
+/**
+ * @brief SO_SNDBUF for the measured RTT (0 = unknown, use the default)
+ *
+ * Two bandwidth-delay products at the larger of the nominal stream rate and
+ * the last window's send rate, plus one full batch.
+ */
+size_t iq_framer_sndbuf(const iq_framer_t *f, uint32_t rtt_us);
+
+/** TCP_NOTSENT_LOWAT: two of the largest frames */
+size_t iq_framer_notsent_lowat(const iq_framer_t *f);
+
+void iq_framer_get_stats(const iq_framer_t *f, iq_framer_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IQ_FRAMER_H */
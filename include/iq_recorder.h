@@ -34,19 +34,38 @@ extern "C" {
  *   - LNA State:    4 bytes  uint32_t
  *   - Start Time:   8 bytes  int64_t (Unix timestamp, microseconds)
  *   - Sample Count: 8 bytes  uint64_t (updated on close)
- *   - Flags:        4 bytes  uint32_t (reserved)
- *   - Reserved:     8 bytes  (padding to 64 bytes)
+ *   - Flags:        4 bytes  uint32_t (IQR_FLAG_*)
+ *   - CRC Block:    4 bytes  uint32_t (sample pairs per CRC block, 0 = none)
+ *   - Reserved:     4 bytes  (padding to 64 bytes)
  * 
  * Data (after header):
  *   - Interleaved I/Q samples: I0, Q0, I1, Q1, ...
  *   - Each sample is int16_t (little-endian)
  *   - 4 bytes per sample pair
+ * 
+ * Trailer chunks (optional, right after the data, written by iqr_stop()):
+ *   Each is a 16-byte iqr_chunk_t followed by entry_count fixed-size
+ *   entries, so a reader can skip chunks it does not know.
+ * 
+ *   "IQRT" timing track (IQR_FLAG_TIMING_TRACK): iqr_timing_entry_t,
+ *          24 bytes, ordered by sample index and UTC, so the entry array
+ *          is its own index
+ *   "IQRC" block CRCs (IQR_FLAG_CRC32C): one uint32_t CRC-32C per
+ *          crc_block_samples pairs of data (the last block may be short)
+ * 
+ * Readers that bound reads by sample_count (every reader in this tree)
+ * never see the trailer, so files with one are still plain version 1.
  */
 
 #define IQR_MAGIC       "IQR1"
 #define IQR_VERSION     1
 #define IQR_HEADER_SIZE 64
 
+#define IQR_FLAG_TIMING_TRACK   0x00000001u
+#define IQR_FLAG_CRC32C         0x00000002u
+
+#define IQR_CRC_DEFAULT_BLOCK   65536   /* Sample pairs (256 KiB) per CRC */
+
 #pragma pack(push, 1)
 typedef struct {
     char        magic[4];       /* "IQR1" */
@@ -58,8 +77,9 @@ typedef struct {
     uint32_t    lna_state;      /* LNA state */
     int64_t     start_time_us;  /* Recording start (Unix time, microseconds) */
     uint64_t    sample_count;   /* Total samples recorded */
-    uint32_t    flags;          /* Reserved flags */
-    uint8_t     reserved[8];    /* Padding to 64 bytes */
+    uint32_t    flags;          /* IQR_FLAG_* */
+    uint32_t    crc_block_samples; /* Pairs per CRC block, 0 = no CRCs */
+    uint8_t     reserved[4];    /* Padding to 64 bytes */
 } iqr_header_t;
 #pragma pack(pop)
 
@@ -67,6 +87,34 @@ typedef struct {
 _Static_assert(sizeof(iqr_header_t) == IQR_HEADER_SIZE, 
                "IQR header must be exactly 64 bytes");
 
+#define IQR_TIMING_MAGIC        "IQRT"
+#define IQR_CRC_MAGIC           "IQRC"
+
+/* iqr_timing_entry_t.flags */
+#define IQR_TIMING_GPS          0x01    /* utc_us from a GPS fix, not the PC clock */
+#define IQR_TIMING_PPS          0x02    /* utc_us is a PPS second edge */
+#define IQR_TIMING_OVERLOAD     0x04    /* ADC overload since the previous entry */
+
+#pragma pack(push, 1)
+typedef struct {
+    char        magic[4];       /* "IQRT", "IQRC" */
+    uint32_t    entry_size;     /* Bytes per entry */
+    uint64_t    entry_count;
+} iqr_chunk_t;
+
+typedef struct {
+    uint64_t    sample_index;   /* Sample pair the timestamp applies to */
+    int64_t     utc_us;         /* Unix time, microseconds */
+    int32_t     gain_reduction; /* Gain reduction dB at that point */
+    uint8_t     lna_state;
+    uint8_t     flags;          /* IQR_TIMING_* */
+    uint8_t     reserved[2];
+} iqr_timing_entry_t;
+#pragma pack(pop)
+
+_Static_assert(sizeof(iqr_chunk_t) == 16, "IQR chunk header must be 16 bytes");
+_Static_assert(sizeof(iqr_timing_entry_t) == 24, "IQR timing entry must be 24 bytes");
+
 /*============================================================================
  * Error Codes
  *============================================================================*/
@@ -160,6 +208,9 @@ iqr_error_t iqr_write(
  * @brief Stop recording and finalize file
  * 
  * Flushes buffers and updates header with final sample count.
+ * If the trailer cannot be written, the file is cut back to the samples
+ * and the header still gets the sample count, without the timing/CRC
+ * flags; the trailer's error is returned.
  * 
  * @param rec  Recorder instance
  * @return Error code
@@ -190,6 +241,33 @@ uint64_t iqr_get_sample_count(const iqr_recorder_t *rec);
  */
 double iqr_get_duration(const iqr_recorder_t *rec);
 
+/**
+ * @brief Record a CRC-32C per block of samples
+ * 
+ * Takes effect at the next iqr_start(). The CRCs are computed as the
+ * buffer is flushed and written after the samples by iqr_stop();
+ * iqr_verify() checks them. Off by default.
+ * 
+ * @param rec            Recorder instance
+ * @param block_samples  Sample pairs per block (0 disables,
+ *                       IQR_CRC_DEFAULT_BLOCK is a good choice)
+ * @return Error code (IQR_ERR_ALREADY_RECORDING while recording)
+ */
+iqr_error_t iqr_set_crc_block(iqr_recorder_t *rec, uint32_t block_samples);
+
+/**
+ * @brief Add a timing track entry
+ * 
+ * Entries are kept in memory and written after the samples by iqr_stop().
+ * Both sample_index and utc_us must increase from one entry to the next;
+ * out-of-order entries are refused.
+ * 
+ * @param rec    Recorder instance
+ * @param entry  Entry to append (sample_index usually iqr_get_sample_count())
+ * @return Error code (IQR_ERR_INVALID_ARG if out of order)
+ */
+iqr_error_t iqr_add_timing(iqr_recorder_t *rec, const iqr_timing_entry_t *entry);
+
 /*============================================================================
  * Playback/Reader API (for offline analysis)
  *============================================================================*/
@@ -255,6 +333,80 @@ iqr_error_t iqr_seek(iqr_reader_t *reader, uint64_t sample);
  */
 iqr_error_t iqr_rewind(iqr_reader_t *reader);
 
+/**
+ * @brief Get the timing track loaded by iqr_open()
+ * 
+ * @param reader  Reader instance
+ * @param count   Receives the number of entries (0 if the file has no track)
+ * @return Entries, ordered by sample and UTC (NULL if none)
+ */
+const iqr_timing_entry_t* iqr_get_timing(const iqr_reader_t *reader, size_t *count);
+
+/**
+ * @brief Map a UTC instant to a sample index
+ * 
+ * Binary search for the surrounding timing entries, then interpolation
+ * between them, so the result follows the real sample clock rather than
+ * the nominal rate. Outside the track (or with no track, e.g. older
+ * files) it extrapolates at the nominal rate from the nearest entry or
+ * from the header start time. Clipped to [0, sample_count].
+ * 
+ * @param reader  Reader instance
+ * @param utc_us  Unix time, microseconds
+ * @param sample  Receives the sample index
+ * @return Error code
+ */
+iqr_error_t iqr_sample_at_utc(const iqr_reader_t *reader, int64_t utc_us, uint64_t *sample);
+
+/**
+ * @brief Seek to the sample at a UTC instant
+ * 
+ * @param reader  Reader instance
+ * @param utc_us  Unix time, microseconds
+ * @return Error code
+ */
+iqr_error_t iqr_seek_utc(iqr_reader_t *reader, int64_t utc_us);
+
+/*============================================================================
+ * Integrity Check
+ *============================================================================*/
+
+typedef struct {
+    double   sample_rate_hz;
+    uint64_t sample_count;      /* Declared in the header */
+    uint64_t samples_present;   /* Actually in the file */
+    uint32_t block_samples;     /* 0 if the file carries no CRCs */
+    uint64_t blocks_checked;
+    uint64_t blocks_bad;
+} iqr_verify_result_t;
+
+/**
+ * @brief Damaged sample range [first, end), adjacent bad blocks merged
+ */
+typedef void (*iqr_damage_fn)(uint64_t first, uint64_t end, void *user);
+
+/**
+ * @brief Check a recording against its block CRCs
+ * 
+ * Reads the file front to back once. Samples missing from a truncated
+ * file are reported as one damaged range; a truncated file has also lost
+ * its CRCs, so its remaining blocks can't be checked (block_samples is 0
+ * then, as for files recorded without CRCs).
+ * 
+ * Opens its own handle and prints nothing, so several files can be
+ * checked at once from different threads.
+ * 
+ * @param filename     Recording to check
+ * @param buffer       Read buffer (NULL to allocate one internally)
+ * @param buffer_size  Buffer size in bytes
+ * @param on_damage    Called for each damaged range (may be NULL)
+ * @param user         Passed to on_damage
+ * @param result       Receives counts
+ * @return Error code (IQR_OK even when damage was found)
+ */
+iqr_error_t iqr_verify(const char *filename, void *buffer, size_t buffer_size,
+                       iqr_damage_fn on_damage, void *user, iqr_verify_result_t *result);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,209 @@
+/**
+ * @file iqr_export.h
+ * @brief IQR interchange formats - WAV/RF64, SigMF, raw cf32/cs16
+ *
+ * Format helpers behind the iqr_convert tool: container headers, sample
+ * conversion and UTC time-range slicing. Everything here works on memory
+ * buffers or an already-open FILE, so the tool owns all bulk I/O.
+ *
+ * Sample conventions:
+ *   - cs16: interleaved int16 I/Q, little-endian (the .iqr payload)
+ *   - cf32: interleaved float I/Q, little-endian, full scale = 1.0
+ *           (int16 value / 32768, same scaling as the decimator)
+ *   - WAV:  2 channels, left = I, right = Q, 16-bit PCM or 32-bit float
+ */
+
+#ifndef IQR_EXPORT_H
+#define IQR_EXPORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "iqr_meta.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Formats
+ *============================================================================*/
+
+typedef enum {
+    IQR_FMT_UNKNOWN = 0,
+    IQR_FMT_IQR,                /* Phoenix .iqr (64-byte header + cs16) */
+    IQR_FMT_WAV,                /* RIFF/RF64 WAVE, 2 channels */
+    IQR_FMT_SIGMF,              /* .sigmf-data + .sigmf-meta */
+    IQR_FMT_CF32,               /* Headerless interleaved float */
+    IQR_FMT_CS16                /* Headerless interleaved int16 */
+} iqr_format_t;
+
+typedef enum {
+    IQR_SAMPLE_CS16 = 0,
+    IQR_SAMPLE_CF32
+} iqr_sample_type_t;
+
+/** Stream description shared by every container */
+typedef struct {
+    iqr_sample_type_t type;
+    double   sample_rate_hz;
+    double   center_freq_hz;    /* 0 if unknown */
+    uint32_t bandwidth_khz;
+    int32_t  gain_reduction;
+    uint32_t lna_state;
+    int64_t  start_time_us;     /* UTC of first sample (Unix us), 0 if unknown */
+    uint64_t sample_count;      /* Complex samples */
+} iqr_stream_info_t;
+
+/**
+ * @brief Parse a format name ("iqr", "wav", "sigmf", "cf32", "cs16")
+ */
+iqr_format_t iqr_format_from_name(const char *name);
+
+/**
+ * @brief Guess a format from a file extension
+ *
+ * .iqr, .wav, .sigmf-data/.sigmf-meta/.sigmf, .cf32/.fc32, .cs16/.sc16
+ */
+iqr_format_t iqr_format_from_path(const char *path);
+
+const char *iqr_format_name(iqr_format_t fmt);
+
+/**
+ * @brief Bytes per complex sample
+ */
+static inline size_t iqr_sample_bytes(iqr_sample_type_t type) {
+    return (type == IQR_SAMPLE_CF32) ? 2 * sizeof(float) : 2 * sizeof(int16_t);
+}
+
+/*============================================================================
+ * Sample Conversion
+ *============================================================================*/
+
+/**
+ * @brief int16 -> float, scaled by 1/32768
+ * @param count  Number of values (2 per complex sample)
+ *
+ * Uses SSE2 or NEON when available.
+ */
+void iqr_convert_s16_f32(const int16_t *in, float *out, size_t count);
+
+/**
+ * @brief float -> int16, scaled by 32768, rounded, saturated
+ */
+void iqr_convert_f32_s16(const float *in, int16_t *out, size_t count);
+
+/* Scalar reference implementations (used for tails and by tests) */
+void iqr_convert_s16_f32_scalar(const int16_t *in, float *out, size_t count);
+void iqr_convert_f32_s16_scalar(const float *in, int16_t *out, size_t count);
+
+/*============================================================================
+ * WAV / RF64
+ *============================================================================*/
+
+/**
+ * Output header layout (80 bytes, fixed):
+ *   RIFF/RF64 (12) + JUNK/ds64 (36) + fmt (24) + data (8)
+ *
+ * A 28-byte JUNK chunk reserves room for the ds64 chunk, so a file that
+ * grows past 4 GB is promoted to RF64 by rewriting the header in place
+ * (EBU Tech 3306). Readers that don't know RF64 see a normal WAV below 4 GB.
+ */
+#define IQR_WAV_HEADER_SIZE     80
+
+typedef struct {
+    uint32_t sample_rate;
+    iqr_sample_type_t type;
+    bool     is_rf64;
+    uint64_t data_offset;       /* Byte offset of first sample */
+    uint64_t data_bytes;        /* Payload size (clipped to the file by caller) */
+} iqr_wav_info_t;
+
+/**
+ * @brief Build the 80-byte header for a payload of data_bytes
+ *
+ * Writes plain RIFF when everything fits in 32 bits, RF64 otherwise.
+ */
+void iqr_wav_build_header(uint8_t *buf, uint32_t sample_rate,
+                          iqr_sample_type_t type, uint64_t data_bytes);
+
+/**
+ * @brief Parse a RIFF or RF64 header from the start of a file
+ *
+ * Accepts 2-channel 16-bit PCM and 32-bit IEEE float (also in
+ * WAVE_FORMAT_EXTENSIBLE). The data chunk must start within buf.
+ *
+ * @return false if the header is not a usable I/Q WAV
+ */
+bool iqr_wav_parse_header(const uint8_t *buf, size_t len, iqr_wav_info_t *info);
+
+/*============================================================================
+ * SigMF
+ *============================================================================*/
+
+/**
+ * @brief Write a .sigmf-meta document
+ *
+ * Global: datatype, sample_rate, version, recorder.
+ * Captures: one capture with frequency and datetime, plus the .iqr gain
+ * settings in the "phoenix:" extension namespace.
+ * Annotations: the recording's timing provenance from .meta (time source,
+ * GPS fix, PC offset) spanning the whole capture, and one annotation per
+ * UTC minute boundary inside it.
+ *
+ * @param meta          Source .meta, or NULL if there is none
+ * @param source_offset First sample's index in the source recording
+ * @return 0 on success, -1 on write error
+ */
+int iqr_sigmf_write_meta(FILE *f, const iqr_stream_info_t *info,
+                         const iqr_meta_t *meta, uint64_t source_offset);
+
+/**
+ * @brief Pick the fields iqr_convert needs out of a .sigmf-meta document
+ *
+ * Reads core:datatype (ci16_le or cf32_le), core:sample_rate, and the first
+ * capture's core:frequency and core:datetime. Not a general JSON parser.
+ *
+ * @return false if the datatype is unsupported or sample_rate is missing
+ */
+bool iqr_sigmf_parse_meta(const char *json, iqr_stream_info_t *info);
+
+/*============================================================================
+ * UTC Time and Slicing
+ *============================================================================*/
+
+/**
+ * @brief Parse a UTC time
+ *
+ * Accepts "YYYY-MM-DDTHH:MM:SS[.ffffff][Z]" (space also allowed as the
+ * separator) or a bare "HH:MM:SS[.ffffff]", which is taken on the UTC date
+ * of day_ref_us.
+ *
+ * @return false on malformed input
+ */
+bool iqr_parse_utc(const char *text, int64_t day_ref_us, int64_t *out_us);
+
+/**
+ * @brief Format Unix microseconds as "YYYY-MM-DDTHH:MM:SS.ffffffZ"
+ */
+void iqr_format_utc(int64_t time_us, char *buf, size_t size);
+
+/**
+ * @brief Map a UTC range to a sample range
+ *
+ * Sample n is at start_time_us + n / sample_rate. The slice holds every
+ * sample with from_us <= t < to_us, clipped to the recording. Pass 0 for
+ * an open end.
+ *
+ * @return false if a bound is given but the stream has no start time, or
+ *         the slice is empty
+ */
+bool iqr_slice_range(const iqr_stream_info_t *info, int64_t from_us, int64_t to_us,
+                     uint64_t *first, uint64_t *count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IQR_EXPORT_H */
@@ -0,0 +1,113 @@
+/**
+ * @file noise_blanker.h
+ * @brief Impulse noise blanker for the full-rate S16 I/Q stream
+ *
+ * Lightning crashes and switching-supply hash are short, strong and
+ * wideband. At 2 MHz they stand well clear of the noise; after the 5 kHz
+ * lowpass and decimation they are smeared into the detector band, where
+ * they look like ticks and markers. The blanker removes them first:
+ *
+ *   - average |x|: mean of |I| and |Q| over 64-pair chunks, each value
+ *     clipped at the trigger level so impulses barely move it, smoothed
+ *     with a time constant of average_ms
+ *   - trigger: |I| or |Q| above threshold x average
+ *   - blank: lookahead_us before each trigger to hang_us after it, with
+ *     zeros, or the last good pair held and then a straight line to the
+ *     next good pair once it is in the look-ahead
+ *
+ * The output is the input delayed by the look-ahead, so the rising edge
+ * before a trigger can still be blanked. Blanked windows that touch merge
+ * into one impulse.
+ *
+ * All arithmetic is integer and follows the stream, not the blocks, so any
+ * block split gives the same output. The detection uses compiler vector
+ * extensions (GCC >= 9, clang) and plain C elsewhere; the _scalar variant
+ * gives identical output for testing.
+ *
+ * Threading: one thread per blanker.
+ */
+
+#ifndef NOISE_BLANKER_H
+#define NOISE_BLANKER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define NB_CHUNK                64          /* Pairs per average update */
+#define NB_MAX_LOOKAHEAD        1024        /* Pairs */
+#define NB_MIN_LEVEL            32          /* No triggers below this |x| (digital silence) */
+
+#define NB_DEFAULT_THRESHOLD    6.0f
+#define NB_DEFAULT_LOOKAHEAD_US 8.0f
+#define NB_DEFAULT_HANG_US      16.0f
+#define NB_DEFAULT_AVERAGE_MS   10.0f
+
+typedef enum {
+    NB_MODE_ZERO = 0,               /* Blanked pairs are zero */
+    NB_MODE_INTERPOLATE             /* Hold the last good pair, then ramp to the next */
+} nb_mode_t;
+
+typedef struct {
+    float     sample_rate;
+    float     threshold;            /* Trigger at threshold x average |x| */
+    float     lookahead_us;         /* Blanked before a trigger; also the output delay */
+    float     hang_us;              /* Blanked after a trigger */
+    float     average_ms;           /* Rounded to a power of two chunks */
+    nb_mode_t mode;
+} noise_blanker_config_t;
+
+typedef struct {
+    uint64_t pairs;                 /* Pairs out */
+    uint64_t blanked;               /* ... of which blanked */
+    uint64_t impulses;              /* Blanked windows, after merging */
+    uint32_t average;               /* Current average |x|, S16 units */
+    uint32_t level;                 /* Current trigger level */
+} noise_blanker_stats_t;
+
+typedef struct noise_blanker noise_blanker_t;
+
+/*============================================================================
+ * API
+ *============================================================================*/
+
+/** Defaults above, interpolating */
+void noise_blanker_default_config(noise_blanker_config_t *cfg, float sample_rate);
+
+/**
+ * @return NULL if the rate or threshold is not positive, or the look-ahead
+ *         exceeds NB_MAX_LOOKAHEAD pairs
+ */
+noise_blanker_t *noise_blanker_create(const noise_blanker_config_t *cfg);
+void noise_blanker_destroy(noise_blanker_t *nb);
+
+/** Back to the created state: empty delay line, no average */
+void noise_blanker_reset(noise_blanker_t *nb);
+
+/** Output delay in pairs */
+int noise_blanker_delay(const noise_blanker_t *nb);
+
+/**
+ * @brief Blank interleaved S16 I/Q
+ *
+ * out[k] is in[k - delay], blanked; the first delay pairs after a reset
+ * are zero. out may be in.
+ */
+void noise_blanker_process(noise_blanker_t *nb, const int16_t *iq, int16_t *out, size_t count);
+void noise_blanker_process_scalar(noise_blanker_t *nb, const int16_t *iq, int16_t *out, size_t count);
+
+void noise_blanker_get_stats(const noise_blanker_t *nb, noise_blanker_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NOISE_BLANKER_H */
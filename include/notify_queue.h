@@ -0,0 +1,114 @@
+/**
+ * @file notify_queue.h
+ * @brief Wait-free hand-off of SDR events to the control-plane thread
+ *
+ * The SDRplay API reports gain changes and power overload on its own event
+ * thread. Those callbacks must return quickly, so they only post here; the
+ * control-plane thread drains the queue between commands and does the
+ * logging and the (blocking) send to the control client.
+ *
+ * Events are coalesced rather than queued one by one:
+ *   - Gain change: a single slot, the latest report wins. A client only
+ *     needs to know the hardware's current GR/LNA values.
+ *   - Overload: every DETECTED/CLEARED edge is counted, and edges are
+ *     delivered in order. When a flapping input outruns the drain rate,
+ *     whole DETECTED+CLEARED pairs are collapsed so the client still sees
+ *     alternating edges ending in the current state.
+ *
+ * Threading: any number of posting threads (wait-free: one atomic exchange
+ * or fetch-add per post), one draining thread.
+ */
+
+#ifndef NOTIFY_QUEUE_H
+#define NOTIFY_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define NOTIFY_MAX_EDGES_PER_DRAIN  4       /* Overload edges sent per drain */
+#define NOTIFY_MAX_EVENTS           (NOTIFY_MAX_EDGES_PER_DRAIN + 1)
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct notify_queue notify_queue_t;
+
+typedef enum {
+    NOTIFY_GAIN_CHANGE = 1,
+    NOTIFY_OVERLOAD
+} notify_type_t;
+
+typedef struct {
+    notify_type_t type;
+    int  gr_db;                         /* NOTIFY_GAIN_CHANGE */
+    int  lna_gr_db;
+    bool overloaded;                    /* NOTIFY_OVERLOAD */
+} notify_event_t;
+
+typedef struct {
+    uint64_t gain_posts;
+    uint64_t gain_coalesced;            /* Overwritten before they were drained */
+    uint64_t overload_edges;
+    uint64_t edges_collapsed;           /* Dropped as DETECTED+CLEARED pairs */
+} notify_stats_t;
+
+/*============================================================================
+ * API
+ *============================================================================*/
+
+notify_queue_t *notify_queue_create(void);
+
+void notify_queue_destroy(notify_queue_t *q);
+
+/**
+ * @brief Post a hardware gain report (any thread, wait-free)
+ */
+void notify_post_gain(notify_queue_t *q, int gr_db, int lna_gr_db);
+
+/**
+ * @brief Post the current overload state (any thread, wait-free)
+ *
+ * Repeated reports of the same state are ignored.
+ *
+ * @return true if this report was an edge
+ */
+bool notify_post_overload(notify_queue_t *q, bool overloaded);
+
+/**
+ * @brief Take pending events (drain thread)
+ *
+ * Overload edges come first, oldest first, then the latest gain report.
+ *
+ * @param out  Room for NOTIFY_MAX_EVENTS events
+ * @return Number of events written
+ */
+int notify_queue_drain(notify_queue_t *q, notify_event_t *out);
+
+/**
+ * @brief Discard everything pending (drain thread) - e.g. a new client connected
+ */
+void notify_queue_resync(notify_queue_t *q);
+
+/**
+ * @brief Format an event as a protocol line without the newline
+ *        ("! GAIN_CHANGE GR_ACTUAL=40 LNA_GR=0", "! OVERLOAD DETECTED")
+ */
+void notify_format(const notify_event_t *ev, char *buf, size_t size);
+
+void notify_queue_get_stats(notify_queue_t *q, notify_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NOTIFY_QUEUE_H */
@@ -165,12 +165,32 @@ typedef void (*psdr_overload_callback_t)(
     void *user_ctx
 );
 
+/** Stream change flags for psdr_stream_event_callback_t */
+#define PSDR_STREAM_GR_CHANGED  (1u << 0)   /**< New gain reduction in effect */
+#define PSDR_STREAM_RF_CHANGED  (1u << 1)   /**< New RF frequency in effect */
+#define PSDR_STREAM_FS_CHANGED  (1u << 2)   /**< New sample rate in effect */
+
+/**
+ * @brief Stream change callback
+ *
+ * Called on the streaming thread just before on_samples when a hardware
+ * change takes effect at the first sample of that block. Optional.
+ *
+ * @param flags     PSDR_STREAM_* bits
+ * @param user_ctx  User-provided context pointer
+ */
+typedef void (*psdr_stream_event_callback_t)(
+    uint32_t flags,
+    void *user_ctx
+);
+
 /** Callback set */
 typedef struct {
     psdr_sample_callback_t   on_samples;
     psdr_gain_callback_t     on_gain_change;
     psdr_overload_callback_t on_overload;
     void                    *user_ctx;
+    psdr_stream_event_callback_t on_stream_event;
 } psdr_callbacks_t;
 
 /*============================================================================
@@ -223,6 +243,18 @@ psdr_error_t psdr_enumerate(
  */
 psdr_error_t psdr_open(psdr_context_t **ctx, unsigned int device_idx);
 
+/**
+ * @brief Create SDR context for the device with this serial number
+ *
+ * Indexes can shift once devices are selected; with several devices in
+ * one process, enumerate once and open each by serial.
+ *
+ * @param ctx     Receives allocated context
+ * @param serial  Serial from psdr_enumerate()
+ * @return Error code (PSDR_ERR_INVALID_ARG if no such device)
+ */
+psdr_error_t psdr_open_serial(psdr_context_t **ctx, const char *serial);
+
 /**
  * @brief Configure device (before starting stream)
  *
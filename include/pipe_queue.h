@@ -0,0 +1,106 @@
+/**
+ * @file pipe_queue.h
+ * @brief Bounded block queue between in-process pipeline stages
+ *
+ * What a TCP hop between two processes does (frame, copy into the kernel,
+ * copy out, re-parse), done in memory: a fixed ring of sample blocks
+ * allocated once. The producer reserves the next free block, writes its
+ * samples straight into it and commits it; the consumer reads the block in
+ * place and pops it. Nothing is framed or copied on the way through.
+ *
+ * The queue is bounded, so a slow consumer holds the producer up just as a
+ * full socket buffer would. Both sides can wait with a timeout, and
+ * pipe_queue_close() wakes them for shutdown.
+ *
+ *   producer:  b = pipe_queue_reserve(q, ms); fill b->samples; pipe_queue_commit(q)
+ *   consumer:  b = pipe_queue_front(q, ms);   use b->samples;  pipe_queue_pop(q)
+ *
+ * Threading: one producer thread, one consumer thread.
+ */
+
+#ifndef PIPE_QUEUE_H
+#define PIPE_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define PIPE_QUEUE_WAIT     (-1)            /* Timeout: until there is room / data, or closed */
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct pipe_queue pipe_queue_t;
+
+/** One block; samples are owned by the queue */
+typedef struct {
+    uint32_t stream;                        /* Producer output it belongs to */
+    uint32_t sample_rate;
+    uint32_t sequence;                      /* Per stream, set by the producer */
+    uint32_t count;                         /* I/Q pairs in samples */
+    void    *samples;                       /* Interleaved, capacity pairs of pair_bytes */
+} pipe_block_t;
+
+typedef struct {
+    uint64_t blocks;                        /* Committed */
+    uint64_t pairs;
+    uint64_t full_waits;                    /* reserve() found no free block */
+    uint64_t empty_waits;                   /* front() found nothing queued */
+    uint32_t depth;                         /* Queued now */
+    uint32_t high_water;
+    uint32_t capacity;                      /* Blocks */
+} pipe_queue_stats_t;
+
+/*============================================================================
+ * API
+ *============================================================================*/
+
+/**
+ * @param blocks      Ring size
+ * @param capacity    I/Q pairs per block
+ * @param pair_bytes  Bytes per I/Q pair (4: S16, 8: F32)
+ */
+pipe_queue_t *pipe_queue_create(uint32_t blocks, uint32_t capacity, uint32_t pair_bytes);
+void pipe_queue_destroy(pipe_queue_t *q);
+
+/** I/Q pairs a block holds */
+uint32_t pipe_queue_capacity(const pipe_queue_t *q);
+
+/**
+ * @brief Next free block for the producer
+ * @param timeout_ms  0 to poll, PIPE_QUEUE_WAIT to wait
+ * @return NULL if still full after the timeout, or closed
+ */
+pipe_block_t *pipe_queue_reserve(pipe_queue_t *q, int timeout_ms);
+
+/** Publish the block from pipe_queue_reserve() */
+void pipe_queue_commit(pipe_queue_t *q);
+
+/**
+ * @brief Oldest queued block for the consumer
+ * @return NULL if nothing arrived within the timeout, or closed and drained
+ */
+pipe_block_t *pipe_queue_front(pipe_queue_t *q, int timeout_ms);
+
+/** Release the block from pipe_queue_front() */
+void pipe_queue_pop(pipe_queue_t *q);
+
+/** Refuse further blocks and wake both sides; queued blocks can still be read */
+void pipe_queue_close(pipe_queue_t *q);
+
+void pipe_queue_get_stats(pipe_queue_t *q, pipe_queue_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PIPE_QUEUE_H */
@@ -0,0 +1,158 @@
+/**
+ * @file relay_fanout.h
+ * @brief signal_relay's per-stream fan-out, for the relay and in-process pipelines
+ *
+ * One fan-out serves one FT32 stream port (detector or display):
+ *
+ *   - Connections accepted on the port wait in a pending list until their
+ *     first bytes say what they are: an FT32 header makes a source, an
+ *     iq_enc_request_t a client with that encoding, and silence for
+ *     RELAY_FANOUT_PENDING_MS a float32 client.
+ *   - Source bytes (relay_fanout_feed) are reassembled into DATA frames;
+ *     an in-process source hands whole float32 frames to
+ *     relay_fanout_frame() instead.
+ *   - Each frame is decoded once and encoded once per encoding in use, not
+ *     once per client, and queued in every client's 30 s ring. Clients on
+ *     the source's encoding get its payload untouched.
+ *   - relay_fanout_send() drains the rings without blocking; a client that
+ *     falls 30 s behind loses its oldest data.
+ *
+ * Sockets stay with the caller except clients and pending connections, so
+ * the caller can select() on everything at once: relay_fanout_pending_fds()
+ * lists what to watch, relay_fanout_service_pending() sorts what arrived.
+ *
+ * Threading: one thread per fan-out.
+ */
+
+#ifndef RELAY_FANOUT_H
+#define RELAY_FANOUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#endif
+#include "iq_encoding.h"
+#include "relay_mcast.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define RELAY_FANOUT_MAX_CLIENTS    100
+#define RELAY_FANOUT_CLIENT_BUFFER  (50000 * 30)    /* Bytes per client, 30 s @ 50 kHz (worst case) */
+#define RELAY_FANOUT_PENDING_MAX    16
+#define RELAY_FANOUT_PENDING_MS     500             /* Silent new connection = float32 client */
+#define RELAY_FANOUT_MAX_FRAME      RELAY_MCAST_MAX_FRAME
+
+/*============================================================================
+ * Wire Format (signal_splitter -> signal_relay -> clients)
+ *============================================================================*/
+
+#define RELAY_MAGIC_FT32    0x46543332      /* "FT32" - stream header */
+#define RELAY_MAGIC_DATA    0x44415441      /* "DATA" - data frame */
+
+typedef struct {
+    uint32_t magic;                         /* RELAY_MAGIC_FT32 */
+    uint32_t sample_rate;                   /* Hz (50000 or 12000) */
+    uint32_t reserved1;                     /* iq_encoding_t of the frames that follow */
+    uint32_t reserved2;
+} relay_stream_header_t;
+
+typedef struct {
+    uint32_t magic;                         /* RELAY_MAGIC_DATA */
+    uint32_t sequence;                      /* Frame counter */
+    uint32_t num_samples;                   /* I/Q pairs in frame */
+    uint32_t reserved;                      /* Encoding scale (float bits), 0 for F32 */
+} relay_data_frame_t;
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+#ifdef _WIN32
+typedef SOCKET relay_socket_t;
+#define RELAY_SOCKET_INVALID INVALID_SOCKET
+#else
+typedef int relay_socket_t;
+#define RELAY_SOCKET_INVALID (-1)
+#endif
+
+typedef struct relay_fanout relay_fanout_t;
+
+typedef struct {
+    int      clients;
+    uint64_t clients_served;
+    uint64_t bytes_in;                      /* Source bytes fed */
+    uint64_t frames;                        /* Frames relayed */
+    uint64_t resyncs;                       /* Source bytes skipped hunting for a frame */
+    uint64_t overflows;                     /* Client ring bytes overwritten */
+    int      enc_clients[IQ_ENC_COUNT];
+    uint64_t enc_bytes[IQ_ENC_COUNT];       /* Queued per encoding (once per frame, not per client) */
+    uint64_t enc_f32_bytes[IQ_ENC_COUNT];   /* Same frames as float32 */
+} relay_fanout_stats_t;
+
+/*============================================================================
+ * API
+ *============================================================================*/
+
+/** @param name  Log prefix ("DETECTOR", "DISPLAY") */
+relay_fanout_t *relay_fanout_create(const char *name, uint32_t sample_rate);
+
+/** Close clients, pending connections and multicast (NULL safe) */
+void relay_fanout_destroy(relay_fanout_t *rf);
+
+/** Also send every frame to a multicast group (see relay_mcast.h) */
+bool relay_fanout_open_mcast(relay_fanout_t *rf, const char *group, int port, const char *iface,
+                             int ttl, int fec);
+
+/** Multicast beacon, once per RELAY_MCAST_BEACON_MS (no-op without multicast) */
+void relay_fanout_beacon(relay_fanout_t *rf);
+
+/** false without multicast */
+bool relay_fanout_mcast_stats(const relay_fanout_t *rf, relay_mcast_tx_stats_t *stats);
+
+/** Rate announced to clients that attach from now on */
+void relay_fanout_set_rate(relay_fanout_t *rf, uint32_t sample_rate);
+
+/** Accept one connection from a readable listener into the pending list */
+void relay_fanout_accept(relay_fanout_t *rf, relay_socket_t listener);
+
+/** Pending connections to select() on; returns how many were written */
+int relay_fanout_pending_fds(const relay_fanout_t *rf, relay_socket_t *fds, int max);
+
+/**
+ * @brief Sort pending connections into clients
+ * @return A connection that sent an FT32 header (a source - the caller
+ *         owns it now; call again for more), or RELAY_SOCKET_INVALID
+ */
+relay_socket_t relay_fanout_service_pending(relay_fanout_t *rf);
+
+/** New source: drop any partial frame from the old one */
+void relay_fanout_reset(relay_fanout_t *rf);
+
+/** Bytes from the source connection */
+void relay_fanout_feed(relay_fanout_t *rf, const uint8_t *data, size_t len);
+
+/** A float32 frame from an in-process source */
+void relay_fanout_frame(relay_fanout_t *rf, uint32_t sequence, const float *iq, uint32_t n);
+
+/** Send what the client rings hold, without blocking; drops clients that hung up */
+void relay_fanout_send(relay_fanout_t *rf);
+
+void relay_fanout_get_stats(const relay_fanout_t *rf, relay_fanout_stats_t *stats);
+
+/** Quality of an encoding on the latest frame (false before the first) */
+bool relay_fanout_measure(const relay_fanout_t *rf, iq_encoding_t encoding, iq_enc_quality_t *q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_FANOUT_H */
@@ -0,0 +1,193 @@
+/**
+ * @file relay_mcast.h
+ * @brief UDP multicast transport for the signal_relay float32 streams
+ *
+ * The relay's TCP fan-out costs one copy of every stream per subscriber.
+ * In multicast mode each FT32 DATA frame is cut into MTU-sized datagrams
+ * and sent once to a group; any number of receivers on the segment join it.
+ *
+ * Every datagram starts with a 16-byte header. DATA packets carry a chunk
+ * of one frame, located by (frame_seq, offset), so a lost packet leaves a
+ * hole of known size instead of shifting the samples after it:
+ *
+ *   header (16) | chunk (16) | count x float32 I/Q pairs
+ *
+ * Loss repair is forward error correction, not NACKs: after every
+ * fec_group DATA packets the sender emits one PARITY packet holding the
+ * XOR of their bodies. A receiver recovers any single loss per group
+ * without talking back to the relay, so the relay's cost stays one send
+ * per packet however many receivers there are. Samples that cannot be
+ * recovered are zero-filled so the frame keeps its length and timing.
+ *
+ * A BEACON packet (the FT32 stream header plus counters) goes out once a
+ * second, so receivers that join late learn the stream and idle receivers
+ * can tell a quiet source from a dead relay.
+ *
+ * Threading: one thread per tx/rx object.
+ */
+
+#ifndef RELAY_MCAST_H
+#define RELAY_MCAST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define RELAY_MCAST_GROUP           "239.255.44.10" /* Default group (site-local) */
+#define RELAY_MCAST_PORT            4420            /* Detector stream; display is +1 */
+#define RELAY_MCAST_TTL             1               /* Stay on the local segment */
+#define RELAY_MCAST_DATAGRAM        1472            /* 1500 MTU - IP - UDP */
+#define RELAY_MCAST_FEC_GROUP       8               /* DATA packets per PARITY packet */
+#define RELAY_MCAST_BEACON_MS       1000
+#define RELAY_MCAST_MAX_FRAME       65536           /* Largest frame (I/Q pairs) */
+
+/*============================================================================
+ * Wire Format
+ *============================================================================*/
+
+#define RELAY_MCAST_MAGIC           0x5048584D      /* "PHXM" */
+#define RELAY_MCAST_VERSION         1
+
+typedef enum {
+    RELAY_MCAST_DATA = 1,
+    RELAY_MCAST_PARITY,
+    RELAY_MCAST_BEACON
+} relay_mcast_type_t;
+
+#pragma pack(push, 1)
+typedef struct {
+    uint32_t magic;             /* RELAY_MCAST_MAGIC */
+    uint8_t  type;              /* relay_mcast_type_t */
+    uint8_t  fec_group;         /* DATA packets per PARITY packet (0 = no FEC) */
+    uint16_t length;            /* Body bytes after this header */
+    uint32_t seq;               /* DATA: packet number; PARITY: first DATA seq covered;
+                                   BEACON: next DATA seq */
+    uint32_t sample_rate;       /* Stream rate (Hz) */
+} relay_mcast_header_t;
+
+typedef struct {
+    uint32_t frame_seq;         /* DATA frame sequence from the source */
+    uint32_t frame_samples;     /* I/Q pairs in the whole frame */
+    uint32_t offset;            /* First I/Q pair in this packet */
+    uint32_t count;             /* I/Q pairs in this packet */
+} relay_mcast_chunk_t;
+
+typedef struct {
+    uint32_t ft32_magic;        /* 0x46543332 - the TCP stream header, verbatim */
+    uint32_t sample_rate;
+    uint32_t version;           /* RELAY_MCAST_VERSION */
+    uint32_t frames_sent;
+} relay_mcast_beacon_t;
+#pragma pack(pop)
+
+#define RELAY_MCAST_HEADER_BYTES    ((int)sizeof(relay_mcast_header_t))
+#define RELAY_MCAST_MAX_BODY        (RELAY_MCAST_DATAGRAM - RELAY_MCAST_HEADER_BYTES)
+#define RELAY_MCAST_PAIRS_PER_PACKET \
+    ((RELAY_MCAST_MAX_BODY - (int)sizeof(relay_mcast_chunk_t)) / 8)
+
+/*============================================================================
+ * Sender
+ *============================================================================*/
+
+typedef struct relay_mcast_tx relay_mcast_tx_t;
+
+/** Called once per datagram */
+typedef void (*relay_mcast_emit_fn)(const uint8_t *packet, size_t len, void *user_data);
+
+typedef struct {
+    uint64_t frames;
+    uint64_t data_packets;
+    uint64_t parity_packets;
+    uint64_t beacons;
+    uint64_t bytes;
+    uint64_t send_errors;
+} relay_mcast_tx_stats_t;
+
+/**
+ * @brief Create a packetizer that hands datagrams to a callback
+ * @param fec_group  DATA packets per PARITY packet, 0 to disable (max 32)
+ */
+relay_mcast_tx_t *relay_mcast_tx_create(uint32_t sample_rate, int fec_group,
+                                        relay_mcast_emit_fn emit, void *user_data);
+
+/**
+ * @brief Create a packetizer that sends to a multicast group
+ * @param iface  Local interface address to send from, or NULL for the default route
+ * @param ttl    Multicast TTL (1 = local segment)
+ */
+relay_mcast_tx_t *relay_mcast_tx_open(const char *group, int port, const char *iface, int ttl,
+                                      uint32_t sample_rate, int fec_group);
+
+void relay_mcast_tx_destroy(relay_mcast_tx_t *tx);
+
+/** Packetize one frame of interleaved float32 I/Q */
+void relay_mcast_tx_frame(relay_mcast_tx_t *tx, uint32_t frame_seq,
+                          const float *iq, uint32_t num_samples);
+
+/** Send a beacon now (the caller decides the cadence, nominally RELAY_MCAST_BEACON_MS) */
+void relay_mcast_tx_beacon(relay_mcast_tx_t *tx);
+
+void relay_mcast_tx_set_rate(relay_mcast_tx_t *tx, uint32_t sample_rate);
+void relay_mcast_tx_get_stats(const relay_mcast_tx_t *tx, relay_mcast_tx_stats_t *stats);
+
+/*============================================================================
+ * Receiver
+ *============================================================================*/
+
+typedef struct relay_mcast_rx relay_mcast_rx_t;
+
+/** A reassembled frame - iq is valid until the next push/pop */
+typedef struct {
+    uint32_t frame_seq;
+    uint32_t num_samples;       /* I/Q pairs */
+    uint32_t samples_lost;      /* Zero-filled pairs (0 = frame arrived whole) */
+    const float *iq;
+} relay_mcast_frame_t;
+
+typedef struct {
+    uint64_t packets;
+    uint64_t beacons;
+    uint64_t recovered;         /* DATA packets rebuilt from parity */
+    uint64_t duplicates;
+    uint64_t late;              /* Arrived after their frame was released */
+    uint64_t invalid;
+    uint64_t frames;
+    uint64_t frames_partial;
+    uint64_t samples_lost;
+} relay_mcast_rx_stats_t;
+
+relay_mcast_rx_t *relay_mcast_rx_create(void);
+void relay_mcast_rx_destroy(relay_mcast_rx_t *rx);
+
+/** Forget all in-flight frames and sequence state (e.g. the relay restarted) */
+void relay_mcast_rx_reset(relay_mcast_rx_t *rx);
+
+/** Feed one datagram; false if it is not a valid packet */
+bool relay_mcast_rx_push(relay_mcast_rx_t *rx, const uint8_t *packet, size_t len);
+
+/**
+ * @brief Take the next frame in sequence order
+ *
+ * A frame is released when it is complete, or - with holes zero-filled -
+ * once the packet sequence has moved far enough past it that no parity
+ * packet can still repair it. Call until it returns false after each push.
+ */
+bool relay_mcast_rx_pop(relay_mcast_rx_t *rx, relay_mcast_frame_t *frame);
+
+/** Sample rate from the latest packet (0 before the first one) */
+uint32_t relay_mcast_rx_sample_rate(const relay_mcast_rx_t *rx);
+void relay_mcast_rx_get_stats(const relay_mcast_rx_t *rx, relay_mcast_rx_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RELAY_MCAST_H */
@@ -0,0 +1,115 @@
+/**
+ * @file rtl_tcp.h
+ * @brief rtl_tcp wire protocol support for sdr_server
+ *
+ * Lets stock rtl_tcp clients (SDR#, GQRX, SDR++, rtl_tcp-based scripts)
+ * attach to sdr_server directly:
+ *   - 12-byte dongle info header ("RTL0", tuner type, gain count)
+ *   - Interleaved unsigned 8-bit I/Q, offset binary (128 = zero)
+ *   - 5-byte command packets (1 byte command, 4 byte big-endian param),
+ *     mapped onto the text control protocol so all range checks and
+ *     hardware handling stay in tcp_commands.c
+ *
+ * Sample conversion is vectorized (SSE2 / NEON, scalar fallback) and
+ * is meant to be done once per SDR block, then shared by every client.
+ */
+
+#ifndef RTL_TCP_H
+#define RTL_TCP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "tcp_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Constants
+ *============================================================================*/
+
+#define RTL_TCP_DEFAULT_PORT    1234
+#define RTL_TCP_HEADER_SIZE     12
+#define RTL_TCP_CMD_SIZE        5
+#define RTL_TCP_MAX_CLIENTS     4
+
+/* Advertise as an R820T so clients build their usual 29-step gain list */
+#define RTL_TCP_TUNER_R820T     5
+#define RTL_TCP_GAIN_COUNT      29
+
+/* rtl_tcp command codes */
+typedef enum {
+    RTL_CMD_SET_FREQ            = 0x01,
+    RTL_CMD_SET_SAMPLE_RATE     = 0x02,
+    RTL_CMD_SET_GAIN_MODE       = 0x03,  /* 0 = auto, 1 = manual */
+    RTL_CMD_SET_GAIN            = 0x04,  /* Tenths of dB */
+    RTL_CMD_SET_FREQ_CORRECTION = 0x05,
+    RTL_CMD_SET_IF_GAIN         = 0x06,
+    RTL_CMD_SET_TEST_MODE       = 0x07,
+    RTL_CMD_SET_AGC_MODE        = 0x08,  /* RTL2832 digital AGC */
+    RTL_CMD_SET_DIRECT_SAMPLING = 0x09,
+    RTL_CMD_SET_OFFSET_TUNING   = 0x0A,
+    RTL_CMD_SET_RTL_XTAL        = 0x0B,
+    RTL_CMD_SET_TUNER_XTAL      = 0x0C,
+    RTL_CMD_SET_GAIN_BY_INDEX   = 0x0D,
+    RTL_CMD_SET_BIAS_TEE        = 0x0E
+} rtl_tcp_cmd_t;
+
+/*============================================================================
+ * Protocol Functions
+ *============================================================================*/
+
+/**
+ * @brief Build the 12-byte dongle info header sent on connect
+ */
+void rtl_tcp_build_header(uint8_t header[RTL_TCP_HEADER_SIZE]);
+
+/**
+ * @brief Map an rtl_tcp command packet onto a control protocol command
+ *
+ * @param pkt   5-byte packet as received
+ * @param cmd   Output command, ready for tcp_execute_command()
+ * @return      TCP_OK if mapped, TCP_ERR_UNKNOWN if the command has no
+ *              equivalent (caller ignores it), or a parse error if the
+ *              translated value is out of range for this hardware
+ */
+tcp_error_t rtl_tcp_map_command(const uint8_t pkt[RTL_TCP_CMD_SIZE], tcp_command_t *cmd);
+
+/**
+ * @brief Convert rtl_tcp tuner gain (tenths of dB, 0-496) to IF gain reduction (20-59 dB)
+ */
+int rtl_tcp_gain_to_reduction(int tenth_db);
+
+/**
+ * @brief Short name for logging
+ */
+const char *rtl_tcp_cmd_name(uint8_t cmd);
+
+/*============================================================================
+ * Sample Conversion
+ *============================================================================*/
+
+/**
+ * @brief Convert planar S16 I/Q to interleaved offset-binary U8
+ *
+ * Rounds to nearest (saturating) then maps -128..127 to 0..255.
+ * Uses SSE2 or NEON when available.
+ *
+ * @param xi     I samples
+ * @param xq     Q samples
+ * @param out    Output, 2 * count bytes (I0 Q0 I1 Q1 ...)
+ * @param count  Number of I/Q pairs
+ */
+void rtl_tcp_convert_s16_u8(const int16_t *xi, const int16_t *xq, uint8_t *out, size_t count);
+
+/**
+ * @brief Scalar reference for rtl_tcp_convert_s16_u8 (used for tails and tests)
+ */
+void rtl_tcp_convert_s16_u8_scalar(const int16_t *xi, const int16_t *xq, uint8_t *out, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RTL_TCP_H */
@@ -0,0 +1,160 @@
+/**
+ * @file sdr_manager.h
+ * @brief Several receivers in one process
+ *
+ * sdr_server drives one psdr_context_t through one tcp_sdr_state_t; a host
+ * with four RSPs ran four servers. The manager holds N devices instead,
+ * each with its own:
+ *
+ *   - Backend: an RSP (psdr), a synthetic tone or an .iqr replay. Tone and
+ *     replay devices answer the same commands, so they stand in for
+ *     hardware in tests and demos.
+ *   - Streaming thread, optionally pinned to a core. RSP samples are
+ *     handed from the SDRplay callback through a ring; tone and replay
+ *     samples are made on the thread itself.
+ *   - Decimator (2 MSPS to 48 kHz, decimator.h) and two PHXI ports: the
+ *     raw S16 stream and the decimated F32 stream. One client per port.
+ *   - tcp_sdr_state_t, so every sdr_server command works per device.
+ *
+ * Commands (sdr_manager_execute()) are addressed with a DEV prefix:
+ *
+ *   DEV 2 SET_FREQ 10000000     Any tcp_commands command, on device 2
+ *   DEV 2 INFO                  Backend, ports, core and counters
+ *   DEVICES                     Device count and backends
+ *   SET_FREQ 10000000           No prefix: device 0, as sdr_server
+ *
+ * Threading: sdr_manager_add*() and sdr_manager_destroy() from one thread;
+ * sdr_manager_execute(), sdr_manager_stop_all() and
+ * sdr_manager_get_stats() from any. Sinks run on the device's streaming
+ * thread.
+ */
+
+#ifndef SDR_MANAGER_H
+#define SDR_MANAGER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#include "tcp_server.h"
+#include "decimator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define SDR_MANAGER_MAX_DEVICES     8
+#define SDR_MANAGER_BLOCK           8192                /* Pairs per processing block */
+#define SDR_MANAGER_RING_PAIRS      (1 << 20)           /* RSP callback -> thread, 0.5 s at 2 MSPS */
+#define SDR_MANAGER_DECIM_RATE      48000               /* Decimated port, from 2 MSPS only */
+
+#define SDR_PORT_NONE               (-1)                /* No listener */
+#define SDR_PORT_ANY                0                   /* Any free port (see stats) */
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct sdr_manager sdr_manager_t;
+
+typedef enum {
+    SDR_BACKEND_HARDWARE = 0,       /* RSP through psdr_* */
+    SDR_BACKEND_TONE,               /* Synthetic tone at tone_hz from center */
+    SDR_BACKEND_REPLAY              /* .iqr file, looped, at the file's rate */
+} sdr_backend_t;
+
+/**
+ * Streaming thread output, after the ports: raw block at the device rate
+ * and what the decimator made of it (n_decim 0 when the rate is not 2 MSPS).
+ * Decimated samples are normalized to +/-1.
+ */
+typedef void (*sdr_device_sink_t)(int device, const int16_t *xi, const int16_t *xq,
+                                  uint32_t count, const decim_complex_t *decim,
+                                  size_t n_decim, void *user);
+
+typedef struct {
+    sdr_backend_t backend;
+    unsigned int  device_idx;       /* HARDWARE: psdr_enumerate() index */
+    char          replay_path[260]; /* REPLAY */
+    double        tone_hz;          /* TONE: offset from center */
+    bool          paced;            /* TONE/REPLAY: real time (false: as fast as the thread runs) */
+    int           iq_port;          /* Raw S16 PHXI: port, SDR_PORT_ANY or SDR_PORT_NONE */
+    int           decim_port;       /* 48 kHz F32 PHXI */
+    int           core;             /* Streaming thread CPU, -1 = not pinned */
+    sdr_device_sink_t sink;         /* Optional */
+    void         *sink_user;
+    bool          sink_raw_only;    /* Sink gets n_decim 0; the decimator runs for the 48k port only */
+} sdr_device_spec_t;
+
+typedef struct {
+    sdr_backend_t backend;
+    char     serial[64];            /* HARDWARE */
+    bool     streaming;
+    int      sample_rate;
+    int      core;
+    bool     pinned;                /* Affinity was set */
+    int      iq_port;               /* Bound ports, SDR_PORT_NONE if none */
+    int      decim_port;
+    bool     iq_client;             /* A client is attached */
+    bool     decim_client;
+    uint64_t samples;               /* Input pairs processed */
+    uint64_t decim_samples;
+    uint64_t frames;                /* IQDQ frames sent on both ports */
+    uint64_t overruns;              /* RSP pairs lost to a full ring */
+    uint32_t replay_loops;
+} sdr_device_stats_t;
+
+/*============================================================================
+ * API
+ *============================================================================*/
+
+sdr_manager_t *sdr_manager_create(void);
+
+/** Stop every device, join the threads, close ports and backends (NULL safe) */
+void sdr_manager_destroy(sdr_manager_t *m);
+
+/** Tone at 1 kHz, paced, no ports, not pinned */
+void sdr_manager_spec_defaults(sdr_device_spec_t *spec, sdr_backend_t backend);
+
+/**
+ * @brief Open a device and start its streaming thread
+ * @return Device number, or -1 (backend, port or thread failed; reason printed)
+ */
+int sdr_manager_add(sdr_manager_t *m, const sdr_device_spec_t *spec);
+
+/**
+ * @brief Add every available RSP from psdr_enumerate()
+ *
+ * Device k found is opened from tmpl with device_idx k; fixed ports and
+ * the core are offset by the number of devices added before it.
+ *
+ * @return Devices added
+ */
+int sdr_manager_add_hardware(sdr_manager_t *m, const sdr_device_spec_t *tmpl);
+
+int sdr_manager_count(const sdr_manager_t *m);
+
+/**
+ * @brief Run one command line (see file comment)
+ * @return Command type executed on the device (CMD_UNKNOWN for manager
+ *         commands and errors), so callers can spot QUIT
+ */
+tcp_cmd_type_t sdr_manager_execute(sdr_manager_t *m, const char *line, tcp_response_t *resp);
+
+/** STOP every streaming device (control client gone) */
+void sdr_manager_stop_all(sdr_manager_t *m);
+
+bool sdr_manager_get_stats(sdr_manager_t *m, int device, sdr_device_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SDR_MANAGER_H */
@@ -71,6 +71,7 @@ typedef enum {
     CMD_START,
     CMD_STOP,
     CMD_STATUS,
+    CMD_GET_IQSTATS,
 
     /* Utility */
     CMD_PING,
@@ -182,8 +183,11 @@ typedef struct {
 
     /* Async notification support */
     tcp_socket_t client_socket;      /* Current client socket for notifications */
-    tcp_mutex_t  notify_mutex;       /* Protects socket access from callback thread */
+    tcp_mutex_t  notify_mutex;       /* Serializes notification sends on client_socket */
     bool         notify_enabled;     /* True when client is connected */
+
+    /* I/Q stream statistics for GET_IQSTATS (NULL when the server has no I/Q port) */
+    void (*iq_stats)(char *buf, size_t size);
 } tcp_sdr_state_t;
 
 /*============================================================================
@@ -0,0 +1,16 @@
+"""
+Phoenix SDR analysis bindings.
+
+    iqr      - .iqr recordings as memory-mapped NumPy arrays (no copies)
+    detectors - the C tick, marker and BCD detectors as block objects
+                (cffi over the phoenix_detect shared library)
+
+    from phoenix_sdr import iqr_read, detectors
+
+    rec = iqr_read("capture.iqr")
+    events = detectors.run(rec)          # same events as iqr_detect
+"""
+
+from .iqr import IqrFile, IqrError, iqr_read
+
+__all__ = ["IqrFile", "IqrError", "iqr_read"]
@@ -0,0 +1,261 @@
+"""
+The C WWV detectors as block-processing objects.
+
+A cffi (ABI mode) shim over the phoenix_detect shared library built from
+tools/wwv_blocks.c; nothing is compiled at install time. Inputs are passed
+to C as pointers into the caller's NumPy buffers - memory-mapped IQR blocks
+go straight in - and events come back as structured arrays (EVENT_DTYPE).
+
+    fe = FrontEnd(rec.sample_rate)       # waterfall detector path
+    tick = TickDetector()
+    for block in rec.blocks(1 << 20):
+        sync, data = fe.process(block)   # complex64 channels
+        events = tick.process(sync)
+
+The library is found through $PHOENIX_DETECT_LIB, then bin/ at the top of
+the source tree (build.ps1 output).
+"""
+
+import os
+import sys
+
+import numpy as np
+from cffi import FFI
+
+ABI_VERSION = 1
+
+DETECTOR_RATE = 50000
+DATA_DECIMATION = 32
+
+CHANNEL_SYNC = 0
+CHANNEL_DATA = 1
+
+BLOCK_TICK = 0
+BLOCK_MARKER = 1
+BLOCK_BCD_TIME = 2
+BLOCK_BCD_FREQ = 3
+
+EVENT_TICK = 0
+EVENT_TICK_MARKER = 1
+EVENT_MARKER = 2
+EVENT_BCD_TIME = 3
+EVENT_BCD_FREQ = 4
+
+EVENT_NAMES = ("tick", "tick_marker", "marker", "bcd_time", "bcd_freq")
+
+# wwv_block_event_t - field meanings per kind are in tools/wwv_blocks.h
+EVENT_DTYPE = np.dtype([
+    ("sample", "<u8"),
+    ("kind", "<i4"),
+    ("number", "<i4"),
+    ("timestamp_ms", "<f4"),
+    ("duration_ms", "<f4"),
+    ("energy", "<f4"),
+    ("baseline", "<f4"),
+    ("score", "<f4"),
+    ("interval_ms", "<f4"),
+])
+assert EVENT_DTYPE.itemsize == 40
+
+_CDEF = """
+typedef struct wwv_front_end wwv_front_end_t;
+typedef struct wwv_block wwv_block_t;
+typedef struct {
+    uint64_t sample;
+    int32_t  kind;
+    int32_t  number;
+    float    timestamp_ms;
+    float    duration_ms;
+    float    energy;
+    float    baseline;
+    float    score;
+    float    interval_ms;
+} wwv_block_event_t;
+
+int32_t wwv_blocks_abi_version(void);
+
+wwv_front_end_t *wwv_front_end_create(int32_t input_rate);
+void wwv_front_end_destroy(wwv_front_end_t *fe);
+void wwv_front_end_reset(wwv_front_end_t *fe);
+size_t wwv_front_end_max_output(const wwv_front_end_t *fe, int32_t channel, size_t pairs);
+void wwv_front_end_process_s16(wwv_front_end_t *fe, const int16_t *iq, size_t pairs,
+                               float *sync, size_t *n_sync, float *data, size_t *n_data);
+void wwv_front_end_process_f32(wwv_front_end_t *fe, const float *iq, size_t pairs,
+                               float *sync, size_t *n_sync, float *data, size_t *n_data);
+
+wwv_block_t *wwv_block_create(int32_t kind, int32_t sample_rate, int32_t decimation);
+void wwv_block_destroy(wwv_block_t *b);
+size_t wwv_block_process(wwv_block_t *b, const float *iq, size_t pairs);
+size_t wwv_block_pending(const wwv_block_t *b);
+size_t wwv_block_take_events(wwv_block_t *b, wwv_block_event_t *out, size_t max);
+uint64_t wwv_block_samples(const wwv_block_t *b);
+"""
+
+ffi = FFI()
+ffi.cdef(_CDEF)
+_lib = None
+
+
+def _library_names():
+    if sys.platform == "win32":
+        return ["phoenix_detect.dll"]
+    if sys.platform == "darwin":
+        return ["libphoenix_detect.dylib"]
+    return ["libphoenix_detect.so"]
+
+
+def library():
+    """Load the shared library once; raises OSError if it can't be found"""
+    global _lib
+    if _lib is not None:
+        return _lib
+
+    candidates = []
+    if os.environ.get("PHOENIX_DETECT_LIB"):
+        candidates.append(os.environ["PHOENIX_DETECT_LIB"])
+    root = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+    candidates += [os.path.join(root, "bin", name) for name in _library_names()]
+
+    for path in candidates:
+        if os.path.exists(path):
+            lib = ffi.dlopen(path)
+            if lib.wwv_blocks_abi_version() != ABI_VERSION:
+                raise OSError(f"{path}: ABI version {lib.wwv_blocks_abi_version()}, "
+                              f"expected {ABI_VERSION}")
+            _lib = lib
+            return _lib
+    raise OSError("phoenix_detect library not found (tried: " + ", ".join(candidates) + ")")
+
+
+def _pairs(iq, integer_ok):
+    """Interleaved contiguous view of an I/Q buffer, copying only if it must"""
+    iq = np.asarray(iq)
+    if np.iscomplexobj(iq):
+        iq = np.ascontiguousarray(iq, dtype=np.complex64).view(np.float32)
+    elif integer_ok and iq.dtype == np.int16:
+        return np.ascontiguousarray(iq).reshape(-1)
+    else:
+        iq = np.ascontiguousarray(iq, dtype=np.float32)
+    return iq.reshape(-1)
+
+
+class FrontEnd:
+    """
+    waterfall's detector path: 5 kHz lowpass, decimate to 50 kHz, block
+    slow AGC, then the sync (800-1400 Hz) and data (0-150 Hz, /32) channels.
+    """
+
+    def __init__(self, input_rate):
+        lib = library()
+        handle = lib.wwv_front_end_create(int(input_rate))
+        if handle == ffi.NULL:
+            raise ValueError(f"input rate {input_rate} is not a multiple of {DETECTOR_RATE} Hz")
+        self._lib = lib
+        self._fe = ffi.gc(handle, lib.wwv_front_end_destroy)
+        self.input_rate = int(input_rate)
+
+    def reset(self):
+        self._lib.wwv_front_end_reset(self._fe)
+
+    def process(self, iq):
+        """
+        iq: int16 or float32 pairs ((N, 2) or interleaved) or complex.
+        Returns (sync, data) as complex64 arrays.
+        """
+        flat = _pairs(iq, integer_ok=True)
+        pairs = flat.size // 2
+        sync = np.empty(2 * self._lib.wwv_front_end_max_output(self._fe, CHANNEL_SYNC, pairs), np.float32)
+        data = np.empty(2 * self._lib.wwv_front_end_max_output(self._fe, CHANNEL_DATA, pairs), np.float32)
+        n_sync = ffi.new("size_t *")
+        n_data = ffi.new("size_t *")
+
+        if flat.dtype == np.int16:
+            self._lib.wwv_front_end_process_s16(self._fe, ffi.from_buffer("int16_t[]", flat), pairs,
+                                                ffi.from_buffer("float[]", sync), n_sync,
+                                                ffi.from_buffer("float[]", data), n_data)
+        else:
+            self._lib.wwv_front_end_process_f32(self._fe, ffi.from_buffer("float[]", flat), pairs,
+                                                ffi.from_buffer("float[]", sync), n_sync,
+                                                ffi.from_buffer("float[]", data), n_data)
+        return (sync[:2 * n_sync[0]].view(np.complex64),
+                data[:2 * n_data[0]].view(np.complex64))
+
+
+class _Block:
+    kind = None
+
+    def __init__(self, sample_rate, decimation):
+        lib = library()
+        handle = lib.wwv_block_create(self.kind, int(sample_rate), int(decimation))
+        if handle == ffi.NULL:
+            raise ValueError(f"{type(self).__name__} does not run at {sample_rate} Hz / {decimation}")
+        self._lib = lib
+        self._block = ffi.gc(handle, lib.wwv_block_destroy)
+        self.sample_rate = float(sample_rate) / decimation
+
+    @property
+    def samples(self):
+        """Input pairs processed so far"""
+        return int(self._lib.wwv_block_samples(self._block))
+
+    def process(self, iq):
+        """Feed float32 pairs or complex samples; returns the events raised (EVENT_DTYPE)"""
+        flat = _pairs(iq, integer_ok=False)
+        pending = self._lib.wwv_block_process(self._block, ffi.from_buffer("float[]", flat), flat.size // 2)
+        events = np.empty(pending, EVENT_DTYPE)
+        if pending:
+            self._lib.wwv_block_take_events(self._block,
+                                            ffi.cast("wwv_block_event_t *", ffi.from_buffer(events)),
+                                            pending)
+        return events
+
+
+class TickDetector(_Block):
+    """tick_detector on the sync channel; reports ticks and minute markers (by duration)"""
+    kind = BLOCK_TICK
+
+    def __init__(self, sample_rate=DETECTOR_RATE):
+        super().__init__(sample_rate, 1)
+
+
+class MarkerDetector(_Block):
+    """marker_detector (1 s energy accumulator), 50 kHz sync channel only"""
+    kind = BLOCK_MARKER
+
+    def __init__(self, sample_rate=DETECTOR_RATE):
+        super().__init__(sample_rate, 1)
+
+
+class BcdTimeDetector(_Block):
+    """bcd_time_detector; by default on the front end's /32 data channel"""
+    kind = BLOCK_BCD_TIME
+
+    def __init__(self, sample_rate=DETECTOR_RATE, decimation=DATA_DECIMATION):
+        super().__init__(sample_rate, decimation)
+
+
+class BcdFreqDetector(_Block):
+    """bcd_freq_detector; by default on the front end's /32 data channel"""
+    kind = BLOCK_BCD_FREQ
+
+    def __init__(self, sample_rate=DETECTOR_RATE, decimation=DATA_DECIMATION):
+        super().__init__(sample_rate, decimation)
+
+
+def run(recording, pairs=1 << 20):
+    """
+    All four detectors over a recording (an IqrFile), as iqr_detect does.
+    Returns {"tick": events, "marker": ..., "bcd_time": ..., "bcd_freq": ...}.
+    """
+    fe = FrontEnd(int(recording.sample_rate))
+    blocks = {"tick": TickDetector(), "marker": MarkerDetector(),
+              "bcd_time": BcdTimeDetector(), "bcd_freq": BcdFreqDetector()}
+    found = {name: [] for name in blocks}
+
+    for block in recording.blocks(pairs):
+        sync, data = fe.process(block)
+        for name, det in blocks.items():
+            found[name].append(det.process(data if name.startswith("bcd") else sync))
+
+    return {name: (np.concatenate(parts) if parts else np.zeros(0, EVENT_DTYPE))
+            for name, parts in found.items()}
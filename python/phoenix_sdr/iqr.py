@@ -0,0 +1,156 @@
+"""
+.iqr recordings as memory-mapped NumPy arrays.
+
+Layout as in include/iq_recorder.h: a 64-byte header, interleaved
+little-endian int16 I/Q, then optional trailer chunks (IQRT timing track,
+IQRC block CRCs). The file is mapped once; samples, timing entries and
+CRCs are views into that mapping, so nothing is read until it is used and
+nothing is copied.
+
+    rec = iqr_read("capture.iqr")
+    rec.sample_rate              # Hz
+    rec.samples                  # (N, 2) int16 view: [:, 0] = I, [:, 1] = Q
+    for block in rec.blocks(1 << 20):
+        ...                      # (<= 2**20, 2) views, in order
+    rec.timing                   # IQRT entries (structured array), may be empty
+"""
+
+import numpy as np
+
+IQR_MAGIC = b"IQR1"
+IQR_VERSION = 1
+IQR_HEADER_SIZE = 64
+
+IQR_FLAG_TIMING_TRACK = 0x00000001
+IQR_FLAG_CRC32C = 0x00000002
+
+IQR_TIMING_GPS = 0x01
+IQR_TIMING_PPS = 0x02
+IQR_TIMING_OVERLOAD = 0x04
+
+MAX_TRAILER_CHUNKS = 8              # Same limit as the C reader
+
+HEADER_DTYPE = np.dtype([
+    ("magic", "S4"),
+    ("version", "<u4"),
+    ("sample_rate_hz", "<f8"),
+    ("center_freq_hz", "<f8"),
+    ("bandwidth_khz", "<u4"),
+    ("gain_reduction", "<i4"),
+    ("lna_state", "<u4"),
+    ("start_time_us", "<i8"),
+    ("sample_count", "<u8"),
+    ("flags", "<u4"),
+    ("crc_block_samples", "<u4"),
+    ("reserved", "V4"),
+])
+
+CHUNK_DTYPE = np.dtype([
+    ("magic", "S4"),
+    ("entry_size", "<u4"),
+    ("entry_count", "<u8"),
+])
+
+TIMING_DTYPE = np.dtype([
+    ("sample_index", "<u8"),
+    ("utc_us", "<i8"),
+    ("gain_reduction", "<i4"),
+    ("lna_state", "u1"),
+    ("flags", "u1"),
+    ("reserved", "V2"),
+])
+
+assert HEADER_DTYPE.itemsize == IQR_HEADER_SIZE
+assert CHUNK_DTYPE.itemsize == 16
+assert TIMING_DTYPE.itemsize == 24
+
+
+class IqrError(Exception):
+    """Not a readable .iqr file (bad magic, version or truncated header)."""
+
+
+class IqrFile:
+    """A mapped .iqr recording. Create with iqr_read()."""
+
+    def __init__(self, path):
+        self.path = str(path)
+        raw = np.memmap(self.path, dtype=np.uint8, mode="r")
+        if raw.size < IQR_HEADER_SIZE:
+            raise IqrError(f"{self.path}: shorter than the {IQR_HEADER_SIZE}-byte header")
+
+        self.header = raw[:IQR_HEADER_SIZE].view(HEADER_DTYPE)[0]
+        if self.header["magic"] != IQR_MAGIC:
+            raise IqrError(f"{self.path}: not an IQR file")
+        if int(self.header["version"]) != IQR_VERSION:
+            raise IqrError(f"{self.path}: version {int(self.header['version'])}, expected {IQR_VERSION}")
+
+        # A truncated file keeps the samples it has; its trailer is gone
+        declared = int(self.header["sample_count"])
+        present = min(declared, (raw.size - IQR_HEADER_SIZE) // 4)
+        end = IQR_HEADER_SIZE + 4 * present
+        self.samples = raw[IQR_HEADER_SIZE:end].view("<i2").reshape(present, 2)
+        self.complete = present == declared
+
+        chunks = self._chunks(raw, end) if self.complete else {}
+        self.timing = chunks.get(b"IQRT", np.zeros(0, TIMING_DTYPE))
+        self.crcs = chunks.get(b"IQRC", np.zeros(0, "<u4"))
+
+    @staticmethod
+    def _chunks(raw, pos):
+        """Trailer chunks by magic, skipping unknown ones; stops at damage"""
+        found = {}
+        entry_types = {b"IQRT": TIMING_DTYPE, b"IQRC": np.dtype("<u4")}
+        for _ in range(MAX_TRAILER_CHUNKS):
+            if pos + CHUNK_DTYPE.itemsize > raw.size:
+                break
+            chunk = raw[pos:pos + CHUNK_DTYPE.itemsize].view(CHUNK_DTYPE)[0]
+            size, count = int(chunk["entry_size"]), int(chunk["entry_count"])
+            start = pos + CHUNK_DTYPE.itemsize
+            if size == 0 or start + size * count > raw.size:
+                break
+            dtype = entry_types.get(bytes(chunk["magic"]))
+            if dtype is not None and dtype.itemsize == size:
+                found[bytes(chunk["magic"])] = raw[start:start + size * count].view(dtype)
+            pos = start + size * count
+        return found
+
+    @property
+    def sample_rate(self):
+        return float(self.header["sample_rate_hz"])
+
+    @property
+    def center_freq(self):
+        return float(self.header["center_freq_hz"])
+
+    @property
+    def start_time_us(self):
+        return int(self.header["start_time_us"])
+
+    @property
+    def i(self):
+        """I samples (strided view)"""
+        return self.samples[:, 0]
+
+    @property
+    def q(self):
+        """Q samples (strided view)"""
+        return self.samples[:, 1]
+
+    def __len__(self):
+        return self.samples.shape[0]
+
+    def blocks(self, pairs, start=0):
+        """Consecutive (<= pairs, 2) views from sample start on"""
+        if pairs < 1:
+            raise ValueError("pairs must be positive")
+        for first in range(start, len(self), pairs):
+            yield self.samples[first:first + pairs]
+
+    def __repr__(self):
+        return (f"IqrFile({self.path!r}, {len(self)} samples at {self.sample_rate:.0f} Hz, "
+                f"{len(self.timing)} timing entries)")
+
+
+def iqr_read(path):
+    """Map a recording; see IqrFile"""
+    return IqrFile(path)
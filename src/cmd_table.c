@@ -0,0 +1,246 @@
+/**
+ * @file cmd_table.c
+ * @brief Table-driven text command parser
+ *
+ * Perfect hash by hash and displace: FNV-1a over the upper-cased name picks
+ * a bucket; the bucket's displacement byte is mixed into the same hash to
+ * pick the slot. Build places the largest buckets first, trying
+ * displacements until all of a bucket's names land in free slots. With at
+ * least twice as many slots as names that takes a few tries per bucket.
+ */
+
+#include "cmd_table.h"
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FNV_OFFSET      2166136261u
+#define FNV_PRIME       16777619u
+#define MIN_SLOTS       16
+#define MAX_DISP        256
+
+/*============================================================================
+ * Hashing
+ *============================================================================*/
+
+static uint32_t hash_name(const char *s, size_t len) {
+    uint32_t h = FNV_OFFSET;
+    for (size_t k = 0; k < len; k++) {
+        h ^= (uint32_t)toupper((unsigned char)s[k]);
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+static uint32_t bucket_of(uint32_t h, uint32_t mask) {
+    return (h ^ (h >> 16)) & mask;
+}
+
+static uint32_t slot_of(uint32_t h, uint32_t disp, uint32_t mask) {
+    uint32_t x = h ^ ((disp + 1) * 0x9E3779B9u);
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    return x & mask;
+}
+
+/* Case-insensitive compare of s[0..len) against NUL-terminated name */
+static bool name_equals(const char *s, size_t len, const char *name) {
+    for (size_t k = 0; k < len; k++) {
+        if (name[k] == '\0') return false;
+        if (toupper((unsigned char)s[k]) != toupper((unsigned char)name[k])) return false;
+    }
+    return name[len] == '\0';
+}
+
+/*============================================================================
+ * Build / Lookup
+ *============================================================================*/
+
+/* Try displacement d for the names in one bucket */
+static bool place_bucket(cmd_table_t *t, const uint32_t *hashes, const int *members, int n, uint32_t d) {
+    uint32_t slots[CMD_TABLE_MAX_SLOTS / 2];
+    for (int m = 0; m < n; m++) {
+        uint32_t s = slot_of(hashes[members[m]], d, t->mask);
+        if (t->slot[s]) return false;
+        for (int k = 0; k < m; k++) {
+            if (slots[k] == s) return false;
+        }
+        slots[m] = s;
+    }
+    for (int m = 0; m < n; m++) t->slot[slots[m]] = (uint8_t)(members[m] + 1);
+    return true;
+}
+
+bool cmd_table_build(cmd_table_t *t, const cmd_spec_t *specs, int count) {
+    if (!t || !specs || count <= 0) return false;
+
+    uint32_t slots = MIN_SLOTS;
+    while (slots < (uint32_t)count * 2) slots *= 2;
+    if (slots > CMD_TABLE_MAX_SLOTS) return false;
+
+    for (int a = 0; a < count; a++) {
+        for (int b = a + 1; b < count; b++) {
+            if (name_equals(specs[a].name, strlen(specs[a].name), specs[b].name)) return false;
+        }
+    }
+
+    t->specs = specs;
+    t->count = count;
+    t->mask = slots - 1;
+    memset(t->disp, 0, sizeof(t->disp));
+    memset(t->slot, 0, sizeof(t->slot));
+
+    uint32_t hashes[CMD_TABLE_MAX_SLOTS / 2];
+    int bucket_size[CMD_TABLE_MAX_SLOTS] = { 0 };
+    for (int i = 0; i < count; i++) {
+        hashes[i] = hash_name(specs[i].name, strlen(specs[i].name));
+        bucket_size[bucket_of(hashes[i], t->mask)]++;
+    }
+
+    /* Largest buckets first */
+    for (int size = count; size > 0; size--) {
+        for (uint32_t b = 0; b < slots; b++) {
+            if (bucket_size[b] != size) continue;
+
+            int members[CMD_TABLE_MAX_SLOTS / 2];
+            int n = 0;
+            for (int i = 0; i < count; i++) {
+                if (bucket_of(hashes[i], t->mask) == b) members[n++] = i;
+            }
+
+            uint32_t d = 0;
+            while (d < MAX_DISP && !place_bucket(t, hashes, members, n, d)) d++;
+            if (d == MAX_DISP) return false;
+            t->disp[b] = (uint8_t)d;
+        }
+    }
+    return true;
+}
+
+const cmd_spec_t *cmd_table_find(const cmd_table_t *t, const char *name, size_t len) {
+    uint32_t h = hash_name(name, len);
+    uint8_t s = t->slot[slot_of(h, t->disp[bucket_of(h, t->mask)], t->mask)];
+    if (s == 0) return NULL;
+    const cmd_spec_t *spec = &t->specs[s - 1];
+    return name_equals(name, len, spec->name) ? spec : NULL;
+}
+
+/*============================================================================
+ * Arguments
+ *============================================================================*/
+
+static cmd_table_status_t convert_arg(const cmd_arg_spec_t *as, cmd_value_t *v) {
+    char *end;
+    v->i = 0;
+    v->f = 0.0;
+    v->choice = -1;
+
+    switch (as->type) {
+        case CMD_ARG_INT:
+            errno = 0;
+            v->i = strtol(v->text, &end, 10);
+            if (end == v->text || *end != '\0') return CMD_TABLE_ERR_TYPE;
+            if (errno == ERANGE) return CMD_TABLE_ERR_RANGE;
+            v->f = (double)v->i;
+            break;
+
+        case CMD_ARG_FLOAT:
+            v->f = strtod(v->text, &end);
+            if (end == v->text || *end != '\0') return CMD_TABLE_ERR_TYPE;
+            if (!isfinite(v->f)) return CMD_TABLE_ERR_RANGE;
+            break;
+
+        case CMD_ARG_WORD:
+            if (!as->choices) return CMD_TABLE_OK;
+            for (int c = 0; as->choices[c]; c++) {
+                if (name_equals(v->text, strlen(v->text), as->choices[c])) {
+                    v->choice = c;
+                    return CMD_TABLE_OK;
+                }
+            }
+            return CMD_TABLE_ERR_CHOICE;
+    }
+
+    if (as->min < as->max && (v->f < as->min || v->f > as->max)) return CMD_TABLE_ERR_RANGE;
+    return CMD_TABLE_OK;
+}
+
+/*============================================================================
+ * Parser
+ *============================================================================*/
+
+static bool is_separator(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static bool is_end(char c) {
+    return c == '\0' || c == '\r' || c == '\n';
+}
+
+cmd_table_status_t cmd_table_parse(const cmd_table_t *t, char *line, cmd_parsed_t *out) {
+    out->spec = NULL;
+    out->name = NULL;
+    out->argc = 0;
+    out->bad_arg = -1;
+
+    /* Split in place: name, then up to CMD_TABLE_MAX_ARGS arguments */
+    char *p = line;
+    int tokens = 0;
+    size_t name_len = 0;
+    for (;;) {
+        while (is_separator(*p)) p++;
+        if (is_end(*p)) break;
+
+        char *start = p;
+        while (!is_separator(*p) && !is_end(*p)) p++;
+        bool last = is_end(*p);
+        size_t len = (size_t)(p - start);
+        *p = '\0';
+        if (!last) p++;
+
+        if (tokens == 0) {
+            out->name = start;
+            name_len = len;
+        } else if (tokens <= CMD_TABLE_MAX_ARGS) {
+            out->argv[tokens - 1].text = start;
+        }
+        tokens++;
+        if (last) break;
+    }
+
+    if (tokens == 0) return CMD_TABLE_ERR_EMPTY;
+
+    out->spec = cmd_table_find(t, out->name, name_len);
+    if (!out->spec) return CMD_TABLE_ERR_UNKNOWN;
+
+    int argc = tokens - 1;
+    if (argc < out->spec->min_args || argc > out->spec->max_args || argc > CMD_TABLE_MAX_ARGS) {
+        return CMD_TABLE_ERR_ARGC;
+    }
+    out->argc = argc;
+
+    for (int a = 0; a < argc; a++) {
+        cmd_table_status_t st = convert_arg(&out->spec->args[a], &out->argv[a]);
+        if (st != CMD_TABLE_OK) {
+            out->bad_arg = a;
+            return st;
+        }
+    }
+    return CMD_TABLE_OK;
+}
+
+const char *cmd_table_status_name(cmd_table_status_t status) {
+    switch (status) {
+        case CMD_TABLE_OK:          return "OK";
+        case CMD_TABLE_ERR_EMPTY:   return "EMPTY";
+        case CMD_TABLE_ERR_UNKNOWN: return "UNKNOWN";
+        case CMD_TABLE_ERR_ARGC:    return "ARGC";
+        case CMD_TABLE_ERR_TYPE:    return "TYPE";
+        case CMD_TABLE_ERR_RANGE:   return "RANGE";
+        case CMD_TABLE_ERR_CHOICE:  return "CHOICE";
+        default:                    return "ERROR";
+    }
+}
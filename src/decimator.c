@@ -69,6 +69,8 @@ static const float stage2_coeffs[STAGE2_TAPS] = {
  * Lowpass at 0.96 * Nyquist to prevent aliasing
  */
 static float stage3_polyphase[STAGE3_UP][STAGE3_TAPS_PER_PHASE];
+static float stage1_norm[STAGE1_TAPS];
+static float stage2_norm[STAGE2_TAPS];
 static bool stage3_initialized = false;
 
 /*============================================================================
@@ -132,11 +134,19 @@ const char* decim_strerror(decim_error_t err) {
 static void init_polyphase_coeffs(void) {
     if (stage3_initialized) return;
 
+    /* Stage 1/2 tables are not unity-gain at DC - normalize copies */
+    float sum1 = 0.0f, sum2 = 0.0f;
+    for (int i = 0; i < STAGE1_TAPS; i++) sum1 += stage1_coeffs[i];
+    for (int i = 0; i < STAGE2_TAPS; i++) sum2 += stage2_coeffs[i];
+    for (int i = 0; i < STAGE1_TAPS; i++) stage1_norm[i] = stage1_coeffs[i] / sum1;
+    for (int i = 0; i < STAGE2_TAPS; i++) stage2_norm[i] = stage2_coeffs[i] / sum2;
+
     /* Generate windowed sinc lowpass filter
-     * Cutoff at 0.48 (slightly below Nyquist for 48/50 ratio)
+     * Prototype runs at the upsampled rate (48 x 50 kHz), so the cutoff
+     * is 0.48 of the 50 kHz Nyquist divided by the interpolation factor
      */
     float sinc[STAGE3_TOTAL_TAPS];
-    float cutoff = 0.48f;
+    float cutoff = 0.48f / STAGE3_UP;
     int center = STAGE3_TOTAL_TAPS / 2;
 
     for (int i = 0; i < STAGE3_TOTAL_TAPS; i++) {
@@ -153,25 +163,16 @@ static void init_polyphase_coeffs(void) {
         sinc[i] *= w;
     }
 
-    /* Normalize */
-    float sum = 0.0f;
-    for (int i = 0; i < STAGE3_TOTAL_TAPS; i++) {
-        sum += sinc[i];
-    }
-    for (int i = 0; i < STAGE3_TOTAL_TAPS; i++) {
-        sinc[i] /= sum;
-    }
-
-    /* Distribute into polyphase branches */
-    /* Note: For decimation (not interpolation), we don't multiply by STAGE3_UP */
+    /* Distribute into polyphase branches, each normalized to unity DC gain */
     for (int phase = 0; phase < STAGE3_UP; phase++) {
+        float sum = 0.0f;
         for (int tap = 0; tap < STAGE3_TAPS_PER_PHASE; tap++) {
             int idx = tap * STAGE3_UP + phase;
-            if (idx < STAGE3_TOTAL_TAPS) {
-                stage3_polyphase[phase][tap] = sinc[idx];
-            } else {
-                stage3_polyphase[phase][tap] = 0.0f;
-            }
+            stage3_polyphase[phase][tap] = (idx < STAGE3_TOTAL_TAPS) ? sinc[idx] : 0.0f;
+            sum += stage3_polyphase[phase][tap];
+        }
+        for (int tap = 0; tap < STAGE3_TAPS_PER_PHASE; tap++) {
+            stage3_polyphase[phase][tap] /= sum;
         }
     }
 
@@ -332,7 +333,7 @@ decim_error_t decim_process_int16(
             state->stage1_phase = 0;
 
             float oi, oq;
-            filter_apply(&state->stage1, stage1_coeffs, STAGE1_TAPS, &oi, &oq);
+            filter_apply(&state->stage1, stage1_norm, STAGE1_TAPS, &oi, &oq);
 
             if (stage1_out < state->buf1_size) {
                 state->buf1[stage1_out].i = oi;
@@ -351,7 +352,7 @@ decim_error_t decim_process_int16(
             state->stage2_phase = 0;
 
             float oi, oq;
-            filter_apply(&state->stage2, stage2_coeffs, STAGE2_TAPS, &oi, &oq);
+            filter_apply(&state->stage2, stage2_norm, STAGE2_TAPS, &oi, &oq);
 
             if (stage2_out < state->buf2_size) {
                 state->buf2[stage2_out].i = oi;
@@ -376,7 +377,10 @@ decim_error_t decim_process_int16(
                 return DECIM_ERR_BUFFER_FULL;
             }
 
-            int phase = state->stage3_out_phase % STAGE3_UP;
+            /* Output m sits at input time m*50/48; the fractional part in
+             * 1/48ths of a sample selects the branch */
+            int phase = state->stage3_out_phase * STAGE3_DOWN -
+                        state->stage3_in_phase * STAGE3_UP;
             float oi, oq;
             filter_apply(&state->stage3, stage3_polyphase[phase],
                         STAGE3_TAPS_PER_PHASE, &oi, &oq);
@@ -0,0 +1,360 @@
+/**
+ * @file dsp_q15.c
+ * @brief Q15 fixed-point receive front end implementation
+ *
+ * Arithmetic rules, so every path gives the same bits:
+ *   - CIC integrators and combs wrap in uint32; the result is exact as long
+ *     as the true output fits int32, which R^N <= 65536 guarantees
+ *   - FIR products are int16 x int16 summed in int32; taps with
+ *     sum |h| < 2 cannot overflow, and integer sums do not depend on order,
+ *     so the vector and scalar dot products agree exactly
+ *   - every Q15 result rounds half up and saturates to int16
+ */
+
+#include "dsp_q15.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9)
+#define Q15_USE_VECTOR 1
+typedef int16_t q15_vec_t __attribute__((vector_size(16)));
+typedef int32_t q15_wide_t __attribute__((vector_size(32)));
+#endif
+
+#define CIC_CHUNK           1024        /* Intermediate pairs per pass */
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+struct q15_frontend {
+    q15_frontend_config_t cfg;
+    q15_cic_t cic;
+    q15_dc_block_t dc;
+    bool use_dc;
+
+    /* Channel FIR: taps reversed so the dot product runs oldest -> newest */
+    int num_taps;               /* Padded to Q15_FIR_LANES */
+    int16_t *taps;
+    int16_t *history[2];        /* Mirrored rings of 2 * num_taps */
+    int pos;
+    int fir_phase;
+
+    int16_t cic_out[CIC_CHUNK * 2];
+};
+
+/*============================================================================
+ * Primitives
+ *============================================================================*/
+
+static inline int16_t sat16(int32_t x) {
+    if (x > 32767) return 32767;
+    if (x < -32768) return -32768;
+    return (int16_t)x;
+}
+
+static int32_t dot_scalar(const int16_t *a, const int16_t *b, int n) {
+    int32_t acc = 0;
+    for (int k = 0; k < n; k++) acc += (int32_t)a[k] * b[k];
+    return acc;
+}
+
+#if defined(Q15_USE_VECTOR)
+static int32_t dot_vector(const int16_t *a, const int16_t *b, int n) {
+    q15_wide_t acc = {0};
+    for (int k = 0; k < n; k += Q15_FIR_LANES) {
+        q15_vec_t va, vb;
+        memcpy(&va, a + k, sizeof(va));
+        memcpy(&vb, b + k, sizeof(vb));
+        acc += __builtin_convertvector(va, q15_wide_t) * __builtin_convertvector(vb, q15_wide_t);
+    }
+    return acc[0] + acc[1] + acc[2] + acc[3] + acc[4] + acc[5] + acc[6] + acc[7];
+}
+#endif
+
+void q15_from_float(const float *in, int16_t *out, size_t count) {
+    for (size_t n = 0; n < count; n++) {
+        float v = in[n] * 32768.0f;
+        if (v >= 32767.0f) out[n] = 32767;
+        else if (v <= -32768.0f) out[n] = -32768;
+        else out[n] = (int16_t)lrintf(v);
+    }
+}
+
+/*============================================================================
+ * DC Blocker
+ *============================================================================*/
+
+void q15_dc_block_init(q15_dc_block_t *dc, float alpha) {
+    memset(dc, 0, sizeof(*dc));
+    dc->alpha = (int32_t)lrintf(alpha * Q15_ONE);
+    if (dc->alpha > Q15_ONE - 1) dc->alpha = Q15_ONE - 1;
+    if (dc->alpha < 0) dc->alpha = 0;
+}
+
+void q15_dc_block_process(q15_dc_block_t *dc, const int16_t *iq, int16_t *out, size_t count) {
+    for (size_t n = 0; n < count; n++) {
+        for (int c = 0; c < 2; c++) {
+            int32_t x = iq[n * 2 + c];
+            int64_t acc = (int64_t)(x - dc->x1[c]) * Q15_ONE
+                        + (int64_t)dc->alpha * dc->y1[c] + dc->err[c];
+            int32_t y = (int32_t)(acc >> 15);
+            dc->err[c] = (int32_t)(acc - (int64_t)y * Q15_ONE);
+            dc->x1[c] = x;
+            dc->y1[c] = y;
+            out[n * 2 + c] = sat16(y);
+        }
+    }
+}
+
+/*============================================================================
+ * CIC Decimator
+ *============================================================================*/
+
+bool q15_cic_init(q15_cic_t *cic, int decimation, int order) {
+    if (!cic || decimation < 1 || order < 1 || order > Q15_CIC_MAX_ORDER) return false;
+
+    int64_t gain = 1;
+    for (int k = 0; k < order; k++) {
+        gain *= decimation;
+        if (gain > Q15_CIC_MAX_GAIN) return false;
+    }
+
+    memset(cic, 0, sizeof(*cic));
+    cic->decimation = decimation;
+    cic->order = order;
+    cic->norm = ((1LL << 31) + gain / 2) / gain;
+    return true;
+}
+
+size_t q15_cic_process(q15_cic_t *cic, const int16_t *iq, size_t count, int16_t *out) {
+    const int order = cic->order;
+    size_t written = 0;
+
+    for (size_t n = 0; n < count; n++) {
+        for (int c = 0; c < 2; c++) {
+            uint32_t v = (uint32_t)(int32_t)iq[n * 2 + c];
+            for (int k = 0; k < order; k++) {
+                cic->integ[k][c] += v;
+                v = cic->integ[k][c];
+            }
+        }
+        if (++cic->phase < cic->decimation) continue;
+        cic->phase = 0;
+
+        for (int c = 0; c < 2; c++) {
+            uint32_t v = cic->integ[order - 1][c];
+            for (int k = 0; k < order; k++) {
+                uint32_t prev = cic->comb[k][c];
+                cic->comb[k][c] = v;
+                v -= prev;
+            }
+            int64_t y = ((int64_t)(int32_t)v * cic->norm + (1LL << 30)) >> 31;
+            out[written * 2 + c] = sat16((int32_t)y);
+        }
+        written++;
+    }
+    return written;
+}
+
+/*============================================================================
+ * Goertzel Energy
+ *============================================================================*/
+
+int32_t q15_goertzel_coeff(float freq_hz, float sample_rate) {
+    return (int32_t)lrint(2.0 * cos(2.0 * M_PI * freq_hz / sample_rate) * 16384.0);
+}
+
+int64_t q15_goertzel_energy(const int16_t *x, size_t count, size_t stride, int32_t coeff) {
+    /* The state is bounded by count * 2^15 / |sin w|; keep it under 2^30
+     * so the three energy terms stay inside int64 */
+    int64_t sin2_q30 = (1LL << 30) - (int64_t)coeff * coeff;
+    if ((int64_t)count * (int64_t)count >= sin2_q30) return -1;
+
+    int32_t s1 = 0, s2 = 0;
+    for (size_t n = 0; n < count; n++) {
+        int32_t fb = (int32_t)(((int64_t)coeff * s1 + 8192) >> 14);
+        int32_t s0 = x[n * stride] + fb - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+
+    int64_t cross = ((int64_t)coeff * s1 + 8192) >> 14;
+    return (int64_t)s1 * s1 + (int64_t)s2 * s2 - cross * s2;
+}
+
+/*============================================================================
+ * Front End
+ *============================================================================*/
+
+void q15_design_lowpass(float *taps, int num_taps, float cutoff_hz, float sample_rate) {
+    const double fc = cutoff_hz / sample_rate;
+    const double mid = (num_taps - 1) / 2.0;
+    double sum = 0.0;
+
+    for (int k = 0; k < num_taps; k++) {
+        double t = k - mid;
+        double sinc = (fabs(t) < 1e-9) ? 2.0 * fc : sin(2.0 * M_PI * fc * t) / (M_PI * t);
+        double w = (num_taps > 1)
+                 ? 0.42 - 0.5 * cos(2.0 * M_PI * k / (num_taps - 1))
+                        + 0.08 * cos(4.0 * M_PI * k / (num_taps - 1))
+                 : 1.0;
+        taps[k] = (float)(sinc * w);
+        sum += taps[k];
+    }
+    for (int k = 0; k < num_taps; k++) taps[k] = (float)(taps[k] / sum);
+}
+
+void q15_frontend_default_config(q15_frontend_config_t *cfg, int input_rate, int output_rate) {
+    int total = (output_rate > 0) ? input_rate / output_rate : 1;
+    if (total < 1) total = 1;
+
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->input_rate = input_rate;
+    cfg->fir_decimation = (total >= 4 && total % 2 == 0) ? 2 : 1;
+    cfg->cic_decimation = total / cfg->fir_decimation;
+    cfg->cic_order = 1;
+    for (int order = 3; order > 1; order--) {
+        int64_t gain = 1;
+        for (int k = 0; k < order; k++) gain *= cfg->cic_decimation;
+        if (gain <= Q15_CIC_MAX_GAIN) { cfg->cic_order = order; break; }
+    }
+    cfg->fir_taps = Q15_FE_DEFAULT_TAPS;
+    cfg->cutoff_hz = Q15_FE_DEFAULT_CUTOFF;
+    cfg->dc_alpha = 0.0f;
+}
+
+q15_frontend_t *q15_frontend_create(const q15_frontend_config_t *cfg) {
+    if (!cfg || cfg->input_rate <= 0 || cfg->fir_decimation < 1 ||
+        cfg->fir_taps < 1 || cfg->fir_taps > Q15_FIR_MAX_TAPS) {
+        return NULL;
+    }
+
+    q15_cic_t cic;
+    if (!q15_cic_init(&cic, cfg->cic_decimation, cfg->cic_order)) return NULL;
+
+    float fir_rate = (float)cfg->input_rate / cfg->cic_decimation;
+    if (cfg->cutoff_hz <= 0.0f || cfg->cutoff_hz >= fir_rate / 2.0f) return NULL;
+
+    q15_frontend_t *fe = (q15_frontend_t *)calloc(1, sizeof(q15_frontend_t));
+    if (!fe) return NULL;
+
+    fe->cfg = *cfg;
+    fe->cic = cic;
+    fe->num_taps = (cfg->fir_taps + Q15_FIR_LANES - 1) / Q15_FIR_LANES * Q15_FIR_LANES;
+    fe->taps = (int16_t *)calloc(fe->num_taps, sizeof(int16_t));
+    fe->history[0] = (int16_t *)calloc(fe->num_taps * 2, sizeof(int16_t));
+    fe->history[1] = (int16_t *)calloc(fe->num_taps * 2, sizeof(int16_t));
+    float *design = (float *)malloc(cfg->fir_taps * sizeof(float));
+    if (!fe->taps || !fe->history[0] || !fe->history[1] || !design) {
+        free(design);
+        q15_frontend_destroy(fe);
+        return NULL;
+    }
+
+    /* Quantize, then put the rounding residue on the center tap so the DC
+     * gain is exactly one. Padding zeros go at the oldest end. */
+    q15_design_lowpass(design, cfg->fir_taps, cfg->cutoff_hz, fir_rate);
+    int32_t sum = 0, abs_sum = 0;
+    int pad = fe->num_taps - cfg->fir_taps;
+    for (int k = 0; k < cfg->fir_taps; k++) {
+        int16_t q = sat16((int32_t)lrintf(design[k] * Q15_ONE));
+        fe->taps[pad + cfg->fir_taps - 1 - k] = q;
+        sum += q;
+    }
+    fe->taps[pad + cfg->fir_taps / 2] = sat16(fe->taps[pad + cfg->fir_taps / 2] + Q15_ONE - sum);
+    for (int k = 0; k < fe->num_taps; k++) abs_sum += abs(fe->taps[k]);
+    free(design);
+
+    if (abs_sum >= 2 * Q15_ONE) {
+        q15_frontend_destroy(fe);
+        return NULL;
+    }
+
+    fe->use_dc = cfg->dc_alpha > 0.0f;
+    q15_dc_block_init(&fe->dc, cfg->dc_alpha);
+    return fe;
+}
+
+void q15_frontend_destroy(q15_frontend_t *fe) {
+    if (!fe) return;
+    free(fe->taps);
+    free(fe->history[0]);
+    free(fe->history[1]);
+    free(fe);
+}
+
+void q15_frontend_reset(q15_frontend_t *fe) {
+    if (!fe) return;
+    q15_cic_init(&fe->cic, fe->cfg.cic_decimation, fe->cfg.cic_order);
+    q15_dc_block_init(&fe->dc, fe->cfg.dc_alpha);
+    memset(fe->history[0], 0, fe->num_taps * 2 * sizeof(int16_t));
+    memset(fe->history[1], 0, fe->num_taps * 2 * sizeof(int16_t));
+    fe->pos = 0;
+    fe->fir_phase = 0;
+}
+
+float q15_frontend_output_rate(const q15_frontend_t *fe) {
+    return (float)fe->cfg.input_rate / (fe->cfg.cic_decimation * fe->cfg.fir_decimation);
+}
+
+const int16_t *q15_frontend_taps(const q15_frontend_t *fe, int *num_taps) {
+    if (num_taps) *num_taps = fe->num_taps;
+    return fe->taps;
+}
+
+static size_t frontend_run(q15_frontend_t *fe, const int16_t *iq, size_t count,
+                           int16_t *out, size_t out_max, bool vector) {
+    const int n = fe->num_taps;
+    const size_t chunk_in = (size_t)CIC_CHUNK * fe->cic.decimation;
+    size_t written = 0;
+
+#if !defined(Q15_USE_VECTOR)
+    (void)vector;
+#endif
+
+    for (size_t base = 0; base < count; base += chunk_in) {
+        size_t len = (count - base < chunk_in) ? count - base : chunk_in;
+        size_t mid = q15_cic_process(&fe->cic, iq + base * 2, len, fe->cic_out);
+
+        for (size_t s = 0; s < mid; s++) {
+            /* Newest sample at pos and pos + n; window is pos + 1 .. pos + n */
+            fe->pos = (fe->pos + 1 < n) ? fe->pos + 1 : 0;
+            fe->history[0][fe->pos] = fe->history[0][fe->pos + n] = fe->cic_out[s * 2];
+            fe->history[1][fe->pos] = fe->history[1][fe->pos + n] = fe->cic_out[s * 2 + 1];
+
+            if (++fe->fir_phase < fe->cfg.fir_decimation) continue;
+            fe->fir_phase = 0;
+            if (written >= out_max) continue;
+
+            for (int c = 0; c < 2; c++) {
+                const int16_t *window = fe->history[c] + fe->pos + 1;
+                int32_t acc;
+#if defined(Q15_USE_VECTOR)
+                acc = vector ? dot_vector(fe->taps, window, n) : dot_scalar(fe->taps, window, n);
+#else
+                acc = dot_scalar(fe->taps, window, n);
+#endif
+                out[written * 2 + c] = sat16((acc + (1 << 14)) >> 15);
+            }
+            if (fe->use_dc) q15_dc_block_process(&fe->dc, out + written * 2, out + written * 2, 1);
+            written++;
+        }
+    }
+    return written;
+}
+
+size_t q15_frontend_process(q15_frontend_t *fe, const int16_t *iq, size_t count,
+                            int16_t *out, size_t out_max) {
+    return frontend_run(fe, iq, count, out, out_max, true);
+}
+
+size_t q15_frontend_process_scalar(q15_frontend_t *fe, const int16_t *iq, size_t count,
+                                   int16_t *out, size_t out_max) {
+    return frontend_run(fe, iq, count, out, out_max, false);
+}
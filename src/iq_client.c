@@ -0,0 +1,645 @@
+/**
+ * @file iq_client.c
+ * @brief Buffered client for the PHXI and FT32 sample streams
+ *
+ * Frames are parsed straight out of the receive buffer. When the free space
+ * at the end of the buffer drops below one maximum-size frame, the partial
+ * frame at the front is moved down to offset 0 - at most one frame's worth
+ * of bytes, and only every few dozen frames at typical sizes. Headers and
+ * S16/F32 frames are multiples of 4 bytes, so sample pointers stay aligned.
+ * A U8 frame with an odd sample count (or a byte-wise resync) leaves the
+ * next frame off a 4-byte boundary; that frame's events and samples are
+ * copied to an aligned buffer instead of being cast in place.
+ *
+ * Encoded FT32 frames (iq_encoding.h) are decoded into a separate float
+ * buffer that grows to the largest frame seen.
+ *
+ * In multicast mode the same buffer receives one datagram at a time and
+ * relay_mcast reassembles the frames; samples then point into its frame.
+ */
+
+#include "iq_client.h"
+#include "relay_mcast.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+typedef SOCKET socket_t;
+#define SOCKET_INVALID INVALID_SOCKET
+#define socket_close closesocket
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <time.h>
+typedef int socket_t;
+#define SOCKET_INVALID (-1)
+#define socket_close close
+#endif
+
+/*============================================================================
+ * Wire Format
+ *============================================================================*/
+
+#define MAGIC_PHXI  0x50485849      /* "PHXI" - I/Q stream header */
+#define MAGIC_IQDQ  0x49514451      /* "IQDQ" - I/Q data frame */
+#define MAGIC_META  0x4D455441      /* "META" - Metadata update */
+#define MAGIC_FT32  0x46543332      /* "FT32" - Float32 stream header */
+#define MAGIC_DATA  0x44415441      /* "DATA" - Float32 data frame */
+
+#define PHXI_HEADER_BYTES   32
+#define FT32_HEADER_BYTES   16
+#define FRAME_HEADER_BYTES  16      /* IQDQ and DATA */
+#define META_BYTES          32
+
+#define RECV_SOCKET_BUFFER  (1024 * 1024)
+#define RECV_SOCKET_MAX     (16 * 1024 * 1024)
+#define RECV_WINDOW_MS      200     /* Stream time the socket buffer holds */
+
+static uint32_t rd32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));       /* Wire and host are little-endian */
+    return v;
+}
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+struct iq_client {
+    char host[256];
+    int port;
+    iq_client_proto_t expect;
+
+    /* Multicast mode: host is the group */
+    bool mcast;
+    char iface[64];
+    relay_mcast_rx_t *rx;
+    uint64_t last_packet_ms;
+
+    socket_t sock;
+    bool have_header;
+    bool down_reported;
+    iq_client_stream_t stream;
+
+    /* Receive buffer: parse position head, data end tail */
+    uint8_t *buf;
+    size_t cap;
+    size_t head;
+    size_t tail;
+
+    bool have_sequence;
+    uint32_t last_sequence;
+
+    /* Requested FT32 encoding and the decode buffer for encoded frames */
+    iq_encoding_t encoding_req;
+    float *decoded;
+    size_t decoded_cap;             /* I/Q pairs */
+
+    /* Copy of a frame body that starts off a 4-byte boundary */
+    uint8_t *aligned;
+    size_t aligned_cap;             /* Bytes */
+
+    int backoff_min_ms;
+    int backoff_max_ms;
+    int backoff_ms;
+    uint64_t next_attempt_ms;
+
+    iq_client_stats_t stats;
+};
+
+/* Parse results besides the iq_client_status_t values */
+#define PARSE_NEED_DATA     (-1)
+#define PARSE_ERROR         (-2)
+
+/*============================================================================
+ * Platform Helpers
+ *============================================================================*/
+
+static uint64_t now_ms(void) {
+#ifdef _WIN32
+    return GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)(ts.tv_nsec / 1000000);
+#endif
+}
+
+static void sleep_ms(uint64_t ms) {
+#ifdef _WIN32
+    Sleep((DWORD)ms);
+#else
+    struct timespec ts = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static socket_t open_socket(const char *host, int port) {
+    struct addrinfo hints, *result, *rp;
+    char port_str[16];
+    socket_t sock = SOCKET_INVALID;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf(port_str, sizeof(port_str), "%d", port);
+
+    if (getaddrinfo(host, port_str, &hints, &result) != 0) return SOCKET_INVALID;
+
+    for (rp = result; rp != NULL; rp = rp->ai_next) {
+        sock = socket(rp->ai_family, rp->ai_socktype, rp->ai_protocol);
+        if (sock == SOCKET_INVALID) continue;
+        if (connect(sock, rp->ai_addr, (int)rp->ai_addrlen) == 0) break;
+        socket_close(sock);
+        sock = SOCKET_INVALID;
+    }
+    freeaddrinfo(result);
+
+    if (sock != SOCKET_INVALID) {
+        int rcvbuf = RECV_SOCKET_BUFFER;
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (const char *)&rcvbuf, sizeof(rcvbuf));
+    }
+    return sock;
+}
+
+static socket_t open_mcast_socket(const char *group, int port, const char *iface) {
+    struct ip_mreq mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    if (inet_pton(AF_INET, group, &mreq.imr_multiaddr) != 1) return SOCKET_INVALID;
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (iface[0] && inet_pton(AF_INET, iface, &mreq.imr_interface) != 1) return SOCKET_INVALID;
+
+    socket_t sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == SOCKET_INVALID) return SOCKET_INVALID;
+
+    /* Several receivers on one host share the port */
+    int opt = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (const char *)&opt, sizeof(opt));
+    opt = RECV_SOCKET_BUFFER;
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (const char *)&opt, sizeof(opt));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char *)&mreq, sizeof(mreq)) != 0) {
+        socket_close(sock);
+        return SOCKET_INVALID;
+    }
+    return sock;
+}
+
+/* 1 = readable, 0 = timeout, -1 = error */
+static int wait_readable(socket_t sock, uint64_t timeout_ms) {
+    fd_set rfds;
+    FD_ZERO(&rfds);
+    FD_SET(sock, &rfds);
+    struct timeval tv;
+    tv.tv_sec = (long)(timeout_ms / 1000);
+    tv.tv_usec = (long)(timeout_ms % 1000) * 1000;
+    int r = select((int)sock + 1, &rfds, NULL, NULL, &tv);
+    return (r > 0) ? 1 : (r == 0) ? 0 : -1;
+}
+
+/*============================================================================
+ * Connection State
+ *============================================================================*/
+
+static void schedule_reconnect(iq_client_t *c) {
+    c->next_attempt_ms = now_ms() + (uint64_t)c->backoff_ms;
+    c->backoff_ms *= 2;
+    if (c->backoff_ms > c->backoff_max_ms) c->backoff_ms = c->backoff_max_ms;
+}
+
+static void drop_connection(iq_client_t *c) {
+    if (c->sock != SOCKET_INVALID) {
+        socket_close(c->sock);
+        c->sock = SOCKET_INVALID;
+        c->stats.disconnects++;
+    }
+    c->have_header = false;
+    c->have_sequence = false;
+    c->head = 0;
+    c->tail = 0;
+    if (c->rx) relay_mcast_rx_reset(c->rx);
+    schedule_reconnect(c);
+}
+
+/* Read whatever is waiting into the free end of the buffer */
+static bool fill(iq_client_t *c) {
+    if (c->head == c->tail) {
+        c->head = 0;
+        c->tail = 0;
+    } else if (c->cap - c->tail < IQ_CLIENT_MAX_FRAME_BYTES) {
+        memmove(c->buf, c->buf + c->head, c->tail - c->head);
+        c->tail -= c->head;
+        c->head = 0;
+    }
+
+    int n = recv(c->sock, (char *)c->buf + c->tail, (int)(c->cap - c->tail), 0);
+    c->stats.recv_calls++;
+    if (n <= 0) return false;
+    c->tail += (size_t)n;
+    c->stats.bytes += (uint64_t)n;
+    return true;
+}
+
+/*============================================================================
+ * Frame Parsing
+ *============================================================================*/
+
+/* SO_RCVBUF for the stream rate the header announced. The connect-time
+ * default limits a 10 MSPS S16 stream to about 25 ms of round trip. */
+static void size_rcvbuf(iq_client_t *c) {
+    if (c->mcast) return;
+    uint64_t want = (uint64_t)c->stream.sample_rate * iq_client_pair_bytes(c->stream.sample_format) *
+                    RECV_WINDOW_MS / 1000;
+    if (want <= RECV_SOCKET_BUFFER) return;
+    if (want > RECV_SOCKET_MAX) want = RECV_SOCKET_MAX;
+    int rcvbuf = (int)want;
+    setsockopt(c->sock, SOL_SOCKET, SO_RCVBUF, (const char *)&rcvbuf, sizeof(rcvbuf));
+}
+
+static int parse_header(iq_client_t *c) {
+    size_t avail = c->tail - c->head;
+    const uint8_t *p = c->buf + c->head;
+    if (avail < 4) return PARSE_NEED_DATA;
+
+    uint32_t magic = rd32(p);
+    iq_client_stream_t *st = &c->stream;
+    memset(st, 0, sizeof(*st));
+
+    if (magic == MAGIC_PHXI && c->expect != IQ_CLIENT_PROTO_FT32) {
+        if (avail < PHXI_HEADER_BYTES) return PARSE_NEED_DATA;
+        st->proto = IQ_CLIENT_PROTO_PHXI;
+        st->version = rd32(p + 4);
+        st->sample_rate = rd32(p + 8);
+        st->sample_format = rd32(p + 12);
+        st->center_freq = ((uint64_t)rd32(p + 20) << 32) | rd32(p + 16);
+        st->gain_reduction = rd32(p + 24);
+        st->lna_state = rd32(p + 28);
+        st->events = (st->version >= IQ_STREAM_VERSION_EVENTS);
+        c->head += PHXI_HEADER_BYTES;
+    } else if (magic == MAGIC_FT32 && c->expect != IQ_CLIENT_PROTO_PHXI) {
+        if (avail < FT32_HEADER_BYTES) return PARSE_NEED_DATA;
+        st->proto = IQ_CLIENT_PROTO_FT32;
+        st->sample_rate = rd32(p + 4);
+        st->sample_format = IQ_CLIENT_FORMAT_F32;
+        st->encoding = rd32(p + 8);
+        if (st->encoding >= IQ_ENC_COUNT) return PARSE_ERROR;
+        c->head += FT32_HEADER_BYTES;
+    } else {
+        return PARSE_ERROR;
+    }
+
+    if (iq_client_pair_bytes(st->sample_format) == 0) return PARSE_ERROR;
+    size_rcvbuf(c);
+
+    c->have_header = true;
+    c->down_reported = false;
+    c->backoff_ms = c->backoff_min_ms;
+    c->stats.connects++;
+    return IQ_CLIENT_CONNECTED;
+}
+
+static void check_sequence(iq_client_t *c, iq_client_frame_t *frame) {
+    frame->frames_lost = 0;
+    if (c->have_sequence) {
+        uint32_t gap = frame->sequence - (c->last_sequence + 1);
+        if (gap != 0 && gap < 0x80000000u) {       /* Backwards = sender restarted */
+            frame->frames_lost = gap;
+            c->stats.sequence_gaps++;
+            c->stats.frames_lost += gap;
+        }
+    }
+    c->have_sequence = true;
+    c->last_sequence = frame->sequence;
+}
+
+/* Decode an encoded FT32 payload; false if the decode buffer cannot grow */
+static bool decode_frame(iq_client_t *c, const uint8_t *payload, uint32_t num_samples, float scale) {
+    if (num_samples > c->decoded_cap) {
+        float *d = (float *)realloc(c->decoded, (size_t)num_samples * 2 * sizeof(float));
+        if (!d) return false;
+        c->decoded = d;
+        c->decoded_cap = num_samples;
+    }
+    iq_enc_decode((iq_encoding_t)c->stream.encoding, payload, num_samples, scale, c->decoded);
+    return true;
+}
+
+/* Copy a misaligned frame body; NULL if the copy buffer cannot grow */
+static const uint8_t *align_body(iq_client_t *c, const uint8_t *body, size_t bytes) {
+    if (bytes > c->aligned_cap) {
+        uint8_t *a = (uint8_t *)realloc(c->aligned, bytes);
+        if (!a) return NULL;
+        c->aligned = a;
+        c->aligned_cap = bytes;
+    }
+    memcpy(c->aligned, body, bytes);
+    return c->aligned;
+}
+
+static int parse_frame(iq_client_t *c, iq_client_frame_t *frame) {
+    iq_client_stream_t *st = &c->stream;
+    uint32_t pair_bytes = iq_client_pair_bytes(st->sample_format);
+    bool encoded = (st->proto == IQ_CLIENT_PROTO_FT32 && st->encoding != IQ_ENC_F32);
+
+    for (;;) {
+        size_t avail = c->tail - c->head;
+        const uint8_t *p = c->buf + c->head;
+        if (avail < 4) return PARSE_NEED_DATA;
+
+        uint32_t magic = rd32(p);
+        bool data = (st->proto == IQ_CLIENT_PROTO_PHXI) ? (magic == MAGIC_IQDQ) : (magic == MAGIC_DATA);
+
+        if (st->proto == IQ_CLIENT_PROTO_PHXI && magic == MAGIC_META) {
+            if (avail < META_BYTES) return PARSE_NEED_DATA;
+            st->sample_rate = rd32(p + 4);
+            st->sample_format = rd32(p + 8);
+            st->center_freq = ((uint64_t)rd32(p + 16) << 32) | rd32(p + 12);
+            st->gain_reduction = rd32(p + 20);
+            st->lna_state = rd32(p + 24);
+            c->head += META_BYTES;
+            if (iq_client_pair_bytes(st->sample_format) == 0) return PARSE_ERROR;
+            return IQ_CLIENT_META;
+        }
+
+        if (!data) {
+            /* Not on a frame boundary (e.g. joined a relay mid-frame): hunt byte-wise */
+            c->head++;
+            c->stats.resyncs++;
+            continue;
+        }
+
+        if (avail < FRAME_HEADER_BYTES) return PARSE_NEED_DATA;
+        uint32_t num_samples = rd32(p + 8);
+        uint32_t flags = rd32(p + 12);
+        uint32_t n_events = st->events ? IQ_EVENT_COUNT(flags) : 0;
+        uint64_t bytes = FRAME_HEADER_BYTES + (uint64_t)n_events * sizeof(iq_event_t) +
+                         (encoded ? (uint64_t)iq_enc_payload_bytes((iq_encoding_t)st->encoding, num_samples)
+                                  : (uint64_t)num_samples * pair_bytes);
+        if (bytes > IQ_CLIENT_MAX_FRAME_BYTES) return PARSE_ERROR;
+        if (avail < bytes) return PARSE_NEED_DATA;
+
+        const uint8_t *body = p + FRAME_HEADER_BYTES;
+        if (((uintptr_t)body & 3) != 0) {
+            body = align_body(c, body, (size_t)bytes - FRAME_HEADER_BYTES);
+            if (!body) return PARSE_ERROR;
+            c->stats.realigned++;
+        }
+
+        frame->sequence = rd32(p + 4);
+        frame->num_samples = num_samples;
+        frame->flags = flags;
+        frame->n_events = n_events;
+        frame->samples_lost = 0;
+        frame->events = n_events ? (const iq_event_t *)body : NULL;
+        frame->samples = body + n_events * sizeof(iq_event_t);
+        if (encoded) {
+            float scale;
+            memcpy(&scale, p + 12, sizeof(scale));     /* DATA reserved field = frame scale */
+            if (!decode_frame(c, body, num_samples, scale)) return PARSE_ERROR;
+            frame->flags = 0;
+            frame->samples = c->decoded;
+        }
+        check_sequence(c, frame);
+
+        c->head += (size_t)bytes;
+        c->stats.frames++;
+        return IQ_CLIENT_FRAME;
+    }
+}
+
+/*============================================================================
+ * Multicast
+ *============================================================================*/
+
+static iq_client_status_t mcast_next(iq_client_t *c, iq_client_frame_t *frame, uint64_t deadline) {
+    for (;;) {
+        relay_mcast_frame_t mf;
+        if (c->have_header && relay_mcast_rx_pop(c->rx, &mf)) {
+            frame->sequence = mf.frame_seq;
+            frame->num_samples = mf.num_samples;
+            frame->flags = 0;
+            frame->samples = mf.iq;
+            frame->events = NULL;
+            frame->n_events = 0;
+            frame->samples_lost = mf.samples_lost;
+            check_sequence(c, frame);
+            c->stats.frames++;
+            c->stats.samples_lost += mf.samples_lost;
+            return IQ_CLIENT_FRAME;
+        }
+
+        uint64_t now = now_ms();
+        if (c->have_header && now - c->last_packet_ms > IQ_CLIENT_MCAST_IDLE_MS) {
+            /* Relay gone quiet: keep the membership, start over on the next packet */
+            c->have_header = false;
+            c->have_sequence = false;
+            relay_mcast_rx_reset(c->rx);
+            c->stats.disconnects++;
+            c->down_reported = true;
+            return IQ_CLIENT_DISCONNECTED;
+        }
+
+        int w = wait_readable(c->sock, (now < deadline) ? deadline - now : 0);
+        if (w == 0) return IQ_CLIENT_TIMEOUT;
+        if (w < 0) {
+            drop_connection(c);
+            c->down_reported = true;
+            return IQ_CLIENT_DISCONNECTED;
+        }
+
+        int n = recv(c->sock, (char *)c->buf, (int)c->cap, 0);
+        c->stats.recv_calls++;
+        if (n <= 0) continue;
+        c->stats.bytes += (uint64_t)n;
+        if (!relay_mcast_rx_push(c->rx, c->buf, (size_t)n)) {
+            c->stats.resyncs++;
+            continue;
+        }
+        c->last_packet_ms = now_ms();
+
+        uint32_t rate = relay_mcast_rx_sample_rate(c->rx);
+        if (!c->have_header) {
+            memset(&c->stream, 0, sizeof(c->stream));
+            c->stream.proto = IQ_CLIENT_PROTO_FT32;
+            c->stream.sample_rate = rate;
+            c->stream.sample_format = IQ_CLIENT_FORMAT_F32;
+            c->have_header = true;
+            c->down_reported = false;
+            c->stats.connects++;
+            return IQ_CLIENT_CONNECTED;
+        }
+        if (rate != c->stream.sample_rate) {
+            c->stream.sample_rate = rate;
+            return IQ_CLIENT_META;
+        }
+    }
+}
+
+/*============================================================================
+ * Public API
+ *============================================================================*/
+
+iq_client_t *iq_client_create(const char *host, int port, iq_client_proto_t expect) {
+    if (!host) return NULL;
+
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return NULL;
+#endif
+
+    iq_client_t *c = (iq_client_t *)calloc(1, sizeof(iq_client_t));
+    if (!c) return NULL;
+    c->cap = IQ_CLIENT_RECV_BUFFER;
+    c->buf = (uint8_t *)malloc(c->cap);
+    if (!c->buf) {
+        free(c);
+        return NULL;
+    }
+
+    strncpy(c->host, host, sizeof(c->host) - 1);
+    c->port = port;
+    c->expect = expect;
+    c->sock = SOCKET_INVALID;
+    c->backoff_min_ms = IQ_CLIENT_BACKOFF_MIN_MS;
+    c->backoff_max_ms = IQ_CLIENT_BACKOFF_MAX_MS;
+    c->backoff_ms = c->backoff_min_ms;
+    c->next_attempt_ms = 0;
+    return c;
+}
+
+iq_client_t *iq_client_create_mcast(const char *group, int port, const char *iface) {
+    iq_client_t *c = iq_client_create(group, port, IQ_CLIENT_PROTO_FT32);
+    if (!c) return NULL;
+    c->rx = relay_mcast_rx_create();
+    if (!c->rx) {
+        iq_client_destroy(c);
+        return NULL;
+    }
+    c->mcast = true;
+    if (iface) strncpy(c->iface, iface, sizeof(c->iface) - 1);
+    return c;
+}
+
+void iq_client_destroy(iq_client_t *c) {
+    if (!c) return;
+    if (c->sock != SOCKET_INVALID) socket_close(c->sock);
+    relay_mcast_rx_destroy(c->rx);
+    free(c->decoded);
+    free(c->aligned);
+    free(c->buf);
+    free(c);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void iq_client_set_encoding(iq_client_t *c, iq_encoding_t encoding) {
+    if (!c || encoding >= IQ_ENC_COUNT) return;
+    c->encoding_req = encoding;
+}
+
+void iq_client_set_backoff(iq_client_t *c, int min_ms, int max_ms) {
+    if (!c || min_ms <= 0 || max_ms < min_ms) return;
+    c->backoff_min_ms = min_ms;
+    c->backoff_max_ms = max_ms;
+    c->backoff_ms = min_ms;
+}
+
+iq_client_status_t iq_client_next(iq_client_t *c, iq_client_frame_t *frame, int timeout_ms) {
+    if (!c || !frame) return IQ_CLIENT_TIMEOUT;
+    uint64_t deadline = now_ms() + (uint64_t)(timeout_ms > 0 ? timeout_ms : 0);
+
+    for (;;) {
+        uint64_t now = now_ms();
+
+        if (c->sock == SOCKET_INVALID) {
+            if (now < c->next_attempt_ms) {
+                if (now >= deadline) return IQ_CLIENT_TIMEOUT;
+                uint64_t until = (c->next_attempt_ms < deadline) ? c->next_attempt_ms : deadline;
+                sleep_ms(until - now);
+                continue;
+            }
+            c->sock = c->mcast ? open_mcast_socket(c->host, c->port, c->iface)
+                               : open_socket(c->host, c->port);
+            if (c->sock == SOCKET_INVALID) {
+                schedule_reconnect(c);
+                if (!c->down_reported) {
+                    c->down_reported = true;
+                    return IQ_CLIENT_DISCONNECTED;
+                }
+                continue;
+            }
+            if (!c->mcast && c->encoding_req != IQ_ENC_F32) {
+                iq_enc_request_t req = { IQ_ENC_REQUEST_MAGIC, (uint32_t)c->encoding_req, 0, 0 };
+                send(c->sock, (const char *)&req, sizeof(req), 0);
+            }
+        }
+
+        if (c->mcast) return mcast_next(c, frame, deadline);
+
+        int r = c->have_header ? parse_frame(c, frame) : parse_header(c);
+        if (r >= 0) return (iq_client_status_t)r;
+        if (r == PARSE_ERROR) {
+            drop_connection(c);
+            c->down_reported = true;
+            return IQ_CLIENT_DISCONNECTED;
+        }
+
+        /* Need more bytes */
+        now = now_ms();
+        int w = wait_readable(c->sock, (now < deadline) ? deadline - now : 0);
+        if (w == 0) return IQ_CLIENT_TIMEOUT;
+        if (w < 0 || !fill(c)) {
+            drop_connection(c);
+            c->down_reported = true;
+            return IQ_CLIENT_DISCONNECTED;
+        }
+    }
+}
+
+void iq_client_disconnect(iq_client_t *c) {
+    if (!c || c->sock == SOCKET_INVALID) return;
+    drop_connection(c);
+    c->down_reported = true;
+}
+
+bool iq_client_connected(const iq_client_t *c) {
+    return c && c->sock != SOCKET_INVALID && c->have_header;
+}
+
+const iq_client_stream_t *iq_client_stream(const iq_client_t *c) {
+    return c ? &c->stream : NULL;
+}
+
+void iq_client_get_stats(const iq_client_t *c, iq_client_stats_t *stats) {
+    if (!c || !stats) return;
+    *stats = c->stats;
+    if (c->rx) {
+        relay_mcast_rx_stats_t rs;
+        relay_mcast_rx_get_stats(c->rx, &rs);
+        stats->packets_recovered = rs.recovered;
+    }
+}
+
+uint32_t iq_client_pair_bytes(uint32_t sample_format) {
+    switch (sample_format) {
+        case IQ_CLIENT_FORMAT_S16: return 4;
+        case IQ_CLIENT_FORMAT_F32: return 8;
+        case IQ_CLIENT_FORMAT_U8:  return 2;
+        default:                   return 0;
+    }
+}
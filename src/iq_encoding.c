@@ -0,0 +1,452 @@
+/**
+ * @file iq_encoding.c
+ * @brief Compact sample encodings for the FT32 relay streams
+ *
+ * The vector paths work on whole groups of 8 floats (S16/ULAW) or whole
+ * S8 blocks and fall through to the scalar code for the tail. Both round
+ * to nearest-even after the same single multiply, so the two paths give
+ * bit-identical payloads.
+ */
+
+#include "iq_encoding.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IQ_ENC_USE_SSE2 1
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+#include <arm_neon.h>
+#define IQ_ENC_USE_NEON 1
+#endif
+
+#define S16_FULL_SCALE      32767.0f
+#define S8_FULL_SCALE       127.0f
+#define S8_BLOCK_VALUES     (IQ_ENC_S8_BLOCK * 2)
+
+#define ULAW_BIAS           0x84
+#define ULAW_CLIP           32635
+
+static size_t align4(size_t n) {
+    return (n + 3) & ~(size_t)3;
+}
+
+static size_t s8_blocks(uint32_t num_samples) {
+    return ((size_t)num_samples + IQ_ENC_S8_BLOCK - 1) / IQ_ENC_S8_BLOCK;
+}
+
+/*============================================================================
+ * Primitives
+ *============================================================================*/
+
+static float peak_abs(const float *in, size_t count, bool simd) {
+    size_t n = 0;
+    float peak = 0.0f;
+
+#if defined(IQ_ENC_USE_SSE2)
+    if (simd && count >= 8) {
+        const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        __m128 a = _mm_setzero_ps(), b = _mm_setzero_ps();
+        for (; n + 8 <= count; n += 8) {
+            a = _mm_max_ps(a, _mm_and_ps(_mm_loadu_ps(in + n), mask));
+            b = _mm_max_ps(b, _mm_and_ps(_mm_loadu_ps(in + n + 4), mask));
+        }
+        a = _mm_max_ps(a, b);
+        a = _mm_max_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+        a = _mm_max_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+        peak = _mm_cvtss_f32(a);
+    }
+#elif defined(IQ_ENC_USE_NEON)
+    if (simd && count >= 8) {
+        float32x4_t a = vdupq_n_f32(0.0f), b = vdupq_n_f32(0.0f);
+        for (; n + 8 <= count; n += 8) {
+            a = vmaxq_f32(a, vabsq_f32(vld1q_f32(in + n)));
+            b = vmaxq_f32(b, vabsq_f32(vld1q_f32(in + n + 4)));
+        }
+        peak = vmaxvq_f32(vmaxq_f32(a, b));
+    }
+#else
+    (void)simd;
+#endif
+
+    for (; n < count; n++) {
+        float v = fabsf(in[n]);
+        if (v > peak) peak = v;
+    }
+    return peak;
+}
+
+/* out = clamp(round(in * mul)) to int16 */
+static void quantize_s16(const float *in, int16_t *out, size_t count, float mul, bool simd) {
+    size_t n = 0;
+
+#if defined(IQ_ENC_USE_SSE2)
+    if (simd) {
+        /* Clamp in float first: cvtps maps out-of-range values to INT_MIN */
+        const __m128 scale = _mm_set1_ps(mul);
+        const __m128 vmax = _mm_set1_ps(32767.0f);
+        const __m128 vmin = _mm_set1_ps(-32768.0f);
+        for (; n + 8 <= count; n += 8) {
+            __m128 a = _mm_mul_ps(_mm_loadu_ps(in + n), scale);
+            __m128 b = _mm_mul_ps(_mm_loadu_ps(in + n + 4), scale);
+            a = _mm_max_ps(_mm_min_ps(a, vmax), vmin);
+            b = _mm_max_ps(_mm_min_ps(b, vmax), vmin);
+            _mm_storeu_si128((__m128i *)(out + n), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+        }
+    }
+#elif defined(IQ_ENC_USE_NEON)
+    if (simd) {
+        const float32x4_t scale = vdupq_n_f32(mul);
+        for (; n + 8 <= count; n += 8) {
+            int32x4_t a = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(in + n), scale));
+            int32x4_t b = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(in + n + 4), scale));
+            vst1q_s16(out + n, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+        }
+    }
+#else
+    (void)simd;
+#endif
+
+    for (; n < count; n++) {
+        float v = in[n] * mul;
+        if (v > 32767.0f) v = 32767.0f;
+        if (v < -32768.0f) v = -32768.0f;
+        out[n] = (int16_t)lrintf(v);
+    }
+}
+
+/* out = in * scale */
+static void expand_s16(const int16_t *in, float *out, size_t count, float scale, bool simd) {
+    size_t n = 0;
+
+#if defined(IQ_ENC_USE_SSE2)
+    if (simd) {
+        const __m128 vs = _mm_set1_ps(scale);
+        for (; n + 8 <= count; n += 8) {
+            __m128i x = _mm_loadu_si128((const __m128i *)(in + n));
+            /* Sign-extend by placing each value in the high half, then shifting down */
+            __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+            __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+            _mm_storeu_ps(out + n, _mm_mul_ps(_mm_cvtepi32_ps(lo), vs));
+            _mm_storeu_ps(out + n + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vs));
+        }
+    }
+#elif defined(IQ_ENC_USE_NEON)
+    if (simd) {
+        const float32x4_t vs = vdupq_n_f32(scale);
+        for (; n + 8 <= count; n += 8) {
+            int16x8_t x = vld1q_s16(in + n);
+            vst1q_f32(out + n, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), vs));
+            vst1q_f32(out + n + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), vs));
+        }
+    }
+#else
+    (void)simd;
+#endif
+
+    for (; n < count; n++) {
+        out[n] = (float)in[n] * scale;
+    }
+}
+
+/*============================================================================
+ * S8 Block Floating Point
+ *============================================================================*/
+
+/* Exponent e such that peak * 2^-e < 127 */
+static int s8_exponent(float peak) {
+    if (!(peak > 0.0f)) return 0;
+    int e;
+    frexpf(peak / S8_FULL_SCALE, &e);
+    if (e < -126) e = -126;
+    if (e > 127) e = 127;
+    return e;
+}
+
+static void s8_encode(const float *iq, uint32_t num_samples, uint8_t *out, bool simd) {
+    size_t blocks = s8_blocks(num_samples);
+    size_t count = (size_t)num_samples * 2;
+    int8_t *exps = (int8_t *)out;
+    int8_t *q = (int8_t *)out + blocks;
+
+    for (size_t b = 0; b < blocks; b++) {
+        size_t start = b * S8_BLOCK_VALUES;
+        size_t len = (count - start < S8_BLOCK_VALUES) ? count - start : S8_BLOCK_VALUES;
+        const float *in = iq + start;
+        int e = s8_exponent(peak_abs(in, len, simd));
+        float mul = ldexpf(1.0f, -e);
+        exps[b] = (int8_t)e;
+
+        size_t n = 0;
+#if defined(IQ_ENC_USE_SSE2)
+        if (simd && len == S8_BLOCK_VALUES) {
+            const __m128 vm = _mm_set1_ps(mul);
+            for (; n < S8_BLOCK_VALUES; n += 16) {
+                __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + n), vm));
+                __m128i b4 = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + n + 4), vm));
+                __m128i c = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + n + 8), vm));
+                __m128i d = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + n + 12), vm));
+                __m128i packed = _mm_packs_epi16(_mm_packs_epi32(a, b4), _mm_packs_epi32(c, d));
+                _mm_storeu_si128((__m128i *)(q + start + n), packed);
+            }
+        }
+#elif defined(IQ_ENC_USE_NEON)
+        if (simd && len == S8_BLOCK_VALUES) {
+            const float32x4_t vm = vdupq_n_f32(mul);
+            for (; n < S8_BLOCK_VALUES; n += 8) {
+                int32x4_t a = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(in + n), vm));
+                int32x4_t b4 = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(in + n + 4), vm));
+                vst1_s8(q + start + n, vqmovn_s16(vcombine_s16(vqmovn_s32(a), vqmovn_s32(b4))));
+            }
+        }
+#endif
+        for (; n < len; n++) {
+            float v = in[n] * mul;
+            if (v > S8_FULL_SCALE) v = S8_FULL_SCALE;
+            if (v < -S8_FULL_SCALE) v = -S8_FULL_SCALE;
+            q[start + n] = (int8_t)lrintf(v);
+        }
+    }
+}
+
+static void s8_decode(const uint8_t *in, uint32_t num_samples, float *iq, bool simd) {
+    size_t blocks = s8_blocks(num_samples);
+    size_t count = (size_t)num_samples * 2;
+    const int8_t *exps = (const int8_t *)in;
+    const int8_t *q = (const int8_t *)in + blocks;
+
+    for (size_t b = 0; b < blocks; b++) {
+        size_t start = b * S8_BLOCK_VALUES;
+        size_t len = (count - start < S8_BLOCK_VALUES) ? count - start : S8_BLOCK_VALUES;
+        float scale = ldexpf(1.0f, exps[b]);
+        float *out = iq + start;
+
+        size_t n = 0;
+#if defined(IQ_ENC_USE_SSE2)
+        if (simd && len == S8_BLOCK_VALUES) {
+            const __m128 vs = _mm_set1_ps(scale);
+            for (; n < S8_BLOCK_VALUES; n += 16) {
+                __m128i x = _mm_loadu_si128((const __m128i *)(q + start + n));
+                __m128i lo16 = _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+                __m128i hi16 = _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8);
+                __m128i w[4] = {
+                    _mm_srai_epi32(_mm_unpacklo_epi16(lo16, lo16), 16),
+                    _mm_srai_epi32(_mm_unpackhi_epi16(lo16, lo16), 16),
+                    _mm_srai_epi32(_mm_unpacklo_epi16(hi16, hi16), 16),
+                    _mm_srai_epi32(_mm_unpackhi_epi16(hi16, hi16), 16)
+                };
+                for (int k = 0; k < 4; k++) {
+                    _mm_storeu_ps(out + n + 4 * k, _mm_mul_ps(_mm_cvtepi32_ps(w[k]), vs));
+                }
+            }
+        }
+#elif defined(IQ_ENC_USE_NEON)
+        if (simd && len == S8_BLOCK_VALUES) {
+            const float32x4_t vs = vdupq_n_f32(scale);
+            for (; n < S8_BLOCK_VALUES; n += 8) {
+                int16x8_t x = vmovl_s8(vld1_s8(q + start + n));
+                vst1q_f32(out + n, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), vs));
+                vst1q_f32(out + n + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), vs));
+            }
+        }
+#endif
+        for (; n < len; n++) {
+            out[n] = (float)q[start + n] * scale;
+        }
+    }
+}
+
+/*============================================================================
+ * Mu-law (G.711)
+ *============================================================================*/
+
+static uint8_t ulaw_encode(int pcm) {
+    int sign = 0;
+    if (pcm < 0) {
+        pcm = -pcm;
+        sign = 0x80;
+    }
+    if (pcm > ULAW_CLIP) pcm = ULAW_CLIP;
+    pcm += ULAW_BIAS;
+
+    int exponent = 0;
+    for (int v = pcm >> 8; v; v >>= 1) exponent++;
+    int mantissa = (pcm >> (exponent + 3)) & 0x0F;
+    return (uint8_t)~(sign | (exponent << 4) | mantissa);
+}
+
+static int ulaw_decode(uint8_t u) {
+    u = (uint8_t)~u;
+    int t = (((u & 0x0F) << 3) + ULAW_BIAS) << ((u >> 4) & 0x07);
+    t -= ULAW_BIAS;
+    return (u & 0x80) ? -t : t;
+}
+
+/*============================================================================
+ * Frame Encode / Decode
+ *============================================================================*/
+
+static size_t encode(iq_encoding_t enc, const float *iq, uint32_t num_samples,
+                     uint8_t *out, float *scale, bool simd) {
+    size_t count = (size_t)num_samples * 2;
+    size_t bytes = iq_enc_payload_bytes(enc, num_samples);
+    if (bytes == 0) return 0;
+
+    *scale = 0.0f;
+    switch (enc) {
+    case IQ_ENC_F32:
+        memcpy(out, iq, count * sizeof(float));
+        return bytes;
+
+    case IQ_ENC_S16: {
+        float peak = peak_abs(iq, count, simd);
+        float s = (peak > 0.0f) ? peak / S16_FULL_SCALE : 1.0f;
+        quantize_s16(iq, (int16_t *)out, count, 1.0f / s, simd);
+        *scale = s;
+        break;
+    }
+
+    case IQ_ENC_S8:
+        s8_encode(iq, num_samples, out, simd);
+        break;
+
+    case IQ_ENC_ULAW: {
+        /* Vector quantize to int16 a chunk at a time, then compand */
+        float peak = peak_abs(iq, count, simd);
+        float s = (peak > 0.0f) ? peak / (float)ULAW_CLIP : 1.0f;
+        int16_t pcm[256];
+        for (size_t base = 0; base < count; base += 256) {
+            size_t len = (count - base < 256) ? count - base : 256;
+            quantize_s16(iq + base, pcm, len, 1.0f / s, simd);
+            for (size_t n = 0; n < len; n++) out[base + n] = ulaw_encode(pcm[n]);
+        }
+        *scale = s;
+        break;
+    }
+
+    default:
+        return 0;
+    }
+
+    /* Zero the alignment padding so payloads are deterministic */
+    size_t used = (enc == IQ_ENC_S16) ? count * 2 :
+                  (enc == IQ_ENC_S8) ? s8_blocks(num_samples) + count : count;
+    memset(out + used, 0, bytes - used);
+    return bytes;
+}
+
+static void decode(iq_encoding_t enc, const uint8_t *in, uint32_t num_samples,
+                   float scale, float *iq, bool simd) {
+    size_t count = (size_t)num_samples * 2;
+
+    switch (enc) {
+    case IQ_ENC_F32:
+        memcpy(iq, in, count * sizeof(float));
+        break;
+    case IQ_ENC_S16:
+        expand_s16((const int16_t *)in, iq, count, scale, simd);
+        break;
+    case IQ_ENC_S8:
+        s8_decode(in, num_samples, iq, simd);
+        break;
+    case IQ_ENC_ULAW:
+        for (size_t n = 0; n < count; n++) iq[n] = (float)ulaw_decode(in[n]) * scale;
+        break;
+    default:
+        memset(iq, 0, count * sizeof(float));
+        break;
+    }
+}
+
+/*============================================================================
+ * Public API
+ *============================================================================*/
+
+const char *iq_enc_name(iq_encoding_t enc) {
+    switch (enc) {
+        case IQ_ENC_F32:  return "f32";
+        case IQ_ENC_S16:  return "s16";
+        case IQ_ENC_S8:   return "s8";
+        case IQ_ENC_ULAW: return "ulaw";
+        default:          return NULL;
+    }
+}
+
+bool iq_enc_parse(const char *name, iq_encoding_t *enc) {
+    if (!name || !enc) return false;
+    for (int e = 0; e < IQ_ENC_COUNT; e++) {
+        const char *n = iq_enc_name((iq_encoding_t)e);
+        size_t k = 0;
+        while (n[k] && name[k] && (name[k] | 0x20) == n[k]) k++;
+        if (!n[k] && !name[k]) {
+            *enc = (iq_encoding_t)e;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t iq_enc_payload_bytes(iq_encoding_t enc, uint32_t num_samples) {
+    size_t count = (size_t)num_samples * 2;
+    switch (enc) {
+        case IQ_ENC_F32:  return count * sizeof(float);
+        case IQ_ENC_S16:  return align4(count * sizeof(int16_t));
+        case IQ_ENC_S8:   return align4(s8_blocks(num_samples) + count);
+        case IQ_ENC_ULAW: return align4(count);
+        default:          return 0;
+    }
+}
+
+size_t iq_enc_encode(iq_encoding_t enc, const float *iq, uint32_t num_samples,
+                     uint8_t *out, float *scale) {
+    return encode(enc, iq, num_samples, out, scale, true);
+}
+
+void iq_enc_decode(iq_encoding_t enc, const uint8_t *in, uint32_t num_samples,
+                   float scale, float *iq) {
+    decode(enc, in, num_samples, scale, iq, true);
+}
+
+size_t iq_enc_encode_scalar(iq_encoding_t enc, const float *iq, uint32_t num_samples,
+                            uint8_t *out, float *scale) {
+    return encode(enc, iq, num_samples, out, scale, false);
+}
+
+void iq_enc_decode_scalar(iq_encoding_t enc, const uint8_t *in, uint32_t num_samples,
+                          float scale, float *iq) {
+    decode(enc, in, num_samples, scale, iq, false);
+}
+
+bool iq_enc_measure(iq_encoding_t enc, const float *iq, uint32_t num_samples,
+                    iq_enc_quality_t *quality) {
+    size_t bytes = iq_enc_payload_bytes(enc, num_samples);
+    if (!quality || bytes == 0 || num_samples == 0) return false;
+
+    uint8_t *payload = (uint8_t *)malloc(bytes);
+    float *back = (float *)malloc((size_t)num_samples * 2 * sizeof(float));
+    if (!payload || !back) {
+        free(payload);
+        free(back);
+        return false;
+    }
+
+    float scale;
+    encode(enc, iq, num_samples, payload, &scale, true);
+    decode(enc, payload, num_samples, scale, back, true);
+
+    double sig = 0.0, err = 0.0;
+    for (size_t n = 0; n < (size_t)num_samples * 2; n++) {
+        double d = (double)iq[n] - (double)back[n];
+        sig += (double)iq[n] * iq[n];
+        err += d * d;
+    }
+
+    quality->bytes_per_pair = (double)bytes / num_samples;
+    quality->ratio = (double)bytes / ((double)num_samples * 8.0);
+    quality->snr_db = (err > 0.0) ? 10.0 * log10(sig / err) : INFINITY;
+
+    free(payload);
+    free(back);
+    return true;
+}
@@ -0,0 +1,262 @@
+/**
+ * @file iq_events.c
+ * @brief Sample-accurate event markers carried in-band in the I/Q stream
+ *
+ * The marker queue is a bounded multi-producer ring: each cell carries a
+ * sequence number that tells a producer it is free and the consumer that it
+ * is filled, so posting is a single compare-exchange on the tail and never
+ * blocks the SDRplay callback threads.
+ */
+
+#include "iq_events.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+
+/*============================================================================
+ * Marker Queue
+ *============================================================================*/
+
+typedef struct {
+    atomic_size_t seq;
+    uint64_t position;
+    uint16_t type;
+    int16_t  aux;
+    int32_t  value;
+} marker_cell_t;
+
+struct iq_marker_queue {
+    marker_cell_t *cells;
+    size_t mask;
+    atomic_size_t tail;                 /* Next cell to post */
+    size_t head;                        /* Next cell to take (consumer only) */
+    atomic_uint_least64_t dropped;
+};
+
+iq_marker_queue_t *iq_marker_queue_create(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+
+    iq_marker_queue_t *q = (iq_marker_queue_t *)calloc(1, sizeof(iq_marker_queue_t));
+    if (!q) return NULL;
+    q->cells = (marker_cell_t *)calloc(size, sizeof(marker_cell_t));
+    if (!q->cells) {
+        free(q);
+        return NULL;
+    }
+    q->mask = size - 1;
+    for (size_t i = 0; i < size; i++) atomic_init(&q->cells[i].seq, i);
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->dropped, 0);
+    return q;
+}
+
+void iq_marker_queue_destroy(iq_marker_queue_t *q) {
+    if (!q) return;
+    free(q->cells);
+    free(q);
+}
+
+bool iq_marker_queue_post(iq_marker_queue_t *q, uint64_t position,
+                          iq_event_type_t type, int16_t aux, int32_t value) {
+    if (!q) return false;
+
+    size_t pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    marker_cell_t *cell;
+    for (;;) {
+        cell = &q->cells[pos & q->mask];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            atomic_fetch_add_explicit(&q->dropped, 1, memory_order_relaxed);
+            return false;
+        } else {
+            pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+        }
+    }
+
+    cell->position = position;
+    cell->type = (uint16_t)type;
+    cell->aux = aux;
+    cell->value = value;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+int iq_marker_queue_take(iq_marker_queue_t *q, uint64_t first_sample,
+                         uint32_t num_samples, iq_event_t *out, int max) {
+    if (!q) return 0;
+    uint64_t end = first_sample + num_samples;
+    int n = 0;
+
+    for (;;) {
+        marker_cell_t *cell = &q->cells[q->head & q->mask];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        if (seq != q->head + 1) break;                  /* Empty or still being written */
+        if (cell->position >= end) break;               /* Belongs to a later frame */
+
+        if (n < max) {
+            iq_event_t ev;
+            ev.offset = (cell->position > first_sample) ?
+                        (uint32_t)(cell->position - first_sample) : 0;
+            ev.type = cell->type;
+            ev.aux = cell->aux;
+            ev.value = cell->value;
+            ev.delta = 0;
+
+            /* Producers on different threads may interleave - keep offset order */
+            int k = n++;
+            while (k > 0 && out[k - 1].offset > ev.offset) {
+                out[k] = out[k - 1];
+                k--;
+            }
+            out[k] = ev;
+        } else {
+            atomic_fetch_add_explicit(&q->dropped, 1, memory_order_relaxed);
+        }
+
+        atomic_store_explicit(&cell->seq, q->head + q->mask + 1, memory_order_release);
+        q->head++;
+    }
+    return n;
+}
+
+void iq_marker_queue_clear(iq_marker_queue_t *q) {
+    if (!q) return;
+    for (;;) {
+        marker_cell_t *cell = &q->cells[q->head & q->mask];
+        if (atomic_load_explicit(&cell->seq, memory_order_acquire) != q->head + 1) break;
+        atomic_store_explicit(&cell->seq, q->head + q->mask + 1, memory_order_release);
+        q->head++;
+    }
+}
+
+uint64_t iq_marker_queue_dropped(iq_marker_queue_t *q) {
+    return q ? atomic_load_explicit(&q->dropped, memory_order_relaxed) : 0;
+}
+
+/*============================================================================
+ * Conditioner
+ *============================================================================*/
+
+static uint32_t us_to_samples(uint32_t sample_rate, uint32_t us) {
+    return (uint32_t)(((uint64_t)sample_rate * us + 500000) / 1000000);
+}
+
+void iq_conditioner_init(iq_conditioner_t *c, uint32_t sample_rate) {
+    if (!c) return;
+    memset(c, 0, sizeof(*c));
+    c->rescale = true;
+    c->gain_settle = us_to_samples(sample_rate, IQ_COND_GAIN_SETTLE_US);
+    c->retune_settle = us_to_samples(sample_rate, IQ_COND_RETUNE_SETTLE_US);
+    c->overload_max_blank = us_to_samples(sample_rate, IQ_COND_OVERLOAD_BLANK_MS * 1000);
+    c->scale = 1.0f;
+}
+
+void iq_conditioner_reset(iq_conditioner_t *c) {
+    if (!c) return;
+    c->gain_offset_cdb = 0;
+    c->scale = 1.0f;
+    c->blank_left = 0;
+    c->hold_left = 0;
+    c->overloaded = false;
+    c->overload_blanked = 0;
+    c->events = 0;
+    c->samples_blanked = 0;
+    c->samples_held = 0;
+}
+
+static void apply_event(iq_conditioner_t *c, const iq_event_t *ev) {
+    c->events++;
+    switch (ev->type) {
+        case IQ_EVENT_GAIN:
+            if (c->rescale && ev->delta != 0) {
+                /* Gain went up by delta: scale down by the same to stay level */
+                c->gain_offset_cdb += ev->delta;
+                c->scale = powf(10.0f, -(float)c->gain_offset_cdb / 2000.0f);
+            }
+            if (c->blank_left < c->gain_settle) c->blank_left = c->gain_settle;
+            break;
+
+        case IQ_EVENT_OVERLOAD:
+            c->overloaded = (ev->value != 0);
+            c->overload_blanked = 0;
+            if (!c->overloaded && c->hold_left < c->gain_settle) {
+                c->hold_left = c->gain_settle;
+            }
+            break;
+
+        case IQ_EVENT_FREQ:
+        case IQ_EVENT_DISCONTINUITY:
+            if (c->hold_left < c->retune_settle) c->hold_left = c->retune_settle;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* Process samples [from, to) under the current state */
+static uint32_t apply_span(iq_conditioner_t *c, float *iq, uint8_t *hold,
+                           uint32_t from, uint32_t to) {
+    uint32_t held = 0;
+
+    if (c->scale != 1.0f) {
+        for (uint32_t s = from; s < to; s++) {
+            iq[s * 2] *= c->scale;
+            iq[s * 2 + 1] *= c->scale;
+        }
+    }
+
+    for (uint32_t s = from; s < to; s++) {
+        bool blank = false;
+        if (c->blank_left > 0) {
+            c->blank_left--;
+            blank = true;
+        }
+        if (c->overloaded && c->overload_blanked < c->overload_max_blank) {
+            c->overload_blanked++;
+            blank = true;
+        }
+        bool h = blank || c->overloaded || c->hold_left > 0;
+        if (c->hold_left > 0) c->hold_left--;
+
+        if (blank) {
+            iq[s * 2] = 0.0f;
+            iq[s * 2 + 1] = 0.0f;
+            c->samples_blanked++;
+        }
+        if (h) held++;
+        if (hold) hold[s] = h ? 1 : 0;
+    }
+
+    c->samples_held += held;
+    return held;
+}
+
+uint32_t iq_conditioner_apply(iq_conditioner_t *c, float *iq, uint8_t *hold,
+                              uint32_t num_samples,
+                              const iq_event_t *events, uint32_t n_events) {
+    if (!c || !iq) return 0;
+
+    uint32_t held = 0;
+    uint32_t pos = 0;
+    for (uint32_t e = 0; e < n_events; e++) {
+        uint32_t at = events[e].offset;
+        if (at > num_samples) at = num_samples;
+        if (at > pos) {
+            held += apply_span(c, iq, hold, pos, at);
+            pos = at;
+        }
+        apply_event(c, &events[e]);
+    }
+    held += apply_span(c, iq, hold, pos, num_samples);
+    return held;
+}
@@ -0,0 +1,224 @@
+/**
+ * @file iq_framer.c
+ * @brief Adaptive IQDQ framing and socket sizing for the sdr_server I/Q stream
+ *
+ * Arrival times are a ring of (stream end position, time) pairs, one per
+ * SDR callback. Positions only grow, so the callback that delivered a given
+ * sample is the oldest entry whose end is past it; the lookup walks back
+ * from the newest entry, which for a frame about to go out is a handful of
+ * steps.
+ */
+
+#include "iq_framer.h"
+#include "iq_events.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+#define FRAME_HEADER_BYTES  16
+
+struct iq_framer {
+    uint32_t latency_us;
+    uint32_t sample_rate;
+    uint32_t pair_bytes;
+    uint32_t cap_samples;               /* Frame size limit from the budget */
+    uint32_t frame_samples;
+
+    /* Arrival ring - written by the SDR callback thread */
+    atomic_uint_least64_t arrival_end[IQ_FRAMER_ARRIVALS];
+    atomic_uint_least64_t arrival_us[IQ_FRAMER_ARRIVALS];
+    atomic_uint_least64_t arrivals;     /* Entries ever written */
+
+    /* Current statistics window */
+    uint64_t w_start_us;
+    uint64_t w_frames;
+    uint64_t w_sends;
+    uint64_t w_bytes;
+    uint64_t w_syscalls;
+    uint64_t w_latency_sum_us;
+    uint64_t w_latency_max_us;
+
+    iq_framer_stats_t stats;
+};
+
+static uint32_t budget_cap(const iq_framer_t *f) {
+    uint64_t cap = (uint64_t)f->sample_rate * f->latency_us / 2 / 1000000;
+    if (cap > IQ_FRAMER_MAX_SAMPLES) cap = IQ_FRAMER_MAX_SAMPLES;
+    if (cap < IQ_FRAMER_MIN_SAMPLES) cap = IQ_FRAMER_MIN_SAMPLES;
+    return (uint32_t)cap;
+}
+
+/* Bytes of the largest frame the current rate allows, markers included */
+static size_t max_frame_bytes(const iq_framer_t *f) {
+    return FRAME_HEADER_BYTES + IQ_MAX_FRAME_EVENTS * sizeof(iq_event_t) +
+           (size_t)f->cap_samples * f->pair_bytes;
+}
+
+/*============================================================================
+ * Lifecycle
+ *============================================================================*/
+
+iq_framer_t *iq_framer_create(uint32_t latency_ms) {
+    iq_framer_t *f = (iq_framer_t *)calloc(1, sizeof(*f));
+    if (!f) return NULL;
+    f->latency_us = (latency_ms > 0 ? latency_ms : IQ_FRAMER_DEFAULT_LATENCY_MS) * 1000u;
+    f->sample_rate = 2000000;
+    f->pair_bytes = 4;
+    atomic_init(&f->arrivals, 0);
+    for (int k = 0; k < IQ_FRAMER_ARRIVALS; k++) {
+        atomic_init(&f->arrival_end[k], 0);
+        atomic_init(&f->arrival_us[k], 0);
+    }
+    iq_framer_reset(f);
+    return f;
+}
+
+void iq_framer_destroy(iq_framer_t *f) {
+    free(f);
+}
+
+void iq_framer_reset(iq_framer_t *f) {
+    f->cap_samples = budget_cap(f);
+    f->frame_samples = f->cap_samples;
+    f->w_start_us = 0;
+    f->w_frames = f->w_sends = f->w_bytes = f->w_syscalls = 0;
+    f->w_latency_sum_us = f->w_latency_max_us = 0;
+    memset(&f->stats, 0, sizeof(f->stats));
+    f->stats.frame_samples = f->frame_samples;
+}
+
+void iq_framer_set_rate(iq_framer_t *f, uint32_t sample_rate, uint32_t pair_bytes) {
+    if (sample_rate == 0 || pair_bytes == 0) return;
+    f->sample_rate = sample_rate;
+    f->pair_bytes = pair_bytes;
+    f->cap_samples = budget_cap(f);
+    if (f->frame_samples > f->cap_samples) f->frame_samples = f->cap_samples;
+}
+
+uint32_t iq_framer_latency_ms(const iq_framer_t *f) {
+    return f->latency_us / 1000u;
+}
+
+uint32_t iq_framer_frame_samples(const iq_framer_t *f) {
+    return f->frame_samples;
+}
+
+/*============================================================================
+ * Arrival Times
+ *============================================================================*/
+
+void iq_framer_arrived(iq_framer_t *f, uint64_t end, uint64_t now_us) {
+    uint64_t n = atomic_load_explicit(&f->arrivals, memory_order_relaxed);
+    int slot = (int)(n % IQ_FRAMER_ARRIVALS);
+    atomic_store_explicit(&f->arrival_end[slot], end, memory_order_relaxed);
+    atomic_store_explicit(&f->arrival_us[slot], now_us, memory_order_relaxed);
+    atomic_store_explicit(&f->arrivals, n + 1, memory_order_release);
+}
+
+uint64_t iq_framer_arrival_us(const iq_framer_t *f, uint64_t pos) {
+    uint64_t n = atomic_load_explicit(&f->arrivals, memory_order_acquire);
+    uint64_t kept = n < IQ_FRAMER_ARRIVALS ? n : IQ_FRAMER_ARRIVALS;
+    uint64_t found = 0;
+
+    for (uint64_t k = 1; k <= kept; k++) {
+        int slot = (int)((n - k) % IQ_FRAMER_ARRIVALS);
+        uint64_t end = atomic_load_explicit(&f->arrival_end[slot], memory_order_relaxed);
+        if (end <= pos) break;
+        found = atomic_load_explicit(&f->arrival_us[slot], memory_order_relaxed);
+    }
+    return found;
+}
+
+/*============================================================================
+ * Framing
+ *============================================================================*/
+
+uint32_t iq_framer_take(const iq_framer_t *f, uint64_t first, size_t available, uint64_t now_us) {
+    if (available == 0) return 0;
+    if (available >= f->frame_samples) return f->frame_samples;
+
+    uint64_t arrived = iq_framer_arrival_us(f, first);
+    if (arrived != 0 && now_us < arrived + f->latency_us / 2) return 0;
+    return (uint32_t)available;
+}
+
+bool iq_framer_should_send(const iq_framer_t *f, size_t batch_bytes, bool writable) {
+    if (batch_bytes == 0) return false;
+    return writable || batch_bytes + max_frame_bytes(f) > IQ_FRAMER_BATCH_BYTES;
+}
+
+bool iq_framer_sent(iq_framer_t *f, uint32_t frames, size_t bytes, uint32_t syscalls,
+                    bool backed_up, uint64_t first, uint64_t now_us) {
+    uint64_t arrived = iq_framer_arrival_us(f, first);
+    uint64_t latency = (arrived != 0 && now_us > arrived) ? now_us - arrived : 0;
+    bool late = latency > f->latency_us;
+
+    /* A backed-up socket wants fewer, larger writes - smaller frames would
+     * not make it drain sooner, so that wins over a late frame */
+    if (backed_up || (!late && latency < f->latency_us / 4)) {
+        f->frame_samples *= 2;
+        if (f->frame_samples > f->cap_samples) f->frame_samples = f->cap_samples;
+    } else if (late) {
+        f->frame_samples /= 2;
+        if (f->frame_samples < IQ_FRAMER_MIN_SAMPLES) f->frame_samples = IQ_FRAMER_MIN_SAMPLES;
+    }
+
+    f->stats.frames += frames;
+    f->stats.sends++;
+    f->stats.bytes += bytes;
+    if (late) f->stats.late_sends++;
+    f->stats.frame_samples = f->frame_samples;
+
+    if (f->w_start_us == 0) f->w_start_us = now_us;
+    f->w_frames += frames;
+    f->w_sends++;
+    f->w_bytes += bytes;
+    f->w_syscalls += syscalls;
+    f->w_latency_sum_us += latency;
+    if (latency > f->w_latency_max_us) f->w_latency_max_us = latency;
+
+    uint64_t span = now_us - f->w_start_us;
+    if (span < IQ_FRAMER_WINDOW_US) return false;
+
+    double sec = (double)span / 1e6;
+    double mb = (double)f->w_bytes / 1e6;
+    f->stats.frames_per_sec = (double)f->w_frames / sec;
+    f->stats.sends_per_sec = (double)f->w_sends / sec;
+    f->stats.frames_per_send = (double)f->w_frames / (double)f->w_sends;
+    f->stats.mbytes_per_sec = mb / sec;
+    f->stats.syscalls_per_mb = mb > 0.0 ? (double)f->w_syscalls / mb : 0.0;
+    f->stats.latency_avg_ms = (double)f->w_latency_sum_us / (double)f->w_sends / 1000.0;
+    f->stats.latency_max_ms = (double)f->w_latency_max_us / 1000.0;
+
+    f->w_start_us = now_us;
+    f->w_frames = f->w_sends = f->w_bytes = f->w_syscalls = 0;
+    f->w_latency_sum_us = f->w_latency_max_us = 0;
+    return true;
+}
+
+/*============================================================================
+ * Socket Sizing
+ *============================================================================*/
+
+size_t iq_framer_sndbuf(const iq_framer_t *f, uint32_t rtt_us) {
+    double rate = (double)f->sample_rate * f->pair_bytes;
+    if (f->stats.mbytes_per_sec * 1e6 > rate) rate = f->stats.mbytes_per_sec * 1e6;
+    double rtt = (double)(rtt_us ? rtt_us : IQ_FRAMER_DEFAULT_RTT_US) / 1e6;
+
+    double size = 2.0 * rate * rtt + IQ_FRAMER_BATCH_BYTES;
+    if (size < IQ_FRAMER_SNDBUF_MIN) size = IQ_FRAMER_SNDBUF_MIN;
+    if (size > IQ_FRAMER_SNDBUF_MAX) size = IQ_FRAMER_SNDBUF_MAX;
+    return (size_t)size;
+}
+
+size_t iq_framer_notsent_lowat(const iq_framer_t *f) {
+    return 2 * max_frame_bytes(f);
+}
+
+void iq_framer_get_stats(const iq_framer_t *f, iq_framer_stats_t *stats) {
+    *stats = f->stats;
+}
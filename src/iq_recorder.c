@@ -4,15 +4,25 @@
  */
 
 #include "iq_recorder.h"
+#include "crc32c.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <math.h>
 
 #ifdef _WIN32
 #include <Windows.h>
+#include <io.h>
+#define file_seek   _fseeki64
+#define file_tell   _ftelli64
+#define file_truncate(f, size)  _chsize_s(_fileno(f), (size))
 #else
 #include <sys/time.h>
+#include <unistd.h>
+#define file_seek   fseeko
+#define file_tell   ftello
+#define file_truncate(f, size)  ftruncate(fileno(f), (off_t)(size))
 #endif
 
 /*============================================================================
@@ -20,6 +30,10 @@
  *============================================================================*/
 
 #define DEFAULT_BUFFER_SAMPLES  (64 * 1024)  /* 64K sample pairs */
+#define TIMING_INITIAL_ENTRIES  1024         /* ~17 min at one entry per second */
+#define CRC_INITIAL_BLOCKS      1024
+#define VERIFY_BUFFER_BYTES     (4 * 1024 * 1024)
+#define MAX_TRAILER_CHUNKS      8
 
 /*============================================================================
  * Internal Structures
@@ -27,18 +41,30 @@
 
 struct iqr_recorder {
     FILE           *file;
+    char           *filename;       /* For reopening after a failed trailer */
     iqr_header_t    header;
     int16_t        *buffer;         /* Interleaved I/Q buffer */
     size_t          buffer_size;    /* Buffer capacity (sample pairs) */
     size_t          buffer_used;    /* Samples in buffer */
     uint64_t        total_samples;
     bool            recording;
+    iqr_timing_entry_t *timing;     /* Timing track, written on stop */
+    size_t          timing_count;
+    size_t          timing_capacity;
+    uint32_t        crc_block;      /* Pairs per CRC block, 0 = off */
+    uint32_t        crc_fill;       /* Pairs in the current block */
+    uint32_t        crc_running;    /* CRC of the current block so far */
+    uint32_t       *crcs;           /* Finished blocks, written on stop */
+    size_t          crc_count;
+    size_t          crc_capacity;
 };
 
 struct iqr_reader {
     FILE           *file;
     iqr_header_t    header;
     uint64_t        position;       /* Current sample position */
+    iqr_timing_entry_t *timing;     /* Timing track, NULL if none */
+    size_t          timing_count;
 };
 
 /*============================================================================
@@ -85,6 +111,37 @@ static int64_t get_timestamp_us(void) {
 #endif
 }
 
+static iqr_error_t finish_crc_block(iqr_recorder_t *rec) {
+    if (rec->crc_count == rec->crc_capacity) {
+        size_t cap = rec->crc_capacity ? rec->crc_capacity * 2 : CRC_INITIAL_BLOCKS;
+        uint32_t *c = realloc(rec->crcs, cap * sizeof(uint32_t));
+        if (!c) return IQR_ERR_ALLOC;
+        rec->crcs = c;
+        rec->crc_capacity = cap;
+    }
+    rec->crcs[rec->crc_count++] = rec->crc_running;
+    rec->crc_running = 0;
+    rec->crc_fill = 0;
+    return IQR_OK;
+}
+
+/* CRC the flushed pairs, closing a block at every crc_block boundary */
+static iqr_error_t update_crcs(iqr_recorder_t *rec, const int16_t *pairs, size_t count) {
+    while (count > 0) {
+        size_t n = rec->crc_block - rec->crc_fill;
+        if (n > count) n = count;
+        rec->crc_running = crc32c(rec->crc_running, pairs, n * 2 * sizeof(int16_t));
+        rec->crc_fill += (uint32_t)n;
+        pairs += n * 2;
+        count -= n;
+        if (rec->crc_fill == rec->crc_block) {
+            iqr_error_t err = finish_crc_block(rec);
+            if (err != IQR_OK) return err;
+        }
+    }
+    return IQR_OK;
+}
+
 static iqr_error_t flush_buffer(iqr_recorder_t *rec) {
     if (!rec->buffer_used) return IQR_OK;
     
@@ -95,12 +152,72 @@ static iqr_error_t flush_buffer(iqr_recorder_t *rec) {
         return IQR_ERR_FILE_WRITE;
     }
     
+    if (rec->crc_block) {
+        iqr_error_t err = update_crcs(rec, rec->buffer, rec->buffer_used);
+        if (err != IQR_OK) return err;
+    }
+    
     rec->total_samples += rec->buffer_used;
     rec->buffer_used = 0;
     
     return IQR_OK;
 }
 
+static int64_t data_offset(uint64_t sample) {
+    return IQR_HEADER_SIZE + (int64_t)(sample * 2 * sizeof(int16_t));
+}
+
+/* One trailer chunk at the current position */
+static iqr_error_t write_chunk(FILE *f, const char *magic, const void *entries,
+                               uint32_t entry_size, size_t count) {
+    iqr_chunk_t chunk;
+    memcpy(chunk.magic, magic, 4);
+    chunk.entry_size = entry_size;
+    chunk.entry_count = count;
+    
+    if (fwrite(&chunk, sizeof(chunk), 1, f) != 1 ||
+        fwrite(entries, entry_size, count, f) != count) {
+        return IQR_ERR_FILE_WRITE;
+    }
+    return IQR_OK;
+}
+
+/*
+ * Find a trailer chunk and load its entries (caller frees). Returns NULL
+ * if it is missing, damaged or of an unexpected entry size.
+ */
+static void *load_chunk(FILE *f, const iqr_header_t *h, const char *magic,
+                        uint32_t entry_size, size_t *count) {
+    int64_t pos = data_offset(h->sample_count);
+    
+    for (int k = 0; k < MAX_TRAILER_CHUNKS; k++) {
+        iqr_chunk_t chunk;
+        if (file_seek(f, pos, SEEK_SET) != 0 || fread(&chunk, sizeof(chunk), 1, f) != 1 ||
+            chunk.entry_size == 0 || chunk.entry_count > (uint64_t)INT64_MAX / chunk.entry_size) {
+            return NULL;
+        }
+        
+        if (memcmp(chunk.magic, magic, 4) == 0) {
+            if (chunk.entry_size != entry_size || chunk.entry_count == 0 ||
+                chunk.entry_count > SIZE_MAX / entry_size) {
+                return NULL;
+            }
+            void *entries = malloc((size_t)chunk.entry_count * entry_size);
+            if (!entries) return NULL;
+            if (fread(entries, entry_size, (size_t)chunk.entry_count, f) != chunk.entry_count) {
+                free(entries);
+                return NULL;
+            }
+            *count = (size_t)chunk.entry_count;
+            return entries;
+        }
+        
+        /* Someone else's chunk: skip it */
+        pos += (int64_t)sizeof(chunk) + (int64_t)(chunk.entry_count * chunk.entry_size);
+    }
+    return NULL;
+}
+
 /*============================================================================
  * Recorder Implementation
  *============================================================================*/
@@ -132,6 +249,9 @@ void iqr_destroy(iqr_recorder_t *rec) {
     }
     
     free(rec->buffer);
+    free(rec->timing);
+    free(rec->crcs);
+    free(rec->filename);
     free(rec);
 }
 
@@ -148,6 +268,12 @@ iqr_error_t iqr_start(
     if (rec->recording) return IQR_ERR_ALREADY_RECORDING;
     
     /* Open file */
+    size_t name_len = strlen(filename) + 1;
+    char *name = realloc(rec->filename, name_len);
+    if (!name) return IQR_ERR_ALLOC;
+    memcpy(name, filename, name_len);
+    rec->filename = name;
+    
     rec->file = fopen(filename, "wb");
     if (!rec->file) {
         return IQR_ERR_FILE_OPEN;
@@ -165,6 +291,7 @@ iqr_error_t iqr_start(
     rec->header.start_time_us = get_timestamp_us();
     rec->header.sample_count = 0;
     rec->header.flags = 0;
+    rec->header.crc_block_samples = rec->crc_block;
     
     /* Write initial header (will update sample_count on close) */
     if (fwrite(&rec->header, sizeof(rec->header), 1, rec->file) != 1) {
@@ -175,6 +302,10 @@ iqr_error_t iqr_start(
     
     rec->buffer_used = 0;
     rec->total_samples = 0;
+    rec->timing_count = 0;
+    rec->crc_count = 0;
+    rec->crc_fill = 0;
+    rec->crc_running = 0;
     rec->recording = true;
     
     printf("iqr_start: Recording to %s\n", filename);
@@ -222,12 +353,52 @@ iqr_error_t iqr_write(
     return IQR_OK;
 }
 
+/* Trailer chunks right after the last sample, flushed so a full disk shows here */
+static iqr_error_t write_trailer(iqr_recorder_t *rec) {
+    iqr_error_t err = IQR_OK;
+    if (rec->crc_block && rec->crc_fill > 0) {
+        err = finish_crc_block(rec);
+    }
+    if (err == IQR_OK && rec->timing_count > 0) {
+        err = write_chunk(rec->file, IQR_TIMING_MAGIC, rec->timing,
+                          sizeof(iqr_timing_entry_t), rec->timing_count);
+        rec->header.flags |= IQR_FLAG_TIMING_TRACK;
+    }
+    if (err == IQR_OK && rec->crc_count > 0) {
+        err = write_chunk(rec->file, IQR_CRC_MAGIC, rec->crcs, sizeof(uint32_t), rec->crc_count);
+        rec->header.flags |= IQR_FLAG_CRC32C;
+    }
+    if (err == IQR_OK && fflush(rec->file) != 0) {
+        err = IQR_ERR_FILE_WRITE;
+    }
+    return err;
+}
+
+/*
+ * Give up a trailer that failed part-way. The samples are already on
+ * disk; the file is reopened so nothing still buffered for the trailer
+ * lands after the cut, and cut back to the last sample.
+ */
+static iqr_error_t drop_trailer(iqr_recorder_t *rec) {
+    rec->header.flags &= ~(uint32_t)(IQR_FLAG_TIMING_TRACK | IQR_FLAG_CRC32C);
+    fclose(rec->file);
+    rec->file = fopen(rec->filename, "r+b");
+    if (!rec->file) return IQR_ERR_FILE_OPEN;
+    
+    /* Best effort: with the flags clear, readers stop at sample_count anyway */
+    (void)file_truncate(rec->file, data_offset(rec->total_samples));
+    return IQR_OK;
+}
+
 iqr_error_t iqr_stop(iqr_recorder_t *rec) {
     if (!rec) return IQR_ERR_INVALID_ARG;
     if (!rec->recording) return IQR_ERR_NOT_RECORDING;
     
     /* Flush remaining samples */
     iqr_error_t err = flush_buffer(rec);
+    if (err == IQR_OK && fflush(rec->file) != 0) {
+        err = IQR_ERR_FILE_WRITE;
+    }
     if (err != IQR_OK) {
         fclose(rec->file);
         rec->file = NULL;
@@ -235,6 +406,16 @@ iqr_error_t iqr_stop(iqr_recorder_t *rec) {
         return err;
     }
     
+    /* The trailer is optional: losing it must not lose the samples */
+    iqr_error_t trailer_err = write_trailer(rec);
+    if (trailer_err != IQR_OK) {
+        err = drop_trailer(rec);
+        if (err != IQR_OK) {
+            rec->recording = false;
+            return err;
+        }
+    }
+    
     /* Update header with final sample count */
     rec->header.sample_count = rec->total_samples;
     
@@ -252,14 +433,19 @@ iqr_error_t iqr_stop(iqr_recorder_t *rec) {
         return IQR_ERR_FILE_WRITE;
     }
     
-    fclose(rec->file);
+    int closed = fclose(rec->file);
     rec->file = NULL;
     rec->recording = false;
+    if (closed != 0) return IQR_ERR_FILE_WRITE;
+    if (trailer_err != IQR_OK) return trailer_err;
     
     double duration = (double)rec->total_samples / rec->header.sample_rate_hz;
     printf("iqr_stop: Recording complete\n");
     printf("  Samples: %llu\n", (unsigned long long)rec->total_samples);
     printf("  Duration: %.2f seconds\n", duration);
+    if (rec->timing_count > 0) {
+        printf("  Timing entries: %zu\n", rec->timing_count);
+    }
     
     return IQR_OK;
 }
@@ -278,6 +464,36 @@ double iqr_get_duration(const iqr_recorder_t *rec) {
     return (double)iqr_get_sample_count(rec) / rec->header.sample_rate_hz;
 }
 
+iqr_error_t iqr_set_crc_block(iqr_recorder_t *rec, uint32_t block_samples) {
+    if (!rec) return IQR_ERR_INVALID_ARG;
+    if (rec->recording) return IQR_ERR_ALREADY_RECORDING;
+    rec->crc_block = block_samples;
+    return IQR_OK;
+}
+
+iqr_error_t iqr_add_timing(iqr_recorder_t *rec, const iqr_timing_entry_t *entry) {
+    if (!rec || !entry) return IQR_ERR_INVALID_ARG;
+    if (!rec->recording) return IQR_ERR_NOT_RECORDING;
+    
+    if (rec->timing_count > 0) {
+        const iqr_timing_entry_t *last = &rec->timing[rec->timing_count - 1];
+        if (entry->sample_index <= last->sample_index || entry->utc_us <= last->utc_us) {
+            return IQR_ERR_INVALID_ARG;
+        }
+    }
+    
+    if (rec->timing_count == rec->timing_capacity) {
+        size_t cap = rec->timing_capacity ? rec->timing_capacity * 2 : TIMING_INITIAL_ENTRIES;
+        iqr_timing_entry_t *t = realloc(rec->timing, cap * sizeof(iqr_timing_entry_t));
+        if (!t) return IQR_ERR_ALLOC;
+        rec->timing = t;
+        rec->timing_capacity = cap;
+    }
+    
+    rec->timing[rec->timing_count++] = *entry;
+    return IQR_OK;
+}
+
 /*============================================================================
  * Reader Implementation
  *============================================================================*/
@@ -315,6 +531,19 @@ iqr_error_t iqr_open(iqr_reader_t **reader, const char *filename) {
         return IQR_ERR_VERSION_MISMATCH;
     }
     
+    /* Timing track, if any; a missing or damaged one is left empty */
+    if (r->header.flags & IQR_FLAG_TIMING_TRACK) {
+        r->timing = load_chunk(r->file, &r->header, IQR_TIMING_MAGIC,
+                               sizeof(iqr_timing_entry_t), &r->timing_count);
+        if (!r->timing) r->timing_count = 0;
+    }
+    if (file_seek(r->file, IQR_HEADER_SIZE, SEEK_SET) != 0) {
+        fclose(r->file);
+        free(r->timing);
+        free(r);
+        return IQR_ERR_FILE_SEEK;
+    }
+    
     r->position = 0;
     *reader = r;
     
@@ -324,6 +553,9 @@ iqr_error_t iqr_open(iqr_reader_t **reader, const char *filename) {
     printf("  Samples: %llu\n", (unsigned long long)r->header.sample_count);
     printf("  Duration: %.2f seconds\n", 
            (double)r->header.sample_count / r->header.sample_rate_hz);
+    if (r->timing_count > 0) {
+        printf("  Timing entries: %zu\n", r->timing_count);
+    }
     
     return IQR_OK;
 }
@@ -334,6 +566,7 @@ void iqr_close(iqr_reader_t *reader) {
     if (reader->file) {
         fclose(reader->file);
     }
+    free(reader->timing);
     free(reader);
 }
 
@@ -395,10 +628,8 @@ iqr_error_t iqr_seek(iqr_reader_t *reader, uint64_t sample) {
         sample = reader->header.sample_count;
     }
     
-    /* Calculate file position: header + (sample * 4 bytes per sample pair) */
-    long offset = IQR_HEADER_SIZE + (long)(sample * 2 * sizeof(int16_t));
-    
-    if (fseek(reader->file, offset, SEEK_SET) != 0) {
+    /* File position: header + (sample * 4 bytes per sample pair) */
+    if (file_seek(reader->file, data_offset(sample), SEEK_SET) != 0) {
         return IQR_ERR_FILE_SEEK;
     }
     
@@ -409,3 +640,202 @@ iqr_error_t iqr_seek(iqr_reader_t *reader, uint64_t sample) {
 iqr_error_t iqr_rewind(iqr_reader_t *reader) {
     return iqr_seek(reader, 0);
 }
+
+const iqr_timing_entry_t* iqr_get_timing(const iqr_reader_t *reader, size_t *count) {
+    if (count) *count = reader ? reader->timing_count : 0;
+    return reader ? reader->timing : NULL;
+}
+
+iqr_error_t iqr_sample_at_utc(const iqr_reader_t *reader, int64_t utc_us, uint64_t *sample) {
+    if (!reader || !sample) return IQR_ERR_INVALID_ARG;
+    
+    const iqr_timing_entry_t *t = reader->timing;
+    size_t n = reader->timing_count;
+    double rate = reader->header.sample_rate_hz;
+    double base_sample, pos;
+    
+    if (n == 0) {
+        /* No track: header start time and nominal rate */
+        base_sample = 0.0;
+        pos = (double)(utc_us - reader->header.start_time_us) * rate / 1e6;
+    } else {
+        /* First entry with utc_us > target */
+        size_t lo = 0, hi = n;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (t[mid].utc_us <= utc_us) lo = mid + 1;
+            else hi = mid;
+        }
+        
+        if (lo == 0 || lo == n) {
+            /* Outside the track: nominal rate from the nearest entry */
+            const iqr_timing_entry_t *e = (lo == 0) ? &t[0] : &t[n - 1];
+            base_sample = (double)e->sample_index;
+            pos = (double)(utc_us - e->utc_us) * rate / 1e6;
+        } else {
+            /* Between two entries: the rate they actually measured */
+            const iqr_timing_entry_t *a = &t[lo - 1];
+            const iqr_timing_entry_t *b = &t[lo];
+            base_sample = (double)a->sample_index;
+            pos = (double)(utc_us - a->utc_us) * (double)(b->sample_index - a->sample_index) /
+                  (double)(b->utc_us - a->utc_us);
+        }
+    }
+    
+    double s = round(base_sample + pos);
+    if (s < 0.0) s = 0.0;
+    if (s > (double)reader->header.sample_count) s = (double)reader->header.sample_count;
+    *sample = (uint64_t)s;
+    return IQR_OK;
+}
+
+iqr_error_t iqr_seek_utc(iqr_reader_t *reader, int64_t utc_us) {
+    uint64_t sample;
+    iqr_error_t err = iqr_sample_at_utc(reader, utc_us, &sample);
+    if (err != IQR_OK) return err;
+    return iqr_seek(reader, sample);
+}
+
+/*============================================================================
+ * Integrity Check
+ *============================================================================*/
+
+typedef struct {
+    iqr_damage_fn fn;
+    void *user;
+    uint64_t first, end;        /* Pending range, end == 0 if none */
+} damage_run_t;
+
+static void damage_add(damage_run_t *d, uint64_t first, uint64_t end) {
+    if (d->end != 0 && first == d->end) {
+        d->end = end;
+        return;
+    }
+    if (d->end != 0 && d->fn) d->fn(d->first, d->end, d->user);
+    d->first = first;
+    d->end = end;
+}
+
+static void damage_flush(damage_run_t *d) {
+    if (d->end != 0 && d->fn) d->fn(d->first, d->end, d->user);
+    d->end = 0;
+}
+
+iqr_error_t iqr_verify(const char *filename, void *buffer, size_t buffer_size,
+                       iqr_damage_fn on_damage, void *user, iqr_verify_result_t *result) {
+    if (!filename || !result) return IQR_ERR_INVALID_ARG;
+    memset(result, 0, sizeof(*result));
+    
+    FILE *f = fopen(filename, "rb");
+    if (!f) return IQR_ERR_FILE_OPEN;
+    
+    iqr_header_t h;
+    if (fread(&h, sizeof(h), 1, f) != 1) {
+        fclose(f);
+        return IQR_ERR_FILE_READ;
+    }
+    if (memcmp(h.magic, IQR_MAGIC, 4) != 0) {
+        fclose(f);
+        return IQR_ERR_INVALID_FORMAT;
+    }
+    if (h.version != IQR_VERSION) {
+        fclose(f);
+        return IQR_ERR_VERSION_MISMATCH;
+    }
+    
+    int64_t size;
+    if (file_seek(f, 0, SEEK_END) != 0 || (size = file_tell(f)) < 0) {
+        fclose(f);
+        return IQR_ERR_FILE_SEEK;
+    }
+    uint64_t present = (uint64_t)(size - IQR_HEADER_SIZE) / (2 * sizeof(int16_t));
+    result->sample_rate_hz = h.sample_rate_hz;
+    result->sample_count = h.sample_count;
+    result->samples_present = present < h.sample_count ? present : h.sample_count;
+    
+    damage_run_t run = { on_damage, user, 0, 0 };
+    
+    /* Block CRCs; truncation takes them with it */
+    uint32_t *crcs = NULL;
+    size_t crc_count = 0;
+    if ((h.flags & IQR_FLAG_CRC32C) && h.crc_block_samples > 0 &&
+        result->samples_present == h.sample_count) {
+        crcs = load_chunk(f, &h, IQR_CRC_MAGIC, sizeof(uint32_t), &crc_count);
+        uint64_t expect = (h.sample_count + h.crc_block_samples - 1) / h.crc_block_samples;
+        if (crcs && crc_count != expect) {
+            free(crcs);
+            fclose(f);
+            return IQR_ERR_INVALID_FORMAT;
+        }
+    }
+    
+    if (!crcs) {
+        if (result->samples_present < h.sample_count) {
+            damage_add(&run, result->samples_present, h.sample_count);
+            damage_flush(&run);
+        }
+        fclose(f);
+        return IQR_OK;
+    }
+    result->block_samples = h.crc_block_samples;
+    
+    uint8_t *own = NULL;
+    if (!buffer || buffer_size < 2 * sizeof(int16_t)) {
+        own = malloc(VERIFY_BUFFER_BYTES);
+        if (!own) {
+            free(crcs);
+            fclose(f);
+            return IQR_ERR_ALLOC;
+        }
+        buffer = own;
+        buffer_size = VERIFY_BUFFER_BYTES;
+    }
+    size_t buffer_pairs = buffer_size / (2 * sizeof(int16_t));
+    
+    iqr_error_t err = IQR_OK;
+    if (file_seek(f, IQR_HEADER_SIZE, SEEK_SET) != 0) err = IQR_ERR_FILE_SEEK;
+    
+    uint64_t pos = 0;
+    uint64_t block = 0;
+    uint64_t block_end = h.crc_block_samples < h.sample_count ? h.crc_block_samples : h.sample_count;
+    uint32_t crc = 0;
+    
+    while (err == IQR_OK && pos < h.sample_count) {
+        uint64_t want = h.sample_count - pos;
+        size_t n = (want < buffer_pairs) ? (size_t)want : buffer_pairs;
+        if (fread(buffer, 2 * sizeof(int16_t), n, f) != n) {
+            err = IQR_ERR_FILE_READ;
+            break;
+        }
+        
+        /* Feed the read to the blocks it covers */
+        const uint8_t *p = buffer;
+        size_t left = n;
+        while (left > 0) {
+            size_t take = (size_t)(block_end - pos);
+            if (take > left) take = left;
+            crc = crc32c(crc, p, take * 2 * sizeof(int16_t));
+            p += take * 2 * sizeof(int16_t);
+            left -= take;
+            pos += take;
+            
+            if (pos == block_end) {
+                result->blocks_checked++;
+                if (crc != crcs[block]) {
+                    result->blocks_bad++;
+                    damage_add(&run, block * h.crc_block_samples, block_end);
+                }
+                block++;
+                crc = 0;
+                block_end += h.crc_block_samples;
+                if (block_end > h.sample_count) block_end = h.sample_count;
+            }
+        }
+    }
+    damage_flush(&run);
+    
+    free(own);
+    free(crcs);
+    fclose(f);
+    return err;
+}
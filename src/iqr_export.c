@@ -0,0 +1,561 @@
+/**
+ * @file iqr_export.c
+ * @brief IQR interchange formats - WAV/RF64, SigMF, raw cf32/cs16
+ *
+ * WAV reference: EBU Tech 3306 (RF64), Microsoft WAVEFORMATEX.
+ * SigMF reference: SigMF specification v1.0.0 (core namespace).
+ * All multi-byte container fields are little-endian.
+ */
+
+#include "iqr_export.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IQR_EXPORT_USE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define IQR_EXPORT_USE_NEON 1
+#endif
+
+#define WAVE_FORMAT_PCM         0x0001
+#define WAVE_FORMAT_IEEE_FLOAT  0x0003
+#define WAVE_FORMAT_EXTENSIBLE  0xFFFE
+
+#define US_PER_SEC              1000000LL
+#define US_PER_DAY              (86400LL * US_PER_SEC)
+
+/*============================================================================
+ * Helpers
+ *============================================================================*/
+
+static void put_le16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_le64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint16_t get_le16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t get_le64(const uint8_t *p) {
+    return (uint64_t)get_le32(p) | ((uint64_t)get_le32(p + 4) << 32);
+}
+
+static bool ends_with(const char *s, const char *suffix) {
+    size_t n = strlen(s), m = strlen(suffix);
+    if (m > n) return false;
+    for (size_t i = 0; i < m; i++) {
+        if (tolower((unsigned char)s[n - m + i]) != suffix[i]) return false;
+    }
+    return true;
+}
+
+/* Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant) */
+static int64_t days_from_civil(int y, int m, int d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static void civil_from_days(int64_t z, int *y, int *m, int *d) {
+    z += 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    *d = (int)(doy - (153 * mp + 2) / 5 + 1);
+    *m = (int)(mp < 10 ? mp + 3 : mp - 9);
+    *y = (int)(yoe + era * 400 + (*m <= 2));
+}
+
+static int64_t floor_div(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+/*============================================================================
+ * Formats
+ *============================================================================*/
+
+static const struct {
+    iqr_format_t fmt;
+    const char *name;
+} g_format_names[] = {
+    { IQR_FMT_IQR,   "iqr"   },
+    { IQR_FMT_WAV,   "wav"   },
+    { IQR_FMT_SIGMF, "sigmf" },
+    { IQR_FMT_CF32,  "cf32"  },
+    { IQR_FMT_CS16,  "cs16"  },
+};
+
+iqr_format_t iqr_format_from_name(const char *name) {
+    if (!name) return IQR_FMT_UNKNOWN;
+    for (size_t i = 0; i < sizeof(g_format_names) / sizeof(g_format_names[0]); i++) {
+        const char *a = name, *b = g_format_names[i].name;
+        while (*a && tolower((unsigned char)*a) == *b) { a++; b++; }
+        if (*a == '\0' && *b == '\0') return g_format_names[i].fmt;
+    }
+    return IQR_FMT_UNKNOWN;
+}
+
+iqr_format_t iqr_format_from_path(const char *path) {
+    if (!path) return IQR_FMT_UNKNOWN;
+    if (ends_with(path, ".iqr")) return IQR_FMT_IQR;
+    if (ends_with(path, ".wav")) return IQR_FMT_WAV;
+    if (ends_with(path, ".sigmf-data") || ends_with(path, ".sigmf-meta") ||
+        ends_with(path, ".sigmf")) return IQR_FMT_SIGMF;
+    if (ends_with(path, ".cf32") || ends_with(path, ".fc32")) return IQR_FMT_CF32;
+    if (ends_with(path, ".cs16") || ends_with(path, ".sc16")) return IQR_FMT_CS16;
+    return IQR_FMT_UNKNOWN;
+}
+
+const char *iqr_format_name(iqr_format_t fmt) {
+    for (size_t i = 0; i < sizeof(g_format_names) / sizeof(g_format_names[0]); i++) {
+        if (g_format_names[i].fmt == fmt) return g_format_names[i].name;
+    }
+    return "unknown";
+}
+
+/*============================================================================
+ * Sample Conversion
+ *============================================================================*/
+
+void iqr_convert_s16_f32_scalar(const int16_t *in, float *out, size_t count) {
+    const float scale = 1.0f / 32768.0f;
+    for (size_t n = 0; n < count; n++) {
+        out[n] = (float)in[n] * scale;
+    }
+}
+
+void iqr_convert_s16_f32(const int16_t *in, float *out, size_t count) {
+    size_t n = 0;
+
+#if defined(IQR_EXPORT_USE_SSE2)
+    const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+    for (; n + 8 <= count; n += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(in + n));
+        /* Sign-extend by placing each value in the high half, then shifting down */
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+        _mm_storeu_ps(out + n, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + n + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+#elif defined(IQR_EXPORT_USE_NEON)
+    const float32x4_t scale = vdupq_n_f32(1.0f / 32768.0f);
+    for (; n + 8 <= count; n += 8) {
+        int16x8_t x = vld1q_s16(in + n);
+        vst1q_f32(out + n, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(x))), scale));
+        vst1q_f32(out + n + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(x))), scale));
+    }
+#endif
+
+    iqr_convert_s16_f32_scalar(in + n, out + n, count - n);
+}
+
+void iqr_convert_f32_s16_scalar(const float *in, int16_t *out, size_t count) {
+    for (size_t n = 0; n < count; n++) {
+        float v = in[n] * 32768.0f;
+        if (v > 32767.0f) v = 32767.0f;
+        if (v < -32768.0f) v = -32768.0f;
+        out[n] = (int16_t)lrintf(v);
+    }
+}
+
+void iqr_convert_f32_s16(const float *in, int16_t *out, size_t count) {
+    size_t n = 0;
+
+#if defined(IQR_EXPORT_USE_SSE2)
+    /* Clamp in float first: cvtps maps out-of-range values to INT_MIN */
+    const __m128 scale = _mm_set1_ps(32768.0f);
+    const __m128 vmax = _mm_set1_ps(32767.0f);
+    const __m128 vmin = _mm_set1_ps(-32768.0f);
+    for (; n + 8 <= count; n += 8) {
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(in + n), scale);
+        __m128 b = _mm_mul_ps(_mm_loadu_ps(in + n + 4), scale);
+        a = _mm_max_ps(_mm_min_ps(a, vmax), vmin);
+        b = _mm_max_ps(_mm_min_ps(b, vmax), vmin);
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        _mm_storeu_si128((__m128i *)(out + n), packed);
+    }
+#elif defined(IQR_EXPORT_USE_NEON) && defined(__aarch64__)
+    const float32x4_t scale = vdupq_n_f32(32768.0f);
+    for (; n + 8 <= count; n += 8) {
+        int32x4_t a = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(in + n), scale));
+        int32x4_t b = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(in + n + 4), scale));
+        vst1q_s16(out + n, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+#endif
+
+    iqr_convert_f32_s16_scalar(in + n, out + n, count - n);
+}
+
+/*============================================================================
+ * WAV / RF64
+ *============================================================================*/
+
+void iqr_wav_build_header(uint8_t *buf, uint32_t sample_rate,
+                          iqr_sample_type_t type, uint64_t data_bytes) {
+    const uint16_t bits = (type == IQR_SAMPLE_CF32) ? 32 : 16;
+    const uint16_t block_align = (uint16_t)(2 * bits / 8);
+    const uint64_t riff_size = (IQR_WAV_HEADER_SIZE - 8) + data_bytes;
+    const bool rf64 = riff_size > 0xFFFFFFFFull;
+
+    memset(buf, 0, IQR_WAV_HEADER_SIZE);
+
+    memcpy(buf, rf64 ? "RF64" : "RIFF", 4);
+    put_le32(buf + 4, rf64 ? 0xFFFFFFFFu : (uint32_t)riff_size);
+    memcpy(buf + 8, "WAVE", 4);
+
+    /* ds64 when promoted, otherwise a JUNK placeholder of the same size */
+    memcpy(buf + 12, rf64 ? "ds64" : "JUNK", 4);
+    put_le32(buf + 16, 28);
+    if (rf64) {
+        put_le64(buf + 20, riff_size);
+        put_le64(buf + 28, data_bytes);
+        put_le64(buf + 36, data_bytes / block_align);
+        put_le32(buf + 44, 0);              /* No chunk size table */
+    }
+
+    memcpy(buf + 48, "fmt ", 4);
+    put_le32(buf + 52, 16);
+    put_le16(buf + 56, (type == IQR_SAMPLE_CF32) ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM);
+    put_le16(buf + 58, 2);
+    put_le32(buf + 60, sample_rate);
+    put_le32(buf + 64, sample_rate * block_align);
+    put_le16(buf + 68, block_align);
+    put_le16(buf + 70, bits);
+
+    memcpy(buf + 72, "data", 4);
+    put_le32(buf + 76, rf64 ? 0xFFFFFFFFu : (uint32_t)data_bytes);
+}
+
+bool iqr_wav_parse_header(const uint8_t *buf, size_t len, iqr_wav_info_t *info) {
+    if (!buf || !info || len < 12) return false;
+    memset(info, 0, sizeof(*info));
+
+    if (memcmp(buf + 8, "WAVE", 4) != 0) return false;
+    if (memcmp(buf, "RF64", 4) == 0) {
+        info->is_rf64 = true;
+    } else if (memcmp(buf, "RIFF", 4) != 0) {
+        return false;
+    }
+
+    uint64_t ds64_data = 0;
+    bool have_fmt = false;
+    size_t pos = 12;
+
+    while (pos + 8 <= len) {
+        const uint8_t *chunk = buf + pos;
+        uint32_t size = get_le32(chunk + 4);
+
+        if (memcmp(chunk, "ds64", 4) == 0 && size >= 24 && pos + 8 + 24 <= len) {
+            ds64_data = get_le64(chunk + 16);
+        } else if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16 && pos + 8 + 16 <= len) {
+            uint16_t tag = get_le16(chunk + 8);
+            uint16_t channels = get_le16(chunk + 10);
+            uint16_t bits = get_le16(chunk + 22);
+            if (tag == WAVE_FORMAT_EXTENSIBLE && size >= 40 && pos + 8 + 40 <= len) {
+                tag = get_le16(chunk + 32);     /* First two bytes of SubFormat GUID */
+            }
+            if (channels != 2) return false;
+            if (tag == WAVE_FORMAT_PCM && bits == 16) {
+                info->type = IQR_SAMPLE_CS16;
+            } else if (tag == WAVE_FORMAT_IEEE_FLOAT && bits == 32) {
+                info->type = IQR_SAMPLE_CF32;
+            } else {
+                return false;
+            }
+            info->sample_rate = get_le32(chunk + 12);
+            have_fmt = true;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!have_fmt) return false;
+            info->data_offset = pos + 8;
+            info->data_bytes = (info->is_rf64 && size == 0xFFFFFFFFu) ? ds64_data : size;
+            return true;
+        }
+
+        pos += 8 + (size_t)size + (size & 1);   /* Chunks are word-aligned */
+    }
+    return false;
+}
+
+/*============================================================================
+ * SigMF
+ *============================================================================*/
+
+/* JSON number without exponent for integral values (sample rates, frequencies) */
+static void json_number(char *buf, size_t size, double v) {
+    if (v == floor(v) && fabs(v) < 1e15) {
+        snprintf(buf, size, "%.0f", v);
+    } else {
+        snprintf(buf, size, "%.9g", v);
+    }
+}
+
+int iqr_sigmf_write_meta(FILE *f, const iqr_stream_info_t *info,
+                         const iqr_meta_t *meta, uint64_t source_offset) {
+    if (!f || !info) return -1;
+
+    char num[64], iso[40];
+    const char *time_source = meta ? (meta->gps_valid ? "GPS_PPS" : "system_clock") : NULL;
+
+    fprintf(f, "{\n");
+    fprintf(f, "    \"global\": {\n");
+    fprintf(f, "        \"core:datatype\": \"%s\",\n",
+            info->type == IQR_SAMPLE_CF32 ? "cf32_le" : "ci16_le");
+    json_number(num, sizeof(num), info->sample_rate_hz);
+    fprintf(f, "        \"core:sample_rate\": %s,\n", num);
+    fprintf(f, "        \"core:recorder\": \"phoenix_sdr\",\n");
+    if (time_source) {
+        fprintf(f, "        \"phoenix:time_source\": \"%s\",\n", time_source);
+    }
+    fprintf(f, "        \"core:version\": \"1.0.0\"\n");
+    fprintf(f, "    },\n");
+
+    fprintf(f, "    \"captures\": [\n");
+    fprintf(f, "        {\n");
+    fprintf(f, "            \"core:sample_start\": 0,\n");
+    if (info->center_freq_hz > 0) {
+        json_number(num, sizeof(num), info->center_freq_hz);
+        fprintf(f, "            \"core:frequency\": %s,\n", num);
+    }
+    if (info->start_time_us != 0) {
+        iqr_format_utc(info->start_time_us, iso, sizeof(iso));
+        fprintf(f, "            \"core:datetime\": \"%s\",\n", iso);
+    }
+    fprintf(f, "            \"phoenix:bandwidth_khz\": %u,\n", info->bandwidth_khz);
+    fprintf(f, "            \"phoenix:gain_reduction_db\": %d,\n", info->gain_reduction);
+    fprintf(f, "            \"phoenix:lna_state\": %u,\n", info->lna_state);
+    fprintf(f, "            \"phoenix:source_offset\": %llu\n", (unsigned long long)source_offset);
+    fprintf(f, "        }\n");
+    fprintf(f, "    ],\n");
+
+    fprintf(f, "    \"annotations\": [");
+    bool first = true;
+
+    if (meta && info->sample_count > 0) {
+        fprintf(f, "\n        {\n");
+        fprintf(f, "            \"core:sample_start\": 0,\n");
+        fprintf(f, "            \"core:sample_count\": %llu,\n", (unsigned long long)info->sample_count);
+        fprintf(f, "            \"core:label\": \"timing\",\n");
+        if (meta->gps_valid) {
+            fprintf(f, "            \"core:comment\": \"time_source=GPS_PPS satellites=%d pc_offset_ms=%.3f\",\n",
+                    meta->gps_satellites, meta->gps_pc_offset_ms);
+            fprintf(f, "            \"phoenix:gps_satellites\": %d,\n", meta->gps_satellites);
+            fprintf(f, "            \"phoenix:gps_pc_offset_ms\": %.3f,\n", meta->gps_pc_offset_ms);
+            fprintf(f, "            \"phoenix:gps_latency_ms\": %.3f,\n", meta->gps_latency_ms);
+        } else {
+            fprintf(f, "            \"core:comment\": \"time_source=system_clock\",\n");
+        }
+        fprintf(f, "            \"phoenix:recording_complete\": %s\n",
+                meta->recording_complete ? "true" : "false");
+        fprintf(f, "        }");
+        first = false;
+    }
+
+    /* UTC minute boundaries - where the WWV minute markers should be */
+    if (info->start_time_us != 0 && info->sample_rate_hz > 0) {
+        const int64_t minute_us = 60 * US_PER_SEC;
+        int64_t t = (floor_div(info->start_time_us - 1, minute_us) + 1) * minute_us;
+        for (;; t += minute_us) {
+            double offset = (double)(t - info->start_time_us) * 1e-6 * info->sample_rate_hz;
+            uint64_t sample = (uint64_t)llround(offset);
+            if (sample >= info->sample_count) break;
+
+            int64_t day = floor_div(t, US_PER_DAY);
+            int64_t sod = (t - day * US_PER_DAY) / US_PER_SEC;
+            fprintf(f, "%s\n        {\n", first ? "" : ",");
+            fprintf(f, "            \"core:sample_start\": %llu,\n", (unsigned long long)sample);
+            fprintf(f, "            \"core:label\": \"minute\",\n");
+            fprintf(f, "            \"core:comment\": \"UTC %02d:%02d\"\n",
+                    (int)(sod / 3600), (int)(sod / 60 % 60));
+            fprintf(f, "        }");
+            first = false;
+        }
+    }
+
+    fprintf(f, "%s]\n}\n", first ? "" : "\n    ");
+    return ferror(f) ? -1 : 0;
+}
+
+/* Position just after `"key":` (whitespace skipped), or NULL */
+static const char *json_find_value(const char *json, const char *key) {
+    size_t klen = strlen(key);
+    for (const char *p = strchr(json, '"'); p; p = strchr(p + 1, '"')) {
+        if (strncmp(p + 1, key, klen) == 0 && p[1 + klen] == '"') {
+            const char *v = p + 2 + klen;
+            while (isspace((unsigned char)*v)) v++;
+            if (*v != ':') continue;
+            v++;
+            while (isspace((unsigned char)*v)) v++;
+            return v;
+        }
+    }
+    return NULL;
+}
+
+static bool json_get_string(const char *json, const char *key, char *out, size_t size) {
+    const char *v = json_find_value(json, key);
+    if (!v || *v != '"' || size == 0) return false;
+    v++;
+    size_t n = 0;
+    while (*v && *v != '"' && n + 1 < size) out[n++] = *v++;
+    out[n] = '\0';
+    return *v == '"';
+}
+
+static bool json_get_number(const char *json, const char *key, double *out) {
+    const char *v = json_find_value(json, key);
+    if (!v) return false;
+    char *end;
+    double d = strtod(v, &end);
+    if (end == v) return false;
+    *out = d;
+    return true;
+}
+
+bool iqr_sigmf_parse_meta(const char *json, iqr_stream_info_t *info) {
+    if (!json || !info) return false;
+    memset(info, 0, sizeof(*info));
+
+    char datatype[32];
+    if (!json_get_string(json, "core:datatype", datatype, sizeof(datatype))) return false;
+    if (strcmp(datatype, "ci16_le") == 0) {
+        info->type = IQR_SAMPLE_CS16;
+    } else if (strcmp(datatype, "cf32_le") == 0) {
+        info->type = IQR_SAMPLE_CF32;
+    } else {
+        return false;
+    }
+
+    if (!json_get_number(json, "core:sample_rate", &info->sample_rate_hz) ||
+        info->sample_rate_hz <= 0) {
+        return false;
+    }
+
+    /* First capture segment only */
+    const char *captures = json_find_value(json, "captures");
+    if (captures) {
+        char iso[48];
+        double v;
+        if (json_get_number(captures, "core:frequency", &v)) info->center_freq_hz = v;
+        if (json_get_string(captures, "core:datetime", iso, sizeof(iso))) {
+            iqr_parse_utc(iso, 0, &info->start_time_us);
+        }
+        if (json_get_number(captures, "phoenix:bandwidth_khz", &v)) info->bandwidth_khz = (uint32_t)v;
+        if (json_get_number(captures, "phoenix:gain_reduction_db", &v)) info->gain_reduction = (int32_t)v;
+        if (json_get_number(captures, "phoenix:lna_state", &v)) info->lna_state = (uint32_t)v;
+    }
+    return true;
+}
+
+/*============================================================================
+ * UTC Time and Slicing
+ *============================================================================*/
+
+/* Parse "HH:MM:SS[.ffffff]" at s; returns chars consumed or 0 */
+static int parse_time_of_day(const char *s, int64_t *out_us) {
+    int hh, mm, ss, n = 0;
+    if (sscanf(s, "%2d:%2d:%2d%n", &hh, &mm, &ss, &n) != 3 || n == 0) return 0;
+    if (hh > 23 || mm > 59 || ss > 60 || hh < 0 || mm < 0 || ss < 0) return 0;
+
+    int64_t frac = 0;
+    if (s[n] == '.') {
+        n++;
+        int digits = 0;
+        while (isdigit((unsigned char)s[n])) {
+            if (digits < 6) { frac = frac * 10 + (s[n] - '0'); digits++; }
+            n++;
+        }
+        if (digits == 0) return 0;
+        while (digits++ < 6) frac *= 10;
+    }
+    *out_us = ((int64_t)hh * 3600 + mm * 60 + ss) * US_PER_SEC + frac;
+    return n;
+}
+
+bool iqr_parse_utc(const char *text, int64_t day_ref_us, int64_t *out_us) {
+    if (!text || !out_us) return false;
+    while (isspace((unsigned char)*text)) text++;
+
+    int y, mo, d, n = 0;
+    int64_t day_us, tod_us;
+    const char *rest;
+
+    if (sscanf(text, "%4d-%2d-%2d%n", &y, &mo, &d, &n) == 3 && n == 10) {
+        if (mo < 1 || mo > 12 || d < 1 || d > 31) return false;
+        if (text[n] != 'T' && text[n] != 't' && text[n] != ' ') return false;
+        day_us = days_from_civil(y, mo, d) * US_PER_DAY;
+        rest = text + n + 1;
+    } else {
+        day_us = floor_div(day_ref_us, US_PER_DAY) * US_PER_DAY;
+        rest = text;
+    }
+
+    int used = parse_time_of_day(rest, &tod_us);
+    if (used == 0) return false;
+    rest += used;
+    if (*rest == 'Z' || *rest == 'z') rest++;
+    while (isspace((unsigned char)*rest)) rest++;
+    if (*rest != '\0') return false;
+
+    *out_us = day_us + tod_us;
+    return true;
+}
+
+void iqr_format_utc(int64_t time_us, char *buf, size_t size) {
+    int64_t day = floor_div(time_us, US_PER_DAY);
+    int64_t rem = time_us - day * US_PER_DAY;
+    int y, m, d;
+    civil_from_days(day, &y, &m, &d);
+    int64_t sec = rem / US_PER_SEC;
+    snprintf(buf, size, "%04d-%02d-%02dT%02d:%02d:%02d.%06dZ",
+             y, m, d, (int)(sec / 3600), (int)(sec / 60 % 60), (int)(sec % 60),
+             (int)(rem % US_PER_SEC));
+}
+
+/* Index of the first sample at or after t */
+static uint64_t sample_at_or_after(const iqr_stream_info_t *info, int64_t t_us) {
+    if (t_us <= info->start_time_us) return 0;
+    double pos = (double)(t_us - info->start_time_us) * 1e-6 * info->sample_rate_hz;
+    double idx = ceil(pos - 1e-6);          /* Absorb rounding at exact boundaries */
+    if (idx >= (double)info->sample_count) return info->sample_count;
+    return (uint64_t)idx;
+}
+
+bool iqr_slice_range(const iqr_stream_info_t *info, int64_t from_us, int64_t to_us,
+                     uint64_t *first, uint64_t *count) {
+    if (!info || !first || !count) return false;
+    *first = 0;
+    *count = 0;
+    if (info->sample_rate_hz <= 0) return false;
+    if (info->start_time_us == 0 && (from_us != 0 || to_us != 0)) return false;
+
+    uint64_t begin = from_us ? sample_at_or_after(info, from_us) : 0;
+    uint64_t end = to_us ? sample_at_or_after(info, to_us) : info->sample_count;
+    if (end <= begin) return false;
+
+    *first = begin;
+    *count = end - begin;
+    return true;
+}
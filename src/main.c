@@ -115,6 +115,7 @@ typedef struct {
 
 static gps_sync_sample_t g_gps_sync_log[MAX_GPS_SYNC_SAMPLES];
 static int g_gps_sync_count = 0;
+static int g_timing_overload_count = 0;   /* g_overload_count at last timing entry */
 
 /*============================================================================
  * Usage / Help
@@ -302,6 +303,30 @@ static void signal_handler(int sig) {
  * GPS Time Display During Recording
  *============================================================================*/
 
+/* Stamp both recordings' timing tracks with a GPS reading */
+static void add_timing_entries(const gps_reading_t *gps) {
+    iqr_timing_entry_t e;
+    memset(&e, 0, sizeof(e));
+    e.utc_us = (int64_t)(gps->unix_time * 1000000.0);
+    e.gain_reduction = g_sdr_config.gain_reduction;
+    e.lna_state = (uint8_t)g_sdr_config.lna_state;
+    e.flags = IQR_TIMING_GPS;
+    if (g_overload_count != g_timing_overload_count) {
+        e.flags |= IQR_TIMING_OVERLOAD;
+        g_timing_overload_count = g_overload_count;
+    }
+    
+    /* Out-of-order readings are refused by the recorder; nothing to do then */
+    if (g_raw_recorder && iqr_is_recording(g_raw_recorder)) {
+        e.sample_index = g_sample_count;
+        iqr_add_timing(g_raw_recorder, &e);
+    }
+    if (g_decim_recorder && iqr_is_recording(g_decim_recorder)) {
+        e.sample_index = g_decim_sample_count;
+        iqr_add_timing(g_decim_recorder, &e);
+    }
+}
+
 static void record_gps_sync(double elapsed_sec) {
     if (!g_gps_enabled || !gps_is_connected(&g_gps_ctx)) {
         printf("  %5.1fs | GPS: NOT CONNECTED\n", elapsed_sec);
@@ -322,6 +347,7 @@ static void record_gps_sync(double elapsed_sec) {
             g_gps_sync_log[g_gps_sync_count].valid = true;
             g_gps_sync_count++;
         }
+        add_timing_entries(&gps);
         
         /* Calculate offset to next minute marker */
         int sec_in_minute = gps.second;
@@ -742,6 +768,10 @@ int main(int argc, char *argv[]) {
         return 1;
     }
     
+    /* Block CRCs so iqr_verify can find damage in the archive later */
+    iqr_set_crc_block(g_raw_recorder, IQR_CRC_DEFAULT_BLOCK);
+    iqr_set_crc_block(g_decim_recorder, IQR_CRC_DEFAULT_BLOCK);
+    
     /* Get fresh GPS time right before recording starts */
     if (have_gps_time && gps_is_connected(&g_gps_ctx)) {
         printf("Synchronizing to GPS...\n");
@@ -0,0 +1,336 @@
+/**
+ * @file noise_blanker.c
+ * @brief Impulse noise blanker implementation
+ *
+ * Per block of at most NB_BLOCK pairs:
+ *   1. the block joins the delay line behind the look-ahead pairs
+ *   2. detection: |x| against the chunk's level, summing min(|x|, level)
+ *      for the average; only chunks with a trigger are scanned pair by pair,
+ *      and the trigger times are queued
+ *   3. the oldest pairs of the delay line go out. Trigger t is applied as
+ *      pair t - lookahead goes out: it opens the window [t - lookahead,
+ *      t + hang], or extends the open one if they touch
+ *
+ * So pair k depends only on pairs up to k + lookahead, whatever the blocks.
+ * Interpolation holds the last pair written until the first pair after the
+ * window is in the look-ahead, then steps toward it, one equal step per
+ * pair; a later trigger that extends the window starts the hold again.
+ */
+
+#include "noise_blanker.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9)
+#define NB_USE_VECTOR 1
+#define NB_LANES 4                      /* One SSE2/NEON register of int32; wider types split badly */
+typedef int16_t nb_vec_t __attribute__((vector_size(8)));
+typedef int32_t nb_wide_t __attribute__((vector_size(16)));
+#endif
+
+#define NB_BLOCK            1024        /* Pairs through the delay line per pass */
+#define NB_MAX_SHIFT        20
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+struct noise_blanker {
+    noise_blanker_config_t cfg;
+    int lookahead;                  /* Pairs */
+    int hang;
+    int shift;                      /* Average: 2^shift chunks */
+    int64_t threshold_q8;
+
+    /* Average |x| */
+    uint32_t average_q8;
+    uint32_t level;
+    uint32_t chunk_fill;
+    uint32_t chunk_sum;
+    bool warm;                      /* First chunk seen */
+
+    /* Delay line: lookahead pairs, then the block; buf[0] is pair base */
+    int16_t *buf;
+    int64_t base;
+
+    /* Triggers not yet applied, oldest first; emptied by every block */
+    int64_t *triggers;
+    int n_triggers;
+    int next_trigger;
+    int64_t window_end;             /* Last pair of the open window */
+
+    int16_t prev[2];                /* Last pair written */
+    noise_blanker_stats_t stats;
+};
+
+/*============================================================================
+ * Create / Destroy
+ *============================================================================*/
+
+void noise_blanker_default_config(noise_blanker_config_t *cfg, float sample_rate) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->sample_rate = sample_rate;
+    cfg->threshold = NB_DEFAULT_THRESHOLD;
+    cfg->lookahead_us = NB_DEFAULT_LOOKAHEAD_US;
+    cfg->hang_us = NB_DEFAULT_HANG_US;
+    cfg->average_ms = NB_DEFAULT_AVERAGE_MS;
+    cfg->mode = NB_MODE_INTERPOLATE;
+}
+
+static int us_to_pairs(float us, float rate) {
+    return us > 0.0f ? (int)lrintf(us * 1e-6f * rate) : 0;
+}
+
+noise_blanker_t *noise_blanker_create(const noise_blanker_config_t *cfg) {
+    if (!cfg || !(cfg->sample_rate > 0.0f) || !(cfg->threshold > 0.0f)) return NULL;
+    int lookahead = us_to_pairs(cfg->lookahead_us, cfg->sample_rate);
+    int hang = us_to_pairs(cfg->hang_us, cfg->sample_rate);
+    if (lookahead > NB_MAX_LOOKAHEAD) return NULL;
+
+    noise_blanker_t *nb = (noise_blanker_t *)calloc(1, sizeof(noise_blanker_t));
+    if (!nb) return NULL;
+    nb->cfg = *cfg;
+    nb->lookahead = lookahead;
+    nb->hang = hang;
+    nb->threshold_q8 = llrintf(cfg->threshold * 256.0f);
+
+    double chunks = cfg->average_ms * 1e-3 * cfg->sample_rate / NB_CHUNK;
+    nb->shift = chunks > 1.0 ? (int)lrint(log2(chunks)) : 0;
+    if (nb->shift > NB_MAX_SHIFT) nb->shift = NB_MAX_SHIFT;
+
+    nb->buf = (int16_t *)malloc(sizeof(int16_t) * 2 * (size_t)(lookahead + NB_BLOCK));
+    nb->triggers = (int64_t *)malloc(sizeof(int64_t) * NB_BLOCK);
+    if (!nb->buf || !nb->triggers) {
+        noise_blanker_destroy(nb);
+        return NULL;
+    }
+    noise_blanker_reset(nb);
+    return nb;
+}
+
+void noise_blanker_destroy(noise_blanker_t *nb) {
+    if (!nb) return;
+    free(nb->buf);
+    free(nb->triggers);
+    free(nb);
+}
+
+void noise_blanker_reset(noise_blanker_t *nb) {
+    nb->average_q8 = 0;
+    nb->level = UINT32_MAX;         /* No triggers until the first chunk sets the average */
+    nb->chunk_fill = 0;
+    nb->chunk_sum = 0;
+    nb->warm = false;
+    memset(nb->buf, 0, sizeof(int16_t) * 2 * (size_t)nb->lookahead);
+    nb->base = -nb->lookahead;
+    nb->n_triggers = 0;
+    nb->next_trigger = 0;
+    nb->window_end = INT64_MIN / 2;
+    nb->prev[0] = nb->prev[1] = 0;
+    memset(&nb->stats, 0, sizeof(nb->stats));
+}
+
+int noise_blanker_delay(const noise_blanker_t *nb) {
+    return nb->lookahead;
+}
+
+void noise_blanker_get_stats(const noise_blanker_t *nb, noise_blanker_stats_t *stats) {
+    *stats = nb->stats;
+    stats->average = nb->average_q8 >> 8;
+    stats->level = nb->warm ? nb->level : 0;
+}
+
+/*============================================================================
+ * Detection
+ *============================================================================*/
+
+/* New average at the end of each chunk; the level follows it */
+static void end_chunk(noise_blanker_t *nb) {
+    /* Mean |x| x 256 over 2 * NB_CHUNK values */
+    int64_t mean_q8 = ((int64_t)nb->chunk_sum << 8) / (2 * NB_CHUNK);
+    if (!nb->warm) {
+        nb->average_q8 = (uint32_t)mean_q8;
+        nb->warm = true;
+    } else {
+        int64_t d = mean_q8 - nb->average_q8;
+        d = d >= 0 ? d >> nb->shift : -((-d) >> nb->shift);
+        nb->average_q8 = (uint32_t)(nb->average_q8 + d);
+    }
+
+    int64_t level = ((int64_t)nb->average_q8 * nb->threshold_q8) >> 16;
+    if (level < NB_MIN_LEVEL) level = NB_MIN_LEVEL;
+    if (level > 65535) level = 65535;
+    nb->level = (uint32_t)level;
+    nb->chunk_fill = 0;
+    nb->chunk_sum = 0;
+}
+
+/* Sum of min(|x|, level) over n values; true if any |x| > level */
+static bool scan_scalar(const int16_t *x, size_t n, uint32_t level, uint32_t *sum) {
+    uint32_t s = 0;
+    bool any = false;
+    for (size_t k = 0; k < n; k++) {
+        uint32_t a = (uint32_t)abs(x[k]);
+        if (a > level) {
+            any = true;
+            a = level;
+        }
+        s += a;
+    }
+    *sum += s;
+    return any;
+}
+
+#if defined(NB_USE_VECTOR)
+static bool scan_vector(const int16_t *x, size_t n, uint32_t level, uint32_t *sum) {
+    /* Levels above 32768 cannot trigger, and clip nothing */
+    const int32_t lv = level > 32768 ? 32768 : (int32_t)level;
+    const nb_wide_t lvec = { lv, lv, lv, lv };
+    nb_wide_t acc = {0};
+    nb_wide_t hit = {0};
+    size_t k = 0;
+
+    for (; k + NB_LANES <= n; k += NB_LANES) {
+        nb_vec_t v;
+        memcpy(&v, x + k, sizeof(v));
+        nb_wide_t w = __builtin_convertvector(v, nb_wide_t);
+        nb_wide_t sign = w >> 31;
+        w = (w ^ sign) - sign;
+        nb_wide_t over = w > lvec;
+        acc += (w & ~over) | (lvec & over);
+        hit |= over;
+    }
+
+    uint32_t s = (uint32_t)(acc[0] + acc[1] + acc[2] + acc[3]);
+    bool any = (hit[0] | hit[1] | hit[2] | hit[3]) != 0;
+    *sum += s;
+    return scan_scalar(x + k, n - k, level, sum) || any;
+}
+#endif
+
+/* count new pairs at x, the first being stream pair first */
+static void detect(noise_blanker_t *nb, const int16_t *x, size_t count, int64_t first, bool vector) {
+#if !defined(NB_USE_VECTOR)
+    (void)vector;
+#endif
+
+    while (count > 0) {
+        size_t n = NB_CHUNK - nb->chunk_fill;
+        if (n > count) n = count;
+        uint32_t level = nb->level;
+        bool any;
+
+#if defined(NB_USE_VECTOR)
+        any = vector ? scan_vector(x, n * 2, level, &nb->chunk_sum)
+                     : scan_scalar(x, n * 2, level, &nb->chunk_sum);
+#else
+        any = scan_scalar(x, n * 2, level, &nb->chunk_sum);
+#endif
+        if (any) {
+            for (size_t k = 0; k < n; k++) {
+                if ((uint32_t)abs(x[k * 2]) > level || (uint32_t)abs(x[k * 2 + 1]) > level) {
+                    nb->triggers[nb->n_triggers++] = first + (int64_t)k;
+                }
+            }
+        }
+
+        nb->chunk_fill += (uint32_t)n;
+        if (nb->chunk_fill == NB_CHUNK) end_chunk(nb);
+        x += n * 2;
+        first += (int64_t)n;
+        count -= n;
+    }
+}
+
+/*============================================================================
+ * Output
+ *============================================================================*/
+
+/* Open a window, or extend the open one, for trigger t as pair t - lookahead goes out */
+static void apply_trigger(noise_blanker_t *nb, int64_t t) {
+    if (t - nb->lookahead > nb->window_end + 1) nb->stats.impulses++;
+    nb->window_end = t + nb->hang;
+}
+
+/* Pairs [from, to) of the delay line, all inside the open window */
+static void blank(noise_blanker_t *nb, int16_t *out, int64_t from, int64_t to) {
+    if (nb->cfg.mode == NB_MODE_ZERO) {
+        memset(out, 0, sizeof(int16_t) * 2 * (size_t)(to - from));
+        nb->prev[0] = nb->prev[1] = 0;
+        return;
+    }
+
+    const int64_t next = nb->window_end + 1;
+    for (int64_t k = from; k < to; k++, out += 2) {
+        if (next - k <= nb->lookahead) {
+            const int16_t *target = nb->buf + (next - nb->base) * 2;
+            int64_t steps = next - k + 1;
+            for (int c = 0; c < 2; c++) {
+                nb->prev[c] = (int16_t)(nb->prev[c] + (target[c] - nb->prev[c]) / steps);
+            }
+        }
+        out[0] = nb->prev[0];
+        out[1] = nb->prev[1];
+    }
+}
+
+/* Write the oldest count pairs of the delay line */
+static void emit(noise_blanker_t *nb, int16_t *out, size_t count) {
+    int64_t k = nb->base;
+    const int64_t stop = nb->base + (int64_t)count;
+
+    while (k < stop) {
+        /* Triggers for pair k; only t == k + lookahead can be left */
+        while (nb->next_trigger < nb->n_triggers && nb->triggers[nb->next_trigger] - nb->lookahead <= k) {
+            apply_trigger(nb, nb->triggers[nb->next_trigger++]);
+        }
+        int64_t until = nb->next_trigger < nb->n_triggers
+                        ? nb->triggers[nb->next_trigger] - nb->lookahead : stop;
+        if (until > stop) until = stop;
+
+        if (k > nb->window_end) {
+            size_t n = (size_t)(until - k);
+            memcpy(out, nb->buf + (k - nb->base) * 2, sizeof(int16_t) * 2 * n);
+            out += n * 2;
+            nb->prev[0] = out[-2];
+            nb->prev[1] = out[-1];
+            k = until;
+            continue;
+        }
+
+        int64_t blank_end = nb->window_end + 1 < until ? nb->window_end + 1 : until;
+        blank(nb, out, k, blank_end);
+        out += (blank_end - k) * 2;
+        nb->stats.blanked += (uint64_t)(blank_end - k);
+        k = blank_end;
+    }
+    nb->n_triggers = 0;
+    nb->next_trigger = 0;
+    nb->stats.pairs += count;
+}
+
+static void run(noise_blanker_t *nb, const int16_t *iq, int16_t *out, size_t count, bool vector) {
+    const size_t la = (size_t)nb->lookahead;
+
+    while (count > 0) {
+        size_t n = count < NB_BLOCK ? count : NB_BLOCK;
+        memcpy(nb->buf + la * 2, iq, sizeof(int16_t) * 2 * n);
+        detect(nb, nb->buf + la * 2, n, nb->base + (int64_t)la, vector);
+        emit(nb, out, n);
+        memmove(nb->buf, nb->buf + n * 2, sizeof(int16_t) * 2 * la);
+        nb->base += (int64_t)n;
+
+        iq += n * 2;
+        out += n * 2;
+        count -= n;
+    }
+}
+
+void noise_blanker_process(noise_blanker_t *nb, const int16_t *iq, int16_t *out, size_t count) {
+    run(nb, iq, out, count, true);
+}
+
+void noise_blanker_process_scalar(noise_blanker_t *nb, const int16_t *iq, int16_t *out, size_t count) {
+    run(nb, iq, out, count, false);
+}
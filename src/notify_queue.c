@@ -0,0 +1,140 @@
+/**
+ * @file notify_queue.c
+ * @brief Wait-free hand-off of SDR events to the control-plane thread
+ *
+ * Gain reports live in one 64-bit slot: a pending bit plus the packed
+ * GR/LNA values, replaced with a single exchange. Overload state is an
+ * exchanged flag; a post that changes it bumps an edge counter. Edges
+ * strictly alternate starting from "not overloaded", so edge k (1-based)
+ * is DETECTED when k is odd - the counter alone reconstructs the sequence.
+ */
+
+#include "notify_queue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+#define GAIN_PENDING    (1ull << 63)
+
+struct notify_queue {
+    /* Posting side */
+    atomic_uint_least64_t gain;         /* GAIN_PENDING | lna << 16 | gr */
+    atomic_bool overloaded;
+    atomic_uint_least64_t edges;
+    atomic_uint_least64_t gain_posts;
+    atomic_uint_least64_t gain_coalesced;
+
+    /* Drain side */
+    uint64_t edges_delivered;
+    uint64_t edges_collapsed;
+};
+
+static uint64_t pack_gain(int gr_db, int lna_gr_db) {
+    return GAIN_PENDING | ((uint64_t)(uint16_t)lna_gr_db << 16) | (uint16_t)gr_db;
+}
+
+/*============================================================================
+ * Create / Destroy
+ *============================================================================*/
+
+notify_queue_t *notify_queue_create(void) {
+    notify_queue_t *q = (notify_queue_t *)calloc(1, sizeof(notify_queue_t));
+    if (!q) return NULL;
+    atomic_init(&q->gain, 0);
+    atomic_init(&q->overloaded, false);
+    atomic_init(&q->edges, 0);
+    atomic_init(&q->gain_posts, 0);
+    atomic_init(&q->gain_coalesced, 0);
+    return q;
+}
+
+void notify_queue_destroy(notify_queue_t *q) {
+    free(q);
+}
+
+/*============================================================================
+ * Posting Side
+ *============================================================================*/
+
+void notify_post_gain(notify_queue_t *q, int gr_db, int lna_gr_db) {
+    if (!q) return;
+    uint64_t old = atomic_exchange_explicit(&q->gain, pack_gain(gr_db, lna_gr_db),
+                                            memory_order_release);
+    atomic_fetch_add_explicit(&q->gain_posts, 1, memory_order_relaxed);
+    if (old & GAIN_PENDING) {
+        atomic_fetch_add_explicit(&q->gain_coalesced, 1, memory_order_relaxed);
+    }
+}
+
+bool notify_post_overload(notify_queue_t *q, bool overloaded) {
+    if (!q) return false;
+    bool was = atomic_exchange_explicit(&q->overloaded, overloaded, memory_order_relaxed);
+    if (was == overloaded) return false;
+    atomic_fetch_add_explicit(&q->edges, 1, memory_order_release);
+    return true;
+}
+
+/*============================================================================
+ * Drain Side
+ *============================================================================*/
+
+int notify_queue_drain(notify_queue_t *q, notify_event_t *out) {
+    if (!q || !out) return 0;
+    int n = 0;
+
+    uint64_t edges = atomic_load_explicit(&q->edges, memory_order_acquire);
+    uint64_t first = q->edges_delivered + 1;
+    uint64_t pending = edges - q->edges_delivered;
+    if (pending > NOTIFY_MAX_EDGES_PER_DRAIN) {
+        /* Skip the oldest edges in whole pairs so parity is preserved */
+        uint64_t drop = pending - NOTIFY_MAX_EDGES_PER_DRAIN;
+        drop += drop & 1;
+        first += drop;
+        q->edges_collapsed += drop;
+    }
+    for (uint64_t k = first; k <= edges; k++) {
+        out[n].type = NOTIFY_OVERLOAD;
+        out[n].overloaded = (k & 1) != 0;
+        out[n].gr_db = 0;
+        out[n].lna_gr_db = 0;
+        n++;
+    }
+    q->edges_delivered = edges;
+
+    uint64_t gain = atomic_exchange_explicit(&q->gain, 0, memory_order_acquire);
+    if (gain & GAIN_PENDING) {
+        out[n].type = NOTIFY_GAIN_CHANGE;
+        out[n].gr_db = (int16_t)(gain & 0xFFFF);
+        out[n].lna_gr_db = (int16_t)((gain >> 16) & 0xFFFF);
+        out[n].overloaded = false;
+        n++;
+    }
+    return n;
+}
+
+void notify_queue_resync(notify_queue_t *q) {
+    if (!q) return;
+    q->edges_delivered = atomic_load_explicit(&q->edges, memory_order_acquire);
+    atomic_store_explicit(&q->gain, 0, memory_order_relaxed);
+}
+
+void notify_format(const notify_event_t *ev, char *buf, size_t size) {
+    if (!ev || !buf || size == 0) return;
+    if (ev->type == NOTIFY_GAIN_CHANGE) {
+        snprintf(buf, size, "! GAIN_CHANGE GR_ACTUAL=%d LNA_GR=%d", ev->gr_db, ev->lna_gr_db);
+    } else {
+        snprintf(buf, size, "! OVERLOAD %s", ev->overloaded ? "DETECTED" : "CLEARED");
+    }
+}
+
+void notify_queue_get_stats(notify_queue_t *q, notify_stats_t *stats) {
+    if (!q || !stats) return;
+    stats->gain_posts = atomic_load_explicit(&q->gain_posts, memory_order_relaxed);
+    stats->gain_coalesced = atomic_load_explicit(&q->gain_coalesced, memory_order_relaxed);
+    stats->overload_edges = atomic_load_explicit(&q->edges, memory_order_relaxed);
+    stats->edges_collapsed = q->edges_collapsed;
+}
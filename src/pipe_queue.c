@@ -0,0 +1,194 @@
+/**
+ * @file pipe_queue.c
+ * @brief Bounded block queue between in-process pipeline stages
+ *
+ * A ring of preallocated blocks with head/tail counters under one mutex.
+ * Blocks are thousands of samples, so one lock per block is noise next to
+ * the work done on it; a side only signals the other when it is actually
+ * waiting.
+ */
+
+#include "pipe_queue.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+struct pipe_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t  not_full;
+    pthread_cond_t  not_empty;
+
+    pipe_block_t *blocks;
+    uint8_t *samples;
+    uint32_t n_blocks;
+    uint32_t capacity;
+
+    uint64_t head;                      /* Next to read */
+    uint64_t tail;                      /* Next to write */
+    bool closed;
+    int  producer_waiting;
+    int  consumer_waiting;
+
+    pipe_queue_stats_t stats;
+};
+
+/* Absolute CLOCK_REALTIME deadline for pthread_cond_timedwait */
+static struct timespec deadline_after(int timeout_ms) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+/* Wait on cond until ready() or the timeout; lock held throughout */
+static bool wait_for(pipe_queue_t *q, pthread_cond_t *cond, int *waiting,
+                     bool (*ready)(const pipe_queue_t *), int timeout_ms) {
+    if (ready(q)) return true;
+    if (timeout_ms == 0) return false;
+
+    struct timespec until = { 0, 0 };
+    if (timeout_ms > 0) until = deadline_after(timeout_ms);
+    (*waiting)++;
+    while (!ready(q)) {
+        int rc = timeout_ms < 0 ? pthread_cond_wait(cond, &q->lock)
+                                : pthread_cond_timedwait(cond, &q->lock, &until);
+        if (rc == ETIMEDOUT) break;
+    }
+    (*waiting)--;
+    return ready(q);
+}
+
+static bool has_room(const pipe_queue_t *q) {
+    return q->closed || q->tail - q->head < q->n_blocks;
+}
+
+static bool has_block(const pipe_queue_t *q) {
+    return q->closed || q->tail != q->head;
+}
+
+/*============================================================================
+ * Create / Destroy
+ *============================================================================*/
+
+pipe_queue_t *pipe_queue_create(uint32_t blocks, uint32_t capacity, uint32_t pair_bytes) {
+    if (blocks == 0 || capacity == 0 || pair_bytes == 0) return NULL;
+
+    pipe_queue_t *q = (pipe_queue_t *)calloc(1, sizeof(pipe_queue_t));
+    if (!q) return NULL;
+
+    q->blocks = (pipe_block_t *)calloc(blocks, sizeof(pipe_block_t));
+    q->samples = (uint8_t *)malloc((size_t)blocks * capacity * pair_bytes);
+    if (!q->blocks || !q->samples) {
+        free(q->blocks);
+        free(q->samples);
+        free(q);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < blocks; i++) {
+        q->blocks[i].samples = q->samples + (size_t)i * capacity * pair_bytes;
+    }
+    q->n_blocks = blocks;
+    q->capacity = capacity;
+    q->stats.capacity = blocks;
+
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->not_full, NULL);
+    pthread_cond_init(&q->not_empty, NULL);
+    return q;
+}
+
+void pipe_queue_destroy(pipe_queue_t *q) {
+    if (!q) return;
+    pthread_mutex_destroy(&q->lock);
+    pthread_cond_destroy(&q->not_full);
+    pthread_cond_destroy(&q->not_empty);
+    free(q->blocks);
+    free(q->samples);
+    free(q);
+}
+
+uint32_t pipe_queue_capacity(const pipe_queue_t *q) {
+    return q->capacity;
+}
+
+/*============================================================================
+ * Producer
+ *============================================================================*/
+
+pipe_block_t *pipe_queue_reserve(pipe_queue_t *q, int timeout_ms) {
+    pipe_block_t *b = NULL;
+
+    pthread_mutex_lock(&q->lock);
+    if (q->tail - q->head >= q->n_blocks && !q->closed) q->stats.full_waits++;
+    if (wait_for(q, &q->not_full, &q->producer_waiting, has_room, timeout_ms) && !q->closed) {
+        b = &q->blocks[q->tail % q->n_blocks];
+        b->count = 0;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return b;
+}
+
+void pipe_queue_commit(pipe_queue_t *q) {
+    pthread_mutex_lock(&q->lock);
+    q->stats.blocks++;
+    q->stats.pairs += q->blocks[q->tail % q->n_blocks].count;
+    q->tail++;
+    uint32_t depth = (uint32_t)(q->tail - q->head);
+    if (depth > q->stats.high_water) q->stats.high_water = depth;
+    if (q->consumer_waiting) pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+}
+
+/*============================================================================
+ * Consumer
+ *============================================================================*/
+
+pipe_block_t *pipe_queue_front(pipe_queue_t *q, int timeout_ms) {
+    pipe_block_t *b = NULL;
+
+    pthread_mutex_lock(&q->lock);
+    if (q->tail == q->head && !q->closed) q->stats.empty_waits++;
+    if (wait_for(q, &q->not_empty, &q->consumer_waiting, has_block, timeout_ms) && q->tail != q->head) {
+        b = &q->blocks[q->head % q->n_blocks];
+    }
+    pthread_mutex_unlock(&q->lock);
+    return b;
+}
+
+void pipe_queue_pop(pipe_queue_t *q) {
+    pthread_mutex_lock(&q->lock);
+    if (q->tail != q->head) q->head++;
+    if (q->producer_waiting) pthread_cond_signal(&q->not_full);
+    pthread_mutex_unlock(&q->lock);
+}
+
+/*============================================================================
+ * Shutdown / Stats
+ *============================================================================*/
+
+void pipe_queue_close(pipe_queue_t *q) {
+    pthread_mutex_lock(&q->lock);
+    q->closed = true;
+    pthread_cond_broadcast(&q->not_full);
+    pthread_cond_broadcast(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+}
+
+void pipe_queue_get_stats(pipe_queue_t *q, pipe_queue_stats_t *stats) {
+    pthread_mutex_lock(&q->lock);
+    *stats = q->stats;
+    stats->depth = (uint32_t)(q->tail - q->head);
+    pthread_mutex_unlock(&q->lock);
+}
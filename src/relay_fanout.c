@@ -0,0 +1,564 @@
+/**
+ * @file relay_fanout.c
+ * @brief signal_relay's per-stream fan-out, for the relay and in-process pipelines
+ *
+ * Moved out of signal_relay.c so an in-process pipeline serves clients with
+ * the same code. The logic is unchanged; only the socket calls go through
+ * the usual Winsock/POSIX macros.
+ */
+
+#include "relay_fanout.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+typedef int socklen_t;
+#define socket_close closesocket
+#define socket_would_block() (WSAGetLastError() == WSAEWOULDBLOCK)
+#define SEND_FLAGS 0
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#define socket_close close
+#define socket_would_block() (errno == EAGAIN || errno == EWOULDBLOCK)
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+#endif
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+#define FRAMER_SIZE         (16 + RELAY_FANOUT_MAX_FRAME * 8)   /* One F32 DATA frame */
+
+typedef struct {
+    uint8_t *data;
+    size_t capacity;
+    size_t write_idx;
+    size_t read_idx;
+    size_t count;
+    uint64_t overflows;
+    uint64_t bytes_sent;
+} client_buffer_t;
+
+typedef struct {
+    relay_socket_t fd;
+    struct sockaddr_in addr;
+    client_buffer_t *buffer;
+    bool header_sent;
+    iq_encoding_t encoding;
+    time_t connected_time;
+    uint64_t frames_sent;
+} client_t;
+
+typedef struct {
+    relay_socket_t fd;
+    struct sockaddr_in addr;
+    uint64_t since_ms;
+} pending_conn_t;
+
+struct relay_fanout {
+    const char *name;
+    relay_stream_header_t stream_header;
+
+    client_t clients[RELAY_FANOUT_MAX_CLIENTS];
+    int count;
+    uint64_t total_clients_served;
+    uint64_t total_bytes_relayed;
+    uint64_t total_frames_relayed;
+    uint64_t overflows_closed;          /* Ring overflows of clients that have gone */
+    uint64_t enc_bytes[IQ_ENC_COUNT];
+    uint64_t enc_f32_bytes[IQ_ENC_COUNT];
+
+    /* Framing: source byte stream -> whole DATA frames */
+    relay_mcast_tx_t *mcast;
+    iq_encoding_t source_encoding;
+    uint8_t *buf;                       /* Source bytes not yet framed */
+    size_t len;
+    float *iq;                          /* Latest frame as float32 */
+    uint32_t iq_samples;
+    uint8_t *out;                       /* Encoder output */
+    uint64_t resyncs;
+
+    pending_conn_t pending[RELAY_FANOUT_PENDING_MAX];
+    int n_pending;
+};
+
+static uint64_t now_ms(void) {
+#ifdef _WIN32
+    return (uint64_t)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)(ts.tv_nsec / 1000000);
+#endif
+}
+
+static void set_nonblocking(relay_socket_t fd) {
+#ifdef _WIN32
+    u_long mode = 1;
+    ioctlsocket(fd, FIONBIO, &mode);
+#else
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+#endif
+}
+
+static uint32_t rd32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/*============================================================================
+ * Client Ring Buffer
+ *============================================================================*/
+
+static client_buffer_t* client_buffer_create(size_t capacity) {
+    client_buffer_t *cb = (client_buffer_t*)malloc(sizeof(client_buffer_t));
+    if (!cb) return NULL;
+
+    cb->data = (uint8_t*)malloc(capacity);
+    if (!cb->data) {
+        free(cb);
+        return NULL;
+    }
+
+    cb->capacity = capacity;
+    cb->write_idx = 0;
+    cb->read_idx = 0;
+    cb->count = 0;
+    cb->overflows = 0;
+    cb->bytes_sent = 0;
+    return cb;
+}
+
+static void client_buffer_destroy(client_buffer_t *cb) {
+    if (cb) {
+        free(cb->data);
+        free(cb);
+    }
+}
+
+static size_t client_buffer_write(client_buffer_t *cb, const uint8_t *data, size_t len) {
+    size_t written = 0;
+
+    while (written < len) {
+        if (cb->count >= cb->capacity) {
+            /* Overflow - discard oldest byte */
+            cb->read_idx = (cb->read_idx + 1) % cb->capacity;
+            cb->overflows++;
+        } else {
+            cb->count++;
+        }
+
+        cb->data[cb->write_idx] = data[written];
+        cb->write_idx = (cb->write_idx + 1) % cb->capacity;
+        written++;
+    }
+
+    return written;
+}
+
+static size_t client_buffer_read(client_buffer_t *cb, uint8_t *data, size_t len) {
+    size_t to_read = (len < cb->count) ? len : cb->count;
+    size_t read_count = 0;
+
+    while (read_count < to_read) {
+        data[read_count] = cb->data[cb->read_idx];
+        cb->read_idx = (cb->read_idx + 1) % cb->capacity;
+        read_count++;
+    }
+
+    cb->count -= read_count;
+    cb->bytes_sent += read_count;
+    return read_count;
+}
+
+/*============================================================================
+ * Client Management
+ *============================================================================*/
+
+static int client_list_add(relay_fanout_t *rf, relay_socket_t fd, struct sockaddr_in *addr,
+                           iq_encoding_t encoding) {
+    if (rf->count >= RELAY_FANOUT_MAX_CLIENTS) {
+        socket_close(fd);
+        return -1;
+    }
+
+    client_t *client = &rf->clients[rf->count];
+    client->fd = fd;
+    client->addr = *addr;
+    client->buffer = client_buffer_create(RELAY_FANOUT_CLIENT_BUFFER);
+    if (!client->buffer) {
+        socket_close(fd);
+        return -1;
+    }
+
+    client->header_sent = false;
+    client->encoding = encoding;
+    client->connected_time = time(NULL);
+    client->frames_sent = 0;
+
+    rf->count++;
+    rf->total_clients_served++;
+
+    fprintf(stderr, "[CLIENT] New connection from %s:%d, %s (total: %d)\n",
+            inet_ntoa(addr->sin_addr), ntohs(addr->sin_port), iq_enc_name(encoding), rf->count);
+
+    return rf->count - 1;
+}
+
+static void client_list_remove(relay_fanout_t *rf, int idx) {
+    if (idx < 0 || idx >= rf->count) return;
+
+    client_t *client = &rf->clients[idx];
+
+    fprintf(stderr, "[CLIENT] Disconnecting %s:%d (sent: %llu bytes, %llu frames)\n",
+            inet_ntoa(client->addr.sin_addr), ntohs(client->addr.sin_port),
+            (unsigned long long)client->buffer->bytes_sent,
+            (unsigned long long)client->frames_sent);
+
+    rf->overflows_closed += client->buffer->overflows;
+    socket_close(client->fd);
+    client_buffer_destroy(client->buffer);
+
+    /* Shift remaining clients */
+    for (int i = idx; i < rf->count - 1; i++) {
+        rf->clients[i] = rf->clients[i + 1];
+    }
+    rf->count--;
+}
+
+/* Bitmask of encodings with at least one client */
+static uint32_t client_list_encodings(const relay_fanout_t *rf) {
+    uint32_t mask = 0;
+    for (int i = 0; i < rf->count; i++) {
+        mask |= 1u << rf->clients[i].encoding;
+    }
+    return mask;
+}
+
+static void client_list_broadcast(relay_fanout_t *rf, iq_encoding_t encoding,
+                                  const relay_data_frame_t *hdr, const uint8_t *data, size_t len) {
+    for (int i = 0; i < rf->count; i++) {
+        client_t *client = &rf->clients[i];
+        if (client->encoding != encoding) continue;
+        client_buffer_write(client->buffer, (const uint8_t*)hdr, sizeof(*hdr));
+        client_buffer_write(client->buffer, data, len);
+        client->frames_sent++;
+    }
+}
+
+void relay_fanout_send(relay_fanout_t *rf) {
+    for (int i = rf->count - 1; i >= 0; i--) {
+        client_t *client = &rf->clients[i];
+
+        /* Send header if not sent yet (reserved1 = the client's encoding) */
+        if (!client->header_sent) {
+            relay_stream_header_t header = rf->stream_header;
+            header.reserved1 = (uint32_t)client->encoding;
+            int sent = (int)send(client->fd, (const char*)&header, sizeof(header), SEND_FLAGS);
+            if (sent == (int)sizeof(header)) {
+                client->header_sent = true;
+            } else if (sent < 0 && !socket_would_block()) {
+                client_list_remove(rf, i);
+                continue;
+            }
+        }
+
+        /* Send buffered data */
+        if (client->buffer->count > 0) {
+            uint8_t chunk[8192];
+            size_t to_send = (client->buffer->count < sizeof(chunk)) ? client->buffer->count : sizeof(chunk);
+            size_t read_count = client_buffer_read(client->buffer, chunk, to_send);
+
+            int sent = (int)send(client->fd, (const char*)chunk, (int)read_count, SEND_FLAGS);
+            if (sent < 0) {
+                if (!socket_would_block()) {
+                    client_list_remove(rf, i);
+                    continue;
+                } else {
+                    /* Put data back in buffer */
+                    client_buffer_write(client->buffer, chunk, read_count);
+                }
+            } else if (sent < (int)read_count) {
+                /* Partial send - put remainder back */
+                client_buffer_write(client->buffer, chunk + sent, read_count - sent);
+            }
+        }
+    }
+}
+
+/*============================================================================
+ * Create / Destroy
+ *============================================================================*/
+
+relay_fanout_t *relay_fanout_create(const char *name, uint32_t sample_rate) {
+    relay_fanout_t *rf = (relay_fanout_t *)calloc(1, sizeof(relay_fanout_t));
+    if (!rf) return NULL;
+
+    rf->name = name;
+    rf->stream_header.magic = RELAY_MAGIC_FT32;
+    rf->stream_header.sample_rate = sample_rate;
+    rf->buf = (uint8_t*)malloc(FRAMER_SIZE);
+    rf->iq = (float*)malloc((size_t)RELAY_FANOUT_MAX_FRAME * 2 * sizeof(float));
+    rf->out = (uint8_t*)malloc(FRAMER_SIZE);
+    if (!rf->buf || !rf->iq || !rf->out) {
+        relay_fanout_destroy(rf);
+        return NULL;
+    }
+    return rf;
+}
+
+void relay_fanout_destroy(relay_fanout_t *rf) {
+    if (!rf) return;
+    for (int i = 0; i < rf->n_pending; i++) socket_close(rf->pending[i].fd);
+    for (int i = 0; i < rf->count; i++) {
+        socket_close(rf->clients[i].fd);
+        client_buffer_destroy(rf->clients[i].buffer);
+    }
+    relay_mcast_tx_destroy(rf->mcast);
+    free(rf->buf);
+    free(rf->iq);
+    free(rf->out);
+    free(rf);
+}
+
+bool relay_fanout_open_mcast(relay_fanout_t *rf, const char *group, int port, const char *iface,
+                             int ttl, int fec) {
+    rf->mcast = relay_mcast_tx_open(group, port, iface, ttl, rf->stream_header.sample_rate, fec);
+    if (!rf->mcast) {
+        fprintf(stderr, "[MCAST-%s] Failed to open %s:%d\n", rf->name, group, port);
+        return false;
+    }
+    fprintf(stderr, "[MCAST-%s] Sending to %s:%d (ttl %d, parity every %d packets)\n",
+            rf->name, group, port, ttl, fec);
+    return true;
+}
+
+void relay_fanout_beacon(relay_fanout_t *rf) {
+    if (rf->mcast) relay_mcast_tx_beacon(rf->mcast);
+}
+
+bool relay_fanout_mcast_stats(const relay_fanout_t *rf, relay_mcast_tx_stats_t *stats) {
+    if (!rf->mcast) return false;
+    relay_mcast_tx_get_stats(rf->mcast, stats);
+    return true;
+}
+
+void relay_fanout_set_rate(relay_fanout_t *rf, uint32_t sample_rate) {
+    rf->stream_header.sample_rate = sample_rate;
+    if (rf->mcast) relay_mcast_tx_set_rate(rf->mcast, sample_rate);
+}
+
+/*============================================================================
+ * Connections
+ *============================================================================*/
+
+void relay_fanout_accept(relay_fanout_t *rf, relay_socket_t listener) {
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+
+    relay_socket_t fd = accept(listener, (struct sockaddr*)&addr, &addr_len);
+    if (fd == RELAY_SOCKET_INVALID) {
+        if (!socket_would_block()) {
+            perror("accept");
+        }
+        return;
+    }
+
+    if (rf->n_pending >= RELAY_FANOUT_PENDING_MAX) {
+        fprintf(stderr, "[%s] Rejecting %s:%d (too many pending connections)\n",
+                rf->name, inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
+        socket_close(fd);
+        return;
+    }
+
+    set_nonblocking(fd);
+    pending_conn_t *pc = &rf->pending[rf->n_pending++];
+    pc->fd = fd;
+    pc->addr = addr;
+    pc->since_ms = now_ms();
+}
+
+int relay_fanout_pending_fds(const relay_fanout_t *rf, relay_socket_t *fds, int max) {
+    int n = 0;
+    for (int i = 0; i < rf->n_pending && n < max; i++) fds[n++] = rf->pending[i].fd;
+    return n;
+}
+
+/* Decide what each new connection is from its first bytes (or silence) */
+relay_socket_t relay_fanout_service_pending(relay_fanout_t *rf) {
+    uint64_t now = now_ms();
+
+    for (int i = rf->n_pending - 1; i >= 0; i--) {
+        pending_conn_t pc = rf->pending[i];
+        bool timed_out = now - pc.since_ms >= RELAY_FANOUT_PENDING_MS;
+        iq_enc_request_t req;
+        int n = (int)recv(pc.fd, (char*)&req, sizeof(req), MSG_PEEK);
+
+        if (n < 0 && socket_would_block()) {
+            if (!timed_out) continue;
+            n = 0;
+            req.magic = 0;
+        } else if (n <= 0) {
+            socket_close(pc.fd);                            /* Gone before saying anything */
+            rf->pending[i] = rf->pending[--rf->n_pending];
+            continue;
+        }
+
+        if (n >= 4 && req.magic == RELAY_MAGIC_FT32) {
+            rf->pending[i] = rf->pending[--rf->n_pending];
+            fprintf(stderr, "[SOURCE-%s] Connection from %s:%d\n",
+                    rf->name, inet_ntoa(pc.addr.sin_addr), ntohs(pc.addr.sin_port));
+            return pc.fd;
+        } else if (n >= 4 && req.magic == IQ_ENC_REQUEST_MAGIC) {
+            if (n < (int)sizeof(req) && !timed_out) continue;
+            recv(pc.fd, (char*)&req, sizeof(req), 0);
+            iq_encoding_t enc = (n == (int)sizeof(req) && req.encoding < IQ_ENC_COUNT)
+                              ? (iq_encoding_t)req.encoding : IQ_ENC_F32;
+            client_list_add(rf, pc.fd, &pc.addr, enc);
+        } else {
+            if (n < 4 && !timed_out) continue;
+            client_list_add(rf, pc.fd, &pc.addr, IQ_ENC_F32);
+        }
+        rf->pending[i] = rf->pending[--rf->n_pending];
+    }
+    return RELAY_SOCKET_INVALID;
+}
+
+/*============================================================================
+ * Stream Framing
+ *============================================================================*/
+
+void relay_fanout_reset(relay_fanout_t *rf) {
+    rf->len = 0;
+    rf->source_encoding = IQ_ENC_F32;
+}
+
+static void relay_frame(relay_fanout_t *rf, uint32_t sequence, const uint8_t *payload,
+                        uint32_t n, float scale) {
+    iq_enc_decode(rf->source_encoding, payload, n, scale, rf->iq);
+    rf->iq_samples = n;
+    if (rf->mcast) relay_mcast_tx_frame(rf->mcast, sequence, rf->iq, n);
+
+    uint32_t mask = client_list_encodings(rf);
+    for (int e = 0; e < IQ_ENC_COUNT; e++) {
+        if (!(mask & (1u << e))) continue;
+
+        relay_data_frame_t hdr = { RELAY_MAGIC_DATA, sequence, n, 0 };
+        const uint8_t *data = rf->out;
+        size_t bytes;
+        float s = scale;
+        if ((iq_encoding_t)e == rf->source_encoding) {
+            data = payload;                 /* Pass through untouched */
+            bytes = iq_enc_payload_bytes(rf->source_encoding, n);
+        } else {
+            bytes = iq_enc_encode((iq_encoding_t)e, rf->iq, n, rf->out, &s);
+        }
+        memcpy(&hdr.reserved, &s, sizeof(s));
+
+        client_list_broadcast(rf, (iq_encoding_t)e, &hdr, data, bytes);
+        rf->enc_bytes[e] += sizeof(hdr) + bytes;
+        rf->enc_f32_bytes[e] += sizeof(hdr) + (uint64_t)n * 2 * sizeof(float);
+    }
+    rf->total_frames_relayed++;
+}
+
+void relay_fanout_frame(relay_fanout_t *rf, uint32_t sequence, const float *iq, uint32_t n) {
+    if (n == 0 || n > RELAY_FANOUT_MAX_FRAME) return;
+    rf->source_encoding = IQ_ENC_F32;
+    rf->total_bytes_relayed += sizeof(relay_data_frame_t) + (uint64_t)n * 2 * sizeof(float);
+    relay_frame(rf, sequence, (const uint8_t*)iq, n, 0.0f);
+}
+
+void relay_fanout_feed(relay_fanout_t *rf, const uint8_t *data, size_t len) {
+    rf->total_bytes_relayed += len;
+
+    if (rf->len + len > FRAMER_SIZE) {
+        rf->len = 0;                    /* Unparseable backlog - drop it */
+        rf->resyncs++;
+        if (len > FRAMER_SIZE) return;
+    }
+    memcpy(rf->buf + rf->len, data, len);
+    rf->len += len;
+
+    /* Headers and payloads are multiples of 4 bytes, so samples stay aligned */
+    size_t pos = 0;
+    while (rf->len - pos >= 16) {
+        const uint8_t *p = rf->buf + pos;
+        uint32_t magic = rd32(p);
+
+        if (magic == RELAY_MAGIC_FT32) {
+            uint32_t rate = rd32(p + 4);
+            uint32_t enc = rd32(p + 8);
+            if (enc >= IQ_ENC_COUNT) {
+                pos += 4;
+                rf->resyncs++;
+                continue;
+            }
+            if (enc != (uint32_t)rf->source_encoding) {
+                fprintf(stderr, "[SOURCE-%s] %u Hz, %s samples\n", rf->name, rate, iq_enc_name((iq_encoding_t)enc));
+            }
+            rf->source_encoding = (iq_encoding_t)enc;
+            relay_fanout_set_rate(rf, rate);
+            pos += sizeof(relay_stream_header_t);
+        } else if (magic == RELAY_MAGIC_DATA) {
+            uint32_t n = rd32(p + 8);
+            if (n == 0 || n > RELAY_FANOUT_MAX_FRAME) {
+                pos += 4;
+                rf->resyncs++;
+                continue;
+            }
+            size_t bytes = sizeof(relay_data_frame_t) + iq_enc_payload_bytes(rf->source_encoding, n);
+            if (rf->len - pos < bytes) break;
+            float scale;
+            memcpy(&scale, p + 12, sizeof(scale));
+            relay_frame(rf, rd32(p + 4), p + sizeof(relay_data_frame_t), n, scale);
+            pos += bytes;
+        } else {
+            pos += 4;
+            rf->resyncs++;
+        }
+    }
+
+    memmove(rf->buf, rf->buf + pos, rf->len - pos);
+    rf->len -= pos;
+}
+
+/*============================================================================
+ * Stats
+ *============================================================================*/
+
+void relay_fanout_get_stats(const relay_fanout_t *rf, relay_fanout_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->clients = rf->count;
+    stats->clients_served = rf->total_clients_served;
+    stats->bytes_in = rf->total_bytes_relayed;
+    stats->frames = rf->total_frames_relayed;
+    stats->resyncs = rf->resyncs;
+    stats->overflows = rf->overflows_closed;
+    for (int i = 0; i < rf->count; i++) {
+        stats->enc_clients[rf->clients[i].encoding]++;
+        stats->overflows += rf->clients[i].buffer->overflows;
+    }
+    memcpy(stats->enc_bytes, rf->enc_bytes, sizeof(stats->enc_bytes));
+    memcpy(stats->enc_f32_bytes, rf->enc_f32_bytes, sizeof(stats->enc_f32_bytes));
+}
+
+bool relay_fanout_measure(const relay_fanout_t *rf, iq_encoding_t encoding, iq_enc_quality_t *q) {
+    return rf->iq_samples > 0 && iq_enc_measure(encoding, rf->iq, rf->iq_samples, q);
+}
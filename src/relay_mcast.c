@@ -0,0 +1,580 @@
+/**
+ * @file relay_mcast.c
+ * @brief UDP multicast packetizer/reassembler for the relay float32 streams
+ *
+ * Parity groups are aligned to DATA sequence numbers (base = seq rounded
+ * down to a multiple of fec_group), which is why fec_group is a power of
+ * two: the alignment then survives the 32-bit sequence wrap.
+ *
+ * A frame with a hole is held until the DATA sequence has moved one full
+ * group past the last packet the frame could have used (known once a later
+ * frame starts arriving): by then its parity packet has either arrived or
+ * been lost too, and the frame is released zero-filled.
+ */
+
+#include "relay_mcast.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET socket_t;
+#define SOCKET_INVALID INVALID_SOCKET
+#define socket_close closesocket
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int socket_t;
+#define SOCKET_INVALID (-1)
+#define socket_close close
+#endif
+
+#define FT32_MAGIC          0x46543332
+#define CHUNK_BYTES         ((int)sizeof(relay_mcast_chunk_t))
+#define SEND_SOCKET_BUFFER  (1024 * 1024)
+
+#define RX_SLOTS            64          /* Frames in flight */
+#define RX_GROUPS           8           /* Parity groups in flight */
+#define RX_SEEN             4096        /* Duplicate-detection window (packets) */
+#define RX_REORDER          4           /* Grace (packets) for reordering without FEC */
+#define RX_RESYNC_PACKETS   65536       /* Sequence jump treated as a restart */
+
+/* Body lengths are multiples of 8 bytes (16-byte chunk + float pairs) */
+static void xor_into(uint8_t *acc, const uint8_t *src, size_t len) {
+    for (size_t i = 0; i + 4 <= len; i += 4) {
+        uint32_t a, b;
+        memcpy(&a, acc + i, 4);
+        memcpy(&b, src + i, 4);
+        a ^= b;
+        memcpy(acc + i, &a, 4);
+    }
+}
+
+static int fec_size(int fec_group) {
+    if (fec_group <= 0) return 0;
+    if (fec_group > 32) fec_group = 32;
+    int g = 1;
+    while (g * 2 <= fec_group) g *= 2;
+    return g;
+}
+
+/*============================================================================
+ * Sender
+ *============================================================================*/
+
+struct relay_mcast_tx {
+    uint32_t sample_rate;
+    int fec_group;
+    relay_mcast_emit_fn emit;
+    void *user_data;
+    socket_t sock;                          /* relay_mcast_tx_open() only */
+
+    uint32_t seq;
+    int group_count;
+    size_t parity_len;
+    uint8_t parity[RELAY_MCAST_MAX_BODY];
+    uint8_t packet[RELAY_MCAST_DATAGRAM];
+
+    relay_mcast_tx_stats_t stats;
+};
+
+static void put_header(uint8_t *p, uint8_t type, uint8_t fec, size_t body_len,
+                       uint32_t seq, uint32_t sample_rate) {
+    relay_mcast_header_t h;
+    h.magic = RELAY_MCAST_MAGIC;
+    h.type = type;
+    h.fec_group = fec;
+    h.length = (uint16_t)body_len;
+    h.seq = seq;
+    h.sample_rate = sample_rate;
+    memcpy(p, &h, sizeof(h));
+}
+
+static void emit_packet(relay_mcast_tx_t *tx, size_t body_len) {
+    size_t len = RELAY_MCAST_HEADER_BYTES + body_len;
+    tx->emit(tx->packet, len, tx->user_data);
+    tx->stats.bytes += len;
+}
+
+static void socket_emit(const uint8_t *packet, size_t len, void *user_data) {
+    relay_mcast_tx_t *tx = (relay_mcast_tx_t *)user_data;
+    if (send(tx->sock, (const char *)packet, (int)len, 0) != (int)len) {
+        tx->stats.send_errors++;
+    }
+}
+
+relay_mcast_tx_t *relay_mcast_tx_create(uint32_t sample_rate, int fec_group,
+                                        relay_mcast_emit_fn emit, void *user_data) {
+    if (!emit) return NULL;
+    relay_mcast_tx_t *tx = (relay_mcast_tx_t *)calloc(1, sizeof(relay_mcast_tx_t));
+    if (!tx) return NULL;
+    tx->sample_rate = sample_rate;
+    tx->fec_group = fec_size(fec_group);
+    tx->emit = emit;
+    tx->user_data = user_data;
+    tx->sock = SOCKET_INVALID;
+    return tx;
+}
+
+relay_mcast_tx_t *relay_mcast_tx_open(const char *group, int port, const char *iface, int ttl,
+                                      uint32_t sample_rate, int fec_group) {
+    if (!group) return NULL;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, group, &addr.sin_addr) != 1) {
+        fprintf(stderr, "[MCAST] Invalid group address: %s\n", group);
+        return NULL;
+    }
+
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return NULL;
+#endif
+
+    socket_t sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == SOCKET_INVALID) goto fail;
+
+    int opt = ttl;
+    setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL, (const char *)&opt, sizeof(opt));
+    opt = 1;                                /* Receivers on this host too */
+    setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, (const char *)&opt, sizeof(opt));
+    opt = SEND_SOCKET_BUFFER;
+    setsockopt(sock, SOL_SOCKET, SO_SNDBUF, (const char *)&opt, sizeof(opt));
+
+    if (iface && iface[0]) {
+        struct in_addr local;
+        if (inet_pton(AF_INET, iface, &local) != 1 ||
+            setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF, (const char *)&local, sizeof(local)) != 0) {
+            fprintf(stderr, "[MCAST] Cannot send from interface %s\n", iface);
+            socket_close(sock);
+            goto fail;
+        }
+    }
+
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        socket_close(sock);
+        goto fail;
+    }
+
+    relay_mcast_tx_t *tx = relay_mcast_tx_create(sample_rate, fec_group, socket_emit, NULL);
+    if (!tx) {
+        socket_close(sock);
+        goto fail;
+    }
+    tx->user_data = tx;
+    tx->sock = sock;
+    return tx;
+
+fail:
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return NULL;
+}
+
+void relay_mcast_tx_destroy(relay_mcast_tx_t *tx) {
+    if (!tx) return;
+    if (tx->sock != SOCKET_INVALID) {
+        socket_close(tx->sock);
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+    free(tx);
+}
+
+void relay_mcast_tx_frame(relay_mcast_tx_t *tx, uint32_t frame_seq,
+                          const float *iq, uint32_t num_samples) {
+    if (!tx || !iq || num_samples == 0 || num_samples > RELAY_MCAST_MAX_FRAME) return;
+
+    uint8_t *body = tx->packet + RELAY_MCAST_HEADER_BYTES;
+
+    for (uint32_t offset = 0; offset < num_samples; ) {
+        uint32_t count = num_samples - offset;
+        if (count > RELAY_MCAST_PAIRS_PER_PACKET) count = RELAY_MCAST_PAIRS_PER_PACKET;
+        size_t body_len = CHUNK_BYTES + (size_t)count * 8;
+
+        relay_mcast_chunk_t chunk = { frame_seq, num_samples, offset, count };
+        memcpy(body, &chunk, sizeof(chunk));
+        memcpy(body + CHUNK_BYTES, iq + (size_t)offset * 2, (size_t)count * 8);
+        put_header(tx->packet, RELAY_MCAST_DATA, (uint8_t)tx->fec_group, body_len,
+                   tx->seq, tx->sample_rate);
+        emit_packet(tx, body_len);
+        tx->stats.data_packets++;
+        tx->seq++;
+        offset += count;
+
+        if (tx->fec_group == 0) continue;
+
+        xor_into(tx->parity, body, body_len);
+        if (body_len > tx->parity_len) tx->parity_len = body_len;
+        if (++tx->group_count == tx->fec_group) {
+            memcpy(body, tx->parity, tx->parity_len);
+            put_header(tx->packet, RELAY_MCAST_PARITY, (uint8_t)tx->fec_group, tx->parity_len,
+                       tx->seq - (uint32_t)tx->fec_group, tx->sample_rate);
+            emit_packet(tx, tx->parity_len);
+            tx->stats.parity_packets++;
+            memset(tx->parity, 0, tx->parity_len);
+            tx->parity_len = 0;
+            tx->group_count = 0;
+        }
+    }
+    tx->stats.frames++;
+}
+
+void relay_mcast_tx_beacon(relay_mcast_tx_t *tx) {
+    if (!tx) return;
+    relay_mcast_beacon_t b;
+    b.ft32_magic = FT32_MAGIC;
+    b.sample_rate = tx->sample_rate;
+    b.version = RELAY_MCAST_VERSION;
+    b.frames_sent = (uint32_t)tx->stats.frames;
+    memcpy(tx->packet + RELAY_MCAST_HEADER_BYTES, &b, sizeof(b));
+    put_header(tx->packet, RELAY_MCAST_BEACON, (uint8_t)tx->fec_group, sizeof(b),
+               tx->seq, tx->sample_rate);
+    emit_packet(tx, sizeof(b));
+    tx->stats.beacons++;
+}
+
+void relay_mcast_tx_set_rate(relay_mcast_tx_t *tx, uint32_t sample_rate) {
+    if (tx) tx->sample_rate = sample_rate;
+}
+
+void relay_mcast_tx_get_stats(const relay_mcast_tx_t *tx, relay_mcast_tx_stats_t *stats) {
+    if (!tx || !stats) return;
+    *stats = tx->stats;
+}
+
+/*============================================================================
+ * Receiver
+ *============================================================================*/
+
+typedef struct {
+    bool used;
+    uint32_t frame_seq;
+    uint32_t num_samples;
+    uint32_t received;
+    uint32_t min_seq;                       /* First DATA packet of this frame seen */
+    bool have_bound;
+    uint32_t bound_seq;                     /* Last packet this frame can have used */
+    float *iq;
+    uint32_t cap;
+} rx_slot_t;
+
+typedef struct {
+    bool used;
+    uint32_t base;
+    int size;
+    uint32_t have;                          /* Bit per DATA packet in the group */
+    uint8_t acc[RELAY_MCAST_MAX_BODY];      /* XOR of received bodies */
+    bool have_parity;
+    size_t parity_len;
+    uint8_t parity[RELAY_MCAST_MAX_BODY];
+} rx_group_t;
+
+struct relay_mcast_rx {
+    rx_slot_t slots[RX_SLOTS];
+    rx_group_t groups[RX_GROUPS];
+    uint32_t seen[RX_SEEN];                 /* seq + 1 per slot, 0 = empty */
+
+    int fec;                                /* fec_group of the latest packet */
+    bool have_highest;
+    uint32_t highest_seq;                   /* Newest DATA packet received */
+    bool have_next;
+    uint32_t next;                          /* Next frame to release */
+
+    uint32_t sample_rate;
+    relay_mcast_rx_stats_t stats;
+};
+
+static bool seq_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+/* DATA seq by which the parity covering 'bound' has had a group's grace to arrive */
+static uint32_t release_point(uint32_t bound, int fec) {
+    if (fec == 0) return bound + 1 + RX_REORDER;
+    return (bound | (uint32_t)(fec - 1)) + 1 + (uint32_t)fec;
+}
+
+static bool seq_reached(const relay_mcast_rx_t *rx, uint32_t point) {
+    return rx->have_highest && !seq_before(rx->highest_seq, point);
+}
+
+static void rx_clear(relay_mcast_rx_t *rx) {
+    for (int i = 0; i < RX_SLOTS; i++) rx->slots[i].used = false;
+    for (int i = 0; i < RX_GROUPS; i++) rx->groups[i].used = false;
+    memset(rx->seen, 0, sizeof(rx->seen));
+    rx->have_highest = false;
+    rx->have_next = false;
+}
+
+static int popcount32(uint32_t v) {
+    int n = 0;
+    while (v) {
+        v &= v - 1;
+        n++;
+    }
+    return n;
+}
+
+static void place_chunk(relay_mcast_rx_t *rx, uint32_t seq, const uint8_t *body, size_t len) {
+    relay_mcast_chunk_t c;
+    if (len < (size_t)CHUNK_BYTES) {
+        rx->stats.invalid++;
+        return;
+    }
+    memcpy(&c, body, sizeof(c));
+    if (c.count == 0 || c.count > RELAY_MCAST_PAIRS_PER_PACKET ||
+        c.frame_samples == 0 || c.frame_samples > RELAY_MCAST_MAX_FRAME ||
+        c.offset > c.frame_samples - c.count || len != CHUNK_BYTES + (size_t)c.count * 8) {
+        rx->stats.invalid++;
+        return;
+    }
+
+    /* Output starts at the first frame whose opening chunk arrives; chunks
+     * seen before that are kept in case they belong to it (reordering) */
+    if (!rx->have_next && c.offset == 0) {
+        rx->have_next = true;
+        rx->next = c.frame_seq;
+        for (int i = 0; i < RX_SLOTS; i++) {
+            if (rx->slots[i].used && seq_before(rx->slots[i].frame_seq, rx->next)) {
+                rx->slots[i].used = false;  /* Joined mid-frame */
+            }
+        }
+    }
+    if (rx->have_next && seq_before(c.frame_seq, rx->next)) {
+        rx->stats.late++;
+        return;
+    }
+
+    rx_slot_t *s = &rx->slots[c.frame_seq % RX_SLOTS];
+    if (!s->used || s->frame_seq != c.frame_seq) {
+        if (s->used) {
+            /* Window overrun: the older frame never completed and is dropped */
+            rx->stats.samples_lost += s->num_samples;
+        }
+        if (c.frame_samples > s->cap) {
+            float *p = (float *)realloc(s->iq, (size_t)c.frame_samples * 2 * sizeof(float));
+            if (!p) return;
+            s->iq = p;
+            s->cap = c.frame_samples;
+        }
+        memset(s->iq, 0, (size_t)c.frame_samples * 2 * sizeof(float));
+        s->used = true;
+        s->frame_seq = c.frame_seq;
+        s->num_samples = c.frame_samples;
+        s->received = 0;
+        s->min_seq = seq;
+        s->have_bound = false;
+    } else if (s->num_samples != c.frame_samples) {
+        rx->stats.invalid++;
+        return;
+    }
+
+    memcpy(s->iq + (size_t)c.offset * 2, body + CHUNK_BYTES, (size_t)c.count * 8);
+    s->received += c.count;
+    if (seq_before(seq, s->min_seq)) s->min_seq = seq;
+
+    /* Frames before this one sent nothing after seq - 1 */
+    for (int i = 0; i < RX_SLOTS; i++) {
+        rx_slot_t *o = &rx->slots[i];
+        if (!o->used || !seq_before(o->frame_seq, c.frame_seq)) continue;
+        if (!o->have_bound || seq_before(seq - 1, o->bound_seq)) {
+            o->bound_seq = seq - 1;
+            o->have_bound = true;
+        }
+    }
+}
+
+/* A DATA body arrived or was rebuilt; rebuilt ones skip the parity bookkeeping */
+static void on_data(relay_mcast_rx_t *rx, uint32_t seq, int fec, const uint8_t *body,
+                    size_t len, bool rebuilt);
+
+static void try_recover(relay_mcast_rx_t *rx, rx_group_t *g) {
+    if (!g->have_parity || popcount32(g->have) != g->size - 1) return;
+
+    int missing = 0;
+    while (g->have & (1u << missing)) missing++;
+    g->have |= 1u << missing;
+
+    uint8_t body[RELAY_MCAST_MAX_BODY];
+    memcpy(body, g->parity, g->parity_len);
+    xor_into(body, g->acc, g->parity_len);
+
+    relay_mcast_chunk_t chunk;
+    memcpy(&chunk, body, sizeof(chunk));
+    size_t len = CHUNK_BYTES + (size_t)chunk.count * 8;
+    if (chunk.count > RELAY_MCAST_PAIRS_PER_PACKET || len > g->parity_len) {
+        rx->stats.invalid++;
+        return;
+    }
+
+    rx->stats.recovered++;
+    on_data(rx, g->base + (uint32_t)missing, g->size, body, len, true);
+}
+
+static rx_group_t *find_group(relay_mcast_rx_t *rx, uint32_t base, int size) {
+    rx_group_t *g = &rx->groups[(base / (uint32_t)size) % RX_GROUPS];
+    if (!g->used || g->base != base || g->size != size) {
+        g->used = true;
+        g->base = base;
+        g->size = size;
+        g->have = 0;
+        g->have_parity = false;
+        memset(g->acc, 0, sizeof(g->acc));
+    }
+    return g;
+}
+
+static void on_data(relay_mcast_rx_t *rx, uint32_t seq, int fec, const uint8_t *body,
+                    size_t len, bool rebuilt) {
+    uint32_t *seen = &rx->seen[seq % RX_SEEN];
+    if (*seen == seq + 1) {
+        rx->stats.duplicates++;
+        return;
+    }
+    *seen = seq + 1;
+
+    if (!rebuilt) {
+        if (rx->have_highest && seq_before(rx->highest_seq, seq - RX_RESYNC_PACKETS)) {
+            rx_clear(rx);                   /* Long outage: old frames are stale */
+        } else if (rx->have_highest && seq_before(seq, rx->highest_seq - RX_RESYNC_PACKETS)) {
+            rx_clear(rx);                   /* Sender restarted its sequence */
+        }
+        if (!rx->have_highest || seq_before(rx->highest_seq, seq)) {
+            rx->highest_seq = seq;
+            rx->have_highest = true;
+        }
+        *seen = seq + 1;
+    }
+
+    place_chunk(rx, seq, body, len);
+
+    if (fec > 0 && !rebuilt) {
+        rx_group_t *g = find_group(rx, seq & ~(uint32_t)(fec - 1), fec);
+        xor_into(g->acc, body, len);
+        g->have |= 1u << (seq - g->base);
+        try_recover(rx, g);
+    }
+}
+
+relay_mcast_rx_t *relay_mcast_rx_create(void) {
+    return (relay_mcast_rx_t *)calloc(1, sizeof(relay_mcast_rx_t));
+}
+
+void relay_mcast_rx_destroy(relay_mcast_rx_t *rx) {
+    if (!rx) return;
+    for (int i = 0; i < RX_SLOTS; i++) free(rx->slots[i].iq);
+    free(rx);
+}
+
+void relay_mcast_rx_reset(relay_mcast_rx_t *rx) {
+    if (rx) rx_clear(rx);
+}
+
+bool relay_mcast_rx_push(relay_mcast_rx_t *rx, const uint8_t *packet, size_t len) {
+    if (!rx || !packet) return false;
+
+    relay_mcast_header_t h;
+    if (len < (size_t)RELAY_MCAST_HEADER_BYTES) {
+        rx->stats.invalid++;
+        return false;
+    }
+    memcpy(&h, packet, sizeof(h));
+    const uint8_t *body = packet + RELAY_MCAST_HEADER_BYTES;
+    int fec = fec_size(h.fec_group);
+    if (h.magic != RELAY_MCAST_MAGIC || h.length != len - RELAY_MCAST_HEADER_BYTES ||
+        h.length > RELAY_MCAST_MAX_BODY || fec != h.fec_group) {
+        rx->stats.invalid++;
+        return false;
+    }
+
+    rx->stats.packets++;
+    rx->sample_rate = h.sample_rate;
+    rx->fec = fec;
+
+    switch (h.type) {
+        case RELAY_MCAST_DATA:
+            on_data(rx, h.seq, fec, body, h.length, false);
+            return true;
+
+        case RELAY_MCAST_PARITY: {
+            if (fec == 0 || (h.seq & (uint32_t)(fec - 1)) != 0) break;
+            rx_group_t *g = find_group(rx, h.seq, fec);
+            if (g->have_parity) {
+                rx->stats.duplicates++;
+                return true;
+            }
+            g->have_parity = true;
+            g->parity_len = h.length;
+            memcpy(g->parity, body, h.length);
+            try_recover(rx, g);
+            return true;
+        }
+
+        case RELAY_MCAST_BEACON:
+            rx->stats.beacons++;
+            return true;
+
+        default:
+            break;
+    }
+    rx->stats.invalid++;
+    return false;
+}
+
+bool relay_mcast_rx_pop(relay_mcast_rx_t *rx, relay_mcast_frame_t *frame) {
+    if (!rx || !frame) return false;
+
+    while (rx->have_next) {
+        rx_slot_t *s = &rx->slots[rx->next % RX_SLOTS];
+
+        if (s->used && s->frame_seq == rx->next) {
+            bool complete = s->received >= s->num_samples;
+            if (!complete && !(s->have_bound && seq_reached(rx, release_point(s->bound_seq, rx->fec)))) {
+                return false;               /* Parity may still repair it */
+            }
+            uint32_t lost = complete ? 0 : s->num_samples - s->received;
+            frame->frame_seq = s->frame_seq;
+            frame->num_samples = s->num_samples;
+            frame->samples_lost = lost;
+            frame->iq = s->iq;
+            s->used = false;
+            rx->next++;
+            rx->stats.frames++;
+            if (lost) {
+                rx->stats.frames_partial++;
+                rx->stats.samples_lost += lost;
+            }
+            return true;
+        }
+
+        /* Nothing of this frame yet: skip to the oldest later frame once
+         * no parity can still bring back packets from before it */
+        rx_slot_t *oldest = NULL;
+        for (int i = 0; i < RX_SLOTS; i++) {
+            rx_slot_t *o = &rx->slots[i];
+            if (o->used && (!oldest || seq_before(o->frame_seq, oldest->frame_seq))) oldest = o;
+        }
+        if (!oldest || !seq_reached(rx, release_point(oldest->min_seq - 1, rx->fec))) return false;
+        rx->next = oldest->frame_seq;
+    }
+    return false;
+}
+
+uint32_t relay_mcast_rx_sample_rate(const relay_mcast_rx_t *rx) {
+    return rx ? rx->sample_rate : 0;
+}
+
+void relay_mcast_rx_get_stats(const relay_mcast_rx_t *rx, relay_mcast_rx_stats_t *stats) {
+    if (!rx || !stats) return;
+    *stats = rx->stats;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file rtl_tcp.c
+ * @brief rtl_tcp wire protocol support for sdr_server
+ *
+ * Protocol reference: librtlsdr rtl_tcp.c (dongle_info_t, command_t).
+ * All multi-byte fields on the wire are big-endian.
+ */
+
+#include "rtl_tcp.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RTL_TCP_USE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RTL_TCP_USE_NEON 1
+#endif
+
+/*============================================================================
+ * Gain Table
+ *============================================================================*/
+
+/* R820T gain steps in tenths of dB - what clients index with SET_GAIN_BY_INDEX */
+static const int g_r820t_gains[RTL_TCP_GAIN_COUNT] = {
+    0, 9, 14, 27, 37, 77, 87, 125, 144, 157, 166, 197, 207, 229, 254,
+    280, 297, 328, 338, 364, 372, 386, 402, 421, 434, 439, 445, 480, 496
+};
+
+#define RTL_TCP_MAX_GAIN_TENTHS 496
+#define RSP_GR_MIN              20
+#define RSP_GR_MAX              59
+
+/*============================================================================
+ * Helpers
+ *============================================================================*/
+
+static void put_be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static uint32_t get_be32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static uint8_t s16_to_u8(int16_t s) {
+    int v = ((int)s + 128) >> 8;        /* Round to nearest */
+    if (v > 127) v = 127;               /* Only 32640..32767 overflow */
+    return (uint8_t)(v + 128);
+}
+
+/*============================================================================
+ * Protocol Functions
+ *============================================================================*/
+
+void rtl_tcp_build_header(uint8_t header[RTL_TCP_HEADER_SIZE]) {
+    memcpy(header, "RTL0", 4);
+    put_be32(header + 4, RTL_TCP_TUNER_R820T);
+    put_be32(header + 8, RTL_TCP_GAIN_COUNT);
+}
+
+int rtl_tcp_gain_to_reduction(int tenth_db) {
+    if (tenth_db < 0) tenth_db = 0;
+    if (tenth_db > RTL_TCP_MAX_GAIN_TENTHS) tenth_db = RTL_TCP_MAX_GAIN_TENTHS;
+
+    /* Linear map: 0 dB tuner gain = max reduction, full gain = min reduction */
+    int span = RSP_GR_MAX - RSP_GR_MIN;
+    return RSP_GR_MAX - (tenth_db * span + RTL_TCP_MAX_GAIN_TENTHS / 2) / RTL_TCP_MAX_GAIN_TENTHS;
+}
+
+const char *rtl_tcp_cmd_name(uint8_t cmd) {
+    switch (cmd) {
+        case RTL_CMD_SET_FREQ:            return "SET_FREQ";
+        case RTL_CMD_SET_SAMPLE_RATE:     return "SET_SAMPLE_RATE";
+        case RTL_CMD_SET_GAIN_MODE:       return "SET_GAIN_MODE";
+        case RTL_CMD_SET_GAIN:            return "SET_GAIN";
+        case RTL_CMD_SET_FREQ_CORRECTION: return "SET_FREQ_CORRECTION";
+        case RTL_CMD_SET_IF_GAIN:         return "SET_IF_GAIN";
+        case RTL_CMD_SET_TEST_MODE:       return "SET_TEST_MODE";
+        case RTL_CMD_SET_AGC_MODE:        return "SET_AGC_MODE";
+        case RTL_CMD_SET_DIRECT_SAMPLING: return "SET_DIRECT_SAMPLING";
+        case RTL_CMD_SET_OFFSET_TUNING:   return "SET_OFFSET_TUNING";
+        case RTL_CMD_SET_RTL_XTAL:        return "SET_RTL_XTAL";
+        case RTL_CMD_SET_TUNER_XTAL:      return "SET_TUNER_XTAL";
+        case RTL_CMD_SET_GAIN_BY_INDEX:   return "SET_GAIN_BY_INDEX";
+        case RTL_CMD_SET_BIAS_TEE:        return "SET_BIAS_TEE";
+        default:                          return "UNKNOWN";
+    }
+}
+
+tcp_error_t rtl_tcp_map_command(const uint8_t pkt[RTL_TCP_CMD_SIZE], tcp_command_t *cmd) {
+    if (!pkt || !cmd) {
+        return TCP_ERR_SYNTAX;
+    }
+
+    uint32_t param = get_be32(pkt + 1);
+    char line[TCP_MAX_LINE_LENGTH];
+
+    switch (pkt[0]) {
+        case RTL_CMD_SET_FREQ:
+            snprintf(line, sizeof(line), "SET_FREQ %u", param);
+            break;
+
+        case RTL_CMD_SET_SAMPLE_RATE:
+            snprintf(line, sizeof(line), "SET_SRATE %u", param);
+            break;
+
+        case RTL_CMD_SET_GAIN_MODE:
+            /* Tuner AGC on auto, hardware AGC off for manual gain */
+            snprintf(line, sizeof(line), "SET_AGC %s", param ? "OFF" : "50HZ");
+            break;
+
+        case RTL_CMD_SET_GAIN:
+            snprintf(line, sizeof(line), "SET_GAIN %d", rtl_tcp_gain_to_reduction((int)param));
+            break;
+
+        case RTL_CMD_SET_GAIN_BY_INDEX:
+            if (param >= RTL_TCP_GAIN_COUNT) {
+                return TCP_ERR_RANGE;
+            }
+            snprintf(line, sizeof(line), "SET_GAIN %d",
+                     rtl_tcp_gain_to_reduction(g_r820t_gains[param]));
+            break;
+
+        case RTL_CMD_SET_BIAS_TEE:
+            /* The client asked explicitly - this is the CONFIRM */
+            snprintf(line, sizeof(line), "SET_BIAST %s", param ? "ON CONFIRM" : "OFF");
+            break;
+
+        default:
+            /* Frequency correction, IF gain, xtal, direct sampling, etc.
+             * have no RSP equivalent */
+            memset(cmd, 0, sizeof(*cmd));
+            return TCP_ERR_UNKNOWN;
+    }
+
+    return tcp_parse_command(line, cmd);
+}
+
+/*============================================================================
+ * Sample Conversion
+ *============================================================================*/
+
+void rtl_tcp_convert_s16_u8_scalar(const int16_t *xi, const int16_t *xq, uint8_t *out, size_t count) {
+    for (size_t n = 0; n < count; n++) {
+        out[2 * n] = s16_to_u8(xi[n]);
+        out[2 * n + 1] = s16_to_u8(xq[n]);
+    }
+}
+
+void rtl_tcp_convert_s16_u8(const int16_t *xi, const int16_t *xq, uint8_t *out, size_t count) {
+    size_t n = 0;
+
+#if defined(RTL_TCP_USE_SSE2)
+    const __m128i round = _mm_set1_epi16(128);
+    const __m128i offset = _mm_set1_epi8((char)0x80);
+    for (; n + 16 <= count; n += 16) {
+        __m128i i0 = _mm_loadu_si128((const __m128i *)(xi + n));
+        __m128i i1 = _mm_loadu_si128((const __m128i *)(xi + n + 8));
+        __m128i q0 = _mm_loadu_si128((const __m128i *)(xq + n));
+        __m128i q1 = _mm_loadu_si128((const __m128i *)(xq + n + 8));
+
+        /* Saturating round, arithmetic shift to 8 bits, pack with saturation */
+        i0 = _mm_srai_epi16(_mm_adds_epi16(i0, round), 8);
+        i1 = _mm_srai_epi16(_mm_adds_epi16(i1, round), 8);
+        q0 = _mm_srai_epi16(_mm_adds_epi16(q0, round), 8);
+        q1 = _mm_srai_epi16(_mm_adds_epi16(q1, round), 8);
+        __m128i i8 = _mm_packs_epi16(i0, i1);
+        __m128i q8 = _mm_packs_epi16(q0, q1);
+
+        /* Interleave and flip sign bit: two's complement -> offset binary */
+        __m128i lo = _mm_xor_si128(_mm_unpacklo_epi8(i8, q8), offset);
+        __m128i hi = _mm_xor_si128(_mm_unpackhi_epi8(i8, q8), offset);
+        _mm_storeu_si128((__m128i *)(out + 2 * n), lo);
+        _mm_storeu_si128((__m128i *)(out + 2 * n + 16), hi);
+    }
+#elif defined(RTL_TCP_USE_NEON)
+    const int16x8_t round = vdupq_n_s16(128);
+    const uint8x16_t offset = vdupq_n_u8(0x80);
+    for (; n + 16 <= count; n += 16) {
+        int16x8_t i0 = vqaddq_s16(vld1q_s16(xi + n), round);
+        int16x8_t i1 = vqaddq_s16(vld1q_s16(xi + n + 8), round);
+        int16x8_t q0 = vqaddq_s16(vld1q_s16(xq + n), round);
+        int16x8_t q1 = vqaddq_s16(vld1q_s16(xq + n + 8), round);
+
+        uint8x16x2_t iq;
+        iq.val[0] = veorq_u8(vreinterpretq_u8_s8(vcombine_s8(vshrn_n_s16(i0, 8), vshrn_n_s16(i1, 8))), offset);
+        iq.val[1] = veorq_u8(vreinterpretq_u8_s8(vcombine_s8(vshrn_n_s16(q0, 8), vshrn_n_s16(q1, 8))), offset);
+        vst2q_u8(out + 2 * n, iq);
+    }
+#endif
+
+    rtl_tcp_convert_s16_u8_scalar(xi + n, xq + n, out + 2 * n, count - n);
+}
@@ -25,6 +25,26 @@ struct psdr_context {
     double                      actual_sample_rate;
 };
 
+/* sdrplay_api_Open/Close are per process: with several devices open (and
+ * psdr_enumerate() called in between), the API stays open until the last
+ * user closes it. Opens and closes come from one thread. */
+static int g_api_users = 0;
+
+static sdrplay_api_ErrT api_acquire(void) {
+    if (g_api_users == 0) {
+        sdrplay_api_ErrT err = sdrplay_api_Open();
+        if (err != sdrplay_api_Success) return err;
+    }
+    g_api_users++;
+    return sdrplay_api_Success;
+}
+
+static void api_release(void) {
+    if (g_api_users > 0 && --g_api_users == 0) {
+        sdrplay_api_Close();
+    }
+}
+
 /*============================================================================
  * Error String Table
  *============================================================================*/
@@ -98,7 +118,7 @@ psdr_error_t psdr_enumerate(
     if (num_found) *num_found = 0;
 
     /* Open API */
-    err = sdrplay_api_Open();
+    err = api_acquire();
     if (err != sdrplay_api_Success) {
         fprintf(stderr, "psdr_enumerate: sdrplay_api_Open failed: %s\n",
                 sdrplay_api_GetErrorString(err));
@@ -108,7 +128,7 @@ psdr_error_t psdr_enumerate(
     /* Check API version */
     err = sdrplay_api_ApiVersion(&api_ver);
     if (err != sdrplay_api_Success) {
-        sdrplay_api_Close();
+        api_release();
         return PSDR_ERR_API_VERSION;
     }
 
@@ -119,7 +139,7 @@ psdr_error_t psdr_enumerate(
     if (err != sdrplay_api_Success) {
         fprintf(stderr, "psdr_enumerate: GetDevices failed: %s\n",
                 sdrplay_api_GetErrorString(err));
-        sdrplay_api_Close();
+        api_release();
         return PSDR_ERR_NO_DEVICES;
     }
 
@@ -141,7 +161,7 @@ psdr_error_t psdr_enumerate(
         }
     }
 
-    sdrplay_api_Close();
+    api_release();
     return PSDR_OK;
 }
 
@@ -149,7 +169,8 @@ psdr_error_t psdr_enumerate(
  * Open / Close
  *============================================================================*/
 
-psdr_error_t psdr_open(psdr_context_t **ctx, unsigned int device_idx) {
+/* Select by list index, or by serial number when serial is not NULL */
+static psdr_error_t open_device(psdr_context_t **ctx, unsigned int device_idx, const char *serial) {
     sdrplay_api_ErrT err;
     sdrplay_api_DeviceT dev_list[SDRPLAY_MAX_DEVICES];
     unsigned int ndev = 0;
@@ -161,7 +182,7 @@ psdr_error_t psdr_open(psdr_context_t **ctx, unsigned int device_idx) {
     if (!c) return PSDR_ERR_UNKNOWN;
 
     /* Open API */
-    err = sdrplay_api_Open();
+    err = api_acquire();
     if (err != sdrplay_api_Success) {
         free(c);
         return PSDR_ERR_API_OPEN;
@@ -175,14 +196,20 @@ psdr_error_t psdr_open(psdr_context_t **ctx, unsigned int device_idx) {
     err = sdrplay_api_GetDevices(dev_list, &ndev, SDRPLAY_MAX_DEVICES);
     if (err != sdrplay_api_Success || ndev == 0) {
         sdrplay_api_UnlockDeviceApi();
-        sdrplay_api_Close();
+        api_release();
         free(c);
         return PSDR_ERR_NO_DEVICES;
     }
 
+    if (serial) {
+        for (device_idx = 0; device_idx < ndev; device_idx++) {
+            if (strcmp(dev_list[device_idx].SerNo, serial) == 0) break;
+        }
+    }
+
     if (device_idx >= ndev) {
         sdrplay_api_UnlockDeviceApi();
-        sdrplay_api_Close();
+        api_release();
         free(c);
         return PSDR_ERR_INVALID_ARG;
     }
@@ -196,7 +223,7 @@ psdr_error_t psdr_open(psdr_context_t **ctx, unsigned int device_idx) {
         fprintf(stderr, "psdr_open: SelectDevice failed: %s\n",
                 sdrplay_api_GetErrorString(err));
         sdrplay_api_UnlockDeviceApi();
-        sdrplay_api_Close();
+        api_release();
         free(c);
         return PSDR_ERR_DEVICE_SELECT;
     }
@@ -211,7 +238,7 @@ psdr_error_t psdr_open(psdr_context_t **ctx, unsigned int device_idx) {
         fprintf(stderr, "psdr_open: GetDeviceParams failed: %s\n",
                 sdrplay_api_GetErrorString(err));
         sdrplay_api_ReleaseDevice(&c->device);
-        sdrplay_api_Close();
+        api_release();
         free(c);
         return PSDR_ERR_DEVICE_PARAMS;
     }
@@ -225,6 +252,15 @@ psdr_error_t psdr_open(psdr_context_t **ctx, unsigned int device_idx) {
     return PSDR_OK;
 }
 
+psdr_error_t psdr_open(psdr_context_t **ctx, unsigned int device_idx) {
+    return open_device(ctx, device_idx, NULL);
+}
+
+psdr_error_t psdr_open_serial(psdr_context_t **ctx, const char *serial) {
+    if (!serial) return PSDR_ERR_INVALID_ARG;
+    return open_device(ctx, 0, serial);
+}
+
 void psdr_close(psdr_context_t *ctx) {
     if (!ctx) return;
 
@@ -240,7 +276,7 @@ void psdr_close(psdr_context_t *ctx) {
 
     /* Close API */
     if (ctx->api_open) {
-        sdrplay_api_Close();
+        api_release();
     }
 
     free(ctx);
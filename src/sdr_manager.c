@@ -0,0 +1,1023 @@
+/**
+ * @file sdr_manager.c
+ * @brief Several receivers in one process
+ *
+ * One thread per device does everything downstream of the backend: accept
+ * on its two ports, make or collect a block of samples, send the raw frame,
+ * decimate, send the decimated frame, call the sink. Devices share nothing
+ * but the manager's table, so a slow sink holds up its own device only. A
+ * client that stops reading is dropped after a bounded send wait.
+ *
+ * RSP samples arrive on the SDRplay API thread and go through a
+ * single-producer ring; the callback never blocks or locks. Tone and
+ * replay samples are made on the device thread, paced by the clock or as
+ * fast as the thread runs.
+ *
+ * Commands run under the device lock against its tcp_sdr_state_t, exactly
+ * as sdr_server runs them. The device thread takes the lock once per block
+ * to copy out what the stream headers need.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE             /* pthread_setaffinity_np, CPU_SET */
+#endif
+
+#include "sdr_manager.h"
+#include "iq_recorder.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <pthread.h>
+typedef SOCKET socket_t;
+typedef int socklen_t;
+#define SOCKET_INVALID INVALID_SOCKET
+#define socket_close closesocket
+#define SEND_FLAGS 0
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <sched.h>
+#include <time.h>
+typedef int socket_t;
+#define SOCKET_INVALID (-1)
+#define socket_close close
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*============================================================================
+ * Wire Format (as sdr_server, docs/SDR_IQ_STREAMING_INTERFACE.md)
+ *============================================================================*/
+
+#define IQ_MAGIC_HEADER     0x50485849      /* "PHXI" */
+#define IQ_MAGIC_DATA       0x49514451      /* "IQDQ" */
+#define IQ_MAGIC_META       0x4D455441      /* "META" */
+
+#define IQ_FORMAT_S16       1
+#define IQ_FORMAT_F32       2
+
+#define IQ_FLAG_OVERLOAD    (1 << 0)
+
+#pragma pack(push, 1)
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sample_rate;
+    uint32_t sample_format;
+    uint32_t center_freq_lo;
+    uint32_t center_freq_hi;
+    uint32_t gain_reduction;
+    uint32_t lna_state;
+} phxi_header_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t sequence;
+    uint32_t num_samples;
+    uint32_t flags;
+} iqdq_header_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t sample_rate;
+    uint32_t sample_format;
+    uint32_t center_freq_lo;
+    uint32_t center_freq_hi;
+    uint32_t gain_reduction;
+    uint32_t lna_state;
+    uint32_t reserved;
+} meta_update_t;
+#pragma pack(pop)
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+#define DECIM_INPUT_HZ      2000000         /* The one rate decimator.h takes */
+#define DECIM_OUT_MAX       1024            /* Per block: 8192 / 41.7, with room */
+#define TONE_AMPLITUDE      16000.0
+#define PACE_MAX_LAG_US     100000          /* Further behind than this: restart the clock */
+#define BATCH_MS            5               /* Smallest block, unless a full one is ready sooner */
+#define IDLE_SLEEP_MS       1
+#define PORT_SNDBUF         (1 << 20)   /* ~0.25 s of raw S16 at 2 MSPS */
+#define PORT_SEND_TIMEOUT_MS 100        /* Longer than this and the client is dropped */
+
+enum { PORT_RAW = 0, PORT_DECIM = 1 };
+
+typedef struct {
+    socket_t listener;
+    socket_t client;
+    int      port;                  /* Bound port, SDR_PORT_NONE */
+    uint32_t format;
+    uint32_t sequence;
+    atomic_bool attached;           /* client, for other threads */
+} stream_port_t;
+
+/* What the stream headers need, copied under the lock once per block */
+typedef struct {
+    bool   streaming;
+    int    sample_rate;
+    double freq_hz;
+    int    gain_reduction;
+    int    lna_state;
+} snapshot_t;
+
+typedef struct {
+    sdr_manager_t *mgr;
+    int number;
+    sdr_device_spec_t spec;
+    char serial[64];
+
+    pthread_mutex_t lock;           /* state */
+    tcp_sdr_state_t state;
+
+    /* RSP: SDRplay callback -> device thread, interleaved pairs */
+    int16_t *ring;
+    atomic_uint_fast64_t ring_write;
+    atomic_uint_fast64_t ring_read;
+    atomic_uint_fast64_t overruns;
+    atomic_bool reset_pending;
+    atomic_bool overload;
+
+    /* Tone / replay */
+    iqr_reader_t *replay;
+    int replay_rate;
+    double tone_phase;
+    uint64_t pace_start_us;
+    uint64_t pace_samples;
+
+    decim_state_t *decim;
+    decim_complex_t *decim_out;
+
+    int16_t *xi;                    /* Current block */
+    int16_t *xq;
+    uint8_t *wire;                  /* Frame being sent */
+
+    stream_port_t ports[2];
+
+    pthread_t thread;
+    bool thread_started;
+    atomic_bool running;
+    atomic_bool pinned;
+
+    atomic_uint_fast64_t samples;
+    atomic_uint_fast64_t decim_samples;
+    atomic_uint_fast64_t frames;
+    atomic_uint replay_loops;
+} sdr_device_t;
+
+struct sdr_manager {
+    sdr_device_t *devices[SDR_MANAGER_MAX_DEVICES];
+    int count;
+};
+
+static const char *const g_backend_names[] = { "HW", "TONE", "REPLAY" };
+
+/*============================================================================
+ * Platform Helpers
+ *============================================================================*/
+
+static uint64_t now_us(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (uint64_t)(count.QuadPart / freq.QuadPart) * 1000000 +
+           (uint64_t)(count.QuadPart % freq.QuadPart) * 1000000 / (uint64_t)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)(ts.tv_nsec / 1000);
+#endif
+}
+
+static void sleep_ms(int ms) {
+#ifdef _WIN32
+    Sleep((DWORD)ms);
+#else
+    struct timespec ts = { ms / 1000, (long)(ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+/* Pin the calling thread; false where the platform or the core refuses */
+static bool pin_to_core(int core) {
+#if defined(_WIN32)
+    if (core < 0 || core >= (int)(sizeof(DWORD_PTR) * 8)) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core) != 0;
+#elif defined(__linux__)
+    if (core < 0 || core >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+
+static int strcasecmp_local(const char *a, const char *b) {
+    while (*a && *b) {
+        int d = toupper((unsigned char)*a) - toupper((unsigned char)*b);
+        if (d != 0) return d;
+        a++;
+        b++;
+    }
+    return toupper((unsigned char)*a) - toupper((unsigned char)*b);
+}
+
+/*============================================================================
+ * Ports
+ *============================================================================*/
+
+static void port_init(stream_port_t *p, uint32_t format) {
+    p->listener = SOCKET_INVALID;
+    p->client = SOCKET_INVALID;
+    p->port = SDR_PORT_NONE;
+    p->format = format;
+    p->sequence = 0;
+    atomic_init(&p->attached, false);
+}
+
+static bool port_open(stream_port_t *p, int port) {
+    if (port == SDR_PORT_NONE) return true;
+
+    socket_t s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == SOCKET_INVALID) return false;
+
+    int reuse = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+    socklen_t len = sizeof(addr);
+
+    if (bind(s, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(s, 1) != 0 ||
+        getsockname(s, (struct sockaddr*)&addr, &len) != 0) {
+        socket_close(s);
+        return false;
+    }
+    p->listener = s;
+    p->port = ntohs(addr.sin_port);
+    return true;
+}
+
+static void port_drop_client(stream_port_t *p) {
+    if (p->client != SOCKET_INVALID) {
+        socket_close(p->client);
+        p->client = SOCKET_INVALID;
+        atomic_store(&p->attached, false);
+    }
+}
+
+static void port_close(stream_port_t *p) {
+    port_drop_client(p);
+    if (p->listener != SOCKET_INVALID) {
+        socket_close(p->listener);
+        p->listener = SOCKET_INVALID;
+    }
+}
+
+static bool send_all(socket_t s, const uint8_t *data, size_t len) {
+    while (len > 0) {
+        int sent = send(s, (const char*)data, (int)len, SEND_FLAGS);
+        if (sent <= 0) return false;
+        data += sent;
+        len -= (size_t)sent;
+    }
+    return true;
+}
+
+/* Header and META rate: the decimated port runs at 48 kHz whatever the device does */
+static uint32_t port_rate(const stream_port_t *p, const snapshot_t *snap) {
+    return p->format == IQ_FORMAT_F32 ? SDR_MANAGER_DECIM_RATE : (uint32_t)snap->sample_rate;
+}
+
+/*
+ * Sends run on the device thread, so a client that stops reading must not
+ * hold it up: once the socket buffer is full a send waits at most
+ * PORT_SEND_TIMEOUT_MS, then the client is dropped and may reconnect.
+ */
+static void port_send(sdr_device_t *d, stream_port_t *p, const void *data, size_t len) {
+    if (p->client == SOCKET_INVALID) return;
+    if (!send_all(p->client, (const uint8_t*)data, len)) {
+        printf("[DEV %d] Client on port %d dropped (send failed or stalled)\n", d->number, p->port);
+        port_drop_client(p);
+    }
+}
+
+static void port_set_send_timeout(socket_t c) {
+    int sndbuf = PORT_SNDBUF;
+    setsockopt(c, SOL_SOCKET, SO_SNDBUF, (const char*)&sndbuf, sizeof(sndbuf));
+#ifdef _WIN32
+    DWORD timeout = PORT_SEND_TIMEOUT_MS;
+#else
+    struct timeval timeout = { 0, PORT_SEND_TIMEOUT_MS * 1000 };
+#endif
+    setsockopt(c, SOL_SOCKET, SO_SNDTIMEO, (const char*)&timeout, sizeof(timeout));
+}
+
+/* One client per port; a second one is turned away while the first stays */
+static void port_accept(sdr_device_t *d, stream_port_t *p, const snapshot_t *snap) {
+    if (p->listener == SOCKET_INVALID) return;
+
+    fd_set read_fds;
+    struct timeval tv = { 0, 0 };
+    FD_ZERO(&read_fds);
+    FD_SET(p->listener, &read_fds);
+    if (select((int)(p->listener + 1), &read_fds, NULL, NULL, &tv) <= 0) return;
+
+    socket_t c = accept(p->listener, NULL, NULL);
+    if (c == SOCKET_INVALID) return;
+    if (p->client != SOCKET_INVALID) {
+        printf("[DEV %d] Port %d busy, connection refused\n", d->number, p->port);
+        socket_close(c);
+        return;
+    }
+
+    int nodelay = 1;
+    setsockopt(c, IPPROTO_TCP, TCP_NODELAY, (const char*)&nodelay, sizeof(nodelay));
+    port_set_send_timeout(c);
+    p->client = c;
+    p->sequence = 0;
+    atomic_store(&p->attached, true);
+
+    phxi_header_t h;
+    uint64_t freq = (uint64_t)snap->freq_hz;
+    memset(&h, 0, sizeof(h));
+    h.magic = IQ_MAGIC_HEADER;
+    h.version = 1;
+    h.sample_rate = port_rate(p, snap);
+    h.sample_format = p->format;
+    h.center_freq_lo = (uint32_t)(freq & 0xFFFFFFFF);
+    h.center_freq_hi = (uint32_t)(freq >> 32);
+    h.gain_reduction = (uint32_t)snap->gain_reduction;
+    h.lna_state = (uint32_t)snap->lna_state;
+    printf("[DEV %d] Client on port %d (%s, %u Hz)\n", d->number, p->port,
+           p->format == IQ_FORMAT_F32 ? "F32" : "S16", h.sample_rate);
+    port_send(d, p, &h, sizeof(h));
+}
+
+static void port_send_meta(sdr_device_t *d, stream_port_t *p, const snapshot_t *snap) {
+    meta_update_t m;
+    uint64_t freq = (uint64_t)snap->freq_hz;
+    memset(&m, 0, sizeof(m));
+    m.magic = IQ_MAGIC_META;
+    m.sample_rate = port_rate(p, snap);
+    m.sample_format = p->format;
+    m.center_freq_lo = (uint32_t)(freq & 0xFFFFFFFF);
+    m.center_freq_hi = (uint32_t)(freq >> 32);
+    m.gain_reduction = (uint32_t)snap->gain_reduction;
+    m.lna_state = (uint32_t)snap->lna_state;
+    port_send(d, p, &m, sizeof(m));
+}
+
+/* IQDQ frame; payload already interleaved after the header in d->wire */
+static void port_send_frame(sdr_device_t *d, stream_port_t *p, uint32_t pairs, size_t pair_bytes) {
+    iqdq_header_t h;
+    h.magic = IQ_MAGIC_DATA;
+    h.sequence = p->sequence++;
+    h.num_samples = pairs;
+    h.flags = atomic_load(&d->overload) ? IQ_FLAG_OVERLOAD : 0;
+    memcpy(d->wire, &h, sizeof(h));
+    port_send(d, p, d->wire, sizeof(h) + pairs * pair_bytes);
+    if (p->client != SOCKET_INVALID) atomic_fetch_add(&d->frames, 1);
+}
+
+/*============================================================================
+ * RSP Callbacks (SDRplay API thread)
+ *============================================================================*/
+
+static void hw_on_samples(const int16_t *xi, const int16_t *xq, uint32_t count,
+                          bool reset, void *user_ctx) {
+    sdr_device_t *d = (sdr_device_t*)user_ctx;
+    uint64_t w = atomic_load_explicit(&d->ring_write, memory_order_relaxed);
+    uint64_t r = atomic_load_explicit(&d->ring_read, memory_order_acquire);
+
+    if (reset) atomic_store(&d->reset_pending, true);
+
+    /* Full ring: the newest samples are lost, the thread sees a gap-free past */
+    uint64_t space = SDR_MANAGER_RING_PAIRS - (w - r);
+    if (count > space) {
+        atomic_fetch_add(&d->overruns, count - space);
+        count = (uint32_t)space;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        size_t pos = (size_t)((w + i) & (SDR_MANAGER_RING_PAIRS - 1)) * 2;
+        d->ring[pos] = xi[i];
+        d->ring[pos + 1] = xq[i];
+    }
+    atomic_store_explicit(&d->ring_write, w + count, memory_order_release);
+}
+
+static void hw_on_overload(bool overloaded, void *user_ctx) {
+    sdr_device_t *d = (sdr_device_t*)user_ctx;
+    atomic_store(&d->overload, overloaded);
+}
+
+/* A new sample rate restarts the decimator */
+static void hw_on_stream_event(uint32_t flags, void *user_ctx) {
+    sdr_device_t *d = (sdr_device_t*)user_ctx;
+    if (flags & PSDR_STREAM_FS_CHANGED) atomic_store(&d->reset_pending, true);
+}
+
+/*============================================================================
+ * Block Sources (device thread)
+ *============================================================================*/
+
+/* Pairs worth a frame: BATCH_MS of stream, at most one block */
+static uint64_t batch_pairs(int rate) {
+    uint64_t n = (uint64_t)rate * BATCH_MS / 1000;
+    return n < SDR_MANAGER_BLOCK ? (n > 0 ? n : 1) : SDR_MANAGER_BLOCK;
+}
+
+static uint32_t fill_hardware(sdr_device_t *d, const snapshot_t *snap) {
+    uint64_t r = atomic_load_explicit(&d->ring_read, memory_order_relaxed);
+    uint64_t w = atomic_load_explicit(&d->ring_write, memory_order_acquire);
+    uint64_t avail = w - r;
+
+    if (!snap->streaming) {
+        atomic_store_explicit(&d->ring_read, w, memory_order_release);
+        return 0;
+    }
+
+    if (avail < batch_pairs(snap->sample_rate)) return 0;
+    uint32_t n = avail < SDR_MANAGER_BLOCK ? (uint32_t)avail : SDR_MANAGER_BLOCK;
+    for (uint32_t i = 0; i < n; i++) {
+        size_t pos = (size_t)((r + i) & (SDR_MANAGER_RING_PAIRS - 1)) * 2;
+        d->xi[i] = d->ring[pos];
+        d->xq[i] = d->ring[pos + 1];
+    }
+    atomic_store_explicit(&d->ring_read, r + n, memory_order_release);
+    return n;
+}
+
+/* Pairs due by the clock at this rate, at most one block */
+static uint32_t paced_count(sdr_device_t *d, int rate) {
+    if (!d->spec.paced) return SDR_MANAGER_BLOCK;
+
+    uint64_t now = now_us();
+    if (d->pace_start_us == 0) {
+        d->pace_start_us = now;
+        d->pace_samples = 0;
+    }
+    uint64_t due = (now - d->pace_start_us) * (uint64_t)rate / 1000000;
+    if (due > d->pace_samples + (uint64_t)rate * PACE_MAX_LAG_US / 1000000) {
+        /* Paused or starved: carry on from now rather than catch up */
+        d->pace_start_us = now;
+        d->pace_samples = 0;
+        return 0;
+    }
+    uint64_t n = due - d->pace_samples;
+    if (n < batch_pairs(rate)) return 0;
+    if (n > SDR_MANAGER_BLOCK) n = SDR_MANAGER_BLOCK;
+    d->pace_samples += n;
+    return (uint32_t)n;
+}
+
+static uint32_t fill_tone(sdr_device_t *d, const snapshot_t *snap) {
+    uint32_t n = paced_count(d, snap->sample_rate);
+    double inc = 2.0 * M_PI * d->spec.tone_hz / (double)snap->sample_rate;
+
+    for (uint32_t i = 0; i < n; i++) {
+        d->xi[i] = (int16_t)lrint(cos(d->tone_phase) * TONE_AMPLITUDE);
+        d->xq[i] = (int16_t)lrint(sin(d->tone_phase) * TONE_AMPLITUDE);
+        d->tone_phase += inc;
+        if (d->tone_phase >= M_PI) d->tone_phase -= 2.0 * M_PI;
+        if (d->tone_phase < -M_PI) d->tone_phase += 2.0 * M_PI;
+    }
+    return n;
+}
+
+static uint32_t fill_replay(sdr_device_t *d) {
+    uint32_t n = paced_count(d, d->replay_rate);
+    uint32_t got = 0;
+    if (n == 0) return 0;
+
+    if (iqr_read(d->replay, d->xi, d->xq, n, &got) == IQR_OK && got == 0) {
+        iqr_rewind(d->replay);
+        atomic_fetch_add(&d->replay_loops, 1);
+        if (iqr_read(d->replay, d->xi, d->xq, n, &got) != IQR_OK) got = 0;
+    }
+    if (got < n && d->spec.paced) d->pace_samples -= n - got;
+    return got;
+}
+
+/*============================================================================
+ * Device Thread
+ *============================================================================*/
+
+static void take_snapshot(sdr_device_t *d, snapshot_t *snap) {
+    pthread_mutex_lock(&d->lock);
+    snap->streaming = d->state.streaming;
+    snap->sample_rate = d->state.sample_rate;
+    snap->freq_hz = d->state.freq_hz;
+    snap->gain_reduction = d->state.gain_reduction;
+    snap->lna_state = d->state.lna_state;
+    pthread_mutex_unlock(&d->lock);
+}
+
+static bool snapshot_changed(const snapshot_t *a, const snapshot_t *b) {
+    return a->sample_rate != b->sample_rate || a->freq_hz != b->freq_hz ||
+           a->gain_reduction != b->gain_reduction || a->lna_state != b->lna_state;
+}
+
+static void process_block(sdr_device_t *d, uint32_t n, int sample_rate) {
+    stream_port_t *raw = &d->ports[PORT_RAW];
+    stream_port_t *dec = &d->ports[PORT_DECIM];
+
+    atomic_fetch_add(&d->samples, n);
+
+    if (raw->client != SOCKET_INVALID) {
+        int16_t *out = (int16_t*)(d->wire + sizeof(iqdq_header_t));
+        for (uint32_t i = 0; i < n; i++) {
+            out[2 * i] = d->xi[i];
+            out[2 * i + 1] = d->xq[i];
+        }
+        port_send_frame(d, raw, n, 2 * sizeof(int16_t));
+    }
+
+    size_t nd = 0;
+    if (d->decim && sample_rate == DECIM_INPUT_HZ &&
+        (dec->client != SOCKET_INVALID || (d->spec.sink && !d->spec.sink_raw_only))) {
+        if (decim_process_int16(d->decim, d->xi, d->xq, n, d->decim_out, DECIM_OUT_MAX, &nd) != DECIM_OK) {
+            nd = 0;
+        }
+        atomic_fetch_add(&d->decim_samples, nd);
+    }
+
+    if (nd > 0 && dec->client != SOCKET_INVALID) {
+        memcpy(d->wire + sizeof(iqdq_header_t), d->decim_out, nd * sizeof(decim_complex_t));
+        port_send_frame(d, dec, (uint32_t)nd, 2 * sizeof(float));
+    }
+
+    if (d->spec.sink) {
+        d->spec.sink(d->number, d->xi, d->xq, n, d->decim_out,
+                     d->spec.sink_raw_only ? 0 : nd, d->spec.sink_user);
+    }
+}
+
+static void *device_thread(void *arg) {
+    sdr_device_t *d = (sdr_device_t*)arg;
+    snapshot_t snap, last;
+    bool have_last = false;
+
+    if (d->spec.core >= 0) {
+        bool ok = pin_to_core(d->spec.core);
+        atomic_store(&d->pinned, ok);
+        if (!ok) printf("[DEV %d] Could not pin to core %d, running unpinned\n", d->number, d->spec.core);
+    }
+
+    while (atomic_load(&d->running)) {
+        take_snapshot(d, &snap);
+
+        /* Parameters changed since the last block: tell clients, restart the filters */
+        if (have_last && snapshot_changed(&snap, &last)) {
+            port_send_meta(d, &d->ports[PORT_RAW], &snap);
+            port_send_meta(d, &d->ports[PORT_DECIM], &snap);
+            if (snap.sample_rate != last.sample_rate && d->decim) decim_reset(d->decim);
+        }
+        if (have_last && snap.streaming != last.streaming) d->pace_start_us = 0;
+        last = snap;
+        have_last = true;
+
+        port_accept(d, &d->ports[PORT_RAW], &snap);
+        port_accept(d, &d->ports[PORT_DECIM], &snap);
+
+        if (atomic_exchange(&d->reset_pending, false) && d->decim) decim_reset(d->decim);
+
+        uint32_t n = 0;
+        if (d->spec.backend == SDR_BACKEND_HARDWARE) {
+            n = fill_hardware(d, &snap);
+        } else if (snap.streaming) {
+            n = d->spec.backend == SDR_BACKEND_TONE ? fill_tone(d, &snap) : fill_replay(d);
+        }
+
+        if (n == 0) {
+            sleep_ms(IDLE_SLEEP_MS);
+            continue;
+        }
+        process_block(d, n, snap.sample_rate);
+    }
+    return NULL;
+}
+
+/*============================================================================
+ * Devices
+ *============================================================================*/
+
+static void device_free(sdr_device_t *d) {
+    if (!d) return;
+    if (d->thread_started) {
+        atomic_store(&d->running, false);
+        pthread_join(d->thread, NULL);
+    }
+    if (d->state.sdr_ctx) {
+        psdr_close(d->state.sdr_ctx);   /* Stops streaming first */
+    }
+    port_close(&d->ports[PORT_RAW]);
+    port_close(&d->ports[PORT_DECIM]);
+    iqr_close(d->replay);
+    decim_destroy(d->decim);
+    pthread_mutex_destroy(&d->lock);
+    free(d->decim_out);
+    free(d->ring);
+    free(d->xi);
+    free(d->xq);
+    free(d->wire);
+    free(d);
+}
+
+/* Open the RSP with this serial, configured from the state defaults */
+static bool open_hardware(sdr_device_t *d, const char *serial) {
+    tcp_sdr_state_t *state = &d->state;
+
+    d->ring = (int16_t*)malloc((size_t)SDR_MANAGER_RING_PAIRS * 2 * sizeof(int16_t));
+    if (!d->ring) return false;
+
+    psdr_error_t err = psdr_open_serial(&state->sdr_ctx, serial);
+    if (err != PSDR_OK) {
+        fprintf(stderr, "[DEV %d] Failed to open %s: %s\n", d->number, serial, psdr_strerror(err));
+        state->sdr_ctx = NULL;
+        return false;
+    }
+
+    state->sdr_callbacks.on_samples = hw_on_samples;
+    state->sdr_callbacks.on_overload = hw_on_overload;
+    state->sdr_callbacks.on_stream_event = hw_on_stream_event;
+    state->sdr_callbacks.user_ctx = d;
+
+    state->sdr_config.freq_hz = state->freq_hz;
+    state->sdr_config.sample_rate_hz = (double)state->sample_rate;
+    state->sdr_config.bandwidth = (psdr_bandwidth_t)state->bandwidth_khz;
+    state->sdr_config.gain_reduction = state->gain_reduction;
+    state->sdr_config.lna_state = state->lna_state;
+
+    err = psdr_configure(state->sdr_ctx, &state->sdr_config);
+    if (err != PSDR_OK) {
+        fprintf(stderr, "[DEV %d] Failed to configure %s: %s\n", d->number, serial, psdr_strerror(err));
+        return false;
+    }
+
+    snprintf(d->serial, sizeof(d->serial), "%s", serial);
+    state->hardware_connected = true;
+    return true;
+}
+
+static bool open_replay(sdr_device_t *d) {
+    iqr_error_t err = iqr_open(&d->replay, d->spec.replay_path);
+    if (err != IQR_OK) {
+        fprintf(stderr, "[DEV %d] %s: %s\n", d->number, d->spec.replay_path, iqr_strerror(err));
+        d->replay = NULL;
+        return false;
+    }
+    const iqr_header_t *h = iqr_get_header(d->replay);
+    d->replay_rate = (int)h->sample_rate_hz;
+    if (d->replay_rate <= 0) {
+        fprintf(stderr, "[DEV %d] %s: no sample rate\n", d->number, d->spec.replay_path);
+        return false;
+    }
+    d->state.sample_rate = d->replay_rate;
+    d->state.freq_hz = h->center_freq_hz;
+    d->state.gain_reduction = h->gain_reduction;
+    d->state.lna_state = (int)h->lna_state;
+    return true;
+}
+
+static int add_device(sdr_manager_t *m, const sdr_device_spec_t *spec, const char *serial) {
+    if (!m || !spec) return -1;
+    if (m->count >= SDR_MANAGER_MAX_DEVICES) {
+        fprintf(stderr, "Device limit (%d) reached\n", SDR_MANAGER_MAX_DEVICES);
+        return -1;
+    }
+
+    sdr_device_t *d = (sdr_device_t*)calloc(1, sizeof(sdr_device_t));
+    if (!d) return -1;
+    d->mgr = m;
+    d->number = m->count;
+    d->spec = *spec;
+    pthread_mutex_init(&d->lock, NULL);
+    port_init(&d->ports[PORT_RAW], IQ_FORMAT_S16);
+    port_init(&d->ports[PORT_DECIM], IQ_FORMAT_F32);
+    tcp_state_defaults(&d->state);
+
+    d->xi = (int16_t*)malloc(SDR_MANAGER_BLOCK * sizeof(int16_t));
+    d->xq = (int16_t*)malloc(SDR_MANAGER_BLOCK * sizeof(int16_t));
+    d->wire = (uint8_t*)malloc(sizeof(iqdq_header_t) + SDR_MANAGER_BLOCK * 2 * sizeof(int16_t));
+    d->decim_out = (decim_complex_t*)malloc(DECIM_OUT_MAX * sizeof(decim_complex_t));
+    if (!d->xi || !d->xq || !d->wire || !d->decim_out ||
+        decim_create(&d->decim, DECIM_INPUT_HZ, SDR_MANAGER_DECIM_RATE) != DECIM_OK) {
+        fprintf(stderr, "[DEV %d] Out of memory\n", d->number);
+        device_free(d);
+        return -1;
+    }
+
+    bool ok = true;
+    switch (spec->backend) {
+        case SDR_BACKEND_HARDWARE: ok = serial && open_hardware(d, serial); break;
+        case SDR_BACKEND_TONE:     ok = true; break;
+        case SDR_BACKEND_REPLAY:   ok = open_replay(d); break;
+        default:                   ok = false; break;
+    }
+    if (!ok) {
+        device_free(d);
+        return -1;
+    }
+
+    if (!port_open(&d->ports[PORT_RAW], spec->iq_port) ||
+        !port_open(&d->ports[PORT_DECIM], spec->decim_port)) {
+        fprintf(stderr, "[DEV %d] Cannot listen on port %d/%d\n", d->number, spec->iq_port, spec->decim_port);
+        device_free(d);
+        return -1;
+    }
+
+    atomic_store(&d->running, true);
+    if (pthread_create(&d->thread, NULL, device_thread, d) != 0) {
+        fprintf(stderr, "[DEV %d] Cannot start streaming thread\n", d->number);
+        device_free(d);
+        return -1;
+    }
+    d->thread_started = true;
+
+    m->devices[m->count++] = d;
+    printf("[DEV %d] %s%s%s, %d Hz, I/Q port %d, 48k port %d, core %d\n", d->number,
+           g_backend_names[spec->backend], d->serial[0] ? " " : "", d->serial,
+           d->state.sample_rate, d->ports[PORT_RAW].port, d->ports[PORT_DECIM].port, spec->core);
+    return d->number;
+}
+
+/*============================================================================
+ * Manager
+ *============================================================================*/
+
+sdr_manager_t *sdr_manager_create(void) {
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return NULL;
+#endif
+    now_us();   /* Latch the counter frequency before device threads use it */
+    return (sdr_manager_t*)calloc(1, sizeof(sdr_manager_t));
+}
+
+void sdr_manager_destroy(sdr_manager_t *m) {
+    if (!m) return;
+    sdr_manager_stop_all(m);
+    for (int i = 0; i < m->count; i++) {
+        device_free(m->devices[i]);
+    }
+    free(m);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void sdr_manager_spec_defaults(sdr_device_spec_t *spec, sdr_backend_t backend) {
+    memset(spec, 0, sizeof(*spec));
+    spec->backend = backend;
+    spec->tone_hz = 1000.0;
+    spec->paced = true;
+    spec->iq_port = SDR_PORT_NONE;
+    spec->decim_port = SDR_PORT_NONE;
+    spec->core = -1;
+}
+
+/* Enumerated RSPs; false (and a message) if the API or the list fails */
+static bool enumerate(psdr_device_info_t *devices, size_t *found) {
+    psdr_error_t err = psdr_enumerate(devices, SDR_MANAGER_MAX_DEVICES, found);
+    if (err != PSDR_OK || *found == 0) {
+        fprintf(stderr, "No SDR devices: %s\n", psdr_strerror(err == PSDR_OK ? PSDR_ERR_NO_DEVICES : err));
+        return false;
+    }
+    if (*found > SDR_MANAGER_MAX_DEVICES) *found = SDR_MANAGER_MAX_DEVICES;
+    return true;
+}
+
+int sdr_manager_add(sdr_manager_t *m, const sdr_device_spec_t *spec) {
+    if (!m || !spec) return -1;
+    if (spec->backend != SDR_BACKEND_HARDWARE) return add_device(m, spec, NULL);
+
+    psdr_device_info_t devices[SDR_MANAGER_MAX_DEVICES];
+    size_t found = 0;
+    if (!enumerate(devices, &found)) return -1;
+    if (spec->device_idx >= found) {
+        fprintf(stderr, "Device index %u out of range (%zu found)\n", spec->device_idx, found);
+        return -1;
+    }
+    return add_device(m, spec, devices[spec->device_idx].serial);
+}
+
+int sdr_manager_add_hardware(sdr_manager_t *m, const sdr_device_spec_t *tmpl) {
+    psdr_device_info_t devices[SDR_MANAGER_MAX_DEVICES];
+    size_t found = 0;
+    int added = 0;
+    if (!m || !tmpl || !enumerate(devices, &found)) return 0;
+
+    for (size_t k = 0; k < found; k++) {
+        if (!devices[k].available) continue;
+        sdr_device_spec_t spec = *tmpl;
+        spec.backend = SDR_BACKEND_HARDWARE;
+        spec.device_idx = (unsigned int)k;
+        if (spec.iq_port > 0) spec.iq_port += added;
+        if (spec.decim_port > 0) spec.decim_port += added;
+        if (spec.core >= 0) spec.core += added;
+        if (add_device(m, &spec, devices[k].serial) >= 0) added++;
+    }
+    return added;
+}
+
+int sdr_manager_count(const sdr_manager_t *m) {
+    return m ? m->count : 0;
+}
+
+bool sdr_manager_get_stats(sdr_manager_t *m, int device, sdr_device_stats_t *stats) {
+    if (!m || !stats || device < 0 || device >= m->count) return false;
+    sdr_device_t *d = m->devices[device];
+
+    memset(stats, 0, sizeof(*stats));
+    stats->backend = d->spec.backend;
+    snprintf(stats->serial, sizeof(stats->serial), "%s", d->serial);
+    pthread_mutex_lock(&d->lock);
+    stats->streaming = d->state.streaming;
+    stats->sample_rate = d->state.sample_rate;
+    pthread_mutex_unlock(&d->lock);
+    stats->core = d->spec.core;
+    stats->pinned = atomic_load(&d->pinned);
+    stats->iq_port = d->ports[PORT_RAW].port;
+    stats->decim_port = d->ports[PORT_DECIM].port;
+    stats->iq_client = atomic_load(&d->ports[PORT_RAW].attached);
+    stats->decim_client = atomic_load(&d->ports[PORT_DECIM].attached);
+    stats->samples = atomic_load(&d->samples);
+    stats->decim_samples = atomic_load(&d->decim_samples);
+    stats->frames = atomic_load(&d->frames);
+    stats->overruns = atomic_load(&d->overruns);
+    stats->replay_loops = atomic_load(&d->replay_loops);
+    return true;
+}
+
+void sdr_manager_stop_all(sdr_manager_t *m) {
+    if (!m) return;
+    for (int i = 0; i < m->count; i++) {
+        sdr_device_t *d = m->devices[i];
+        tcp_command_t cmd;
+        tcp_response_t resp;
+        memset(&cmd, 0, sizeof(cmd));
+        cmd.type = CMD_STOP;
+
+        pthread_mutex_lock(&d->lock);
+        if (d->state.streaming) {
+            printf("[DEV %d] Stopping streaming\n", d->number);
+            tcp_execute_command(&cmd, &d->state, &resp);
+        }
+        pthread_mutex_unlock(&d->lock);
+    }
+}
+
+/*============================================================================
+ * Device-Addressed Commands
+ *============================================================================*/
+
+/* Next whitespace-separated word: start in *word, length returned, *p moved past it */
+static size_t next_word(const char **p, const char **word) {
+    const char *s = *p;
+    while (*s == ' ' || *s == '\t') s++;
+    *word = s;
+    while (*s && *s != ' ' && *s != '\t' && *s != '\r' && *s != '\n') s++;
+    *p = s;
+    return (size_t)(s - *word);
+}
+
+static bool word_is(const char *word, size_t len, const char *name) {
+    char buf[16];
+    if (len == 0 || len >= sizeof(buf)) return false;
+    memcpy(buf, word, len);
+    buf[len] = '\0';
+    return strcasecmp_local(buf, name) == 0;
+}
+
+static void devices_reply(sdr_manager_t *m, tcp_response_t *resp) {
+    char buf[TCP_MAX_LINE_LENGTH - 4];
+    size_t off = (size_t)snprintf(buf, sizeof(buf), "COUNT=%d BACKENDS=", m->count);
+    for (int i = 0; i < m->count && off < sizeof(buf); i++) {
+        off += (size_t)snprintf(buf + off, sizeof(buf) - off, "%s%s", i ? "," : "",
+                                g_backend_names[m->devices[i]->spec.backend]);
+    }
+    if (m->count == 0 && off < sizeof(buf)) snprintf(buf + off, sizeof(buf) - off, "NONE");
+    tcp_response_ok(resp, buf);
+}
+
+static void info_reply(sdr_manager_t *m, int device, tcp_response_t *resp) {
+    sdr_device_stats_t s;
+    char buf[TCP_MAX_LINE_LENGTH - 4];
+    sdr_manager_get_stats(m, device, &s);
+    snprintf(buf, sizeof(buf),
+             "BACKEND=%s%s%s STREAMING=%d SRATE=%d IQ_PORT=%d DECIM_PORT=%d CORE=%d PINNED=%d "
+             "SAMPLES=%llu DECIM=%llu FRAMES=%llu OVERRUNS=%llu LOOPS=%u",
+             g_backend_names[s.backend], s.serial[0] ? " SERIAL=" : "", s.serial,
+             s.streaming ? 1 : 0, s.sample_rate, s.iq_port, s.decim_port, s.core, s.pinned ? 1 : 0,
+             (unsigned long long)s.samples, (unsigned long long)s.decim_samples,
+             (unsigned long long)s.frames, (unsigned long long)s.overruns, s.replay_loops);
+    tcp_response_ok(resp, buf);
+}
+
+static const char *parse_error_text(tcp_error_t err) {
+    switch (err) {
+        case TCP_ERR_SYNTAX:   return "malformed command";
+        case TCP_ERR_UNKNOWN:  return "unknown command";
+        case TCP_ERR_RANGE:    return "value out of range";
+        case TCP_ERR_PARAM:    return "invalid parameter";
+        default:               return NULL;
+    }
+}
+
+tcp_cmd_type_t sdr_manager_execute(sdr_manager_t *m, const char *line, tcp_response_t *resp) {
+    const char *p = line;
+    const char *word;
+    size_t len = next_word(&p, &word);
+    int device = 0;
+    const char *rest = line;
+
+    if (word_is(word, len, "DEVICES")) {
+        devices_reply(m, resp);
+        return CMD_UNKNOWN;
+    }
+
+    if (word_is(word, len, "DEV")) {
+        char num[16];
+        char *end;
+        len = next_word(&p, &word);
+        if (len == 0 || len >= sizeof(num)) {
+            tcp_response_error(resp, TCP_ERR_SYNTAX, "DEV <n> <command>");
+            return CMD_UNKNOWN;
+        }
+        memcpy(num, word, len);
+        num[len] = '\0';
+        long n = strtol(num, &end, 10);
+        if (*end != '\0') {
+            tcp_response_error(resp, TCP_ERR_SYNTAX, "DEV <n> <command>");
+            return CMD_UNKNOWN;
+        }
+        if (n < 0 || n >= m->count) {
+            tcp_response_error(resp, TCP_ERR_PARAM, "no such device");
+            return CMD_UNKNOWN;
+        }
+        device = (int)n;
+        rest = p;
+
+        const char *after = p;
+        len = next_word(&after, &word);
+        if (len == 0) {
+            tcp_response_error(resp, TCP_ERR_SYNTAX, "DEV <n> <command>");
+            return CMD_UNKNOWN;
+        }
+        if (word_is(word, len, "INFO")) {
+            info_reply(m, device, resp);
+            return CMD_UNKNOWN;
+        }
+    } else if (m->count == 0) {
+        tcp_response_error(resp, TCP_ERR_STATE, "no devices");
+        return CMD_UNKNOWN;
+    }
+
+    tcp_command_t cmd;
+    tcp_error_t err = tcp_parse_command(rest, &cmd);
+    if (err != TCP_OK) {
+        tcp_response_error(resp, err, parse_error_text(err));
+        return CMD_UNKNOWN;
+    }
+
+    sdr_device_t *d = m->devices[device];
+    if (d->spec.backend == SDR_BACKEND_REPLAY && cmd.type == CMD_SET_SRATE) {
+        tcp_response_error(resp, TCP_ERR_STATE, "replay runs at the file rate");
+        return cmd.type;
+    }
+
+    pthread_mutex_lock(&d->lock);
+    tcp_execute_command(&cmd, &d->state, resp);
+    pthread_mutex_unlock(&d->lock);
+    return cmd.type;
+}
@@ -21,9 +21,6 @@ struct psdr_context {
     double                      actual_sample_rate;
 };
 
-/* Thread-local context pointer for callbacks (single device support) */
-static psdr_context_t *g_callback_ctx = NULL;
-
 /*============================================================================
  * Internal Callbacks (SDRplay API -> User callbacks)
  *============================================================================*/
@@ -36,11 +33,21 @@ static void stream_callback_a(
     unsigned int reset,
     void *cbContext
 ) {
-    (void)params;  /* Unused but required by API */
     psdr_context_t *ctx = (psdr_context_t *)cbContext;
 
     if (!ctx || !ctx->user_callbacks.on_samples) return;
 
+    /* Changes flagged here take effect at xi[0] */
+    if (params && ctx->user_callbacks.on_stream_event) {
+        uint32_t flags = 0;
+        if (params->grChanged) flags |= PSDR_STREAM_GR_CHANGED;
+        if (params->rfChanged) flags |= PSDR_STREAM_RF_CHANGED;
+        if (params->fsChanged) flags |= PSDR_STREAM_FS_CHANGED;
+        if (flags) {
+            ctx->user_callbacks.on_stream_event(flags, ctx->user_callbacks.user_ctx);
+        }
+    }
+
     /* Forward to user callback */
     ctx->user_callbacks.on_samples(
         (const int16_t *)xi,
@@ -253,10 +260,7 @@ psdr_error_t psdr_start(psdr_context_t *ctx, const psdr_callbacks_t *callbacks)
     ctx->api_callbacks.StreamBCbFn = stream_callback_b;
     ctx->api_callbacks.EventCbFn = event_callback;
 
-    /* Store global context for callbacks */
-    g_callback_ctx = ctx;
-
-    /* Initialize streaming */
+    /* Initialize streaming - callbacks get ctx back, one per device */
     err = sdrplay_api_Init(ctx->device.dev, &ctx->api_callbacks, ctx);
     if (err != sdrplay_api_Success) {
         fprintf(stderr, "psdr_start: sdrplay_api_Init failed: %s\n",
@@ -284,7 +288,6 @@ psdr_error_t psdr_stop(psdr_context_t *ctx) {
     }
 
     ctx->streaming = false;
-    g_callback_ctx = NULL;
 
     printf("psdr_stop: Streaming stopped\n");
 
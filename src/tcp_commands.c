@@ -6,73 +6,96 @@
  */
 
 #include "tcp_server.h"
+#include "cmd_table.h"
 #include "version.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdatomic.h>
 
 /*============================================================================
- * Command Name Table
+ * Command Grammar
  *============================================================================*/
 
-typedef struct {
-    const char     *name;
-    tcp_cmd_type_t  type;
-    int             min_args;
-    int             max_args;
-} cmd_def_t;
+static const char *const g_on_off[] = { "ON", "OFF", NULL };
+static const char *const g_agc_modes[] = { "OFF", "5HZ", "50HZ", "100HZ", NULL };
+static const char *const g_antennas[] = { "A", "B", "HIZ", NULL };
+static const char *const g_if_modes[] = { "ZERO", "LOW", NULL };
 
-static const cmd_def_t g_commands[] = {
+static const cmd_spec_t g_commands[] = {
     /* Frequency */
-    { "SET_FREQ",    CMD_SET_FREQ,    1, 1 },
-    { "GET_FREQ",    CMD_GET_FREQ,    0, 0 },
+    { "SET_FREQ",    CMD_SET_FREQ,    1, 1, { CMD_SPEC_FLOAT(1000, 2000000000) }, NULL },
+    { "GET_FREQ",    CMD_GET_FREQ,    0, 0, { CMD_SPEC_NO_ARGS }, NULL },
 
     /* Gain */
-    { "SET_GAIN",    CMD_SET_GAIN,    1, 1 },
-    { "GET_GAIN",    CMD_GET_GAIN,    0, 0 },
-    { "SET_LNA",     CMD_SET_LNA,     1, 1 },
-    { "GET_LNA",     CMD_GET_LNA,     0, 0 },
-    { "SET_AGC",     CMD_SET_AGC,     1, 1 },
-    { "GET_AGC",     CMD_GET_AGC,     0, 0 },
+    { "SET_GAIN",    CMD_SET_GAIN,    1, 1, { CMD_SPEC_INT(20, 59) }, NULL },
+    { "GET_GAIN",    CMD_GET_GAIN,    0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "SET_LNA",     CMD_SET_LNA,     1, 1, { CMD_SPEC_INT(0, 8) }, NULL },  /* Per-port limit in execute */
+    { "GET_LNA",     CMD_GET_LNA,     0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "SET_AGC",     CMD_SET_AGC,     1, 1, { CMD_SPEC_CHOICE(g_agc_modes) }, NULL },
+    { "GET_AGC",     CMD_GET_AGC,     0, 0, { CMD_SPEC_NO_ARGS }, NULL },
 
     /* Sample Rate / Bandwidth */
-    { "SET_SRATE",   CMD_SET_SRATE,   1, 1 },
-    { "GET_SRATE",   CMD_GET_SRATE,   0, 0 },
-    { "SET_BW",      CMD_SET_BW,      1, 1 },
-    { "GET_BW",      CMD_GET_BW,      0, 0 },
+    { "SET_SRATE",   CMD_SET_SRATE,   1, 1, { CMD_SPEC_INT(2000000, 10000000) }, NULL },
+    { "GET_SRATE",   CMD_GET_SRATE,   0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "SET_BW",      CMD_SET_BW,      1, 1, { CMD_SPEC_INT(0, 0) }, NULL },     /* Value set checked below */
+    { "GET_BW",      CMD_GET_BW,      0, 0, { CMD_SPEC_NO_ARGS }, NULL },
 
     /* Hardware */
-    { "SET_ANTENNA", CMD_SET_ANTENNA, 1, 1 },
-    { "GET_ANTENNA", CMD_GET_ANTENNA, 0, 0 },
-    { "SET_BIAST",   CMD_SET_BIAST,   1, 2 },  /* ON [CONFIRM] */
-    { "SET_NOTCH",   CMD_SET_NOTCH,   1, 1 },
-    { "SET_DECIM",   CMD_SET_DECIM,   1, 1 },
-    { "GET_DECIM",   CMD_GET_DECIM,   0, 0 },
-    { "SET_IFMODE",  CMD_SET_IFMODE,  1, 1 },
-    { "GET_IFMODE",  CMD_GET_IFMODE,  0, 0 },
-    { "SET_DCOFFSET", CMD_SET_DCOFFSET, 1, 1 },
-    { "GET_DCOFFSET", CMD_GET_DCOFFSET, 0, 0 },
-    { "SET_IQCORR",  CMD_SET_IQCORR,  1, 1 },
-    { "GET_IQCORR",  CMD_GET_IQCORR,  0, 0 },
-    { "SET_AGC_SETPOINT", CMD_SET_AGC_SETPOINT, 1, 1 },
-    { "GET_AGC_SETPOINT", CMD_GET_AGC_SETPOINT, 0, 0 },
+    { "SET_ANTENNA", CMD_SET_ANTENNA, 1, 1, { CMD_SPEC_CHOICE(g_antennas) }, NULL },
+    { "GET_ANTENNA", CMD_GET_ANTENNA, 0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "SET_BIAST",   CMD_SET_BIAST,   1, 2, { CMD_SPEC_CHOICE(g_on_off), CMD_SPEC_WORD }, NULL },  /* ON [CONFIRM] */
+    { "SET_NOTCH",   CMD_SET_NOTCH,   1, 1, { CMD_SPEC_CHOICE(g_on_off) }, NULL },
+    { "SET_DECIM",   CMD_SET_DECIM,   1, 1, { CMD_SPEC_INT(0, 0) }, NULL },     /* Value set checked below */
+    { "GET_DECIM",   CMD_GET_DECIM,   0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "SET_IFMODE",  CMD_SET_IFMODE,  1, 1, { CMD_SPEC_CHOICE(g_if_modes) }, NULL },
+    { "GET_IFMODE",  CMD_GET_IFMODE,  0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "SET_DCOFFSET", CMD_SET_DCOFFSET, 1, 1, { CMD_SPEC_CHOICE(g_on_off) }, NULL },
+    { "GET_DCOFFSET", CMD_GET_DCOFFSET, 0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "SET_IQCORR",  CMD_SET_IQCORR,  1, 1, { CMD_SPEC_CHOICE(g_on_off) }, NULL },
+    { "GET_IQCORR",  CMD_GET_IQCORR,  0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "SET_AGC_SETPOINT", CMD_SET_AGC_SETPOINT, 1, 1, { CMD_SPEC_INT(-72, 0) }, NULL },
+    { "GET_AGC_SETPOINT", CMD_GET_AGC_SETPOINT, 0, 0, { CMD_SPEC_NO_ARGS }, NULL },
 
     /* Streaming */
-    { "START",       CMD_START,       0, 0 },
-    { "STOP",        CMD_STOP,        0, 0 },
-    { "STATUS",      CMD_STATUS,      0, 0 },
+    { "START",       CMD_START,       0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "STOP",        CMD_STOP,        0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "STATUS",      CMD_STATUS,      0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "GET_IQSTATS", CMD_GET_IQSTATS, 0, 0, { CMD_SPEC_NO_ARGS }, NULL },
 
     /* Utility */
-    { "PING",        CMD_PING,        0, 0 },
-    { "VER",         CMD_VER,         0, 0 },
-    { "CAPS",        CMD_CAPS,        0, 0 },
-    { "HELP",        CMD_HELP,        0, 0 },
-    { "QUIT",        CMD_QUIT,        0, 0 },
-
-    { NULL,          CMD_UNKNOWN,     0, 0 }   /* Sentinel */
+    { "PING",        CMD_PING,        0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "VER",         CMD_VER,         0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "CAPS",        CMD_CAPS,        0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "HELP",        CMD_HELP,        0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "QUIT",        CMD_QUIT,        0, 0, { CMD_SPEC_NO_ARGS }, NULL },
 };
 
+#define NUM_COMMANDS    ((int)(sizeof(g_commands) / sizeof(g_commands[0])))
+
+/* Built on first parse; client threads may race to it */
+static cmd_table_t g_command_table;
+static atomic_int g_command_table_state;    /* 0 = unbuilt, 1 = building, 2 = ready */
+
+static const cmd_table_t *command_table(void) {
+    int expected = 0;
+    if (atomic_load_explicit(&g_command_table_state, memory_order_acquire) == 2) {
+        return &g_command_table;
+    }
+    if (atomic_compare_exchange_strong(&g_command_table_state, &expected, 1)) {
+        if (!cmd_table_build(&g_command_table, g_commands, NUM_COMMANDS)) {
+            fprintf(stderr, "tcp_commands: command table failed to build\n");
+            abort();
+        }
+        atomic_store_explicit(&g_command_table_state, 2, memory_order_release);
+    }
+    while (atomic_load_explicit(&g_command_table_state, memory_order_acquire) != 2) {
+        /* Another thread is building - a few microseconds */
+    }
+    return &g_command_table;
+}
+
 /*============================================================================
  * Helper: Case-insensitive string compare
  *============================================================================*/
@@ -93,8 +116,8 @@ static int strcasecmp_local(const char *a, const char *b) {
  *============================================================================*/
 
 const char* tcp_cmd_name(tcp_cmd_type_t type) {
-    for (int i = 0; g_commands[i].name; i++) {
-        if (g_commands[i].type == type) {
+    for (int i = 0; i < NUM_COMMANDS; i++) {
+        if (g_commands[i].id == (int)type) {
             return g_commands[i].name;
         }
     }
@@ -124,6 +147,24 @@ const char* tcp_error_name(tcp_error_t err) {
  * Command Parser
  *============================================================================*/
 
+static tcp_error_t parse_status_to_error(cmd_table_status_t st) {
+    switch (st) {
+        case CMD_TABLE_OK:          return TCP_OK;
+        case CMD_TABLE_ERR_UNKNOWN: return TCP_ERR_UNKNOWN;
+        case CMD_TABLE_ERR_RANGE:   return TCP_ERR_RANGE;
+        case CMD_TABLE_ERR_TYPE:
+        case CMD_TABLE_ERR_CHOICE:  return TCP_ERR_PARAM;
+        default:                    return TCP_ERR_SYNTAX;
+    }
+}
+
+/* Copy a validated choice's canonical (upper-case) spelling */
+static void copy_choice(char *dst, size_t size, const cmd_parsed_t *p, int arg) {
+    const char *word = p->spec->args[arg].choices[p->argv[arg].choice];
+    strncpy(dst, word, size - 1);
+    dst[size - 1] = '\0';
+}
+
 tcp_error_t tcp_parse_command(const char *line, tcp_command_t *cmd) {
     if (!line || !cmd) {
         return TCP_ERR_SYNTAX;
@@ -133,116 +174,50 @@ tcp_error_t tcp_parse_command(const char *line, tcp_command_t *cmd) {
     memset(cmd, 0, sizeof(*cmd));
     cmd->type = CMD_UNKNOWN;
 
-    /* Skip leading whitespace */
-    while (*line && isspace((unsigned char)*line)) {
-        line++;
-    }
-
-    /* Empty line */
-    if (*line == '\0' || *line == '\n' || *line == '\r') {
-        return TCP_ERR_SYNTAX;
-    }
-
-    /* Tokenize: first token is command name */
+    /* Tokenized in place: work on a copy of the caller's line */
     char linebuf[TCP_MAX_LINE_LENGTH];
     strncpy(linebuf, line, sizeof(linebuf) - 1);
     linebuf[sizeof(linebuf) - 1] = '\0';
 
-    /* Remove trailing newline/carriage return */
-    size_t len = strlen(linebuf);
-    while (len > 0 && (linebuf[len-1] == '\n' || linebuf[len-1] == '\r')) {
-        linebuf[--len] = '\0';
-    }
-
-    /* Parse tokens */
-    char *saveptr = NULL;
-    char *token = strtok_r(linebuf, " \t", &saveptr);
-
-    if (!token) {
-        return TCP_ERR_SYNTAX;
+    cmd_parsed_t p;
+    cmd_table_status_t st = cmd_table_parse(command_table(), linebuf, &p);
+    if (p.spec) {
+        cmd->type = (tcp_cmd_type_t)p.spec->id;
     }
-
-    /* Look up command */
-    const cmd_def_t *def = NULL;
-    for (int i = 0; g_commands[i].name; i++) {
-        if (strcasecmp_local(token, g_commands[i].name) == 0) {
-            def = &g_commands[i];
-            cmd->type = def->type;
-            break;
-        }
-    }
-
-    if (!def) {
-        return TCP_ERR_UNKNOWN;
-    }
-
-    /* Parse arguments */
-    cmd->argc = 0;
-    while ((token = strtok_r(NULL, " \t", &saveptr)) != NULL) {
-        if (cmd->argc >= TCP_MAX_ARGS) {
-            return TCP_ERR_SYNTAX;  /* Too many arguments */
-        }
-        strncpy(cmd->argv[cmd->argc], token, 63);
-        cmd->argv[cmd->argc][63] = '\0';
-        cmd->argc++;
+    if (st != CMD_TABLE_OK) {
+        return parse_status_to_error(st);
     }
 
-    /* Check argument count */
-    if (cmd->argc < def->min_args) {
-        return TCP_ERR_SYNTAX;  /* Missing arguments */
-    }
-    if (cmd->argc > def->max_args) {
-        return TCP_ERR_SYNTAX;  /* Too many arguments */
+    cmd->argc = p.argc;
+    for (int a = 0; a < p.argc; a++) {
+        strncpy(cmd->argv[a], p.argv[a].text, 63);
+        cmd->argv[a][63] = '\0';
     }
 
-    /* Parse type-specific values */
+    /* Types and ranges are checked by the table; store the values */
     switch (cmd->type) {
         case CMD_SET_FREQ:
-            cmd->value.freq_hz = atof(cmd->argv[0]);
-            if (cmd->value.freq_hz < 1000 || cmd->value.freq_hz > 2000000000) {
-                return TCP_ERR_RANGE;
-            }
+            cmd->value.freq_hz = p.argv[0].f;
             break;
 
         case CMD_SET_GAIN:
-            cmd->value.gain_db = atoi(cmd->argv[0]);
-            if (cmd->value.gain_db < 20 || cmd->value.gain_db > 59) {
-                return TCP_ERR_RANGE;
-            }
+            cmd->value.gain_db = (int)p.argv[0].i;
             break;
 
         case CMD_SET_LNA:
-            cmd->value.lna_state = atoi(cmd->argv[0]);
-            /* Range check done in execute based on antenna port */
-            if (cmd->value.lna_state < 0 || cmd->value.lna_state > 8) {
-                return TCP_ERR_RANGE;
-            }
+            cmd->value.lna_state = (int)p.argv[0].i;
             break;
 
         case CMD_SET_AGC:
-            strncpy(cmd->value.agc.mode, cmd->argv[0], 15);
-            cmd->value.agc.mode[15] = '\0';
-            /* Convert to uppercase for comparison */
-            for (char *p = cmd->value.agc.mode; *p; p++) {
-                *p = toupper((unsigned char)*p);
-            }
-            if (strcmp(cmd->value.agc.mode, "OFF") != 0 &&
-                strcmp(cmd->value.agc.mode, "5HZ") != 0 &&
-                strcmp(cmd->value.agc.mode, "50HZ") != 0 &&
-                strcmp(cmd->value.agc.mode, "100HZ") != 0) {
-                return TCP_ERR_PARAM;
-            }
+            copy_choice(cmd->value.agc.mode, sizeof(cmd->value.agc.mode), &p, 0);
             break;
 
         case CMD_SET_SRATE:
-            cmd->value.sample_rate = atoi(cmd->argv[0]);
-            if (cmd->value.sample_rate < 2000000 || cmd->value.sample_rate > 10000000) {
-                return TCP_ERR_RANGE;
-            }
+            cmd->value.sample_rate = (int)p.argv[0].i;
             break;
 
         case CMD_SET_BW:
-            cmd->value.bandwidth_khz = atoi(cmd->argv[0]);
+            cmd->value.bandwidth_khz = (int)p.argv[0].i;
             /* Valid bandwidths: 200, 300, 600, 1536, 5000, 6000, 7000, 8000 */
             if (cmd->value.bandwidth_khz != 200 &&
                 cmd->value.bandwidth_khz != 300 &&
@@ -257,50 +232,19 @@ tcp_error_t tcp_parse_command(const char *line, tcp_command_t *cmd) {
             break;
 
         case CMD_SET_ANTENNA:
-            strncpy(cmd->value.antenna.port, cmd->argv[0], 7);
-            cmd->value.antenna.port[7] = '\0';
-            for (char *p = cmd->value.antenna.port; *p; p++) {
-                *p = toupper((unsigned char)*p);
-            }
-            if (strcmp(cmd->value.antenna.port, "A") != 0 &&
-                strcmp(cmd->value.antenna.port, "B") != 0 &&
-                strcmp(cmd->value.antenna.port, "HIZ") != 0) {
-                return TCP_ERR_PARAM;
-            }
+            copy_choice(cmd->value.antenna.port, sizeof(cmd->value.antenna.port), &p, 0);
             break;
 
         case CMD_SET_BIAST:
         case CMD_SET_NOTCH:
-            /* Parse ON/OFF */
-            for (char *p = cmd->argv[0]; *p; p++) {
-                *p = toupper((unsigned char)*p);
-            }
-            if (strcmp(cmd->argv[0], "ON") == 0) {
-                cmd->value.on_off = true;
-            } else if (strcmp(cmd->argv[0], "OFF") == 0) {
-                cmd->value.on_off = false;
-            } else {
-                return TCP_ERR_PARAM;
-            }
-            break;
-
         case CMD_SET_DCOFFSET:
         case CMD_SET_IQCORR:
-            /* Parse ON/OFF */
-            for (char *p = cmd->argv[0]; *p; p++) {
-                *p = toupper((unsigned char)*p);
-            }
-            if (strcmp(cmd->argv[0], "ON") == 0) {
-                cmd->value.on_off = true;
-            } else if (strcmp(cmd->argv[0], "OFF") == 0) {
-                cmd->value.on_off = false;
-            } else {
-                return TCP_ERR_PARAM;
-            }
+            copy_choice(cmd->argv[0], sizeof(cmd->argv[0]), &p, 0);
+            cmd->value.on_off = (p.argv[0].choice == 0);
             break;
 
         case CMD_SET_DECIM:
-            cmd->value.decimation = atoi(cmd->argv[0]);
+            cmd->value.decimation = (int)p.argv[0].i;
             /* Valid decimation factors: 1, 2, 4, 8, 16, 32 */
             if (cmd->value.decimation != 1 &&
                 cmd->value.decimation != 2 &&
@@ -313,22 +257,11 @@ tcp_error_t tcp_parse_command(const char *line, tcp_command_t *cmd) {
             break;
 
         case CMD_SET_IFMODE:
-            strncpy(cmd->value.if_mode, cmd->argv[0], 15);
-            cmd->value.if_mode[15] = '\0';
-            for (char *p = cmd->value.if_mode; *p; p++) {
-                *p = toupper((unsigned char)*p);
-            }
-            if (strcmp(cmd->value.if_mode, "ZERO") != 0 &&
-                strcmp(cmd->value.if_mode, "LOW") != 0) {
-                return TCP_ERR_PARAM;
-            }
+            copy_choice(cmd->value.if_mode, sizeof(cmd->value.if_mode), &p, 0);
             break;
 
         case CMD_SET_AGC_SETPOINT:
-            cmd->value.agc_setpoint = atoi(cmd->argv[0]);
-            if (cmd->value.agc_setpoint < -72 || cmd->value.agc_setpoint > 0) {
-                return TCP_ERR_RANGE;
-            }
+            cmd->value.agc_setpoint = (int)p.argv[0].i;
             break;
 
         default:
@@ -842,6 +775,17 @@ tcp_error_t tcp_execute_command(
             tcp_response_ok(response, buf);
             break;
 
+        case CMD_GET_IQSTATS: {
+            char stats[TCP_MAX_LINE_LENGTH - 4];    /* Room for "OK " */
+            if (!state->iq_stats) {
+                tcp_response_error(response, TCP_ERR_STATE, "I/Q streaming disabled");
+                return TCP_ERR_STATE;
+            }
+            state->iq_stats(stats, sizeof(stats));
+            tcp_response_ok(response, stats);
+            break;
+        }
+
         /* ----- Utility ----- */
         case CMD_PING:
             strcpy(response->message, "PONG");
@@ -876,7 +820,7 @@ tcp_error_t tcp_execute_command(
             tcp_response_ok(response,
                 "COMMANDS: SET_FREQ GET_FREQ SET_GAIN GET_GAIN SET_LNA GET_LNA "
                 "SET_AGC GET_AGC SET_SRATE GET_SRATE SET_BW GET_BW SET_ANTENNA "
-                "GET_ANTENNA SET_BIAST SET_NOTCH START STOP STATUS PING VER CAPS HELP QUIT"
+                "GET_ANTENNA SET_BIAST SET_NOTCH START STOP STATUS GET_IQSTATS PING VER CAPS HELP QUIT"
             );
             break;
 
@@ -56,6 +56,12 @@ psdr_error_t psdr_open(psdr_context_t **ctx, unsigned int device_idx) {
     return PSDR_ERR_NO_DEVICES;
 }
 
+psdr_error_t psdr_open_serial(psdr_context_t **ctx, const char *serial) {
+    (void)serial;
+    if (ctx) *ctx = NULL;
+    return PSDR_ERR_NO_DEVICES;
+}
+
 psdr_error_t psdr_configure(psdr_context_t *ctx, const psdr_config_t *config) {
     (void)ctx;
     (void)config;
@@ -0,0 +1,211 @@
+/**
+ * @file test_block_normalizer.c
+ * @brief Unit tests for the block slow AGC
+ *
+ * - Approximate magnitude within 0.2% over a wide range
+ * - Block output matches the per-sample normalize() through warmup,
+ *   level steps and steady state (0.3% settled, 1% while the level
+ *   moves, 5% in a chunk holding a step or in the first 5 ms)
+ * - Gain is continuous across chunk and call boundaries
+ * - Held input keeps the level; reset restores warmup
+ */
+
+#include "test_framework.h"
+#include "../tools/block_normalizer.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FS          50000
+#define N_SAMPLES   (FS * 4)
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+static float noise(uint32_t *lcg, float amplitude) {
+    *lcg = *lcg * 1664525u + 1013904223u;
+    return amplitude * ((float)(*lcg >> 8) / 16777216.0f - 0.5f);
+}
+
+/* 1 kHz carrier plus noise, stepping -20 dB at 1.5 s and +30 dB at 2.5 s */
+static float *make_signal(int n) {
+    float *iq = (float *)malloc((size_t)n * 2 * sizeof(float));
+    uint32_t lcg = 21;
+    for (int k = 0; k < n; k++) {
+        float amp = (k < FS * 3 / 2) ? 0.3f : (k < FS * 5 / 2) ? 0.03f : 0.95f;
+        double ph = 2.0 * M_PI * 1000.0 * k / FS;
+        iq[2 * k] = amp * (float)cos(ph) + noise(&lcg, 0.01f);
+        iq[2 * k + 1] = amp * (float)sin(ph) + noise(&lcg, 0.01f);
+    }
+    return iq;
+}
+
+/* Worst |a/b - 1| over samples [from, to), by magnitude */
+static float worst_ratio_error(const float *a, const float *b, int from, int to) {
+    float worst = 0.0f;
+    for (int k = from; k < to; k++) {
+        float ma = hypotf(a[2 * k], a[2 * k + 1]);
+        float mb = hypotf(b[2 * k], b[2 * k + 1]);
+        if (mb < 1e-3f) continue;
+        float e = fabsf(ma / mb - 1.0f);
+        if (e > worst) worst = e;
+    }
+    return worst;
+}
+
+/*============================================================================
+ * Magnitude
+ *============================================================================*/
+
+TEST(approx_magnitude) {
+    block_normalizer_t bn;
+    float iq[2 * 37];
+    float worst = 0.0f;
+
+    /* Constant |x| = m from level m: the chunk's level update recovers the
+     * approximate magnitude as (level' - d * m) / (1 - d) */
+    for (int e = -20; e <= 20; e++) {
+        float m = powf(2.0f, e * 0.37f);
+        for (int k = 0; k < 37; k++) {
+            iq[2 * k] = m * (float)cos(0.3 * k);
+            iq[2 * k + 1] = m * (float)sin(0.3 * k);
+        }
+        block_normalizer_init(&bn);
+        bn.level = m;
+        bn.gain = 1.0f / m;
+        block_normalizer_process(&bn, iq, 37);
+        float d = bn.decay[0][37];
+        float approx = (block_normalizer_level(&bn) - d * m) / (1.0f - d);
+        float err = fabsf(approx / m - 1.0f);
+        if (err > worst) worst = err;
+    }
+    ASSERT_TRUE(worst < 0.002f, "magnitude within 0.2%");
+
+    block_normalizer_init(&bn);
+    memset(iq, 0, sizeof(iq));
+    block_normalizer_process(&bn, iq, 37);
+    ASSERT_TRUE(block_normalizer_level(&bn) < BLOCK_NORM_INITIAL_LEVEL, "zero input decays");
+    ASSERT_FALSE(isnan(iq[0]), "zero input stays finite");
+    PASS();
+}
+
+/*============================================================================
+ * Equivalence
+ *============================================================================*/
+
+TEST(matches_per_sample) {
+    float *ref = make_signal(N_SAMPLES);
+    float *blk = make_signal(N_SAMPLES);
+    block_normalizer_t a, b;
+    block_normalizer_init(&a);
+    block_normalizer_init(&b);
+
+    /* Reference one sample at a time; block path in waterfall-sized calls */
+    block_normalizer_process_per_sample(&a, ref, N_SAMPLES);
+    for (int pos = 0; pos < N_SAMPLES; pos += 102) {
+        int n = (N_SAMPLES - pos < 102) ? N_SAMPLES - pos : 102;
+        block_normalizer_process(&b, blk + 2 * pos, n);
+    }
+
+    /* The first chunk ramps from the initial level, and a chunk holding a
+     * level step spreads the gain change across it */
+    const int settle = 4 * BLOCK_NORM_CHUNK;
+    const int step1 = FS * 3 / 2, step2 = FS * 5 / 2;
+    const int c = BLOCK_NORM_CHUNK;
+    ASSERT_TRUE(worst_ratio_error(blk, ref, c, settle) < 0.05f, "fast warmup within 5%");
+    ASSERT_TRUE(worst_ratio_error(blk, ref, settle, FS) < 0.01f, "rest of warmup within 1%");
+    ASSERT_TRUE(worst_ratio_error(blk, ref, FS, step1 - c) < 0.003f, "steady state within 0.3%");
+    ASSERT_TRUE(worst_ratio_error(blk, ref, step1 + c, step2 - c) < 0.01f, "after -20 dB step within 1%");
+    ASSERT_TRUE(worst_ratio_error(blk, ref, step2 + c, N_SAMPLES) < 0.01f, "after +30 dB step within 1%");
+    ASSERT_TRUE(worst_ratio_error(blk, ref, N_SAMPLES - FS / 2, N_SAMPLES) < 0.003f, "settled again within 0.3%");
+    ASSERT_TRUE(worst_ratio_error(blk, ref, step1 - c, step1 + c) < 0.05f, "chunk across a step within 5%");
+    ASSERT_TRUE(worst_ratio_error(blk, ref, step2 - c, step2 + c) < 0.05f, "chunk across a step within 5%");
+    ASSERT_FLOAT_EQ(block_normalizer_level(&b) / block_normalizer_level(&a), 1.0f, 0.003f, "same level");
+    ASSERT_EQ(b.warmup, a.warmup, "warmup saturates the same");
+
+    free(ref);
+    free(blk);
+    PASS();
+}
+
+TEST(gain_continuous) {
+    /* Constant |x| = 1 input: output magnitude is the gain itself */
+    const int n = FS * 2;
+    float *iq = (float *)malloc((size_t)n * 2 * sizeof(float));
+    for (int k = 0; k < n; k++) {
+        float amp = (k < FS) ? 1.0f : 0.1f;          /* -20 dB step at 1 s */
+        iq[2 * k] = amp * (float)cos(0.01 * k);
+        iq[2 * k + 1] = amp * (float)sin(0.01 * k);
+    }
+
+    block_normalizer_t bn;
+    block_normalizer_init(&bn);
+    for (int pos = 0; pos < n; pos += 77) {
+        block_normalizer_process(&bn, iq + 2 * pos, (n - pos < 77) ? n - pos : 77);
+    }
+
+    float worst = 0.0f;
+    for (int k = FS / 2 + 1; k < n; k++) {
+        if (k == FS) continue;                          /* The input step itself */
+        float amp_prev = (k - 1 < FS) ? 1.0f : 0.1f;
+        float amp = (k < FS) ? 1.0f : 0.1f;
+        float g_prev = hypotf(iq[2 * (k - 1)], iq[2 * (k - 1) + 1]) / amp_prev;
+        float g = hypotf(iq[2 * k], iq[2 * k + 1]) / amp;
+        float jump = fabsf(g / g_prev - 1.0f);
+        if (jump > worst) worst = jump;
+    }
+    ASSERT_TRUE(worst < 1e-4f, "no gain step between samples after warmup");
+    free(iq);
+    PASS();
+}
+
+/*============================================================================
+ * Hold and Reset
+ *============================================================================*/
+
+TEST(hold_and_reset) {
+    float *iq = make_signal(FS);
+    block_normalizer_t bn;
+    block_normalizer_init(&bn);
+    block_normalizer_process(&bn, iq, FS / 2);
+
+    float level = block_normalizer_level(&bn);
+    float burst[2 * 64];
+    for (int k = 0; k < 64; k++) { burst[2 * k] = 10.0f; burst[2 * k + 1] = 0.0f; }
+    block_normalizer_hold(&bn, burst, 64);
+    ASSERT_TRUE(block_normalizer_level(&bn) == level, "held input leaves the level");
+    ASSERT_FLOAT_EQ(burst[0], 10.0f / level, 10.0f / level * 1e-6f, "current gain applied");
+
+    block_normalizer_reset(&bn);
+    ASSERT_TRUE(block_normalizer_level(&bn) == BLOCK_NORM_INITIAL_LEVEL, "level reset");
+    ASSERT_EQ(bn.warmup, 0, "warmup again");
+    free(iq);
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Block Normalizer Tests");
+
+    TEST_SECTION("Magnitude");
+    RUN_TEST(approx_magnitude);
+
+    TEST_SECTION("Equivalence");
+    RUN_TEST(matches_per_sample);
+    RUN_TEST(gain_continuous);
+
+    TEST_SECTION("Hold and Reset");
+    RUN_TEST(hold_and_reset);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,193 @@
+/**
+ * @file test_cmd_table.c
+ * @brief Unit tests for the table-driven command parser
+ *
+ * - Perfect-hash build: every name found, case-insensitive, near misses
+ *   rejected, duplicates and oversized tables refused, 128 names fit
+ * - In-place tokenization: tokens point into the line, CR/LF/tabs handled
+ * - Typed arguments: whole-token numbers, ranges, choices, argument counts
+ */
+
+#include "test_framework.h"
+#include "cmd_table.h"
+#include <stdio.h>
+#include <string.h>
+
+/*============================================================================
+ * Test Grammar
+ *============================================================================*/
+
+enum { T_PING, T_SET_FREQ, T_SET_GAIN, T_SET_AGC, T_SET_BIAST, T_ECHO };
+
+static const char *const g_agc[] = { "OFF", "5HZ", "50HZ", NULL };
+static const char *const g_on_off[] = { "ON", "OFF", NULL };
+static const int g_tag = 42;
+
+static const cmd_spec_t g_specs[] = {
+    { "PING",      T_PING,      0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    { "SET_FREQ",  T_SET_FREQ,  1, 1, { CMD_SPEC_FLOAT(1000, 2e9) }, &g_tag },
+    { "SET_GAIN",  T_SET_GAIN,  1, 1, { CMD_SPEC_INT(20, 59) }, NULL },
+    { "SET_AGC",   T_SET_AGC,   1, 1, { CMD_SPEC_CHOICE(g_agc) }, NULL },
+    { "SET_BIAST", T_SET_BIAST, 1, 2, { CMD_SPEC_CHOICE(g_on_off), CMD_SPEC_WORD }, NULL },
+    { "ECHO",      T_ECHO,      0, CMD_TABLE_MAX_ARGS, { CMD_SPEC_NO_ARGS }, NULL },
+};
+
+#define NUM_SPECS ((int)(sizeof(g_specs) / sizeof(g_specs[0])))
+
+static cmd_table_t g_table;
+
+static cmd_table_status_t parse(const char *text, char *buf, size_t size, cmd_parsed_t *p) {
+    snprintf(buf, size, "%s", text);
+    return cmd_table_parse(&g_table, buf, p);
+}
+
+/*============================================================================
+ * Build / Lookup
+ *============================================================================*/
+
+TEST(build_and_find) {
+    ASSERT_TRUE(cmd_table_build(&g_table, g_specs, NUM_SPECS), "table builds");
+
+    for (int i = 0; i < NUM_SPECS; i++) {
+        const cmd_spec_t *s = cmd_table_find(&g_table, g_specs[i].name, strlen(g_specs[i].name));
+        ASSERT_TRUE(s == &g_specs[i], "every name maps to its own spec");
+    }
+    ASSERT_TRUE(cmd_table_find(&g_table, "set_freq", 8) == &g_specs[1], "lower case");
+    ASSERT_TRUE(cmd_table_find(&g_table, "Set_Agc", 7) == &g_specs[3], "mixed case");
+    ASSERT_NULL(cmd_table_find(&g_table, "SET_FRE", 7), "prefix rejected");
+    ASSERT_NULL(cmd_table_find(&g_table, "SET_FREQX", 9), "extension rejected");
+    ASSERT_NULL(cmd_table_find(&g_table, "SET_FREQ", 7), "length respected");
+    ASSERT_NULL(cmd_table_find(&g_table, "", 0), "empty name");
+    PASS();
+}
+
+TEST(build_rejects) {
+    cmd_table_t t;
+    static const cmd_spec_t dup[] = {
+        { "PING", 0, 0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+        { "ping", 1, 0, 0, { CMD_SPEC_NO_ARGS }, NULL },
+    };
+    ASSERT_FALSE(cmd_table_build(&t, dup, 2), "case-insensitive duplicate refused");
+    ASSERT_FALSE(cmd_table_build(&t, g_specs, 0), "empty table refused");
+
+    /* Largest table the slots allow, then one more */
+    static char names[CMD_TABLE_MAX_SLOTS / 2 + 1][16];
+    static cmd_spec_t many[CMD_TABLE_MAX_SLOTS / 2 + 1];
+    for (int i = 0; i <= CMD_TABLE_MAX_SLOTS / 2; i++) {
+        snprintf(names[i], sizeof(names[i]), "SET_P%03d", i);
+        many[i].name = names[i];
+        many[i].id = i;
+    }
+    ASSERT_TRUE(cmd_table_build(&t, many, CMD_TABLE_MAX_SLOTS / 2), "128 names fit");
+    for (int i = 0; i < CMD_TABLE_MAX_SLOTS / 2; i++) {
+        ASSERT_TRUE(cmd_table_find(&t, names[i], strlen(names[i])) == &many[i], "each found");
+    }
+    ASSERT_FALSE(cmd_table_build(&t, many, CMD_TABLE_MAX_SLOTS / 2 + 1), "129 refused");
+    PASS();
+}
+
+/*============================================================================
+ * Tokenization
+ *============================================================================*/
+
+TEST(tokenize_in_place) {
+    char buf[128];
+    cmd_parsed_t p;
+
+    ASSERT_EQ(parse("  ECHO\ta  bb\tccc \r\n", buf, sizeof(buf), &p), CMD_TABLE_OK, "parses");
+    ASSERT_STR_EQ(p.name, "ECHO", "name");
+    ASSERT_EQ(p.argc, 3, "three arguments");
+    ASSERT_STR_EQ(p.argv[0].text, "a", "arg 0");
+    ASSERT_STR_EQ(p.argv[1].text, "bb", "arg 1");
+    ASSERT_STR_EQ(p.argv[2].text, "ccc", "arg 2");
+    ASSERT_TRUE(p.name >= buf && p.argv[2].text < buf + sizeof(buf), "tokens point into the line");
+
+    ASSERT_EQ(parse("PING\n", buf, sizeof(buf), &p), CMD_TABLE_OK, "trailing LF");
+    ASSERT_EQ(parse("PING\r", buf, sizeof(buf), &p), CMD_TABLE_OK, "trailing CR");
+    ASSERT_EQ(parse("PING\nSET_GAIN 1", buf, sizeof(buf), &p), CMD_TABLE_OK, "stops at LF");
+    ASSERT_EQ(p.argc, 0, "nothing after LF");
+
+    ASSERT_EQ(parse("", buf, sizeof(buf), &p), CMD_TABLE_ERR_EMPTY, "empty");
+    ASSERT_NULL(p.name, "no name");
+    ASSERT_EQ(parse(" \t \r\n", buf, sizeof(buf), &p), CMD_TABLE_ERR_EMPTY, "blank");
+    ASSERT_EQ(parse("NOPE 1", buf, sizeof(buf), &p), CMD_TABLE_ERR_UNKNOWN, "unknown");
+    ASSERT_STR_EQ(p.name, "NOPE", "unknown name reported");
+    ASSERT_NULL(p.spec, "no spec");
+    PASS();
+}
+
+/*============================================================================
+ * Typed Arguments
+ *============================================================================*/
+
+TEST(numbers) {
+    char buf[128];
+    cmd_parsed_t p;
+
+    ASSERT_EQ(parse("SET_FREQ 15e6", buf, sizeof(buf), &p), CMD_TABLE_OK, "exponent");
+    ASSERT_FLOAT_EQ(p.argv[0].f, 15e6, 1e-3, "value");
+    ASSERT_TRUE(p.spec->data == &g_tag, "context pointer");
+    ASSERT_EQ(parse("SET_FREQ 1000", buf, sizeof(buf), &p), CMD_TABLE_OK, "min inclusive");
+    ASSERT_EQ(parse("SET_FREQ 999.9", buf, sizeof(buf), &p), CMD_TABLE_ERR_RANGE, "below min");
+    ASSERT_EQ(parse("SET_FREQ 1e99", buf, sizeof(buf), &p), CMD_TABLE_ERR_RANGE, "above max");
+    ASSERT_EQ(parse("SET_FREQ inf", buf, sizeof(buf), &p), CMD_TABLE_ERR_RANGE, "not finite");
+    ASSERT_EQ(parse("SET_FREQ 1e6x", buf, sizeof(buf), &p), CMD_TABLE_ERR_TYPE, "trailing junk");
+    ASSERT_EQ(p.bad_arg, 0, "bad argument index");
+
+    ASSERT_EQ(parse("set_gain 40", buf, sizeof(buf), &p), CMD_TABLE_OK, "integer");
+    ASSERT_EQ(p.argv[0].i, 40, "integer value");
+    ASSERT_FLOAT_EQ(p.argv[0].f, 40.0, 1e-9, "integer also as double");
+    ASSERT_EQ(parse("SET_GAIN 40.5", buf, sizeof(buf), &p), CMD_TABLE_ERR_TYPE, "fraction is not an int");
+    ASSERT_EQ(parse("SET_GAIN abc", buf, sizeof(buf), &p), CMD_TABLE_ERR_TYPE, "word is not an int");
+    ASSERT_EQ(parse("SET_GAIN 60", buf, sizeof(buf), &p), CMD_TABLE_ERR_RANGE, "int range");
+    ASSERT_EQ(parse("SET_GAIN 99999999999999999999", buf, sizeof(buf), &p), CMD_TABLE_ERR_RANGE,
+              "overflow");
+    PASS();
+}
+
+TEST(choices_and_counts) {
+    char buf[128];
+    cmd_parsed_t p;
+
+    ASSERT_EQ(parse("SET_AGC 50hz", buf, sizeof(buf), &p), CMD_TABLE_OK, "choice, any case");
+    ASSERT_EQ(p.argv[0].choice, 2, "choice index");
+    ASSERT_EQ(parse("SET_AGC 10HZ", buf, sizeof(buf), &p), CMD_TABLE_ERR_CHOICE, "not a choice");
+    ASSERT_EQ(parse("SET_AGC 5HZZ", buf, sizeof(buf), &p), CMD_TABLE_ERR_CHOICE, "choice extension");
+
+    ASSERT_EQ(parse("SET_BIAST ON confirm", buf, sizeof(buf), &p), CMD_TABLE_OK, "optional word");
+    ASSERT_EQ(p.argc, 2, "two arguments");
+    ASSERT_EQ(p.argv[1].choice, -1, "free word has no choice");
+    ASSERT_EQ(parse("SET_BIAST maybe", buf, sizeof(buf), &p), CMD_TABLE_ERR_CHOICE, "first arg checked");
+    ASSERT_EQ(parse("SET_BIAST ON CONFIRM X", buf, sizeof(buf), &p), CMD_TABLE_ERR_ARGC, "too many");
+    ASSERT_EQ(parse("SET_BIAST", buf, sizeof(buf), &p), CMD_TABLE_ERR_ARGC, "too few");
+    ASSERT_TRUE(p.spec == &g_specs[4], "spec reported on argument errors");
+    ASSERT_EQ(parse("PING x", buf, sizeof(buf), &p), CMD_TABLE_ERR_ARGC, "no-arg command");
+
+    ASSERT_EQ(parse("ECHO 1 2 3 4 5 6 7 8", buf, sizeof(buf), &p), CMD_TABLE_OK, "max arguments");
+    ASSERT_EQ(parse("ECHO 1 2 3 4 5 6 7 8 9", buf, sizeof(buf), &p), CMD_TABLE_ERR_ARGC,
+              "beyond CMD_TABLE_MAX_ARGS");
+    ASSERT_STR_EQ(cmd_table_status_name(CMD_TABLE_ERR_CHOICE), "CHOICE", "status name");
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Command Table Tests");
+
+    TEST_SECTION("Build / Lookup");
+    RUN_TEST(build_and_find);
+    RUN_TEST(build_rejects);
+
+    TEST_SECTION("Tokenization");
+    RUN_TEST(tokenize_in_place);
+
+    TEST_SECTION("Typed Arguments");
+    RUN_TEST(numbers);
+    RUN_TEST(choices_and_counts);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,189 @@
+/**
+ * @file test_decimator.c
+ * @brief Unit tests for decimator module
+ *
+ * 2 MSPS S16 tones through the three stages to 48 kHz:
+ * - Output count matches the 2M/48k ratio
+ * - Tone amplitude kept (unity gain through all stages, flat to 5 kHz)
+ * - Tone frequency kept at +/- offsets across the passband
+ * - Out-of-band tone rejected
+ * - Any block split gives the same output as one call
+ */
+
+#include "test_framework.h"
+#include "decimator.h"
+#include <math.h>
+#include <stdlib.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+#define IN_RATE     2000000
+#define IN_SAMPLES  (IN_RATE / 2)           /* 0.5 s */
+#define IN_BLOCK    8000
+#define OUT_MAX     (IN_SAMPLES / 40)       /* 25000, above the 24000 expected */
+#define SETTLE      2400                    /* 50 ms of output skipped */
+#define TONE_AMP    0.5
+
+static int16_t g_xi[IN_SAMPLES];
+static int16_t g_xq[IN_SAMPLES];
+static decim_complex_t g_out[OUT_MAX];
+static decim_complex_t g_split[OUT_MAX];
+
+static void make_tone(double hz, double amp) {
+    for (int n = 0; n < IN_SAMPLES; n++) {
+        double ph = 2.0 * M_PI * hz * n / IN_RATE;
+        g_xi[n] = (int16_t)lrint(amp * 32767.0 * cos(ph));
+        g_xq[n] = (int16_t)lrint(amp * 32767.0 * sin(ph));
+    }
+}
+
+static size_t decimate_tone(double hz, double amp, decim_complex_t *out) {
+    decim_state_t *d = NULL;
+    if (decim_create(&d, DECIM_INPUT_RATE, DECIM_OUTPUT_RATE) != DECIM_OK) return 0;
+    make_tone(hz, amp);
+
+    /* RSP-sized blocks; one call takes at most 64K input pairs */
+    size_t n = 0;
+    for (size_t pos = 0; pos < IN_SAMPLES; pos += IN_BLOCK) {
+        size_t got = 0;
+        if (decim_process_int16(d, g_xi + pos, g_xq + pos, IN_BLOCK,
+                                out + n, OUT_MAX - n, &got) != DECIM_OK) {
+            n = 0;
+            break;
+        }
+        n += got;
+    }
+    decim_destroy(d);
+    return n;
+}
+
+/* RMS magnitude of the settled output */
+static double out_amplitude(const decim_complex_t *out, size_t n) {
+    double acc = 0.0;
+    for (size_t k = SETTLE; k < n; k++) acc += out[k].i * out[k].i + out[k].q * out[k].q;
+    return sqrt(acc / (double)(n - SETTLE));
+}
+
+/* Frequency from the mean lag-1 phase step */
+static double out_frequency(const decim_complex_t *out, size_t n) {
+    double re = 0.0, im = 0.0;
+    for (size_t k = SETTLE + 1; k < n; k++) {
+        re += out[k].i * out[k - 1].i + out[k].q * out[k - 1].q;
+        im += out[k].q * out[k - 1].i - out[k].i * out[k - 1].q;
+    }
+    return atan2(im, re) * DECIM_OUTPUT_RATE / (2.0 * M_PI);
+}
+
+/*============================================================================
+ * Rate Tests
+ *============================================================================*/
+
+TEST(output_count_matches_ratio) {
+    size_t n = decimate_tone(1000.0, TONE_AMP, g_out);
+    ASSERT(n >= 23990 && n <= 24000, "0.5 s in, 24000 pairs out");
+
+    decim_state_t *d = NULL;
+    ASSERT_EQ(decim_create(&d, DECIM_INPUT_RATE, DECIM_OUTPUT_RATE), DECIM_OK, "create");
+    ASSERT_FLOAT_EQ(decim_get_output_rate(d), DECIM_OUTPUT_RATE, 1e-6, "output rate");
+    ASSERT_FLOAT_EQ(decim_get_ratio(d), DECIM_INPUT_RATE / DECIM_OUTPUT_RATE, 1e-9, "ratio");
+    decim_destroy(d);
+    PASS();
+}
+
+/*============================================================================
+ * Tone Tests
+ *============================================================================*/
+
+TEST(tone_amplitude_kept) {
+    /* Flat to +/-5 kHz; the short stage 2/3 filters roll off above that */
+    static const double flat[] = { 0.0, 100.0, 1000.0, -1000.0, -2500.0, 5000.0, -5000.0 };
+    for (size_t t = 0; t < sizeof(flat) / sizeof(flat[0]); t++) {
+        size_t n = decimate_tone(flat[t], TONE_AMP, g_out);
+        ASSERT(n > SETTLE, "output");
+        ASSERT_FLOAT_EQ(out_amplitude(g_out, n), TONE_AMP, TONE_AMP * 0.035, "unity gain within 0.3 dB");
+    }
+    size_t n = decimate_tone(10000.0, TONE_AMP, g_out);
+    double pos = out_amplitude(g_out, n);
+    n = decimate_tone(-10000.0, TONE_AMP, g_out);
+    double neg = out_amplitude(g_out, n);
+    ASSERT(pos > TONE_AMP * 0.84, "10 kHz down < 1.5 dB");
+    ASSERT_FLOAT_EQ(pos, neg, 1e-3, "same response at +f and -f");
+    PASS();
+}
+
+TEST(tone_frequency_kept) {
+    static const double tones[] = { 100.0, 1000.0, -1000.0, 5000.0, -7500.0, 10000.0 };
+    for (size_t t = 0; t < sizeof(tones) / sizeof(tones[0]); t++) {
+        size_t n = decimate_tone(tones[t], TONE_AMP, g_out);
+        ASSERT(n > SETTLE, "output");
+        ASSERT_FLOAT_EQ(out_frequency(g_out, n), tones[t], 0.5, "frequency at 48 kHz");
+    }
+    PASS();
+}
+
+TEST(out_of_band_rejected) {
+    /* 40 kHz is past the 24 kHz output Nyquist: would alias to -8 kHz */
+    size_t n = decimate_tone(40000.0, TONE_AMP, g_out);
+    ASSERT(n > SETTLE, "output");
+    ASSERT(20.0 * log10(out_amplitude(g_out, n) / TONE_AMP) < -30.0, "40 kHz down > 30 dB");
+    n = decimate_tone(-60000.0, TONE_AMP, g_out);
+    ASSERT(20.0 * log10(out_amplitude(g_out, n) / TONE_AMP) < -45.0, "60 kHz down > 45 dB");
+    PASS();
+}
+
+/*============================================================================
+ * Block Tests
+ *============================================================================*/
+
+TEST(block_split_invariant) {
+    size_t n = decimate_tone(3000.0, TONE_AMP, g_out);
+    ASSERT(n > 0, "one call");
+
+    decim_state_t *d = NULL;
+    ASSERT_EQ(decim_create(&d, DECIM_INPUT_RATE, DECIM_OUTPUT_RATE), DECIM_OK, "create");
+    size_t total = 0, pos = 0;
+    uint32_t lcg = 7;
+    while (pos < IN_SAMPLES) {
+        lcg = lcg * 1664525u + 1013904223u;
+        size_t len = 1 + (lcg >> 16) % 5000;       /* Blocks not a multiple of 8, 40 or 125 */
+        if (len > IN_SAMPLES - pos) len = IN_SAMPLES - pos;
+        size_t got = 0;
+        ASSERT_EQ(decim_process_int16(d, g_xi + pos, g_xq + pos, len,
+                                      g_split + total, OUT_MAX - total, &got), DECIM_OK, "block");
+        total += got;
+        pos += len;
+    }
+    decim_destroy(d);
+
+    ASSERT_EQ(total, n, "same count");
+    ASSERT_EQ(memcmp(g_split, g_out, n * sizeof(decim_complex_t)), 0, "bit-identical");
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Decimator Tests");
+
+    TEST_SECTION("Rate");
+    RUN_TEST(output_count_matches_ratio);
+
+    TEST_SECTION("Tones");
+    RUN_TEST(tone_amplitude_kept);
+    RUN_TEST(tone_frequency_kept);
+    RUN_TEST(out_of_band_rejected);
+
+    TEST_SECTION("Blocks");
+    RUN_TEST(block_split_invariant);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
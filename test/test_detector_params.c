@@ -0,0 +1,323 @@
+/**
+ * @file test_detector_params.c
+ * @brief Unit tests for detector_params module
+ *
+ * - Parameter table lookup and range checking
+ * - Versioned publish / reader poll, stale drafts refused
+ * - INI round trip and file watch reload
+ * - Audit log entries
+ */
+
+#include "test_framework.h"
+#include "../tools/detector_params.h"
+
+#define TEST_INI_PATH   "test_detector_params.ini"
+#define TEST_AUDIT_PATH "test_detector_params_audit.log"
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+/* Valid snapshot: every parameter at the midpoint of its range */
+static void make_valid_params(detector_params_t *p) {
+    memset(p, 0, sizeof(*p));
+    for (int i = 0; i < detector_params_count(); i++) {
+        const detector_param_desc_t *d = detector_params_desc(i);
+        float mid = (d->min + d->max) * 0.5f;
+        detector_params_set(p, d, d->is_int ? (float)(int)mid : mid);
+    }
+}
+
+static void cleanup_files(void) {
+    remove(TEST_INI_PATH);
+    remove(TEST_AUDIT_PATH);
+}
+
+static int count_lines_containing(const char *path, const char *needle) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+    char line[256];
+    int count = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (strstr(line, needle)) count++;
+    }
+    fclose(f);
+    return count;
+}
+
+/*============================================================================
+ * Parameter Table Tests
+ *============================================================================*/
+
+TEST(params_table_lookup) {
+    ASSERT_EQ(detector_params_count(), 22, "22 tunable parameters");
+    ASSERT_NOT_NULL(detector_params_find("tick_detector", "threshold_multiplier"), "tick threshold");
+    ASSERT_NOT_NULL(detector_params_find("marker_detector", "threshold_multiplier"), "marker threshold");
+    ASSERT_NOT_NULL(detector_params_find("sync_detector", "p_marker_tolerance_ms"), "sync tolerance");
+    ASSERT_NULL(detector_params_find("sync_detector", "no_such_key"), "unknown key");
+    ASSERT_NULL(detector_params_find("nope", "threshold_multiplier"), "unknown section");
+    ASSERT_NULL(detector_params_desc(-1), "index below range");
+    ASSERT_NULL(detector_params_desc(detector_params_count()), "index above range");
+    PASS();
+}
+
+TEST(params_range_check) {
+    detector_params_t p;
+    make_valid_params(&p);
+    ASSERT_TRUE(detector_params_validate(&p, NULL), "midpoints validate");
+
+    const detector_param_desc_t *d = detector_params_find("tick_detector", "threshold_multiplier");
+    ASSERT_EQ(detector_params_set(&p, d, 2.5f), DETECTOR_PARAM_OK, "in range");
+    ASSERT_FLOAT_EQ(p.tick_threshold_mult, 2.5f, 1e-6f, "value stored");
+    ASSERT_EQ(detector_params_set(&p, d, 6.0f), DETECTOR_PARAM_ERR_RANGE, "above range");
+    ASSERT_FLOAT_EQ(p.tick_threshold_mult, 2.5f, 1e-6f, "rejected value not stored");
+    ASSERT_EQ(detector_params_set(&p, NULL, 1.0f), DETECTOR_PARAM_ERR_UNKNOWN, "NULL descriptor");
+
+    const detector_param_desc_t *misses = detector_params_find("tick_correlator", "max_consecutive_misses");
+    ASSERT_EQ(detector_params_set(&p, misses, 7.0f), DETECTOR_PARAM_OK, "int param");
+    ASSERT_EQ(p.corr_max_misses, 7, "int stored as int");
+
+    const detector_param_desc_t *bad = NULL;
+    p.sync_decay_normal = 0.5f;
+    ASSERT_FALSE(detector_params_validate(&p, &bad), "invalid field caught");
+    ASSERT_NOT_NULL(bad, "bad descriptor reported");
+    ASSERT_STR_EQ(bad->key, "confidence_decay_normal", "correct field reported");
+    PASS();
+}
+
+/*============================================================================
+ * Store Tests
+ *============================================================================*/
+
+TEST(store_rejects_invalid_initial) {
+    detector_params_t p;
+    make_valid_params(&p);
+    p.marker_min_duration_ms = 10.0f;
+    ASSERT_NULL(detector_param_store_create(&p, NULL), "invalid initial snapshot");
+    PASS();
+}
+
+TEST(store_publish_and_poll) {
+    detector_params_t p, out;
+    make_valid_params(&p);
+    detector_param_store_t *store = detector_param_store_create(&p, NULL);
+    ASSERT_NOT_NULL(store, "create");
+    ASSERT_EQ(detector_param_store_version(store), 1, "starts at v1");
+
+    uint32_t applied = 0;
+    ASSERT_TRUE(detector_param_store_poll(store, &applied, &out), "initial snapshot delivered");
+    ASSERT_EQ(applied, 1, "applied v1");
+    ASSERT_FALSE(detector_param_store_poll(store, &applied, &out), "nothing new");
+
+    /* Related parameters change together in one version */
+    detector_params_t draft;
+    detector_param_store_snapshot(store, &draft);
+    draft.sync_weight_tick = 0.1f;
+    draft.sync_weight_marker = 0.5f;
+    ASSERT_EQ(detector_param_store_publish(store, &draft, "test"), 2, "published v2");
+
+    ASSERT_TRUE(detector_param_store_poll(store, &applied, &out), "v2 delivered");
+    ASSERT_EQ(out.version, 2, "snapshot carries version");
+    ASSERT_FLOAT_EQ(out.sync_weight_tick, 0.1f, 1e-6f, "first field");
+    ASSERT_FLOAT_EQ(out.sync_weight_marker, 0.5f, 1e-6f, "second field");
+
+    /* Identical draft is not a new version */
+    ASSERT_EQ(detector_param_store_publish(store, &draft, "test"), 0, "no-op publish");
+
+    /* Invalid draft never becomes current */
+    draft.tick_adapt_alpha_up = 1.0f;
+    ASSERT_EQ(detector_param_store_publish(store, &draft, "test"), 0, "invalid publish");
+    ASSERT_EQ(detector_param_store_version(store), 2, "still v2");
+
+    detector_param_store_destroy(store);
+    PASS();
+}
+
+TEST(store_refuses_stale_draft) {
+    detector_params_t p;
+    make_valid_params(&p);
+    detector_param_store_t *store = detector_param_store_create(&p, NULL);
+    ASSERT_NOT_NULL(store, "create");
+
+    /* Two writers start from v1 */
+    detector_params_t udp, ini;
+    detector_param_store_snapshot(store, &udp);
+    detector_param_store_snapshot(store, &ini);
+    udp.corr_max_misses = 3;
+    ini.tick_threshold_mult = 2.5f;
+
+    ASSERT_EQ(detector_param_store_publish(store, &ini, "ini"), 2, "first writer wins");
+    ASSERT_EQ(detector_param_store_publish(store, &udp, "udp"), DETECTOR_PARAM_STORE_CONFLICT,
+              "stale draft refused");
+    ASSERT_EQ(detector_param_store_version(store), 2, "still v2");
+
+    /* Re-snapshot and re-apply keeps both edits */
+    detector_param_store_snapshot(store, &udp);
+    udp.corr_max_misses = 3;
+    ASSERT_EQ(detector_param_store_publish(store, &udp, "udp"), 3, "retry published v3");
+
+    detector_params_t out;
+    detector_param_store_snapshot(store, &out);
+    ASSERT_FLOAT_EQ(out.tick_threshold_mult, 2.5f, 1e-6f, "ini edit kept");
+    ASSERT_EQ(out.corr_max_misses, 3, "udp edit kept");
+
+    detector_param_store_destroy(store);
+    PASS();
+}
+
+TEST(store_reader_skips_to_latest) {
+    detector_params_t p, out;
+    make_valid_params(&p);
+    detector_param_store_t *store = detector_param_store_create(&p, NULL);
+    ASSERT_NOT_NULL(store, "create");
+
+    uint32_t applied = 0;
+    detector_param_store_poll(store, &applied, &out);
+
+    /* Many publishes between two blocks - reader only sees the last one */
+    detector_params_t draft;
+    for (int i = 0; i < 50; i++) {
+        detector_param_store_snapshot(store, &draft);
+        draft.tick_threshold_mult = 1.0f + 0.05f * (float)(i + 1);
+        detector_param_store_publish(store, &draft, "test");
+    }
+
+    ASSERT_TRUE(detector_param_store_poll(store, &applied, &out), "latest delivered");
+    ASSERT_EQ(applied, 51, "jumped to v51");
+    ASSERT_FLOAT_EQ(out.tick_threshold_mult, 3.5f, 1e-4f, "latest value");
+
+    detector_param_store_destroy(store);
+    PASS();
+}
+
+/*============================================================================
+ * INI and Audit Tests
+ *============================================================================*/
+
+TEST(ini_round_trip) {
+    cleanup_files();
+    detector_params_t p, loaded;
+    make_valid_params(&p);
+    p.tick_min_duration_ms = 4.25f;
+    p.corr_max_misses = 9;
+    ASSERT_TRUE(detector_params_save_ini(TEST_INI_PATH, &p), "save");
+
+    memset(&loaded, 0, sizeof(loaded));
+    int rejected = -1;
+    ASSERT_EQ(detector_params_load_ini(TEST_INI_PATH, &loaded, &rejected), 22, "all loaded");
+    ASSERT_EQ(rejected, 0, "none rejected");
+    ASSERT_FLOAT_EQ(loaded.tick_min_duration_ms, 4.25f, 0.01f, "float round trip");
+    ASSERT_EQ(loaded.corr_max_misses, 9, "int round trip");
+    ASSERT_TRUE(detector_params_validate(&loaded, NULL), "loaded set valid");
+
+    /* Same key in two sections stays separate */
+    ASSERT_FLOAT_EQ(loaded.marker_threshold_mult, p.marker_threshold_mult, 0.001f, "marker threshold");
+    ASSERT_FLOAT_EQ(loaded.tick_threshold_mult, p.tick_threshold_mult, 0.001f, "tick threshold");
+
+    ASSERT_EQ(detector_params_load_ini("no_such_file.ini", &loaded, NULL), -1, "missing file");
+    cleanup_files();
+    PASS();
+}
+
+TEST(ini_rejects_out_of_range) {
+    cleanup_files();
+    FILE *f = fopen(TEST_INI_PATH, "w");
+    ASSERT_NOT_NULL(f, "write ini");
+    fprintf(f, "; comment\n[tick_detector]\nthreshold_multiplier = 9.0\nmin_duration_ms=3.0\n");
+    fprintf(f, "[unknown]\nfoo=1\n");
+    fclose(f);
+
+    detector_params_t p;
+    make_valid_params(&p);
+    float before = p.tick_threshold_mult;
+    int rejected = 0;
+    ASSERT_EQ(detector_params_load_ini(TEST_INI_PATH, &p, &rejected), 1, "one valid value");
+    ASSERT_EQ(rejected, 1, "one rejected");
+    ASSERT_FLOAT_EQ(p.tick_threshold_mult, before, 1e-6f, "rejected value kept default");
+    ASSERT_FLOAT_EQ(p.tick_min_duration_ms, 3.0f, 1e-6f, "valid value applied");
+    cleanup_files();
+    PASS();
+}
+
+TEST(ini_watch_reloads) {
+    cleanup_files();
+    detector_params_t p, out;
+    make_valid_params(&p);
+    detector_param_store_t *store = detector_param_store_create(&p, TEST_AUDIT_PATH);
+    ASSERT_NOT_NULL(store, "create");
+
+    detector_param_store_watch_ini(store, TEST_INI_PATH);
+    ASSERT_TRUE(detector_param_store_save_ini(store), "save current");
+    ASSERT_EQ(detector_param_store_check_ini(store), 0, "own write does not reload");
+
+    /* External edit - different length so the change is visible within one second */
+    FILE *f = fopen(TEST_INI_PATH, "w");
+    ASSERT_NOT_NULL(f, "edit ini");
+    fprintf(f, "[sync_detector]\nweight_tick=0.150\n");
+    fclose(f);
+
+    uint32_t version = detector_param_store_check_ini(store);
+    ASSERT_EQ(version, 2, "reload published v2");
+
+    uint32_t applied = 1;
+    ASSERT_TRUE(detector_param_store_poll(store, &applied, &out), "reader sees reload");
+    ASSERT_FLOAT_EQ(out.sync_weight_tick, 0.15f, 1e-6f, "reloaded value");
+    ASSERT_FLOAT_EQ(out.sync_weight_marker, p.sync_weight_marker, 1e-6f, "untouched keys unchanged");
+    ASSERT_EQ(detector_param_store_check_ini(store), 0, "no further change");
+
+    ASSERT_EQ(count_lines_containing(TEST_AUDIT_PATH, "[ini] sync_detector.weight_tick"), 1,
+              "audit entry for reload");
+
+    detector_param_store_destroy(store);
+    cleanup_files();
+    PASS();
+}
+
+TEST(audit_log_records_changes) {
+    cleanup_files();
+    detector_params_t p;
+    make_valid_params(&p);
+    detector_param_store_t *store = detector_param_store_create(&p, TEST_AUDIT_PATH);
+    ASSERT_NOT_NULL(store, "create");
+
+    detector_params_t draft;
+    detector_param_store_snapshot(store, &draft);
+    draft.marker_noise_adapt_rate = 0.002f;
+    draft.corr_max_misses = 3;
+    detector_param_store_publish(store, &draft, "udp");
+
+    ASSERT_EQ(count_lines_containing(TEST_AUDIT_PATH, " v2 [udp] "), 2, "one line per changed field");
+    ASSERT_EQ(count_lines_containing(TEST_AUDIT_PATH, "tick_correlator.max_consecutive_misses 6 -> 3"), 1,
+              "old and new value logged");
+
+    detector_param_store_destroy(store);
+    cleanup_files();
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Detector Parameter Store Tests");
+
+    TEST_SECTION("Parameter Table");
+    RUN_TEST(params_table_lookup);
+    RUN_TEST(params_range_check);
+
+    TEST_SECTION("Store");
+    RUN_TEST(store_rejects_invalid_initial);
+    RUN_TEST(store_publish_and_poll);
+    RUN_TEST(store_refuses_stale_draft);
+    RUN_TEST(store_reader_skips_to_latest);
+
+    TEST_SECTION("INI and Audit");
+    RUN_TEST(ini_round_trip);
+    RUN_TEST(ini_rejects_out_of_range);
+    RUN_TEST(ini_watch_reloads);
+    RUN_TEST(audit_log_records_changes);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,283 @@
+/**
+ * @file test_detector_rate.c
+ * @brief Unit tests for runtime detector input rates
+ *
+ * - Rate profile: FFT sizes at 50k / 48k / 12k / 2.4M, range checks
+ * - Tick detector finds the same ticks at 50k, 48k, 12k and a generic
+ *   (non-specialized) 96k matched filter
+ * - BCD time detector pulse width and tone tracker offset at 48k
+ * - BCD time detector on the ÷32 filter bank subband: same pulses as at 50k
+ * - Slow marker detector bins from the caller's FFT
+ */
+
+#include "test_framework.h"
+#include "../tools/detector_rate.h"
+#include "../tools/tick_detector.h"
+#include "../tools/bcd_time_detector.h"
+#include "../tools/tone_tracker.h"
+#include "../tools/slow_marker_detector.h"
+#include "../tools/fft_filter_bank.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define MAX_TICKS   16
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+typedef struct {
+    float timestamp_ms[MAX_TICKS];
+    int count;
+} tick_log_t;
+
+static void log_tick(const tick_event_t *event, void *user_data) {
+    tick_log_t *log = (tick_log_t *)user_data;
+    if (log->count < MAX_TICKS) log->timestamp_ms[log->count++] = event->timestamp_ms;
+}
+
+static float g_bcd_duration_ms;
+static int g_bcd_pulses;
+
+static void log_bcd(const bcd_time_event_t *event, void *user_data) {
+    (void)user_data;
+    g_bcd_duration_ms = event->duration_ms;
+    g_bcd_pulses++;
+}
+
+typedef struct {
+    float start_ms[MAX_TICKS];
+    float duration_ms[MAX_TICKS];
+    int count;
+} bcd_log_t;
+
+static void log_bcd_pulse(const bcd_time_event_t *event, void *user_data) {
+    bcd_log_t *log = (bcd_log_t *)user_data;
+    if (log->count < MAX_TICKS) {
+        log->start_ms[log->count] = event->timestamp_ms;
+        log->duration_ms[log->count] = event->duration_ms;
+        log->count++;
+    }
+}
+
+static float noise(uint32_t *lcg, float amplitude) {
+    *lcg = *lcg * 1664525u + 1013904223u;
+    return amplitude * ((float)(*lcg >> 8) / 16777216.0f - 0.5f);
+}
+
+/* Four seconds of WWV-like ticks (5 ms of 1000 Hz at each second) in noise */
+static void run_ticks(int rate, tick_log_t *log) {
+    tick_detector_t *td = tick_detector_create_rate(NULL, rate);
+    tick_detector_set_callback(td, log_tick, log);
+
+    uint32_t lcg = 3;
+    for (int n = 0; n < rate * 4; n++) {
+        double t = (double)n / rate;
+        double in_second = t - floor(t);
+        float amp = (t >= 1.0 && in_second < 0.005) ? 0.8f : 0.0f;
+        double ph = 2.0 * M_PI * 1000.0 * t;
+        tick_detector_process_sample(td, amp * (float)cos(ph) + noise(&lcg, 0.02f),
+                                         amp * (float)sin(ph) + noise(&lcg, 0.02f));
+    }
+    tick_detector_destroy(td);
+}
+
+/*============================================================================
+ * Rate Profile
+ *============================================================================*/
+
+TEST(profile_fft_sizes) {
+    detector_rate_t dr;
+
+    ASSERT_TRUE(detector_rate_init(&dr, 50000, 50000, 256), "nominal");
+    ASSERT_EQ(dr.fft_size, 256, "nominal size unchanged");
+    ASSERT_FLOAT_EQ(dr.frame_ms, 5.12f, 1e-4f, "5.12 ms frame");
+
+    ASSERT_TRUE(detector_rate_init(&dr, 48000, 50000, 256), "48k");
+    ASSERT_EQ(dr.fft_size, 256, "245.8 rounds to 256");
+    ASSERT_TRUE(detector_rate_init(&dr, 12000, 50000, 256), "12k");
+    ASSERT_EQ(dr.fft_size, 64, "61.4 rounds to 64");
+    ASSERT_TRUE(detector_rate_init(&dr, 2400000, 50000, 256), "2.4M");
+    ASSERT_EQ(dr.fft_size, 16384, "12288 ties go larger");
+    ASSERT_TRUE(detector_rate_init(&dr, 48000, 12000, 4096), "tone tracker at 48k");
+    ASSERT_EQ(dr.fft_size, 16384, "same Hz/bin");
+    ASSERT_FLOAT_EQ(dr.hz_per_bin, 12000.0f / 4096.0f, 1e-5f, "2.93 Hz/bin");
+
+    ASSERT_EQ(detector_rate_samples(&dr, 5.0f), 240, "5 ms at 48k");
+
+    ASSERT_TRUE(detector_rate_init(&dr, 50000, 50000, 2048), "BCD freq profile");
+    ASSERT_TRUE(detector_rate_decimate(&dr, 32), "subband");
+    ASSERT_EQ(dr.fft_size, 64, "2048 / 32");
+    ASSERT_FLOAT_EQ(dr.frame_ms, 40.96f, 1e-3f, "frame kept");
+    ASSERT_FLOAT_EQ(dr.hz_per_bin, 50000.0f / 2048.0f, 1e-5f, "bins kept");
+    ASSERT_FALSE(detector_rate_decimate(&dr, 32), "2 points is too short");
+    ASSERT_FALSE(detector_rate_decimate(&dr, 3), "must divide the FFT");
+    ASSERT_EQ(dr.fft_size, 64, "unchanged on refusal");
+    ASSERT_FALSE(detector_rate_init(&dr, 4000, 50000, 256), "below minimum");
+    ASSERT_FALSE(detector_rate_init(&dr, 20000000, 50000, 256), "above maximum");
+    ASSERT_NULL(tick_detector_create_rate(NULL, 1000), "detector refuses bad rate");
+    PASS();
+}
+
+/*============================================================================
+ * Tick Detector
+ *============================================================================*/
+
+TEST(tick_same_at_all_rates) {
+    static const int rates[] = { 50000, 48000, 12000, 96000 };   /* 96k: generic kernel */
+    tick_log_t logs[4];
+
+    for (int r = 0; r < 4; r++) {
+        memset(&logs[r], 0, sizeof(logs[r]));
+        run_ticks(rates[r], &logs[r]);
+        ASSERT_EQ(logs[r].count, 3, "one event per tick");
+    }
+    for (int r = 1; r < 4; r++) {
+        for (int k = 0; k < 3; k++) {
+            ASSERT_FLOAT_EQ(logs[r].timestamp_ms[k], logs[0].timestamp_ms[k], 12.0f,
+                            "same tick time within ~2 frames");
+        }
+    }
+    for (int k = 0; k < 3; k++) {
+        ASSERT_FLOAT_EQ(logs[0].timestamp_ms[k], 1000.0f * (k + 1), 20.0f, "ticks on the second");
+    }
+
+    tick_detector_t *td = tick_detector_create_rate(NULL, 12000);
+    ASSERT_EQ(tick_detector_get_sample_rate(td), 12000, "rate kept");
+    ASSERT_FLOAT_EQ(tick_detector_get_frame_ms(td), 64000.0f / 12000.0f, 1e-4f, "64-pt frames");
+    tick_detector_destroy(td);
+    PASS();
+}
+
+/*============================================================================
+ * Other Detectors
+ *============================================================================*/
+
+TEST(bcd_time_pulse_at_48k) {
+    const int rate = 48000;
+    bcd_time_detector_t *td = bcd_time_detector_create_rate(NULL, rate);
+    ASSERT_NOT_NULL(td, "created");
+    g_bcd_pulses = 0;
+    bcd_time_detector_set_callback(td, log_bcd, NULL);
+
+    uint32_t lcg = 5;
+    for (int n = 0; n < rate * 4; n++) {
+        double t = (double)n / rate;
+        double in_second = t - floor(t);
+        float amp = (t >= 2.0 && in_second >= 0.03 && in_second < 0.53) ? 0.5f : 0.0f;
+        double ph = 2.0 * M_PI * 100.0 * t;
+        bcd_time_detector_process_sample(td, amp * (float)cos(ph) + noise(&lcg, 0.01f),
+                                             amp * (float)sin(ph) + noise(&lcg, 0.01f));
+    }
+    ASSERT_TRUE(g_bcd_pulses >= 1, "100 Hz pulse detected");
+    ASSERT_FLOAT_EQ(g_bcd_duration_ms, 500.0f, 30.0f, "pulse width in ms, not frames");
+    bcd_time_detector_destroy(td);
+    PASS();
+}
+
+/* Same 50 kHz input through full-rate and ÷32 data bands */
+TEST(bcd_subband_matches_full_rate) {
+    const int rate = 50000;
+    static const int widths_ms[] = { 200, 500, 800, 200, 500 };
+    fft_filter_bank_t *bank = fft_filter_bank_create((float)rate, FFT_BANK_DEFAULT_FFT_SIZE);
+    ASSERT_NOT_NULL(bank, "bank");
+    int full = fft_filter_bank_add_band(bank, 0.0f, 150.0f, 1);
+    int sub = fft_filter_bank_add_band(bank, 0.0f, 150.0f, 32);
+    ASSERT_TRUE(full >= 0 && sub >= 0, "bands");
+
+    bcd_time_detector_t *td_full = bcd_time_detector_create_rate(NULL, rate);
+    bcd_time_detector_t *td_sub = bcd_time_detector_create_subband(NULL, rate, 32);
+    ASSERT_NOT_NULL(td_sub, "subband detector");
+    ASSERT_NULL(bcd_time_detector_create_subband(NULL, rate, 128), "256 / 128 is too short");
+    ASSERT_FLOAT_EQ(bcd_time_detector_get_frame_ms(td_sub), 5.12f, 1e-4f, "same frames");
+
+    bcd_log_t log_full = {0}, log_sub = {0};
+    bcd_time_detector_set_callback(td_full, log_bcd_pulse, &log_full);
+    bcd_time_detector_set_callback(td_sub, log_bcd_pulse, &log_sub);
+
+    uint32_t lcg = 11;
+    for (int n = 0; n < rate * 7; n++) {
+        double t = (double)n / rate;
+        int sec = (int)t;
+        double in_second = t - sec;
+        bool on = sec >= 2 && in_second >= 0.03 && in_second < 0.03 + widths_ms[sec - 2] / 1000.0;
+        float amp = on ? 0.5f : 0.08f;
+        double ph = 2.0 * M_PI * 100.0 * t;
+        if (!fft_filter_bank_push(bank, amp * (float)cos(ph) + noise(&lcg, 0.05f),
+                                        amp * (float)sin(ph) + noise(&lcg, 0.05f))) {
+            continue;
+        }
+
+        int count;
+        const float *out = fft_filter_bank_output(bank, full, &count);
+        for (int k = 0; k < count; k++) bcd_time_detector_process_sample(td_full, out[2 * k], out[2 * k + 1]);
+        out = fft_filter_bank_output(bank, sub, &count);
+        for (int k = 0; k < count; k++) bcd_time_detector_process_sample(td_sub, out[2 * k], out[2 * k + 1]);
+    }
+
+    ASSERT_TRUE(log_full.count >= 4, "pulses at 50k");
+    ASSERT_EQ(log_sub.count, log_full.count, "same pulse count");
+    for (int k = 0; k < log_full.count && k < log_sub.count; k++) {
+        ASSERT_FLOAT_EQ(log_sub.start_ms[k], log_full.start_ms[k], 0.01f, "same start frame");
+        ASSERT_FLOAT_EQ(log_sub.duration_ms[k], log_full.duration_ms[k], 0.01f, "same width");
+    }
+
+    bcd_time_detector_destroy(td_full);
+    bcd_time_detector_destroy(td_sub);
+    fft_filter_bank_destroy(bank);
+    PASS();
+}
+
+TEST(tone_tracker_at_48k) {
+    const int rate = 48000;
+    tone_tracker_t *tt = tone_tracker_create_rate(500.0f, NULL, rate);
+    ASSERT_NOT_NULL(tt, "created");
+
+    /* 500 Hz AM tone, received 0.5 Hz high on both sidebands' center */
+    uint32_t lcg = 9;
+    for (int n = 0; n < rate * 2; n++) {
+        double t = (double)n / rate;
+        float tone = 0.3f * (float)cos(2.0 * M_PI * 500.5 * t);
+        tone_tracker_process_sample(tt, tone + noise(&lcg, 0.01f), noise(&lcg, 0.01f));
+    }
+    ASSERT_TRUE(tone_tracker_get_frame_count(tt) >= 5, "frames at 341 ms");
+    ASSERT_TRUE(tone_tracker_is_valid(tt), "tone found");
+    ASSERT_FLOAT_EQ(tone_tracker_get_offset_hz(tt), 0.5f, 0.1f, "offset resolved at 48k");
+    tone_tracker_destroy(tt);
+    PASS();
+}
+
+TEST(slow_marker_caller_fft) {
+    slow_marker_detector_t *smd = slow_marker_detector_create_rate(48000, 8192);
+    ASSERT_NOT_NULL(smd, "48k display FFT");
+    slow_marker_detector_destroy(smd);
+    ASSERT_NULL(slow_marker_detector_create_rate(12000, 1000), "not a power of two");
+    ASSERT_NULL(slow_marker_detector_create_rate(2000, 64), "1 kHz bucket at Nyquist");
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Detector Input Rate Tests");
+
+    TEST_SECTION("Rate Profile");
+    RUN_TEST(profile_fft_sizes);
+
+    TEST_SECTION("Tick Detector");
+    RUN_TEST(tick_same_at_all_rates);
+
+    TEST_SECTION("Other Detectors");
+    RUN_TEST(bcd_time_pulse_at_48k);
+    RUN_TEST(bcd_subband_matches_full_rate);
+    RUN_TEST(tone_tracker_at_48k);
+    RUN_TEST(slow_marker_caller_fft);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
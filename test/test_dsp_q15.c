@@ -0,0 +1,382 @@
+/**
+ * @file test_dsp_q15.c
+ * @brief Unit tests for the Q15 fixed-point front end
+ *
+ * - CIC decimator within 1 LSB of the same filter in double
+ * - Front end (CIC + Q15 FIR) against the float design: SNR, passband,
+ *   alias rejection at 50 kHz and 12 kHz
+ * - Vector vs. scalar bit-exactness, independent of block boundaries
+ * - Goertzel energy and error-feedback DC blocker against float
+ */
+
+#include "test_framework.h"
+#include "dsp_q15.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FS          2000000
+#define N_IN        400000      /* 0.2 s at 2 MHz */
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+static int16_t *make_input(float freq, float amp, float noise, uint32_t seed) {
+    int16_t *iq = (int16_t *)malloc(N_IN * 2 * sizeof(int16_t));
+    float *f = (float *)malloc(N_IN * 2 * sizeof(float));
+    uint32_t lcg = seed;
+    for (int n = 0; n < N_IN; n++) {
+        double ph = 2.0 * M_PI * freq * n / FS;
+        lcg = lcg * 1664525u + 1013904223u;
+        float ni = noise * ((float)(lcg >> 8) / 16777216.0f - 0.5f);
+        lcg = lcg * 1664525u + 1013904223u;
+        float nq = noise * ((float)(lcg >> 8) / 16777216.0f - 0.5f);
+        f[n * 2] = amp * (float)cos(ph) + ni;
+        f[n * 2 + 1] = amp * (float)sin(ph) + nq;
+    }
+    q15_from_float(f, iq, N_IN * 2);
+    free(f);
+    return iq;
+}
+
+/* The front end's structure in double with unquantized taps: the "float
+ * path" the Q15 output is measured against */
+static size_t reference_chain(const q15_frontend_config_t *cfg, const int16_t *iq, size_t count,
+                              double *out) {
+    const int R = cfg->cic_decimation, N = cfg->cic_order, M = cfg->fir_decimation;
+    const int T = cfg->fir_taps;
+    double gain = pow(R, N);
+    float *taps = (float *)malloc(T * sizeof(float));
+    double *hist = (double *)calloc((size_t)T * 2, sizeof(double));
+    q15_design_lowpass(taps, T, cfg->cutoff_hz, (float)cfg->input_rate / R);
+
+    double integ[4][2] = {{0}}, comb[4][2] = {{0}};
+    int phase = 0, fir_phase = 0;
+    size_t written = 0;
+    for (size_t n = 0; n < count; n++) {
+        for (int c = 0; c < 2; c++) {
+            double v = iq[n * 2 + c];
+            for (int k = 0; k < N; k++) { integ[k][c] += v; v = integ[k][c]; }
+        }
+        if (++phase < R) continue;
+        phase = 0;
+
+        memmove(hist + 2, hist, (size_t)(T - 1) * 2 * sizeof(double));
+        for (int c = 0; c < 2; c++) {
+            double v = integ[N - 1][c];
+            for (int k = 0; k < N; k++) { double prev = comb[k][c]; comb[k][c] = v; v -= prev; }
+            hist[c] = v / gain / 32768.0;
+        }
+        if (++fir_phase < M) continue;
+        fir_phase = 0;
+
+        double acc_i = 0.0, acc_q = 0.0;
+        for (int k = 0; k < T; k++) {
+            acc_i += taps[k] * hist[k * 2];
+            acc_q += taps[k] * hist[k * 2 + 1];
+        }
+        out[written * 2] = acc_i;
+        out[written * 2 + 1] = acc_q;
+        written++;
+    }
+    free(taps);
+    free(hist);
+    return written;
+}
+
+/* SNR of the Q15 front end against the reference, skipping the settle */
+static double frontend_snr(int output_rate, float freq, float amp) {
+    q15_frontend_config_t cfg;
+    q15_frontend_default_config(&cfg, FS, output_rate);
+    q15_frontend_t *fe = q15_frontend_create(&cfg);
+    int16_t *iq = make_input(freq, amp, 0.05f, 7);
+    size_t max_out = N_IN / (cfg.cic_decimation * cfg.fir_decimation) + 1;
+    int16_t *out = (int16_t *)malloc(max_out * 2 * sizeof(int16_t));
+    double *ref = (double *)malloc(max_out * 2 * sizeof(double));
+
+    size_t n = q15_frontend_process(fe, iq, N_IN, out, max_out);
+    size_t m = reference_chain(&cfg, iq, N_IN, ref);
+
+    double sig = 0.0, err = 0.0;
+    for (size_t k = 200; k < n && k < m; k++) {
+        for (int c = 0; c < 2; c++) {
+            double d = out[k * 2 + c] / 32768.0 - ref[k * 2 + c];
+            sig += ref[k * 2 + c] * ref[k * 2 + c];
+            err += d * d;
+        }
+    }
+    free(iq);
+    free(out);
+    free(ref);
+    q15_frontend_destroy(fe);
+    return (n == m) ? 10.0 * log10(sig / err) : -1.0;
+}
+
+/* Output RMS (full scale = 1) for a tone of amplitude amp */
+static double frontend_gain(int output_rate, float freq, float amp) {
+    q15_frontend_config_t cfg;
+    q15_frontend_default_config(&cfg, FS, output_rate);
+    q15_frontend_t *fe = q15_frontend_create(&cfg);
+    int16_t *iq = make_input(freq, amp, 0.0f, 1);
+    size_t max_out = N_IN / (cfg.cic_decimation * cfg.fir_decimation) + 1;
+    int16_t *out = (int16_t *)malloc(max_out * 2 * sizeof(int16_t));
+
+    size_t n = q15_frontend_process(fe, iq, N_IN, out, max_out);
+    double pow_sum = 0.0;
+    for (size_t k = 200; k < n; k++) {
+        double i = out[k * 2] / 32768.0, q = out[k * 2 + 1] / 32768.0;
+        pow_sum += i * i + q * q;
+    }
+    free(iq);
+    free(out);
+    q15_frontend_destroy(fe);
+    return sqrt(pow_sum / (double)(n - 200)) / amp;
+}
+
+/* The float path being replaced: 5 kHz biquad at 2 MHz, keep every Nth */
+static double float_path_gain(int decimation, float freq) {
+    const double w0 = 2.0 * M_PI * 5000.0 / FS, alpha = sin(w0) / (2.0 * 0.7071), a0 = 1.0 + alpha;
+    const double b0 = (1.0 - cos(w0)) / 2.0 / a0, b1 = (1.0 - cos(w0)) / a0, b2 = b0;
+    const double a1 = -2.0 * cos(w0) / a0, a2 = (1.0 - alpha) / a0;
+    double xi[2] = {0}, yi[2] = {0}, xq[2] = {0}, yq[2] = {0}, pow_sum = 0.0;
+    int kept = 0;
+
+    for (int n = 0; n < N_IN; n++) {
+        double ph = 2.0 * M_PI * freq * n / FS;
+        double i = b0 * cos(ph) + b1 * xi[0] + b2 * xi[1] - a1 * yi[0] - a2 * yi[1];
+        double q = b0 * sin(ph) + b1 * xq[0] + b2 * xq[1] - a1 * yq[0] - a2 * yq[1];
+        xi[1] = xi[0]; xi[0] = cos(ph); yi[1] = yi[0]; yi[0] = i;
+        xq[1] = xq[0]; xq[0] = sin(ph); yq[1] = yq[0]; yq[0] = q;
+        if (n % decimation == decimation - 1 && n > 20000) {
+            pow_sum += i * i + q * q;
+            kept++;
+        }
+    }
+    return sqrt(pow_sum / kept);
+}
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+TEST(default_config_splits) {
+    q15_frontend_config_t cfg;
+    q15_frontend_default_config(&cfg, FS, 50000);
+    ASSERT_EQ(cfg.cic_decimation, 20, "detector CIC ÷20");
+    ASSERT_EQ(cfg.cic_order, 3, "order 3 fits (8000)");
+    ASSERT_EQ(cfg.fir_decimation, 2, "FIR ÷2");
+
+    q15_frontend_default_config(&cfg, FS, 12000);
+    ASSERT_EQ(cfg.cic_decimation, 83, "display CIC ÷83");
+    ASSERT_EQ(cfg.cic_order, 2, "order 3 would overflow");
+    q15_frontend_t *fe = q15_frontend_create(&cfg);
+    ASSERT_NOT_NULL(fe, "display front end");
+    ASSERT_FLOAT_EQ(q15_frontend_output_rate(fe), 2000000.0f / 166, 0.01f, "same 166:1 as float path");
+    int taps;
+    q15_frontend_taps(fe, &taps);
+    ASSERT_EQ(taps % Q15_FIR_LANES, 0, "padded taps");
+    q15_frontend_destroy(fe);
+
+    q15_cic_t cic;
+    ASSERT_FALSE(q15_cic_init(&cic, 166, 3), "gain 4.6M refused");
+    ASSERT_TRUE(q15_cic_init(&cic, 40, 3), "gain 64000 fits");
+    cfg.cutoff_hz = 20000.0f;
+    ASSERT_NULL(q15_frontend_create(&cfg), "cutoff above FIR Nyquist");
+    PASS();
+}
+
+/*============================================================================
+ * CIC Decimator
+ *============================================================================*/
+
+TEST(cic_matches_double) {
+    int16_t *iq = make_input(3000.0f, 0.6f, 0.5f, 11);
+    int16_t *out = (int16_t *)malloc((N_IN / 20 + 1) * 2 * sizeof(int16_t));
+    q15_cic_t cic;
+    ASSERT_TRUE(q15_cic_init(&cic, 20, 3), "init");
+    size_t n = q15_cic_process(&cic, iq, N_IN, out);
+    ASSERT_EQ((int)n, N_IN / 20, "one output per R inputs");
+
+    double integ[3][2] = {{0}}, comb[3][2] = {{0}};
+    int phase = 0, worst = 0;
+    size_t k = 0;
+    for (int s = 0; s < N_IN; s++) {
+        for (int c = 0; c < 2; c++) {
+            double v = iq[s * 2 + c];
+            for (int j = 0; j < 3; j++) { integ[j][c] += v; v = integ[j][c]; }
+        }
+        if (++phase < 20) continue;
+        phase = 0;
+        for (int c = 0; c < 2; c++) {
+            double v = integ[2][c];
+            for (int j = 0; j < 3; j++) { double prev = comb[j][c]; comb[j][c] = v; v -= prev; }
+            int d = abs(out[k * 2 + c] - (int)lrint(v / 8000.0));
+            if (d > worst) worst = d;
+        }
+        k++;
+    }
+    ASSERT_TRUE(worst <= 1, "within 1 LSB despite wrapping integrators");
+    free(iq);
+    free(out);
+    PASS();
+}
+
+/*============================================================================
+ * Front End Accuracy
+ *============================================================================*/
+
+TEST(snr_against_float_path) {
+    double snr_det = frontend_snr(50000, 1000.0f, 0.5f);
+    double snr_disp = frontend_snr(12000, -1200.0f, 0.5f);
+    printf("    detector %.1f dB, display %.1f dB\n", snr_det, snr_disp);
+    ASSERT_TRUE(snr_det > 70.0, "50 kHz path within 70 dB of float");
+    ASSERT_TRUE(snr_disp > 70.0, "12 kHz path within 70 dB of float");
+    PASS();
+}
+
+TEST(passband_and_alias_rejection) {
+    ASSERT_FLOAT_EQ((float)frontend_gain(50000, 1000.0f, 0.5f), 1.0f, 0.012f, "1 kHz tick flat at 50k");
+    ASSERT_FLOAT_EQ((float)frontend_gain(12000, 100.0f, 0.5f), 1.0f, 0.012f, "100 Hz BCD flat at 12k");
+    ASSERT_TRUE(frontend_gain(50000, 45000.0f, 0.5f) < 1e-3, "45 kHz (aliases to -5 kHz) down 60 dB");
+
+    /* Out-of-band tones that fold into the output band: never worse than
+     * the float path's 5 kHz biquad + 40:1 / 166:1 sample picking */
+    static const float probes[] = { 20000.0f, 47000.0f, 98000.0f, 301000.0f };
+    for (int p = 0; p < 4; p++) {
+        ASSERT_TRUE(frontend_gain(50000, probes[p], 0.5f) <= float_path_gain(40, probes[p]),
+                    "detector alias rejection >= float path");
+        ASSERT_TRUE(frontend_gain(12000, probes[p], 0.5f) <= float_path_gain(166, probes[p]),
+                    "display alias rejection >= float path");
+    }
+    PASS();
+}
+
+TEST(vector_matches_scalar) {
+    q15_frontend_config_t cfg;
+    q15_frontend_default_config(&cfg, FS, 50000);
+    cfg.fir_taps = 61;                          /* Exercise the padding */
+    q15_frontend_t *a = q15_frontend_create(&cfg);
+    q15_frontend_t *b = q15_frontend_create(&cfg);
+    int16_t *iq = make_input(700.0f, 0.9f, 0.3f, 5);
+    size_t max_out = N_IN / 40 + 1;
+    int16_t *va = (int16_t *)malloc(max_out * 2 * sizeof(int16_t));
+    int16_t *vb = (int16_t *)malloc(max_out * 2 * sizeof(int16_t));
+
+    size_t na = q15_frontend_process(a, iq, N_IN, va, max_out);
+
+    /* Odd block sizes straddle CIC and FIR phases */
+    size_t nb = 0, pos = 0, step = 1;
+    while (pos < N_IN) {
+        size_t len = (N_IN - pos < step) ? N_IN - pos : step;
+        nb += q15_frontend_process_scalar(b, iq + pos * 2, len, vb + nb * 2, max_out - nb);
+        pos += len;
+        step = step * 3 + 7;
+        if (step > 50000) step = 13;
+    }
+    ASSERT_EQ((int)na, (int)nb, "same count");
+    ASSERT_TRUE(memcmp(va, vb, na * 2 * sizeof(int16_t)) == 0, "bit-identical");
+
+    q15_frontend_reset(a);
+    size_t nr = q15_frontend_process(a, iq, N_IN, vb, max_out);
+    ASSERT_EQ((int)nr, (int)na, "reset count");
+    ASSERT_TRUE(memcmp(va, vb, na * 2 * sizeof(int16_t)) == 0, "reset replays");
+
+    free(iq);
+    free(va);
+    free(vb);
+    q15_frontend_destroy(a);
+    q15_frontend_destroy(b);
+    PASS();
+}
+
+/*============================================================================
+ * Goertzel and DC Blocker
+ *============================================================================*/
+
+TEST(goertzel_against_float) {
+    /* The subcarrier front end's block: 24 samples of 100 Hz at 2400 Hz */
+    int16_t x[48];
+    float xf[48];
+    for (int n = 0; n < 24; n++) {
+        xf[n * 2] = 0.4f * (float)cos(2.0 * M_PI * 100.0 * n / 2400.0 + 0.3);
+        xf[n * 2 + 1] = 0.1f;
+    }
+    q15_from_float(xf, x, 48);
+
+    float coeff_f = 2.0f * (float)cos(2.0 * M_PI * 100.0 / 2400.0);
+    double s1 = 0.0, s2 = 0.0;
+    for (int n = 0; n < 24; n++) {
+        double s0 = x[n * 2] / 32768.0 + coeff_f * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+    double ref = s1 * s1 + s2 * s2 - coeff_f * s1 * s2;
+
+    int32_t coeff = q15_goertzel_coeff(100.0f, 2400.0f);
+    int64_t e = q15_goertzel_energy(x, 24, 2, coeff);
+    ASSERT_TRUE(e > 0, "energy");
+    ASSERT_FLOAT_EQ((float)(e / 1073741824.0 / ref), 1.0f, 1e-3f, "within 0.1% of float");
+    ASSERT_TRUE(q15_goertzel_energy(x + 1, 24, 2, coeff) < e / 100, "constant Q has no 100 Hz");
+
+    static int16_t big[9000];
+    ASSERT_TRUE(q15_goertzel_energy(big, 8482, 1, coeff) >= 0, "8482 samples allowed");
+    ASSERT_EQ((int)q15_goertzel_energy(big, 9000, 1, coeff), -1, "overflow guarded");
+    PASS();
+}
+
+TEST(dc_block_error_feedback) {
+    q15_dc_block_t dc;
+    q15_dc_block_init(&dc, 0.995f);
+    int16_t buf[2 * 4000];
+    for (int n = 0; n < 4000; n++) { buf[n * 2] = 3000; buf[n * 2 + 1] = -20000; }
+    q15_dc_block_process(&dc, buf, buf, 4000);
+    ASSERT_EQ(buf[0], 3000, "step passes");
+    ASSERT_EQ(buf[3999 * 2], 0, "I settles to exactly zero");
+    ASSERT_EQ(buf[3999 * 2 + 1], 0, "Q settles to exactly zero");
+
+    /* Float DC blocker on a 1 kHz tone at 50 kHz */
+    q15_dc_block_init(&dc, 0.995f);
+    double x1 = 0.0, y1 = 0.0;
+    int worst = 0;
+    for (int n = 0; n < 4000; n++) {
+        int16_t in[2] = { (int16_t)lrint(12000.0 * cos(2.0 * M_PI * 1000.0 * n / 50000.0) + 5000.0), 0 };
+        int16_t out[2];
+        q15_dc_block_process(&dc, in, out, 1);
+        double y = in[0] - x1 + (dc.alpha / 32768.0) * y1;
+        x1 = in[0];
+        y1 = y;
+        int d = abs(out[0] - (int)lrint(y));
+        if (d > worst) worst = d;
+    }
+    ASSERT_TRUE(worst <= 1, "within 1 LSB of float");
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Q15 Front End Tests");
+
+    TEST_SECTION("Configuration");
+    RUN_TEST(default_config_splits);
+
+    TEST_SECTION("CIC Decimator");
+    RUN_TEST(cic_matches_double);
+
+    TEST_SECTION("Front End Accuracy");
+    RUN_TEST(snr_against_float_path);
+    RUN_TEST(passband_and_alias_rejection);
+    RUN_TEST(vector_matches_scalar);
+
+    TEST_SECTION("Goertzel and DC Blocker");
+    RUN_TEST(goertzel_against_float);
+    RUN_TEST(dc_block_error_feedback);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,272 @@
+/**
+ * @file test_dual_station_detector.c
+ * @brief Unit tests for dual_station_detector module
+ *
+ * Synthesizes 50 kHz baseband with 5 ms tick bursts at 1000 Hz (WWV)
+ * and 1200 Hz (WWVH) at independent offsets within each second:
+ * - Create/destroy lifecycle
+ * - Each station alone (no bleed into the other)
+ * - Both stations together, separated and delay measured
+ * - Overlapping pulses
+ */
+
+#include "test_framework.h"
+#include "../tools/dual_station_detector.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+#define NO_STATION      -1.0f   /* Offset value meaning "station silent" */
+
+static int g_ticks[2];
+static station_tick_event_t g_last_tick[2];
+static int g_delay_count = 0;
+static station_delay_event_t g_last_delay;
+
+static void test_tick_callback(const station_tick_event_t *event, void *user_data) {
+    (void)user_data;
+    if (event && !event->is_marker) {
+        g_ticks[event->station]++;
+        g_last_tick[event->station] = *event;
+    }
+}
+
+static void test_delay_callback(const station_delay_event_t *event, void *user_data) {
+    (void)user_data;
+    g_delay_count++;
+    if (event) {
+        g_last_delay = *event;
+    }
+}
+
+static void reset_callback_state(void) {
+    memset(g_ticks, 0, sizeof(g_ticks));
+    memset(g_last_tick, 0, sizeof(g_last_tick));
+    g_delay_count = 0;
+    memset(&g_last_delay, 0, sizeof(g_last_delay));
+}
+
+/* Deterministic uniform noise in [-1, 1] */
+static unsigned int g_rng = 12345;
+static float noise(void) {
+    g_rng = g_rng * 1103515245u + 12345u;
+    return ((float)((g_rng >> 8) & 0xFFFF) / 32768.0f) - 1.0f;
+}
+
+/**
+ * Feed `seconds` of signal. Ticks start at wwv_ms / wwvh_ms into each
+ * second (NO_STATION to omit). Returns nothing - results arrive via callbacks.
+ */
+static void feed_seconds(dual_station_detector_t *det, int seconds,
+                         float wwv_ms, float wwvh_ms, float amplitude) {
+    const int pulse = DUAL_TEMPLATE_SAMPLES;
+    int wwv_start = (int)(wwv_ms * DUAL_SAMPLE_RATE / 1000.0f);
+    int wwvh_start = (int)(wwvh_ms * DUAL_SAMPLE_RATE / 1000.0f);
+
+    for (int s = 0; s < seconds; s++) {
+        for (int n = 0; n < DUAL_SAMPLE_RATE; n++) {
+            float i_sample = 0.01f * noise();
+            float q_sample = 0.01f * noise();
+
+            if (wwv_ms >= 0.0f && n >= wwv_start && n < wwv_start + pulse) {
+                float phase = 2.0f * (float)M_PI * DUAL_WWV_FREQ_HZ * (n - wwv_start) / DUAL_SAMPLE_RATE;
+                i_sample += amplitude * cosf(phase);
+                q_sample += amplitude * sinf(phase);
+            }
+            if (wwvh_ms >= 0.0f && n >= wwvh_start && n < wwvh_start + pulse) {
+                float phase = 2.0f * (float)M_PI * DUAL_WWVH_FREQ_HZ * (n - wwvh_start) / DUAL_SAMPLE_RATE;
+                i_sample += amplitude * cosf(phase);
+                q_sample += amplitude * sinf(phase);
+            }
+
+            dual_station_detector_process_sample(det, i_sample, q_sample);
+        }
+    }
+}
+
+static dual_station_detector_t *create_with_callbacks(void) {
+    dual_station_detector_t *det = dual_station_detector_create(NULL);
+    reset_callback_state();
+    if (det) {
+        dual_station_detector_set_tick_callback(det, test_tick_callback, NULL);
+        dual_station_detector_set_delay_callback(det, test_delay_callback, NULL);
+    }
+    return det;
+}
+
+/*============================================================================
+ * Lifecycle Tests
+ *============================================================================*/
+
+TEST(dual_create_destroy) {
+    dual_station_detector_t *det = dual_station_detector_create(NULL);
+    ASSERT_NOT_NULL(det, "create should return non-NULL");
+    ASSERT_TRUE(dual_station_detector_get_enabled(det), "should start enabled");
+    ASSERT_EQ(dual_station_detector_get_tick_count(det, WWV_STATION_WWV), 0, "no WWV ticks");
+    ASSERT_EQ(dual_station_detector_get_tick_count(det, WWV_STATION_WWVH), 0, "no WWVH ticks");
+    ASSERT_FALSE(dual_station_detector_get_relative_delay(det, NULL), "delay not locked");
+    dual_station_detector_destroy(det);
+    PASS();
+}
+
+TEST(dual_null_safety) {
+    dual_station_detector_destroy(NULL);
+    ASSERT_FALSE(dual_station_detector_process_sample(NULL, 0.0f, 0.0f), "NULL process");
+    ASSERT_EQ(dual_station_detector_get_tick_count(NULL, WWV_STATION_WWV), 0, "NULL count");
+    ASSERT_FALSE(dual_station_detector_get_epoch(NULL, WWV_STATION_WWV, NULL), "NULL epoch");
+    PASS();
+}
+
+TEST(dual_disabled_ignores_samples) {
+    dual_station_detector_t *det = create_with_callbacks();
+    ASSERT_NOT_NULL(det, "create should succeed");
+
+    dual_station_detector_set_enabled(det, false);
+    feed_seconds(det, 2, 100.0f, 150.0f, 0.5f);
+    ASSERT_EQ(dual_station_detector_get_sample_count(det), 0, "disabled detector should not consume samples");
+
+    dual_station_detector_destroy(det);
+    PASS();
+}
+
+/*============================================================================
+ * Separation Tests
+ *============================================================================*/
+
+TEST(dual_wwv_only) {
+    dual_station_detector_t *det = create_with_callbacks();
+    ASSERT_NOT_NULL(det, "create should succeed");
+
+    feed_seconds(det, 10, 100.0f, NO_STATION, 0.5f);
+
+    ASSERT_GT(g_ticks[WWV_STATION_WWV], 7, "WWV ticks should be detected");
+    ASSERT_EQ(g_ticks[WWV_STATION_WWVH], 0, "1000 Hz ticks must not be credited to WWVH");
+    ASSERT_TRUE(g_last_tick[WWV_STATION_WWV].dominance > 1.5f, "WWV should dominate");
+    ASSERT_GT(dual_station_detector_get_rejected_count(det, WWV_STATION_WWVH), 0,
+              "WWVH should see and reject bleed-through");
+
+    /* Fields waterfall --dual-station hands to tick_correlator */
+    const station_tick_event_t *ev = &g_last_tick[WWV_STATION_WWV];
+    ASSERT_FLOAT_EQ(fmod(ev->leading_edge_ms, 1000.0), 100.0, 1.0, "leading edge on the second");
+    ASSERT_FLOAT_EQ(ev->interval_ms, 1000.0f, 1.0f, "tick interval");
+    ASSERT_TRUE(ev->corr_peak > 0.0f && ev->noise_floor > 0.0f, "peak and noise floor reported");
+    ASSERT_TRUE(dual_station_detector_get_threshold(det, WWV_STATION_WWV) >
+                dual_station_detector_get_noise_floor(det, WWV_STATION_WWV), "threshold above floor");
+
+    /* Flash: set on a credited tick, only for that station */
+    ASSERT_EQ(dual_station_detector_get_flash_frames(det, WWV_STATION_WWVH), 0, "no WWVH flash");
+    feed_seconds(det, 1, 100.0f, NO_STATION, 0.5f);
+    int flash = dual_station_detector_get_flash_frames(det, WWV_STATION_WWV);
+    ASSERT_GT(flash, 0, "WWV flash after a tick");
+    dual_station_detector_decrement_flash(det, WWV_STATION_WWV);
+    ASSERT_EQ(dual_station_detector_get_flash_frames(det, WWV_STATION_WWV), flash - 1, "decrement");
+
+    dual_station_detector_destroy(det);
+    PASS();
+}
+
+TEST(dual_wwvh_only) {
+    dual_station_detector_t *det = create_with_callbacks();
+    ASSERT_NOT_NULL(det, "create should succeed");
+
+    feed_seconds(det, 10, NO_STATION, 250.0f, 0.5f);
+
+    ASSERT_GT(g_ticks[WWV_STATION_WWVH], 7, "WWVH ticks should be detected");
+    ASSERT_EQ(g_ticks[WWV_STATION_WWV], 0, "1200 Hz ticks must not be credited to WWV");
+
+    float epoch;
+    ASSERT_TRUE(dual_station_detector_get_epoch(det, WWV_STATION_WWVH, &epoch), "WWVH epoch locked");
+    ASSERT_FLOAT_EQ(epoch, 250.0f, 1.0f, "WWVH epoch at tick leading edge");
+    ASSERT_FALSE(dual_station_detector_get_relative_delay(det, NULL), "no delay without WWV");
+
+    dual_station_detector_destroy(det);
+    PASS();
+}
+
+TEST(dual_both_stations_delay) {
+    dual_station_detector_t *det = create_with_callbacks();
+    ASSERT_NOT_NULL(det, "create should succeed");
+
+    feed_seconds(det, 12, 100.0f, 112.5f, 0.5f);
+
+    ASSERT_GT(g_ticks[WWV_STATION_WWV], 9, "WWV ticks should be detected");
+    ASSERT_GT(g_ticks[WWV_STATION_WWVH], 9, "WWVH ticks should be detected");
+    ASSERT_GT(dual_station_detector_get_chain_length(det, WWV_STATION_WWV), DUAL_MIN_CHAIN - 1, "WWV chain");
+    ASSERT_GT(dual_station_detector_get_chain_length(det, WWV_STATION_WWVH), DUAL_MIN_CHAIN - 1, "WWVH chain");
+
+    float wwv_epoch, wwvh_epoch, delay;
+    ASSERT_TRUE(dual_station_detector_get_epoch(det, WWV_STATION_WWV, &wwv_epoch), "WWV epoch");
+    ASSERT_TRUE(dual_station_detector_get_epoch(det, WWV_STATION_WWVH, &wwvh_epoch), "WWVH epoch");
+    ASSERT_FLOAT_EQ(wwv_epoch, 100.0f, 1.0f, "WWV epoch");
+    ASSERT_FLOAT_EQ(wwvh_epoch, 112.5f, 1.0f, "WWVH epoch");
+
+    ASSERT_TRUE(dual_station_detector_get_relative_delay(det, &delay), "delay locked");
+    ASSERT_FLOAT_EQ(delay, 12.5f, 0.5f, "WWVH - WWV delay");
+    ASSERT_GT(g_delay_count, 0, "delay callback fired");
+    ASSERT_FLOAT_EQ(g_last_delay.delay_ms, delay, 0.001f, "callback matches getter");
+
+    dual_station_detector_destroy(det);
+    PASS();
+}
+
+TEST(dual_negative_delay_wraps) {
+    dual_station_detector_t *det = create_with_callbacks();
+    ASSERT_NOT_NULL(det, "create should succeed");
+
+    /* WWVH arrives 20 ms before WWV, across the second boundary */
+    feed_seconds(det, 12, 10.0f, 990.0f, 0.5f);
+
+    float delay;
+    ASSERT_TRUE(dual_station_detector_get_relative_delay(det, &delay), "delay locked");
+    ASSERT_FLOAT_EQ(delay, -20.0f, 0.5f, "delay wraps into (-500, 500]");
+
+    dual_station_detector_destroy(det);
+    PASS();
+}
+
+TEST(dual_overlapping_pulses) {
+    dual_station_detector_t *det = create_with_callbacks();
+    ASSERT_NOT_NULL(det, "create should succeed");
+
+    /* 2 ms apart - pulses overlap, so only coarse timing is expected */
+    feed_seconds(det, 12, 300.0f, 302.0f, 0.5f);
+
+    ASSERT_GT(g_ticks[WWV_STATION_WWV], 9, "WWV ticks under overlap");
+    ASSERT_GT(g_ticks[WWV_STATION_WWVH], 9, "WWVH ticks under overlap");
+
+    float delay;
+    ASSERT_TRUE(dual_station_detector_get_relative_delay(det, &delay), "delay locked");
+    ASSERT_FLOAT_EQ(delay, 2.0f, 2.0f, "overlapping delay");
+
+    dual_station_detector_destroy(det);
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Dual Station Detector Tests");
+
+    TEST_SECTION("Lifecycle");
+    RUN_TEST(dual_create_destroy);
+    RUN_TEST(dual_null_safety);
+    RUN_TEST(dual_disabled_ignores_samples);
+
+    TEST_SECTION("Station Separation");
+    RUN_TEST(dual_wwv_only);
+    RUN_TEST(dual_wwvh_only);
+    RUN_TEST(dual_both_stations_delay);
+    RUN_TEST(dual_negative_delay_wraps);
+    RUN_TEST(dual_overlapping_pulses);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,258 @@
+/**
+ * @file test_event_merge.c
+ * @brief Unit tests for event_merge module
+ *
+ * - Sample-time ordering and producer-rank tie-break
+ * - Watermark hold-back
+ * - Ordering contract and queue-full backpressure
+ * - Threaded producers deliver the same sequence as a serial run
+ */
+
+#include "test_framework.h"
+#include "../tools/event_merge.h"
+#include <pthread.h>
+#include <sched.h>
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+#define MAX_RECORDED    20000
+
+typedef struct {
+    uint64_t sample;
+    uint16_t producer;
+    uint32_t seq;
+    int value;
+} record_t;
+
+typedef struct {
+    record_t events[MAX_RECORDED];
+    int count;
+} recorder_t;
+
+static void record_event(const merge_event_t *event, void *user_data) {
+    recorder_t *rec = (recorder_t *)user_data;
+    if (rec->count >= MAX_RECORDED) return;
+    record_t *r = &rec->events[rec->count++];
+    r->sample = event->sample;
+    r->producer = event->producer;
+    r->seq = event->seq;
+    memcpy(&r->value, event->payload.bytes, sizeof(int));
+}
+
+static bool push_int(event_merge_t *m, int producer, uint64_t sample, int value) {
+    return event_merge_push(m, producer, sample, 0, &value, sizeof(value));
+}
+
+/* Deterministic event stream for one producer: strictly increasing-or-equal
+ * sample indices with bursts at the same index */
+static uint64_t next_sample(uint32_t *lcg, uint64_t sample) {
+    *lcg = *lcg * 1664525u + 1013904223u;
+    uint32_t r = *lcg >> 16;
+    return (r % 4 == 0) ? sample : sample + 1 + r % 50;
+}
+
+#define STREAM_EVENTS   5000
+
+/*============================================================================
+ * Ordering Tests
+ *============================================================================*/
+
+TEST(merge_orders_by_sample) {
+    event_merge_t *m = event_merge_create(2, 16);
+    ASSERT_NOT_NULL(m, "create");
+    static recorder_t rec;
+    rec.count = 0;
+
+    push_int(m, 0, 10, 1);
+    push_int(m, 0, 30, 3);
+    push_int(m, 1, 20, 2);
+    push_int(m, 1, 40, 4);
+    event_merge_close(m, 0);
+    event_merge_close(m, 1);
+
+    ASSERT_EQ(event_merge_drain(m, record_event, &rec), 4, "all delivered");
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(rec.events[i].value, i + 1, "sample order");
+    }
+    event_merge_destroy(m);
+    PASS();
+}
+
+TEST(merge_tie_break_by_rank) {
+    event_merge_t *m = event_merge_create(2, 16);
+    static recorder_t rec;
+    rec.count = 0;
+
+    /* Producer 1 pushes first, but rank 0 wins at the same sample */
+    push_int(m, 1, 100, 2);
+    push_int(m, 0, 100, 1);
+    push_int(m, 0, 100, 11);
+    event_merge_close(m, 0);
+    event_merge_close(m, 1);
+
+    ASSERT_EQ(event_merge_drain(m, record_event, &rec), 3, "all delivered");
+    ASSERT_EQ(rec.events[0].value, 1, "rank 0 first");
+    ASSERT_EQ(rec.events[1].value, 11, "rank 0 keeps FIFO order");
+    ASSERT_EQ(rec.events[2].value, 2, "rank 1 last");
+    ASSERT_EQ(rec.events[1].seq, 1, "per-producer sequence");
+    event_merge_destroy(m);
+    PASS();
+}
+
+TEST(merge_waits_for_watermark) {
+    event_merge_t *m = event_merge_create(2, 16);
+    static recorder_t rec;
+    rec.count = 0;
+
+    push_int(m, 0, 100, 1);
+    event_merge_advance(m, 0, 101);
+    event_merge_advance(m, 1, 50);
+    ASSERT_EQ(event_merge_drain(m, record_event, &rec), 0, "producer 1 may still emit before 100");
+
+    event_merge_advance(m, 1, 100);
+    ASSERT_EQ(event_merge_drain(m, record_event, &rec), 1, "rank 1 at 100 sorts after rank 0");
+
+    /* Rank 1 event at 200 must wait for rank 0 to pass 200, not just reach it */
+    push_int(m, 1, 200, 2);
+    event_merge_advance(m, 0, 200);
+    ASSERT_EQ(event_merge_drain(m, record_event, &rec), 0, "rank 0 may still emit at 200");
+    event_merge_advance(m, 0, 201);
+    ASSERT_EQ(event_merge_drain(m, record_event, &rec), 1, "released");
+    ASSERT_EQ(event_merge_watermark(m), 100, "lowest watermark");
+    event_merge_destroy(m);
+    PASS();
+}
+
+/*============================================================================
+ * Contract Tests
+ *============================================================================*/
+
+TEST(merge_rejects_out_of_order) {
+    event_merge_t *m = event_merge_create(1, 16);
+    ASSERT_TRUE(push_int(m, 0, 50, 1), "first push");
+    ASSERT_FALSE(push_int(m, 0, 49, 2), "sample went backwards");
+    event_merge_advance(m, 0, 60);
+    ASSERT_FALSE(push_int(m, 0, 55, 3), "below own watermark");
+    ASSERT_TRUE(push_int(m, 0, 60, 4), "at watermark");
+    ASSERT_FALSE(push_int(m, 1, 70, 5), "unknown producer");
+    ASSERT_FALSE(event_merge_push(m, 0, 70, 0, NULL, EVENT_MERGE_PAYLOAD_SIZE + 1), "payload too large");
+    ASSERT_NULL(event_merge_create(0, 16), "no producers");
+    ASSERT_NULL(event_merge_create(EVENT_MERGE_MAX_PRODUCERS + 1, 16), "too many producers");
+    event_merge_destroy(m);
+    PASS();
+}
+
+TEST(merge_queue_full) {
+    event_merge_t *m = event_merge_create(1, 4);
+    static recorder_t rec;
+    rec.count = 0;
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(push_int(m, 0, (uint64_t)i, i), "fill");
+    }
+    ASSERT_FALSE(push_int(m, 0, 4, 4), "full");
+    ASSERT_EQ(event_merge_pending(m), 4, "four pending");
+
+    event_merge_advance(m, 0, 4);
+    ASSERT_EQ(event_merge_drain(m, record_event, &rec), 4, "drained");
+    ASSERT_TRUE(push_int(m, 0, 4, 4), "space again");
+
+    uint64_t delivered = 0, full_waits = 0;
+    event_merge_get_stats(m, &delivered, &full_waits);
+    ASSERT_EQ(delivered, 4, "delivered count");
+    ASSERT_EQ(full_waits, 1, "one refused push");
+    event_merge_destroy(m);
+    PASS();
+}
+
+/*============================================================================
+ * Determinism Test
+ *============================================================================*/
+
+typedef struct {
+    event_merge_t *merge;
+    int producer;
+    uint32_t seed;
+} producer_arg_t;
+
+/* Emit a stream, advancing the watermark every few events like a block loop */
+static void run_producer(event_merge_t *m, int producer, uint32_t seed, bool spin) {
+    uint32_t lcg = seed;
+    uint64_t sample = 0;
+    for (int i = 0; i < STREAM_EVENTS; i++) {
+        sample = next_sample(&lcg, sample);
+        while (!push_int(m, producer, sample, producer * 100000 + i)) {
+            if (!spin) return;
+            sched_yield();
+        }
+        if (i % 7 == 6) event_merge_advance(m, producer, sample);
+    }
+    event_merge_close(m, producer);
+}
+
+static void *producer_thread(void *arg) {
+    producer_arg_t *a = (producer_arg_t *)arg;
+    run_producer(a->merge, a->producer, a->seed, true);
+    return NULL;
+}
+
+TEST(merge_threaded_matches_serial) {
+    static const uint32_t seeds[3] = { 1u, 77u, 12345u };
+    static recorder_t serial, threaded;
+    serial.count = 0;
+    threaded.count = 0;
+
+    /* Serial reference: large queues, producers run one after another */
+    event_merge_t *m = event_merge_create(3, STREAM_EVENTS);
+    for (int p = 0; p < 3; p++) run_producer(m, p, seeds[p], false);
+    event_merge_drain(m, record_event, &serial);
+    event_merge_destroy(m);
+    ASSERT_EQ(serial.count, 3 * STREAM_EVENTS, "serial delivered everything");
+
+    /* Threaded: small queues force interleaving and backpressure */
+    m = event_merge_create(3, 32);
+    pthread_t threads[3];
+    producer_arg_t args[3];
+    for (int p = 0; p < 3; p++) {
+        args[p] = (producer_arg_t){ m, p, seeds[p] };
+        pthread_create(&threads[p], NULL, producer_thread, &args[p]);
+    }
+    while (threaded.count < 3 * STREAM_EVENTS) {
+        if (event_merge_drain(m, record_event, &threaded) == 0) sched_yield();
+    }
+    for (int p = 0; p < 3; p++) pthread_join(threads[p], NULL);
+    event_merge_destroy(m);
+
+    int mismatch = 0;
+    for (int i = 0; i < serial.count; i++) {
+        if (serial.events[i].value != threaded.events[i].value) mismatch++;
+        if (i > 0 && serial.events[i].sample < serial.events[i - 1].sample) mismatch++;
+    }
+    ASSERT_EQ(mismatch, 0, "threaded order identical to serial, sorted by sample");
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Event Merge Tests");
+
+    TEST_SECTION("Ordering");
+    RUN_TEST(merge_orders_by_sample);
+    RUN_TEST(merge_tie_break_by_rank);
+    RUN_TEST(merge_waits_for_watermark);
+
+    TEST_SECTION("Contract");
+    RUN_TEST(merge_rejects_out_of_order);
+    RUN_TEST(merge_queue_full);
+
+    TEST_SECTION("Determinism");
+    RUN_TEST(merge_threaded_matches_serial);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,249 @@
+/**
+ * @file test_fft_filter_bank.c
+ * @brief Unit tests for the overlap-save FFT filter bank
+ *
+ * - Passband / stopband for the sync (800-1400 Hz) and data (0-150 Hz) bands
+ * - Zero-phase alignment: no group delay at any in-band frequency
+ * - Output positions name the input each output is aligned to
+ * - Decimated band equals the full-rate band subsampled
+ * - Block boundaries, reset, invalid bands
+ */
+
+#include "test_framework.h"
+#include "../tools/fft_filter_bank.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FS          50000.0f
+#define N_SAMPLES   50000
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+/* Run a unit complex tone through one band; return the steady-state output
+ * RMS and the RMS error against the unfiltered, undelayed tone */
+static void run_tone(float freq, float low, float high, int decimation,
+                     float *gain, float *phase_err) {
+    fft_filter_bank_t *bank = fft_filter_bank_create(FS, FFT_BANK_DEFAULT_FFT_SIZE);
+    int b = fft_filter_bank_add_band(bank, low, high, decimation);
+
+    double sig = 0.0, err = 0.0, out_pow = 0.0;
+    int out_index = 0, counted = 0;
+    for (int n = 0; n < N_SAMPLES; n++) {
+        double ph = 2.0 * M_PI * freq * n / FS;
+        if (!fft_filter_bank_push(bank, (float)cos(ph), (float)sin(ph))) continue;
+
+        int count;
+        const float *out = fft_filter_bank_output(bank, b, &count);
+        for (int k = 0; k < count; k++, out_index++) {
+            if (out_index * decimation < 5000) continue;        /* Settle */
+            double ref = 2.0 * M_PI * freq * (double)out_index * decimation / FS;
+            double di = out[2 * k] - cos(ref), dq = out[2 * k + 1] - sin(ref);
+            out_pow += out[2 * k] * out[2 * k] + out[2 * k + 1] * out[2 * k + 1];
+            sig += 1.0;
+            err += di * di + dq * dq;
+            counted++;
+        }
+    }
+    *gain = (float)sqrt(out_pow / counted);
+    *phase_err = (float)sqrt(err / sig);                /* Relative error incl. phase */
+    fft_filter_bank_destroy(bank);
+}
+
+/*============================================================================
+ * Frequency Response
+ *============================================================================*/
+
+TEST(sync_band_response) {
+    float gain, err;
+    run_tone(1000.0f, 800.0f, 1400.0f, 1, &gain, &err);
+    ASSERT_FLOAT_EQ(gain, 1.0f, 0.01f, "1000 Hz tick passes");
+    ASSERT_TRUE(err < 0.01f, "1000 Hz zero phase");
+    run_tone(-1200.0f, 800.0f, 1400.0f, 1, &gain, &err);
+    ASSERT_FLOAT_EQ(gain, 1.0f, 0.01f, "-1200 Hz (WWVH, lower sideband) passes");
+    ASSERT_TRUE(err < 0.01f, "1200 Hz zero phase");
+    run_tone(100.0f, 800.0f, 1400.0f, 1, &gain, &err);
+    ASSERT_TRUE(gain < 0.003f, "100 Hz BCD rejected > 50 dB");
+    run_tone(3000.0f, 800.0f, 1400.0f, 1, &gain, &err);
+    ASSERT_TRUE(gain < 0.003f, "3 kHz rejected");
+    PASS();
+}
+
+TEST(data_band_response) {
+    float gain, err;
+    run_tone(100.0f, 0.0f, 150.0f, 1, &gain, &err);
+    ASSERT_FLOAT_EQ(gain, 1.0f, 0.01f, "100 Hz BCD passes");
+    ASSERT_TRUE(err < 0.01f, "100 Hz zero phase");
+    run_tone(1000.0f, 0.0f, 150.0f, 1, &gain, &err);
+    ASSERT_TRUE(gain < 0.003f, "1000 Hz tick rejected");
+
+    fft_filter_bank_t *bank = fft_filter_bank_create(FS, FFT_BANK_DEFAULT_FFT_SIZE);
+    int b = fft_filter_bank_add_band(bank, 0.0f, 150.0f, 1);
+    ASSERT_FLOAT_EQ(fft_filter_bank_response(bank, b, 0.0f), 1.0f, 1e-3f, "unity DC gain");
+    ASSERT_TRUE(fft_filter_bank_response(bank, b, 150.0f) > 0.98f, "flat to band edge");
+    fft_filter_bank_destroy(bank);
+    PASS();
+}
+
+/*============================================================================
+ * Alignment
+ *============================================================================*/
+
+TEST(impulse_is_centered) {
+    /* Zero-phase: an impulse at input n comes out centered at output n */
+    fft_filter_bank_t *bank = fft_filter_bank_create(FS, 256);
+    int b = fft_filter_bank_add_band(bank, 0.0f, 5000.0f, 1);
+    const int at = 300;
+
+    int out_index = 0, peak_at = -1;
+    float peak = 0.0f;
+    for (int n = 0; n < 2000; n++) {
+        if (!fft_filter_bank_push(bank, n == at ? 1.0f : 0.0f, 0.0f)) continue;
+        int count;
+        const float *out = fft_filter_bank_output(bank, b, &count);
+        for (int k = 0; k < count; k++, out_index++) {
+            if (fabsf(out[2 * k]) > peak) { peak = fabsf(out[2 * k]); peak_at = out_index; }
+        }
+    }
+    ASSERT_EQ(peak_at, at, "impulse response centered on input sample");
+    ASSERT_EQ(out_index, (2000 / 128) * 128 - 64, "one output per input, minus look-ahead");
+    fft_filter_bank_destroy(bank);
+    PASS();
+}
+
+TEST(output_position_names_input) {
+    /* Each output's position is the input it is aligned to, decimated too */
+    fft_filter_bank_t *bank = fft_filter_bank_create(FS, 256);
+    int full = fft_filter_bank_add_band(bank, 0.0f, 5000.0f, 1);
+    int dec = fft_filter_bank_add_band(bank, 0.0f, 2000.0f, 4);
+    ASSERT_EQ(fft_filter_bank_decimation(bank, dec), 4, "decimation");
+    const int at = 700;
+
+    uint64_t next_full = 0, next_dec = 0, peak_full = 0, peak_dec = 0;
+    float max_full = 0.0f, max_dec = 0.0f;
+    for (int n = 0; n < 2000; n++) {
+        if (!fft_filter_bank_push(bank, n == at ? 1.0f : 0.0f, 0.0f)) continue;
+        int nf, nd;
+        const float *of = fft_filter_bank_output(bank, full, &nf);
+        const float *od = fft_filter_bank_output(bank, dec, &nd);
+        uint64_t pf = fft_filter_bank_output_position(bank, full);
+        uint64_t pd = fft_filter_bank_output_position(bank, dec);
+        ASSERT_EQ(pf, next_full, "contiguous");
+        ASSERT_EQ(pd, next_dec, "contiguous, decimated");
+        ASSERT(pf + (uint64_t)nf + 64 == (uint64_t)n + 1, "look-ahead behind the newest input");
+        for (int k = 0; k < nf; k++) {
+            if (fabsf(of[2 * k]) > max_full) { max_full = fabsf(of[2 * k]); peak_full = pf + (uint64_t)k; }
+        }
+        for (int k = 0; k < nd; k++) {
+            if (fabsf(od[2 * k]) > max_dec) { max_dec = fabsf(od[2 * k]); peak_dec = pd + (uint64_t)k * 4; }
+        }
+        next_full = pf + (uint64_t)nf;
+        next_dec = pd + (uint64_t)nd * 4;
+    }
+    ASSERT_EQ(peak_full, at, "full-rate peak at the impulse");
+    ASSERT_EQ(peak_dec, at, "decimated peak at the impulse");
+
+    fft_filter_bank_reset(bank);
+    for (int n = 0; n < 128; n++) fft_filter_bank_push(bank, 0.0f, 0.0f);
+    ASSERT_EQ(fft_filter_bank_output_position(bank, full), 0, "reset restarts positions");
+    fft_filter_bank_destroy(bank);
+    PASS();
+}
+
+/*============================================================================
+ * Decimation
+ *============================================================================*/
+
+TEST(decimated_matches_subsampled) {
+    fft_filter_bank_t *bank = fft_filter_bank_create(FS, FFT_BANK_DEFAULT_FFT_SIZE);
+    int full = fft_filter_bank_add_band(bank, 0.0f, 150.0f, 1);
+    int dec = fft_filter_bank_add_band(bank, 0.0f, 150.0f, 64);
+    ASSERT_TRUE(full >= 0 && dec >= 0, "bands added");
+    ASSERT_FLOAT_EQ(fft_filter_bank_output_rate(bank, dec), FS / 64.0f, 1e-3f, "output rate");
+
+    uint32_t lcg = 1;
+    int checked = 0;
+    for (int n = 0; n < 20000; n++) {
+        lcg = lcg * 1664525u + 1013904223u;
+        float noise = (float)(lcg >> 8) / 16777216.0f - 0.5f;
+        float x = 0.3f * cosf(2.0f * (float)M_PI * 90.0f * n / FS) + noise;
+        if (!fft_filter_bank_push(bank, x, -x)) continue;
+
+        int nf, nd;
+        const float *of = fft_filter_bank_output(bank, full, &nf);
+        const float *od = fft_filter_bank_output(bank, dec, &nd);
+        ASSERT_EQ(nd * 64, nf, "same span");
+        for (int k = 0; k < nd; k++) {
+            ASSERT_FLOAT_EQ(od[2 * k], of[2 * k * 64], 1e-4f, "I matches every 64th");
+            ASSERT_FLOAT_EQ(od[2 * k + 1], of[2 * k * 64 + 1], 1e-4f, "Q matches every 64th");
+            checked++;
+        }
+    }
+    ASSERT_TRUE(checked > 200, "compared outputs");
+
+    /* Too much decimation for the band is refused */
+    fft_filter_bank_t *other = fft_filter_bank_create(FS, FFT_BANK_DEFAULT_FFT_SIZE);
+    ASSERT_EQ(fft_filter_bank_add_band(other, 800.0f, 1400.0f, 32), -1, "1400 Hz at 1.5 kHz refused");
+    ASSERT_TRUE(fft_filter_bank_add_band(other, 800.0f, 1400.0f, 8) >= 0, "1400 Hz at 6.25 kHz ok");
+    ASSERT_EQ(fft_filter_bank_add_band(other, 0.0f, 150.0f, 3), -1, "not a power of two");
+    ASSERT_EQ(fft_filter_bank_add_band(other, 500.0f, 400.0f, 1), -1, "inverted band");
+    fft_filter_bank_destroy(other);
+
+    fft_filter_bank_destroy(bank);
+    PASS();
+}
+
+/*============================================================================
+ * Lifecycle
+ *============================================================================*/
+
+TEST(reset_realigns) {
+    fft_filter_bank_t *bank = fft_filter_bank_create(FS, 256);
+    int b = fft_filter_bank_add_band(bank, 0.0f, 5000.0f, 1);
+    int first = -1, after_reset = -1;
+
+    for (int n = 0; n < 128; n++) {
+        if (fft_filter_bank_push(bank, 1.0f, 0.0f)) fft_filter_bank_output(bank, b, &first);
+    }
+    for (int n = 0; n < 500; n++) fft_filter_bank_push(bank, 1.0f, 0.0f);
+    fft_filter_bank_reset(bank);
+    ASSERT_EQ(fft_filter_bank_add_band(bank, 0.0f, 100.0f, 1), -1, "bands fixed once started");
+    for (int n = 0; n < 128; n++) {
+        if (fft_filter_bank_push(bank, 1.0f, 0.0f)) fft_filter_bank_output(bank, b, &after_reset);
+    }
+    ASSERT_EQ(first, 64, "first block trimmed by half the filter");
+    ASSERT_EQ(after_reset, first, "reset trims again");
+    fft_filter_bank_destroy(bank);
+
+    ASSERT_NULL(fft_filter_bank_create(FS, 1000), "fft size must be a power of two");
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("FFT Filter Bank Tests");
+
+    TEST_SECTION("Frequency Response");
+    RUN_TEST(sync_band_response);
+    RUN_TEST(data_band_response);
+
+    TEST_SECTION("Alignment");
+    RUN_TEST(impulse_is_centered);
+    RUN_TEST(output_position_names_input);
+
+    TEST_SECTION("Decimation");
+    RUN_TEST(decimated_matches_subsampled);
+
+    TEST_SECTION("Lifecycle");
+    RUN_TEST(reset_realigns);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,476 @@
+/**
+ * @file test_iq_client.c
+ * @brief Unit tests for iq_client module
+ *
+ * A loopback server thread plays scripted byte streams to the client:
+ * - PHXI header, frames with event markers and META, split into odd chunks
+ * - Odd-length U8 frames: later events and samples still 4-byte aligned
+ * - Sequence gaps and sender restarts
+ * - FT32 stream joined mid-frame (byte-wise resync)
+ * - Encoding request and encoded FT32 frames decoded to F32
+ * - Reconnect after the server drops the connection
+ * - Many large frames through the receive buffer (compaction keeps data intact)
+ */
+
+#include "test_framework.h"
+#include "iq_client.h"
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET socket_t;
+#define socket_close closesocket
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int socket_t;
+#define socket_close close
+#endif
+
+/*============================================================================
+ * Loopback Server
+ *============================================================================*/
+
+#define MAX_SCRIPT      (8 * 1024 * 1024)
+#define MAX_SESSIONS    2
+
+typedef struct {
+    socket_t listener;
+    int port;
+    uint8_t *script[MAX_SESSIONS];      /* Bytes sent on each accepted connection */
+    size_t len[MAX_SESSIONS];
+    int sessions;
+    size_t chunk;                       /* send() size, to split frames */
+    bool read_request;                  /* Read an iq_enc_request_t before sending */
+    iq_enc_request_t request;
+    pthread_t thread;
+} server_t;
+
+static void put32(server_t *s, int session, uint32_t v) {
+    memcpy(s->script[session] + s->len[session], &v, 4);
+    s->len[session] += 4;
+}
+
+static void put_bytes(server_t *s, int session, const void *p, size_t n) {
+    memcpy(s->script[session] + s->len[session], p, n);
+    s->len[session] += n;
+}
+
+static void put_phxi_header(server_t *s, int session, uint32_t version, uint32_t rate) {
+    put32(s, session, 0x50485849);
+    put32(s, session, version);
+    put32(s, session, rate);
+    put32(s, session, IQ_CLIENT_FORMAT_S16);
+    put32(s, session, 10000000);
+    put32(s, session, 0);
+    put32(s, session, 40);
+    put32(s, session, 2);
+}
+
+/* IQDQ frame whose samples are seq * 1000 + index */
+static void put_iqdq(server_t *s, int session, uint32_t seq, uint32_t n,
+                     const iq_event_t *ev, uint32_t n_ev) {
+    put32(s, session, 0x49514451);
+    put32(s, session, seq);
+    put32(s, session, n);
+    put32(s, session, n_ev << IQ_EVENT_COUNT_SHIFT);
+    if (n_ev) put_bytes(s, session, ev, n_ev * sizeof(iq_event_t));
+    for (uint32_t i = 0; i < n * 2; i++) {
+        int16_t v = (int16_t)((seq * 1000 + i) & 0x7FFF);
+        put_bytes(s, session, &v, 2);
+    }
+}
+
+static void put_meta(server_t *s, int session, uint32_t rate, uint32_t format) {
+    put32(s, session, 0x4D455441);
+    put32(s, session, rate);
+    put32(s, session, format);
+    put32(s, session, 10000000);
+    put32(s, session, 0);
+    put32(s, session, 40);
+    put32(s, session, 2);
+    put32(s, session, 0);
+}
+
+/* U8 IQDQ frame whose bytes are seq * 16 + index */
+static void put_iqdq_u8(server_t *s, int session, uint32_t seq, uint32_t n,
+                        const iq_event_t *ev, uint32_t n_ev) {
+    put32(s, session, 0x49514451);
+    put32(s, session, seq);
+    put32(s, session, n);
+    put32(s, session, n_ev << IQ_EVENT_COUNT_SHIFT);
+    if (n_ev) put_bytes(s, session, ev, n_ev * sizeof(iq_event_t));
+    for (uint32_t i = 0; i < n * 2; i++) {
+        uint8_t v = (uint8_t)(seq * 16 + i);
+        put_bytes(s, session, &v, 1);
+    }
+}
+
+static void *server_thread(void *arg) {
+    server_t *s = (server_t *)arg;
+    for (int k = 0; k < s->sessions; k++) {
+        socket_t conn = accept(s->listener, NULL, NULL);
+        if (s->read_request) {
+            recv(conn, (char *)&s->request, sizeof(s->request), MSG_WAITALL);
+        }
+        for (size_t off = 0; off < s->len[k]; off += s->chunk) {
+            size_t n = s->len[k] - off < s->chunk ? s->len[k] - off : s->chunk;
+            if (send(conn, (const char *)s->script[k] + off, (int)n, 0) <= 0) break;
+        }
+        socket_close(conn);
+    }
+    return NULL;
+}
+
+static bool server_init(server_t *s, int sessions, size_t chunk) {
+    memset(s, 0, sizeof(*s));
+#ifdef _WIN32
+    WSADATA wsa;
+    WSAStartup(MAKEWORD(2, 2), &wsa);
+#endif
+    s->sessions = sessions;
+    s->chunk = chunk;
+    for (int k = 0; k < sessions; k++) {
+        s->script[k] = (uint8_t *)malloc(MAX_SCRIPT);
+        if (!s->script[k]) return false;
+    }
+
+    s->listener = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (bind(s->listener, (struct sockaddr *)&addr, sizeof(addr)) != 0) return false;
+    if (listen(s->listener, 1) != 0) return false;
+    socklen_t alen = sizeof(addr);
+    getsockname(s->listener, (struct sockaddr *)&addr, &alen);
+    s->port = ntohs(addr.sin_port);
+    return true;
+}
+
+static void server_start(server_t *s) {
+    pthread_create(&s->thread, NULL, server_thread, s);
+}
+
+static void server_finish(server_t *s) {
+    pthread_join(s->thread, NULL);
+    socket_close(s->listener);
+    for (int k = 0; k < s->sessions; k++) free(s->script[k]);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+/* Next result that is not a timeout */
+static iq_client_status_t next_event(iq_client_t *c, iq_client_frame_t *f) {
+    for (int i = 0; i < 100; i++) {
+        iq_client_status_t st = iq_client_next(c, f, 50);
+        if (st != IQ_CLIENT_TIMEOUT) return st;
+    }
+    return IQ_CLIENT_TIMEOUT;
+}
+
+/*============================================================================
+ * PHXI Tests
+ *============================================================================*/
+
+TEST(phxi_frames_events_meta) {
+    server_t s;
+    ASSERT_TRUE(server_init(&s, 1, 7), "server");
+
+    iq_event_t ev = { .offset = 5, .type = IQ_EVENT_GAIN, .aux = 3, .value = 4000, .delta = -600 };
+    put_phxi_header(&s, 0, IQ_STREAM_VERSION_EVENTS, 2000000);
+    put_iqdq(&s, 0, 0, 64, &ev, 1);
+    put_iqdq(&s, 0, 1, 64, NULL, 0);
+    put32(&s, 0, 0x4D455441);                   /* META: new rate and freq */
+    put32(&s, 0, 1000000);
+    put32(&s, 0, IQ_CLIENT_FORMAT_S16);
+    put32(&s, 0, 15000000);
+    put32(&s, 0, 0);
+    put32(&s, 0, 50);
+    put32(&s, 0, 4);
+    put32(&s, 0, 0);
+    put_iqdq(&s, 0, 4, 32, NULL, 0);            /* Frames 2 and 3 lost */
+    server_start(&s);
+
+    iq_client_t *c = iq_client_create("127.0.0.1", s.port, IQ_CLIENT_PROTO_PHXI);
+    ASSERT_NOT_NULL(c, "create");
+    iq_client_frame_t f;
+
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_CONNECTED, "connected");
+    const iq_client_stream_t *st = iq_client_stream(c);
+    ASSERT_EQ(st->proto, IQ_CLIENT_PROTO_PHXI, "proto");
+    ASSERT_EQ(st->sample_rate, 2000000, "rate");
+    ASSERT_EQ(st->center_freq, 10000000, "freq");
+    ASSERT_EQ(st->gain_reduction, 40, "GR");
+    ASSERT_TRUE(st->events, "version 2 carries events");
+
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_FRAME, "frame 0");
+    ASSERT_EQ(f.num_samples, 64, "samples");
+    ASSERT_EQ(f.n_events, 1, "one marker");
+    ASSERT_EQ(f.events[0].offset, 5, "marker offset");
+    ASSERT_EQ(f.events[0].delta, -600, "marker delta");
+    const int16_t *smp = (const int16_t *)f.samples;
+    ASSERT_EQ(smp[0], 0, "first sample");
+    ASSERT_EQ(smp[127], 127, "last sample");
+
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_FRAME, "frame 1");
+    ASSERT_NULL(f.events, "no markers");
+    ASSERT_EQ(((const int16_t *)f.samples)[0], 1000, "frame 1 data");
+
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_META, "meta");
+    ASSERT_EQ(st->sample_rate, 1000000, "new rate");
+    ASSERT_EQ(st->center_freq, 15000000, "new freq");
+    ASSERT_EQ(st->lna_state, 4, "new LNA");
+
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_FRAME, "frame 4");
+    ASSERT_EQ(f.sequence, 4, "sequence");
+    ASSERT_EQ(f.frames_lost, 2, "gap reported");
+
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_DISCONNECTED, "server closed");
+    ASSERT_FALSE(iq_client_connected(c), "down");
+
+    iq_client_stats_t stats;
+    iq_client_get_stats(c, &stats);
+    ASSERT_EQ(stats.frames, 3, "frames");
+    ASSERT_EQ(stats.sequence_gaps, 1, "gaps");
+    ASSERT_EQ(stats.frames_lost, 2, "lost");
+    ASSERT_EQ(stats.resyncs, 0, "aligned stream");
+
+    iq_client_destroy(c);
+    server_finish(&s);
+    PASS();
+}
+
+TEST(odd_u8_frames_keep_alignment) {
+    server_t s;
+    ASSERT_TRUE(server_init(&s, 1, 4096), "server");
+
+    iq_event_t ev = { .offset = 1, .type = IQ_EVENT_OVERLOAD, .value = 1 };
+    put_phxi_header(&s, 0, IQ_STREAM_VERSION_EVENTS, 2000000);
+    put_meta(&s, 0, 2000000, IQ_CLIENT_FORMAT_U8);
+    put_iqdq_u8(&s, 0, 0, 3, NULL, 0);          /* 6-byte payload: next frame at 4n+2 */
+    put_iqdq_u8(&s, 0, 1, 4, &ev, 1);           /* Keeps the offset: META and S16 frame off too */
+    put_meta(&s, 0, 2000000, IQ_CLIENT_FORMAT_S16);
+    put_iqdq(&s, 0, 2, 16, &ev, 1);
+    server_start(&s);
+
+    iq_client_t *c = iq_client_create("127.0.0.1", s.port, IQ_CLIENT_PROTO_PHXI);
+    ASSERT_NOT_NULL(c, "create");
+    iq_client_frame_t f;
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_CONNECTED, "connected");
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_META, "to U8");
+
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_FRAME, "U8 frame 0");
+    ASSERT_EQ(f.num_samples, 3, "odd count");
+    ASSERT_EQ(((const uint8_t *)f.samples)[5], 5, "U8 data");
+
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_FRAME, "U8 frame 1");
+    ASSERT_EQ(((uintptr_t)f.events & 3), 0, "events aligned");
+    ASSERT_EQ(f.events[0].type, IQ_EVENT_OVERLOAD, "marker");
+    ASSERT_EQ(((const uint8_t *)f.samples)[0], 16, "U8 data");
+    ASSERT_EQ(((const uint8_t *)f.samples)[7], 23, "U8 data");
+
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_META, "back to S16");
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_FRAME, "S16 frame");
+    ASSERT_EQ(f.sequence, 2, "sequence");
+    ASSERT_EQ(((uintptr_t)f.samples & 3), 0, "samples aligned");
+    ASSERT_EQ(f.events[0].offset, 1, "marker");
+    const int16_t *smp = (const int16_t *)f.samples;
+    ASSERT_EQ(smp[0], 2000, "first sample");
+    ASSERT_EQ(smp[31], 2031, "last sample");
+
+    iq_client_stats_t stats;
+    iq_client_get_stats(c, &stats);
+    ASSERT_EQ(stats.frames, 3, "frames");
+    ASSERT_EQ(stats.resyncs, 0, "no resync");
+    ASSERT_EQ(stats.realigned, 2, "frames after the odd one copied");
+
+    iq_client_destroy(c);
+    server_finish(&s);
+    PASS();
+}
+
+TEST(reconnect_after_drop) {
+    server_t s;
+    ASSERT_TRUE(server_init(&s, 2, 4096), "server");
+    put_phxi_header(&s, 0, 1, 2000000);
+    put_iqdq(&s, 0, 100, 16, NULL, 0);
+    put_phxi_header(&s, 1, 1, 2000000);
+    put_iqdq(&s, 1, 0, 16, NULL, 0);            /* Restarted sender: not a gap */
+    server_start(&s);
+
+    iq_client_t *c = iq_client_create("127.0.0.1", s.port, 0);
+    iq_client_set_backoff(c, 10, 40);
+    iq_client_frame_t f;
+
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_CONNECTED, "first connect");
+    ASSERT_FALSE(iq_client_stream(c)->events, "version 1");
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_FRAME, "first frame");
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_DISCONNECTED, "dropped");
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_CONNECTED, "reconnected");
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_FRAME, "frame after reconnect");
+    ASSERT_EQ(f.frames_lost, 0, "sequence restarts with the connection");
+
+    iq_client_stats_t stats;
+    iq_client_get_stats(c, &stats);
+    ASSERT_EQ(stats.connects, 2, "two sessions");
+
+    iq_client_destroy(c);
+    server_finish(&s);
+    PASS();
+}
+
+TEST(large_frames_through_buffer) {
+    server_t s;
+    const uint32_t frames = 200, n = 8192;     /* 6.4 MB through a 1 MB buffer */
+    ASSERT_TRUE(server_init(&s, 1, 60000), "server");
+    put_phxi_header(&s, 0, 1, 2000000);
+    for (uint32_t k = 0; k < frames; k++) put_iqdq(&s, 0, k, n, NULL, 0);
+    server_start(&s);
+
+    iq_client_t *c = iq_client_create("127.0.0.1", s.port, IQ_CLIENT_PROTO_PHXI);
+    iq_client_frame_t f;
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_CONNECTED, "connected");
+
+    uint32_t got = 0, bad = 0;
+    while (next_event(c, &f) == IQ_CLIENT_FRAME) {
+        const int16_t *smp = (const int16_t *)f.samples;
+        if (f.sequence != got || f.num_samples != n) bad++;
+        if (smp[0] != (int16_t)((got * 1000) & 0x7FFF)) bad++;
+        if (smp[n * 2 - 1] != (int16_t)((got * 1000 + n * 2 - 1) & 0x7FFF)) bad++;
+        if (((uintptr_t)f.samples & 3) != 0) bad++;
+        got++;
+    }
+    ASSERT_EQ(got, frames, "all frames");
+    ASSERT_EQ(bad, 0, "contents, order and alignment intact");
+
+    iq_client_stats_t stats;
+    iq_client_get_stats(c, &stats);
+    ASSERT_LT(stats.recv_calls, (uint64_t)frames * 3, "fewer recv calls than header/payload reads");
+
+    iq_client_destroy(c);
+    server_finish(&s);
+    PASS();
+}
+
+/*============================================================================
+ * FT32 Tests
+ *============================================================================*/
+
+TEST(ft32_resync_mid_frame) {
+    server_t s;
+    ASSERT_TRUE(server_init(&s, 1, 1000), "server");
+
+    put32(&s, 0, 0x46543332);                   /* FT32 header */
+    put32(&s, 0, 50000);
+    put32(&s, 0, 0);
+    put32(&s, 0, 0);
+    float junk[7] = { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f };
+    put_bytes(&s, 0, junk, sizeof(junk));       /* Tail of a frame already in flight */
+    for (uint32_t k = 0; k < 3; k++) {
+        put32(&s, 0, 0x44415441);
+        put32(&s, 0, 10 + k);
+        put32(&s, 0, 4);
+        put32(&s, 0, 0);
+        for (int i = 0; i < 8; i++) {
+            float v = (float)(k * 10 + i);
+            put_bytes(&s, 0, &v, 4);
+        }
+    }
+    server_start(&s);
+
+    iq_client_t *c = iq_client_create("127.0.0.1", s.port, IQ_CLIENT_PROTO_FT32);
+    iq_client_frame_t f;
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_CONNECTED, "connected");
+    ASSERT_EQ(iq_client_stream(c)->proto, IQ_CLIENT_PROTO_FT32, "proto");
+    ASSERT_EQ(iq_client_stream(c)->sample_format, IQ_CLIENT_FORMAT_F32, "float samples");
+
+    for (uint32_t k = 0; k < 3; k++) {
+        ASSERT_EQ(next_event(c, &f), IQ_CLIENT_FRAME, "frame");
+        ASSERT_EQ(f.sequence, 10 + k, "sequence");
+        ASSERT_FLOAT_EQ(((const float *)f.samples)[7], (float)(k * 10 + 7), 1e-6, "data");
+    }
+
+    iq_client_stats_t stats;
+    iq_client_get_stats(c, &stats);
+    ASSERT_EQ(stats.resyncs, sizeof(junk), "junk skipped byte-wise");
+
+    iq_client_destroy(c);
+    server_finish(&s);
+    PASS();
+}
+
+TEST(ft32_encoded_frames_decoded) {
+    enum { N = 100 };
+    server_t s;
+    ASSERT_TRUE(server_init(&s, 1, 777), "server");
+    s.read_request = true;
+
+    put32(&s, 0, 0x46543332);
+    put32(&s, 0, 12000);
+    put32(&s, 0, IQ_ENC_S8);                    /* reserved1 = encoding */
+    put32(&s, 0, 0);
+
+    static float iq[2][N * 2];
+    static uint8_t payload[N * 8];
+    for (uint32_t k = 0; k < 2; k++) {
+        for (int i = 0; i < N * 2; i++) iq[k][i] = 0.01f * (float)((i * 7 + (int)k) % 41 - 20);
+        float scale;
+        size_t bytes = iq_enc_encode(IQ_ENC_S8, iq[k], N, payload, &scale);
+        put32(&s, 0, 0x44415441);
+        put32(&s, 0, k);
+        put32(&s, 0, N);
+        put_bytes(&s, 0, &scale, 4);
+        put_bytes(&s, 0, payload, bytes);
+    }
+    server_start(&s);
+
+    iq_client_t *c = iq_client_create("127.0.0.1", s.port, IQ_CLIENT_PROTO_FT32);
+    iq_client_set_encoding(c, IQ_ENC_S8);
+    iq_client_frame_t f;
+    ASSERT_EQ(next_event(c, &f), IQ_CLIENT_CONNECTED, "connected");
+    ASSERT_EQ(iq_client_stream(c)->encoding, IQ_ENC_S8, "encoding from header");
+    ASSERT_EQ(iq_client_stream(c)->sample_format, IQ_CLIENT_FORMAT_F32, "caller sees F32");
+
+    for (uint32_t k = 0; k < 2; k++) {
+        ASSERT_EQ(next_event(c, &f), IQ_CLIENT_FRAME, "frame");
+        ASSERT_EQ(f.sequence, k, "sequence");
+        ASSERT_EQ(f.num_samples, N, "pairs");
+        const float *out = (const float *)f.samples;
+        for (int i = 0; i < N * 2; i++) {
+            ASSERT_FLOAT_EQ(out[i], iq[k][i], 0.002f, "decoded sample");
+        }
+    }
+    ASSERT_EQ(s.request.magic, IQ_ENC_REQUEST_MAGIC, "request sent");
+    ASSERT_EQ(s.request.encoding, IQ_ENC_S8, "requested encoding");
+
+    iq_client_destroy(c);
+    server_finish(&s);
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("I/Q Stream Client Tests");
+
+    TEST_SECTION("PHXI");
+    RUN_TEST(phxi_frames_events_meta);
+    RUN_TEST(odd_u8_frames_keep_alignment);
+    RUN_TEST(reconnect_after_drop);
+    RUN_TEST(large_frames_through_buffer);
+
+    TEST_SECTION("FT32");
+    RUN_TEST(ft32_resync_mid_frame);
+    RUN_TEST(ft32_encoded_frames_decoded);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
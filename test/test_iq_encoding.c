@@ -0,0 +1,202 @@
+/**
+ * @file test_iq_encoding.c
+ * @brief Unit tests for the relay sample encodings
+ *
+ * - Vector encode/decode match the scalar reference bit for bit
+ * - Payload sizes and padding
+ * - Round-trip SNR per encoding, S8 block dynamic range
+ * - Names, silence, full-scale edges
+ */
+
+#include "test_framework.h"
+#include "iq_encoding.h"
+#include <math.h>
+
+#define PI 3.14159265358979f
+
+static void make_tone(float *iq, uint32_t n, float amp, float cycles_per_sample, uint32_t seed) {
+    uint32_t lcg = seed;
+    for (uint32_t k = 0; k < n; k++) {
+        lcg = lcg * 1664525u + 1013904223u;
+        float noise = ((float)(lcg >> 8) / 16777216.0f - 0.5f) * amp * 0.01f;
+        iq[2 * k] = amp * cosf(2.0f * PI * cycles_per_sample * k) + noise;
+        iq[2 * k + 1] = amp * sinf(2.0f * PI * cycles_per_sample * k) - noise;
+    }
+}
+
+/*============================================================================
+ * Vector vs. Scalar
+ *============================================================================*/
+
+TEST(simd_matches_scalar) {
+    enum { N = 1037 };                  /* Partial S8 block and vector tail */
+    static float iq[N * 2], a[N * 2], b[N * 2];
+    static uint8_t pa[N * 8], pb[N * 8];
+    make_tone(iq, N, 0.7f, 0.013f, 3);
+    iq[5] = 1e-30f;                     /* Denormal-ish values quantize to 0 */
+
+    for (int e = 0; e < IQ_ENC_COUNT; e++) {
+        float sa, sb;
+        size_t na = iq_enc_encode((iq_encoding_t)e, iq, N, pa, &sa);
+        size_t nb = iq_enc_encode_scalar((iq_encoding_t)e, iq, N, pb, &sb);
+        ASSERT_EQ(na, nb, "same payload size");
+        ASSERT_EQ(memcmp(pa, pb, na), 0, "bit-identical payload");
+        ASSERT_TRUE(sa == sb, "same frame scale");
+
+        iq_enc_decode((iq_encoding_t)e, pa, N, sa, a);
+        iq_enc_decode_scalar((iq_encoding_t)e, pa, N, sa, b);
+        ASSERT_EQ(memcmp(a, b, sizeof(a)), 0, "bit-identical decode");
+    }
+    PASS();
+}
+
+/*============================================================================
+ * Sizes
+ *============================================================================*/
+
+TEST(payload_sizes) {
+    ASSERT_EQ(iq_enc_payload_bytes(IQ_ENC_F32, 2048), 16384u, "F32 8 B/pair");
+    ASSERT_EQ(iq_enc_payload_bytes(IQ_ENC_S16, 2048), 8192u, "S16 4 B/pair");
+    ASSERT_EQ(iq_enc_payload_bytes(IQ_ENC_S8, 2048), 4096u + 128u, "S8 2 B/pair + exponents");
+    ASSERT_EQ(iq_enc_payload_bytes(IQ_ENC_ULAW, 2048), 4096u, "ULAW 2 B/pair");
+    ASSERT_EQ(iq_enc_payload_bytes(IQ_ENC_ULAW, 3), 8u, "padded to 4");
+    ASSERT_EQ(iq_enc_payload_bytes(IQ_ENC_S8, 1), 4u, "1 exponent + 2 values, padded");
+    ASSERT_EQ(iq_enc_payload_bytes(IQ_ENC_COUNT, 16), 0u, "unknown encoding");
+
+    float iq[6] = { 0.1f, 0.2f, 0.3f, -0.1f, -0.2f, -0.3f };
+    uint8_t out[8];
+    memset(out, 0xAA, sizeof(out));
+    float scale;
+    ASSERT_EQ(iq_enc_encode(IQ_ENC_ULAW, iq, 3, out, &scale), 8u, "ULAW bytes");
+    ASSERT_EQ(out[6], 0, "padding zeroed");
+    ASSERT_EQ(out[7], 0, "padding zeroed");
+    PASS();
+}
+
+/*============================================================================
+ * Quality
+ *============================================================================*/
+
+TEST(round_trip_snr) {
+    enum { N = 4096 };
+    static float iq[N * 2];
+    make_tone(iq, N, 0.5f, 0.01f, 11);
+
+    iq_enc_quality_t q[IQ_ENC_COUNT];
+    for (int e = 0; e < IQ_ENC_COUNT; e++) {
+        ASSERT_TRUE(iq_enc_measure((iq_encoding_t)e, iq, N, &q[e]), "measure");
+    }
+    ASSERT_TRUE(isinf(q[IQ_ENC_F32].snr_db), "F32 lossless");
+    ASSERT_FLOAT_EQ(q[IQ_ENC_F32].ratio, 1.0, 1e-9, "F32 ratio");
+    ASSERT_TRUE(q[IQ_ENC_S16].snr_db > 85.0, "S16 > 85 dB");
+    ASSERT_FLOAT_EQ(q[IQ_ENC_S16].ratio, 0.5, 1e-9, "S16 half size");
+    ASSERT_TRUE(q[IQ_ENC_S8].snr_db > 38.0, "S8 > 38 dB");
+    ASSERT_TRUE(q[IQ_ENC_S8].ratio < 0.27, "S8 ~quarter size");
+    ASSERT_TRUE(q[IQ_ENC_ULAW].snr_db > 35.0, "ULAW > 35 dB");
+    ASSERT_FLOAT_EQ(q[IQ_ENC_ULAW].ratio, 0.25, 1e-9, "ULAW quarter size");
+    PASS();
+}
+
+TEST(s8_blocks_keep_quiet_passages) {
+    /* One loud block then quiet ones 60 dB down: each block scales on its own */
+    enum { N = 256 };
+    static float iq[N * 2], back[N * 2];
+    static uint8_t payload[N * 8];
+    make_tone(iq, N, 1e-3f, 0.02f, 5);
+    for (int k = 0; k < IQ_ENC_S8_BLOCK * 2; k++) iq[k] *= 1000.0f;
+
+    float scale;
+    iq_enc_encode(IQ_ENC_S8, iq, N, payload, &scale);
+    iq_enc_decode(IQ_ENC_S8, payload, N, scale, back);
+
+    double sig = 0.0, err = 0.0;
+    for (int k = IQ_ENC_S8_BLOCK * 2; k < N * 2; k++) {
+        sig += (double)iq[k] * iq[k];
+        err += ((double)iq[k] - back[k]) * ((double)iq[k] - back[k]);
+    }
+    ASSERT_TRUE(10.0 * log10(sig / err) > 38.0, "quiet blocks keep S8 resolution");
+    PASS();
+}
+
+TEST(ulaw_keeps_relative_error_across_levels) {
+    /* Companding: error tracks the sample, not the frame peak */
+    enum { N = 1024 };
+    static float iq[N * 2], back[N * 2];
+    static uint8_t payload[N * 2];
+    make_tone(iq, N, 1.0f, 0.03f, 9);
+    for (int k = N; k < N * 2; k++) iq[k] *= 0.003f;    /* Second half 50 dB down */
+
+    float scale;
+    iq_enc_encode(IQ_ENC_ULAW, iq, N, payload, &scale);
+    iq_enc_decode(IQ_ENC_ULAW, payload, N, scale, back);
+
+    double sig = 0.0, err = 0.0;
+    for (int k = N; k < N * 2; k++) {
+        sig += (double)iq[k] * iq[k];
+        err += ((double)iq[k] - back[k]) * ((double)iq[k] - back[k]);
+    }
+    ASSERT_TRUE(10.0 * log10(sig / err) > 25.0, "quiet half still > 25 dB");
+    PASS();
+}
+
+/*============================================================================
+ * Edges
+ *============================================================================*/
+
+TEST(silence_and_full_scale) {
+    float zero[64] = { 0 }, back[64];
+    uint8_t payload[256];
+    for (int e = 0; e < IQ_ENC_COUNT; e++) {
+        float scale;
+        iq_enc_encode((iq_encoding_t)e, zero, 32, payload, &scale);
+        iq_enc_decode((iq_encoding_t)e, payload, 32, scale, back);
+        for (int k = 0; k < 64; k++) ASSERT_TRUE(back[k] == 0.0f, "silence stays silent");
+    }
+
+    float edge[4] = { 1.0f, -1.0f, 0.25f, -0.5f };
+    float scale;
+    iq_enc_encode(IQ_ENC_S16, edge, 2, payload, &scale);
+    iq_enc_decode(IQ_ENC_S16, payload, 2, scale, back);
+    ASSERT_FLOAT_EQ(back[0], 1.0f, 1e-6f, "S16 peak exact");
+    ASSERT_FLOAT_EQ(back[1], -1.0f, 1e-6f, "S16 negative peak exact");
+    PASS();
+}
+
+TEST(names) {
+    iq_encoding_t e;
+    ASSERT_TRUE(iq_enc_parse("S16", &e) && e == IQ_ENC_S16, "case-insensitive");
+    ASSERT_TRUE(iq_enc_parse("ulaw", &e) && e == IQ_ENC_ULAW, "ulaw");
+    ASSERT_FALSE(iq_enc_parse("s1", &e), "prefix rejected");
+    ASSERT_FALSE(iq_enc_parse("s166", &e), "suffix rejected");
+    for (int k = 0; k < IQ_ENC_COUNT; k++) {
+        ASSERT_TRUE(iq_enc_parse(iq_enc_name((iq_encoding_t)k), &e) && e == (iq_encoding_t)k,
+                    "name round trip");
+    }
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("IQ Encoding Tests");
+
+    TEST_SECTION("Vector vs. Scalar");
+    RUN_TEST(simd_matches_scalar);
+
+    TEST_SECTION("Sizes");
+    RUN_TEST(payload_sizes);
+
+    TEST_SECTION("Quality");
+    RUN_TEST(round_trip_snr);
+    RUN_TEST(s8_blocks_keep_quiet_passages);
+    RUN_TEST(ulaw_keeps_relative_error_across_levels);
+
+    TEST_SECTION("Edges");
+    RUN_TEST(silence_and_full_scale);
+    RUN_TEST(names);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,320 @@
+/**
+ * @file test_iq_events.c
+ * @brief Unit tests for iq_events module
+ *
+ * - Marker queue: frame offsets, stale markers, ordering, overflow
+ * - Concurrent producers lose nothing that was accepted
+ * - Conditioner: gain rescale, settle blanking across frames,
+ *   overload blanking cap, hold-only markers
+ */
+
+#include "test_framework.h"
+#include "iq_events.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+#define FRAME   1000
+
+static float g_iq[FRAME * 2];
+static uint8_t g_hold[FRAME];
+
+static void fill(float level) {
+    for (int s = 0; s < FRAME; s++) {
+        g_iq[s * 2] = level;
+        g_iq[s * 2 + 1] = -level;
+    }
+}
+
+static int count_zero(int from, int to) {
+    int n = 0;
+    for (int s = from; s < to; s++) {
+        if (g_iq[s * 2] == 0.0f && g_iq[s * 2 + 1] == 0.0f) n++;
+    }
+    return n;
+}
+
+static int count_held(int from, int to) {
+    int n = 0;
+    for (int s = from; s < to; s++) n += g_hold[s];
+    return n;
+}
+
+static iq_event_t make_event(uint32_t offset, iq_event_type_t type, int32_t value, int32_t delta) {
+    iq_event_t ev = {0};
+    ev.offset = offset;
+    ev.type = (uint16_t)type;
+    ev.value = value;
+    ev.delta = delta;
+    return ev;
+}
+
+/*============================================================================
+ * Marker Queue Tests
+ *============================================================================*/
+
+TEST(queue_frame_offsets) {
+    iq_marker_queue_t *q = iq_marker_queue_create(16);
+    ASSERT_NOT_NULL(q, "create");
+    iq_event_t ev[IQ_MAX_FRAME_EVENTS];
+
+    iq_marker_queue_post(q, 100, IQ_EVENT_GAIN, 0, 0);
+    iq_marker_queue_post(q, 8191, IQ_EVENT_OVERLOAD, 0, 1);
+    iq_marker_queue_post(q, 8192, IQ_EVENT_OVERLOAD, 0, 0);
+
+    int n = iq_marker_queue_take(q, 0, 8192, ev, IQ_MAX_FRAME_EVENTS);
+    ASSERT_EQ(n, 2, "two markers in first frame");
+    ASSERT_EQ(ev[0].offset, 100, "first offset");
+    ASSERT_EQ(ev[0].type, IQ_EVENT_GAIN, "first type");
+    ASSERT_EQ(ev[1].offset, 8191, "last sample of frame");
+    ASSERT_EQ(ev[1].value, 1, "payload kept");
+
+    n = iq_marker_queue_take(q, 8192, 8192, ev, IQ_MAX_FRAME_EVENTS);
+    ASSERT_EQ(n, 1, "boundary marker in next frame");
+    ASSERT_EQ(ev[0].offset, 0, "first sample of next frame");
+    ASSERT_EQ(iq_marker_queue_take(q, 16384, 8192, ev, IQ_MAX_FRAME_EVENTS), 0, "empty");
+    iq_marker_queue_destroy(q);
+    PASS();
+}
+
+TEST(queue_stale_and_ordering) {
+    iq_marker_queue_t *q = iq_marker_queue_create(16);
+    iq_event_t ev[IQ_MAX_FRAME_EVENTS];
+
+    /* Samples before 1000 were dropped from the ring */
+    iq_marker_queue_post(q, 500, IQ_EVENT_GAIN, 0, 0);
+    /* Two threads interleaved: later position queued first */
+    iq_marker_queue_post(q, 1300, IQ_EVENT_FREQ, 0, 0);
+    iq_marker_queue_post(q, 1200, IQ_EVENT_OVERLOAD, 0, 1);
+
+    int n = iq_marker_queue_take(q, 1000, 1000, ev, IQ_MAX_FRAME_EVENTS);
+    ASSERT_EQ(n, 3, "all three");
+    ASSERT_EQ(ev[0].offset, 0, "stale marker at frame start");
+    ASSERT_EQ(ev[1].offset, 200, "sorted");
+    ASSERT_EQ(ev[1].type, IQ_EVENT_OVERLOAD, "sorted type");
+    ASSERT_EQ(ev[2].offset, 300, "sorted last");
+    iq_marker_queue_destroy(q);
+    PASS();
+}
+
+TEST(queue_overflow_and_clear) {
+    iq_marker_queue_t *q = iq_marker_queue_create(4);
+    iq_event_t ev[2];
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(iq_marker_queue_post(q, (uint64_t)i, IQ_EVENT_GAIN, 0, i), "fits");
+    }
+    ASSERT_FALSE(iq_marker_queue_post(q, 4, IQ_EVENT_GAIN, 0, 4), "full");
+    ASSERT_EQ(iq_marker_queue_dropped(q), 1, "post drop counted");
+
+    /* Frame with room for two: the rest of its markers are discarded */
+    ASSERT_EQ(iq_marker_queue_take(q, 0, 3, ev, 2), 2, "capped");
+    ASSERT_EQ(iq_marker_queue_dropped(q), 2, "frame drop counted");
+
+    iq_marker_queue_clear(q);
+    ASSERT_EQ(iq_marker_queue_take(q, 0, 100, ev, 2), 0, "cleared");
+    ASSERT_TRUE(iq_marker_queue_post(q, 10, IQ_EVENT_GAIN, 0, 0), "usable after clear");
+    iq_marker_queue_destroy(q);
+    PASS();
+}
+
+#define POSTS_PER_THREAD    20000
+
+typedef struct {
+    iq_marker_queue_t *q;
+    int thread;
+    int accepted;
+} poster_arg_t;
+
+static atomic_int g_posters_done;
+
+static void *poster_thread(void *arg) {
+    poster_arg_t *p = (poster_arg_t *)arg;
+    for (int i = 0; i < POSTS_PER_THREAD; i++) {
+        if (iq_marker_queue_post(p->q, (uint64_t)i, IQ_EVENT_OVERLOAD, (int16_t)p->thread, i)) {
+            p->accepted++;
+        }
+    }
+    atomic_fetch_add(&g_posters_done, 1);
+    return NULL;
+}
+
+TEST(queue_concurrent_posters) {
+    iq_marker_queue_t *q = iq_marker_queue_create(64);
+    iq_event_t ev[64];                  /* Whole queue, so take never discards */
+    poster_arg_t args[2] = {{q, 0, 0}, {q, 1, 0}};
+    pthread_t threads[2];
+    int received[2] = {0, 0};
+    int last[2] = {-1, -1};
+    int out_of_order = 0;
+
+    atomic_store(&g_posters_done, 0);
+    for (int t = 0; t < 2; t++) pthread_create(&threads[t], NULL, poster_thread, &args[t]);
+
+    bool done = false;
+    while (!done) {
+        done = atomic_load(&g_posters_done) == 2;
+        int n;
+        while ((n = iq_marker_queue_take(q, 0, POSTS_PER_THREAD, ev, 64)) > 0) {
+            for (int i = 0; i < n; i++) {
+                int t = ev[i].aux;
+                if (ev[i].value <= last[t]) out_of_order++;
+                last[t] = ev[i].value;
+                received[t]++;
+            }
+        }
+    }
+    for (int t = 0; t < 2; t++) pthread_join(threads[t], NULL);
+
+    ASSERT_EQ(received[0], args[0].accepted, "thread 0: every accepted marker taken");
+    ASSERT_EQ(received[1], args[1].accepted, "thread 1: every accepted marker taken");
+    ASSERT_EQ(out_of_order, 0, "per-producer order kept");
+    ASSERT_EQ(iq_marker_queue_dropped(q),
+              2 * POSTS_PER_THREAD - args[0].accepted - args[1].accepted, "rest counted");
+    iq_marker_queue_destroy(q);
+    PASS();
+}
+
+/*============================================================================
+ * Conditioner Tests
+ *============================================================================*/
+
+TEST(conditioner_defaults) {
+    iq_conditioner_t c;
+    iq_conditioner_init(&c, 2000000);
+    ASSERT_TRUE(c.rescale, "rescale on");
+    ASSERT_EQ(c.gain_settle, 2000, "1 ms at 2 MSPS");
+    ASSERT_EQ(c.retune_settle, 10000, "5 ms at 2 MSPS");
+    ASSERT_EQ(c.overload_max_blank, 100000, "50 ms at 2 MSPS");
+
+    /* No markers: samples untouched */
+    fill(0.25f);
+    ASSERT_EQ(iq_conditioner_apply(&c, g_iq, g_hold, FRAME, NULL, 0), 0, "nothing held");
+    ASSERT_FLOAT_EQ(g_iq[0], 0.25f, 1e-9, "unchanged");
+    PASS();
+}
+
+TEST(conditioner_gain_rescale) {
+    iq_conditioner_t c;
+    iq_conditioner_init(&c, 2000000);
+    c.gain_settle = 0;
+
+    /* Hardware gain up 6 dB at sample 400: input doubles from there */
+    fill(0.25f);
+    for (int s = 400; s < FRAME; s++) {
+        g_iq[s * 2] = 0.5f;
+        g_iq[s * 2 + 1] = -0.5f;
+    }
+    iq_event_t ev = make_event(400, IQ_EVENT_GAIN, 4000, 600);
+    iq_conditioner_apply(&c, g_iq, g_hold, FRAME, &ev, 1);
+
+    ASSERT_FLOAT_EQ(g_iq[399 * 2], 0.25f, 1e-9, "before step untouched");
+    ASSERT_FLOAT_EQ(g_iq[400 * 2], 0.5f * powf(10.0f, -0.3f), 1e-6, "step undone at the marker");
+    ASSERT_FLOAT_EQ(g_iq[999 * 2 + 1], -0.5f * powf(10.0f, -0.3f), 1e-6, "Q scaled too");
+    ASSERT_EQ(c.gain_offset_cdb, 600, "offset tracked");
+
+    /* Compensation persists into the next frame, then a step back cancels it */
+    fill(0.5f);
+    ev = make_event(500, IQ_EVENT_GAIN, 3400, -600);
+    iq_conditioner_apply(&c, g_iq, g_hold, FRAME, &ev, 1);
+    ASSERT_FLOAT_EQ(g_iq[0], 0.5f * powf(10.0f, -0.3f), 1e-6, "carried over");
+    ASSERT_FLOAT_EQ(g_iq[500 * 2], 0.5f, 1e-6, "back to unity");
+    ASSERT_EQ(count_held(0, FRAME), 0, "no settle window configured");
+    PASS();
+}
+
+TEST(conditioner_settle_spans_frames) {
+    iq_conditioner_t c;
+    iq_conditioner_init(&c, 2000000);
+    c.gain_settle = 100;
+
+    fill(0.1f);
+    iq_event_t ev = make_event(950, IQ_EVENT_GAIN, 0, 0);
+    uint32_t held = iq_conditioner_apply(&c, g_iq, g_hold, FRAME, &ev, 1);
+    ASSERT_EQ(held, 50, "tail of first frame held");
+    ASSERT_EQ(count_zero(0, 950), 0, "nothing blanked before the marker");
+    ASSERT_EQ(count_zero(950, FRAME), 50, "blanked from the marker");
+    ASSERT_EQ(g_hold[949], 0, "hold starts exactly at the marker");
+    ASSERT_EQ(g_hold[950], 1, "held at the marker");
+
+    fill(0.1f);
+    held = iq_conditioner_apply(&c, g_iq, g_hold, FRAME, NULL, 0);
+    ASSERT_EQ(held, 50, "rest of the window in the next frame");
+    ASSERT_EQ(count_zero(0, 50), 50, "blank continues");
+    ASSERT_EQ(g_hold[50], 0, "released after the window");
+    ASSERT_EQ(c.samples_blanked, 100, "stats");
+    PASS();
+}
+
+TEST(conditioner_overload) {
+    iq_conditioner_t c;
+    iq_conditioner_init(&c, 2000000);
+    c.gain_settle = 10;
+    c.overload_max_blank = 300;
+
+    /* Overload from 100 to 600: 300 blanked, all 500 held, then settle */
+    fill(0.9f);
+    iq_event_t ev[2] = {
+        make_event(100, IQ_EVENT_OVERLOAD, 1, 0),
+        make_event(600, IQ_EVENT_OVERLOAD, 0, 0)
+    };
+    uint32_t held = iq_conditioner_apply(&c, g_iq, g_hold, FRAME, ev, 2);
+    ASSERT_EQ(count_zero(100, 400), 300, "blanked up to the cap");
+    ASSERT_EQ(count_zero(400, FRAME), 0, "passes through after the cap");
+    ASSERT_EQ(count_held(100, 600), 500, "whole overload held");
+    ASSERT_EQ(count_held(600, 610), 10, "settle after clear");
+    ASSERT_EQ(held, 510, "held count");
+    ASSERT_FALSE(c.overloaded, "cleared");
+    PASS();
+}
+
+TEST(conditioner_hold_only_markers) {
+    iq_conditioner_t c;
+    iq_conditioner_init(&c, 2000000);
+    c.retune_settle = 200;
+
+    fill(0.3f);
+    iq_event_t ev[2] = {
+        make_event(0, IQ_EVENT_DISCONTINUITY, 4096, 0),
+        make_event(700, IQ_EVENT_FREQ, 10000000, 0)
+    };
+    uint32_t held = iq_conditioner_apply(&c, g_iq, g_hold, FRAME, ev, 2);
+    ASSERT_EQ(count_zero(0, FRAME), 0, "never blanked");
+    ASSERT_EQ(count_held(0, 200), 200, "held after gap");
+    ASSERT_EQ(count_held(200, 700), 0, "released");
+    ASSERT_EQ(count_held(700, 900), 200, "held after retune");
+    ASSERT_EQ(held, 400, "held count");
+    ASSERT_EQ(c.events, 2, "events counted");
+
+    iq_conditioner_reset(&c);
+    ASSERT_EQ(c.events, 0, "reset clears stats");
+    ASSERT_EQ(c.retune_settle, 200, "reset keeps config");
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("I/Q Event Marker Tests");
+
+    TEST_SECTION("Marker Queue");
+    RUN_TEST(queue_frame_offsets);
+    RUN_TEST(queue_stale_and_ordering);
+    RUN_TEST(queue_overflow_and_clear);
+    RUN_TEST(queue_concurrent_posters);
+
+    TEST_SECTION("Conditioner");
+    RUN_TEST(conditioner_defaults);
+    RUN_TEST(conditioner_gain_rescale);
+    RUN_TEST(conditioner_settle_spans_frames);
+    RUN_TEST(conditioner_overload);
+    RUN_TEST(conditioner_hold_only_markers);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
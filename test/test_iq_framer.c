@@ -0,0 +1,230 @@
+/**
+ * @file test_iq_framer.c
+ * @brief Unit tests for sdr_server's adaptive I/Q framing
+ *
+ * - Frame size limits from the latency budget and stream rate
+ * - Arrival lookup: the callback that delivered a sample, ring wrap
+ * - When a frame goes out: full, or short once half the budget has passed
+ * - Adaptation: grow when backed up or early, shrink when late
+ * - Coalescing decision, statistics window, socket buffer sizing
+ */
+
+#include "test_framework.h"
+#include "iq_framer.h"
+#include "iq_events.h"
+
+#define RATE        2000000
+#define PAIR_BYTES  4
+
+static iq_framer_t *make_framer(uint32_t latency_ms) {
+    iq_framer_t *f = iq_framer_create(latency_ms);
+    if (f) iq_framer_set_rate(f, RATE, PAIR_BYTES);
+    return f;
+}
+
+/*============================================================================
+ * Frame Size Limits
+ *============================================================================*/
+
+TEST(budget_cap) {
+    iq_framer_t *f = make_framer(20);
+    ASSERT_NOT_NULL(f, "create");
+    iq_framer_reset(f);
+    ASSERT_EQ(iq_framer_frame_samples(f), IQ_FRAMER_MAX_SAMPLES, "20 ms at 2 MSPS: receiver limit");
+    ASSERT_EQ(iq_framer_latency_ms(f), 20, "budget kept");
+    iq_framer_destroy(f);
+
+    f = make_framer(2);
+    iq_framer_reset(f);
+    ASSERT_EQ(iq_framer_frame_samples(f), 2000, "2 ms budget: 1 ms of samples");
+
+    iq_framer_set_rate(f, 48000, PAIR_BYTES);
+    ASSERT_EQ(iq_framer_frame_samples(f), IQ_FRAMER_MIN_SAMPLES, "slow stream: minimum frame");
+    iq_framer_destroy(f);
+
+    f = iq_framer_create(0);
+    ASSERT_EQ(iq_framer_latency_ms(f), IQ_FRAMER_DEFAULT_LATENCY_MS, "0 = default budget");
+    iq_framer_destroy(f);
+    PASS();
+}
+
+/*============================================================================
+ * Arrival Times
+ *============================================================================*/
+
+TEST(arrival_lookup) {
+    iq_framer_t *f = make_framer(20);
+
+    ASSERT_EQ(iq_framer_arrival_us(f, 0), 0, "nothing arrived");
+    iq_framer_arrived(f, 1000, 100);
+    iq_framer_arrived(f, 2000, 200);
+    iq_framer_arrived(f, 3000, 300);
+
+    ASSERT_EQ(iq_framer_arrival_us(f, 0), 100, "first callback");
+    ASSERT_EQ(iq_framer_arrival_us(f, 999), 100, "last sample of first callback");
+    ASSERT_EQ(iq_framer_arrival_us(f, 1000), 200, "first sample of second callback");
+    ASSERT_EQ(iq_framer_arrival_us(f, 2999), 300, "third callback");
+    ASSERT_EQ(iq_framer_arrival_us(f, 3000), 0, "not arrived yet");
+
+    /* Wrap the ring: older positions report the oldest time kept */
+    for (int k = 4; k <= IQ_FRAMER_ARRIVALS + 10; k++) {
+        iq_framer_arrived(f, (uint64_t)k * 1000, (uint64_t)k * 100);
+    }
+    ASSERT_EQ(iq_framer_arrival_us(f, 0), 1100, "oldest kept entry");
+    ASSERT_EQ(iq_framer_arrival_us(f, (IQ_FRAMER_ARRIVALS + 9) * 1000), (IQ_FRAMER_ARRIVALS + 10) * 100,
+              "newest entry");
+    iq_framer_destroy(f);
+    PASS();
+}
+
+/*============================================================================
+ * Framing
+ *============================================================================*/
+
+TEST(take) {
+    iq_framer_t *f = make_framer(20);       /* 8192-sample frames, short after 10 ms */
+
+    ASSERT_EQ(iq_framer_take(f, 0, 0, 0), 0, "nothing waiting");
+    ASSERT_EQ(iq_framer_take(f, 0, 3000, 0), 3000, "no arrival times: send what is there");
+
+    iq_framer_arrived(f, 3000, 1000000);
+    ASSERT_EQ(iq_framer_take(f, 0, 3000, 1000000), 0, "fresh samples wait for a full frame");
+    ASSERT_EQ(iq_framer_take(f, 0, 3000, 1009999), 0, "still inside half the budget");
+    ASSERT_EQ(iq_framer_take(f, 0, 3000, 1010000), 3000, "half the budget: short frame");
+    ASSERT_EQ(iq_framer_take(f, 0, 3000, 999000), 0, "clock read before the arrival");
+
+    iq_framer_arrived(f, 20000, 1001000);
+    ASSERT_EQ(iq_framer_take(f, 0, 20000, 1001000), IQ_FRAMER_MAX_SAMPLES, "full frame at once");
+    iq_framer_destroy(f);
+    PASS();
+}
+
+TEST(adaptation) {
+    iq_framer_t *f = make_framer(20);
+    uint64_t t = 1000000;
+    iq_framer_arrived(f, 1000000, t);
+
+    /* Late, socket keeping up: halve down to the minimum */
+    iq_framer_sent(f, 1, 32768, 2, false, 0, t + 25000);
+    ASSERT_EQ(iq_framer_frame_samples(f), 4096, "late halves");
+    for (int k = 0; k < 10; k++) iq_framer_sent(f, 1, 32768, 2, false, 0, t + 25000);
+    ASSERT_EQ(iq_framer_frame_samples(f), IQ_FRAMER_MIN_SAMPLES, "never below the minimum");
+
+    /* Between a quarter and all of the budget: hold */
+    iq_framer_sent(f, 1, 32768, 2, false, 0, t + 10000);
+    ASSERT_EQ(iq_framer_frame_samples(f), IQ_FRAMER_MIN_SAMPLES, "inside budget holds");
+
+    /* Backed up wins over late */
+    iq_framer_sent(f, 4, 131072, 6, true, 0, t + 25000);
+    ASSERT_EQ(iq_framer_frame_samples(f), 2 * IQ_FRAMER_MIN_SAMPLES, "backed up doubles");
+
+    /* Well inside the budget: grow back to the cap */
+    for (int k = 0; k < 10; k++) iq_framer_sent(f, 1, 32768, 2, false, 0, t + 1000);
+    ASSERT_EQ(iq_framer_frame_samples(f), IQ_FRAMER_MAX_SAMPLES, "grows back to the cap");
+
+    iq_framer_stats_t s;
+    iq_framer_get_stats(f, &s);
+    ASSERT_EQ(s.late_sends, 12, "late sends counted");
+    ASSERT_EQ(s.frames, 26, "frames counted");
+    ASSERT_EQ(s.frame_samples, IQ_FRAMER_MAX_SAMPLES, "current size in stats");
+
+    iq_framer_reset(f);
+    iq_framer_get_stats(f, &s);
+    ASSERT_EQ(s.frames, 0, "reset clears totals");
+    iq_framer_destroy(f);
+    PASS();
+}
+
+TEST(should_send) {
+    iq_framer_t *f = make_framer(20);
+    size_t frame = 16 + (size_t)IQ_FRAMER_MAX_SAMPLES * PAIR_BYTES;
+    size_t worst = frame + IQ_MAX_FRAME_EVENTS * sizeof(iq_event_t);
+
+    ASSERT_FALSE(iq_framer_should_send(f, 0, true), "empty batch");
+    ASSERT_TRUE(iq_framer_should_send(f, frame, true), "writable: send now");
+    ASSERT_FALSE(iq_framer_should_send(f, frame, false), "backed up: coalesce");
+    ASSERT_FALSE(iq_framer_should_send(f, IQ_FRAMER_BATCH_BYTES - worst, false), "one more fits");
+    ASSERT_TRUE(iq_framer_should_send(f, IQ_FRAMER_BATCH_BYTES - worst + 1, false), "batch full");
+    iq_framer_destroy(f);
+    PASS();
+}
+
+/*============================================================================
+ * Statistics / Socket Sizing
+ *============================================================================*/
+
+TEST(stats_window) {
+    iq_framer_t *f = make_framer(20);
+    uint64_t t = 5000000;
+    iq_framer_stats_t s;
+
+    /* A 4000-byte frame every 4 ms, 2 calls each, until the window closes
+     * (251 sends over exactly one second); each frame's first sample
+     * arrived 4 ms before its send returned */
+    bool closed = false;
+    for (int k = 0; k <= 250; k++) {
+        uint64_t now = t + (uint64_t)k * 4000;
+        iq_framer_arrived(f, (uint64_t)(k + 1) * 1000, now - 4000);
+        closed = iq_framer_sent(f, 1, 4000, 2, false, (uint64_t)k * 1000, now);
+        if (closed) break;
+    }
+    ASSERT_TRUE(closed, "window closes after a second");
+
+    iq_framer_get_stats(f, &s);
+    ASSERT_FLOAT_EQ(s.frames_per_sec, 251.0, 0.01, "frames per second");
+    ASSERT_FLOAT_EQ(s.frames_per_send, 1.0, 1e-9, "one frame per send");
+    ASSERT_FLOAT_EQ(s.mbytes_per_sec, 1.004, 1e-6, "MB/s");
+    ASSERT_FLOAT_EQ(s.syscalls_per_mb, 500.0, 1e-6, "syscalls per MB");
+    ASSERT_FLOAT_EQ(s.latency_avg_ms, 4.0, 0.01, "average latency");
+    ASSERT_FLOAT_EQ(s.latency_max_ms, 4.0, 0.01, "max latency");
+    ASSERT_FALSE(iq_framer_sent(f, 1, 4000, 2, false, 251000, t + 1004000), "new window open");
+    iq_framer_destroy(f);
+    PASS();
+}
+
+TEST(socket_sizing) {
+    iq_framer_t *f = make_framer(20);
+    double rate = (double)RATE * PAIR_BYTES;
+
+    ASSERT_EQ(iq_framer_sndbuf(f, 0),
+              (size_t)(2.0 * rate * IQ_FRAMER_DEFAULT_RTT_US / 1e6) + IQ_FRAMER_BATCH_BYTES,
+              "default RTT");
+    ASSERT_EQ(iq_framer_sndbuf(f, 100000), (size_t)(2.0 * rate * 0.1) + IQ_FRAMER_BATCH_BYTES,
+              "two BDPs plus a batch");
+    ASSERT_EQ(iq_framer_sndbuf(f, 10000000), IQ_FRAMER_SNDBUF_MAX, "clamped high");
+
+    ASSERT_EQ(iq_framer_notsent_lowat(f),
+              2 * (16 + IQ_MAX_FRAME_EVENTS * sizeof(iq_event_t) + IQ_FRAMER_MAX_SAMPLES * PAIR_BYTES),
+              "two largest frames");
+
+    iq_framer_set_rate(f, 8000, 1);
+    ASSERT_EQ(iq_framer_sndbuf(f, 1000), IQ_FRAMER_BATCH_BYTES + 16, "slow stream: about one batch");
+    iq_framer_destroy(f);
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("I/Q Framer Tests");
+
+    TEST_SECTION("Frame Size Limits");
+    RUN_TEST(budget_cap);
+
+    TEST_SECTION("Arrival Times");
+    RUN_TEST(arrival_lookup);
+
+    TEST_SECTION("Framing");
+    RUN_TEST(take);
+    RUN_TEST(adaptation);
+    RUN_TEST(should_send);
+
+    TEST_SECTION("Statistics / Socket Sizing");
+    RUN_TEST(stats_window);
+    RUN_TEST(socket_sizing);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
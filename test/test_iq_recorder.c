@@ -7,12 +7,22 @@
  * - Recording operations
  * - Playback/reader operations
  * - File format validation
+ * - Timing track: round trip, ordering, UTC seek in a multi-hour file
+ * - Block CRCs: clean files, damaged blocks, truncation, files without CRCs
+ * - Failed trailer write: samples and sample_count kept, trailer dropped
  * - Edge cases
  */
 
 #include "test_framework.h"
 #include "../include/iq_recorder.h"
 #include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/resource.h>
+#endif
 
 /*============================================================================
  * Test Helpers
@@ -366,6 +376,477 @@ TEST(iqr_header_size) {
     PASS();
 }
 
+/*============================================================================
+ * Timing Track Tests
+ *============================================================================*/
+
+#define START_US    1700000000000000LL  /* 2023-11-14T22:13:20Z */
+
+static iqr_timing_entry_t make_entry(uint64_t sample, int64_t utc_us, uint8_t flags) {
+    iqr_timing_entry_t e;
+    memset(&e, 0, sizeof(e));
+    e.sample_index = sample;
+    e.utc_us = utc_us;
+    e.gain_reduction = 40;
+    e.lna_state = 3;
+    e.flags = flags;
+    return e;
+}
+
+TEST(iqr_timing_roundtrip) {
+    cleanup_test_file();
+
+    iqr_recorder_t *rec = NULL;
+    iqr_create(&rec, 0);
+    iqr_start(rec, TEST_FILENAME, 1000.0, 5000000.0, 600, 40, 3);
+
+    int16_t xi[1000], xq[1000];
+    for (int i = 0; i < 1000; i++) {
+        xi[i] = (int16_t)i;
+        xq[i] = (int16_t)-i;
+    }
+    for (int s = 0; s < 5; s++) {
+        iqr_timing_entry_t e = make_entry(iqr_get_sample_count(rec), START_US + s * 1000000LL,
+                                          IQR_TIMING_GPS | (s == 2 ? IQR_TIMING_OVERLOAD : 0));
+        ASSERT_EQ(iqr_add_timing(rec, &e), IQR_OK, "add entry");
+        iqr_write(rec, xi, xq, 1000);
+    }
+    iqr_stop(rec);
+    iqr_destroy(rec);
+
+    iqr_reader_t *reader = NULL;
+    ASSERT_EQ(iqr_open(&reader, TEST_FILENAME), IQR_OK, "open");
+    const iqr_header_t *hdr = iqr_get_header(reader);
+    ASSERT_EQ(hdr->version, IQR_VERSION, "still a version 1 file");
+    ASSERT_TRUE(hdr->flags & IQR_FLAG_TIMING_TRACK, "track flag set");
+    ASSERT_EQ(hdr->sample_count, 5000, "sample count excludes the track");
+
+    size_t n = 0;
+    const iqr_timing_entry_t *t = iqr_get_timing(reader, &n);
+    ASSERT_EQ(n, 5, "five entries");
+    ASSERT_EQ(t[3].sample_index, 3000, "sample index");
+    ASSERT_TRUE(t[3].utc_us == START_US + 3000000LL, "utc");
+    ASSERT_EQ(t[3].gain_reduction, 40, "gain");
+    ASSERT_EQ(t[2].flags, IQR_TIMING_GPS | IQR_TIMING_OVERLOAD, "overload flag");
+
+    /* Reads stop at sample_count, the track never shows up as samples */
+    int16_t ri[1000], rq[1000];
+    uint32_t got, total = 0;
+    do {
+        iqr_read(reader, ri, rq, 1000, &got);
+        total += got;
+    } while (got > 0);
+    ASSERT_EQ(total, 5000, "all samples, nothing more");
+    ASSERT_EQ(ri[999], 999, "last sample intact");
+
+    iqr_close(reader);
+    cleanup_test_file();
+    PASS();
+}
+
+TEST(iqr_timing_order) {
+    cleanup_test_file();
+
+    iqr_recorder_t *rec = NULL;
+    iqr_create(&rec, 0);
+
+    iqr_timing_entry_t e = make_entry(0, START_US, 0);
+    ASSERT_EQ(iqr_add_timing(rec, &e), IQR_ERR_NOT_RECORDING, "not recording");
+
+    iqr_start(rec, TEST_FILENAME, 1000.0, 5000000.0, 600, 40, 3);
+    ASSERT_EQ(iqr_add_timing(rec, &e), IQR_OK, "first entry");
+    e = make_entry(1000, START_US, 0);
+    ASSERT_EQ(iqr_add_timing(rec, &e), IQR_ERR_INVALID_ARG, "same UTC refused");
+    e = make_entry(0, START_US + 1000000LL, 0);
+    ASSERT_EQ(iqr_add_timing(rec, &e), IQR_ERR_INVALID_ARG, "same sample refused");
+    e = make_entry(1000, START_US + 1000000LL, 0);
+    ASSERT_EQ(iqr_add_timing(rec, &e), IQR_OK, "later entry");
+    ASSERT_EQ(iqr_add_timing(rec, NULL), IQR_ERR_INVALID_ARG, "NULL entry");
+
+    iqr_stop(rec);
+    iqr_destroy(rec);
+    cleanup_test_file();
+    PASS();
+}
+
+/*
+ * Three hours at a nominal 100 Hz whose clock actually runs 20 ppm fast,
+ * one GPS entry per second. Each sample stores its own index (I = low 15
+ * bits, Q = the rest), so a seek can be checked against the data itself.
+ */
+TEST(iqr_timing_seek_multi_hour) {
+    cleanup_test_file();
+
+    const double nominal = 100.0;
+    const double actual = 100.002;
+    const int seconds = 3 * 3600;
+    const uint64_t total = (uint64_t)(seconds * actual);
+
+    iqr_recorder_t *rec = NULL;
+    iqr_create(&rec, 0);
+    iqr_start(rec, TEST_FILENAME, nominal, 10000000.0, 600, 40, 3);
+
+    int16_t xi[1024], xq[1024];
+    uint64_t written = 0;
+    int next_second = 0;
+    while (written < total) {
+        /* Entry for every second boundary before the next block */
+        while (next_second <= seconds && (uint64_t)ceil(next_second * actual) <= written) {
+            uint64_t idx = (uint64_t)ceil(next_second * actual);
+            int64_t utc = START_US + (int64_t)llround(idx / actual * 1e6);
+            iqr_timing_entry_t e = make_entry(idx, utc, IQR_TIMING_GPS);
+            iqr_add_timing(rec, &e);
+            next_second++;
+        }
+        uint32_t n = (total - written < 1024) ? (uint32_t)(total - written) : 1024;
+        for (uint32_t k = 0; k < n; k++) {
+            uint64_t idx = written + k;
+            xi[k] = (int16_t)(idx & 0x7FFF);
+            xq[k] = (int16_t)(idx >> 15);
+        }
+        iqr_write(rec, xi, xq, n);
+        written += n;
+    }
+    iqr_stop(rec);
+    iqr_destroy(rec);
+
+    iqr_reader_t *reader = NULL;
+    ASSERT_EQ(iqr_open(&reader, TEST_FILENAME), IQR_OK, "open");
+    size_t entries = 0;
+    iqr_get_timing(reader, &entries);
+    ASSERT_TRUE(entries > 10000, "one entry per second");
+
+    /* Random instants across the file land on the sample recorded then */
+    uint32_t lcg = 12345;
+    int worst = 0;
+    for (int k = 0; k < 500; k++) {
+        lcg = lcg * 1664525u + 1013904223u;
+        int64_t offset_us = (int64_t)((double)(lcg >> 8) / 16777216.0 * (seconds - 1) * 1e6);
+        uint64_t expect = (uint64_t)llround(offset_us * 1e-6 * actual);
+
+        ASSERT_EQ(iqr_seek_utc(reader, START_US + offset_us), IQR_OK, "seek");
+        int16_t ri[1], rq[1];
+        uint32_t got = 0;
+        iqr_read(reader, ri, rq, 1, &got);
+        ASSERT_EQ(got, 1, "sample read");
+        uint64_t at = (uint64_t)(uint16_t)ri[0] | ((uint64_t)(uint16_t)rq[0] << 15);
+        int err = (int)llabs((long long)at - (long long)expect);
+        if (err > worst) worst = err;
+    }
+    ASSERT_TRUE(worst <= 1, "within one sample of the true instant");
+
+    /* The nominal rate alone would be ~22 samples off by the end */
+    uint64_t s = 0;
+    iqr_sample_at_utc(reader, START_US + (int64_t)(seconds - 1) * 1000000LL, &s);
+    double nominal_guess = (seconds - 1) * nominal;
+    ASSERT_TRUE(fabs((double)s - nominal_guess) > 20.0, "track follows the real clock");
+
+    /* Outside the file: clipped */
+    iqr_sample_at_utc(reader, START_US - 3600000000LL, &s);
+    ASSERT_EQ(s, 0, "before start clips to 0");
+    iqr_sample_at_utc(reader, START_US + (int64_t)(seconds + 3600) * 1000000LL, &s);
+    ASSERT_EQ(s, total, "after end clips to sample_count");
+
+    iqr_close(reader);
+    cleanup_test_file();
+    PASS();
+}
+
+TEST(iqr_timing_without_track) {
+    cleanup_test_file();
+
+    /* Plain recording: no entries, no track */
+    iqr_recorder_t *rec = NULL;
+    iqr_create(&rec, 0);
+    iqr_start(rec, TEST_FILENAME, 1000.0, 5000000.0, 600, 40, 3);
+    int16_t xi[5000] = {0}, xq[5000] = {0};
+    iqr_write(rec, xi, xq, 5000);
+    iqr_stop(rec);
+    iqr_destroy(rec);
+
+    iqr_reader_t *reader = NULL;
+    ASSERT_EQ(iqr_open(&reader, TEST_FILENAME), IQR_OK, "open");
+    const iqr_header_t *hdr = iqr_get_header(reader);
+    ASSERT_EQ(hdr->flags, 0, "no flags");
+    size_t n = 99;
+    ASSERT_NULL(iqr_get_timing(reader, &n), "no track");
+    ASSERT_EQ(n, 0, "zero entries");
+
+    /* Falls back to header start time at the nominal rate */
+    uint64_t s = 0;
+    ASSERT_EQ(iqr_sample_at_utc(reader, hdr->start_time_us + 2500000LL, &s), IQR_OK, "map");
+    ASSERT_EQ(s, 2500, "2.5 s at 1 kHz");
+
+    iqr_close(reader);
+    cleanup_test_file();
+    PASS();
+}
+
+TEST(iqr_timing_damaged_track) {
+    cleanup_test_file();
+
+    iqr_recorder_t *rec = NULL;
+    iqr_create(&rec, 0);
+    iqr_start(rec, TEST_FILENAME, 1000.0, 5000000.0, 600, 40, 3);
+    int16_t xi[100] = {0}, xq[100] = {0};
+    iqr_timing_entry_t e = make_entry(0, START_US, IQR_TIMING_GPS);
+    iqr_add_timing(rec, &e);
+    iqr_write(rec, xi, xq, 100);
+    iqr_stop(rec);
+    iqr_destroy(rec);
+
+    /* Overwrite the chunk magic */
+    FILE *f = fopen(TEST_FILENAME, "r+b");
+    ASSERT_NOT_NULL(f, "reopen for patch");
+    fseek(f, IQR_HEADER_SIZE + 100 * 4, SEEK_SET);
+    fwrite("XXXX", 1, 4, f);
+    fclose(f);
+
+    /* Samples still readable, track ignored */
+    iqr_reader_t *reader = NULL;
+    ASSERT_EQ(iqr_open(&reader, TEST_FILENAME), IQR_OK, "open");
+    size_t n = 99;
+    iqr_get_timing(reader, &n);
+    ASSERT_EQ(n, 0, "damaged track dropped");
+    int16_t ri[100], rq[100];
+    uint32_t got = 0;
+    iqr_read(reader, ri, rq, 100, &got);
+    ASSERT_EQ(got, 100, "samples intact");
+
+    iqr_close(reader);
+    cleanup_test_file();
+    PASS();
+}
+
+/*============================================================================
+ * Integrity Tests
+ *============================================================================*/
+
+#define CRC_BLOCK   1000
+
+typedef struct {
+    uint64_t first[8], end[8];
+    int count;
+} damage_log_t;
+
+static void log_damage(uint64_t first, uint64_t end, void *user) {
+    damage_log_t *d = (damage_log_t *)user;
+    if (d->count < 8) {
+        d->first[d->count] = first;
+        d->end[d->count] = end;
+    }
+    d->count++;
+}
+
+/* 10.5 CRC blocks, written through a buffer that doesn't line up with them */
+static void record_crc_file(bool with_timing) {
+    iqr_recorder_t *rec = NULL;
+    iqr_create(&rec, 300);
+    iqr_set_crc_block(rec, CRC_BLOCK);
+    iqr_start(rec, TEST_FILENAME, 1000.0, 5000000.0, 600, 40, 3);
+
+    int16_t xi[700], xq[700];
+    for (int k = 0; k < 15; k++) {
+        for (int i = 0; i < 700; i++) {
+            xi[i] = (int16_t)(k * 700 + i);
+            xq[i] = (int16_t)-i;
+        }
+        if (with_timing) {
+            iqr_timing_entry_t e = make_entry(iqr_get_sample_count(rec),
+                                              START_US + k * 700000LL, IQR_TIMING_GPS);
+            iqr_add_timing(rec, &e);
+        }
+        iqr_write(rec, xi, xq, 700);
+    }
+    iqr_stop(rec);
+    iqr_destroy(rec);
+}
+
+static void corrupt_sample(uint64_t sample) {
+    FILE *f = fopen(TEST_FILENAME, "r+b");
+    if (!f) return;
+    fseek(f, (long)(IQR_HEADER_SIZE + sample * 4), SEEK_SET);
+    int c = fgetc(f);
+    fseek(f, (long)(IQR_HEADER_SIZE + sample * 4), SEEK_SET);
+    fputc(c ^ 0x01, f);
+    fclose(f);
+}
+
+TEST(iqr_crc_clean) {
+    cleanup_test_file();
+    record_crc_file(true);
+
+    damage_log_t log = { {0}, {0}, 0 };
+    iqr_verify_result_t res;
+    ASSERT_EQ(iqr_verify(TEST_FILENAME, NULL, 0, log_damage, &log, &res), IQR_OK, "verify");
+    ASSERT_EQ(res.sample_count, 10500, "declared samples");
+    ASSERT_EQ(res.samples_present, 10500, "all present");
+    ASSERT_EQ(res.block_samples, CRC_BLOCK, "block size");
+    ASSERT_EQ(res.blocks_checked, 11, "ten full blocks and a short one");
+    ASSERT_EQ(res.blocks_bad, 0, "no damage");
+    ASSERT_EQ(log.count, 0, "no ranges reported");
+
+    /* Both trailer chunks present and found */
+    iqr_reader_t *reader = NULL;
+    iqr_open(&reader, TEST_FILENAME);
+    const iqr_header_t *hdr = iqr_get_header(reader);
+    ASSERT_EQ(hdr->flags, IQR_FLAG_TIMING_TRACK | IQR_FLAG_CRC32C, "both flags");
+    ASSERT_EQ(hdr->crc_block_samples, CRC_BLOCK, "block size in header");
+    size_t n = 0;
+    iqr_get_timing(reader, &n);
+    ASSERT_EQ(n, 15, "timing track still loads");
+    iqr_close(reader);
+
+    cleanup_test_file();
+    PASS();
+}
+
+TEST(iqr_crc_damage) {
+    cleanup_test_file();
+    record_crc_file(false);
+
+    corrupt_sample(2500);       /* Block 2 */
+    corrupt_sample(3999);       /* Block 3: adjacent, merged */
+    corrupt_sample(10400);      /* Short last block */
+
+    /* A small buffer makes reads straddle block boundaries */
+    uint8_t buf[700];
+    damage_log_t log = { {0}, {0}, 0 };
+    iqr_verify_result_t res;
+    ASSERT_EQ(iqr_verify(TEST_FILENAME, buf, sizeof(buf), log_damage, &log, &res), IQR_OK, "verify");
+    ASSERT_EQ(res.blocks_checked, 11, "every block checked");
+    ASSERT_EQ(res.blocks_bad, 3, "three bad blocks");
+    ASSERT_EQ(log.count, 2, "two ranges");
+    ASSERT_EQ(log.first[0], 2000, "first range start");
+    ASSERT_EQ(log.end[0], 4000, "first range end");
+    ASSERT_EQ(log.first[1], 10000, "last block start");
+    ASSERT_EQ(log.end[1], 10500, "last block ends at sample_count");
+
+    cleanup_test_file();
+    PASS();
+}
+
+TEST(iqr_crc_truncated) {
+    cleanup_test_file();
+    record_crc_file(false);
+
+    /* Keep the header and the first 6000 samples */
+    FILE *f = fopen(TEST_FILENAME, "rb");
+    ASSERT_NOT_NULL(f, "open original");
+    static uint8_t bytes[IQR_HEADER_SIZE + 6000 * 4];
+    size_t got = fread(bytes, 1, sizeof(bytes), f);
+    fclose(f);
+    ASSERT_EQ(got, sizeof(bytes), "read prefix");
+    f = fopen(TEST_FILENAME, "wb");
+    fwrite(bytes, 1, sizeof(bytes), f);
+    fclose(f);
+
+    damage_log_t log = { {0}, {0}, 0 };
+    iqr_verify_result_t res;
+    ASSERT_EQ(iqr_verify(TEST_FILENAME, NULL, 0, log_damage, &log, &res), IQR_OK, "verify");
+    ASSERT_EQ(res.samples_present, 6000, "samples present");
+    ASSERT_EQ(res.block_samples, 0, "CRCs lost with the tail");
+    ASSERT_EQ(log.count, 1, "one range");
+    ASSERT_EQ(log.first[0], 6000, "missing from");
+    ASSERT_EQ(log.end[0], 10500, "missing to");
+
+    cleanup_test_file();
+    PASS();
+}
+
+TEST(iqr_crc_absent) {
+    cleanup_test_file();
+
+    iqr_recorder_t *rec = NULL;
+    iqr_create(&rec, 0);
+    iqr_start(rec, TEST_FILENAME, 1000.0, 5000000.0, 600, 40, 3);
+    ASSERT_EQ(iqr_set_crc_block(rec, CRC_BLOCK), IQR_ERR_ALREADY_RECORDING, "not while recording");
+    int16_t xi[100] = {0}, xq[100] = {0};
+    iqr_write(rec, xi, xq, 100);
+    iqr_stop(rec);
+    iqr_destroy(rec);
+
+    damage_log_t log = { {0}, {0}, 0 };
+    iqr_verify_result_t res;
+    ASSERT_EQ(iqr_verify(TEST_FILENAME, NULL, 0, log_damage, &log, &res), IQR_OK, "verify");
+    ASSERT_EQ(res.block_samples, 0, "nothing to check");
+    ASSERT_EQ(res.blocks_checked, 0, "no blocks");
+    ASSERT_EQ(log.count, 0, "no damage reported");
+
+    ASSERT_EQ(iqr_verify("nonexistent_file.iqr", NULL, 0, NULL, NULL, &res), IQR_ERR_FILE_OPEN,
+              "missing file");
+    cleanup_test_file();
+    PASS();
+}
+
+TEST(iqr_trailer_write_fails) {
+#ifdef _WIN32
+    SKIP("needs RLIMIT_FSIZE");
+#else
+    cleanup_test_file();
+
+    iqr_recorder_t *rec = NULL;
+    iqr_create(&rec, 300);
+    iqr_set_crc_block(rec, CRC_BLOCK);
+    iqr_start(rec, TEST_FILENAME, 1000.0, 5000000.0, 600, 40, 3);
+    int16_t xi[700], xq[700];
+    for (int k = 0; k < 15; k++) {
+        for (int i = 0; i < 700; i++) {
+            xi[i] = (int16_t)(k * 700 + i);
+            xq[i] = (int16_t)-i;
+        }
+        iqr_timing_entry_t e = make_entry(iqr_get_sample_count(rec), START_US + k * 700000LL, IQR_TIMING_GPS);
+        iqr_add_timing(rec, &e);
+        iqr_write(rec, xi, xq, 700);
+    }
+
+    /* Room for the samples and 10 bytes of trailer: the disk fills mid-chunk */
+    const long data_end = IQR_HEADER_SIZE + 10500 * 4;
+    struct rlimit old, lim;
+    getrlimit(RLIMIT_FSIZE, &old);
+    lim = old;
+    lim.rlim_cur = (rlim_t)(data_end + 10);
+    void (*old_handler)(int) = signal(SIGXFSZ, SIG_IGN);
+    setrlimit(RLIMIT_FSIZE, &lim);
+    iqr_error_t err = iqr_stop(rec);
+    setrlimit(RLIMIT_FSIZE, &old);
+    signal(SIGXFSZ, old_handler);
+    iqr_destroy(rec);
+    ASSERT_EQ(err, IQR_ERR_FILE_WRITE, "trailer failure reported");
+
+    /* The recording itself survives, without the trailer */
+    FILE *f = fopen(TEST_FILENAME, "rb");
+    ASSERT_NOT_NULL(f, "file kept");
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    ASSERT_EQ(size, data_end, "cut back to the last sample");
+
+    iqr_reader_t *reader = NULL;
+    ASSERT_EQ(iqr_open(&reader, TEST_FILENAME), IQR_OK, "opens");
+    const iqr_header_t *hdr = iqr_get_header(reader);
+    ASSERT_EQ(hdr->sample_count, 10500, "sample_count written");
+    ASSERT_EQ(hdr->flags, 0, "no trailer flags");
+    size_t n = 1;
+    ASSERT_NULL(iqr_get_timing(reader, &n), "no timing track");
+    int16_t ri[10], rq[10];
+    uint32_t got = 0;
+    iqr_seek(reader, 10490);
+    ASSERT_EQ(iqr_read(reader, ri, rq, 10, &got), IQR_OK, "read tail");
+    ASSERT_EQ(got, 10, "last samples");
+    ASSERT_EQ(ri[9], 10499, "last I");
+    iqr_close(reader);
+
+    iqr_verify_result_t res;
+    ASSERT_EQ(iqr_verify(TEST_FILENAME, NULL, 0, NULL, NULL, &res), IQR_OK, "verify");
+    ASSERT_EQ(res.samples_present, 10500, "all present");
+    ASSERT_EQ(res.block_samples, 0, "no CRCs claimed");
+
+    cleanup_test_file();
+    PASS();
+#endif
+}
+
 /*============================================================================
  * Main
  *============================================================================*/
@@ -401,6 +882,20 @@ int main(void) {
     TEST_SECTION("File Format");
     RUN_TEST(iqr_header_size);
 
+    TEST_SECTION("Timing Track");
+    RUN_TEST(iqr_timing_roundtrip);
+    RUN_TEST(iqr_timing_order);
+    RUN_TEST(iqr_timing_seek_multi_hour);
+    RUN_TEST(iqr_timing_without_track);
+    RUN_TEST(iqr_timing_damaged_track);
+
+    TEST_SECTION("Integrity");
+    RUN_TEST(iqr_crc_clean);
+    RUN_TEST(iqr_crc_damage);
+    RUN_TEST(iqr_crc_truncated);
+    RUN_TEST(iqr_crc_absent);
+    RUN_TEST(iqr_trailer_write_fails);
+
     TEST_END();
     return TEST_EXIT_CODE();
 }
@@ -0,0 +1,276 @@
+/**
+ * @file test_iqr_export.c
+ * @brief Unit tests for iqr_export module
+ *
+ * - Vectorized sample conversion matches the scalar reference
+ * - WAV header round trip, RF64 promotion above 4 GB
+ * - SigMF meta fields written and read back
+ * - UTC parsing and time-range slicing
+ */
+
+#include "test_framework.h"
+#include "iqr_export.h"
+#include <math.h>
+
+/*============================================================================
+ * Sample Conversion Tests
+ *============================================================================*/
+
+TEST(convert_s16_f32_matches_scalar) {
+    enum { N = 1037 };                  /* Odd length exercises the scalar tail */
+    static int16_t in[N];
+    static float simd[N], ref[N];
+    uint32_t lcg = 1;
+    for (int i = 0; i < N; i++) {
+        lcg = lcg * 1664525u + 1013904223u;
+        in[i] = (int16_t)(lcg >> 16);
+    }
+    in[0] = -32768;
+    in[1] = 32767;
+
+    iqr_convert_s16_f32(in, simd, N);
+    iqr_convert_s16_f32_scalar(in, ref, N);
+    ASSERT_EQ(memcmp(simd, ref, sizeof(simd)), 0, "bit-identical to scalar");
+    ASSERT_FLOAT_EQ(ref[0], -1.0f, 1e-9f, "full scale negative");
+    ASSERT_FLOAT_EQ(ref[1], 32767.0f / 32768.0f, 1e-9f, "full scale positive");
+    PASS();
+}
+
+TEST(convert_f32_s16_saturates) {
+    enum { N = 1029 };
+    static float in[N];
+    static int16_t simd[N], ref[N];
+    uint32_t lcg = 7;
+    for (int i = 0; i < N; i++) {
+        lcg = lcg * 1664525u + 1013904223u;
+        in[i] = ((float)(lcg >> 8) / 16777216.0f - 0.5f) * 2.5f;    /* +/-1.25 */
+    }
+    in[0] = 1.0f;
+    in[1] = -1.0f;
+    in[2] = 1e10f;
+    in[3] = -1e10f;
+    in[4] = 0.5f / 32768.0f;            /* Ties round to even */
+
+    iqr_convert_f32_s16(in, simd, N);
+    iqr_convert_f32_s16_scalar(in, ref, N);
+    ASSERT_EQ(memcmp(simd, ref, sizeof(simd)), 0, "bit-identical to scalar");
+    ASSERT_EQ(ref[0], 32767, "+1.0 saturates");
+    ASSERT_EQ(ref[1], -32768, "-1.0 exact");
+    ASSERT_EQ(ref[2], 32767, "huge positive saturates");
+    ASSERT_EQ(ref[3], -32768, "huge negative saturates");
+    ASSERT_EQ(ref[4], 0, "half step rounds to even");
+    PASS();
+}
+
+TEST(convert_round_trip) {
+    static int16_t in[512], back[512];
+    static float f[512];
+    for (int i = 0; i < 512; i++) in[i] = (int16_t)(i * 128 - 32768);
+    iqr_convert_s16_f32(in, f, 512);
+    iqr_convert_f32_s16(f, back, 512);
+    ASSERT_EQ(memcmp(in, back, sizeof(in)), 0, "cs16 -> cf32 -> cs16 lossless");
+    PASS();
+}
+
+/*============================================================================
+ * WAV Tests
+ *============================================================================*/
+
+TEST(wav_header_round_trip) {
+    uint8_t hdr[IQR_WAV_HEADER_SIZE];
+    iqr_wav_info_t info;
+
+    iqr_wav_build_header(hdr, 2000000, IQR_SAMPLE_CS16, 4000000);
+    ASSERT_EQ(memcmp(hdr, "RIFF", 4), 0, "small file is RIFF");
+    ASSERT_TRUE(iqr_wav_parse_header(hdr, sizeof(hdr), &info), "parses");
+    ASSERT_EQ(info.sample_rate, 2000000, "rate");
+    ASSERT_EQ(info.type, IQR_SAMPLE_CS16, "16-bit PCM");
+    ASSERT_EQ(info.data_offset, IQR_WAV_HEADER_SIZE, "data offset");
+    ASSERT_EQ(info.data_bytes, 4000000, "data size");
+    ASSERT_FALSE(info.is_rf64, "not RF64");
+
+    iqr_wav_build_header(hdr, 48000, IQR_SAMPLE_CF32, 0);
+    ASSERT_TRUE(iqr_wav_parse_header(hdr, sizeof(hdr), &info), "float parses");
+    ASSERT_EQ(info.type, IQR_SAMPLE_CF32, "float");
+    PASS();
+}
+
+TEST(wav_rf64_above_4gb) {
+    uint8_t hdr[IQR_WAV_HEADER_SIZE];
+    iqr_wav_info_t info;
+    const uint64_t big = 6000000000ull;
+
+    iqr_wav_build_header(hdr, 2000000, IQR_SAMPLE_CS16, big);
+    ASSERT_EQ(memcmp(hdr, "RF64", 4), 0, "promoted to RF64");
+    ASSERT_EQ(memcmp(hdr + 12, "ds64", 4), 0, "JUNK became ds64");
+    ASSERT_TRUE(iqr_wav_parse_header(hdr, sizeof(hdr), &info), "parses");
+    ASSERT_TRUE(info.is_rf64, "RF64 flag");
+    ASSERT_EQ(info.data_bytes, big, "64-bit size from ds64");
+
+    /* Largest size that still fits a RIFF */
+    iqr_wav_build_header(hdr, 2000000, IQR_SAMPLE_CS16, 0xFFFFFFFFull - (IQR_WAV_HEADER_SIZE - 8));
+    ASSERT_EQ(memcmp(hdr, "RIFF", 4), 0, "boundary stays RIFF");
+    PASS();
+}
+
+TEST(wav_rejects_mono) {
+    uint8_t hdr[IQR_WAV_HEADER_SIZE];
+    iqr_wav_info_t info;
+    iqr_wav_build_header(hdr, 48000, IQR_SAMPLE_CS16, 100);
+    hdr[58] = 1;                        /* channels = 1 */
+    ASSERT_FALSE(iqr_wav_parse_header(hdr, sizeof(hdr), &info), "mono is not I/Q");
+    ASSERT_FALSE(iqr_wav_parse_header((const uint8_t *)"RIFX....WAVE", 12, &info), "bad magic");
+    PASS();
+}
+
+/*============================================================================
+ * SigMF Tests
+ *============================================================================*/
+
+TEST(sigmf_meta_round_trip) {
+    iqr_stream_info_t info = {
+        .type = IQR_SAMPLE_CS16, .sample_rate_hz = 2000000.0, .center_freq_hz = 10000000.0,
+        .bandwidth_khz = 200, .gain_reduction = 40, .lna_state = 2,
+        .sample_count = 2000000ull * 120,                           /* 120 s */
+    };
+    iqr_parse_utc("2025-12-18T14:30:30.5Z", 0, &info.start_time_us);
+
+    iqr_meta_t meta;
+    memset(&meta, 0, sizeof(meta));
+    meta.gps_valid = true;
+    meta.gps_satellites = 9;
+    meta.gps_pc_offset_ms = 1.25;
+    meta.recording_complete = true;
+
+    static char json[8192];
+    FILE *f = tmpfile();
+    ASSERT_NOT_NULL(f, "tmpfile");
+    ASSERT_EQ(iqr_sigmf_write_meta(f, &info, &meta, 1234), 0, "write");
+    rewind(f);
+    size_t n = fread(json, 1, sizeof(json) - 1, f);
+    json[n] = '\0';
+    fclose(f);
+
+    ASSERT_NOT_NULL(strstr(json, "\"core:datatype\": \"ci16_le\""), "datatype");
+    ASSERT_NOT_NULL(strstr(json, "\"core:sample_rate\": 2000000,"), "integral rate");
+    ASSERT_NOT_NULL(strstr(json, "\"core:datetime\": \"2025-12-18T14:30:30.500000Z\""), "datetime");
+    ASSERT_NOT_NULL(strstr(json, "\"phoenix:source_offset\": 1234"), "slice offset");
+    ASSERT_NOT_NULL(strstr(json, "satellites=9"), "GPS annotation");
+    /* Minute boundaries at 14:31 and 14:32 fall inside 14:30:30.5 + 120 s */
+    ASSERT_NOT_NULL(strstr(json, "\"core:sample_start\": 59000000"), "14:31 at 29.5 s");
+    ASSERT_NOT_NULL(strstr(json, "UTC 14:32"), "14:32 marker");
+    ASSERT_NULL(strstr(json, "UTC 14:33"), "14:33 is past the end");
+
+    iqr_stream_info_t back;
+    ASSERT_TRUE(iqr_sigmf_parse_meta(json, &back), "parses");
+    ASSERT_EQ(back.type, IQR_SAMPLE_CS16, "type");
+    ASSERT_FLOAT_EQ(back.sample_rate_hz, 2000000.0, 1e-6, "rate");
+    ASSERT_FLOAT_EQ(back.center_freq_hz, 10000000.0, 1e-6, "frequency");
+    ASSERT_EQ(back.start_time_us, info.start_time_us, "datetime");
+    ASSERT_EQ(back.gain_reduction, 40, "gain reduction");
+    PASS();
+}
+
+TEST(sigmf_rejects_unsupported) {
+    iqr_stream_info_t info;
+    ASSERT_FALSE(iqr_sigmf_parse_meta("{\"global\": {\"core:datatype\": \"ri8\", "
+                                      "\"core:sample_rate\": 1000}}", &info), "real int8");
+    ASSERT_FALSE(iqr_sigmf_parse_meta("{\"global\": {\"core:datatype\": \"cf32_le\"}}", &info),
+                 "missing rate");
+    ASSERT_TRUE(iqr_sigmf_parse_meta("{\"global\":{\"core:datatype\":\"cf32_le\","
+                                     "\"core:sample_rate\":48000}}", &info), "compact JSON");
+    ASSERT_EQ(info.type, IQR_SAMPLE_CF32, "cf32");
+    PASS();
+}
+
+/*============================================================================
+ * UTC and Slicing Tests
+ *============================================================================*/
+
+TEST(utc_parse_and_format) {
+    int64_t t;
+    char buf[40];
+
+    ASSERT_TRUE(iqr_parse_utc("1970-01-01T00:00:01Z", 0, &t), "epoch + 1");
+    ASSERT_EQ(t, 1000000, "one second");
+    ASSERT_TRUE(iqr_parse_utc("2024-02-29 23:59:59.25", 0, &t), "leap day, space separator");
+    iqr_format_utc(t, buf, sizeof(buf));
+    ASSERT_STR_EQ(buf, "2024-02-29T23:59:59.250000Z", "formats back");
+
+    int64_t ref = t;
+    ASSERT_TRUE(iqr_parse_utc("01:02:03", ref, &t), "time of day");
+    iqr_format_utc(t, buf, sizeof(buf));
+    ASSERT_STR_EQ(buf, "2024-02-29T01:02:03.000000Z", "on the reference date");
+
+    ASSERT_FALSE(iqr_parse_utc("14:30", 0, &t), "seconds required");
+    ASSERT_FALSE(iqr_parse_utc("2024-13-01T00:00:00Z", 0, &t), "bad month");
+    ASSERT_FALSE(iqr_parse_utc("12:00:00 junk", 0, &t), "trailing junk");
+    PASS();
+}
+
+TEST(slice_range) {
+    iqr_stream_info_t info = { .sample_rate_hz = 2000000.0, .sample_count = 2000000ull * 120 };
+    iqr_parse_utc("2025-12-18T14:30:00Z", 0, &info.start_time_us);
+    uint64_t first, count;
+    int64_t from, to;
+
+    iqr_parse_utc("14:30:10", info.start_time_us, &from);
+    iqr_parse_utc("14:30:12.5", info.start_time_us, &to);
+    ASSERT_TRUE(iqr_slice_range(&info, from, to, &first, &count), "inside");
+    ASSERT_EQ(first, 20000000, "starts at 10 s");
+    ASSERT_EQ(count, 5000000, "2.5 s long");
+
+    iqr_parse_utc("14:29:00", info.start_time_us, &from);
+    ASSERT_TRUE(iqr_slice_range(&info, from, 0, &first, &count), "clipped start, open end");
+    ASSERT_EQ(first, 0, "clipped to start");
+    ASSERT_EQ(count, info.sample_count, "whole recording");
+
+    iqr_parse_utc("14:35:00", info.start_time_us, &from);
+    ASSERT_FALSE(iqr_slice_range(&info, from, 0, &first, &count), "after the end");
+
+    info.start_time_us = 0;
+    ASSERT_TRUE(iqr_slice_range(&info, 0, 0, &first, &count), "no bounds needs no time");
+    ASSERT_FALSE(iqr_slice_range(&info, to, 0, &first, &count), "bound without start time");
+    PASS();
+}
+
+TEST(format_detection) {
+    ASSERT_EQ(iqr_format_from_path("rec_20251218.iqr"), IQR_FMT_IQR, "iqr");
+    ASSERT_EQ(iqr_format_from_path("OUT.WAV"), IQR_FMT_WAV, "case-insensitive");
+    ASSERT_EQ(iqr_format_from_path("x.sigmf-meta"), IQR_FMT_SIGMF, "sigmf meta");
+    ASSERT_EQ(iqr_format_from_path("x.fc32"), IQR_FMT_CF32, "fc32 alias");
+    ASSERT_EQ(iqr_format_from_path("x.bin"), IQR_FMT_UNKNOWN, "unknown");
+    ASSERT_EQ(iqr_format_from_name("CS16"), IQR_FMT_CS16, "by name");
+    ASSERT_STR_EQ(iqr_format_name(IQR_FMT_SIGMF), "sigmf", "name");
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("IQR Export Tests");
+
+    TEST_SECTION("Sample Conversion");
+    RUN_TEST(convert_s16_f32_matches_scalar);
+    RUN_TEST(convert_f32_s16_saturates);
+    RUN_TEST(convert_round_trip);
+
+    TEST_SECTION("WAV / RF64");
+    RUN_TEST(wav_header_round_trip);
+    RUN_TEST(wav_rf64_above_4gb);
+    RUN_TEST(wav_rejects_mono);
+
+    TEST_SECTION("SigMF");
+    RUN_TEST(sigmf_meta_round_trip);
+    RUN_TEST(sigmf_rejects_unsupported);
+
+    TEST_SECTION("UTC and Slicing");
+    RUN_TEST(utc_parse_and_format);
+    RUN_TEST(slice_range);
+    RUN_TEST(format_detection);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
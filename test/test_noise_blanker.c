@@ -0,0 +1,340 @@
+/**
+ * @file test_noise_blanker.c
+ * @brief Unit tests for noise_blanker module
+ *
+ * The signal is the tone device's synthesizer (sdr_manager.c fill_tone)
+ * at -18 dB in receiver noise, with lightning-like impulses injected:
+ * a few rising pairs below the trigger, a full-scale peak, a decaying tail.
+ *
+ * - Config: defaults, delay, refusals
+ * - A clean signal comes out exactly, delayed by the look-ahead
+ * - Every impulse is found and blanked, rising edge included; nothing else
+ *   is touched
+ * - Zero and interpolate (hold, then a line) fill the gap as documented
+ * - Any block split, vector or scalar: the same bits and counts
+ * - Through split_stage, the detector stream error from impulses drops
+ */
+
+#include "test_framework.h"
+#include "noise_blanker.h"
+#include "../tools/split_stage.h"
+#include <math.h>
+#include <stdint.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define RATE            2000000.0f
+#define PAIRS           400000
+#define TONE_HZ         1000.0
+#define TONE_AMPLITUDE  16000.0         /* sdr_manager.c */
+#define TONE_SHIFT      3               /* -18 dB: a weak carrier */
+#define NOISE_HALF      260             /* Sum of 4 uniforms: sigma ~300 */
+#define IMPULSE_EVERY   20000
+#define IMPULSE_OFFSET  7919
+#define N_IMPULSES      ((PAIRS - IMPULSE_OFFSET - 64) / IMPULSE_EVERY + 1)
+
+/* Rising edge, peak, decay; the first two stay under the trigger level */
+static const int16_t g_shape[] = { 2500, 4500, 12000, 32000, 26000, 19000, 14000, 10000,
+                                   7500, 5500, 4000, 3000, 2200, 1600 };
+#define SHAPE_LEN       ((int)(sizeof(g_shape) / sizeof(g_shape[0])))
+#define SHAPE_PEAK      3
+
+static int16_t g_clean[PAIRS * 2];
+static int16_t g_dirty[PAIRS * 2];
+static int16_t g_out[PAIRS * 2];
+static int16_t g_out2[PAIRS * 2];
+
+static uint32_t g_lcg = 12345;
+
+static int noise(void) {
+    int s = 0;
+    for (int k = 0; k < 4; k++) {
+        g_lcg = g_lcg * 1664525u + 1013904223u;
+        s += (int)(g_lcg >> 16) % (2 * NOISE_HALF + 1) - NOISE_HALF;
+    }
+    return s;
+}
+
+static int16_t clamp16(int v) {
+    return (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : v);
+}
+
+static void make_signals(void) {
+    double phase = 0.0;
+    double inc = 2.0 * M_PI * TONE_HZ / RATE;
+    for (int n = 0; n < PAIRS; n++) {
+        int i = (int)lrint(cos(phase) * TONE_AMPLITUDE) >> TONE_SHIFT;
+        int q = (int)lrint(sin(phase) * TONE_AMPLITUDE) >> TONE_SHIFT;
+        g_clean[2 * n] = clamp16(i + noise());
+        g_clean[2 * n + 1] = clamp16(q + noise());
+        phase += inc;
+        if (phase >= M_PI) phase -= 2.0 * M_PI;
+        if (phase < -M_PI) phase += 2.0 * M_PI;
+    }
+
+    memcpy(g_dirty, g_clean, sizeof(g_clean));
+    for (int k = 0; k < N_IMPULSES; k++) {
+        int at = IMPULSE_OFFSET + k * IMPULSE_EVERY;
+        int sign = (k % 2) ? -1 : 1;
+        for (int s = 0; s < SHAPE_LEN; s++) {
+            g_dirty[2 * (at + s)] = clamp16(g_dirty[2 * (at + s)] + sign * g_shape[s]);
+            g_dirty[2 * (at + s) + 1] = clamp16(g_dirty[2 * (at + s) + 1] - sign * g_shape[s] * 3 / 4);
+        }
+    }
+}
+
+static noise_blanker_t *make_blanker(nb_mode_t mode) {
+    noise_blanker_config_t cfg;
+    noise_blanker_default_config(&cfg, RATE);
+    cfg.mode = mode;
+    return noise_blanker_create(&cfg);
+}
+
+/*============================================================================
+ * Config
+ *============================================================================*/
+
+TEST(config_and_refusals) {
+    noise_blanker_config_t cfg;
+    noise_blanker_default_config(&cfg, RATE);
+    ASSERT_FLOAT_EQ(cfg.threshold, NB_DEFAULT_THRESHOLD, 1e-6, "threshold");
+    ASSERT_EQ(cfg.mode, NB_MODE_INTERPOLATE, "interpolating");
+
+    noise_blanker_t *nb = noise_blanker_create(&cfg);
+    ASSERT_NOT_NULL(nb, "defaults");
+    ASSERT_EQ(noise_blanker_delay(nb), 16, "8 us at 2 MHz");
+    noise_blanker_destroy(nb);
+
+    cfg.threshold = 0.0f;
+    ASSERT_NULL(noise_blanker_create(&cfg), "zero threshold");
+    noise_blanker_default_config(&cfg, 0.0f);
+    ASSERT_NULL(noise_blanker_create(&cfg), "zero rate");
+    noise_blanker_default_config(&cfg, RATE);
+    cfg.lookahead_us = 1000.0f;
+    ASSERT_NULL(noise_blanker_create(&cfg), "look-ahead beyond NB_MAX_LOOKAHEAD");
+    cfg.lookahead_us = 0.0f;
+    nb = noise_blanker_create(&cfg);
+    ASSERT_NOT_NULL(nb, "no look-ahead");
+    ASSERT_EQ(noise_blanker_delay(nb), 0, "no delay");
+    noise_blanker_destroy(nb);
+    PASS();
+}
+
+/*============================================================================
+ * Blanking
+ *============================================================================*/
+
+TEST(clean_signal_delayed_exactly) {
+    noise_blanker_t *nb = make_blanker(NB_MODE_INTERPOLATE);
+    noise_blanker_stats_t st;
+    int d = noise_blanker_delay(nb);
+
+    noise_blanker_process(nb, g_clean, g_out, PAIRS);
+    noise_blanker_get_stats(nb, &st);
+    ASSERT_EQ(st.blanked, 0, "nothing blanked");
+    ASSERT_EQ(st.impulses, 0, "no impulses");
+    ASSERT_EQ(st.pairs, PAIRS, "pairs out");
+    ASSERT(st.average > 800 && st.average < 1800, "average |x| of the weak tone in noise");
+    ASSERT(st.level >= st.average * 6 - 6 && st.level <= st.average * 6 + 6, "level = 6 x average");
+
+    ASSERT(g_out[0] == 0 && g_out[2 * d - 1] == 0, "delay line starts empty");
+    ASSERT(memcmp(g_out + 2 * d, g_clean, sizeof(int16_t) * 2 * (PAIRS - d)) == 0, "delayed copy");
+    noise_blanker_destroy(nb);
+    PASS();
+}
+
+TEST(impulses_found_and_blanked) {
+    noise_blanker_t *nb = make_blanker(NB_MODE_INTERPOLATE);
+    noise_blanker_stats_t st;
+    int d = noise_blanker_delay(nb);
+
+    noise_blanker_process(nb, g_dirty, g_out, PAIRS);
+    noise_blanker_get_stats(nb, &st);
+    ASSERT_EQ(st.impulses, N_IMPULSES, "one window per impulse");
+
+    /* Trigger at the third pair (12000 > level); window runs from 8 us before to 16 us after the last */
+    int level = (int)st.level;
+    ASSERT(level > 4500 + 1200 && level < 12000 - 1200, "edge below, peak above the level");
+    int window = 16 + 32 + (SHAPE_PEAK + 6 - 2) + 1;
+    ASSERT(st.blanked >= (uint64_t)N_IMPULSES * (16 + 32 + 1), "at least one window each");
+    ASSERT(st.blanked <= (uint64_t)N_IMPULSES * (window + 4), "no more than the impulse needs");
+
+    int changed = 0;
+    for (int n = d; n < PAIRS; n++) {
+        const int16_t *in = g_dirty + 2 * (n - d);
+        const int16_t *out = g_out + 2 * n;
+        if (in[0] != out[0] || in[1] != out[1]) changed++;
+    }
+    ASSERT(changed <= (int)st.blanked, "only blanked pairs differ");
+
+    /* Every impulse pair replaced, and by nothing bigger than the clean signal */
+    const int peak = ((int)TONE_AMPLITUDE >> TONE_SHIFT) + 4 * NOISE_HALF;
+    for (int k = 0; k < N_IMPULSES; k++) {
+        int at = IMPULSE_OFFSET + k * IMPULSE_EVERY;
+        for (int s = 0; s < SHAPE_LEN; s++) {
+            const int16_t *in = g_dirty + 2 * (at + s);
+            const int16_t *out = g_out + 2 * (at + s + d);
+            if ((in[0] == out[0] && in[1] == out[1]) || abs(out[0]) > peak || abs(out[1]) > peak) {
+                printf("\n    impulse %d pair %d: %d %d\n", k, s, out[0], out[1]);
+                ASSERT(false, "impulse pair survived (rising edge included)");
+            }
+        }
+    }
+    noise_blanker_destroy(nb);
+    PASS();
+}
+
+TEST(zero_and_interpolate_fill) {
+    noise_blanker_t *zero = make_blanker(NB_MODE_ZERO);
+    noise_blanker_t *line = make_blanker(NB_MODE_INTERPOLATE);
+    int d = noise_blanker_delay(zero);
+    noise_blanker_process(zero, g_dirty, g_out, PAIRS);
+    noise_blanker_process(line, g_dirty, g_out2, PAIRS);
+
+    int at = IMPULSE_OFFSET + 3 * IMPULSE_EVERY + d;
+    int start = at, end = at;
+    while (g_out[2 * (start - 1)] == 0 && g_out[2 * (start - 1) + 1] == 0) start--;
+    while (g_out[2 * (end + 1)] == 0 && g_out[2 * (end + 1) + 1] == 0) end++;
+    ASSERT(end - start + 1 >= 16 + 32 + 1, "zeroed window");
+    ASSERT(start <= at - 16 + 2, "zeroing starts ahead of the trigger");
+
+    /* Hold the pair before, then a line to the pair after over the last 8 us */
+    for (int c = 0; c < 2; c++) {
+        int a = g_out2[2 * (start - 1) + c];
+        int b = g_out2[2 * (end + 1) + c];
+        int lo = a < b ? a : b, hi = a < b ? b : a;
+        int prev = a;
+        for (int n = start; n <= end; n++) {
+            int v = g_out2[2 * n + c];
+            if (end + 1 - n > d) ASSERT_EQ(v, a, "held");
+            ASSERT(v >= lo && v <= hi, "between the good pairs");
+            ASSERT(b >= a ? v >= prev : v <= prev, "monotonic");
+            prev = v;
+        }
+        int mid = g_out2[2 * (end + 1 - d / 2) + c];
+        ASSERT(abs(mid - (a + b) / 2) <= abs(b - a) / 10 + 2, "straight line");
+    }
+    noise_blanker_destroy(zero);
+    noise_blanker_destroy(line);
+    PASS();
+}
+
+TEST(any_block_split_vector_or_scalar) {
+    static const size_t sizes[] = { 1, 7, 8192, 63, 64, 65, 1000, 3 };
+    noise_blanker_t *whole = make_blanker(NB_MODE_INTERPOLATE);
+    noise_blanker_t *split = make_blanker(NB_MODE_INTERPOLATE);
+    noise_blanker_t *scalar = make_blanker(NB_MODE_INTERPOLATE);
+    noise_blanker_stats_t a, b, c;
+
+    noise_blanker_process(whole, g_dirty, g_out, PAIRS);
+
+    /* In place, odd blocks */
+    memcpy(g_out2, g_dirty, sizeof(g_dirty));
+    for (size_t done = 0, k = 0; done < PAIRS; k++) {
+        size_t n = sizes[k % 8];
+        if (n > PAIRS - done) n = PAIRS - done;
+        noise_blanker_process(split, g_out2 + done * 2, g_out2 + done * 2, n);
+        done += n;
+    }
+    ASSERT(memcmp(g_out, g_out2, sizeof(g_out)) == 0, "block split identical");
+
+    noise_blanker_process_scalar(scalar, g_dirty, g_out2, PAIRS);
+    ASSERT(memcmp(g_out, g_out2, sizeof(g_out)) == 0, "scalar identical");
+
+    noise_blanker_get_stats(whole, &a);
+    noise_blanker_get_stats(split, &b);
+    noise_blanker_get_stats(scalar, &c);
+    ASSERT(a.blanked == b.blanked && a.blanked == c.blanked, "same blanked count");
+    ASSERT(a.impulses == b.impulses && a.impulses == c.impulses, "same impulses");
+    ASSERT(a.average == b.average && a.level == c.level, "same average");
+
+    noise_blanker_reset(whole);
+    noise_blanker_process(whole, g_dirty, g_out2, PAIRS);
+    ASSERT(memcmp(g_out, g_out2, sizeof(g_out)) == 0, "reset starts over");
+    noise_blanker_destroy(whole);
+    noise_blanker_destroy(split);
+    noise_blanker_destroy(scalar);
+    PASS();
+}
+
+/*============================================================================
+ * Detector Stream
+ *============================================================================*/
+
+static float g_det[3][(PAIRS / SPLIT_DETECTOR_DECIMATION + 1) * 2];
+
+/* Detector output of iq through a split stage, with or without the blanker */
+static size_t detector(const int16_t *iq, bool blank, float *det) {
+    static float disp[SPLIT_DISPLAY_OUT_MAX * 2];
+    split_stage_t *s = split_stage_create();
+    noise_blanker_config_t cfg;
+    size_t n_det = 0;
+
+    noise_blanker_default_config(&cfg, RATE);
+    if (blank) split_stage_set_blanker(s, &cfg);
+    for (int done = 0; done < PAIRS; done += SPLIT_MAX_BLOCK) {
+        uint32_t n = PAIRS - done < SPLIT_MAX_BLOCK ? PAIRS - done : SPLIT_MAX_BLOCK;
+        split_output_t out = { det + n_det * 2, 0, disp, 0 };
+        split_stage_process_s16(s, iq + (size_t)done * 2, n, &out);
+        n_det += out.n_det;
+    }
+    split_stage_destroy(s);
+    return n_det;
+}
+
+static double error_power(const float *a, const float *b, size_t n) {
+    double e = 0.0;
+    for (size_t k = 0; k < n * 2; k++) e += (double)(a[k] - b[k]) * (a[k] - b[k]);
+    return e / (double)n;
+}
+
+TEST(detector_stream_cleaner) {
+    noise_blanker_stats_t st;
+    split_stage_t *probe = split_stage_create();
+    ASSERT_FALSE(split_stage_blanker_stats(probe, &st), "off by default");
+    noise_blanker_config_t cfg;
+    noise_blanker_default_config(&cfg, RATE);
+    cfg.threshold = -1.0f;
+    ASSERT_FALSE(split_stage_set_blanker(probe, &cfg), "bad config refused");
+    ASSERT_FALSE(split_stage_blanker_stats(probe, &st), "and left off");
+    split_stage_destroy(probe);
+
+    /* The blanker delays by 16 pairs: compare like with like */
+    size_t n = detector(g_clean, true, g_det[0]);
+    detector(g_dirty, true, g_det[1]);
+    double with = error_power(g_det[0], g_det[1], n);
+    detector(g_clean, false, g_det[0]);
+    detector(g_dirty, false, g_det[2]);
+    double without = error_power(g_det[0], g_det[2], n);
+
+    printf("\n    impulse error in the detector stream: %.1f dB without, %.1f dB with the blanker  ",
+           10.0 * log10(without), 10.0 * log10(with));
+    ASSERT(with * 30.0 < without, "at least 15 dB less impulse energy");
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Noise Blanker Tests");
+    make_signals();
+
+    TEST_SECTION("Config");
+    RUN_TEST(config_and_refusals);
+
+    TEST_SECTION("Blanking");
+    RUN_TEST(clean_signal_delayed_exactly);
+    RUN_TEST(impulses_found_and_blanked);
+    RUN_TEST(zero_and_interpolate_fill);
+    RUN_TEST(any_block_split_vector_or_scalar);
+
+    TEST_SECTION("Detector Stream");
+    RUN_TEST(detector_stream_cleaner);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,186 @@
+/**
+ * @file test_notify_queue.c
+ * @brief Unit tests for notify_queue module
+ *
+ * - Gain reports coalesce to the latest value
+ * - Overload edges delivered in order, duplicates ignored
+ * - Flapping collapses whole pairs and ends in the current state
+ * - Concurrent posters never lose the final state
+ */
+
+#include "test_framework.h"
+#include "notify_queue.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+/*============================================================================
+ * Gain Tests
+ *============================================================================*/
+
+TEST(gain_latest_wins) {
+    notify_queue_t *q = notify_queue_create();
+    ASSERT_NOT_NULL(q, "create");
+    notify_event_t ev[NOTIFY_MAX_EVENTS];
+
+    ASSERT_EQ(notify_queue_drain(q, ev), 0, "empty");
+
+    notify_post_gain(q, 40, 0);
+    notify_post_gain(q, 35, 12);
+    notify_post_gain(q, 30, 24);
+    ASSERT_EQ(notify_queue_drain(q, ev), 1, "one coalesced report");
+    ASSERT_EQ(ev[0].type, NOTIFY_GAIN_CHANGE, "type");
+    ASSERT_EQ(ev[0].gr_db, 30, "latest GR");
+    ASSERT_EQ(ev[0].lna_gr_db, 24, "latest LNA");
+    ASSERT_EQ(notify_queue_drain(q, ev), 0, "slot cleared");
+
+    notify_stats_t st;
+    notify_queue_get_stats(q, &st);
+    ASSERT_EQ(st.gain_posts, 3, "posts");
+    ASSERT_EQ(st.gain_coalesced, 2, "two overwritten");
+    notify_queue_destroy(q);
+    PASS();
+}
+
+/*============================================================================
+ * Overload Tests
+ *============================================================================*/
+
+TEST(overload_edges_in_order) {
+    notify_queue_t *q = notify_queue_create();
+    notify_event_t ev[NOTIFY_MAX_EVENTS];
+
+    ASSERT_FALSE(notify_post_overload(q, false), "already clear");
+    ASSERT_TRUE(notify_post_overload(q, true), "rising edge");
+    ASSERT_FALSE(notify_post_overload(q, true), "repeat ignored");
+    ASSERT_TRUE(notify_post_overload(q, false), "falling edge");
+    notify_post_gain(q, 20, 0);
+
+    ASSERT_EQ(notify_queue_drain(q, ev), 3, "two edges and a gain report");
+    ASSERT_EQ(ev[0].type, NOTIFY_OVERLOAD, "edges first");
+    ASSERT_TRUE(ev[0].overloaded, "DETECTED first");
+    ASSERT_FALSE(ev[1].overloaded, "then CLEARED");
+    ASSERT_EQ(ev[2].type, NOTIFY_GAIN_CHANGE, "gain last");
+
+    char line[64];
+    notify_format(&ev[0], line, sizeof(line));
+    ASSERT_STR_EQ(line, "! OVERLOAD DETECTED", "overload line");
+    notify_format(&ev[2], line, sizeof(line));
+    ASSERT_STR_EQ(line, "! GAIN_CHANGE GR_ACTUAL=20 LNA_GR=0", "gain line");
+    notify_queue_destroy(q);
+    PASS();
+}
+
+TEST(overload_flapping_collapses_pairs) {
+    notify_queue_t *q = notify_queue_create();
+    notify_event_t ev[NOTIFY_MAX_EVENTS];
+
+    /* 11 edges: ends overloaded */
+    for (int i = 0; i < 11; i++) notify_post_overload(q, (i & 1) == 0);
+
+    int n = notify_queue_drain(q, ev);
+    ASSERT_TRUE(n <= NOTIFY_MAX_EDGES_PER_DRAIN, "bounded per drain");
+    ASSERT_EQ(n % 2, 1, "odd count keeps parity");
+    for (int i = 0; i < n; i++) {
+        ASSERT_EQ(ev[i].overloaded, (i % 2) == 0, "alternating from DETECTED");
+    }
+    ASSERT_TRUE(ev[n - 1].overloaded, "ends in current state");
+
+    notify_stats_t st;
+    notify_queue_get_stats(q, &st);
+    ASSERT_EQ(st.overload_edges, 11, "all edges counted");
+    ASSERT_EQ(st.edges_collapsed, (uint64_t)(11 - n), "rest collapsed");
+    notify_queue_destroy(q);
+    PASS();
+}
+
+TEST(resync_discards_pending) {
+    notify_queue_t *q = notify_queue_create();
+    notify_event_t ev[NOTIFY_MAX_EVENTS];
+
+    notify_post_overload(q, true);
+    notify_post_gain(q, 50, 0);
+    notify_queue_resync(q);
+    ASSERT_EQ(notify_queue_drain(q, ev), 0, "nothing after resync");
+
+    notify_post_overload(q, false);
+    ASSERT_EQ(notify_queue_drain(q, ev), 1, "new edge");
+    ASSERT_FALSE(ev[0].overloaded, "parity survives resync");
+    notify_queue_destroy(q);
+    PASS();
+}
+
+/*============================================================================
+ * Concurrency Test
+ *============================================================================*/
+
+#define POSTS_PER_THREAD    100000
+#define POSTER_THREADS      3
+
+static atomic_int g_posters_done;
+
+static void *poster_thread(void *arg) {
+    notify_queue_t *q = (notify_queue_t *)arg;
+    for (int i = 0; i < POSTS_PER_THREAD; i++) {
+        notify_post_gain(q, i % 60, (i % 4) * 6);
+        notify_post_overload(q, (i % 3) == 0);
+    }
+    atomic_fetch_add(&g_posters_done, 1);
+    return NULL;
+}
+
+/* Every delivered edge must flip the state */
+static int check_edges(const notify_event_t *ev, int n, bool *state) {
+    int mismatches = 0;
+    for (int i = 0; i < n; i++) {
+        if (ev[i].type != NOTIFY_OVERLOAD) continue;
+        if (ev[i].overloaded == *state) mismatches++;
+        *state = ev[i].overloaded;
+    }
+    return mismatches;
+}
+
+TEST(concurrent_posters) {
+    notify_queue_t *q = notify_queue_create();
+    notify_event_t ev[NOTIFY_MAX_EVENTS];
+    pthread_t threads[POSTER_THREADS];
+    bool state = false;
+    int mismatches = 0;
+
+    atomic_store(&g_posters_done, 0);
+    for (int t = 0; t < POSTER_THREADS; t++) {
+        pthread_create(&threads[t], NULL, poster_thread, q);
+    }
+    while (atomic_load(&g_posters_done) < POSTER_THREADS) {
+        mismatches += check_edges(ev, notify_queue_drain(q, ev), &state);
+    }
+    for (int t = 0; t < POSTER_THREADS; t++) pthread_join(threads[t], NULL);
+    mismatches += check_edges(ev, notify_queue_drain(q, ev), &state);
+
+    /* Each thread's last post is i = POSTS-1 -> (99999 % 3 == 0) -> overloaded */
+    ASSERT_EQ(mismatches, 0, "edges always alternate");
+    ASSERT_TRUE(state, "final state delivered");
+    notify_queue_destroy(q);
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Notification Queue Tests");
+
+    TEST_SECTION("Gain");
+    RUN_TEST(gain_latest_wins);
+
+    TEST_SECTION("Overload");
+    RUN_TEST(overload_edges_in_order);
+    RUN_TEST(overload_flapping_collapses_pairs);
+    RUN_TEST(resync_discards_pending);
+
+    TEST_SECTION("Concurrency");
+    RUN_TEST(concurrent_posters);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,219 @@
+/**
+ * @file test_pipe_queue.c
+ * @brief Unit tests for pipe_queue module
+ *
+ * - Blocks come out in order with their samples and tags
+ * - A full queue refuses a poll and counts the wait; timeouts expire
+ * - Close wakes a waiting side, refuses new blocks, drains the rest
+ * - Producer and consumer threads: every block, in order, bounded depth
+ */
+
+#include "test_framework.h"
+#include "pipe_queue.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#define sleep_ms(ms) Sleep(ms)
+#else
+#include <unistd.h>
+#define sleep_ms(ms) usleep((ms) * 1000)
+#endif
+
+static double now_ms(void) {
+#ifdef _WIN32
+    return (double)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+/*============================================================================
+ * Single Thread
+ *============================================================================*/
+
+TEST(blocks_in_order) {
+    pipe_queue_t *q = pipe_queue_create(4, 16, 2 * sizeof(int16_t));
+    ASSERT_NOT_NULL(q, "create");
+    ASSERT_EQ(pipe_queue_capacity(q), 16, "pairs per block");
+    ASSERT_NULL(pipe_queue_front(q, 0), "empty");
+
+    for (uint32_t k = 0; k < 3; k++) {
+        pipe_block_t *b = pipe_queue_reserve(q, 0);
+        ASSERT_NOT_NULL(b, "room");
+        int16_t *s = (int16_t*)b->samples;
+        for (uint32_t i = 0; i < 10 + k; i++) {
+            s[2 * i] = (int16_t)(100 * k + i);
+            s[2 * i + 1] = (int16_t)-(int16_t)(100 * k + i);
+        }
+        b->stream = k % 2;
+        b->sequence = k;
+        b->count = 10 + k;
+        pipe_queue_commit(q);
+    }
+
+    for (uint32_t k = 0; k < 3; k++) {
+        pipe_block_t *b = pipe_queue_front(q, 0);
+        ASSERT_NOT_NULL(b, "queued");
+        ASSERT_EQ(b->sequence, k, "order");
+        ASSERT_EQ(b->stream, k % 2, "tag");
+        ASSERT_EQ(b->count, 10 + k, "count");
+        const int16_t *s = (const int16_t*)b->samples;
+        ASSERT_EQ(s[2 * (b->count - 1)], (int16_t)(100 * k + b->count - 1), "samples");
+        pipe_queue_pop(q);
+    }
+    ASSERT_NULL(pipe_queue_front(q, 0), "drained");
+
+    pipe_queue_stats_t st;
+    pipe_queue_get_stats(q, &st);
+    ASSERT_EQ(st.blocks, 3, "blocks");
+    ASSERT_EQ(st.pairs, 33, "pairs");
+    ASSERT_EQ(st.high_water, 3, "high water");
+    ASSERT_EQ(st.depth, 0, "empty now");
+    pipe_queue_destroy(q);
+    PASS();
+}
+
+TEST(full_queue_and_timeouts) {
+    pipe_queue_t *q = pipe_queue_create(2, 8, 2 * sizeof(float));
+    for (int k = 0; k < 2; k++) {
+        ASSERT_NOT_NULL(pipe_queue_reserve(q, 0), "room");
+        pipe_queue_commit(q);
+    }
+    ASSERT_NULL(pipe_queue_reserve(q, 0), "full: poll refused");
+
+    double t0 = now_ms();
+    ASSERT_NULL(pipe_queue_reserve(q, 50), "full: timed out");
+    ASSERT(now_ms() - t0 >= 40, "waited");
+
+    pipe_queue_pop(q);
+    ASSERT_NOT_NULL(pipe_queue_reserve(q, 0), "room after pop");
+    pipe_queue_commit(q);
+
+    pipe_queue_stats_t st;
+    pipe_queue_get_stats(q, &st);
+    ASSERT_EQ(st.full_waits, 2, "full waits");
+    ASSERT_EQ(st.depth, 2, "depth");
+    ASSERT_EQ(st.capacity, 2, "capacity");
+
+    pipe_queue_pop(q);
+    pipe_queue_pop(q);
+    t0 = now_ms();
+    ASSERT_NULL(pipe_queue_front(q, 50), "empty: timed out");
+    ASSERT(now_ms() - t0 >= 40, "waited");
+    pipe_queue_destroy(q);
+    PASS();
+}
+
+/*============================================================================
+ * Close
+ *============================================================================*/
+
+static void *wait_front(void *arg) {
+    return pipe_queue_front((pipe_queue_t*)arg, PIPE_QUEUE_WAIT);
+}
+
+TEST(close_wakes_and_drains) {
+    pipe_queue_t *q = pipe_queue_create(4, 8, 4);
+    pthread_t th;
+    void *got = (void*)1;
+
+    /* A consumer waiting forever is woken with nothing */
+    pthread_create(&th, NULL, wait_front, q);
+    sleep_ms(50);
+    pipe_queue_close(q);
+    pthread_join(th, &got);
+    ASSERT_NULL(got, "woken empty-handed");
+    pipe_queue_destroy(q);
+
+    /* Queued blocks survive the close; new ones are refused */
+    q = pipe_queue_create(4, 8, 4);
+    pipe_block_t *b = pipe_queue_reserve(q, 0);
+    b->sequence = 7;
+    pipe_queue_commit(q);
+    pipe_queue_close(q);
+    ASSERT_NULL(pipe_queue_reserve(q, PIPE_QUEUE_WAIT), "closed to producers");
+    b = pipe_queue_front(q, PIPE_QUEUE_WAIT);
+    ASSERT_NOT_NULL(b, "still readable");
+    ASSERT_EQ(b->sequence, 7, "the queued block");
+    pipe_queue_pop(q);
+    ASSERT_NULL(pipe_queue_front(q, PIPE_QUEUE_WAIT), "drained");
+    pipe_queue_destroy(q);
+    PASS();
+}
+
+/*============================================================================
+ * Threads
+ *============================================================================*/
+
+#define THREAD_BLOCKS   20000
+#define THREAD_PAIRS    64
+
+static void *producer(void *arg) {
+    pipe_queue_t *q = (pipe_queue_t*)arg;
+    for (uint32_t k = 0; k < THREAD_BLOCKS; k++) {
+        pipe_block_t *b = pipe_queue_reserve(q, PIPE_QUEUE_WAIT);
+        if (!b) break;
+        uint32_t *s = (uint32_t*)b->samples;
+        uint32_t n = 1 + k % THREAD_PAIRS;
+        for (uint32_t i = 0; i < n; i++) s[i] = k * 131u + i;
+        b->sequence = k;
+        b->count = n;
+        pipe_queue_commit(q);
+    }
+    return NULL;
+}
+
+TEST(threads_keep_order) {
+    pipe_queue_t *q = pipe_queue_create(4, THREAD_PAIRS, sizeof(uint32_t));
+    pthread_t th;
+    pthread_create(&th, NULL, producer, q);
+
+    bool ok = true;
+    for (uint32_t k = 0; k < THREAD_BLOCKS && ok; k++) {
+        pipe_block_t *b = pipe_queue_front(q, 5000);
+        if (!b) {
+            ok = false;
+            break;
+        }
+        const uint32_t *s = (const uint32_t*)b->samples;
+        ok = b->sequence == k && b->count == 1 + k % THREAD_PAIRS &&
+             s[0] == k * 131u && s[b->count - 1] == k * 131u + b->count - 1;
+        pipe_queue_pop(q);
+    }
+    pipe_queue_close(q);
+    pthread_join(th, NULL);
+    ASSERT(ok, "every block in order, intact");
+
+    pipe_queue_stats_t st;
+    pipe_queue_get_stats(q, &st);
+    ASSERT_EQ(st.blocks, THREAD_BLOCKS, "all committed");
+    ASSERT(st.high_water <= 4, "bounded");
+    pipe_queue_destroy(q);
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Pipe Queue Tests");
+
+    TEST_SECTION("Single Thread");
+    RUN_TEST(blocks_in_order);
+    RUN_TEST(full_queue_and_timeouts);
+
+    TEST_SECTION("Close");
+    RUN_TEST(close_wakes_and_drains);
+
+    TEST_SECTION("Threads");
+    RUN_TEST(threads_keep_order);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,412 @@
+/**
+ * @file test_pipeline.c
+ * @brief Unit tests for the in-process pipeline (tools/pipeline.c, tools/split_stage.c)
+ *
+ * - Descriptions parse, format back, and bad ones say why
+ * - split_stage gives the same output for any block split, and exactly
+ *   what signal_splitter's per-sample loop gave (float build) or the
+ *   scalar Q15 front ends give in one call (PHOENIX_FIXED_POINT build)
+ * - A tone through '>' queues and through '|' TCP links reaches relay
+ *   clients bit-identical, and equal to split_stage run on the tone directly
+ * - A phxi source (a tone device's raw port) gives the same frames
+ * - An S16 relay client gets the same frames, compactly encoded
+ * - A blank stage gives split_stage's output with its blanker on
+ */
+
+#include "test_framework.h"
+#include "../tools/pipeline.h"
+#include "../tools/split_stage.h"
+#include "iq_client.h"
+#include <math.h>
+#include <stdint.h>
+
+#ifdef PHOENIX_FIXED_POINT
+#include "dsp_q15.h"
+#else
+#include "../tools/waterfall_dsp.h"
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define TONE_HZ         1000.0
+#define TONE_AMPLITUDE  16000.0         /* sdr_manager.c */
+#define DET_FRAMES      6
+#define DISP_FRAMES     2
+#define DET_PAIRS       (DET_FRAMES * PIPELINE_FRAME_SIZE)
+#define DISP_PAIRS      (DISP_FRAMES * PIPELINE_FRAME_SIZE)
+#define REF_INPUT       (DISP_PAIRS * SPLIT_DISPLAY_DECIMATION + SPLIT_MAX_BLOCK)
+#define WAIT_MS         10000
+
+/*============================================================================
+ * Reference: the tone device's samples through split_stage directly
+ *============================================================================*/
+
+static int16_t g_tone[REF_INPUT * 2];
+static float g_ref_det[(REF_INPUT / SPLIT_DETECTOR_DECIMATION + 1) * 2];
+static float g_ref_disp[(REF_INPUT / SPLIT_DISPLAY_DECIMATION + 1) * 2];
+
+/* As fill_tone() in sdr_manager.c */
+static void make_tone(void) {
+    double phase = 0.0;
+    double inc = 2.0 * M_PI * TONE_HZ / 2000000.0;
+    for (int i = 0; i < REF_INPUT; i++) {
+        g_tone[2 * i] = (int16_t)lrint(cos(phase) * TONE_AMPLITUDE);
+        g_tone[2 * i + 1] = (int16_t)lrint(sin(phase) * TONE_AMPLITUDE);
+        phase += inc;
+        if (phase >= M_PI) phase -= 2.0 * M_PI;
+        if (phase < -M_PI) phase += 2.0 * M_PI;
+    }
+}
+
+/* Split in blocks cycling through sizes; returns false if create fails */
+static bool split_all(const int16_t *iq, int pairs, const uint32_t *sizes, int n_sizes, bool blank,
+                      float *det, size_t *n_det, float *disp, size_t *n_disp) {
+    split_stage_t *s = split_stage_create();
+    if (!s) return false;
+    if (blank) {
+        noise_blanker_config_t nb;
+        noise_blanker_default_config(&nb, (float)SPLIT_INPUT_RATE);
+        split_stage_set_blanker(s, &nb);
+    }
+    *n_det = 0;
+    *n_disp = 0;
+    for (int done = 0, k = 0; done < pairs; k++) {
+        uint32_t n = sizes[k % n_sizes];
+        if (n > (uint32_t)(pairs - done)) n = (uint32_t)(pairs - done);
+        split_output_t out = { det + *n_det * 2, 0, disp + *n_disp * 2, 0 };
+        split_stage_process_s16(s, iq + (size_t)done * 2, n, &out);
+        *n_det += out.n_det;
+        *n_disp += out.n_disp;
+        done += (int)n;
+    }
+    split_stage_destroy(s);
+    return true;
+}
+
+static void make_reference(bool blank) {
+    static const uint32_t block = SPLIT_MAX_BLOCK;
+    size_t n_det, n_disp;
+    split_all(g_tone, REF_INPUT, &block, 1, blank, g_ref_det, &n_det, g_ref_disp, &n_disp);
+}
+
+/*============================================================================
+ * Description
+ *============================================================================*/
+
+TEST(parse_descriptions) {
+    pipeline_desc_t d;
+    char err[128];
+    char text[512];
+
+    ASSERT_TRUE(pipeline_parse("tone > split > relay", &d, err, sizeof(err)), "minimal");
+    ASSERT_EQ(d.n_stages, 3, "three stages");
+    ASSERT_EQ(d.stages[0].type, PIPE_STAGE_TONE, "tone");
+    ASSERT_FLOAT_EQ(d.stages[0].tone_hz, 1000.0, 1e-9, "default offset");
+    ASSERT_EQ(d.links[0], PIPE_LINK_QUEUE, "queue link");
+    ASSERT_EQ(d.stages[2].det_port, PIPELINE_DEFAULT_DET_PORT, "default detector port");
+    ASSERT_EQ(d.stages[2].disp_port, PIPELINE_DEFAULT_DISP_PORT, "default display port");
+    pipeline_format(&d, text, sizeof(text));
+    ASSERT_STR_EQ(text, "tone:1000 > split > relay:4410:4411", "formatted");
+
+    ASSERT_TRUE(pipeline_parse("  tone:-2500|split >relay:0:0 ", &d, err, sizeof(err)), "spacing, mixed links");
+    ASSERT_FLOAT_EQ(d.stages[0].tone_hz, -2500.0, 1e-9, "offset");
+    ASSERT_EQ(d.links[0], PIPE_LINK_TCP, "TCP link");
+    ASSERT_EQ(d.links[1], PIPE_LINK_QUEUE, "queue link");
+    ASSERT_EQ(d.stages[2].det_port, 0, "any port");
+
+    ASSERT_TRUE(pipeline_parse("replay:C:\\iq\\wwv.iqr > split > relay:5000", &d, err, sizeof(err)), "replay");
+    ASSERT_STR_EQ(d.stages[0].path, "C:\\iq\\wwv.iqr", "path keeps its colon");
+    ASSERT_EQ(d.stages[2].det_port, 5000, "detector port");
+    ASSERT_EQ(d.stages[2].disp_port, PIPELINE_DEFAULT_DISP_PORT, "display port defaulted");
+
+    ASSERT_TRUE(pipeline_parse("phxi:rx1.local:4536 | split | relay", &d, err, sizeof(err)), "phxi");
+    ASSERT_STR_EQ(d.stages[0].host, "rx1.local", "host");
+    ASSERT_EQ(d.stages[0].port, 4536, "port");
+    ASSERT_TRUE(pipeline_parse("rsp:1 > split > relay", &d, err, sizeof(err)), "rsp");
+    ASSERT_EQ(d.stages[0].device_idx, 1, "index");
+
+    ASSERT_TRUE(pipeline_parse("tone > blank:8 > split | relay", &d, err, sizeof(err)), "blank");
+    ASSERT_EQ(d.n_stages, 4, "four stages");
+    ASSERT_EQ(d.stages[1].type, PIPE_STAGE_BLANK, "blank stage");
+    ASSERT_FLOAT_EQ(d.stages[1].blank_threshold, 8.0, 1e-9, "threshold");
+    pipeline_format(&d, text, sizeof(text));
+    ASSERT_STR_EQ(text, "tone:1000 > blank:8 > split | relay:4410:4411", "formatted");
+    ASSERT_TRUE(pipeline_parse("tone | blank > split > relay", &d, err, sizeof(err)), "TCP into blank");
+    ASSERT_FLOAT_EQ(d.stages[1].blank_threshold, NB_DEFAULT_THRESHOLD, 1e-9, "default threshold");
+    ASSERT_FALSE(pipeline_parse("tone > blank | split > relay", &d, err, sizeof(err)), "blank | split");
+    ASSERT(strstr(err, "'>'") != NULL, "says why");
+    ASSERT_FALSE(pipeline_parse("tone > blank:0 > split > relay", &d, err, sizeof(err)), "bad threshold");
+    ASSERT_FALSE(pipeline_parse("tone > split > blank > relay", &d, err, sizeof(err)), "blank after split");
+
+    ASSERT_FALSE(pipeline_parse("tone > split >", &d, err, sizeof(err)), "trailing link");
+    ASSERT(strstr(err, "empty") != NULL, "says why");
+    ASSERT_FALSE(pipeline_parse("tone > mixer > relay", &d, err, sizeof(err)), "unknown stage");
+    ASSERT(strstr(err, "mixer") != NULL, "names it");
+    ASSERT_FALSE(pipeline_parse("split > tone > relay", &d, err, sizeof(err)), "wrong order");
+    ASSERT_FALSE(pipeline_parse("tone > relay", &d, NULL, 0), "no split");
+    ASSERT_FALSE(pipeline_parse("phxi:host:4536 > split > relay", &d, err, sizeof(err)), "phxi needs TCP");
+    ASSERT_FALSE(pipeline_parse("phxi:4536 | split | relay", &d, err, sizeof(err)), "phxi needs a host");
+    ASSERT_FALSE(pipeline_parse("tone:abc > split > relay", &d, err, sizeof(err)), "bad offset");
+    ASSERT_FALSE(pipeline_parse("tone > split > relay:70000", &d, err, sizeof(err)), "bad port");
+    PASS();
+}
+
+/*============================================================================
+ * Split Stage
+ *============================================================================*/
+
+static float g_det[(REF_INPUT / SPLIT_DETECTOR_DECIMATION + 1) * 2];
+static float g_disp[(REF_INPUT / SPLIT_DISPLAY_DECIMATION + 1) * 2];
+
+TEST(split_stage_any_block_split) {
+    static const uint32_t odd[] = { 1, 37, 8192, 999, 40, 166, 3 };
+    size_t n_det, n_disp;
+    ASSERT_TRUE(split_all(g_tone, REF_INPUT, odd, 7, false, g_det, &n_det, g_disp, &n_disp), "create");
+    ASSERT_EQ(n_det, REF_INPUT / SPLIT_DETECTOR_DECIMATION, "detector pairs");
+    ASSERT_EQ(n_disp, REF_INPUT / SPLIT_DISPLAY_DECIMATION, "display pairs");
+    ASSERT(memcmp(g_det, g_ref_det, n_det * 2 * sizeof(float)) == 0, "detector identical");
+    ASSERT(memcmp(g_disp, g_ref_disp, n_disp * 2 * sizeof(float)) == 0, "display identical");
+    PASS();
+}
+
+#ifndef PHOENIX_FIXED_POINT
+/* signal_splitter's loop before split_stage.c, sample by sample */
+TEST(split_stage_matches_splitter) {
+    wf_lowpass_t det_i, det_q, disp_i, disp_q;
+    int det_count = 0, disp_count = 0;
+    size_t n_det = 0, n_disp = 0;
+    wf_lowpass_init(&det_i, 5000.0f, 2000000.0f);
+    wf_lowpass_init(&det_q, 5000.0f, 2000000.0f);
+    wf_lowpass_init(&disp_i, 5000.0f, 2000000.0f);
+    wf_lowpass_init(&disp_q, 5000.0f, 2000000.0f);
+
+    for (int s = 0; s < REF_INPUT; s++) {
+        float i_raw = (float)g_tone[2 * s] / 32768.0f;
+        float q_raw = (float)g_tone[2 * s + 1] / 32768.0f;
+        float di = wf_lowpass_process(&det_i, i_raw);
+        float dq = wf_lowpass_process(&det_q, q_raw);
+        if (++det_count >= 40) {
+            det_count = 0;
+            g_det[n_det * 2] = di;
+            g_det[n_det * 2 + 1] = dq;
+            n_det++;
+        }
+        float pi = wf_lowpass_process(&disp_i, i_raw);
+        float pq = wf_lowpass_process(&disp_q, q_raw);
+        if (++disp_count >= 166) {
+            disp_count = 0;
+            g_disp[n_disp * 2] = pi;
+            g_disp[n_disp * 2 + 1] = pq;
+            n_disp++;
+        }
+    }
+    ASSERT(memcmp(g_det, g_ref_det, n_det * 2 * sizeof(float)) == 0, "detector bit-exact");
+    ASSERT(memcmp(g_disp, g_ref_disp, n_disp * 2 * sizeof(float)) == 0, "display bit-exact");
+    PASS();
+}
+#else
+static int16_t g_q15_out[(REF_INPUT / SPLIT_DETECTOR_DECIMATION + 1) * 2];
+
+/* One front end over the whole tone, scalar loop, scaled as split_stage does */
+static size_t q15_reference(int output_rate, float *out) {
+    q15_frontend_config_t cfg;
+    q15_frontend_default_config(&cfg, SPLIT_INPUT_RATE, output_rate);
+    q15_frontend_t *fe = q15_frontend_create(&cfg);
+    if (!fe) return 0;
+    size_t n = q15_frontend_process_scalar(fe, g_tone, REF_INPUT, g_q15_out,
+                                           REF_INPUT / SPLIT_DETECTOR_DECIMATION + 1);
+    q15_frontend_destroy(fe);
+    for (size_t k = 0; k < n * 2; k++) out[k] = g_q15_out[k] / 32768.0f;
+    return n;
+}
+
+TEST(split_stage_matches_q15_frontend) {
+    size_t n_det = q15_reference(SPLIT_DETECTOR_RATE, g_det);
+    size_t n_disp = q15_reference(SPLIT_DISPLAY_RATE, g_disp);
+    ASSERT_EQ(n_det, REF_INPUT / SPLIT_DETECTOR_DECIMATION, "detector pairs");
+    ASSERT_EQ(n_disp, REF_INPUT / SPLIT_DISPLAY_DECIMATION, "display pairs");
+    ASSERT(memcmp(g_det, g_ref_det, n_det * 2 * sizeof(float)) == 0, "detector bit-exact");
+    ASSERT(memcmp(g_disp, g_ref_disp, n_disp * 2 * sizeof(float)) == 0, "display bit-exact");
+
+    /* Not silence: the 1 kHz tone comes through at unity gain */
+    double power = 0.0;
+    for (size_t k = n_det / 2; k < n_det; k++) {
+        power += (double)g_det[k * 2] * g_det[k * 2] + (double)g_det[k * 2 + 1] * g_det[k * 2 + 1];
+    }
+    ASSERT_FLOAT_EQ(sqrt(power / (double)(n_det - n_det / 2)), TONE_AMPLITUDE / 32768.0, 0.01, "tone level");
+    PASS();
+}
+#endif
+
+/*============================================================================
+ * Pipelines
+ *============================================================================*/
+
+typedef struct {
+    iq_client_t *c;
+    float *out;
+    size_t want;
+    size_t got;
+    bool   connected;
+    double max_err;                 /* Against the reference */
+    const float *ref;
+} relay_client_t;
+
+static void client_open(relay_client_t *rc, int port, iq_encoding_t enc, float *out, size_t want,
+                        const float *ref) {
+    memset(rc, 0, sizeof(*rc));
+    rc->c = iq_client_create("127.0.0.1", port, IQ_CLIENT_PROTO_FT32);
+    iq_client_set_encoding(rc->c, enc);
+    rc->out = out;
+    rc->want = want;
+    rc->ref = ref;
+}
+
+/* Poll every client until each has connected (connect_only) or has its pairs */
+static bool clients_run(relay_client_t *rc, int n, bool connect_only) {
+    for (int t = 0; t < WAIT_MS / 10; t++) {
+        bool done = true;
+        for (int k = 0; k < n; k++) {
+            iq_client_frame_t f;
+            iq_client_status_t st = iq_client_next(rc[k].c, &f, 10);
+            if (st == IQ_CLIENT_CONNECTED) rc[k].connected = true;
+            if (st == IQ_CLIENT_FRAME && rc[k].got < rc[k].want) {
+                size_t take = f.num_samples;
+                const float *iq = (const float*)f.samples;
+                if (take > rc[k].want - rc[k].got) take = rc[k].want - rc[k].got;
+                if (rc[k].out) memcpy(rc[k].out + rc[k].got * 2, iq, take * 2 * sizeof(float));
+                for (size_t i = 0; i < take * 2; i++) {
+                    double e = fabs(iq[i] - rc[k].ref[rc[k].got * 2 + i]);
+                    if (e > rc[k].max_err) rc[k].max_err = e;
+                }
+                rc[k].got += take;
+            }
+            done = done && (connect_only ? rc[k].connected : rc[k].got >= rc[k].want);
+        }
+        if (done) return true;
+    }
+    return false;
+}
+
+static void clients_close(relay_client_t *rc, int n) {
+    for (int k = 0; k < n; k++) iq_client_destroy(rc[k].c);
+}
+
+/* Clients attached before START, as a late joiner would not see sample 0 */
+static bool run_tone(const char *text, sdr_manager_t *remote, bool s16_client, relay_client_t *rc,
+                     pipeline_stats_t *end) {
+    pipeline_desc_t d;
+    pipeline_stats_t st;
+    tcp_response_t resp;
+    int n = s16_client ? 3 : 2;
+
+    if (!pipeline_parse(text, &d, NULL, 0)) return false;
+    pipeline_t *p = pipeline_create(&d, NULL);
+    if (!p) return false;
+    pipeline_get_stats(p, &st);
+
+    client_open(&rc[0], st.det_port, IQ_ENC_F32, g_det, DET_PAIRS, g_ref_det);
+    client_open(&rc[1], st.disp_port, IQ_ENC_F32, g_disp, DISP_PAIRS, g_ref_disp);
+    if (s16_client) client_open(&rc[2], st.det_port, IQ_ENC_S16, NULL, DET_PAIRS, g_ref_det);
+
+    bool ok = clients_run(rc, n, true);
+    sdr_manager_execute(remote ? remote : pipeline_manager(p), "START", &resp);
+    ok = ok && clients_run(rc, n, false);
+
+    clients_close(rc, n);
+    if (end) pipeline_get_stats(p, end);
+    pipeline_destroy(p);
+    return ok;
+}
+
+TEST(queue_links_match_reference) {
+    relay_client_t rc[3];
+    ASSERT_TRUE(run_tone("tone:1000 > split > relay:0:0", NULL, true, rc, NULL), "frames received");
+    ASSERT(memcmp(g_det, g_ref_det, DET_PAIRS * 2 * sizeof(float)) == 0, "detector bit-identical");
+    ASSERT(memcmp(g_disp, g_ref_disp, DISP_PAIRS * 2 * sizeof(float)) == 0, "display bit-identical");
+    ASSERT(rc[2].max_err < 1e-4, "S16 client within its quantization");
+    ASSERT(rc[2].max_err > 0.0, "S16 client really got S16");
+    PASS();
+}
+
+TEST(tcp_links_match_reference) {
+    relay_client_t rc[2];
+    ASSERT_TRUE(run_tone("tone:1000 | split | relay:0:0", NULL, false, rc, NULL), "frames received");
+    ASSERT(memcmp(g_det, g_ref_det, DET_PAIRS * 2 * sizeof(float)) == 0, "detector bit-identical");
+    ASSERT(memcmp(g_disp, g_ref_disp, DISP_PAIRS * 2 * sizeof(float)) == 0, "display bit-identical");
+    PASS();
+}
+
+TEST(phxi_source_matches_reference) {
+    sdr_manager_t *remote = sdr_manager_create();
+    sdr_device_spec_t spec;
+    sdr_device_stats_t dev;
+    char text[128];
+    relay_client_t rc[2];
+
+    sdr_manager_spec_defaults(&spec, SDR_BACKEND_TONE);
+    spec.tone_hz = TONE_HZ;
+    spec.iq_port = SDR_PORT_ANY;
+    ASSERT_EQ(sdr_manager_add(remote, &spec), 0, "remote tone device");
+    sdr_manager_get_stats(remote, 0, &dev);
+    snprintf(text, sizeof(text), "phxi:127.0.0.1:%d | split > relay:0:0", dev.iq_port);
+
+    bool ok = run_tone(text, remote, false, rc, NULL);
+    sdr_manager_destroy(remote);
+    ASSERT_TRUE(ok, "frames received");
+    ASSERT(memcmp(g_det, g_ref_det, DET_PAIRS * 2 * sizeof(float)) == 0, "detector bit-identical");
+    ASSERT(memcmp(g_disp, g_ref_disp, DISP_PAIRS * 2 * sizeof(float)) == 0, "display bit-identical");
+    PASS();
+}
+
+/* A steady tone never triggers: the blanker only delays it */
+TEST(blank_stage_matches_reference) {
+    relay_client_t rc[2];
+    pipeline_stats_t st;
+
+    make_reference(true);
+    bool ok = run_tone("tone:1000 > blank > split > relay:0:0", NULL, false, rc, &st);
+    bool det_same = memcmp(g_det, g_ref_det, DET_PAIRS * 2 * sizeof(float)) == 0;
+    bool disp_same = memcmp(g_disp, g_ref_disp, DISP_PAIRS * 2 * sizeof(float)) == 0;
+    make_reference(false);
+    ASSERT_TRUE(ok, "frames received");
+    ASSERT_TRUE(det_same, "detector bit-identical");
+    ASSERT_TRUE(disp_same, "display bit-identical");
+    ASSERT(memcmp(g_det, g_ref_det, DET_PAIRS * 2 * sizeof(float)) != 0, "delayed");
+    ASSERT_TRUE(st.blanking, "blanker on");
+    ASSERT_EQ(st.blanked, 0, "nothing blanked");
+    ASSERT_EQ(st.impulses, 0, "no impulses");
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Pipeline Tests");
+    make_tone();
+    make_reference(false);
+
+    TEST_SECTION("Description");
+    RUN_TEST(parse_descriptions);
+
+    TEST_SECTION("Split Stage");
+    RUN_TEST(split_stage_any_block_split);
+#ifdef PHOENIX_FIXED_POINT
+    RUN_TEST(split_stage_matches_q15_frontend);
+#else
+    RUN_TEST(split_stage_matches_splitter);
+#endif
+
+    TEST_SECTION("Pipelines");
+    RUN_TEST(queue_links_match_reference);
+    RUN_TEST(tcp_links_match_reference);
+    RUN_TEST(phxi_source_matches_reference);
+    RUN_TEST(blank_stage_matches_reference);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,362 @@
+"""
+pytest suite for the Python bindings (python/phoenix_sdr)
+
+- iqr_read: header fields, samples mapped without copies, timing track and
+  CRC trailer, truncated files
+- detectors: minute marker and BCD pulses found where the synthetic signal
+  puts them, with the right widths; every event matches the checked-in
+  golden list (test/fixtures); bad rates are refused
+- bindings and iqr_detect agree bit for bit whatever the block size (both
+  wrap tools/wwv_blocks.c, so this checks the wrappers, not the detectors)
+
+Needs numpy and cffi. The detector tests also need the phoenix_detect
+library and iqr_detect (bin/ after build.ps1, or $PHOENIX_DETECT_LIB and
+$PHOENIX_IQR_DETECT) and are skipped without them.
+
+    python -m pytest test/test_py_bindings.py
+    python test/test_py_bindings.py --write-golden     # after a deliberate detector change
+"""
+
+import csv
+import os
+import subprocess
+import sys
+
+import pytest
+
+np = pytest.importorskip("numpy")
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+sys.path.insert(0, os.path.join(ROOT, "python"))
+
+from phoenix_sdr import iqr  # noqa: E402
+from phoenix_sdr import IqrError, iqr_read  # noqa: E402
+
+FLOAT_FIELDS = ("timestamp_ms", "duration_ms", "energy", "baseline", "score", "interval_ms")
+
+FIXTURES = os.path.join(ROOT, "test", "fixtures")
+RECORDINGS = {"250k": (250000, 16, 1), "100k": (100000, 16, 2)}
+MARKER_SECOND = 10                      # wwv_baseband: minute marker 10 s in
+BCD_START_MS = 30
+BCD_WIDTHS = (200, 500, 800)
+
+# Golden comparison: a frame either way for float differences between compilers
+GOLDEN_TOL_MS = 11.0
+
+# ============================================================================
+# Fixture Recordings
+# ============================================================================
+
+
+def write_iqr(path, iq, rate, timing=None, crcs=None, start_time_us=0):
+    """Write an .iqr file the way iq_recorder.c lays it out"""
+    header = np.zeros(1, iqr.HEADER_DTYPE)
+    header["magic"] = iqr.IQR_MAGIC
+    header["version"] = iqr.IQR_VERSION
+    header["sample_rate_hz"] = rate
+    header["center_freq_hz"] = 10e6
+    header["start_time_us"] = start_time_us
+    header["sample_count"] = len(iq)
+    if timing is not None:
+        header["flags"] |= iqr.IQR_FLAG_TIMING_TRACK
+    if crcs is not None:
+        header["flags"] |= iqr.IQR_FLAG_CRC32C
+        header["crc_block_samples"] = 65536
+
+    with open(path, "wb") as f:
+        f.write(header.tobytes())
+        f.write(np.ascontiguousarray(iq, "<i2").tobytes())
+        for magic, entries in ((b"IQRT", timing), (b"IQRC", crcs)):
+            if entries is None:
+                continue
+            chunk = np.zeros(1, iqr.CHUNK_DTYPE)
+            chunk["magic"] = magic
+            chunk["entry_size"] = entries.dtype.itemsize
+            chunk["entry_count"] = len(entries)
+            f.write(chunk.tobytes())
+            f.write(entries.tobytes())
+
+
+def wwv_baseband(rate, seconds, seed):
+    """
+    WWV-like baseband (carrier removed): 5 ms 1000 Hz ticks, an 800 ms
+    minute marker 10 s in, 100 Hz BCD pulses of 200/500/800 ms from 30 ms
+    into each second with a slow fade, and noise
+    """
+    rng = np.random.default_rng(seed)
+    widths = rng.choice(BCD_WIDTHS, size=seconds)
+    n = rate * seconds
+    t = np.arange(n) / rate
+    sec = np.arange(n) // rate
+    ms = (np.arange(n) % rate) * 1000.0 / rate
+    minute_sec = (sec + 50) % 60
+
+    tone = np.where(minute_sec == 0, ms < 800, (ms < 5) & (minute_sec != 29) & (minute_sec != 59))
+    fade = 1.0 + 0.5 * np.sin(2 * np.pi * t / 7.0)
+    bcd = np.where((ms >= 30) & (ms < 30 + widths[sec]), 0.5, 0.08) * fade
+
+    x = 0.5 * tone * np.exp(2j * np.pi * 1000 * t) + bcd * np.exp(2j * np.pi * 100 * t)
+    x += 0.05 * (rng.standard_normal(n) + 1j * rng.standard_normal(n))
+
+    iq = np.empty((n, 2), "<i2")
+    iq[:, 0] = np.clip(np.round(x.real * 8000), -32768, 32767)
+    iq[:, 1] = np.clip(np.round(x.imag * 8000), -32768, 32767)
+    return iq, widths
+
+
+def write_recording(path, name):
+    rate, seconds, seed = RECORDINGS[name]
+    iq, widths = wwv_baseband(rate, seconds, seed)
+    write_iqr(path, iq, rate)
+    return widths
+
+
+@pytest.fixture(scope="module", params=sorted(RECORDINGS), ids=sorted(RECORDINGS))
+def recording(request, tmp_path_factory):
+    path = tmp_path_factory.mktemp("iqr") / f"wwv_{request.param}.iqr"
+    return path, request.param, write_recording(path, request.param)
+
+
+# ============================================================================
+# iqr_read
+# ============================================================================
+
+
+def test_iqr_read_maps_samples(tmp_path):
+    iq = np.arange(2000, dtype="<i2").reshape(1000, 2)
+    path = tmp_path / "ramp.iqr"
+    write_iqr(path, iq, 2000000, start_time_us=1700000000000000)
+
+    rec = iqr_read(path)
+    assert len(rec) == 1000
+    assert rec.sample_rate == 2000000.0
+    assert rec.center_freq == 10e6
+    assert rec.start_time_us == 1700000000000000
+    assert rec.complete
+    np.testing.assert_array_equal(rec.samples, iq)
+    np.testing.assert_array_equal(rec.i, iq[:, 0])
+    np.testing.assert_array_equal(rec.q, iq[:, 1])
+    assert len(rec.timing) == 0 and len(rec.crcs) == 0
+
+    # Views of the file mapping, not copies
+    base = rec.samples
+    while base.base is not None and not isinstance(base, np.memmap):
+        base = base.base
+    assert isinstance(base, np.memmap)
+    assert not rec.samples.flags.owndata and not rec.samples.flags.writeable
+
+    blocks = list(rec.blocks(300))
+    assert [len(b) for b in blocks] == [300, 300, 300, 100]
+    assert np.shares_memory(blocks[1], rec.samples)
+    np.testing.assert_array_equal(np.concatenate(blocks), iq)
+
+
+def test_iqr_read_trailer(tmp_path):
+    iq = np.zeros((5000, 2), "<i2")
+    timing = np.zeros(3, iqr.TIMING_DTYPE)
+    timing["sample_index"] = [0, 2000, 4000]
+    timing["utc_us"] = [1000000, 1001000, 1002000]
+    timing["flags"] = [iqr.IQR_TIMING_GPS, iqr.IQR_TIMING_GPS | iqr.IQR_TIMING_PPS, 0]
+    crcs = np.array([0x12345678], "<u4")
+    path = tmp_path / "trailer.iqr"
+    write_iqr(path, iq, 2000000, timing=timing, crcs=crcs)
+
+    rec = iqr_read(path)
+    assert len(rec) == 5000
+    np.testing.assert_array_equal(rec.timing["sample_index"], timing["sample_index"])
+    np.testing.assert_array_equal(rec.timing["utc_us"], timing["utc_us"])
+    np.testing.assert_array_equal(rec.timing["flags"], timing["flags"])
+    np.testing.assert_array_equal(rec.crcs, crcs)
+
+
+def test_iqr_read_truncated(tmp_path):
+    iq = np.ones((1000, 2), "<i2")
+    path = tmp_path / "cut.iqr"
+    write_iqr(path, iq, 2000000, timing=np.zeros(1, iqr.TIMING_DTYPE))
+    with open(path, "r+b") as f:
+        f.truncate(iqr.IQR_HEADER_SIZE + 4 * 600 + 2)
+
+    rec = iqr_read(path)
+    assert len(rec) == 600
+    assert not rec.complete
+    assert len(rec.timing) == 0
+
+
+def test_iqr_read_rejects(tmp_path):
+    path = tmp_path / "bad.iqr"
+    path.write_bytes(b"RIFF" + bytes(60))
+    with pytest.raises(IqrError):
+        iqr_read(path)
+    path.write_bytes(b"IQR1")
+    with pytest.raises(IqrError):
+        iqr_read(path)
+
+
+# ============================================================================
+# Detectors
+# ============================================================================
+
+
+@pytest.fixture(scope="module")
+def detectors():
+    pytest.importorskip("cffi")
+    from phoenix_sdr import detectors as det
+    try:
+        det.library()
+    except OSError as e:
+        pytest.skip(str(e))
+    return det
+
+
+@pytest.fixture(scope="module")
+def iqr_detect():
+    exe = os.environ.get("PHOENIX_IQR_DETECT")
+    if not exe:
+        name = "iqr_detect.exe" if sys.platform == "win32" else "iqr_detect"
+        exe = os.path.join(ROOT, "bin", name)
+    if not os.path.exists(exe):
+        pytest.skip(f"{exe} not built")
+    return exe
+
+
+def tool_events(exe, path, tmp_path, chunk):
+    out = tmp_path / f"events_{chunk}.csv"
+    subprocess.run([exe, "-c", str(chunk), str(path), str(out)], check=True,
+                   stdout=subprocess.DEVNULL)
+    with open(out, newline="") as f:
+        return list(csv.DictReader(f))
+
+
+def assert_same_events(rows, events, name, event_names):
+    assert len(rows) == len(events), f"{name}: {len(rows)} events from iqr_detect, {len(events)} from Python"
+    for row, ev in zip(rows, events):
+        assert int(row["sample"]) == int(ev["sample"])
+        assert row["kind"] == event_names[ev["kind"]]
+        assert int(row["number"]) == int(ev["number"])
+        for field in FLOAT_FIELDS:
+            # %.9g reads back as the same float32; compare the bits
+            assert np.float32(row[field]).tobytes() == ev[field].tobytes(), \
+                f"{name} {field}: {row[field]} vs {ev[field]!r}"
+
+
+def golden_path(name):
+    return os.path.join(FIXTURES, f"wwv_{name}_events.csv")
+
+
+def golden_rows(events, event_names):
+    rows = []
+    for det, found in events.items():
+        for ev in found:
+            rows.append({"detector": det, "kind": event_names[ev["kind"]],
+                         "number": int(ev["number"]), "sample": int(ev["sample"]),
+                         "timestamp_ms": f"{float(ev['timestamp_ms']):.1f}",
+                         "duration_ms": f"{float(ev['duration_ms']):.1f}"})
+    return rows
+
+
+def write_golden(name, path, detectors):
+    events = detectors.run(iqr_read(path), pairs=65536)
+    with open(golden_path(name), "w", newline="") as f:
+        w = csv.DictWriter(f, ["detector", "kind", "number", "sample", "timestamp_ms", "duration_ms"],
+                           lineterminator="\n")
+        w.writeheader()
+        w.writerows(golden_rows(events, detectors.EVENT_NAMES))
+
+
+def test_marker_and_bcd_match_signal(recording, detectors):
+    path, _, widths = recording
+    events = detectors.run(iqr_read(path), pairs=65536)
+
+    # One minute marker, reported after the 800 ms tone and within a window of it
+    markers = events["marker"]
+    assert len(markers) == 1, f"{len(markers)} markers"
+    assert MARKER_SECOND * 1000 + 800 <= markers[0]["timestamp_ms"] <= MARKER_SECOND * 1000 + 2000
+
+    # Once the noise floor settles: one pulse per second, starting on the
+    # 30 ms BCD edge, with the width the generator chose for that second
+    pulses = [p for p in events["bcd_time"] if p["timestamp_ms"] >= 5000]
+    seconds = [int(p["timestamp_ms"] // 1000) for p in pulses]
+    assert seconds == sorted(set(seconds)), f"pulses in seconds {seconds}"
+    assert set(range(5, len(widths) - 1)) <= set(seconds), f"pulses in seconds {seconds}"
+    right = 0
+    for p, sec in zip(pulses, seconds):
+        assert abs(p["timestamp_ms"] - sec * 1000 - BCD_START_MS) <= 20, float(p["timestamp_ms"])
+        width = min(BCD_WIDTHS, key=lambda w: abs(w - float(p["duration_ms"])))
+        right += width == widths[sec]
+    # The marker second's pulse overlaps the marker tone; allow a miss
+    assert right >= 0.8 * len(pulses), f"{right}/{len(pulses)} pulse widths right"
+
+
+def test_events_match_golden(recording, detectors):
+    path, name, _ = recording
+    if not os.path.exists(golden_path(name)):
+        pytest.fail(f"{golden_path(name)} missing; run this file with --write-golden")
+    with open(golden_path(name), newline="") as f:
+        want = list(csv.DictReader(f))
+    got = golden_rows(detectors.run(iqr_read(path), pairs=65536), detectors.EVENT_NAMES)
+
+    assert [(r["detector"], r["kind"]) for r in got] == [(r["detector"], r["kind"]) for r in want]
+    for g, w in zip(got, want):
+        rate = detectors.DETECTOR_RATE
+        if g["detector"] in ("bcd_time", "bcd_freq"):
+            rate /= detectors.DATA_DECIMATION
+        where = f"{g['detector']} at {w['timestamp_ms']} ms"
+        assert int(g["number"]) == int(w["number"]), where
+        assert abs(int(g["sample"]) - int(w["sample"])) <= GOLDEN_TOL_MS * rate / 1000, where
+        for field in ("timestamp_ms", "duration_ms"):
+            assert abs(float(g[field]) - float(w[field])) <= GOLDEN_TOL_MS, f"{where}: {field}"
+
+
+def test_events_match_iqr_detect(recording, detectors, iqr_detect, tmp_path):
+    path = recording[0]
+    rows = tool_events(iqr_detect, path, tmp_path, 65536)
+    events = detectors.run(iqr_read(path), pairs=100003)
+
+    assert len(events["tick"]) > 0, "fixture should raise ticks"
+    for name, found in events.items():
+        assert_same_events([r for r in rows if r["detector"] == name], found, name, detectors.EVENT_NAMES)
+
+
+def test_block_size_does_not_matter(recording, detectors, iqr_detect, tmp_path):
+    path = recording[0]
+    rows = tool_events(iqr_detect, path, tmp_path, 777)
+    rec = iqr_read(path)
+
+    # Float input and a hand-driven pipeline with odd block sizes
+    fe = detectors.FrontEnd(int(rec.sample_rate))
+    tick = detectors.TickDetector()
+    bcd = detectors.BcdTimeDetector()
+    ticks, pulses = [], []
+    fed = 0
+    for block in rec.blocks(31337):
+        sync, data = fe.process(block.astype(np.float32) / 32768.0)
+        fed += len(sync)
+        for k in range(0, len(sync), 5000):
+            ticks.append(tick.process(sync[k:k + 5000]))
+        pulses.append(bcd.process(data))
+
+    assert_same_events([r for r in rows if r["detector"] == "tick"], np.concatenate(ticks),
+                       "tick", detectors.EVENT_NAMES)
+    assert_same_events([r for r in rows if r["detector"] == "bcd_time"], np.concatenate(pulses),
+                       "bcd_time", detectors.EVENT_NAMES)
+    assert tick.samples == fed
+
+
+def test_rates_refused(detectors):
+    with pytest.raises(ValueError):
+        detectors.FrontEnd(48000)
+    with pytest.raises(ValueError):
+        detectors.MarkerDetector(48000)
+    assert detectors.TickDetector(48000).sample_rate == 48000.0
+    assert detectors.BcdFreqDetector().sample_rate == detectors.DETECTOR_RATE / detectors.DATA_DECIMATION
+
+
+if __name__ == "__main__" and "--write-golden" in sys.argv:
+    import tempfile
+    from phoenix_sdr import detectors as det
+    os.makedirs(FIXTURES, exist_ok=True)
+    with tempfile.TemporaryDirectory() as tmp:
+        for name in sorted(RECORDINGS):
+            write_recording(os.path.join(tmp, f"wwv_{name}.iqr"), name)
+            write_golden(name, os.path.join(tmp, f"wwv_{name}.iqr"), det)
+            print(golden_path(name))
@@ -0,0 +1,289 @@
+/**
+ * @file test_relay_mcast.c
+ * @brief Unit tests for relay_mcast module
+ *
+ * Packets are captured from the sender and fed to the receiver with
+ * scripted loss, reordering and duplication:
+ * - Clean round trip, frames split across datagrams
+ * - One loss per parity group repaired, two zero-filled in place
+ * - Whole frame lost, reordered and duplicated packets, mid-frame join
+ * - Loopback multicast end to end through iq_client
+ */
+
+#include "test_framework.h"
+#include "relay_mcast.h"
+#include "iq_client.h"
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+#define MAX_PACKETS     4096
+#define FRAME_SAMPLES   2048            /* signal_splitter RELAY_FRAME_SIZE */
+#define RATE            50000
+
+typedef struct {
+    uint8_t data[RELAY_MCAST_DATAGRAM];
+    size_t len;
+} packet_t;
+
+static packet_t g_packets[MAX_PACKETS];
+static int g_count;
+
+static void capture(const uint8_t *packet, size_t len, void *user_data) {
+    (void)user_data;
+    if (g_count >= MAX_PACKETS) return;
+    memcpy(g_packets[g_count].data, packet, len);
+    g_packets[g_count].len = len;
+    g_count++;
+}
+
+static uint8_t packet_type(int i) {
+    relay_mcast_header_t h;
+    memcpy(&h, g_packets[i].data, sizeof(h));
+    return h.type;
+}
+
+static float sample_value(uint32_t frame, uint32_t k) {
+    return (float)(frame * 10000 + k) + 0.5f;
+}
+
+/* Packetize frames first..first+n-1 into g_packets */
+static void make_frames(int fec, uint32_t first, int n) {
+    static float iq[FRAME_SAMPLES * 2];
+    relay_mcast_tx_t *tx = relay_mcast_tx_create(RATE, fec, capture, NULL);
+    g_count = 0;
+    for (int f = 0; f < n; f++) {
+        for (uint32_t k = 0; k < FRAME_SAMPLES * 2; k++) iq[k] = sample_value(first + f, k);
+        relay_mcast_tx_frame(tx, first + f, iq, FRAME_SAMPLES);
+    }
+    relay_mcast_tx_destroy(tx);
+}
+
+typedef struct {
+    int frames;
+    int bad_samples;                    /* Neither the sent value nor a zero-filled hole */
+    int zeros;                          /* Zero-filled pairs */
+    uint32_t lost;                      /* Sum of samples_lost */
+    uint32_t seq[64];
+} result_t;
+
+static void drain(relay_mcast_rx_t *rx, result_t *r) {
+    relay_mcast_frame_t f;
+    while (relay_mcast_rx_pop(rx, &f)) {
+        if (r->frames < 64) r->seq[r->frames] = f.frame_seq;
+        r->frames++;
+        r->lost += f.samples_lost;
+        for (uint32_t k = 0; k < f.num_samples * 2; k += 2) {
+            if (f.iq[k] == 0.0f && f.iq[k + 1] == 0.0f) r->zeros++;
+            else if (f.iq[k] != sample_value(f.frame_seq, k)) r->bad_samples++;
+        }
+    }
+}
+
+/* Feed all captured packets except those in drop[] */
+static void feed(relay_mcast_rx_t *rx, const int *drop, int n_drop, result_t *r) {
+    for (int i = 0; i < g_count; i++) {
+        bool skip = false;
+        for (int d = 0; d < n_drop; d++) if (drop[d] == i) skip = true;
+        if (skip) continue;
+        relay_mcast_rx_push(rx, g_packets[i].data, g_packets[i].len);
+        drain(rx, r);
+    }
+}
+
+/* Index of the n-th DATA packet in g_packets */
+static int data_index(int n) {
+    for (int i = 0; i < g_count; i++) {
+        if (packet_type(i) == RELAY_MCAST_DATA && n-- == 0) return i;
+    }
+    return -1;
+}
+
+/*============================================================================
+ * Transport Tests
+ *============================================================================*/
+
+TEST(round_trip) {
+    make_frames(RELAY_MCAST_FEC_GROUP, 100, 4);
+    int per_frame = (FRAME_SAMPLES + RELAY_MCAST_PAIRS_PER_PACKET - 1) / RELAY_MCAST_PAIRS_PER_PACKET;
+    ASSERT_EQ(g_count, 4 * per_frame + (4 * per_frame) / RELAY_MCAST_FEC_GROUP, "data + parity packets");
+    for (int i = 0; i < g_count; i++) {
+        ASSERT_TRUE(g_packets[i].len <= RELAY_MCAST_DATAGRAM, "fits one datagram");
+    }
+
+    relay_mcast_rx_t *rx = relay_mcast_rx_create();
+    result_t r = { 0 };
+    feed(rx, NULL, 0, &r);
+    ASSERT_EQ(r.frames, 4, "all frames out");
+    ASSERT_EQ(r.seq[0], 100, "first frame");
+    ASSERT_EQ(r.seq[3], 103, "in order");
+    ASSERT_EQ(r.bad_samples, 0, "samples intact");
+    ASSERT_EQ(r.lost, 0, "nothing lost");
+    ASSERT_EQ(relay_mcast_rx_sample_rate(rx), RATE, "rate from header");
+    relay_mcast_rx_destroy(rx);
+    PASS();
+}
+
+TEST(parity_repairs_single_loss) {
+    make_frames(RELAY_MCAST_FEC_GROUP, 0, 6);
+
+    /* One loss in each of the first five groups; DATA 11 is the last of frame 0 */
+    int drop[5] = { data_index(1), data_index(11), data_index(18), data_index(28), data_index(37) };
+
+    relay_mcast_rx_t *rx = relay_mcast_rx_create();
+    result_t r = { 0 };
+    feed(rx, drop, 5, &r);
+    relay_mcast_rx_stats_t st;
+    relay_mcast_rx_get_stats(rx, &st);
+    ASSERT_EQ(st.recovered, 5, "every loss rebuilt");
+    ASSERT_EQ(r.frames, 6, "all frames out");
+    ASSERT_EQ(r.zeros, 0, "no holes");
+    ASSERT_EQ(r.bad_samples, 0, "rebuilt samples exact");
+    relay_mcast_rx_destroy(rx);
+    PASS();
+}
+
+TEST(double_loss_zero_filled) {
+    make_frames(RELAY_MCAST_FEC_GROUP, 0, 4);
+    int drop[2] = { data_index(1), data_index(2) };     /* Same group, frame 0 */
+
+    relay_mcast_rx_t *rx = relay_mcast_rx_create();
+    result_t r = { 0 };
+    feed(rx, drop, 2, &r);
+    ASSERT_EQ(r.frames, 4, "frame released despite the hole");
+    ASSERT_EQ(r.lost, 2 * RELAY_MCAST_PAIRS_PER_PACKET, "two packets of samples lost");
+    ASSERT_EQ(r.zeros, 2 * RELAY_MCAST_PAIRS_PER_PACKET, "zero-filled in place");
+    ASSERT_EQ(r.bad_samples, 0, "samples after the hole not shifted");
+    relay_mcast_rx_destroy(rx);
+    PASS();
+}
+
+TEST(whole_frame_lost) {
+    make_frames(0, 0, 5);               /* No FEC */
+    int per_frame = (FRAME_SAMPLES + RELAY_MCAST_PAIRS_PER_PACKET - 1) / RELAY_MCAST_PAIRS_PER_PACKET;
+    int drop[32];
+    for (int i = 0; i < per_frame; i++) drop[i] = data_index(per_frame * 2 + i);
+
+    relay_mcast_rx_t *rx = relay_mcast_rx_create();
+    result_t r = { 0 };
+    feed(rx, drop, per_frame, &r);
+    ASSERT_EQ(r.frames, 4, "remaining frames out");
+    ASSERT_EQ(r.seq[1], 1, "before the gap");
+    ASSERT_EQ(r.seq[2], 3, "gap skipped");
+    ASSERT_EQ(r.bad_samples + r.zeros, 0, "frames whole");
+    relay_mcast_rx_destroy(rx);
+    PASS();
+}
+
+TEST(reorder_and_duplicates) {
+    make_frames(RELAY_MCAST_FEC_GROUP, 0, 4);
+
+    /* Swap neighbours and repeat every fifth packet */
+    relay_mcast_rx_t *rx = relay_mcast_rx_create();
+    result_t r = { 0 };
+    for (int i = 0; i + 1 < g_count; i += 2) {
+        relay_mcast_rx_push(rx, g_packets[i + 1].data, g_packets[i + 1].len);
+        relay_mcast_rx_push(rx, g_packets[i].data, g_packets[i].len);
+        if (i % 5 == 0) relay_mcast_rx_push(rx, g_packets[i].data, g_packets[i].len);
+        drain(rx, &r);
+    }
+    if (g_count % 2) relay_mcast_rx_push(rx, g_packets[g_count - 1].data, g_packets[g_count - 1].len);
+    drain(rx, &r);
+
+    relay_mcast_rx_stats_t st;
+    relay_mcast_rx_get_stats(rx, &st);
+    ASSERT_GT(st.duplicates, 0, "duplicates seen");
+    ASSERT_EQ(r.frames, 4, "all frames out");
+    ASSERT_EQ(r.bad_samples + r.zeros, 0, "duplicates not applied twice");
+    relay_mcast_rx_destroy(rx);
+    PASS();
+}
+
+TEST(join_mid_frame) {
+    make_frames(RELAY_MCAST_FEC_GROUP, 7, 3);
+
+    relay_mcast_rx_t *rx = relay_mcast_rx_create();
+    result_t r = { 0 };
+    for (int i = data_index(5); i < g_count; i++) {
+        relay_mcast_rx_push(rx, g_packets[i].data, g_packets[i].len);
+        drain(rx, &r);
+    }
+    ASSERT_EQ(r.frames, 2, "partial first frame skipped");
+    ASSERT_EQ(r.seq[0], 8, "starts at the next frame");
+    ASSERT_EQ(r.bad_samples + r.zeros, 0, "frames whole");
+    relay_mcast_rx_destroy(rx);
+    PASS();
+}
+
+/*============================================================================
+ * Loopback Multicast
+ *============================================================================*/
+
+TEST(loopback_through_iq_client) {
+    const int port = RELAY_MCAST_PORT + 100;
+    iq_client_t *c = iq_client_create_mcast(RELAY_MCAST_GROUP, port, "127.0.0.1");
+    relay_mcast_tx_t *tx = relay_mcast_tx_open(RELAY_MCAST_GROUP, port, "127.0.0.1",
+                                               RELAY_MCAST_TTL, RATE, RELAY_MCAST_FEC_GROUP);
+    ASSERT_NOT_NULL(c, "client");
+    if (!tx) {
+        iq_client_destroy(c);
+        SKIP("no multicast on loopback");
+    }
+
+    /* First call joins the group */
+    iq_client_frame_t f;
+    iq_client_next(c, &f, 10);
+
+    static float iq[FRAME_SAMPLES * 2];
+    relay_mcast_tx_beacon(tx);
+    for (uint32_t seq = 0; seq < 8; seq++) {
+        for (uint32_t k = 0; k < FRAME_SAMPLES * 2; k++) iq[k] = sample_value(seq, k);
+        relay_mcast_tx_frame(tx, seq, iq, FRAME_SAMPLES);
+    }
+
+    int connected = 0, frames = 0, bad = 0;
+    for (int tries = 0; tries < 40 && frames < 8; tries++) {
+        iq_client_status_t st = iq_client_next(c, &f, 50);
+        if (st == IQ_CLIENT_CONNECTED) connected++;
+        if (st == IQ_CLIENT_FRAME) {
+            const float *s = (const float *)f.samples;
+            if (f.sequence != (uint32_t)frames || s[FRAME_SAMPLES] != sample_value(f.sequence, FRAME_SAMPLES)) bad++;
+            frames++;
+        }
+    }
+    relay_mcast_tx_destroy(tx);
+
+    if (connected == 0) {
+        iq_client_destroy(c);
+        SKIP("multicast loopback not delivered");
+    }
+    ASSERT_EQ(iq_client_stream(c)->sample_rate, RATE, "rate");
+    ASSERT_EQ(iq_client_stream(c)->proto, IQ_CLIENT_PROTO_FT32, "FT32 stream");
+    ASSERT_EQ(frames, 8, "all frames");
+    ASSERT_EQ(bad, 0, "in order and intact");
+    iq_client_destroy(c);
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Relay Multicast Tests");
+
+    TEST_SECTION("Transport");
+    RUN_TEST(round_trip);
+    RUN_TEST(parity_repairs_single_loss);
+    RUN_TEST(double_loss_zero_filled);
+    RUN_TEST(whole_frame_lost);
+    RUN_TEST(reorder_and_duplicates);
+    RUN_TEST(join_mid_frame);
+
+    TEST_SECTION("Loopback");
+    RUN_TEST(loopback_through_iq_client);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
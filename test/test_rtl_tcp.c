@@ -0,0 +1,206 @@
+/**
+ * @file test_rtl_tcp.c
+ * @brief Unit tests for rtl_tcp protocol support
+ *
+ * - Dongle info header layout
+ * - Command packet mapping onto the text control protocol
+ * - Gain mapping (tuner gain -> IF gain reduction)
+ * - Vectorized S16 -> U8 conversion matches the scalar reference
+ */
+
+#include "test_framework.h"
+#include "rtl_tcp.h"
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+static void make_packet(uint8_t pkt[RTL_TCP_CMD_SIZE], uint8_t cmd, uint32_t param) {
+    pkt[0] = cmd;
+    pkt[1] = (uint8_t)(param >> 24);
+    pkt[2] = (uint8_t)(param >> 16);
+    pkt[3] = (uint8_t)(param >> 8);
+    pkt[4] = (uint8_t)param;
+}
+
+/*============================================================================
+ * Protocol Tests
+ *============================================================================*/
+
+TEST(rtl_header_layout) {
+    uint8_t hdr[RTL_TCP_HEADER_SIZE];
+    rtl_tcp_build_header(hdr);
+    ASSERT_TRUE(memcmp(hdr, "RTL0", 4) == 0, "magic is RTL0");
+    ASSERT_EQ(hdr[7], RTL_TCP_TUNER_R820T, "tuner type big-endian");
+    ASSERT_EQ(hdr[4] | hdr[5] | hdr[6], 0, "tuner type high bytes zero");
+    ASSERT_EQ(hdr[11], RTL_TCP_GAIN_COUNT, "gain count big-endian");
+    PASS();
+}
+
+TEST(rtl_map_freq) {
+    uint8_t pkt[RTL_TCP_CMD_SIZE];
+    tcp_command_t cmd;
+    make_packet(pkt, RTL_CMD_SET_FREQ, 10000000);
+    ASSERT_EQ(rtl_tcp_map_command(pkt, &cmd), TCP_OK, "freq maps");
+    ASSERT_EQ(cmd.type, CMD_SET_FREQ, "SET_FREQ");
+    ASSERT_FLOAT_EQ(cmd.value.freq_hz, 10000000.0, 0.5, "frequency value");
+    PASS();
+}
+
+TEST(rtl_map_sample_rate) {
+    uint8_t pkt[RTL_TCP_CMD_SIZE];
+    tcp_command_t cmd;
+    make_packet(pkt, RTL_CMD_SET_SAMPLE_RATE, 2048000);
+    ASSERT_EQ(rtl_tcp_map_command(pkt, &cmd), TCP_OK, "rate maps");
+    ASSERT_EQ(cmd.type, CMD_SET_SRATE, "SET_SRATE");
+    ASSERT_EQ(cmd.value.sample_rate, 2048000, "rate value");
+
+    /* Typical RTL-only rate is below the RSP minimum */
+    make_packet(pkt, RTL_CMD_SET_SAMPLE_RATE, 1024000);
+    ASSERT_EQ(rtl_tcp_map_command(pkt, &cmd), TCP_ERR_RANGE, "1.024 MSPS out of range");
+    PASS();
+}
+
+TEST(rtl_map_gain_mode) {
+    uint8_t pkt[RTL_TCP_CMD_SIZE];
+    tcp_command_t cmd;
+    make_packet(pkt, RTL_CMD_SET_GAIN_MODE, 0);
+    ASSERT_EQ(rtl_tcp_map_command(pkt, &cmd), TCP_OK, "auto maps");
+    ASSERT_EQ(cmd.type, CMD_SET_AGC, "SET_AGC");
+    ASSERT_STR_EQ(cmd.value.agc.mode, "50HZ", "auto -> AGC on");
+
+    make_packet(pkt, RTL_CMD_SET_GAIN_MODE, 1);
+    ASSERT_EQ(rtl_tcp_map_command(pkt, &cmd), TCP_OK, "manual maps");
+    ASSERT_STR_EQ(cmd.value.agc.mode, "OFF", "manual -> AGC off");
+    PASS();
+}
+
+TEST(rtl_map_gain) {
+    uint8_t pkt[RTL_TCP_CMD_SIZE];
+    tcp_command_t cmd;
+    make_packet(pkt, RTL_CMD_SET_GAIN, 496);
+    ASSERT_EQ(rtl_tcp_map_command(pkt, &cmd), TCP_OK, "gain maps");
+    ASSERT_EQ(cmd.type, CMD_SET_GAIN, "SET_GAIN");
+    ASSERT_EQ(cmd.value.gain_db, 20, "max gain -> min reduction");
+
+    make_packet(pkt, RTL_CMD_SET_GAIN_BY_INDEX, 0);
+    ASSERT_EQ(rtl_tcp_map_command(pkt, &cmd), TCP_OK, "index maps");
+    ASSERT_EQ(cmd.value.gain_db, 59, "index 0 -> max reduction");
+
+    make_packet(pkt, RTL_CMD_SET_GAIN_BY_INDEX, RTL_TCP_GAIN_COUNT);
+    ASSERT_EQ(rtl_tcp_map_command(pkt, &cmd), TCP_ERR_RANGE, "index past table");
+    PASS();
+}
+
+TEST(rtl_gain_monotonic) {
+    int prev = rtl_tcp_gain_to_reduction(0);
+    ASSERT_EQ(prev, 59, "0 dB -> 59");
+    for (int g = 1; g <= 496; g++) {
+        int gr = rtl_tcp_gain_to_reduction(g);
+        ASSERT_TRUE(gr <= prev, "more gain never increases reduction");
+        ASSERT_TRUE(gr >= 20 && gr <= 59, "reduction stays in range");
+        prev = gr;
+    }
+    ASSERT_EQ(rtl_tcp_gain_to_reduction(-10), 59, "negative clamps");
+    ASSERT_EQ(rtl_tcp_gain_to_reduction(9999), 20, "overrange clamps");
+    PASS();
+}
+
+TEST(rtl_map_bias_tee) {
+    uint8_t pkt[RTL_TCP_CMD_SIZE];
+    tcp_command_t cmd;
+    make_packet(pkt, RTL_CMD_SET_BIAS_TEE, 1);
+    ASSERT_EQ(rtl_tcp_map_command(pkt, &cmd), TCP_OK, "bias on maps");
+    ASSERT_EQ(cmd.type, CMD_SET_BIAST, "SET_BIAST");
+    ASSERT_TRUE(cmd.value.on_off, "bias on");
+
+    make_packet(pkt, RTL_CMD_SET_BIAS_TEE, 0);
+    ASSERT_EQ(rtl_tcp_map_command(pkt, &cmd), TCP_OK, "bias off maps");
+    ASSERT_FALSE(cmd.value.on_off, "bias off");
+    PASS();
+}
+
+TEST(rtl_map_unsupported) {
+    uint8_t pkt[RTL_TCP_CMD_SIZE];
+    tcp_command_t cmd;
+    make_packet(pkt, RTL_CMD_SET_FREQ_CORRECTION, 5);
+    ASSERT_EQ(rtl_tcp_map_command(pkt, &cmd), TCP_ERR_UNKNOWN, "ppm unsupported");
+    make_packet(pkt, RTL_CMD_SET_DIRECT_SAMPLING, 1);
+    ASSERT_EQ(rtl_tcp_map_command(pkt, &cmd), TCP_ERR_UNKNOWN, "direct sampling unsupported");
+    make_packet(pkt, 0x7F, 0);
+    ASSERT_EQ(rtl_tcp_map_command(pkt, &cmd), TCP_ERR_UNKNOWN, "unknown command");
+    ASSERT_EQ(rtl_tcp_map_command(NULL, &cmd), TCP_ERR_SYNTAX, "NULL packet");
+    PASS();
+}
+
+/*============================================================================
+ * Conversion Tests
+ *============================================================================*/
+
+TEST(rtl_convert_known_values) {
+    int16_t xi[4] = { 0, 32767, -32768, 256 };
+    int16_t xq[4] = { -1, 127, 128, -256 };
+    uint8_t out[8];
+    rtl_tcp_convert_s16_u8_scalar(xi, xq, out, 4);
+    ASSERT_EQ(out[0], 128, "0 -> 128");
+    ASSERT_EQ(out[1], 128, "-1 rounds to 128");
+    ASSERT_EQ(out[2], 255, "full scale positive");
+    ASSERT_EQ(out[3], 128, "127 rounds down");
+    ASSERT_EQ(out[4], 0, "full scale negative");
+    ASSERT_EQ(out[5], 129, "128 rounds up");
+    ASSERT_EQ(out[6], 129, "+1 LSB");
+    ASSERT_EQ(out[7], 127, "-1 LSB");
+    PASS();
+}
+
+TEST(rtl_convert_simd_matches_scalar) {
+    /* Every int16 value in I, reversed in Q, odd length to hit the tail */
+    const size_t count = 65536 + 7;
+    int16_t *xi = (int16_t *)malloc(count * sizeof(int16_t));
+    int16_t *xq = (int16_t *)malloc(count * sizeof(int16_t));
+    uint8_t *ref = (uint8_t *)malloc(count * 2);
+    uint8_t *out = (uint8_t *)malloc(count * 2);
+    ASSERT_TRUE(xi && xq && ref && out, "allocation");
+
+    for (size_t n = 0; n < count; n++) {
+        xi[n] = (int16_t)(n - 32768);
+        xq[n] = (int16_t)(32767 - (int)(n & 0xFFFF));
+    }
+
+    rtl_tcp_convert_s16_u8_scalar(xi, xq, ref, count);
+    rtl_tcp_convert_s16_u8(xi, xq, out, count);
+
+    size_t mismatch = 0;
+    for (size_t n = 0; n < count * 2; n++) {
+        if (ref[n] != out[n]) mismatch++;
+    }
+
+    free(xi); free(xq); free(ref); free(out);
+    ASSERT_EQ(mismatch, 0, "vector path matches scalar reference");
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("rtl_tcp Protocol Tests");
+
+    TEST_SECTION("Protocol");
+    RUN_TEST(rtl_header_layout);
+    RUN_TEST(rtl_map_freq);
+    RUN_TEST(rtl_map_sample_rate);
+    RUN_TEST(rtl_map_gain_mode);
+    RUN_TEST(rtl_map_gain);
+    RUN_TEST(rtl_gain_monotonic);
+    RUN_TEST(rtl_map_bias_tee);
+    RUN_TEST(rtl_map_unsupported);
+
+    TEST_SECTION("Conversion");
+    RUN_TEST(rtl_convert_known_values);
+    RUN_TEST(rtl_convert_simd_matches_scalar);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
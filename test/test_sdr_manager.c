@@ -0,0 +1,425 @@
+/**
+ * @file test_sdr_manager.c
+ * @brief Unit tests for sdr_manager module
+ *
+ * Several tone and replay devices open at once (no hardware; the psdr_*
+ * stubs report none):
+ * - Each device streams on its own thread, decimated tone at its own offset
+ * - DEV-addressed commands reach one device only; DEVICES and INFO
+ * - Replay delivers the file's samples in order and loops
+ * - Raw S16 and 48 kHz F32 PHXI ports per device, META on retune
+ * - A client that stops reading is dropped; the device keeps streaming
+ * - No RSPs: hardware devices are refused cleanly
+ */
+
+#include "test_framework.h"
+#include "sdr_manager.h"
+#include "iq_recorder.h"
+#include "iq_client.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#define sleep_ms(ms) Sleep(ms)
+#else
+#include <unistd.h>
+#define sleep_ms(ms) usleep((ms) * 1000)
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define REPLAY_FILE     "test_sdr_manager.iqr"
+#define REPLAY_PAIRS    10000
+#define KEEP_PAIRS      25000
+#define WAIT_MS         10000
+
+/*============================================================================
+ * Sink
+ *============================================================================*/
+
+typedef struct {
+    pthread_t thread;
+    atomic_int calls;
+    atomic_uint_fast64_t raw;
+    atomic_uint_fast64_t decim;
+    int16_t first_i[KEEP_PAIRS];        /* Raw samples as delivered */
+    int16_t first_q[KEEP_PAIRS];
+    double prev_i, prev_q;              /* Lag-1 product for the tone frequency */
+    double acc_re, acc_im;
+} sink_t;
+
+static void sink_fn(int device, const int16_t *xi, const int16_t *xq, uint32_t count,
+                    const decim_complex_t *decim, size_t n_decim, void *user) {
+    sink_t *s = (sink_t*)user;
+    (void)device;
+
+    if (atomic_fetch_add(&s->calls, 1) == 0) s->thread = pthread_self();
+
+    uint64_t raw = atomic_load(&s->raw);
+    for (uint32_t i = 0; i < count && raw + i < KEEP_PAIRS; i++) {
+        s->first_i[raw + i] = xi[i];
+        s->first_q[raw + i] = xq[i];
+    }
+    atomic_fetch_add(&s->raw, count);
+
+    /* Skip the filter warmup */
+    uint64_t done = atomic_load(&s->decim);
+    for (size_t k = 0; k < n_decim; k++) {
+        if (done + k > 200) {
+            s->acc_re += decim[k].i * s->prev_i + decim[k].q * s->prev_q;
+            s->acc_im += decim[k].q * s->prev_i - decim[k].i * s->prev_q;
+        }
+        s->prev_i = decim[k].i;
+        s->prev_q = decim[k].q;
+    }
+    atomic_fetch_add(&s->decim, n_decim);
+}
+
+static double sink_tone_hz(const sink_t *s) {
+    return atan2(s->acc_im, s->acc_re) * SDR_MANAGER_DECIM_RATE / (2.0 * M_PI);
+}
+
+static bool wait_decim(sink_t *s, uint64_t n) {
+    for (int t = 0; t < WAIT_MS && atomic_load(&s->decim) < n; t += 5) sleep_ms(5);
+    return atomic_load(&s->decim) >= n;
+}
+
+static bool wait_raw(sink_t *s, uint64_t n) {
+    for (int t = 0; t < WAIT_MS && atomic_load(&s->raw) < n; t += 5) sleep_ms(5);
+    return atomic_load(&s->raw) >= n;
+}
+
+static tcp_response_t run(sdr_manager_t *m, const char *line) {
+    tcp_response_t resp;
+    memset(&resp, 0, sizeof(resp));
+    sdr_manager_execute(m, line, &resp);
+    return resp;
+}
+
+static int add_tone(sdr_manager_t *m, double tone_hz, sink_t *sink) {
+    sdr_device_spec_t spec;
+    sdr_manager_spec_defaults(&spec, SDR_BACKEND_TONE);
+    spec.tone_hz = tone_hz;
+    spec.paced = false;
+    spec.sink = sink_fn;
+    spec.sink_user = sink;
+    return sdr_manager_add(m, &spec);
+}
+
+static sink_t g_sinks[3];
+
+static void reset_sinks(void) {
+    memset(g_sinks, 0, sizeof(g_sinks));
+}
+
+/*============================================================================
+ * Devices
+ *============================================================================*/
+
+TEST(tones_on_own_threads) {
+    static const double tones[3] = { 1000.0, 2500.0, -4000.0 };
+    reset_sinks();
+    sdr_manager_t *m = sdr_manager_create();
+    ASSERT_NOT_NULL(m, "create");
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(add_tone(m, tones[i], &g_sinks[i]), i, "device number");
+    }
+    ASSERT_EQ(sdr_manager_count(m), 3, "three devices");
+
+    for (int i = 0; i < 3; i++) {
+        char line[32];
+        snprintf(line, sizeof(line), "DEV %d START", i);
+        ASSERT_STR_EQ(run(m, line).message, "OK", "start");
+    }
+    for (int i = 0; i < 3; i++) {
+        ASSERT(wait_decim(&g_sinks[i], 48000), "a second of decimated output");
+    }
+    sdr_manager_stop_all(m);
+
+    sdr_device_stats_t st;
+    ASSERT(sdr_manager_get_stats(m, 2, &st), "stats");
+    ASSERT(!st.streaming, "stopped");
+    ASSERT_EQ(st.backend, SDR_BACKEND_TONE, "backend");
+    ASSERT_GT(st.samples, 2000000, "2 MSPS in");
+    ASSERT_FLOAT_EQ((double)st.decim_samples / (double)st.samples, 0.024, 0.0005, "2M -> 48k");
+    sdr_manager_destroy(m);
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT(!pthread_equal(g_sinks[i].thread, pthread_self()), "not the caller's thread");
+        for (int j = 0; j < i; j++) {
+            ASSERT(!pthread_equal(g_sinks[i].thread, g_sinks[j].thread), "one thread per device");
+        }
+        ASSERT_FLOAT_EQ(sink_tone_hz(&g_sinks[i]), tones[i], 2.0, "tone through the decimator");
+    }
+    PASS();
+}
+
+TEST(commands_addressed_by_device) {
+    reset_sinks();
+    sdr_manager_t *m = sdr_manager_create();
+    for (int i = 0; i < 3; i++) add_tone(m, 1000.0, &g_sinks[i]);
+
+    ASSERT_STR_EQ(run(m, "DEVICES").message, "OK COUNT=3 BACKENDS=TONE,TONE,TONE", "devices");
+    ASSERT_STR_EQ(run(m, "dev 1 set_freq 5000000").message, "OK", "retune device 1");
+    ASSERT_STR_CONTAINS(run(m, "DEV 1 GET_FREQ").message, "5000000", "device 1 retuned");
+    ASSERT_STR_CONTAINS(run(m, "DEV 0 GET_FREQ").message, "15000000", "device 0 untouched");
+    ASSERT_STR_CONTAINS(run(m, "GET_FREQ").message, "15000000", "no prefix: device 0");
+    ASSERT_STR_CONTAINS(run(m, "DEV 1 INFO").message, "BACKEND=TONE STREAMING=0", "info");
+
+    ASSERT_STR_CONTAINS(run(m, "DEV 3 PING").message, "ERR PARAM", "no device 3");
+    ASSERT_STR_CONTAINS(run(m, "DEV -1 PING").message, "ERR PARAM", "negative");
+    ASSERT_STR_CONTAINS(run(m, "DEV x PING").message, "ERR SYNTAX", "not a number");
+    ASSERT_STR_CONTAINS(run(m, "DEV 1").message, "ERR SYNTAX", "no command");
+    ASSERT_STR_CONTAINS(run(m, "DEV 1 FROB").message, "ERR UNKNOWN", "unknown command");
+    ASSERT_STR_CONTAINS(run(m, "DEV 1 SET_GAIN 99").message, "ERR RANGE", "range checked");
+
+    tcp_response_t resp;
+    ASSERT_EQ(sdr_manager_execute(m, "DEV 2 QUIT", &resp), CMD_QUIT, "QUIT reported");
+
+    /* Only device 1 streams */
+    ASSERT_STR_EQ(run(m, "DEV 1 START").message, "OK", "start 1");
+    ASSERT_STR_CONTAINS(run(m, "DEV 1 START").message, "ERR STATE", "already streaming");
+    ASSERT(wait_raw(&g_sinks[1], 100000), "device 1 streams");
+    ASSERT_STR_CONTAINS(run(m, "DEV 1 STATUS").message, "STREAMING=1", "status 1");
+    ASSERT_STR_CONTAINS(run(m, "STATUS").message, "STREAMING=0", "status 0");
+    sdr_manager_destroy(m);
+
+    ASSERT_EQ(atomic_load(&g_sinks[0].raw), 0, "device 0 idle");
+    ASSERT_EQ(atomic_load(&g_sinks[2].raw), 0, "device 2 idle");
+    PASS();
+}
+
+TEST(replay_delivers_file_in_order) {
+    static int16_t xi[REPLAY_PAIRS], xq[REPLAY_PAIRS];
+    for (int k = 0; k < REPLAY_PAIRS; k++) {
+        xi[k] = (int16_t)k;
+        xq[k] = (int16_t)-k;
+    }
+    iqr_recorder_t *rec = NULL;
+    ASSERT_EQ(iqr_create(&rec, 0), IQR_OK, "recorder");
+    ASSERT_EQ(iqr_start(rec, REPLAY_FILE, 2000000.0, 10000000.0, 200, 30, 2), IQR_OK, "record");
+    iqr_write(rec, xi, xq, REPLAY_PAIRS);
+    iqr_stop(rec);
+    iqr_destroy(rec);
+
+    /* Two replays of the same file and a tone, all at once */
+    reset_sinks();
+    sdr_manager_t *m = sdr_manager_create();
+    sdr_device_spec_t spec;
+    sdr_manager_spec_defaults(&spec, SDR_BACKEND_REPLAY);
+    snprintf(spec.replay_path, sizeof(spec.replay_path), "%s", REPLAY_FILE);
+    spec.paced = false;
+    spec.sink = sink_fn;
+    for (int i = 0; i < 2; i++) {
+        spec.sink_user = &g_sinks[i];
+        ASSERT_EQ(sdr_manager_add(m, &spec), i, "replay device");
+    }
+    ASSERT_EQ(add_tone(m, 1000.0, &g_sinks[2]), 2, "tone device");
+
+    ASSERT_STR_EQ(run(m, "DEVICES").message, "OK COUNT=3 BACKENDS=REPLAY,REPLAY,TONE", "devices");
+    ASSERT_STR_CONTAINS(run(m, "DEV 0 GET_FREQ").message, "10000000", "file frequency");
+    ASSERT_STR_CONTAINS(run(m, "DEV 0 GET_GAIN").message, "30", "file gain");
+    ASSERT_STR_CONTAINS(run(m, "DEV 0 SET_SRATE 4000000").message, "ERR STATE", "file rate fixed");
+
+    for (int i = 0; i < 3; i++) {
+        char line[32];
+        snprintf(line, sizeof(line), "DEV %d START", i);
+        run(m, line);
+    }
+    for (int i = 0; i < 3; i++) {
+        ASSERT(wait_raw(&g_sinks[i], KEEP_PAIRS), "streamed");
+    }
+
+    sdr_device_stats_t st;
+    sdr_manager_get_stats(m, 1, &st);
+    ASSERT_GT(st.replay_loops, 1, "looped");
+    ASSERT_EQ(st.sample_rate, 2000000, "file rate");
+    sdr_manager_destroy(m);
+
+    for (int i = 0; i < 2; i++) {
+        for (int k = 0; k < KEEP_PAIRS; k++) {
+            ASSERT_EQ(g_sinks[i].first_i[k], xi[k % REPLAY_PAIRS], "I in order");
+            ASSERT_EQ(g_sinks[i].first_q[k], xq[k % REPLAY_PAIRS], "Q in order");
+        }
+        ASSERT_GT(atomic_load(&g_sinks[i].decim), 0, "decimated");
+    }
+    remove(REPLAY_FILE);
+    PASS();
+}
+
+TEST(replay_missing_file_refused) {
+    sdr_manager_t *m = sdr_manager_create();
+    sdr_device_spec_t spec;
+    sdr_manager_spec_defaults(&spec, SDR_BACKEND_REPLAY);
+    snprintf(spec.replay_path, sizeof(spec.replay_path), "no_such_file.iqr");
+    ASSERT_EQ(sdr_manager_add(m, &spec), -1, "refused");
+    ASSERT_EQ(sdr_manager_count(m), 0, "not added");
+    sdr_manager_destroy(m);
+    PASS();
+}
+
+/*============================================================================
+ * Ports
+ *============================================================================*/
+
+/* Next data frame, or META; false on timeout */
+static bool next_frame(iq_client_t *c, iq_client_frame_t *f, iq_client_status_t *st) {
+    for (int t = 0; t < 200; t++) {
+        *st = iq_client_next(c, f, 50);
+        if (*st == IQ_CLIENT_FRAME || *st == IQ_CLIENT_META) return true;
+    }
+    return false;
+}
+
+TEST(ports_stream_raw_and_decimated) {
+    sdr_manager_t *m = sdr_manager_create();
+    sdr_device_spec_t spec;
+    sdr_manager_spec_defaults(&spec, SDR_BACKEND_TONE);
+    spec.iq_port = SDR_PORT_ANY;
+    spec.decim_port = SDR_PORT_ANY;
+    spec.core = 0;
+    ASSERT_EQ(sdr_manager_add(m, &spec), 0, "device 0");
+    spec.core = -1;
+    ASSERT_EQ(sdr_manager_add(m, &spec), 1, "device 1");
+
+    sdr_device_stats_t st0, st1;
+    sdr_manager_get_stats(m, 0, &st0);
+    sdr_manager_get_stats(m, 1, &st1);
+    ASSERT_GT(st0.iq_port, 0, "raw port bound");
+    ASSERT_GT(st0.decim_port, 0, "decimated port bound");
+    ASSERT(st0.iq_port != st1.iq_port && st0.decim_port != st1.decim_port, "ports per device");
+
+    iq_client_t *raw = iq_client_create("127.0.0.1", st1.iq_port, IQ_CLIENT_PROTO_PHXI);
+    iq_client_t *dec = iq_client_create("127.0.0.1", st1.decim_port, IQ_CLIENT_PROTO_PHXI);
+    iq_client_frame_t f;
+    iq_client_status_t s;
+    ASSERT_EQ(iq_client_next(raw, &f, 2000), IQ_CLIENT_CONNECTED, "raw header");
+    ASSERT_EQ(iq_client_next(dec, &f, 2000), IQ_CLIENT_CONNECTED, "decimated header");
+    ASSERT_EQ(iq_client_stream(raw)->sample_rate, 2000000, "raw rate");
+    ASSERT_EQ(iq_client_stream(raw)->sample_format, IQ_CLIENT_FORMAT_S16, "raw S16");
+    ASSERT_EQ(iq_client_stream(dec)->sample_rate, SDR_MANAGER_DECIM_RATE, "48 kHz");
+    ASSERT_EQ(iq_client_stream(dec)->sample_format, IQ_CLIENT_FORMAT_F32, "decimated F32");
+
+    run(m, "DEV 1 START");
+    uint64_t got = 0;
+    while (got < 20000) {
+        ASSERT(next_frame(raw, &f, &s) && s == IQ_CLIENT_FRAME, "raw frames");
+        ASSERT(f.num_samples <= SDR_MANAGER_BLOCK, "frame size");
+        got += f.num_samples;
+    }
+    got = 0;
+    while (got < 480) {
+        ASSERT(next_frame(dec, &f, &s) && s == IQ_CLIENT_FRAME, "decimated frames");
+        const float *iq = (const float*)f.samples;
+        ASSERT(fabsf(iq[0]) <= 1.0f && fabsf(iq[1]) <= 1.0f, "normalized");
+        got += f.num_samples;
+    }
+
+    /* Retune: META on the running stream */
+    run(m, "DEV 1 SET_FREQ 7000000");
+    bool meta = false;
+    for (int k = 0; k < 500 && !meta; k++) {
+        ASSERT(next_frame(raw, &f, &s), "frames after retune");
+        meta = s == IQ_CLIENT_META;
+    }
+    ASSERT(meta, "META sent");
+    ASSERT_EQ(iq_client_stream(raw)->center_freq, 7000000, "new frequency");
+
+    sdr_manager_get_stats(m, 0, &st0);
+    sdr_manager_get_stats(m, 1, &st1);
+    ASSERT_EQ(st0.samples, 0, "device 0 idle");
+    ASSERT(st1.iq_client && st1.decim_client, "clients attached");
+    ASSERT_GT(st1.frames, 0, "frames counted");
+#if defined(_WIN32) || defined(__linux__)
+    ASSERT(st0.pinned, "device 0 pinned to core 0");
+#endif
+    ASSERT(!st1.pinned, "device 1 not pinned");
+
+    iq_client_destroy(raw);
+    iq_client_destroy(dec);
+    sdr_manager_destroy(m);
+    PASS();
+}
+
+TEST(stalled_client_dropped) {
+    reset_sinks();
+    sdr_manager_t *m = sdr_manager_create();
+    sdr_device_spec_t spec;
+    sdr_manager_spec_defaults(&spec, SDR_BACKEND_TONE);
+    spec.iq_port = SDR_PORT_ANY;
+    spec.paced = false;
+    spec.sink = sink_fn;
+    spec.sink_user = &g_sinks[0];
+    ASSERT_EQ(sdr_manager_add(m, &spec), 0, "device 0");
+
+    sdr_device_stats_t st;
+    sdr_manager_get_stats(m, 0, &st);
+
+    /* Reads the header, then never again */
+    iq_client_t *stalled = iq_client_create("127.0.0.1", st.iq_port, IQ_CLIENT_PROTO_PHXI);
+    iq_client_frame_t f;
+    ASSERT_EQ(iq_client_next(stalled, &f, 2000), IQ_CLIENT_CONNECTED, "header");
+    run(m, "DEV 0 START");
+
+    /* 20 M pairs is 80 MB, far past any socket buffer */
+    ASSERT(wait_raw(&g_sinks[0], 20000000), "device thread not held by the stalled client");
+    sdr_manager_get_stats(m, 0, &st);
+    ASSERT(!st.iq_client, "stalled client dropped");
+
+    /* The port takes a new client */
+    iq_client_t *next = iq_client_create("127.0.0.1", st.iq_port, IQ_CLIENT_PROTO_PHXI);
+    iq_client_status_t s;
+    ASSERT_EQ(iq_client_next(next, &f, 2000), IQ_CLIENT_CONNECTED, "reconnect header");
+    ASSERT(next_frame(next, &f, &s), "frames after reconnect");
+
+    iq_client_destroy(next);
+    iq_client_destroy(stalled);
+    sdr_manager_destroy(m);
+    PASS();
+}
+
+/*============================================================================
+ * Hardware
+ *============================================================================*/
+
+TEST(no_hardware_refused) {
+    sdr_manager_t *m = sdr_manager_create();
+    sdr_device_spec_t spec;
+    sdr_manager_spec_defaults(&spec, SDR_BACKEND_HARDWARE);
+    ASSERT_EQ(sdr_manager_add(m, &spec), -1, "no RSP to open");
+    ASSERT_EQ(sdr_manager_add_hardware(m, &spec), 0, "none enumerated");
+    ASSERT_EQ(sdr_manager_count(m), 0, "empty");
+    ASSERT_STR_CONTAINS(run(m, "PING").message, "ERR STATE", "no device 0");
+    ASSERT_STR_EQ(run(m, "DEVICES").message, "OK COUNT=0 BACKENDS=NONE", "devices");
+    sdr_manager_destroy(m);
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("SDR Device Manager Tests");
+
+    TEST_SECTION("Devices");
+    RUN_TEST(tones_on_own_threads);
+    RUN_TEST(commands_addressed_by_device);
+    RUN_TEST(replay_delivers_file_in_order);
+    RUN_TEST(replay_missing_file_refused);
+
+    TEST_SECTION("Ports");
+    RUN_TEST(ports_stream_raw_and_decimated);
+    RUN_TEST(stalled_client_dropped);
+
+    TEST_SECTION("Hardware");
+    RUN_TEST(no_hardware_refused);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,249 @@
+/**
+ * @file test_subcarrier_frontend.c
+ * @brief Unit tests for the shared 100 Hz subcarrier front end
+ *
+ * - Consumers on one shared front end match private-front-end instances
+ * - bcd_envelope and subcarrier_detector agree frame for frame
+ * - 100 Hz AM detected, tick-band energy rejected
+ * - Subscribe / unsubscribe / disable
+ */
+
+#include "test_framework.h"
+#include "../tools/subcarrier_frontend.h"
+#include "../tools/bcd_envelope.h"
+#include "../tools/subcarrier_detector.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define MAX_FRAMES  1000
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+typedef struct {
+    bcd_envelope_frame_t frames[MAX_FRAMES];
+    int count;
+} env_log_t;
+
+typedef struct {
+    subcarrier_frame_t frames[MAX_FRAMES];
+    int count;
+} sc_log_t;
+
+static void log_envelope(const bcd_envelope_frame_t *frame, void *user_data) {
+    env_log_t *log = (env_log_t *)user_data;
+    if (log->count < MAX_FRAMES) log->frames[log->count++] = *frame;
+}
+
+static void log_subcarrier(const subcarrier_frame_t *frame, void *user_data) {
+    sc_log_t *log = (sc_log_t *)user_data;
+    if (log->count < MAX_FRAMES) log->frames[log->count++] = *frame;
+}
+
+static void count_blocks(const subcarrier_block_t *block, void *user_data) {
+    (void)block;
+    (*(int *)user_data)++;
+}
+
+/* 12 kHz display-path sample: 100 Hz subcarrier keyed 500 ms per second,
+ * plus a 1000 Hz tick and a little noise */
+static void make_sample(int n, float am_depth, float *i_out, float *q_out, uint32_t *lcg) {
+    float t = (float)n / 12000.0f;
+    int ms_in_second = (n / 12) % 1000;
+    float sub = (ms_in_second >= 30 && ms_in_second < 530) ? 1.0f : 0.0f;
+    float am = am_depth * sub * cosf(2.0f * (float)M_PI * 100.0f * t);
+    float tick = (ms_in_second < 5) ? 0.3f * cosf(2.0f * (float)M_PI * 1000.0f * t) : 0.0f;
+
+    *lcg = *lcg * 1664525u + 1013904223u;
+    float noise = ((float)(*lcg >> 8) / 16777216.0f - 0.5f) * 0.002f;
+
+    *i_out = 0.2f + am + tick + noise;
+    *q_out = 0.1f + 0.5f * am + noise;
+}
+
+/*============================================================================
+ * Shared vs. Private
+ *============================================================================*/
+
+static env_log_t g_env_private, g_env_shared;
+static sc_log_t g_sc_private, g_sc_shared;
+
+TEST(shared_matches_private) {
+    memset(&g_env_private, 0, sizeof(g_env_private));
+    memset(&g_env_shared, 0, sizeof(g_env_shared));
+    memset(&g_sc_private, 0, sizeof(g_sc_private));
+    memset(&g_sc_shared, 0, sizeof(g_sc_shared));
+
+    bcd_envelope_t *env_p = bcd_envelope_create(NULL);
+    subcarrier_detector_t *sc_p = subcarrier_detector_create(NULL);
+    subcarrier_frontend_t *fe = subcarrier_frontend_create();
+    bcd_envelope_t *env_s = bcd_envelope_create_shared(fe, NULL);
+    subcarrier_detector_t *sc_s = subcarrier_detector_create_shared(fe, NULL);
+    ASSERT_NOT_NULL(env_p, "private envelope");
+    ASSERT_NOT_NULL(sc_p, "private detector");
+    ASSERT_NOT_NULL(env_s, "shared envelope");
+    ASSERT_NOT_NULL(sc_s, "shared detector");
+
+    bcd_envelope_set_callback(env_p, log_envelope, &g_env_private);
+    bcd_envelope_set_callback(env_s, log_envelope, &g_env_shared);
+    subcarrier_detector_set_callback(sc_p, log_subcarrier, &g_sc_private);
+    subcarrier_detector_set_callback(sc_s, log_subcarrier, &g_sc_shared);
+
+    uint32_t lcg = 7;
+    for (int n = 0; n < 12000 * 3; n++) {
+        float i, q;
+        make_sample(n, 0.05f, &i, &q, &lcg);
+        bcd_envelope_process_sample(env_p, i, q);
+        subcarrier_detector_process_sample(sc_p, i, q);
+        subcarrier_frontend_process_sample(fe, i, q);
+        bcd_envelope_process_sample(env_s, i, q);           /* No-op when shared */
+        subcarrier_detector_process_sample(sc_s, i, q);
+    }
+
+    ASSERT_EQ(g_env_private.count, 300, "100 frames per second");
+    ASSERT_EQ(g_env_shared.count, g_env_private.count, "same frame count (shared not double fed)");
+    ASSERT_EQ(g_sc_shared.count, g_sc_private.count, "same frame count");
+    ASSERT_EQ(memcmp(g_env_shared.frames, g_env_private.frames,
+                     g_env_private.count * sizeof(bcd_envelope_frame_t)), 0,
+              "envelope frames bit-identical");
+    ASSERT_EQ(memcmp(g_sc_shared.frames, g_sc_private.frames,
+                     g_sc_private.count * sizeof(subcarrier_frame_t)), 0,
+              "detector frames bit-identical");
+
+    /* Both consumers compute the same thing from the same blocks */
+    for (int k = 0; k < g_env_shared.count; k++) {
+        ASSERT_TRUE(g_env_shared.frames[k].envelope == g_sc_shared.frames[k].envelope,
+                    "envelope matches across consumers");
+        ASSERT_TRUE(g_env_shared.frames[k].snr_db == g_sc_shared.frames[k].snr_db,
+                    "SNR matches across consumers");
+    }
+    ASSERT_EQ(subcarrier_frontend_get_block_count(fe), 300u, "one front end pass");
+
+    bcd_envelope_destroy(env_p);
+    subcarrier_detector_destroy(sc_p);
+    bcd_envelope_destroy(env_s);
+    subcarrier_detector_destroy(sc_s);
+    subcarrier_frontend_destroy(fe);
+    PASS();
+}
+
+/*============================================================================
+ * Detection
+ *============================================================================*/
+
+TEST(detects_subcarrier) {
+    bcd_envelope_t *strong = bcd_envelope_create(NULL);
+    bcd_envelope_t *none = bcd_envelope_create(NULL);
+
+    uint32_t lcg_a = 1, lcg_b = 1;
+    float on_env = 0.0f;
+    for (int n = 0; n < 12000 * 3; n++) {
+        float i, q;
+        make_sample(n, 0.1f, &i, &q, &lcg_a);
+        bcd_envelope_process_sample(strong, i, q);
+        make_sample(n, 0.0f, &i, &q, &lcg_b);           /* Tick + DC only */
+        bcd_envelope_process_sample(none, i, q);
+        if (n >= 12000 && (n / 12) % 1000 == 400) {     /* Floor settled */
+            on_env = bcd_envelope_get_envelope(strong);
+            ASSERT_EQ(bcd_envelope_get_status(strong), BCD_ENV_STRONG, "keyed on: STRONG");
+        }
+    }
+
+    /* Tick band and DC stay out of the 100 Hz bin */
+    ASSERT_TRUE(on_env > 20.0f * bcd_envelope_get_envelope(none), "100 Hz >> tick leakage");
+    ASSERT_TRUE(bcd_envelope_get_envelope(strong) < 0.1f * on_env, "envelope drops when keyed off");
+    ASSERT_TRUE(bcd_envelope_get_status(none) != BCD_ENV_STRONG, "no subcarrier, no STRONG");
+
+    bcd_envelope_destroy(strong);
+    bcd_envelope_destroy(none);
+    PASS();
+}
+
+/*============================================================================
+ * Subscribers
+ *============================================================================*/
+
+TEST(subscribe_unsubscribe) {
+    subcarrier_frontend_t *fe = subcarrier_frontend_create();
+    int counts[SUBCARRIER_FE_MAX_SUBSCRIBERS + 1] = { 0 };
+
+    for (int k = 0; k < SUBCARRIER_FE_MAX_SUBSCRIBERS; k++) {
+        ASSERT_TRUE(subcarrier_frontend_subscribe(fe, count_blocks, &counts[k]), "subscribe");
+    }
+    ASSERT_FALSE(subcarrier_frontend_subscribe(fe, count_blocks, &counts[SUBCARRIER_FE_MAX_SUBSCRIBERS]),
+                 "table full");
+
+    for (int n = 0; n < SUBCARRIER_FE_BLOCK_SIZE * 10; n++) {
+        subcarrier_frontend_process_sample_2400(fe, 0.1f, 0.0f);
+    }
+    subcarrier_frontend_unsubscribe(fe, count_blocks, &counts[1]);
+    for (int n = 0; n < SUBCARRIER_FE_BLOCK_SIZE * 10; n++) {
+        subcarrier_frontend_process_sample_2400(fe, 0.1f, 0.0f);
+    }
+
+    ASSERT_EQ(counts[0], 20, "first subscriber sees every block");
+    ASSERT_EQ(counts[1], 10, "removed subscriber stops");
+    ASSERT_EQ(counts[2], 20, "later subscribers shift down");
+    ASSERT_EQ(counts[SUBCARRIER_FE_MAX_SUBSCRIBERS], 0, "rejected subscriber never called");
+
+    subcarrier_frontend_destroy(fe);
+    PASS();
+}
+
+TEST(disabled_consumer_skips_blocks) {
+    subcarrier_frontend_t *fe = subcarrier_frontend_create();
+    subcarrier_detector_t *a = subcarrier_detector_create_shared(fe, NULL);
+    subcarrier_detector_t *b = subcarrier_detector_create_shared(fe, NULL);
+    sc_log_t *la = calloc(1, sizeof(sc_log_t));
+    sc_log_t *lb = calloc(1, sizeof(sc_log_t));
+    subcarrier_detector_set_callback(a, log_subcarrier, la);
+    subcarrier_detector_set_callback(b, log_subcarrier, lb);
+
+    subcarrier_detector_set_enabled(b, false);
+    for (int n = 0; n < SUBCARRIER_FE_BLOCK_SIZE * 5; n++) {
+        subcarrier_frontend_process_sample_2400(fe, 0.1f, 0.0f);
+    }
+    ASSERT_EQ(la->count, 5, "enabled consumer runs");
+    ASSERT_EQ(lb->count, 0, "disabled consumer idle");
+    ASSERT_EQ(subcarrier_frontend_get_block_count(fe), 5u, "front end keeps running");
+
+    /* Consumer destroyed first; front end stays usable */
+    subcarrier_detector_destroy(a);
+    subcarrier_detector_set_enabled(b, true);
+    for (int n = 0; n < SUBCARRIER_FE_BLOCK_SIZE; n++) {
+        subcarrier_frontend_process_sample_2400(fe, 0.1f, 0.0f);
+    }
+    ASSERT_EQ(lb->count, 1, "re-enabled consumer resumes");
+    ASSERT_FLOAT_EQ(lb->frames[0].timestamp_ms, 60.0f, 1e-3f, "front end timeline");
+
+    subcarrier_detector_destroy(b);
+    subcarrier_frontend_destroy(fe);
+    free(la);
+    free(lb);
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Subcarrier Front End Tests");
+
+    TEST_SECTION("Shared vs. Private");
+    RUN_TEST(shared_matches_private);
+
+    TEST_SECTION("Detection");
+    RUN_TEST(detects_subcarrier);
+
+    TEST_SECTION("Subscribers");
+    RUN_TEST(subscribe_unsubscribe);
+    RUN_TEST(disabled_consumer_skips_blocks);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -571,6 +571,32 @@ TEST(cmd_status) {
     PASS();
 }
 
+static void fake_iq_stats(char *buf, size_t size) {
+    snprintf(buf, size, "CONNECTED=1 FPS=244.1 FRAME=8192");
+}
+
+TEST(cmd_get_iqstats) {
+    tcp_command_t cmd;
+    tcp_response_t resp;
+    tcp_sdr_state_t state;
+
+    tcp_state_defaults(&state);
+    ASSERT_EQ(tcp_parse_command("get_iqstats\n", &cmd), TCP_OK, "GET_IQSTATS should parse");
+    ASSERT_EQ(cmd.type, CMD_GET_IQSTATS, "should be GET_IQSTATS");
+
+    /* No I/Q port: nothing to report */
+    ASSERT_EQ(tcp_execute_command(&cmd, &state, &resp), TCP_ERR_STATE, "no hook");
+    ASSERT(strstr(resp.message, "ERR STATE") != NULL, "should report STATE error");
+
+    state.iq_stats = fake_iq_stats;
+    ASSERT_EQ(tcp_execute_command(&cmd, &state, &resp), TCP_OK, "hook set");
+    ASSERT_STR_EQ(resp.message, "OK CONNECTED=1 FPS=244.1 FRAME=8192", "hook text returned");
+
+    ASSERT(tcp_parse_command("GET_IQSTATS 1\n", &cmd) != TCP_OK, "takes no arguments");
+
+    PASS();
+}
+
 /*============================================================================
  * Response Formatting Tests
  *============================================================================*/
@@ -656,6 +682,7 @@ int main(void) {
 
     printf("\n=== Status Command ===\n");
     RUN_TEST(cmd_status);
+    RUN_TEST(cmd_get_iqstats);
 
     printf("\n=== Response Formatting ===\n");
     RUN_TEST(response_formatting);
@@ -0,0 +1,188 @@
+/**
+ * @file test_tick_correlator.c
+ * @brief Unit tests for tick_correlator module
+ *
+ * - Welford chain statistics match a direct computation
+ * - Tick ring keeps the newest CORR_TICK_HISTORY records
+ * - Chain stats age out of the ring and new chains keep updating
+ * - Intervals stay exact 200 hours into a run
+ * - Spill log holds every tick in order, with its Unix wall time
+ */
+
+#include "test_framework.h"
+#include "../tools/tick_correlator.h"
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+#define SPILL_PATH  "test_tick_spill.bin"
+
+static void add_tick(tick_correlator_t *tc, double timestamp_ms, int tick_num) {
+    char time_str[16];
+    int sec = tick_num % 86400;
+    snprintf(time_str, sizeof(time_str), "%02d:%02d:%02d", sec / 3600, (sec / 60) % 60, sec % 60);
+    tick_correlator_add_tick(tc, time_str, timestamp_ms, tick_num, "TICK",
+                             0.01f, 5.0f, 1000.0f, 1000.0f, 0.001f, 10.0f, 5.0f);
+}
+
+/*============================================================================
+ * Chain Statistics Tests
+ *============================================================================*/
+
+TEST(chain_stats_welford) {
+    tick_correlator_t *tc = tick_correlator_create(NULL);
+    ASSERT_NOT_NULL(tc, "create");
+
+    static const float intervals[] = { 1000.5f, 999.0f, 1001.5f, 1000.0f, 998.5f, 1001.0f };
+    const int n = (int)(sizeof(intervals) / sizeof(intervals[0]));
+
+    float t = 1000.0f;
+    add_tick(tc, t, 1);
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        t += intervals[i];
+        add_tick(tc, t, i + 2);
+        sum += intervals[i];
+    }
+    double mean = sum / n;
+    double var = 0.0;
+    for (int i = 0; i < n; i++) var += (intervals[i] - mean) * (intervals[i] - mean);
+    double sd = sqrt(var / n);
+
+    ASSERT_EQ(tick_correlator_get_chain_count(tc), 1, "one chain");
+    chain_stats_t cs = tick_correlator_get_chain_stats(tc, 1);
+    ASSERT_EQ(cs.chain_id, 1, "chain id");
+    ASSERT_EQ(cs.tick_count, n + 1, "tick count");
+    ASSERT_FLOAT_EQ(cs.avg_interval_ms, mean, 1e-3, "mean excludes the gap before tick 1");
+    ASSERT_FLOAT_EQ(cs.std_interval_ms, sd, 1e-3, "std dev");
+    ASSERT_FLOAT_EQ(cs.min_interval_ms, 998.5f, 1e-3, "min");
+    ASSERT_FLOAT_EQ(cs.max_interval_ms, 1001.5f, 1e-3, "max");
+    tick_correlator_destroy(tc);
+    PASS();
+}
+
+TEST(chains_age_out) {
+    tick_correlator_t *tc = tick_correlator_create(NULL);
+    const int chains = CORR_CHAIN_HISTORY + 50;
+
+    /* Two ticks per chain, 5 s gap between chains */
+    float t = 1000.0f;
+    for (int c = 0; c < chains; c++) {
+        add_tick(tc, t, c * 2);
+        add_tick(tc, t + 1000.0f, c * 2 + 1);
+        t += 6000.0f;
+    }
+
+    ASSERT_EQ(tick_correlator_get_chain_count(tc), chains, "all chains counted");
+    chain_stats_t old = tick_correlator_get_chain_stats(tc, 1);
+    ASSERT_EQ(old.chain_id, 0, "oldest chain aged out");
+    chain_stats_t first_kept = tick_correlator_get_chain_stats(tc, chains - CORR_CHAIN_HISTORY + 1);
+    ASSERT_EQ(first_kept.chain_id, chains - CORR_CHAIN_HISTORY + 1, "oldest retained chain");
+    chain_stats_t last = tick_correlator_get_chain_stats(tc, chains);
+    ASSERT_EQ(last.chain_id, chains, "newest chain");
+    ASSERT_EQ(last.tick_count, 2, "stats still updating past the ring size");
+    ASSERT_FLOAT_EQ(last.avg_interval_ms, 1000.0f, 1e-3, "interval");
+    tick_correlator_destroy(tc);
+    PASS();
+}
+
+TEST(intervals_exact_after_200_hours) {
+    tick_correlator_t *tc = tick_correlator_create(NULL);
+
+    /* 1000.25 ms apart: a float timestamp steps by 64 ms here, so every interval would be 960 or 1024 */
+    double t = 200.0 * 3600.0 * 1000.0;
+    for (int i = 0; i < 20; i++) add_tick(tc, t + i * 1000.25, i);
+
+    ASSERT_EQ(tick_correlator_get_chain_count(tc), 1, "one chain");
+    ASSERT_EQ(tick_correlator_get_current_chain_length(tc), 20, "every tick inside 998-1002 ms");
+    chain_stats_t cs = tick_correlator_get_chain_stats(tc, 1);
+    ASSERT_FLOAT_EQ(cs.avg_interval_ms, 1000.25f, 1e-3, "mean interval");
+    ASSERT_FLOAT_EQ(cs.std_interval_ms, 0.0f, 1e-3, "no quantization");
+    ASSERT_FLOAT_EQ(cs.end_ms - cs.start_ms, 19 * 1000.25, 1e-6, "span");
+    ASSERT_FLOAT_EQ(tick_correlator_get_current_drift(tc), 19 * 0.25f, 1e-3, "drift");
+    tick_correlator_destroy(tc);
+    PASS();
+}
+
+/*============================================================================
+ * Tick Ring Tests
+ *============================================================================*/
+
+TEST(tick_ring_keeps_newest) {
+    tick_correlator_t *tc = tick_correlator_create(NULL);
+    const int total = CORR_TICK_HISTORY + 500;
+
+    for (int i = 0; i < total; i++) add_tick(tc, 1000.0f + i * 1000.0f, i);
+
+    tick_record_t tr;
+    ASSERT_EQ(tick_correlator_get_tick_count(tc), total, "total ticks");
+    ASSERT_TRUE(tick_correlator_get_tick(tc, 0, &tr), "newest");
+    ASSERT_EQ(tr.tick_num, total - 1, "newest tick");
+    ASSERT_TRUE(tick_correlator_get_tick(tc, CORR_TICK_HISTORY - 1, &tr), "oldest retained");
+    ASSERT_EQ(tr.tick_num, total - CORR_TICK_HISTORY, "oldest tick");
+    ASSERT_STR_EQ(tr.expected, "TICK", "record reused cleanly");
+    ASSERT_FALSE(tick_correlator_get_tick(tc, CORR_TICK_HISTORY, &tr), "aged out");
+    tick_correlator_destroy(tc);
+    PASS();
+}
+
+TEST(spill_log_holds_every_tick) {
+    tick_correlator_t *tc = tick_correlator_create(NULL);
+    ASSERT_TRUE(tick_correlator_set_spill_file(tc, SPILL_PATH), "open spill");
+    const int total = CORR_TICK_HISTORY + 100;
+
+    int64_t before_ms = (int64_t)time(NULL) * 1000;
+    for (int i = 0; i < total; i++) add_tick(tc, 1000.0 + i * 1000.0, i);
+    tick_correlator_destroy(tc);
+    int64_t after_ms = ((int64_t)time(NULL) + 1) * 1000;
+
+    FILE *f = fopen(SPILL_PATH, "rb");
+    ASSERT_NOT_NULL(f, "spill file written");
+    tick_spill_header_t hdr;
+    ASSERT_EQ(fread(&hdr, sizeof(hdr), 1, f), 1, "header");
+    ASSERT_EQ(hdr.magic, TICK_SPILL_MAGIC, "magic");
+    ASSERT_EQ(hdr.version, TICK_SPILL_VERSION, "version");
+    ASSERT_EQ(hdr.record_size, sizeof(tick_spill_record_t), "record size");
+
+    tick_spill_record_t rec;
+    int count = 0, out_of_order = 0, bad_time = 0;
+    int64_t prev_wall = 0;
+    while (fread(&rec, sizeof(rec), 1, f) == 1) {
+        if (rec.tick_num != count) out_of_order++;
+        if (rec.timestamp_ms != 1000.0 + count * 1000.0) out_of_order++;
+        if (rec.wall_time_ms < before_ms || rec.wall_time_ms > after_ms || rec.wall_time_ms < prev_wall) bad_time++;
+        prev_wall = rec.wall_time_ms;
+        count++;
+    }
+    fclose(f);
+    remove(SPILL_PATH);
+
+    ASSERT_EQ(count, total, "every tick spilled");
+    ASSERT_EQ(out_of_order, 0, "oldest first");
+    ASSERT_EQ(bad_time, 0, "Unix wall time, ms");
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("Tick Correlator Tests");
+
+    TEST_SECTION("Chain Statistics");
+    RUN_TEST(chain_stats_welford);
+    RUN_TEST(chains_age_out);
+    RUN_TEST(intervals_exact_after_200_hours);
+
+    TEST_SECTION("Tick Storage");
+    RUN_TEST(tick_ring_keeps_newest);
+    RUN_TEST(spill_log_holds_every_tick);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
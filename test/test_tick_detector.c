@@ -6,6 +6,7 @@
  * - Create/destroy lifecycle
  * - Sample processing
  * - Detection callbacks
+ * - Noise floor held across blanked input
  * - Edge cases
  */
 
@@ -212,6 +213,28 @@ TEST(tick_process_noise) {
     PASS();
 }
 
+TEST(tick_hold_freezes_noise_floor) {
+    tick_detector_t *det = tick_detector_create(NULL);
+
+    feed_noise(det, 2 * TICK_SAMPLE_RATE, 0.01f);
+    float floor = tick_detector_get_noise_floor(det);
+    float threshold = tick_detector_get_threshold(det);
+
+    /* Blanked input while held: floor and threshold stay put */
+    tick_detector_set_hold(det, true);
+    feed_silence(det, TICK_SAMPLE_RATE / 2);
+    ASSERT_FLOAT_EQ(tick_detector_get_noise_floor(det), floor, 1e-9f, "floor held");
+    ASSERT_FLOAT_EQ(tick_detector_get_threshold(det), threshold, 1e-9f, "threshold held");
+
+    /* Released: the same input pulls the floor down */
+    tick_detector_set_hold(det, false);
+    feed_silence(det, TICK_SAMPLE_RATE / 2);
+    ASSERT(tick_detector_get_noise_floor(det) < floor, "floor adapts again");
+
+    tick_detector_destroy(det);
+    PASS();
+}
+
 TEST(tick_process_tone_burst) {
     tick_detector_t *det = tick_detector_create(NULL);
     reset_callback_state();
@@ -318,6 +341,7 @@ int main(void) {
     TEST_SECTION("Processing");
     RUN_TEST(tick_process_silence);
     RUN_TEST(tick_process_noise);
+    RUN_TEST(tick_hold_freezes_noise_floor);
     RUN_TEST(tick_process_tone_burst);
     RUN_TEST(tick_process_disabled);
 
@@ -0,0 +1,181 @@
+/**
+ * @file test_wwv_detector_manager.c
+ * @brief Unit tests for wwv_detector_manager module
+ *
+ * A synthetic detector-path signal (1 kHz ticks every second, an 800 ms
+ * minute marker) through the manager:
+ * - Default config creates every detector; ticks and the marker reach the
+ *   callbacks, counts and sync status
+ * - At 48 kHz the tick detector still runs and marker_detector is skipped
+ * - Display path and status queries run without detectors
+ */
+
+#include "test_framework.h"
+#include "../tools/wwv_detector_manager.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*============================================================================
+ * Test Helpers
+ *============================================================================*/
+
+#define SIGNAL_SECONDS  13
+#define MARKER_SECOND   10
+
+static int g_ticks;
+static int g_markers;
+static wwv_marker_event_t g_last_marker;
+
+static void on_tick(const wwv_tick_event_t *event, void *user_data) {
+    (void)event;
+    (void)user_data;
+    g_ticks++;
+}
+
+static void on_marker(const wwv_marker_event_t *event, void *user_data) {
+    (void)user_data;
+    g_markers++;
+    g_last_marker = *event;
+}
+
+static void reset_counts(void) {
+    g_ticks = 0;
+    g_markers = 0;
+    memset(&g_last_marker, 0, sizeof(g_last_marker));
+}
+
+/* Noise, a 5 ms tick each second and an 800 ms marker in MARKER_SECOND */
+static void feed_signal(wwv_detector_manager_t *mgr, int rate) {
+    uint32_t lcg = 12345;
+    for (int n = 0; n < SIGNAL_SECONDS * rate; n++) {
+        int sec = n / rate;
+        int ms = (int)((int64_t)(n % rate) * 1000 / rate);
+        float amp = 0.0f;
+        if (sec >= 1 && ms < 5) amp = 0.8f;
+        if (sec == MARKER_SECOND && ms < 800) amp = 0.8f;
+
+        double ph = 2.0 * M_PI * 1000.0 * n / rate;
+        lcg = lcg * 1664525u + 1013904223u;
+        float ni = 0.01f * ((float)(lcg >> 8) / 8388608.0f - 1.0f);
+        lcg = lcg * 1664525u + 1013904223u;
+        float nq = 0.01f * ((float)(lcg >> 8) / 8388608.0f - 1.0f);
+        wwv_detector_manager_process_detector_sample(mgr, amp * (float)cos(ph) + ni,
+                                                     amp * (float)sin(ph) + nq);
+    }
+}
+
+static void remove_logs(void) {
+    static const char *logs[] = {
+        "wwv_ticks.csv", "wwv_markers.csv", "wwv_tick_corr.csv", "wwv_markers_corr.csv",
+        "wwv_sync.csv", "wwv_carrier.csv", "wwv_tone_500.csv", "wwv_tone_600.csv",
+        "wwv_debug_marker.csv"
+    };
+    for (size_t k = 0; k < sizeof(logs) / sizeof(logs[0]); k++) remove(logs[k]);
+}
+
+/*============================================================================
+ * Detector Path Tests
+ *============================================================================*/
+
+TEST(default_rates_detect_ticks_and_marker) {
+    wwv_detector_config_t cfg = WWV_DETECTOR_CONFIG_DEFAULT;
+    wwv_detector_manager_t *mgr = wwv_detector_manager_create(&cfg);
+    ASSERT_NOT_NULL(mgr, "create");
+    reset_counts();
+    wwv_detector_manager_set_tick_callback(mgr, on_tick, NULL);
+    wwv_detector_manager_set_marker_callback(mgr, on_marker, NULL);
+
+    feed_signal(mgr, 50000);
+
+    ASSERT_GT(g_ticks, 0, "ticks forwarded");
+    ASSERT_EQ(wwv_detector_manager_get_tick_count(mgr), g_ticks, "tick count matches callbacks");
+    ASSERT_EQ(g_markers, 1, "one marker forwarded");
+    ASSERT(g_last_marker.timestamp_ms > MARKER_SECOND * 1000.0f &&
+           g_last_marker.timestamp_ms < (MARKER_SECOND + 2) * 1000.0f, "marker where it was sent");
+    ASSERT_EQ(wwv_detector_manager_get_marker_count(mgr), 1, "marker count");
+
+    wwv_sync_status_t st = wwv_detector_manager_get_sync_status(mgr);
+    ASSERT_EQ(st.tick_count, g_ticks, "status tick count");
+    ASSERT(st.confidence >= 0 && st.confidence <= 100, "confidence in percent");
+
+    wwv_detector_manager_destroy(mgr);
+    remove_logs();
+    PASS();
+}
+
+TEST(other_rate_skips_marker_detector) {
+    wwv_detector_config_t cfg = WWV_DETECTOR_CONFIG_DEFAULT;
+    cfg.detector_sample_rate = 48000;
+    cfg.display_sample_rate = 12000;
+    wwv_detector_manager_t *mgr = wwv_detector_manager_create(&cfg);
+    ASSERT_NOT_NULL(mgr, "create");
+    reset_counts();
+    wwv_detector_manager_set_tick_callback(mgr, on_tick, NULL);
+    wwv_detector_manager_set_marker_callback(mgr, on_marker, NULL);
+
+    feed_signal(mgr, 48000);
+
+    ASSERT_GT(g_ticks, 0, "tick detector sized for 48 kHz");
+    ASSERT_EQ(g_markers, 0, "marker_detector skipped");
+    ASSERT_EQ(wwv_detector_manager_get_marker_count(mgr), 0, "no marker count");
+
+    wwv_detector_manager_destroy(mgr);
+    remove_logs();
+    PASS();
+}
+
+/*============================================================================
+ * Display Path / Status Tests
+ *============================================================================*/
+
+TEST(display_path_and_empty_manager) {
+    wwv_detector_config_t cfg = WWV_DETECTOR_CONFIG_DEFAULT;
+    cfg.enable_tick_detector = false;
+    cfg.enable_marker_detector = false;
+    cfg.enable_sync_detector = false;
+    cfg.enable_correlators = false;
+    cfg.enable_slow_marker = false;
+    wwv_detector_manager_t *mgr = wwv_detector_manager_create(&cfg);
+    ASSERT_NOT_NULL(mgr, "create");
+
+    for (int n = 0; n < 12000; n++) {
+        double ph = 2.0 * M_PI * 500.0 * n / 12000.0;
+        wwv_detector_manager_process_display_sample(mgr, 0.5f * (float)cos(ph), 0.5f * (float)sin(ph));
+    }
+    wwv_detector_manager_process_detector_sample(mgr, 0.0f, 0.0f);
+
+    wwv_sync_status_t st = wwv_detector_manager_get_sync_status(mgr);
+    ASSERT_FALSE(st.is_synced, "no sync detector");
+    ASSERT_EQ(st.tick_count, 0, "no ticks");
+    ASSERT_EQ(wwv_detector_manager_get_tick_flash(mgr), 0, "no flash");
+    wwv_detector_manager_decrement_flash(mgr);
+    wwv_detector_manager_log_metadata(mgr, 10000000, 2000000, 40, 3);
+
+    wwv_detector_manager_destroy(mgr);
+    wwv_detector_manager_destroy(NULL);
+    remove_logs();
+    PASS();
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+int main(void) {
+    TEST_BEGIN("WWV Detector Manager Tests");
+
+    TEST_SECTION("Detector Path");
+    RUN_TEST(default_rates_detect_ticks_and_marker);
+    RUN_TEST(other_rate_skips_marker_detector);
+
+    TEST_SECTION("Display Path");
+    RUN_TEST(display_path_and_empty_manager);
+
+    TEST_END();
+    return TEST_EXIT_CODE();
+}
@@ -27,6 +27,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include "subcarrier_frontend.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -102,6 +103,17 @@ typedef void (*bcd_envelope_callback_fn)(const bcd_envelope_frame_t *frame, void
  */
 bcd_envelope_t *bcd_envelope_create(const char *csv_path);
 
+/**
+ * Create an instance that consumes blocks from a shared front end
+ * @param frontend  Front end fed by the caller (NULL = private, same as _create)
+ * @param csv_path  Path for CSV log file (NULL to disable logging)
+ *
+ * With a shared front end the process_sample calls are no-ops; feed the
+ * front end instead. Destroy this instance before the front end.
+ */
+bcd_envelope_t *bcd_envelope_create_shared(subcarrier_frontend_t *frontend,
+                                           const char *csv_path);
+
 /**
  * Destroy a BCD envelope tracker instance
  */
@@ -129,7 +141,7 @@ void bcd_envelope_process_sample(bcd_envelope_t *det,
 
 /**
  * Alternative: Feed pre-decimated samples at 2.4 kHz
- * Use this if decimation happens elsewhere
+ * Use this if decimation happens elsewhere (private front end only)
  */
 void bcd_envelope_process_sample_2400(bcd_envelope_t *det,
                                       float i_sample, float q_sample);
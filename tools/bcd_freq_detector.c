@@ -18,6 +18,7 @@
 #include "bcd_freq_detector.h"
 #include "waterfall_telemetry.h"
 #include "kiss_fft.h"
+#include "detector_rate.h"
 #include "version.h"
 #include <stdlib.h>
 #include <string.h>
@@ -28,10 +29,6 @@
  * Internal Configuration
  *============================================================================*/
 
-#define FRAME_DURATION_MS   ((float)BCD_FREQ_FFT_SIZE * 1000.0f / BCD_FREQ_SAMPLE_RATE)
-#define HZ_PER_BIN          ((float)BCD_FREQ_SAMPLE_RATE / BCD_FREQ_FFT_SIZE)
-#define WINDOW_FRAMES       ((int)(BCD_FREQ_WINDOW_MS / FRAME_DURATION_MS))
-
 /* Detection timing */
 #define BCD_FREQ_COOLDOWN_MS        500.0f  /* Cooldown between detections */
 #define BCD_FREQ_MAX_DURATION_MS    2000.0f /* Max time in pulse before timeout */
@@ -41,8 +38,6 @@
 #define BCD_FREQ_WARMUP_ADAPT_RATE  0.02f
 #define BCD_FREQ_MIN_STARTUP_MS     5000.0f /* No pulses in first 5 seconds */
 
-#define MS_TO_FRAMES(ms)    ((int)((ms) / FRAME_DURATION_MS + 0.5f))
-
 #ifndef M_PI
 #define M_PI 3.14159265358979323846f
 #endif
@@ -58,6 +53,12 @@ typedef enum {
 } detector_state_t;
 
 struct bcd_freq_detector {
+    /* Input rate profile (fixed at create) */
+    detector_rate_t rate;
+    int center_bin;             /* BCD_FREQ_TARGET_FREQ_HZ bin */
+    int bin_span;               /* +/- bins for BCD_FREQ_BANDWIDTH_HZ */
+    int window_frames;          /* BCD_FREQ_WINDOW_MS in frames */
+
     /* FFT resources */
     kiss_fft_cfg fft_cfg;
     kiss_fft_cpx *fft_in;
@@ -101,6 +102,7 @@ struct bcd_freq_detector {
 
     /* Enabled flag */
     bool detection_enabled;
+    bool hold;                      /* Baseline frozen */
 
     /* Callback */
     bcd_freq_callback_fn callback;
@@ -121,30 +123,7 @@ struct bcd_freq_detector {
  * 100 Hz is in bin ~4 (100/24.4 ≈ 4.1)
  */
 static float calculate_bucket_energy(bcd_freq_detector_t *fd) {
-    int center_bin = (int)(BCD_FREQ_TARGET_FREQ_HZ / HZ_PER_BIN + 0.5f);
-    int bin_span = (int)(BCD_FREQ_BANDWIDTH_HZ / HZ_PER_BIN + 0.5f);
-    if (bin_span < 1) bin_span = 1;
-
-    float pos_energy = 0.0f;
-    float neg_energy = 0.0f;
-
-    for (int b = -bin_span; b <= bin_span; b++) {
-        int pos_bin = center_bin + b;
-        int neg_bin = BCD_FREQ_FFT_SIZE - center_bin + b;
-
-        if (pos_bin >= 0 && pos_bin < BCD_FREQ_FFT_SIZE) {
-            float re = fd->fft_out[pos_bin].r;
-            float im = fd->fft_out[pos_bin].i;
-            pos_energy += sqrtf(re * re + im * im) / BCD_FREQ_FFT_SIZE;
-        }
-        if (neg_bin >= 0 && neg_bin < BCD_FREQ_FFT_SIZE) {
-            float re = fd->fft_out[neg_bin].r;
-            float im = fd->fft_out[neg_bin].i;
-            neg_energy += sqrtf(re * re + im * im) / BCD_FREQ_FFT_SIZE;
-        }
-    }
-
-    return pos_energy + neg_energy;
+    return detector_rate_bucket_energy(&fd->rate, fd->fft_out, fd->center_bin, fd->bin_span);
 }
 
 /**
@@ -160,15 +139,15 @@ static void get_wall_time_str(bcd_freq_detector_t *fd, float timestamp_ms, char
  * Update sliding window accumulator
  */
 static void update_accumulator(bcd_freq_detector_t *fd, float energy) {
-    if (fd->history_count >= WINDOW_FRAMES) {
+    if (fd->history_count >= fd->window_frames) {
         fd->accumulated_energy -= fd->energy_history[fd->history_idx];
     }
 
     fd->energy_history[fd->history_idx] = energy;
     fd->accumulated_energy += energy;
 
-    fd->history_idx = (fd->history_idx + 1) % WINDOW_FRAMES;
-    if (fd->history_count < WINDOW_FRAMES) {
+    fd->history_idx = (fd->history_idx + 1) % fd->window_frames;
+    if (fd->history_count < fd->window_frames) {
         fd->history_count++;
     }
 }
@@ -181,7 +160,7 @@ static void run_state_machine(bcd_freq_detector_t *fd) {
 
     /* Warmup phase - fast adaptation to learn baseline */
     if (!fd->warmup_complete) {
-        fd->baseline_energy += BCD_FREQ_WARMUP_ADAPT_RATE * (fd->accumulated_energy - fd->baseline_energy);
+        if (!fd->hold) fd->baseline_energy += BCD_FREQ_WARMUP_ADAPT_RATE * (fd->accumulated_energy - fd->baseline_energy);
         fd->threshold = fd->baseline_energy * BCD_FREQ_THRESHOLD_MULT;
 
         if (frame >= fd->start_frame + BCD_FREQ_WARMUP_FRAMES) {
@@ -193,15 +172,15 @@ static void run_state_machine(bcd_freq_detector_t *fd) {
     }
 
     /* No pulses in first few seconds - baseline still stabilizing */
-    float timestamp_ms = fd->frame_count * FRAME_DURATION_MS;
+    float timestamp_ms = fd->frame_count * fd->rate.frame_ms;
     if (timestamp_ms < BCD_FREQ_MIN_STARTUP_MS) {
-        fd->baseline_energy += BCD_FREQ_NOISE_ADAPT_RATE * (fd->accumulated_energy - fd->baseline_energy);
+        if (!fd->hold) fd->baseline_energy += BCD_FREQ_NOISE_ADAPT_RATE * (fd->accumulated_energy - fd->baseline_energy);
         fd->threshold = fd->baseline_energy * BCD_FREQ_THRESHOLD_MULT;
         return;
     }
 
     /* Self-track baseline during IDLE */
-    if (fd->state == STATE_IDLE) {
+    if (fd->state == STATE_IDLE && !fd->hold) {
         fd->baseline_energy += BCD_FREQ_NOISE_ADAPT_RATE * (fd->accumulated_energy - fd->baseline_energy);
         if (fd->baseline_energy < 0.0001f) fd->baseline_energy = 0.0001f;
         fd->threshold = fd->baseline_energy * BCD_FREQ_THRESHOLD_MULT;
@@ -226,7 +205,7 @@ static void run_state_machine(bcd_freq_detector_t *fd) {
             }
 
             /* Check for timeout or signal drop */
-            float duration_ms = fd->pulse_duration_frames * FRAME_DURATION_MS;
+            float duration_ms = fd->pulse_duration_frames * fd->rate.frame_ms;
             bool timed_out = (duration_ms > BCD_FREQ_MAX_DURATION_MS);
 
             /* Phase 9: Require consecutive low frames before ending pulse */
@@ -237,7 +216,7 @@ static void run_state_machine(bcd_freq_detector_t *fd) {
             }
 
             if ((fd->consecutive_low_frames >= MIN_LOW_FRAMES) || timed_out) {
-                float start_timestamp_ms = fd->pulse_start_frame * FRAME_DURATION_MS;
+                float start_timestamp_ms = fd->pulse_start_frame * fd->rate.frame_ms;
 
                 if (duration_ms >= BCD_FREQ_PULSE_MIN_MS &&
                     duration_ms <= BCD_FREQ_PULSE_MAX_MS) {
@@ -291,7 +270,7 @@ static void run_state_machine(bcd_freq_detector_t *fd) {
                 }
 
                 fd->state = STATE_COOLDOWN;
-                fd->cooldown_frames = MS_TO_FRAMES(BCD_FREQ_COOLDOWN_MS);
+                fd->cooldown_frames = detector_rate_frames(&fd->rate, BCD_FREQ_COOLDOWN_MS);
             }
             break;
 
@@ -308,21 +287,42 @@ static void run_state_machine(bcd_freq_detector_t *fd) {
  *============================================================================*/
 
 bcd_freq_detector_t *bcd_freq_detector_create(const char *csv_path) {
+    return bcd_freq_detector_create_rate(csv_path, BCD_FREQ_SAMPLE_RATE);
+}
+
+bcd_freq_detector_t *bcd_freq_detector_create_rate(const char *csv_path, int sample_rate) {
+    return bcd_freq_detector_create_subband(csv_path, sample_rate, 1);
+}
+
+bcd_freq_detector_t *bcd_freq_detector_create_subband(const char *csv_path, int sample_rate,
+                                                      int decimation) {
     bcd_freq_detector_t *fd = (bcd_freq_detector_t *)calloc(1, sizeof(bcd_freq_detector_t));
     if (!fd) return NULL;
 
-    fd->fft_cfg = kiss_fft_alloc(BCD_FREQ_FFT_SIZE, 0, NULL, NULL);
+    /* Derive FFT size and bins from the input rate */
+    if (!detector_rate_init(&fd->rate, sample_rate, BCD_FREQ_SAMPLE_RATE, BCD_FREQ_FFT_SIZE) ||
+        !detector_rate_decimate(&fd->rate, decimation)) {
+        free(fd);
+        return NULL;
+    }
+    int fft_size = fd->rate.fft_size;
+    fd->center_bin = detector_rate_bin(&fd->rate, BCD_FREQ_TARGET_FREQ_HZ);
+    fd->bin_span = detector_rate_bin(&fd->rate, BCD_FREQ_BANDWIDTH_HZ);
+    if (fd->bin_span < 1) fd->bin_span = 1;
+    fd->window_frames = (int)(BCD_FREQ_WINDOW_MS / fd->rate.frame_ms);
+
+    fd->fft_cfg = kiss_fft_alloc(fft_size, 0, NULL, NULL);
     if (!fd->fft_cfg) {
         free(fd);
         return NULL;
     }
 
-    fd->fft_in = (kiss_fft_cpx *)malloc(BCD_FREQ_FFT_SIZE * sizeof(kiss_fft_cpx));
-    fd->fft_out = (kiss_fft_cpx *)malloc(BCD_FREQ_FFT_SIZE * sizeof(kiss_fft_cpx));
-    fd->window_func = (float *)malloc(BCD_FREQ_FFT_SIZE * sizeof(float));
-    fd->i_buffer = (float *)malloc(BCD_FREQ_FFT_SIZE * sizeof(float));
-    fd->q_buffer = (float *)malloc(BCD_FREQ_FFT_SIZE * sizeof(float));
-    fd->energy_history = (float *)malloc(WINDOW_FRAMES * sizeof(float));
+    fd->fft_in = (kiss_fft_cpx *)malloc(fft_size * sizeof(kiss_fft_cpx));
+    fd->fft_out = (kiss_fft_cpx *)malloc(fft_size * sizeof(kiss_fft_cpx));
+    fd->window_func = (float *)malloc(fft_size * sizeof(float));
+    fd->i_buffer = (float *)malloc(fft_size * sizeof(float));
+    fd->q_buffer = (float *)malloc(fft_size * sizeof(float));
+    fd->energy_history = (float *)malloc(fd->window_frames * sizeof(float));
 
     if (!fd->fft_in || !fd->fft_out || !fd->window_func ||
         !fd->i_buffer || !fd->q_buffer || !fd->energy_history) {
@@ -330,16 +330,18 @@ bcd_freq_detector_t *bcd_freq_detector_create(const char *csv_path) {
         return NULL;
     }
 
-    /* Hann window */
-    for (int i = 0; i < BCD_FREQ_FFT_SIZE; i++) {
-        fd->window_func[i] = 0.5f * (1.0f - cosf(2.0f * M_PI * i / (BCD_FREQ_FFT_SIZE - 1)));
+    /* Hann window (full-rate window at the samples kept) */
+    int full_size = fft_size * fd->rate.decimation;
+    for (int i = 0; i < fft_size; i++) {
+        int n = i * fd->rate.decimation;
+        fd->window_func[i] = 0.5f * (1.0f - cosf(2.0f * M_PI * n / (full_size - 1)));
     }
 
-    memset(fd->i_buffer, 0, BCD_FREQ_FFT_SIZE * sizeof(float));
-    memset(fd->q_buffer, 0, BCD_FREQ_FFT_SIZE * sizeof(float));
+    memset(fd->i_buffer, 0, fft_size * sizeof(float));
+    memset(fd->q_buffer, 0, fft_size * sizeof(float));
     fd->buffer_idx = 0;
 
-    memset(fd->energy_history, 0, WINDOW_FRAMES * sizeof(float));
+    memset(fd->energy_history, 0, fd->window_frames * sizeof(float));
     fd->history_idx = 0;
     fd->history_count = 0;
     fd->accumulated_energy = 0.0f;
@@ -360,7 +362,7 @@ bcd_freq_detector_t *bcd_freq_detector_create(const char *csv_path) {
             fprintf(fd->csv_file, "# Phoenix SDR BCD Freq Detector Log v%s\n", PHOENIX_VERSION_FULL);
             fprintf(fd->csv_file, "# Started: %s\n", time_str);
             fprintf(fd->csv_file, "# FFT: %d (%.2fms), Window: %d frames (%.0fms)\n",
-                    BCD_FREQ_FFT_SIZE, FRAME_DURATION_MS, WINDOW_FRAMES, BCD_FREQ_WINDOW_MS);
+                    fft_size, fd->rate.frame_ms, fd->window_frames, BCD_FREQ_WINDOW_MS);
             fprintf(fd->csv_file, "# Target: %dHz ±%dHz\n",
                     BCD_FREQ_TARGET_FREQ_HZ, BCD_FREQ_BANDWIDTH_HZ);
             fprintf(fd->csv_file, "time,timestamp_ms,pulse_num,accum_energy,duration_ms,baseline,snr_db\n");
@@ -368,10 +370,14 @@ bcd_freq_detector_t *bcd_freq_detector_create(const char *csv_path) {
         }
     }
 
-    printf("[BCD_FREQ] Detector created: FFT=%d (%.2fms), window=%d frames (%.0fms)\n",
-           BCD_FREQ_FFT_SIZE, FRAME_DURATION_MS, WINDOW_FRAMES, BCD_FREQ_WINDOW_MS);
+    printf("[BCD_FREQ] Detector created: %dHz, FFT=%d (%.2fms), window=%d frames (%.0fms)\n",
+           fd->rate.sample_rate, fft_size, fd->rate.frame_ms, fd->window_frames, BCD_FREQ_WINDOW_MS);
     printf("[BCD_FREQ] Target: %dHz ±%dHz, self-tracking baseline\n",
            BCD_FREQ_TARGET_FREQ_HZ, BCD_FREQ_BANDWIDTH_HZ);
+    if (fd->rate.decimation > 1) {
+        printf("[BCD_FREQ] Subband input: every %dth sample (%.2fHz)\n",
+               fd->rate.decimation, (float)fd->rate.sample_rate / fd->rate.decimation);
+    }
 
     return fd;
 }
@@ -409,7 +415,7 @@ bool bcd_freq_detector_process_sample(bcd_freq_detector_t *fd,
     fd->buffer_idx++;
 
     /* Not enough samples yet */
-    if (fd->buffer_idx < BCD_FREQ_FFT_SIZE) {
+    if (fd->buffer_idx < fd->rate.fft_size) {
         return false;
     }
 
@@ -417,7 +423,7 @@ bool bcd_freq_detector_process_sample(bcd_freq_detector_t *fd,
     fd->buffer_idx = 0;
 
     /* Apply window and load FFT input */
-    for (int i = 0; i < BCD_FREQ_FFT_SIZE; i++) {
+    for (int i = 0; i < fd->rate.fft_size; i++) {
         fd->fft_in[i].r = fd->i_buffer[i] * fd->window_func[i];
         fd->fft_in[i].i = fd->q_buffer[i] * fd->window_func[i];
     }
@@ -440,6 +446,10 @@ void bcd_freq_detector_set_enabled(bcd_freq_detector_t *fd, bool enabled) {
     if (fd) fd->detection_enabled = enabled;
 }
 
+void bcd_freq_detector_set_hold(bcd_freq_detector_t *fd, bool hold) {
+    if (fd) fd->hold = hold;
+}
+
 bool bcd_freq_detector_get_enabled(bcd_freq_detector_t *fd) {
     return fd ? fd->detection_enabled : false;
 }
@@ -467,11 +477,11 @@ int bcd_freq_detector_get_pulse_count(bcd_freq_detector_t *fd) {
 void bcd_freq_detector_print_stats(bcd_freq_detector_t *fd) {
     if (!fd) return;
 
-    float elapsed = fd->frame_count * FRAME_DURATION_MS / 1000.0f;
+    float elapsed = fd->frame_count * fd->rate.frame_ms / 1000.0f;
 
     printf("\n=== BCD FREQ DETECTOR STATS ===\n");
     printf("FFT: %d (%.2fms), Window: %d frames (%.0fms)\n",
-           BCD_FREQ_FFT_SIZE, FRAME_DURATION_MS, WINDOW_FRAMES, BCD_FREQ_WINDOW_MS);
+           fd->rate.fft_size, fd->rate.frame_ms, fd->window_frames, BCD_FREQ_WINDOW_MS);
     printf("Target: %d Hz ±%d Hz\n", BCD_FREQ_TARGET_FREQ_HZ, BCD_FREQ_BANDWIDTH_HZ);
     printf("Elapsed: %.1fs  Detected: %d  Rejected: %d\n",
            elapsed, fd->pulses_detected, fd->pulses_rejected);
@@ -481,5 +491,13 @@ void bcd_freq_detector_print_stats(bcd_freq_detector_t *fd) {
 }
 
 float bcd_freq_detector_get_frame_duration_ms(void) {
-    return FRAME_DURATION_MS;
+    return (float)BCD_FREQ_FFT_SIZE * 1000.0f / BCD_FREQ_SAMPLE_RATE;
+}
+
+float bcd_freq_detector_get_frame_ms(bcd_freq_detector_t *fd) {
+    return fd ? fd->rate.frame_ms : bcd_freq_detector_get_frame_duration_ms();
+}
+
+int bcd_freq_detector_get_sample_rate(bcd_freq_detector_t *fd) {
+    return fd ? fd->rate.sample_rate : BCD_FREQ_SAMPLE_RATE;
 }
@@ -32,7 +32,7 @@ extern "C" {
  *============================================================================*/
 
 #define BCD_FREQ_FFT_SIZE           2048    /* 40.96ms frames at 50kHz */
-#define BCD_FREQ_SAMPLE_RATE        50000   /* Input sample rate (2MHz/40) */
+#define BCD_FREQ_SAMPLE_RATE        50000   /* Default input sample rate (2MHz/40) */
 #define BCD_FREQ_TARGET_FREQ_HZ     100     /* BCD subcarrier frequency */
 #define BCD_FREQ_BANDWIDTH_HZ       15      /* Narrow bucket for precise isolation */
 
@@ -76,6 +76,26 @@ typedef void (*bcd_freq_callback_fn)(const bcd_freq_event_t *event, void *user_d
  */
 bcd_freq_detector_t *bcd_freq_detector_create(const char *csv_path);
 
+/**
+ * Create a detector for a given input rate (FFT scaled to keep the frame length)
+ * @param csv_path     Path for CSV log file (NULL to disable logging)
+ * @param sample_rate  Input rate in Hz (DETECTOR_RATE_MIN..MAX)
+ * @return             Detector instance or NULL on failure / bad rate
+ */
+bcd_freq_detector_t *bcd_freq_detector_create_rate(const char *csv_path, int sample_rate);
+
+/**
+ * Create a detector fed every decimation-th sample of a band-limited
+ * channel (fft_filter_bank band with that decimation). Frames, bins and
+ * timestamps match create_rate(sample_rate); the FFT is decimation times
+ * shorter (2048 -> 64 points at 32).
+ * @param sample_rate  Full channel rate in Hz
+ * @param decimation   Power of two dividing the full-rate FFT size
+ * @return             Detector instance or NULL on failure / bad rate
+ */
+bcd_freq_detector_t *bcd_freq_detector_create_subband(const char *csv_path, int sample_rate,
+                                                      int decimation);
+
 /**
  * Destroy a BCD frequency-domain detector instance
  */
@@ -109,6 +129,12 @@ bool bcd_freq_detector_process_sample(bcd_freq_detector_t *fd,
 void bcd_freq_detector_set_enabled(bcd_freq_detector_t *fd, bool enabled);
 bool bcd_freq_detector_get_enabled(bcd_freq_detector_t *fd);
 
+/**
+ * Hold the baseline (blanked or settling input upstream)
+ * While set, the baseline and thresholds stay put; detection still runs.
+ */
+void bcd_freq_detector_set_hold(bcd_freq_detector_t *fd, bool hold);
+
 /**
  * Get current state for display/debug
  */
@@ -124,9 +150,11 @@ int bcd_freq_detector_get_pulse_count(bcd_freq_detector_t *fd);
 void bcd_freq_detector_print_stats(bcd_freq_detector_t *fd);
 
 /**
- * Get timing info
+ * Get timing info (default rate / this instance)
  */
 float bcd_freq_detector_get_frame_duration_ms(void);
+float bcd_freq_detector_get_frame_ms(bcd_freq_detector_t *fd);
+int bcd_freq_detector_get_sample_rate(bcd_freq_detector_t *fd);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,413 @@
+/**
+ * @file bcd_subband_bench.c
+ * @brief A/B check of the BCD detectors at 50 kHz vs. on the 1562 Hz subband
+ *
+ * Runs the waterfall detector path (5 kHz lowpass, decimate to 50 kHz,
+ * normalize) and then two copies of the BCD data channel side by side:
+ *
+ *   A: 0-150 Hz band at 50 kHz      -> bcd_time/freq_detector_create_rate()
+ *   B: 0-150 Hz band, every 32nd    -> bcd_time/freq_detector_create_subband()
+ *
+ * and reports:
+ *
+ *   - pulses found by each path, matched by start time
+ *   - worst start / duration difference between matched pulses
+ *   - CPU time (and TSC cycles on x86) per second of signal, per path
+ *
+ * Exits non-zero if the paths disagree by more than one detector frame.
+ *
+ * Usage:
+ *   bcd_subband_bench                  # 60 s of synthetic BCD pulses
+ *   bcd_subband_bench -t 300           # 300 s synthetic
+ *   bcd_subband_bench capture.iqr      # Recorded file (rate a multiple of 50 kHz)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "iq_recorder.h"
+#include "waterfall_dsp.h"
+#include "fft_filter_bank.h"
+#include "bcd_time_detector.h"
+#include "bcd_freq_detector.h"
+#include "version.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define HAVE_TSC 1
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define DETECTOR_RATE       50000           /* waterfall DETECTOR_SAMPLE_RATE */
+#define DETECTOR_CUTOFF     5000.0f         /* waterfall DETECTOR_FILTER_CUTOFF */
+#define SUBBAND_DECIMATION  32              /* waterfall BCD_SUBBAND_DECIMATION */
+#define CHUNK_SAMPLES       65536           /* Input pairs per read */
+#define DEFAULT_SECONDS     60
+#define MAX_PULSES          8192
+#define PI                  3.14159265358979
+
+static double now_sec(void) {
+#ifdef _WIN32
+    LARGE_INTEGER f, c;
+    QueryPerformanceFrequency(&f);
+    QueryPerformanceCounter(&c);
+    return (double)c.QuadPart / (double)f.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+static uint64_t now_cycles(void) {
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/*============================================================================
+ * One Data Channel Path
+ *============================================================================*/
+
+typedef struct {
+    float start_ms[MAX_PULSES];
+    float duration_ms[MAX_PULSES];
+    int count;
+} pulse_log_t;
+
+typedef struct {
+    const char *name;
+    fft_filter_bank_t *bank;
+    int band;
+    bcd_time_detector_t *time_det;
+    bcd_freq_detector_t *freq_det;
+    pulse_log_t time_pulses;
+    pulse_log_t freq_pulses;
+    double cpu_sec;
+    uint64_t cycles;
+} bcd_path_t;
+
+static void log_pulse(pulse_log_t *log, float start_ms, float duration_ms) {
+    if (log->count < MAX_PULSES) {
+        log->start_ms[log->count] = start_ms;
+        log->duration_ms[log->count] = duration_ms;
+        log->count++;
+    }
+}
+
+static void on_time_pulse(const bcd_time_event_t *event, void *user_data) {
+    log_pulse(&((bcd_path_t *)user_data)->time_pulses, event->timestamp_ms, event->duration_ms);
+}
+
+static void on_freq_pulse(const bcd_freq_event_t *event, void *user_data) {
+    log_pulse(&((bcd_path_t *)user_data)->freq_pulses, event->timestamp_ms, event->duration_ms);
+}
+
+static bool path_init(bcd_path_t *p, const char *name, int decimation) {
+    memset(p, 0, sizeof(*p));
+    p->name = name;
+    p->bank = fft_filter_bank_create((float)DETECTOR_RATE, FFT_BANK_DEFAULT_FFT_SIZE);
+    if (!p->bank) return false;
+    p->band = fft_filter_bank_add_band(p->bank, 0.0f, 150.0f, decimation);
+    p->time_det = bcd_time_detector_create_subband(NULL, DETECTOR_RATE, decimation);
+    p->freq_det = bcd_freq_detector_create_subband(NULL, DETECTOR_RATE, decimation);
+    if (p->band < 0 || !p->time_det || !p->freq_det) return false;
+
+    bcd_time_detector_set_callback(p->time_det, on_time_pulse, p);
+    bcd_freq_detector_set_callback(p->freq_det, on_freq_pulse, p);
+    return true;
+}
+
+static void path_free(bcd_path_t *p) {
+    bcd_time_detector_destroy(p->time_det);
+    bcd_freq_detector_destroy(p->freq_det);
+    fft_filter_bank_destroy(p->bank);
+}
+
+/* Same loop as waterfall detector_path_sample() after normalization */
+static void path_run(bcd_path_t *p, const float *iq, int count) {
+    double t0 = now_sec();
+    uint64_t c0 = now_cycles();
+
+    for (int n = 0; n < count; n++) {
+        if (!fft_filter_bank_push(p->bank, iq[2 * n], iq[2 * n + 1])) continue;
+
+        int n_data;
+        const float *data = fft_filter_bank_output(p->bank, p->band, &n_data);
+        for (int k = 0; k < n_data; k++) {
+            float data_i = data[2 * k], data_q = data[2 * k + 1];
+            bcd_time_detector_process_sample(p->time_det, data_i, data_q);
+            bcd_freq_detector_process_sample(p->freq_det, data_i, data_q);
+        }
+    }
+
+    p->cycles += now_cycles() - c0;
+    p->cpu_sec += now_sec() - t0;
+}
+
+/*============================================================================
+ * Front End (waterfall detector path up to the channel bank)
+ *============================================================================*/
+
+typedef struct {
+    wf_lowpass_t lp_i, lp_q;
+    int decimation;
+    int phase;
+    float level;
+    long warmup;
+} front_end_t;
+
+static void front_end_init(front_end_t *fe, int input_rate) {
+    memset(fe, 0, sizeof(*fe));
+    fe->decimation = input_rate / DETECTOR_RATE;
+    wf_lowpass_init(&fe->lp_i, DETECTOR_CUTOFF, (float)input_rate);
+    wf_lowpass_init(&fe->lp_q, DETECTOR_CUTOFF, (float)input_rate);
+}
+
+/* Lowpass + decimate + slow AGC; returns 50 kHz pairs written */
+static int front_end_process(front_end_t *fe, const float *in, int count, float *out) {
+    int written = 0;
+    for (int n = 0; n < count; n++) {
+        float i = in[2 * n], q = in[2 * n + 1];
+        if (fe->decimation > 1) {
+            i = wf_lowpass_process(&fe->lp_i, i);
+            q = wf_lowpass_process(&fe->lp_q, q);
+            if (++fe->phase < fe->decimation) continue;
+            fe->phase = 0;
+        }
+
+        /* waterfall normalize() */
+        float mag = sqrtf(i * i + q * q);
+        float alpha = (fe->warmup < 50000) ? 0.01f : 0.0001f;
+        fe->level += alpha * (mag - fe->level);
+        fe->warmup++;
+        if (fe->level < 0.0001f) fe->level = 0.0001f;
+
+        out[2 * written] = i / fe->level;
+        out[2 * written + 1] = q / fe->level;
+        written++;
+    }
+    return written;
+}
+
+/*============================================================================
+ * Input Sources
+ *============================================================================*/
+
+typedef struct {
+    iqr_reader_t *reader;
+    int16_t *xi, *xq;
+    int rate;
+    /* Synthetic */
+    long total;
+    long pos;
+    uint32_t lcg;
+    int width_ms;           /* Current second's pulse width */
+} source_t;
+
+static float noise(uint32_t *lcg, float amplitude) {
+    *lcg = *lcg * 1664525u + 1013904223u;
+    return amplitude * ((float)(*lcg >> 8) / 16777216.0f - 0.5f);
+}
+
+/*
+ * WWV-like 50 kHz baseband (carrier removed): 1000 Hz ticks and the
+ * 100 Hz subcarrier raised for 200 / 500 / 800 ms from 30 ms into each
+ * second. A steady time code never trips bcd_freq's 1 s integrator; it
+ * needs the fades of a real recording.
+ */
+static int synth_read(source_t *s, float *iq, int max) {
+    int n = 0;
+    while (n < max && s->pos < s->total) {
+        long sec = s->pos / DETECTOR_RATE;
+        long in_sec = s->pos % DETECTOR_RATE;
+        if (in_sec == 0) {
+            s->lcg = s->lcg * 1664525u + 1013904223u;
+            static const int widths[] = { 200, 500, 200, 800 };
+            s->width_ms = widths[(s->lcg >> 16) & 3];
+        }
+
+        double t = (double)s->pos / DETECTOR_RATE;
+        double ms = in_sec * 1000.0 / DETECTOR_RATE;
+        float bcd = (sec >= 2 && ms >= 30.0 && ms < 30.0 + s->width_ms) ? 0.5f : 0.08f;
+        float tick = (ms < 5.0) ? 0.5f : 0.0f;
+        double ph100 = 2.0 * PI * 100.0 * t;
+        double ph1k = 2.0 * PI * 1000.0 * t;
+
+        iq[2 * n] = bcd * (float)cos(ph100) + tick * (float)cos(ph1k) + noise(&s->lcg, 0.05f);
+        iq[2 * n + 1] = bcd * (float)sin(ph100) + tick * (float)sin(ph1k) + noise(&s->lcg, 0.05f);
+        n++;
+        s->pos++;
+    }
+    return n;
+}
+
+static int source_read(source_t *s, float *iq, int max) {
+    if (!s->reader) return synth_read(s, iq, max);
+
+    uint32_t got = 0;
+    if (iqr_read(s->reader, s->xi, s->xq, (uint32_t)max, &got) != IQR_OK) return 0;
+    for (uint32_t k = 0; k < got; k++) {
+        iq[2 * k] = s->xi[k] / 32768.0f;
+        iq[2 * k + 1] = s->xq[k] / 32768.0f;
+    }
+    return (int)got;
+}
+
+/*============================================================================
+ * Comparison
+ *============================================================================*/
+
+/* Worst differences between pulses matched by start time; false on a miss */
+static bool compare_pulses(const char *what, const pulse_log_t *a, const pulse_log_t *b,
+                           float frame_ms) {
+    float worst_start = 0.0f, worst_dur = 0.0f;
+    int matched = 0;
+
+    for (int k = 0; k < a->count; k++) {
+        int best = -1;
+        float best_diff = 1e9f;
+        for (int j = 0; j < b->count; j++) {
+            float d = fabsf(a->start_ms[k] - b->start_ms[j]);
+            if (d < best_diff) { best_diff = d; best = j; }
+        }
+        if (best < 0 || best_diff > frame_ms + 0.01f) continue;
+
+        matched++;
+        float dd = fabsf(a->duration_ms[k] - b->duration_ms[best]);
+        if (best_diff > worst_start) worst_start = best_diff;
+        if (dd > worst_dur) worst_dur = dd;
+    }
+
+    bool ok = (matched == a->count && matched == b->count && worst_dur <= frame_ms + 0.01f);
+    printf("  %-10s A=%4d  B=%4d  matched=%4d  max |d start|=%6.2f ms  max |d dur|=%6.2f ms  %s\n",
+           what, a->count, b->count, matched, worst_start, worst_dur, ok ? "OK" : "MISMATCH");
+    return ok;
+}
+
+static void report_cost(const bcd_path_t *p, double signal_sec) {
+    printf("  %-22s %8.2f ms CPU/s", p->name, 1000.0 * p->cpu_sec / signal_sec);
+#ifdef HAVE_TSC
+    printf("  %8.2f Mcycles/s", p->cycles / signal_sec / 1e6);
+#endif
+    printf("  (%.0fx real time)\n", signal_sec / p->cpu_sec);
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [options] [file.iqr]\n", prog);
+    printf("  -t <sec>   Synthetic signal length (default %d)\n", DEFAULT_SECONDS);
+    printf("  -h         Show this help\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = NULL;
+    int seconds = DEFAULT_SECONDS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            seconds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    print_version("bcd_subband_bench");
+
+    source_t src;
+    memset(&src, 0, sizeof(src));
+    src.lcg = 12345;
+    if (path) {
+        if (iqr_open(&src.reader, path) != IQR_OK) {
+            fprintf(stderr, "Cannot open %s\n", path);
+            return 1;
+        }
+        src.rate = (int)iqr_get_header(src.reader)->sample_rate_hz;
+        if (src.rate < DETECTOR_RATE || src.rate % DETECTOR_RATE != 0) {
+            fprintf(stderr, "%s: %d Hz is not a multiple of %d Hz\n", path, src.rate, DETECTOR_RATE);
+            iqr_close(src.reader);
+            return 1;
+        }
+        src.xi = (int16_t *)malloc(CHUNK_SAMPLES * sizeof(int16_t));
+        src.xq = (int16_t *)malloc(CHUNK_SAMPLES * sizeof(int16_t));
+    } else {
+        if (seconds < 5) seconds = 5;
+        src.rate = DETECTOR_RATE;
+        src.total = (long)seconds * DETECTOR_RATE;
+    }
+
+    float *in = (float *)malloc(2 * CHUNK_SAMPLES * sizeof(float));
+    float *det = (float *)malloc(2 * CHUNK_SAMPLES * sizeof(float));
+    bcd_path_t a, b;
+    bool ready = in && det && (!path || (src.xi && src.xq));
+    ready = ready && path_init(&a, "A: 50 kHz", 1);
+    ready = ready && path_init(&b, "B: subband /32", SUBBAND_DECIMATION);
+    if (!ready) {
+        fprintf(stderr, "Setup failed\n");
+        return 1;
+    }
+
+    front_end_t fe;
+    front_end_init(&fe, src.rate);
+
+    long det_samples = 0;
+    int got;
+    while ((got = source_read(&src, in, CHUNK_SAMPLES)) > 0) {
+        int n = front_end_process(&fe, in, got, det);
+        path_run(&a, det, n);
+        path_run(&b, det, n);
+        det_samples += n;
+    }
+    double signal_sec = (double)det_samples / DETECTOR_RATE;
+
+    printf("\n=== BCD SUBBAND A/B (%s, %.1f s of signal) ===\n",
+           path ? path : "synthetic", signal_sec);
+    printf("Pulses (matched within one frame):\n");
+    bool ok = compare_pulses("bcd_time", &a.time_pulses, &b.time_pulses,
+                             bcd_time_detector_get_frame_ms(a.time_det));
+    ok = compare_pulses("bcd_freq", &a.freq_pulses, &b.freq_pulses,
+                        bcd_freq_detector_get_frame_ms(a.freq_det)) && ok;
+
+    printf("Cost per second of signal (channel filter + both detectors):\n");
+    if (signal_sec > 0.0) {
+        report_cost(&a, signal_sec);
+        report_cost(&b, signal_sec);
+        printf("  Speedup: %.1fx\n", a.cpu_sec / b.cpu_sec);
+    }
+
+    path_free(&a);
+    path_free(&b);
+    free(in);
+    free(det);
+    free(src.xi);
+    free(src.xq);
+    if (src.reader) iqr_close(src.reader);
+    return ok ? 0 : 2;
+}
@@ -18,6 +18,7 @@
 #include "bcd_time_detector.h"
 #include "waterfall_telemetry.h"
 #include "kiss_fft.h"
+#include "detector_rate.h"
 #include "version.h"
 #include <stdlib.h>
 #include <string.h>
@@ -28,9 +29,6 @@
  * Internal Configuration
  *============================================================================*/
 
-#define FRAME_DURATION_MS   ((float)BCD_TIME_FFT_SIZE * 1000.0f / BCD_TIME_SAMPLE_RATE)
-#define HZ_PER_BIN          ((float)BCD_TIME_SAMPLE_RATE / BCD_TIME_FFT_SIZE)
-
 /* Detection timing */
 #define BCD_TIME_COOLDOWN_MS        200.0f  /* Prevent retriggering */
 
@@ -42,8 +40,6 @@
 #define BCD_TIME_WARMUP_ADAPT_RATE  0.05f
 #define BCD_TIME_WARMUP_FRAMES      50
 
-#define MS_TO_FRAMES(ms)    ((int)((ms) / FRAME_DURATION_MS + 0.5f))
-
 #ifndef M_PI
 #define M_PI 3.14159265358979323846f
 #endif
@@ -59,6 +55,11 @@ typedef enum {
 } detector_state_t;
 
 struct bcd_time_detector {
+    /* Input rate profile (fixed at create) */
+    detector_rate_t rate;
+    int center_bin;             /* BCD_TIME_TARGET_FREQ_HZ bin */
+    int bin_span;               /* +/- bins for BCD_TIME_BANDWIDTH_HZ */
+
     /* FFT resources */
     kiss_fft_cfg fft_cfg;
     kiss_fft_cpx *fft_in;
@@ -97,6 +98,7 @@ struct bcd_time_detector {
 
     /* Enabled flag */
     bool detection_enabled;
+    bool hold;                      /* Noise floor frozen */
 
     /* Callback */
     bcd_time_callback_fn callback;
@@ -118,30 +120,7 @@ struct bcd_time_detector {
  * For 100 Hz, we need bin 0-1 area (coarse resolution)
  */
 static float calculate_bucket_energy(bcd_time_detector_t *td) {
-    int center_bin = (int)(BCD_TIME_TARGET_FREQ_HZ / HZ_PER_BIN + 0.5f);
-    int bin_span = (int)(BCD_TIME_BANDWIDTH_HZ / HZ_PER_BIN + 0.5f);
-    if (bin_span < 1) bin_span = 1;
-
-    float pos_energy = 0.0f;
-    float neg_energy = 0.0f;
-
-    for (int b = -bin_span; b <= bin_span; b++) {
-        int pos_bin = center_bin + b;
-        int neg_bin = BCD_TIME_FFT_SIZE - center_bin + b;
-
-        if (pos_bin >= 0 && pos_bin < BCD_TIME_FFT_SIZE) {
-            float re = td->fft_out[pos_bin].r;
-            float im = td->fft_out[pos_bin].i;
-            pos_energy += sqrtf(re * re + im * im) / BCD_TIME_FFT_SIZE;
-        }
-        if (neg_bin >= 0 && neg_bin < BCD_TIME_FFT_SIZE) {
-            float re = td->fft_out[neg_bin].r;
-            float im = td->fft_out[neg_bin].i;
-            neg_energy += sqrtf(re * re + im * im) / BCD_TIME_FFT_SIZE;
-        }
-    }
-
-    return pos_energy + neg_energy;
+    return detector_rate_bucket_energy(&td->rate, td->fft_out, td->center_bin, td->bin_span);
 }
 
 /**
@@ -159,7 +138,7 @@ static void run_state_machine(bcd_time_detector_t *td) {
 
     /* Warmup phase - fast adaptation to establish baseline */
     if (!td->warmup_complete) {
-        td->noise_floor += BCD_TIME_WARMUP_ADAPT_RATE * (energy - td->noise_floor);
+        if (!td->hold) td->noise_floor += BCD_TIME_WARMUP_ADAPT_RATE * (energy - td->noise_floor);
         if (td->noise_floor < NOISE_FLOOR_MIN) td->noise_floor = NOISE_FLOOR_MIN;
         td->threshold_high = td->noise_floor * BCD_TIME_THRESHOLD_MULT;
         td->threshold_low = td->threshold_high * BCD_TIME_HYSTERESIS_RATIO;
@@ -173,7 +152,7 @@ static void run_state_machine(bcd_time_detector_t *td) {
     }
 
     /* Adaptive noise floor - asymmetric: fast down, slow up */
-    if (td->state == STATE_IDLE && energy < td->threshold_high) {
+    if (td->state == STATE_IDLE && energy < td->threshold_high && !td->hold) {
         if (energy < td->noise_floor) {
             td->noise_floor += BCD_TIME_NOISE_ADAPT_DOWN * (energy - td->noise_floor);
         } else {
@@ -212,8 +191,8 @@ static void run_state_machine(bcd_time_detector_t *td) {
 
             if (td->consecutive_low_frames >= MIN_LOW_FRAMES) {
                 /* Pulse ended - check validity */
-                float duration_ms = td->pulse_duration_frames * FRAME_DURATION_MS;
-                float timestamp_ms = td->pulse_start_frame * FRAME_DURATION_MS;
+                float duration_ms = td->pulse_duration_frames * td->rate.frame_ms;
+                float timestamp_ms = td->pulse_start_frame * td->rate.frame_ms;
                 float snr_db = 10.0f * log10f(td->pulse_peak_energy / td->noise_floor);
 
                 if (duration_ms >= BCD_TIME_PULSE_MIN_MS &&
@@ -267,7 +246,7 @@ static void run_state_machine(bcd_time_detector_t *td) {
                 }
 
                 td->state = STATE_COOLDOWN;
-                td->cooldown_frames = MS_TO_FRAMES(BCD_TIME_COOLDOWN_MS);
+                td->cooldown_frames = detector_rate_frames(&td->rate, BCD_TIME_COOLDOWN_MS);
             }
             break;
 
@@ -284,21 +263,41 @@ static void run_state_machine(bcd_time_detector_t *td) {
  *============================================================================*/
 
 bcd_time_detector_t *bcd_time_detector_create(const char *csv_path) {
+    return bcd_time_detector_create_rate(csv_path, BCD_TIME_SAMPLE_RATE);
+}
+
+bcd_time_detector_t *bcd_time_detector_create_rate(const char *csv_path, int sample_rate) {
+    return bcd_time_detector_create_subband(csv_path, sample_rate, 1);
+}
+
+bcd_time_detector_t *bcd_time_detector_create_subband(const char *csv_path, int sample_rate,
+                                                      int decimation) {
     bcd_time_detector_t *td = (bcd_time_detector_t *)calloc(1, sizeof(bcd_time_detector_t));
     if (!td) return NULL;
 
+    /* Derive FFT size and bins from the input rate */
+    if (!detector_rate_init(&td->rate, sample_rate, BCD_TIME_SAMPLE_RATE, BCD_TIME_FFT_SIZE) ||
+        !detector_rate_decimate(&td->rate, decimation)) {
+        free(td);
+        return NULL;
+    }
+    int fft_size = td->rate.fft_size;
+    td->center_bin = detector_rate_bin(&td->rate, BCD_TIME_TARGET_FREQ_HZ);
+    td->bin_span = detector_rate_bin(&td->rate, BCD_TIME_BANDWIDTH_HZ);
+    if (td->bin_span < 1) td->bin_span = 1;
+
     /* Allocate FFT */
-    td->fft_cfg = kiss_fft_alloc(BCD_TIME_FFT_SIZE, 0, NULL, NULL);
+    td->fft_cfg = kiss_fft_alloc(fft_size, 0, NULL, NULL);
     if (!td->fft_cfg) {
         free(td);
         return NULL;
     }
 
-    td->fft_in = (kiss_fft_cpx *)malloc(BCD_TIME_FFT_SIZE * sizeof(kiss_fft_cpx));
-    td->fft_out = (kiss_fft_cpx *)malloc(BCD_TIME_FFT_SIZE * sizeof(kiss_fft_cpx));
-    td->window_func = (float *)malloc(BCD_TIME_FFT_SIZE * sizeof(float));
-    td->i_buffer = (float *)malloc(BCD_TIME_FFT_SIZE * sizeof(float));
-    td->q_buffer = (float *)malloc(BCD_TIME_FFT_SIZE * sizeof(float));
+    td->fft_in = (kiss_fft_cpx *)malloc(fft_size * sizeof(kiss_fft_cpx));
+    td->fft_out = (kiss_fft_cpx *)malloc(fft_size * sizeof(kiss_fft_cpx));
+    td->window_func = (float *)malloc(fft_size * sizeof(float));
+    td->i_buffer = (float *)malloc(fft_size * sizeof(float));
+    td->q_buffer = (float *)malloc(fft_size * sizeof(float));
 
     if (!td->fft_in || !td->fft_out || !td->window_func ||
         !td->i_buffer || !td->q_buffer) {
@@ -306,14 +305,16 @@ bcd_time_detector_t *bcd_time_detector_create(const char *csv_path) {
         return NULL;
     }
 
-    /* Initialize Hann window */
-    for (int i = 0; i < BCD_TIME_FFT_SIZE; i++) {
-        td->window_func[i] = 0.5f * (1.0f - cosf(2.0f * M_PI * i / (BCD_TIME_FFT_SIZE - 1)));
+    /* Initialize Hann window (full-rate window at the samples kept) */
+    int full_size = fft_size * td->rate.decimation;
+    for (int i = 0; i < fft_size; i++) {
+        int n = i * td->rate.decimation;
+        td->window_func[i] = 0.5f * (1.0f - cosf(2.0f * M_PI * n / (full_size - 1)));
     }
 
     /* Initialize buffers */
-    memset(td->i_buffer, 0, BCD_TIME_FFT_SIZE * sizeof(float));
-    memset(td->q_buffer, 0, BCD_TIME_FFT_SIZE * sizeof(float));
+    memset(td->i_buffer, 0, fft_size * sizeof(float));
+    memset(td->q_buffer, 0, fft_size * sizeof(float));
     td->buffer_idx = 0;
 
     /* Initialize state */
@@ -335,16 +336,20 @@ bcd_time_detector_t *bcd_time_detector_create(const char *csv_path) {
             fprintf(td->csv_file, "# Phoenix SDR BCD Time Detector Log v%s\n", PHOENIX_VERSION_FULL);
             fprintf(td->csv_file, "# Started: %s\n", time_str);
             fprintf(td->csv_file, "# FFT: %d (%.2fms), Target: %dHz ±%dHz\n",
-                    BCD_TIME_FFT_SIZE, FRAME_DURATION_MS,
+                    fft_size, td->rate.frame_ms,
                     BCD_TIME_TARGET_FREQ_HZ, BCD_TIME_BANDWIDTH_HZ);
             fprintf(td->csv_file, "time,timestamp_ms,pulse_num,peak_energy,duration_ms,noise_floor,snr_db\n");
             fflush(td->csv_file);
         }
     }
 
-    printf("[BCD_TIME] Detector created: FFT=%d (%.2fms), Target=%dHz ±%dHz\n",
-           BCD_TIME_FFT_SIZE, FRAME_DURATION_MS,
+    printf("[BCD_TIME] Detector created: %dHz, FFT=%d (%.2fms), Target=%dHz ±%dHz\n",
+           td->rate.sample_rate, fft_size, td->rate.frame_ms,
            BCD_TIME_TARGET_FREQ_HZ, BCD_TIME_BANDWIDTH_HZ);
+    if (td->rate.decimation > 1) {
+        printf("[BCD_TIME] Subband input: every %dth sample (%.2fHz)\n",
+               td->rate.decimation, (float)td->rate.sample_rate / td->rate.decimation);
+    }
 
     return td;
 }
@@ -381,7 +386,7 @@ bool bcd_time_detector_process_sample(bcd_time_detector_t *td,
     td->buffer_idx++;
 
     /* Not enough samples yet */
-    if (td->buffer_idx < BCD_TIME_FFT_SIZE) {
+    if (td->buffer_idx < td->rate.fft_size) {
         return false;
     }
 
@@ -389,7 +394,7 @@ bool bcd_time_detector_process_sample(bcd_time_detector_t *td,
     td->buffer_idx = 0;
 
     /* Apply window and load FFT input */
-    for (int i = 0; i < BCD_TIME_FFT_SIZE; i++) {
+    for (int i = 0; i < td->rate.fft_size; i++) {
         td->fft_in[i].r = td->i_buffer[i] * td->window_func[i];
         td->fft_in[i].i = td->q_buffer[i] * td->window_func[i];
     }
@@ -412,6 +417,10 @@ void bcd_time_detector_set_enabled(bcd_time_detector_t *td, bool enabled) {
     if (td) td->detection_enabled = enabled;
 }
 
+void bcd_time_detector_set_hold(bcd_time_detector_t *td, bool hold) {
+    if (td) td->hold = hold;
+}
+
 bool bcd_time_detector_get_enabled(bcd_time_detector_t *td) {
     return td ? td->detection_enabled : false;
 }
@@ -435,11 +444,11 @@ int bcd_time_detector_get_pulse_count(bcd_time_detector_t *td) {
 void bcd_time_detector_print_stats(bcd_time_detector_t *td) {
     if (!td) return;
 
-    float elapsed = td->frame_count * FRAME_DURATION_MS / 1000.0f;
+    float elapsed = td->frame_count * td->rate.frame_ms / 1000.0f;
 
     printf("\n=== BCD TIME DETECTOR STATS ===\n");
     printf("FFT: %d (%.2fms), Target: %d Hz ±%d Hz\n",
-           BCD_TIME_FFT_SIZE, FRAME_DURATION_MS,
+           td->rate.fft_size, td->rate.frame_ms,
            BCD_TIME_TARGET_FREQ_HZ, BCD_TIME_BANDWIDTH_HZ);
     printf("Elapsed: %.1fs  Detected: %d  Rejected: %d\n",
            elapsed, td->pulses_detected, td->pulses_rejected);
@@ -449,5 +458,13 @@ void bcd_time_detector_print_stats(bcd_time_detector_t *td) {
 }
 
 float bcd_time_detector_get_frame_duration_ms(void) {
-    return FRAME_DURATION_MS;
+    return (float)BCD_TIME_FFT_SIZE * 1000.0f / BCD_TIME_SAMPLE_RATE;
+}
+
+float bcd_time_detector_get_frame_ms(bcd_time_detector_t *td) {
+    return td ? td->rate.frame_ms : bcd_time_detector_get_frame_duration_ms();
+}
+
+int bcd_time_detector_get_sample_rate(bcd_time_detector_t *td) {
+    return td ? td->rate.sample_rate : BCD_TIME_SAMPLE_RATE;
 }
@@ -31,7 +31,7 @@ extern "C" {
  *============================================================================*/
 
 #define BCD_TIME_FFT_SIZE           256     /* 5.12ms frames at 50kHz */
-#define BCD_TIME_SAMPLE_RATE        50000   /* Input sample rate (2MHz/40) */
+#define BCD_TIME_SAMPLE_RATE        50000   /* Default input sample rate (2MHz/40) */
 #define BCD_TIME_TARGET_FREQ_HZ     100     /* BCD subcarrier frequency */
 #define BCD_TIME_BANDWIDTH_HZ       50      /* Wider bucket for coarse resolution */
 
@@ -74,6 +74,26 @@ typedef void (*bcd_time_callback_fn)(const bcd_time_event_t *event, void *user_d
  */
 bcd_time_detector_t *bcd_time_detector_create(const char *csv_path);
 
+/**
+ * Create a detector for a given input rate (FFT scaled to keep the frame length)
+ * @param csv_path     Path for CSV log file (NULL to disable logging)
+ * @param sample_rate  Input rate in Hz (DETECTOR_RATE_MIN..MAX)
+ * @return             Detector instance or NULL on failure / bad rate
+ */
+bcd_time_detector_t *bcd_time_detector_create_rate(const char *csv_path, int sample_rate);
+
+/**
+ * Create a detector fed every decimation-th sample of a band-limited
+ * channel (fft_filter_bank band with that decimation). Frames, bins and
+ * timestamps match create_rate(sample_rate); the FFT is decimation times
+ * shorter (256 -> 8 points at 32).
+ * @param sample_rate  Full channel rate in Hz
+ * @param decimation   Power of two dividing the full-rate FFT size
+ * @return             Detector instance or NULL on failure / bad rate
+ */
+bcd_time_detector_t *bcd_time_detector_create_subband(const char *csv_path, int sample_rate,
+                                                      int decimation);
+
 /**
  * Destroy a BCD time-domain detector instance
  */
@@ -107,6 +127,12 @@ bool bcd_time_detector_process_sample(bcd_time_detector_t *td,
 void bcd_time_detector_set_enabled(bcd_time_detector_t *td, bool enabled);
 bool bcd_time_detector_get_enabled(bcd_time_detector_t *td);
 
+/**
+ * Hold the noise floor (blanked or settling input upstream)
+ * While set, the floor and thresholds stay put; detection still runs.
+ */
+void bcd_time_detector_set_hold(bcd_time_detector_t *td, bool hold);
+
 /**
  * Get current state for display/debug
  */
@@ -121,9 +147,11 @@ int bcd_time_detector_get_pulse_count(bcd_time_detector_t *td);
 void bcd_time_detector_print_stats(bcd_time_detector_t *td);
 
 /**
- * Get timing info
+ * Get timing info (default rate / this instance)
  */
 float bcd_time_detector_get_frame_duration_ms(void);
+float bcd_time_detector_get_frame_ms(bcd_time_detector_t *td);
+int bcd_time_detector_get_sample_rate(bcd_time_detector_t *td);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,167 @@
+/**
+ * @file block_normalizer.c
+ * @brief Block slow AGC implementation
+ *
+ * One chunk of n samples replaces n steps of
+ *
+ *   level += alpha * (|x[k]| - level)
+ *
+ * with the closed form
+ *
+ *   level' = (1 - alpha)^n * level + alpha * sum_k (1 - alpha)^(n-1-k) |x[k]|
+ *
+ * so the only serial work left is one multiply-add per chunk. Chunks never
+ * straddle the end of warmup, where alpha changes.
+ */
+
+#include "block_normalizer.h"
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9)
+#define BLOCK_NORM_USE_VECTOR 1
+typedef float bn_vec_t __attribute__((vector_size(16)));
+typedef int32_t bn_ivec_t __attribute__((vector_size(16)));
+#endif
+
+#define RSQRT_MAGIC     0x5f375a86      /* Lomont's constant */
+#define LANES           4
+
+/*============================================================================
+ * Magnitude
+ *============================================================================*/
+
+/* sqrt(p) as p / sqrt(p); p = 0 gives 0 */
+static inline float approx_sqrt(float p) {
+    int32_t bits;
+    memcpy(&bits, &p, sizeof(bits));
+    bits = RSQRT_MAGIC - (bits >> 1);
+    float y;
+    memcpy(&y, &bits, sizeof(y));
+    y = y * (1.5f - 0.5f * p * y * y);
+    return p * y;
+}
+
+/* mag[k] = |iq[k]| for n pairs */
+static void magnitudes(const float *iq, float *mag, int n) {
+    for (int k = 0; k < n; k++) {
+        mag[k] = iq[2 * k] * iq[2 * k] + iq[2 * k + 1] * iq[2 * k + 1];
+    }
+
+    int k = 0;
+#if defined(BLOCK_NORM_USE_VECTOR)
+    const bn_vec_t half = { 0.5f, 0.5f, 0.5f, 0.5f };
+    const bn_vec_t three_halves = { 1.5f, 1.5f, 1.5f, 1.5f };
+    const bn_ivec_t magic = { RSQRT_MAGIC, RSQRT_MAGIC, RSQRT_MAGIC, RSQRT_MAGIC };
+    for (; k + LANES <= n; k += LANES) {
+        bn_vec_t p;
+        memcpy(&p, mag + k, sizeof(p));
+        bn_vec_t y = (bn_vec_t)(magic - ((bn_ivec_t)p >> 1));
+        y = y * (three_halves - half * p * y * y);
+        p = p * y;
+        memcpy(mag + k, &p, sizeof(p));
+    }
+#endif
+    for (; k < n; k++) mag[k] = approx_sqrt(mag[k]);
+}
+
+static float weighted_sum(const float *w, const float *x, int n) {
+    int k = 0;
+    float sum = 0.0f;
+#if defined(BLOCK_NORM_USE_VECTOR)
+    bn_vec_t acc = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (; k + LANES <= n; k += LANES) {
+        bn_vec_t vw, vx;
+        memcpy(&vw, w + k, sizeof(vw));
+        memcpy(&vx, x + k, sizeof(vx));
+        acc += vw * vx;
+    }
+    sum = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+    for (; k < n; k++) sum += w[k] * x[k];
+    return sum;
+}
+
+/*============================================================================
+ * Public API
+ *============================================================================*/
+
+void block_normalizer_init(block_normalizer_t *bn) {
+    const float alpha[2] = { BLOCK_NORM_ALPHA_WARMUP, BLOCK_NORM_ALPHA };
+
+    for (int p = 0; p < 2; p++) {
+        double beta = 1.0 - alpha[p];
+        double power = 1.0;
+        for (int k = 0; k <= BLOCK_NORM_CHUNK; k++) {
+            bn->decay[p][k] = (float)power;
+            if (k < BLOCK_NORM_CHUNK) bn->weights[p][BLOCK_NORM_CHUNK - 1 - k] = (float)power;
+            power *= beta;
+        }
+    }
+    block_normalizer_reset(bn);
+}
+
+void block_normalizer_reset(block_normalizer_t *bn) {
+    bn->level = BLOCK_NORM_INITIAL_LEVEL;
+    bn->gain = 1.0f / bn->level;
+    bn->warmup = 0;
+}
+
+void block_normalizer_process(block_normalizer_t *bn, float *iq, int count) {
+    float mag[BLOCK_NORM_CHUNK];
+
+    for (int pos = 0; pos < count; ) {
+        bool warming = bn->warmup < BLOCK_NORM_WARMUP_SAMPLES;
+        int p = warming ? 0 : 1;
+        int n = (count - pos < BLOCK_NORM_CHUNK) ? count - pos : BLOCK_NORM_CHUNK;
+        if (warming && n > BLOCK_NORM_WARMUP_SAMPLES - bn->warmup) {
+            n = BLOCK_NORM_WARMUP_SAMPLES - bn->warmup;
+        }
+        float *x = iq + 2 * pos;
+
+        magnitudes(x, mag, n);
+        float alpha = warming ? BLOCK_NORM_ALPHA_WARMUP : BLOCK_NORM_ALPHA;
+        float sum = weighted_sum(bn->weights[p] + BLOCK_NORM_CHUNK - n, mag, n);
+        float level = bn->decay[p][n] * bn->level + alpha * sum;
+        if (level < BLOCK_NORM_MIN_LEVEL) level = BLOCK_NORM_MIN_LEVEL;
+
+        /* Gain ramp: sample k gets g0 + (g1 - g0) * (k + 1) / n */
+        float g1 = 1.0f / level;
+        float step = (g1 - bn->gain) / n;
+        for (int k = 0; k < n; k++) {
+            float g = bn->gain + step * (k + 1);
+            x[2 * k] *= g;
+            x[2 * k + 1] *= g;
+        }
+
+        bn->level = level;
+        bn->gain = g1;
+        if (warming) bn->warmup += n;
+        pos += n;
+    }
+}
+
+void block_normalizer_hold(const block_normalizer_t *bn, float *iq, int count) {
+    for (int k = 0; k < 2 * count; k++) iq[k] *= bn->gain;
+}
+
+float block_normalizer_level(const block_normalizer_t *bn) {
+    return bn->level;
+}
+
+void block_normalizer_process_per_sample(block_normalizer_t *bn, float *iq, int count) {
+    for (int k = 0; k < count; k++) {
+        float i = iq[2 * k], q = iq[2 * k + 1];
+        float mag = sqrtf(i * i + q * q);
+        float alpha = (bn->warmup < BLOCK_NORM_WARMUP_SAMPLES) ? BLOCK_NORM_ALPHA_WARMUP
+                                                                : BLOCK_NORM_ALPHA;
+        bn->level += alpha * (mag - bn->level);
+        if (bn->warmup < BLOCK_NORM_WARMUP_SAMPLES) bn->warmup++;
+        if (bn->level < BLOCK_NORM_MIN_LEVEL) bn->level = BLOCK_NORM_MIN_LEVEL;
+
+        bn->gain = 1.0f / bn->level;
+        iq[2 * k] = i * bn->gain;
+        iq[2 * k + 1] = q * bn->gain;
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ * @file block_normalizer.h
+ * @brief Block slow AGC for the waterfall detector path
+ *
+ * Same level tracker as the old per-sample normalize() - a one-pole
+ * average of |x| with a fast warmup (alpha 0.01 for 50000 samples, then
+ * 0.0001) - run over buffers:
+ *
+ *   |x|     magnitude-squared times an approximate 1/sqrt (bit estimate
+ *           plus one Newton step, ~0.2% worst case), four lanes at a time
+ *   level   the one-pole recursion over a chunk folded into one weighted
+ *           sum against a table of (1 - alpha)^k
+ *   gain    ramped linearly from the previous chunk's 1/level to this
+ *           one's, so a level step never shows up as a gain step
+ *
+ * Chunks are BLOCK_NORM_CHUNK samples; the level floor is applied per
+ * chunk. Held (blanked / settling) samples get the current gain without
+ * moving the level.
+ */
+
+#ifndef BLOCK_NORMALIZER_H
+#define BLOCK_NORMALIZER_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define BLOCK_NORM_CHUNK            64          /* Samples per level update */
+#define BLOCK_NORM_INITIAL_LEVEL    0.01f
+#define BLOCK_NORM_MIN_LEVEL        0.0001f
+#define BLOCK_NORM_WARMUP_SAMPLES   50000       /* 1 s at 50 kHz */
+#define BLOCK_NORM_ALPHA_WARMUP     0.01f
+#define BLOCK_NORM_ALPHA            0.0001f
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct {
+    float level;
+    float gain;                 /* 1 / level at the end of the last chunk */
+    int warmup;                 /* Samples tracked, up to BLOCK_NORM_WARMUP_SAMPLES */
+
+    /* weights[p][BLOCK_NORM_CHUNK - 1 - k] = (1 - alpha)^k, p = warmup / steady;
+     * decay[p][n] = (1 - alpha)^n */
+    float weights[2][BLOCK_NORM_CHUNK];
+    float decay[2][BLOCK_NORM_CHUNK + 1];
+} block_normalizer_t;
+
+/*============================================================================
+ * Public API
+ *============================================================================*/
+
+void block_normalizer_init(block_normalizer_t *bn);
+
+/** Back to the initial level and warmup (call on reconnect) */
+void block_normalizer_reset(block_normalizer_t *bn);
+
+/**
+ * Track the level over count interleaved I/Q pairs and scale them in place
+ */
+void block_normalizer_process(block_normalizer_t *bn, float *iq, int count);
+
+/** Scale by the current gain without tracking (held input) */
+void block_normalizer_hold(const block_normalizer_t *bn, float *iq, int count);
+
+/** Current level (average |x|) */
+float block_normalizer_level(const block_normalizer_t *bn);
+
+/**
+ * The original per-sample normalize(): exact sqrtf, level and gain
+ * updated every sample. Reference for tests and benchmarks; shares the
+ * level and warmup with the block path.
+ */
+void block_normalizer_process_per_sample(block_normalizer_t *bn, float *iq, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLOCK_NORMALIZER_H */
@@ -0,0 +1,327 @@
+/**
+ * @file cmd_bench.c
+ * @brief Command parser throughput: cmd_table vs. the sscanf/strcmp chain
+ *
+ * Replays a command corpus through
+ *
+ *   table    cmd_table_parse(): in-place tokenize, perfect-hash lookup,
+ *            typed argument checks (what waterfall and sdr_server run)
+ *   legacy   sscanf("%63s %f") plus a linear case-insensitive strcmp scan,
+ *            the way waterfall's UDP handler parsed before
+ *
+ * and reports commands per second for each and how often they disagree.
+ * The corpus is a recorded file - one command per line, or a telem_logger
+ * CTRL channel log ("CTRL,<command>" lines, '#' comments skipped) - or, by
+ * default, a synthetic parameter sweep.
+ *
+ * Usage:
+ *   cmd_bench                         # 200000-line synthetic sweep
+ *   cmd_bench -f logs/CTRL.csv -n 50  # Replay a recorded session 50 times
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <ctype.h>
+
+#include "cmd_table.h"
+#include "version.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define DEFAULT_LINES       200000
+#define DEFAULT_PASSES      20
+#define MAX_LINE            512         /* waterfall CMD_MAX_LEN */
+
+static double now_sec(void) {
+#ifdef _WIN32
+    LARGE_INTEGER f, c;
+    QueryPerformanceFrequency(&f);
+    QueryPerformanceCounter(&c);
+    return (double)c.QuadPart / (double)f.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+/*============================================================================
+ * Grammar (waterfall UDP commands plus the sdr_server set)
+ *============================================================================*/
+
+static const char *const g_channels[] = { "TICK", "MARK", "SYNC", "CORR", "CONS", NULL };
+static const char *const g_on_off[] = { "ON", "OFF", NULL };
+
+#define SET_F(name)     { name, 0, 1, 1, { CMD_SPEC_FLOAT(0, 0) }, NULL }
+#define SET_I(name)     { name, 0, 1, 1, { CMD_SPEC_INT(0, 0) }, NULL }
+#define GET(name)       { name, 0, 0, 0, { CMD_SPEC_NO_ARGS }, NULL }
+
+static const cmd_spec_t g_specs[] = {
+    { "ENABLE_TELEM", 0, 1, 1, { CMD_SPEC_CHOICE(g_channels) }, NULL },
+    { "DISABLE_TELEM", 0, 1, 1, { CMD_SPEC_CHOICE(g_channels) }, NULL },
+    SET_F("SET_TICK_THRESHOLD"), SET_F("SET_TICK_ADAPT_DOWN"), SET_F("SET_TICK_ADAPT_UP"),
+    SET_F("SET_TICK_MIN_DURATION"), SET_F("SET_CORR_CONFIDENCE"), SET_I("SET_CORR_MAX_MISSES"),
+    SET_F("SET_MARKER_THRESHOLD"), SET_F("SET_MARKER_ADAPT_RATE"), SET_F("SET_MARKER_MIN_DURATION"),
+    SET_F("SET_SYNC_WEIGHT_TICK"), SET_F("SET_SYNC_WEIGHT_MARKER"), SET_F("SET_SYNC_WEIGHT_P_MARKER"),
+    SET_F("SET_SYNC_WEIGHT_TICK_HOLE"), SET_F("SET_SYNC_WEIGHT_COMBINED"),
+    SET_F("SET_SYNC_LOCKED_THRESHOLD"), SET_F("SET_SYNC_MIN_RETAIN"), SET_F("SET_SYNC_TENTATIVE_INIT"),
+    SET_F("SET_SYNC_DECAY_NORMAL"), SET_F("SET_SYNC_DECAY_RECOVERING"),
+    SET_F("SET_SYNC_TICK_TOLERANCE"), SET_F("SET_SYNC_MARKER_TOLERANCE"),
+    SET_F("SET_SYNC_P_MARKER_TOLERANCE"),
+    SET_F("SET_FREQ"), GET("GET_FREQ"), SET_I("SET_GAIN"), GET("GET_GAIN"), SET_I("SET_LNA"),
+    GET("GET_LNA"), SET_I("SET_SRATE"), GET("GET_SRATE"),
+    { "SET_NOTCH", 0, 1, 1, { CMD_SPEC_CHOICE(g_on_off) }, NULL },
+    GET("STATUS"), GET("PING"), GET("VER"), GET("START"), GET("STOP"),
+};
+
+#define NUM_SPECS ((int)(sizeof(g_specs) / sizeof(g_specs[0])))
+
+/*============================================================================
+ * Legacy Parser
+ *============================================================================*/
+
+static int strcasecmp_local(const char *a, const char *b) {
+    while (*a && *b) {
+        int ca = toupper((unsigned char)*a);
+        int cb = toupper((unsigned char)*b);
+        if (ca != cb) return ca - cb;
+        a++;
+        b++;
+    }
+    return toupper((unsigned char)*a) - toupper((unsigned char)*b);
+}
+
+/* Spec index, or -1 for unknown / missing value */
+static int legacy_parse(char *line) {
+    char *nl = strchr(line, '\n');
+    if (nl) *nl = '\0';
+    char *cr = strchr(line, '\r');
+    if (cr) *cr = '\0';
+
+    char name[64];
+    float value;
+    int parsed = sscanf(line, "%63s %f", name, &value);
+    if (parsed < 1) return -1;
+
+    for (int i = 0; i < NUM_SPECS; i++) {
+        if (strcasecmp_local(name, g_specs[i].name) == 0) {
+            if (g_specs[i].min_args > 0 && g_specs[i].args[0].type != CMD_ARG_WORD && parsed < 2) {
+                return -1;
+            }
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*============================================================================
+ * Corpus
+ *============================================================================*/
+
+typedef struct {
+    char *text;             /* All lines, NUL-separated */
+    size_t *offset;
+    int count;
+} corpus_t;
+
+static uint32_t g_lcg = 12345;
+
+static uint32_t rnd(uint32_t n) {
+    g_lcg = g_lcg * 1664525u + 1013904223u;
+    return (g_lcg >> 8) % n;
+}
+
+/* Optimizer-style sweep: mostly SETs, some telemetry/status, a few bad lines */
+static bool corpus_synthetic(corpus_t *c, int lines) {
+    c->text = (char *)malloc((size_t)lines * 64);
+    c->offset = (size_t *)malloc((size_t)lines * sizeof(size_t));
+    if (!c->text || !c->offset) return false;
+
+    size_t pos = 0;
+    for (int k = 0; k < lines; k++) {
+        uint32_t r = rnd(100);
+        const cmd_spec_t *s = &g_specs[2 + rnd(22)];
+        char *out = c->text + pos;
+        int n;
+        if (r < 88) {
+            n = (s->args[0].type == CMD_ARG_INT)
+                ? sprintf(out, "%s %u\n", s->name, rnd(20))
+                : sprintf(out, "%s %.4f\n", s->name, rnd(100000) / 10000.0);
+        } else if (r < 92) {
+            n = sprintf(out, "%s %s\n", rnd(2) ? "ENABLE_TELEM" : "DISABLE_TELEM", g_channels[rnd(5)]);
+        } else if (r < 97) {
+            const char *plain[] = { "STATUS", "PING", "GET_FREQ", "SET_FREQ 15000000", "SET_GAIN 40" };
+            n = sprintf(out, "%s\r\n", plain[rnd(5)]);
+        } else {
+            const char *bad[] = { "SET_TICK_THRESHOLD", "SET_TICKS_THRESHOLD 2.0", "", "SET_FREQ abc" };
+            n = sprintf(out, "%s\n", bad[rnd(4)]);
+        }
+        c->offset[k] = pos;
+        pos += (size_t)n + 1;
+    }
+    c->count = lines;
+    return true;
+}
+
+static bool corpus_load(corpus_t *c, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size <= 0) {
+        fclose(f);
+        return false;
+    }
+
+    c->text = (char *)malloc((size_t)size + 1);
+    c->offset = (size_t *)malloc(((size_t)size / 2 + 1) * sizeof(size_t));
+    if (!c->text || !c->offset || fread(c->text, 1, (size_t)size, f) != (size_t)size) {
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+    c->text[size] = '\0';
+
+    /* Split into lines; keep commands only */
+    c->count = 0;
+    char *p = c->text;
+    while (*p) {
+        char *line = p;
+        char *nl = strchr(p, '\n');
+        if (nl) {
+            *nl = '\0';
+            p = nl + 1;
+        } else {
+            p += strlen(p);
+        }
+        if (strncmp(line, "CTRL,", 5) == 0) line += 5;
+        if (line[0] == '#' || line[0] == '\0' || line[0] == '\r') continue;
+        if (strlen(line) >= MAX_LINE) continue;
+        c->offset[c->count++] = (size_t)(line - c->text);
+    }
+    return c->count > 0;
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  -f FILE      Command corpus (one per line, or telem_logger CTRL log)\n");
+    printf("  -l LINES     Synthetic corpus size (default: %d)\n", DEFAULT_LINES);
+    printf("  -n PASSES    Passes over the corpus (default: %d)\n", DEFAULT_PASSES);
+    printf("  -h, --help   Show this help\n");
+}
+
+int main(int argc, char *argv[]) {
+    print_version("Phoenix SDR - Command Parser Benchmark");
+
+    const char *path = NULL;
+    int lines = DEFAULT_LINES;
+    int passes = DEFAULT_PASSES;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            lines = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (lines <= 0 || passes <= 0) {
+        fprintf(stderr, "Corpus size out of range\n");
+        return 1;
+    }
+
+    cmd_table_t table;
+    if (!cmd_table_build(&table, g_specs, NUM_SPECS)) {
+        fprintf(stderr, "Command table failed to build\n");
+        return 1;
+    }
+
+    corpus_t corpus = { 0 };
+    bool ok = path ? corpus_load(&corpus, path) : corpus_synthetic(&corpus, lines);
+    if (!ok) {
+        fprintf(stderr, "Could not %s corpus%s%s\n", path ? "load" : "build",
+                path ? " " : "", path ? path : "");
+        return 1;
+    }
+
+    /* Agreement: same command found; table-only rejections are typed checks */
+    char buf[MAX_LINE + 1];
+    int same = 0, stricter = 0, other = 0, table_ok = 0;
+    for (int k = 0; k < corpus.count; k++) {
+        const char *line = corpus.text + corpus.offset[k];
+        cmd_parsed_t p;
+        snprintf(buf, sizeof(buf), "%s", line);
+        cmd_table_status_t st = cmd_table_parse(&table, buf, &p);
+        int t = (st == CMD_TABLE_OK) ? (int)(p.spec - g_specs) : -1;
+        snprintf(buf, sizeof(buf), "%s", line);
+        int l = legacy_parse(buf);
+        if (st == CMD_TABLE_OK) table_ok++;
+        if (t == l) same++;
+        else if (t < 0) stricter++;
+        else other++;
+    }
+
+    printf("Corpus: %d lines%s%s, %d commands in the grammar\n\n", corpus.count,
+           path ? " from " : " (synthetic sweep)", path ? path : "", NUM_SPECS);
+    printf("Agreement\n");
+    printf("  same result              %8d\n", same);
+    printf("  rejected by type checks  %8d\n", stricter);
+    printf("  other differences        %8d\n", other);
+    printf("  accepted by table        %8d\n\n", table_ok);
+
+    /* Throughput: both paths copy the line first (parsing is destructive) */
+    volatile int sink = 0;
+    double t0 = now_sec();
+    for (int pass = 0; pass < passes; pass++) {
+        for (int k = 0; k < corpus.count; k++) {
+            cmd_parsed_t p;
+            strcpy(buf, corpus.text + corpus.offset[k]);
+            sink += (int)cmd_table_parse(&table, buf, &p);
+        }
+    }
+    double t_table = now_sec() - t0;
+
+    t0 = now_sec();
+    for (int pass = 0; pass < passes; pass++) {
+        for (int k = 0; k < corpus.count; k++) {
+            strcpy(buf, corpus.text + corpus.offset[k]);
+            sink += legacy_parse(buf);
+        }
+    }
+    double t_legacy = now_sec() - t0;
+    (void)sink;
+
+    double total = (double)corpus.count * passes;
+    printf("Throughput\n");
+    printf("  table    %8.2f M cmd/s  %7.1f ns/cmd\n", total / t_table / 1e6, t_table / total * 1e9);
+    printf("  legacy   %8.2f M cmd/s  %7.1f ns/cmd\n", total / t_legacy / 1e6, t_legacy / total * 1e9);
+    printf("  speedup  %8.2fx\n", t_legacy / t_table);
+
+    free(corpus.text);
+    free(corpus.offset);
+    return 0;
+}
@@ -0,0 +1,527 @@
+/**
+ * @file detector_params.c
+ * @brief Versioned, hot-reloadable detector parameter store
+ *
+ * Snapshot reclamation uses a single hazard pointer: the reader announces
+ * the snapshot it is about to copy and re-checks it is still current. A
+ * writer frees every retired snapshot except the announced one, so at
+ * most one old snapshot outlives a publish no matter how slow the reader.
+ *
+ * The writer lock only guards the pointer swap and the retired list; the
+ * audit log and INI files are read and written outside it.
+ */
+
+#include "detector_params.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/*============================================================================
+ * Parameter Table
+ *
+ * Ranges match the detector setters - a value the store accepts is a value
+ * the detector will take.
+ *============================================================================*/
+
+#define PARAM(sec, k, field, is_int, lo, hi, fmt) \
+    { sec, k, offsetof(detector_params_t, field), is_int, lo, hi, fmt }
+
+static const detector_param_desc_t g_params[] = {
+    PARAM("tick_detector",   "threshold_multiplier",        tick_threshold_mult,        false, 1.0f,    5.0f,    "%.3f"),
+    PARAM("tick_detector",   "adapt_alpha_down",            tick_adapt_alpha_down,      false, 0.9f,    0.999f,  "%.6f"),
+    PARAM("tick_detector",   "adapt_alpha_up",              tick_adapt_alpha_up,        false, 0.001f,  0.1f,    "%.6f"),
+    PARAM("tick_detector",   "min_duration_ms",             tick_min_duration_ms,       false, 1.0f,    10.0f,   "%.2f"),
+
+    PARAM("tick_correlator", "epoch_confidence_threshold",  corr_epoch_confidence,      false, 0.5f,    0.95f,   "%.3f"),
+    PARAM("tick_correlator", "max_consecutive_misses",      corr_max_misses,            true,  2.0f,    10.0f,   "%d"),
+
+    PARAM("marker_detector", "threshold_multiplier",        marker_threshold_mult,      false, 2.0f,    5.0f,    "%.3f"),
+    PARAM("marker_detector", "noise_adapt_rate",            marker_noise_adapt_rate,    false, 0.0001f, 0.01f,   "%.6f"),
+    PARAM("marker_detector", "min_duration_ms",             marker_min_duration_ms,     false, 300.0f,  700.0f,  "%.2f"),
+
+    PARAM("sync_detector",   "weight_tick",                 sync_weight_tick,           false, 0.01f,   0.2f,    "%.3f"),
+    PARAM("sync_detector",   "weight_marker",               sync_weight_marker,         false, 0.1f,    0.6f,    "%.3f"),
+    PARAM("sync_detector",   "weight_p_marker",             sync_weight_p_marker,       false, 0.05f,   0.3f,    "%.3f"),
+    PARAM("sync_detector",   "weight_tick_hole",            sync_weight_tick_hole,      false, 0.05f,   0.4f,    "%.3f"),
+    PARAM("sync_detector",   "weight_combined_hole_marker", sync_weight_combined,       false, 0.2f,    0.8f,    "%.3f"),
+    PARAM("sync_detector",   "confidence_locked_threshold", sync_locked_threshold,      false, 0.5f,    0.9f,    "%.3f"),
+    PARAM("sync_detector",   "confidence_min_retain",       sync_min_retain,            false, 0.01f,   0.2f,    "%.3f"),
+    PARAM("sync_detector",   "confidence_tentative_init",   sync_tentative_init,        false, 0.1f,    0.5f,    "%.3f"),
+    PARAM("sync_detector",   "confidence_decay_normal",     sync_decay_normal,          false, 0.99f,   0.9999f, "%.4f"),
+    PARAM("sync_detector",   "confidence_decay_recovering", sync_decay_recovering,      false, 0.90f,   0.99f,   "%.4f"),
+    PARAM("sync_detector",   "tick_phase_tolerance_ms",     sync_tick_tolerance_ms,     false, 50.0f,   200.0f,  "%.1f"),
+    PARAM("sync_detector",   "marker_tolerance_ms",         sync_marker_tolerance_ms,   false, 200.0f,  800.0f,  "%.1f"),
+    PARAM("sync_detector",   "p_marker_tolerance_ms",       sync_p_marker_tolerance_ms, false, 100.0f,  400.0f,  "%.1f"),
+};
+
+#define NUM_PARAMS ((int)(sizeof(g_params) / sizeof(g_params[0])))
+
+int detector_params_count(void) {
+    return NUM_PARAMS;
+}
+
+const detector_param_desc_t *detector_params_desc(int index) {
+    if (index < 0 || index >= NUM_PARAMS) return NULL;
+    return &g_params[index];
+}
+
+const detector_param_desc_t *detector_params_find(const char *section, const char *key) {
+    if (!section || !key) return NULL;
+    for (int i = 0; i < NUM_PARAMS; i++) {
+        if (strcmp(g_params[i].section, section) == 0 && strcmp(g_params[i].key, key) == 0) {
+            return &g_params[i];
+        }
+    }
+    return NULL;
+}
+
+float detector_params_get(const detector_params_t *params, const detector_param_desc_t *desc) {
+    if (!params || !desc) return 0.0f;
+    const char *base = (const char *)params + desc->offset;
+    if (desc->is_int) {
+        int v;
+        memcpy(&v, base, sizeof(v));
+        return (float)v;
+    }
+    float v;
+    memcpy(&v, base, sizeof(v));
+    return v;
+}
+
+detector_param_result_t detector_params_set(detector_params_t *params,
+                                            const detector_param_desc_t *desc, float value) {
+    if (!params || !desc) return DETECTOR_PARAM_ERR_UNKNOWN;
+    if (!(value >= desc->min && value <= desc->max)) return DETECTOR_PARAM_ERR_RANGE;
+
+    char *base = (char *)params + desc->offset;
+    if (desc->is_int) {
+        int v = (int)value;
+        memcpy(base, &v, sizeof(v));
+    } else {
+        memcpy(base, &value, sizeof(value));
+    }
+    return DETECTOR_PARAM_OK;
+}
+
+void detector_params_format(const detector_params_t *params, const detector_param_desc_t *desc,
+                            char *buf, size_t buf_size) {
+    if (!buf || buf_size == 0) return;
+    if (!params || !desc) {
+        buf[0] = '\0';
+        return;
+    }
+    if (desc->is_int) {
+        snprintf(buf, buf_size, desc->fmt, (int)detector_params_get(params, desc));
+    } else {
+        snprintf(buf, buf_size, desc->fmt, (double)detector_params_get(params, desc));
+    }
+}
+
+bool detector_params_validate(const detector_params_t *params, const detector_param_desc_t **bad) {
+    if (!params) return false;
+    for (int i = 0; i < NUM_PARAMS; i++) {
+        float v = detector_params_get(params, &g_params[i]);
+        if (!(v >= g_params[i].min && v <= g_params[i].max)) {
+            if (bad) *bad = &g_params[i];
+            return false;
+        }
+    }
+    return true;
+}
+
+/*============================================================================
+ * INI Files
+ *============================================================================*/
+
+static char *trim(char *s) {
+    while (isspace((unsigned char)*s)) s++;
+    char *end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+int detector_params_load_ini(const char *path, detector_params_t *params, int *rejected) {
+    if (rejected) *rejected = 0;
+    if (!path || !params) return -1;
+
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+
+    char line[256];
+    char section[64] = "";
+    int loaded = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        char *s = trim(line);
+        if (*s == '\0' || *s == ';' || *s == '#') continue;
+
+        if (*s == '[') {
+            char *close = strchr(s, ']');
+            if (close) {
+                *close = '\0';
+                snprintf(section, sizeof(section), "%s", trim(s + 1));
+            } else {
+                section[0] = '\0';
+            }
+            continue;
+        }
+
+        char *eq = strchr(s, '=');
+        if (!eq) continue;
+        *eq = '\0';
+
+        const detector_param_desc_t *desc = detector_params_find(section, trim(s));
+        if (!desc) continue;
+
+        char *value_str = trim(eq + 1);
+        char *endp;
+        float value = strtof(value_str, &endp);
+        if (endp == value_str || detector_params_set(params, desc, value) != DETECTOR_PARAM_OK) {
+            if (rejected) (*rejected)++;
+            continue;
+        }
+        loaded++;
+    }
+
+    fclose(f);
+    return loaded;
+}
+
+bool detector_params_save_ini(const char *path, const detector_params_t *params) {
+    if (!path || !params) return false;
+
+    /* Write beside the target and rename so a watcher never sees half a file */
+    char tmp_path[512];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    FILE *f = fopen(tmp_path, "w");
+    if (!f) return false;
+
+    const char *section = NULL;
+    for (int i = 0; i < NUM_PARAMS; i++) {
+        if (!section || strcmp(section, g_params[i].section) != 0) {
+            section = g_params[i].section;
+            fprintf(f, "%s[%s]\n", i > 0 ? "\n" : "", section);
+        }
+        char value[32];
+        detector_params_format(params, &g_params[i], value, sizeof(value));
+        fprintf(f, "%s=%s\n", g_params[i].key, value);
+    }
+
+    if (fclose(f) != 0) {
+        remove(tmp_path);
+        return false;
+    }
+
+#ifdef _WIN32
+    if (!MoveFileExA(tmp_path, path, MOVEFILE_REPLACE_EXISTING)) {
+#else
+    if (rename(tmp_path, path) != 0) {
+#endif
+        remove(tmp_path);
+        return false;
+    }
+    return true;
+}
+
+/*============================================================================
+ * Store
+ *============================================================================*/
+
+typedef struct snapshot {
+    detector_params_t params;
+    struct snapshot *next;                  /* Retired list link */
+} snapshot_t;
+
+struct detector_param_store {
+    _Atomic(snapshot_t *) current;
+    atomic_uint version;                    /* Mirrors current->params.version */
+    _Atomic(snapshot_t *) hazard;           /* Snapshot the reader is copying */
+    atomic_flag writer_lock;
+
+    snapshot_t *retired;                    /* Writer side only */
+    char audit_path[256];
+
+    /* INI watch */
+    char ini_path[256];
+    time_t ini_mtime;
+    long ini_size;
+};
+
+static void writer_lock(detector_param_store_t *store) {
+    while (atomic_flag_test_and_set_explicit(&store->writer_lock, memory_order_acquire)) {
+        /* Writers are rare (commands, file reloads) - spinning is fine */
+    }
+}
+
+static void writer_unlock(detector_param_store_t *store) {
+    atomic_flag_clear_explicit(&store->writer_lock, memory_order_release);
+}
+
+/* Free retired snapshots the reader is not copying (writer lock held) */
+static void reclaim(detector_param_store_t *store) {
+    snapshot_t *in_use = atomic_load_explicit(&store->hazard, memory_order_seq_cst);
+    snapshot_t **link = &store->retired;
+    while (*link) {
+        snapshot_t *s = *link;
+        if (s != in_use) {
+            *link = s->next;
+            free(s);
+        } else {
+            link = &s->next;
+        }
+    }
+}
+
+static void audit_changes(detector_param_store_t *store, const detector_params_t *old_params,
+                          const detector_params_t *new_params, const char *source) {
+    if (store->audit_path[0] == '\0') return;
+
+    FILE *f = fopen(store->audit_path, "a");
+    if (!f) return;
+
+    char stamp[32];
+    time_t now = time(NULL);
+    struct tm *utc = gmtime(&now);
+    if (utc) {
+        strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", utc);
+    } else {
+        snprintf(stamp, sizeof(stamp), "%lld", (long long)now);
+    }
+
+    for (int i = 0; i < NUM_PARAMS; i++) {
+        const detector_param_desc_t *d = &g_params[i];
+        if (detector_params_get(old_params, d) == detector_params_get(new_params, d)) continue;
+
+        char old_str[32], new_str[32];
+        detector_params_format(old_params, d, old_str, sizeof(old_str));
+        detector_params_format(new_params, d, new_str, sizeof(new_str));
+        fprintf(f, "%s UTC v%u [%s] %s.%s %s -> %s\n", stamp, new_params->version,
+                source ? source : "?", d->section, d->key, old_str, new_str);
+    }
+    fclose(f);
+}
+
+detector_param_store_t *detector_param_store_create(const detector_params_t *initial,
+                                                    const char *audit_path) {
+    if (!initial || !detector_params_validate(initial, NULL)) return NULL;
+
+    detector_param_store_t *store = (detector_param_store_t *)calloc(1, sizeof(*store));
+    snapshot_t *snap = (snapshot_t *)calloc(1, sizeof(*snap));
+    if (!store || !snap) {
+        free(store);
+        free(snap);
+        return NULL;
+    }
+
+    snap->params = *initial;
+    snap->params.version = 1;
+    atomic_init(&store->current, snap);
+    atomic_init(&store->version, 1u);
+    atomic_init(&store->hazard, NULL);
+    atomic_flag_clear(&store->writer_lock);
+
+    if (audit_path) {
+        snprintf(store->audit_path, sizeof(store->audit_path), "%s", audit_path);
+    }
+    return store;
+}
+
+void detector_param_store_destroy(detector_param_store_t *store) {
+    if (!store) return;
+
+    while (store->retired) {
+        snapshot_t *next = store->retired->next;
+        free(store->retired);
+        store->retired = next;
+    }
+    free(atomic_load(&store->current));
+    free(store);
+}
+
+void detector_param_store_snapshot(detector_param_store_t *store, detector_params_t *out) {
+    if (!store || !out) return;
+    writer_lock(store);
+    *out = atomic_load_explicit(&store->current, memory_order_acquire)->params;
+    writer_unlock(store);
+}
+
+uint32_t detector_param_store_publish(detector_param_store_t *store,
+                                      const detector_params_t *draft, const char *source) {
+    if (!store || !draft || !detector_params_validate(draft, NULL)) return 0;
+
+    writer_lock(store);
+
+    snapshot_t *old_snap = atomic_load_explicit(&store->current, memory_order_acquire);
+
+    bool changed = false;
+    for (int i = 0; i < NUM_PARAMS && !changed; i++) {
+        changed = detector_params_get(&old_snap->params, &g_params[i]) !=
+                  detector_params_get(draft, &g_params[i]);
+    }
+    if (!changed) {
+        writer_unlock(store);
+        return 0;
+    }
+
+    /* Edited from an older snapshot - publishing would undo the newer one */
+    if (draft->version != old_snap->params.version) {
+        writer_unlock(store);
+        return DETECTOR_PARAM_STORE_CONFLICT;
+    }
+
+    snapshot_t *snap = (snapshot_t *)calloc(1, sizeof(*snap));
+    if (!snap) {
+        writer_unlock(store);
+        return 0;
+    }
+    snap->params = *draft;
+    snap->params.version = old_snap->params.version + 1;
+
+    /* Old values for the audit log - old_snap may be freed below */
+    detector_params_t old_params = old_snap->params;
+    detector_params_t new_params = snap->params;
+
+    /* Pointer first, then version - a reader that sees the new version
+     * always loads this snapshot or a newer one. The pointer store is
+     * seq_cst so it cannot be reordered after the hazard load in reclaim():
+     * either the reader's re-check sees this snapshot, or we see its hazard. */
+    atomic_store_explicit(&store->current, snap, memory_order_seq_cst);
+    atomic_store_explicit(&store->version, snap->params.version, memory_order_release);
+
+    old_snap->next = store->retired;
+    store->retired = old_snap;
+    reclaim(store);
+
+    writer_unlock(store);
+
+    audit_changes(store, &old_params, &new_params, source);
+    return new_params.version;
+}
+
+uint32_t detector_param_store_version(detector_param_store_t *store) {
+    if (!store) return 0;
+    return atomic_load_explicit(&store->version, memory_order_acquire);
+}
+
+bool detector_param_store_poll(detector_param_store_t *store, uint32_t *applied_version,
+                               detector_params_t *out) {
+    if (!store || !applied_version || !out) return false;
+
+    /* Fast path: one atomic load per block when nothing changed */
+    if (atomic_load_explicit(&store->version, memory_order_acquire) == *applied_version) {
+        return false;
+    }
+
+    /* Announce, then confirm it is still current - a writer that retired it
+     * in between will see the hazard and keep it alive */
+    snapshot_t *snap;
+    do {
+        snap = atomic_load(&store->current);
+        atomic_store(&store->hazard, snap);
+    } while (snap != atomic_load(&store->current));
+
+    *out = snap->params;
+    atomic_store_explicit(&store->hazard, NULL, memory_order_release);
+
+    if (out->version == *applied_version) {
+        return false;
+    }
+    *applied_version = out->version;
+    return true;
+}
+
+/*============================================================================
+ * INI Watch
+ *============================================================================*/
+
+static bool ini_stat(const char *path, time_t *mtime, long *size) {
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    *mtime = st.st_mtime;
+    *size = (long)st.st_size;
+    return true;
+}
+
+void detector_param_store_watch_ini(detector_param_store_t *store, const char *path) {
+    if (!store) return;
+
+    time_t mtime = 0;
+    long size = -1;
+    if (path && !ini_stat(path, &mtime, &size)) {
+        mtime = 0;
+        size = -1;
+    }
+
+    writer_lock(store);
+    if (path) {
+        snprintf(store->ini_path, sizeof(store->ini_path), "%s", path);
+        store->ini_mtime = mtime;
+        store->ini_size = size;
+    } else {
+        store->ini_path[0] = '\0';
+    }
+    writer_unlock(store);
+}
+
+uint32_t detector_param_store_check_ini(detector_param_store_t *store) {
+    if (!store || store->ini_path[0] == '\0') return 0;
+
+    time_t mtime;
+    long size;
+    if (!ini_stat(store->ini_path, &mtime, &size)) return 0;
+
+    writer_lock(store);
+    bool changed = (mtime != store->ini_mtime || size != store->ini_size);
+    if (changed) {
+        store->ini_mtime = mtime;
+        store->ini_size = size;
+    }
+    writer_unlock(store);
+
+    if (!changed) return 0;
+
+    /* Another writer got in first - reload onto its snapshot */
+    uint32_t version;
+    do {
+        detector_params_t draft;
+        detector_param_store_snapshot(store, &draft);
+        if (detector_params_load_ini(store->ini_path, &draft, NULL) <= 0) return 0;
+        version = detector_param_store_publish(store, &draft, "ini");
+    } while (version == DETECTOR_PARAM_STORE_CONFLICT);
+
+    return version;
+}
+
+bool detector_param_store_save_ini(detector_param_store_t *store) {
+    if (!store || store->ini_path[0] == '\0') return false;
+
+    detector_params_t params;
+    detector_param_store_snapshot(store, &params);
+
+    if (!detector_params_save_ini(store->ini_path, &params)) return false;
+
+    /* A check_ini() that lands before the stat reloads the same values,
+     * which publish() drops as unchanged */
+    time_t mtime = 0;
+    long size = -1;
+    if (!ini_stat(store->ini_path, &mtime, &size)) {
+        mtime = 0;
+        size = -1;
+    }
+
+    writer_lock(store);
+    store->ini_mtime = mtime;
+    store->ini_size = size;
+    writer_unlock(store);
+    return true;
+}
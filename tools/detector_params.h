@@ -0,0 +1,228 @@
+/**
+ * @file detector_params.h
+ * @brief Versioned, hot-reloadable detector parameter store
+ *
+ * All runtime-tunable detector parameters live in one immutable snapshot.
+ * Writers (UDP command path, INI file watcher) copy the current snapshot,
+ * edit the copy, and publish it; publishing validates every field, bumps
+ * the version, appends the changes to an audit log and swaps a single
+ * atomic pointer. The DSP loop polls once per block and applies a whole
+ * snapshot at a time, so related parameters never change mid-block and
+ * tuning never writes into detector structs from outside the sample path.
+ *
+ * Threading: any number of writers, exactly one reader calling
+ * detector_param_store_poll(). Publishing is serialized internally, but a
+ * draft based on an older version is refused with
+ * DETECTOR_PARAM_STORE_CONFLICT so concurrent edits are never lost - the
+ * writer re-snapshots, re-applies its edits and publishes again. Retired
+ * snapshots are freed on the next publish unless the reader is copying one
+ * at that moment.
+ */
+
+#ifndef DETECTOR_PARAMS_H
+#define DETECTOR_PARAMS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Parameter Snapshot
+ *============================================================================*/
+
+typedef struct {
+    uint32_t version;                   /* Set by the store on publish */
+
+    /* [tick_detector] */
+    float tick_threshold_mult;
+    float tick_adapt_alpha_down;
+    float tick_adapt_alpha_up;
+    float tick_min_duration_ms;
+
+    /* [tick_correlator] */
+    float corr_epoch_confidence;
+    int   corr_max_misses;
+
+    /* [marker_detector] */
+    float marker_threshold_mult;
+    float marker_noise_adapt_rate;
+    float marker_min_duration_ms;
+
+    /* [sync_detector] */
+    float sync_weight_tick;
+    float sync_weight_marker;
+    float sync_weight_p_marker;
+    float sync_weight_tick_hole;
+    float sync_weight_combined;
+    float sync_locked_threshold;
+    float sync_min_retain;
+    float sync_tentative_init;
+    float sync_decay_normal;
+    float sync_decay_recovering;
+    float sync_tick_tolerance_ms;
+    float sync_marker_tolerance_ms;
+    float sync_p_marker_tolerance_ms;
+} detector_params_t;
+
+/* Parameter descriptor - INI section/key, valid range, print format */
+typedef struct {
+    const char *section;
+    const char *key;
+    size_t      offset;                 /* offsetof() into detector_params_t */
+    bool        is_int;
+    float       min;
+    float       max;
+    const char *fmt;                    /* printf format for the value */
+} detector_param_desc_t;
+
+typedef enum {
+    DETECTOR_PARAM_OK = 0,
+    DETECTOR_PARAM_ERR_UNKNOWN,         /* No such section/key */
+    DETECTOR_PARAM_ERR_RANGE            /* Value outside descriptor range */
+} detector_param_result_t;
+
+/*============================================================================
+ * Parameter Table
+ *============================================================================*/
+
+/**
+ * @brief Number of tunable parameters
+ */
+int detector_params_count(void);
+
+/**
+ * @brief Descriptor by index (0 .. count-1), NULL if out of range
+ */
+const detector_param_desc_t *detector_params_desc(int index);
+
+/**
+ * @brief Look up a descriptor by INI section and key
+ */
+const detector_param_desc_t *detector_params_find(const char *section, const char *key);
+
+/**
+ * @brief Read a parameter as float
+ */
+float detector_params_get(const detector_params_t *params, const detector_param_desc_t *desc);
+
+/**
+ * @brief Range-check and set a parameter in a draft snapshot
+ */
+detector_param_result_t detector_params_set(detector_params_t *params,
+                                            const detector_param_desc_t *desc, float value);
+
+/**
+ * @brief Format a parameter value with its descriptor format
+ */
+void detector_params_format(const detector_params_t *params, const detector_param_desc_t *desc,
+                            char *buf, size_t buf_size);
+
+/**
+ * @brief Check every parameter against its range
+ * @param bad  If non-NULL, receives the first failing descriptor
+ */
+bool detector_params_validate(const detector_params_t *params, const detector_param_desc_t **bad);
+
+/*============================================================================
+ * INI Files
+ *============================================================================*/
+
+/**
+ * @brief Apply key=value lines from an INI file onto a draft snapshot
+ *
+ * Unknown sections/keys are skipped. Out-of-range values are skipped and
+ * counted in *rejected.
+ *
+ * @return Number of parameters loaded, -1 if the file could not be opened
+ */
+int detector_params_load_ini(const char *path, detector_params_t *params, int *rejected);
+
+/**
+ * @brief Write all parameters to an INI file (temp file + rename)
+ */
+bool detector_params_save_ini(const char *path, const detector_params_t *params);
+
+/*============================================================================
+ * Store
+ *============================================================================*/
+
+typedef struct detector_param_store detector_param_store_t;
+
+/* publish() result when the draft's version is no longer current */
+#define DETECTOR_PARAM_STORE_CONFLICT UINT32_MAX
+
+/**
+ * @brief Create a store holding an initial snapshot (version 1)
+ * @param initial     Initial values (must validate)
+ * @param audit_path  Append-only change log, or NULL for none
+ */
+detector_param_store_t *detector_param_store_create(const detector_params_t *initial,
+                                                    const char *audit_path);
+
+void detector_param_store_destroy(detector_param_store_t *store);
+
+/**
+ * @brief Copy the current snapshot (writer side - start of an edit)
+ */
+void detector_param_store_snapshot(detector_param_store_t *store, detector_params_t *out);
+
+/**
+ * @brief Publish an edited snapshot
+ *
+ * The draft must come from detector_param_store_snapshot() of the current
+ * version; if another writer published in between, nothing is changed.
+ * A draft identical to the current values is a no-op whatever its version.
+ *
+ * @param source  Who made the change, recorded in the audit log ("udp", "ini", ...)
+ * @return New version, 0 if the draft is invalid or identical to current,
+ *         DETECTOR_PARAM_STORE_CONFLICT if it is based on an older version
+ */
+uint32_t detector_param_store_publish(detector_param_store_t *store,
+                                      const detector_params_t *draft, const char *source);
+
+/**
+ * @brief Current published version
+ */
+uint32_t detector_param_store_version(detector_param_store_t *store);
+
+/**
+ * @brief Reader side: pick up a newer snapshot at a block boundary
+ *
+ * Lock-free. Call from the single DSP thread only.
+ *
+ * @param applied_version  In: version last applied (0 initially). Out: updated on change.
+ * @param out              Receives the new snapshot when one is available
+ * @return true if *out holds a snapshot newer than *applied_version had
+ */
+bool detector_param_store_poll(detector_param_store_t *store, uint32_t *applied_version,
+                               detector_params_t *out);
+
+/*============================================================================
+ * INI Watch
+ *============================================================================*/
+
+/**
+ * @brief Watch an INI file; detector_param_store_check_ini() reloads it on change
+ */
+void detector_param_store_watch_ini(detector_param_store_t *store, const char *path);
+
+/**
+ * @brief Reload the watched INI if it changed on disk (call about once a second)
+ * @return New version if a reload was published, 0 otherwise
+ */
+uint32_t detector_param_store_check_ini(detector_param_store_t *store);
+
+/**
+ * @brief Save the current snapshot to the watched INI without triggering a reload
+ */
+bool detector_param_store_save_ini(detector_param_store_t *store);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DETECTOR_PARAMS_H */
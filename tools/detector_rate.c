@@ -0,0 +1,83 @@
+/**
+ * @file detector_rate.c
+ * @brief Per-instance input rate profile implementation
+ */
+
+#include "detector_rate.h"
+#include <math.h>
+
+/*============================================================================
+ * Public API Implementation
+ *============================================================================*/
+
+bool detector_rate_init(detector_rate_t *dr, int sample_rate,
+                        int nominal_rate, int nominal_fft_size) {
+    if (!dr || sample_rate < DETECTOR_RATE_MIN || sample_rate > DETECTOR_RATE_MAX ||
+        nominal_rate <= 0 || nominal_fft_size < 2) {
+        return false;
+    }
+
+    /* Power of two closest to the nominal frame length; ties go larger */
+    double ideal = (double)nominal_fft_size * sample_rate / nominal_rate;
+    int fft_size = 16;
+    while (fft_size < DETECTOR_FFT_MAX && fft_size * 2 <= ideal) fft_size *= 2;
+    if (fft_size < DETECTOR_FFT_MAX && ideal - fft_size >= fft_size * 2 - ideal) fft_size *= 2;
+
+    dr->sample_rate = sample_rate;
+    dr->decimation = 1;
+    dr->fft_size = fft_size;
+    dr->frame_ms = (float)fft_size * 1000.0f / sample_rate;
+    dr->hz_per_bin = (float)sample_rate / fft_size;
+    return true;
+}
+
+bool detector_rate_decimate(detector_rate_t *dr, int decimation) {
+    if (!dr || decimation < 1 || dr->fft_size % decimation != 0 ||
+        dr->fft_size / decimation < DETECTOR_SUBBAND_MIN_FFT) {
+        return false;
+    }
+
+    /* Same frame span and bin width, fewer points */
+    dr->decimation *= decimation;
+    dr->fft_size /= decimation;
+    return true;
+}
+
+int detector_rate_samples(const detector_rate_t *dr, float ms) {
+    return (int)(ms * dr->sample_rate / 1000.0f + 0.5f);
+}
+
+int detector_rate_frames(const detector_rate_t *dr, float ms) {
+    return (int)(ms / dr->frame_ms + 0.5f);
+}
+
+int detector_rate_bin(const detector_rate_t *dr, float hz) {
+    return (int)(hz / dr->hz_per_bin + 0.5f);
+}
+
+float detector_rate_bucket_energy(const detector_rate_t *dr, const kiss_fft_cpx *spectrum,
+                                  int center_bin, int bin_span) {
+    const int n = dr->fft_size;
+    const float scale = 1.0f / n;       /* Exact: n is a power of two */
+    float pos_energy = 0.0f;
+    float neg_energy = 0.0f;
+
+    for (int b = -bin_span; b <= bin_span; b++) {
+        int pos_bin = center_bin + b;
+        int neg_bin = n - center_bin + b;
+
+        if (pos_bin >= 0 && pos_bin < n) {
+            float re = spectrum[pos_bin].r;
+            float im = spectrum[pos_bin].i;
+            pos_energy += sqrtf(re * re + im * im) * scale;
+        }
+        /* Short (decimated) FFTs: the ranges can meet at Nyquist */
+        if (neg_bin >= 0 && neg_bin < n && neg_bin > center_bin + bin_span) {
+            float re = spectrum[neg_bin].r;
+            float im = spectrum[neg_bin].i;
+            neg_energy += sqrtf(re * re + im * im) * scale;
+        }
+    }
+
+    return pos_energy + neg_energy;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file detector_rate.h
+ * @brief Per-instance input rate profile for FFT-bucket detectors
+ *
+ * The detectors were written against one compile-time rate (50 kHz detector
+ * path, 12 kHz display path). A rate profile carries the values they used
+ * to derive from macros, computed once at create time:
+ *
+ *   fft_size    power of two whose frame length is closest to the nominal
+ *               detector's (a 5.12 ms tick frame stays ~5 ms at any rate)
+ *   frame_ms    fft_size / rate
+ *   hz_per_bin  rate / fft_size
+ *
+ * Timing constants in ms then convert to frames or samples per instance,
+ * so a detector fed straight from a 48 kHz modem or a wideband capture
+ * needs no resampler in front of it.
+ *
+ * A narrowband detector (the 100 Hz BCD pair) can instead take every
+ * Nth sample of a band-limited channel: detector_rate_decimate() keeps
+ * the frame length and Hz/bin and divides the FFT by N, so frames line
+ * up with the full-rate ones (2048 points become 64 at N = 32).
+ */
+
+#ifndef DETECTOR_RATE_H
+#define DETECTOR_RATE_H
+
+#include <stdbool.h>
+#include "kiss_fft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define DETECTOR_RATE_MIN       8000        /* Keeps the 1 kHz tick below Nyquist */
+#define DETECTOR_RATE_MAX       10000000
+#define DETECTOR_FFT_MAX        (1 << 18)
+#define DETECTOR_SUBBAND_MIN_FFT    4       /* Smallest FFT after decimation */
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct {
+    int sample_rate;            /* Rate the timing refers to */
+    int decimation;             /* Input is every Nth sample of sample_rate */
+    int fft_size;               /* Input samples per frame */
+    float frame_ms;
+    float hz_per_bin;
+} detector_rate_t;
+
+/*============================================================================
+ * Public API
+ *============================================================================*/
+
+/**
+ * Derive a profile for sample_rate from the detector's nominal design
+ * @param nominal_rate      Rate the detector was tuned at
+ * @param nominal_fft_size  FFT size at nominal_rate
+ * @return false if sample_rate is outside DETECTOR_RATE_MIN..MAX
+ *
+ * At nominal_rate the nominal FFT size comes back unchanged.
+ */
+bool detector_rate_init(detector_rate_t *dr, int sample_rate,
+                        int nominal_rate, int nominal_fft_size);
+
+/**
+ * Take every decimation-th sample instead of all of them
+ * @return false unless decimation divides fft_size and leaves at least
+ *         DETECTOR_SUBBAND_MIN_FFT points (profile unchanged then)
+ *
+ * The caller must band-limit the input to well inside
+ * sample_rate / (2 * decimation) first (fft_filter_bank does).
+ */
+bool detector_rate_decimate(detector_rate_t *dr, int decimation);
+
+/** Samples in ms at sample_rate (rounded) */
+int detector_rate_samples(const detector_rate_t *dr, float ms);
+
+/** Whole frames in ms (rounded, as the old MS_TO_FRAMES) */
+int detector_rate_frames(const detector_rate_t *dr, float ms);
+
+/** Nearest FFT bin to hz (positive frequencies) */
+int detector_rate_bin(const detector_rate_t *dr, float hz);
+
+/**
+ * Summed magnitude of bins center +/- span at +f and -f, each scaled by
+ * 1/fft_size - the bucket energy every detector here computes
+ */
+float detector_rate_bucket_energy(const detector_rate_t *dr, const kiss_fft_cpx *spectrum,
+                                  int center_bin, int bin_span);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DETECTOR_RATE_H */
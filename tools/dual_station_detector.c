@@ -0,0 +1,738 @@
+/**
+ * @file dual_station_detector.c
+ * @brief Simultaneous WWV / WWVH tick separation
+ *
+ * Shared front end (runs once per sample / frame for both stations):
+ *   1. Mirrored correlation buffer - the last DUAL_TEMPLATE_SAMPLES are
+ *      always contiguous, so the fused correlation loop has no modulo
+ *   2. One 256-point FFT per 5.12 ms frame, read at bin 5 (1000 Hz)
+ *      and bin 6 (1200 Hz)
+ *   3. One correlation pass producing both station responses. Runs every
+ *      CORR_DECIMATION samples while any pulse is active, and every
+ *      CORR_IDLE_DECIMATION samples otherwise (noise floor tracking only)
+ *
+ * Per station:
+ *   - Adaptive noise floor and tick / marker state machine
+ *   - Dominance check: a 5 ms Hann-windowed tone 200 Hz away still
+ *     produces roughly half the matched filter response, so a pulse is
+ *     only credited if its own response beats the other station's
+ *   - Tick chain (leading edges 1000 ms apart) and epoch estimate
+ *
+ * Once both stations have locked epochs, the relative delay
+ * (WWVH - WWV) is reported and smoothed.
+ */
+
+#include "dual_station_detector.h"
+#include "waterfall_telemetry.h"
+#include "kiss_fft.h"
+#include "version.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/*============================================================================
+ * Internal Configuration
+ *============================================================================*/
+
+#define FRAME_DURATION_MS   ((float)DUAL_FFT_SIZE * 1000.0f / DUAL_SAMPLE_RATE)
+#define HZ_PER_BIN          ((float)DUAL_SAMPLE_RATE / DUAL_FFT_SIZE)
+#define SAMPLE_MS           (1000.0f / DUAL_SAMPLE_RATE)
+
+#define NUM_STATIONS        2
+
+/* Detection timing (same windows as tick_detector) */
+#define DUAL_TICK_MIN_DURATION_MS   2.0f
+#define DUAL_TICK_MAX_DURATION_MS   50.0f
+#define DUAL_MARKER_MIN_DURATION_MS 600.0f
+#define DUAL_MARKER_MAX_DURATION_MS 1500.0f
+#define DUAL_MARKER_MIN_INTERVAL_MS 55000.0f
+#define DUAL_COOLDOWN_MS            500.0f
+#define DUAL_FLASH_FRAMES           5       /* Display frames per tick (x6 for markers) */
+
+/* Threshold adaptation */
+#define DUAL_NOISE_ADAPT_DOWN   0.002f
+#define DUAL_NOISE_ADAPT_UP     0.0002f
+#define DUAL_NOISE_FLOOR_MAX    5.0f
+#define DUAL_WARMUP_ADAPT_RATE  0.05f
+#define DUAL_WARMUP_FRAMES      50
+#define DUAL_HYSTERESIS_RATIO   0.7f
+#define DUAL_THRESHOLD_MULT     2.0f
+
+/* Matched filter */
+#define CORR_THRESHOLD_MULT     5.0f    /* Own peak must be 5x own noise floor */
+#define CORR_NOISE_ADAPT        0.01f
+#define CORR_DECIMATION         8       /* While a pulse is active */
+#define CORR_IDLE_DECIMATION    32      /* While both stations are idle */
+
+/*
+ * Station dominance: own peak / other station's peak over the same pulse.
+ * A lone 1000 Hz tick gives ~0.55 at 1200 Hz (and vice versa), so 0.7
+ * rejects bleed-through while still accepting both stations when their
+ * pulses genuinely overlap (~0.9 each way at 2 ms separation).
+ */
+#define DUAL_DOMINANCE_MIN      0.7f
+
+/* Chains and epoch */
+#define DUAL_CHAIN_TOLERANCE_MS 3.0f    /* Interval must be N*1000 +/- this */
+#define DUAL_CHAIN_MAX_SKIP     2       /* Allow one missed tick (2000 ms) */
+#define DUAL_EPOCH_MAX_WEIGHT   10      /* Epoch EMA settles to 1/10 */
+#define DUAL_DELAY_ALPHA        0.1f    /* Relative delay smoothing */
+
+#define MS_TO_FRAMES(ms)    ((int)((ms) / FRAME_DURATION_MS + 0.5f))
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846f
+#endif
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+typedef enum {
+    STATE_IDLE,
+    STATE_IN_PULSE,
+    STATE_COOLDOWN
+} station_state_t;
+
+typedef struct {
+    wwv_station_t station;
+    int freq_hz;
+    int center_bin;
+
+    /* Matched filter template (Hann-windowed complex tone) */
+    float *template_i;
+    float *template_q;
+
+    /* Correlation tracking */
+    float corr_noise_floor;
+    float frame_corr_max;       /* Max own response since last frame */
+    uint64_t frame_corr_max_sample;
+    float frame_other_max;      /* Max other-station response since last frame */
+    float corr_peak;            /* Own peak over current pulse */
+    uint64_t corr_peak_sample;
+    float other_peak;           /* Other station's peak over current pulse */
+
+    /* Energy state machine */
+    station_state_t state;
+    float energy;
+    float noise_floor;
+    float threshold_high;
+    float threshold_low;
+    uint64_t pulse_start_frame;
+    int pulse_frames;
+    float pulse_peak_energy;
+    int cooldown_frames;
+    int flash_frames_remaining;
+
+    /* Statistics */
+    int ticks_detected;
+    int markers_detected;
+    int rejected;
+    uint64_t last_marker_frame;
+
+    /* Chain / epoch */
+    double last_leading_ms;     /* < 0 until first tick */
+    int chain_length;
+    float epoch_ms;
+    bool epoch_valid;
+} station_channel_t;
+
+struct dual_station_detector {
+    /* Shared FFT front end */
+    kiss_fft_cfg fft_cfg;
+    kiss_fft_cpx *fft_in;
+    kiss_fft_cpx *fft_out;
+    float *window_func;
+    float *i_buffer;
+    float *q_buffer;
+    int buffer_idx;
+
+    /* Shared mirrored correlation buffer (2 x template length) */
+    float *corr_buf_i;
+    float *corr_buf_q;
+    int corr_buf_idx;
+
+    uint64_t sample_count;
+    uint64_t frame_count;
+    bool warmup_complete;
+    bool detection_enabled;
+    bool hold;                          /* Noise floors frozen */
+
+    station_channel_t ch[NUM_STATIONS];
+
+    /* Relative delay */
+    bool delay_valid;
+    float delay_ms;
+    float raw_delay_ms;
+    int delay_measurements;
+
+    /* Callbacks */
+    station_tick_callback_fn tick_callback;
+    void *tick_callback_user_data;
+    station_delay_callback_fn delay_callback;
+    void *delay_callback_user_data;
+
+    /* Logging */
+    FILE *csv_file;
+    time_t start_time;
+};
+
+/*============================================================================
+ * Internal Functions
+ *============================================================================*/
+
+/** Wrap a millisecond offset into (-500, 500] */
+static float wrap_half_second(float ms) {
+    ms = fmodf(ms, 1000.0f);
+    if (ms > 500.0f) ms -= 1000.0f;
+    if (ms <= -500.0f) ms += 1000.0f;
+    return ms;
+}
+
+/** Wrap into [0, 1000) */
+static float wrap_second(float ms) {
+    ms = fmodf(ms, 1000.0f);
+    if (ms < 0.0f) ms += 1000.0f;
+    return ms;
+}
+
+static void get_wall_time_str(dual_station_detector_t *det, double timestamp_ms,
+                              char *buf, size_t buflen) {
+    time_t event_time = det->start_time + (time_t)(timestamp_ms / 1000.0);
+    struct tm *tm_info = localtime(&event_time);
+    strftime(buf, buflen, "%H:%M:%S", tm_info);
+}
+
+static bool init_channel(station_channel_t *ch, wwv_station_t station) {
+    ch->station = station;
+    ch->freq_hz = (station == WWV_STATION_WWVH) ? DUAL_WWVH_FREQ_HZ : DUAL_WWV_FREQ_HZ;
+    ch->center_bin = (int)(ch->freq_hz / HZ_PER_BIN + 0.5f);
+
+    ch->template_i = (float *)malloc(DUAL_TEMPLATE_SAMPLES * sizeof(float));
+    ch->template_q = (float *)malloc(DUAL_TEMPLATE_SAMPLES * sizeof(float));
+    if (!ch->template_i || !ch->template_q) return false;
+
+    for (int i = 0; i < DUAL_TEMPLATE_SAMPLES; i++) {
+        float t = (float)i / DUAL_SAMPLE_RATE;
+        float window = 0.5f * (1.0f - cosf(2.0f * M_PI * i / (DUAL_TEMPLATE_SAMPLES - 1)));
+        ch->template_i[i] = cosf(2.0f * M_PI * ch->freq_hz * t) * window;
+        ch->template_q[i] = sinf(2.0f * M_PI * ch->freq_hz * t) * window;
+    }
+
+    ch->state = STATE_IDLE;
+    ch->noise_floor = 0.01f;
+    ch->threshold_high = ch->noise_floor * DUAL_THRESHOLD_MULT;
+    ch->threshold_low = ch->threshold_high * DUAL_HYSTERESIS_RATIO;
+    ch->last_leading_ms = -1.0f;
+    return true;
+}
+
+/**
+ * Fused matched filter for both stations over the shared buffer.
+ * One pass, one load of each signal sample, four accumulators per station.
+ */
+static void compute_correlations(dual_station_detector_t *det, float *corr_wwv, float *corr_wwvh) {
+    const float *xi = det->corr_buf_i + det->corr_buf_idx;   /* Oldest sample first */
+    const float *xq = det->corr_buf_q + det->corr_buf_idx;
+    const float *ai = det->ch[WWV_STATION_WWV].template_i;
+    const float *aq = det->ch[WWV_STATION_WWV].template_q;
+    const float *bi = det->ch[WWV_STATION_WWVH].template_i;
+    const float *bq = det->ch[WWV_STATION_WWVH].template_q;
+
+    float a_re = 0.0f, a_im = 0.0f;
+    float b_re = 0.0f, b_im = 0.0f;
+
+    for (int k = 0; k < DUAL_TEMPLATE_SAMPLES; k++) {
+        float si = xi[k];
+        float sq = xq[k];
+        /* (si + j*sq) * conj(template) */
+        a_re += si * ai[k] + sq * aq[k];
+        a_im += sq * ai[k] - si * aq[k];
+        b_re += si * bi[k] + sq * bq[k];
+        b_im += sq * bi[k] - si * bq[k];
+    }
+
+    *corr_wwv = sqrtf(a_re * a_re + a_im * a_im);
+    *corr_wwvh = sqrtf(b_re * b_re + b_im * b_im);
+}
+
+static void update_correlation(station_channel_t *ch, float own, float other, uint64_t sample,
+                               bool hold) {
+    if (hold) {
+        /* Blanked or settling input - keep the floor */
+    } else if (own < ch->corr_noise_floor || ch->corr_noise_floor < 0.001f) {
+        ch->corr_noise_floor += CORR_NOISE_ADAPT * (own - ch->corr_noise_floor);
+    } else if (ch->state == STATE_IDLE) {
+        ch->corr_noise_floor += (CORR_NOISE_ADAPT * 0.1f) * (own - ch->corr_noise_floor);
+    }
+
+    if (own > ch->frame_corr_max) {
+        ch->frame_corr_max = own;
+        ch->frame_corr_max_sample = sample;
+    }
+    if (other > ch->frame_other_max) {
+        ch->frame_other_max = other;
+    }
+}
+
+static float bin_energy(const kiss_fft_cpx *out, int bin) {
+    float re = out[bin].r;
+    float im = out[bin].i;
+    return sqrtf(re * re + im * im) / DUAL_FFT_SIZE;
+}
+
+static void update_delay(dual_station_detector_t *det) {
+    station_channel_t *wwv = &det->ch[WWV_STATION_WWV];
+    station_channel_t *wwvh = &det->ch[WWV_STATION_WWVH];
+
+    if (!wwv->epoch_valid || !wwvh->epoch_valid) return;
+
+    det->raw_delay_ms = wrap_half_second(wwvh->epoch_ms - wwv->epoch_ms);
+    if (!det->delay_valid) {
+        det->delay_ms = det->raw_delay_ms;
+        det->delay_valid = true;
+        printf("[DUAL] Both stations locked: WWVH - WWV = %+.2f ms\n", det->delay_ms);
+    } else {
+        det->delay_ms += DUAL_DELAY_ALPHA * wrap_half_second(det->raw_delay_ms - det->delay_ms);
+    }
+    det->delay_measurements++;
+
+    if (det->delay_callback) {
+        station_delay_event_t event = {
+            .delay_ms = det->delay_ms,
+            .raw_delay_ms = det->raw_delay_ms,
+            .wwv_epoch_ms = wwv->epoch_ms,
+            .wwvh_epoch_ms = wwvh->epoch_ms,
+            .wwv_chain = wwv->chain_length,
+            .wwvh_chain = wwvh->chain_length,
+            .measurements = det->delay_measurements
+        };
+        det->delay_callback(&event, det->delay_callback_user_data);
+    }
+}
+
+/** Extend or restart the station's chain and refine its epoch */
+static float update_chain(station_channel_t *ch, double leading_ms) {
+    float interval_ms = (ch->last_leading_ms >= 0.0) ? (float)(leading_ms - ch->last_leading_ms) : 0.0f;
+    float phase_ms = wrap_second((float)fmod(leading_ms, 1000.0));
+
+    int seconds = (int)(interval_ms / 1000.0f + 0.5f);
+    bool on_second = seconds >= 1 && seconds <= DUAL_CHAIN_MAX_SKIP &&
+                     fabsf(interval_ms - seconds * 1000.0f) <= DUAL_CHAIN_TOLERANCE_MS * seconds;
+
+    if (on_second && ch->chain_length > 0) {
+        ch->chain_length++;
+        int weight = ch->chain_length < DUAL_EPOCH_MAX_WEIGHT ? ch->chain_length : DUAL_EPOCH_MAX_WEIGHT;
+        ch->epoch_ms = wrap_second(ch->epoch_ms + wrap_half_second(phase_ms - ch->epoch_ms) / weight);
+    } else {
+        ch->chain_length = 1;
+        ch->epoch_ms = phase_ms;
+        ch->epoch_valid = false;
+    }
+
+    if (ch->chain_length >= DUAL_MIN_CHAIN) {
+        ch->epoch_valid = true;
+    }
+
+    ch->last_leading_ms = leading_ms;
+    return interval_ms;
+}
+
+/**
+ * Energy state machine for one station. Returns true if a tick or marker
+ * was credited this frame.
+ */
+static bool run_station(dual_station_detector_t *det, station_channel_t *ch) {
+    float energy = ch->energy;
+    uint64_t frame = det->frame_count;
+    bool reported = false;
+
+    if (!det->warmup_complete) {
+        if (!det->hold) ch->noise_floor += DUAL_WARMUP_ADAPT_RATE * (energy - ch->noise_floor);
+        if (ch->noise_floor < 0.0001f) ch->noise_floor = 0.0001f;
+        ch->threshold_high = ch->noise_floor * DUAL_THRESHOLD_MULT;
+        ch->threshold_low = ch->threshold_high * DUAL_HYSTERESIS_RATIO;
+        return false;
+    }
+
+    if (ch->state == STATE_IDLE && energy < ch->threshold_high && !det->hold) {
+        float alpha = (energy < ch->noise_floor) ? DUAL_NOISE_ADAPT_DOWN : DUAL_NOISE_ADAPT_UP;
+        ch->noise_floor += alpha * (energy - ch->noise_floor);
+        if (ch->noise_floor < 0.0001f) ch->noise_floor = 0.0001f;
+        if (ch->noise_floor > DUAL_NOISE_FLOOR_MAX) ch->noise_floor = DUAL_NOISE_FLOOR_MAX;
+        ch->threshold_high = ch->noise_floor * DUAL_THRESHOLD_MULT;
+        ch->threshold_low = ch->threshold_high * DUAL_HYSTERESIS_RATIO;
+    }
+
+    switch (ch->state) {
+        case STATE_IDLE:
+            if (energy > ch->threshold_high) {
+                ch->state = STATE_IN_PULSE;
+                ch->pulse_start_frame = frame;
+                ch->pulse_frames = 1;
+                ch->pulse_peak_energy = energy;
+                /* The pulse began inside this frame - seed with its responses */
+                ch->corr_peak = ch->frame_corr_max;
+                ch->corr_peak_sample = ch->frame_corr_max_sample;
+                ch->other_peak = ch->frame_other_max;
+            }
+            break;
+
+        case STATE_IN_PULSE:
+            ch->pulse_frames++;
+            if (energy > ch->pulse_peak_energy) ch->pulse_peak_energy = energy;
+            if (ch->frame_corr_max > ch->corr_peak) {
+                ch->corr_peak = ch->frame_corr_max;
+                ch->corr_peak_sample = ch->frame_corr_max_sample;
+            }
+            if (ch->frame_other_max > ch->other_peak) ch->other_peak = ch->frame_other_max;
+
+            if (energy < ch->threshold_low) {
+                float duration_ms = ch->pulse_frames * FRAME_DURATION_MS;
+                double timestamp_ms = (double)frame * DUAL_FFT_SIZE * 1000.0 / DUAL_SAMPLE_RATE;
+                float corr_ratio = (ch->corr_noise_floor > 0.001f) ?
+                    ch->corr_peak / ch->corr_noise_floor : 0.0f;
+                float dominance = (ch->other_peak > 1e-9f) ?
+                    ch->corr_peak / ch->other_peak : 1000.0f;
+
+                bool is_marker = duration_ms >= DUAL_MARKER_MIN_DURATION_MS &&
+                                 duration_ms <= DUAL_MARKER_MAX_DURATION_MS;
+                bool is_tick = duration_ms >= DUAL_TICK_MIN_DURATION_MS &&
+                               duration_ms <= DUAL_TICK_MAX_DURATION_MS &&
+                               ch->corr_peak > ch->corr_noise_floor * CORR_THRESHOLD_MULT;
+                float since_marker_ms = (ch->last_marker_frame > 0) ?
+                    (ch->pulse_start_frame - ch->last_marker_frame) * FRAME_DURATION_MS :
+                    DUAL_MARKER_MIN_INTERVAL_MS;
+                bool dominant = dominance >= DUAL_DOMINANCE_MIN;
+
+                if (is_marker && dominant && since_marker_ms >= DUAL_MARKER_MIN_INTERVAL_MS) {
+                    ch->markers_detected++;
+                    ch->last_marker_frame = ch->pulse_start_frame;
+                    reported = true;
+                } else if (is_tick && dominant) {
+                    ch->ticks_detected++;
+                    reported = true;
+                } else {
+                    ch->rejected++;
+                }
+
+                /* Bleed from the other station must not blank our own tick a few ms later */
+                if (!reported && !dominant) {
+                    ch->state = STATE_IDLE;
+                    break;
+                }
+
+                if (reported) {
+                    ch->flash_frames_remaining = is_marker ? DUAL_FLASH_FRAMES * 6 : DUAL_FLASH_FRAMES;
+
+                    /* Ticks: matched filter peaks when the template covers the whole pulse.
+                     * Markers: 800 ms is far longer than the template, use the energy edge. */
+                    double leading_ms = is_marker ?
+                        timestamp_ms - duration_ms :
+                        ((double)ch->corr_peak_sample - DUAL_TEMPLATE_SAMPLES) * 1000.0 / DUAL_SAMPLE_RATE;
+                    float interval_ms = is_marker ? since_marker_ms : update_chain(ch, leading_ms);
+                    int number = is_marker ? ch->markers_detected : ch->ticks_detected;
+
+                    char time_str[16];
+                    get_wall_time_str(det, timestamp_ms, time_str, sizeof(time_str));
+
+                    if (det->csv_file) {
+                        fprintf(det->csv_file, "%s,%.1f,%s,%s%d,%.6f,%.1f,%.2f,%.0f,%.1f,%.2f,%.1f,%d,%.2f\n",
+                                time_str, timestamp_ms, wwv_station_name(ch->station),
+                                is_marker ? "M" : "", number, ch->pulse_peak_energy,
+                                duration_ms, leading_ms, interval_ms, corr_ratio, dominance,
+                                ch->corr_noise_floor, ch->chain_length, ch->epoch_ms);
+                        fflush(det->csv_file);
+                    }
+
+                    telem_sendf(TELEM_STATION, "%s,%.1f,%s,%s%d,%.6f,%.1f,%.2f,%.0f,%.1f,%.2f,%d,%.2f,%.2f",
+                                time_str, timestamp_ms, wwv_station_name(ch->station),
+                                is_marker ? "M" : "", number, ch->pulse_peak_energy,
+                                duration_ms, leading_ms, interval_ms, corr_ratio, dominance,
+                                ch->chain_length, ch->epoch_ms,
+                                det->delay_valid ? det->delay_ms : 0.0f);
+
+                    if (det->tick_callback) {
+                        station_tick_event_t event = {
+                            .station = ch->station,
+                            .tick_number = number,
+                            .is_marker = is_marker,
+                            .timestamp_ms = timestamp_ms,
+                            .leading_edge_ms = leading_ms,
+                            .duration_ms = duration_ms,
+                            .peak_energy = ch->pulse_peak_energy,
+                            .noise_floor = ch->noise_floor,
+                            .corr_peak = ch->corr_peak,
+                            .corr_ratio = corr_ratio,
+                            .dominance = dominance,
+                            .interval_ms = interval_ms,
+                            .chain_length = ch->chain_length,
+                            .epoch_ms = ch->epoch_ms
+                        };
+                        det->tick_callback(&event, det->tick_callback_user_data);
+                    }
+
+                    if (!is_marker) {
+                        update_delay(det);
+                    }
+                }
+
+                ch->state = STATE_COOLDOWN;
+                ch->cooldown_frames = MS_TO_FRAMES(DUAL_COOLDOWN_MS);
+            } else if (ch->pulse_frames * FRAME_DURATION_MS > DUAL_MARKER_MAX_DURATION_MS) {
+                ch->rejected++;
+                ch->state = STATE_COOLDOWN;
+                ch->cooldown_frames = MS_TO_FRAMES(DUAL_COOLDOWN_MS);
+            }
+            break;
+
+        case STATE_COOLDOWN:
+            if (--ch->cooldown_frames <= 0) {
+                ch->state = STATE_IDLE;
+            }
+            break;
+    }
+
+    return reported;
+}
+
+/*============================================================================
+ * Public API Implementation
+ *============================================================================*/
+
+dual_station_detector_t *dual_station_detector_create(const char *csv_path) {
+    dual_station_detector_t *det = (dual_station_detector_t *)calloc(1, sizeof(dual_station_detector_t));
+    if (!det) return NULL;
+
+    det->fft_cfg = kiss_fft_alloc(DUAL_FFT_SIZE, 0, NULL, NULL);
+    det->fft_in = (kiss_fft_cpx *)malloc(DUAL_FFT_SIZE * sizeof(kiss_fft_cpx));
+    det->fft_out = (kiss_fft_cpx *)malloc(DUAL_FFT_SIZE * sizeof(kiss_fft_cpx));
+    det->window_func = (float *)malloc(DUAL_FFT_SIZE * sizeof(float));
+    det->i_buffer = (float *)calloc(DUAL_FFT_SIZE, sizeof(float));
+    det->q_buffer = (float *)calloc(DUAL_FFT_SIZE, sizeof(float));
+    det->corr_buf_i = (float *)calloc(2 * DUAL_TEMPLATE_SAMPLES, sizeof(float));
+    det->corr_buf_q = (float *)calloc(2 * DUAL_TEMPLATE_SAMPLES, sizeof(float));
+
+    if (!det->fft_cfg || !det->fft_in || !det->fft_out || !det->window_func ||
+        !det->i_buffer || !det->q_buffer || !det->corr_buf_i || !det->corr_buf_q ||
+        !init_channel(&det->ch[WWV_STATION_WWV], WWV_STATION_WWV) ||
+        !init_channel(&det->ch[WWV_STATION_WWVH], WWV_STATION_WWVH)) {
+        dual_station_detector_destroy(det);
+        return NULL;
+    }
+
+    for (int i = 0; i < DUAL_FFT_SIZE; i++) {
+        det->window_func[i] = 0.5f * (1.0f - cosf(2.0f * M_PI * i / (DUAL_FFT_SIZE - 1)));
+    }
+
+    det->detection_enabled = true;
+    det->start_time = time(NULL);
+
+    if (csv_path) {
+        det->csv_file = fopen(csv_path, "w");
+        if (det->csv_file) {
+            char time_str[64];
+            time_t now = time(NULL);
+            strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", localtime(&now));
+            fprintf(det->csv_file, "# Phoenix SDR WWV/WWVH Dual Station Log v%s\n", PHOENIX_VERSION_FULL);
+            fprintf(det->csv_file, "# Started: %s\n", time_str);
+            fprintf(det->csv_file, "time,timestamp_ms,station,tick_num,energy_peak,duration_ms,leading_edge_ms,interval_ms,corr_ratio,dominance,corr_noise,chain_len,epoch_ms\n");
+            fflush(det->csv_file);
+        }
+    }
+
+    printf("[DUAL] Detector created: FFT=%d (%.1fms), bins %d/%d, templates=%d samples\n",
+           DUAL_FFT_SIZE, FRAME_DURATION_MS,
+           det->ch[WWV_STATION_WWV].center_bin, det->ch[WWV_STATION_WWVH].center_bin,
+           DUAL_TEMPLATE_SAMPLES);
+    printf("[DUAL] WWV %dHz / WWVH %dHz, logging to %s\n",
+           DUAL_WWV_FREQ_HZ, DUAL_WWVH_FREQ_HZ, csv_path ? csv_path : "(disabled)");
+
+    return det;
+}
+
+void dual_station_detector_destroy(dual_station_detector_t *det) {
+    if (!det) return;
+
+    if (det->csv_file) fclose(det->csv_file);
+    if (det->fft_cfg) kiss_fft_free(det->fft_cfg);
+    free(det->fft_in);
+    free(det->fft_out);
+    free(det->window_func);
+    free(det->i_buffer);
+    free(det->q_buffer);
+    free(det->corr_buf_i);
+    free(det->corr_buf_q);
+    for (int s = 0; s < NUM_STATIONS; s++) {
+        free(det->ch[s].template_i);
+        free(det->ch[s].template_q);
+    }
+    free(det);
+}
+
+void dual_station_detector_set_tick_callback(dual_station_detector_t *det,
+                                             station_tick_callback_fn callback,
+                                             void *user_data) {
+    if (!det) return;
+    det->tick_callback = callback;
+    det->tick_callback_user_data = user_data;
+}
+
+void dual_station_detector_set_delay_callback(dual_station_detector_t *det,
+                                              station_delay_callback_fn callback,
+                                              void *user_data) {
+    if (!det) return;
+    det->delay_callback = callback;
+    det->delay_callback_user_data = user_data;
+}
+
+bool dual_station_detector_process_sample(dual_station_detector_t *det,
+                                          float i_sample, float q_sample) {
+    if (!det || !det->detection_enabled) return false;
+
+    station_channel_t *wwv = &det->ch[WWV_STATION_WWV];
+    station_channel_t *wwvh = &det->ch[WWV_STATION_WWVH];
+
+    /* Mirrored write keeps the newest window contiguous */
+    det->corr_buf_i[det->corr_buf_idx] = i_sample;
+    det->corr_buf_q[det->corr_buf_idx] = q_sample;
+    det->corr_buf_i[det->corr_buf_idx + DUAL_TEMPLATE_SAMPLES] = i_sample;
+    det->corr_buf_q[det->corr_buf_idx + DUAL_TEMPLATE_SAMPLES] = q_sample;
+    if (++det->corr_buf_idx >= DUAL_TEMPLATE_SAMPLES) {
+        det->corr_buf_idx = 0;
+    }
+    det->sample_count++;
+
+    int decimation = (wwv->state == STATE_IN_PULSE || wwvh->state == STATE_IN_PULSE) ?
+                     CORR_DECIMATION : CORR_IDLE_DECIMATION;
+    if (det->sample_count >= DUAL_TEMPLATE_SAMPLES && (det->sample_count % decimation) == 0) {
+        float corr_wwv, corr_wwvh;
+        compute_correlations(det, &corr_wwv, &corr_wwvh);
+        update_correlation(wwv, corr_wwv, corr_wwvh, det->sample_count, det->hold);
+        update_correlation(wwvh, corr_wwvh, corr_wwv, det->sample_count, det->hold);
+    }
+
+    det->i_buffer[det->buffer_idx] = i_sample;
+    det->q_buffer[det->buffer_idx] = q_sample;
+    if (++det->buffer_idx < DUAL_FFT_SIZE) {
+        return false;
+    }
+    det->buffer_idx = 0;
+
+    for (int i = 0; i < DUAL_FFT_SIZE; i++) {
+        det->fft_in[i].r = det->i_buffer[i] * det->window_func[i];
+        det->fft_in[i].i = det->q_buffer[i] * det->window_func[i];
+    }
+    kiss_fft(det->fft_cfg, det->fft_in, det->fft_out);
+
+    /* Positive + negative frequency, as in tick_detector */
+    for (int s = 0; s < NUM_STATIONS; s++) {
+        station_channel_t *ch = &det->ch[s];
+        ch->energy = bin_energy(det->fft_out, ch->center_bin) +
+                     bin_energy(det->fft_out, DUAL_FFT_SIZE - ch->center_bin);
+    }
+
+    if (!det->warmup_complete && det->frame_count >= DUAL_WARMUP_FRAMES) {
+        det->warmup_complete = true;
+        printf("[DUAL] Warmup complete. WWV noise=%.4f, WWVH noise=%.4f\n",
+               wwv->noise_floor, wwvh->noise_floor);
+    }
+
+    bool reported = run_station(det, wwv);
+    reported |= run_station(det, wwvh);
+
+    for (int s = 0; s < NUM_STATIONS; s++) {
+        det->ch[s].frame_corr_max = 0.0f;
+        det->ch[s].frame_other_max = 0.0f;
+    }
+
+    det->frame_count++;
+    return reported;
+}
+
+int dual_station_detector_get_tick_count(dual_station_detector_t *det, wwv_station_t station) {
+    return det ? det->ch[station].ticks_detected : 0;
+}
+
+int dual_station_detector_get_marker_count(dual_station_detector_t *det, wwv_station_t station) {
+    return det ? det->ch[station].markers_detected : 0;
+}
+
+int dual_station_detector_get_rejected_count(dual_station_detector_t *det, wwv_station_t station) {
+    return det ? det->ch[station].rejected : 0;
+}
+
+int dual_station_detector_get_chain_length(dual_station_detector_t *det, wwv_station_t station) {
+    return det ? det->ch[station].chain_length : 0;
+}
+
+bool dual_station_detector_get_epoch(dual_station_detector_t *det, wwv_station_t station,
+                                     float *epoch_ms) {
+    if (!det || !det->ch[station].epoch_valid) return false;
+    if (epoch_ms) *epoch_ms = det->ch[station].epoch_ms;
+    return true;
+}
+
+float dual_station_detector_get_threshold(dual_station_detector_t *det, wwv_station_t station) {
+    return det ? det->ch[station].threshold_high : 0.0f;
+}
+
+float dual_station_detector_get_noise_floor(dual_station_detector_t *det, wwv_station_t station) {
+    return det ? det->ch[station].noise_floor : 0.0f;
+}
+
+int dual_station_detector_get_flash_frames(dual_station_detector_t *det, wwv_station_t station) {
+    return det ? det->ch[station].flash_frames_remaining : 0;
+}
+
+void dual_station_detector_decrement_flash(dual_station_detector_t *det, wwv_station_t station) {
+    if (det && det->ch[station].flash_frames_remaining > 0) {
+        det->ch[station].flash_frames_remaining--;
+    }
+}
+
+bool dual_station_detector_get_relative_delay(dual_station_detector_t *det, float *delay_ms) {
+    if (!det || !det->delay_valid) return false;
+    if (delay_ms) *delay_ms = det->delay_ms;
+    return true;
+}
+
+void dual_station_detector_set_enabled(dual_station_detector_t *det, bool enabled) {
+    if (det) det->detection_enabled = enabled;
+}
+
+void dual_station_detector_set_hold(dual_station_detector_t *det, bool hold) {
+    if (det) det->hold = hold;
+}
+
+bool dual_station_detector_get_enabled(dual_station_detector_t *det) {
+    return det ? det->detection_enabled : false;
+}
+
+uint64_t dual_station_detector_get_sample_count(dual_station_detector_t *det) {
+    return det ? det->sample_count : 0;
+}
+
+void dual_station_detector_print_stats(dual_station_detector_t *det) {
+    if (!det) return;
+
+    float elapsed = det->sample_count * SAMPLE_MS / 1000.0f;
+    printf("\n=== DUAL STATION DETECTOR STATS ===\n");
+    printf("Elapsed: %.1f sec\n", elapsed);
+    for (int s = 0; s < NUM_STATIONS; s++) {
+        station_channel_t *ch = &det->ch[s];
+        printf("%-5s %dHz: ticks=%d markers=%d rejected=%d chain=%d epoch=%s%.2fms\n",
+               wwv_station_name(ch->station), ch->freq_hz,
+               ch->ticks_detected, ch->markers_detected, ch->rejected, ch->chain_length,
+               ch->epoch_valid ? "" : "~", ch->epoch_ms);
+    }
+    if (det->delay_valid) {
+        printf("WWVH - WWV delay: %+.2f ms (%d measurements)\n",
+               det->delay_ms, det->delay_measurements);
+    } else {
+        printf("WWVH - WWV delay: (not locked)\n");
+    }
+    printf("===================================\n");
+}
@@ -0,0 +1,145 @@
+/**
+ * @file dual_station_detector.h
+ * @brief Simultaneous WWV / WWVH tick separation
+ *
+ * WWV (Fort Collins) ticks at 1000 Hz, WWVH (Kauai) at 1200 Hz. On 2.5,
+ * 5, 10 and 15 MHz both stations are often heard at once, offset by the
+ * difference in propagation delay. Running two tick_detector instances
+ * would double the FFT and matched filter work and still let each station
+ * bleed into the other's bucket.
+ *
+ * This detector shares one front end between both stations:
+ *   - One sample buffer and one 256-point FFT per frame, read at both
+ *     the 1000 Hz and 1200 Hz buckets
+ *   - One mirrored correlation buffer, correlated against both 5 ms
+ *     templates in a single pass (every 8th sample while a pulse is
+ *     active, every 32nd otherwise)
+ *
+ * Each station then keeps its own state machine, tick chain and epoch.
+ * A pulse is only credited to a station if its matched filter response
+ * dominates the other station's response over the same window. Once both
+ * epochs are locked, the WWVH - WWV relative delay is reported.
+ *
+ * Input: 50 kHz complex baseband from the sync channel (same as
+ * tick_detector).
+ */
+
+#ifndef DUAL_STATION_DETECTOR_H
+#define DUAL_STATION_DETECTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "wwv_clock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define DUAL_SAMPLE_RATE        50000   /* Same 50 kHz detector path as tick_detector */
+#define DUAL_FFT_SIZE           256     /* 5.12 ms frames */
+#define DUAL_WWV_FREQ_HZ        1000    /* WWV tick tone */
+#define DUAL_WWVH_FREQ_HZ       1200    /* WWVH tick tone */
+
+#define DUAL_PULSE_MS           5.0f
+#define DUAL_TEMPLATE_SAMPLES   ((int)(DUAL_PULSE_MS * DUAL_SAMPLE_RATE / 1000.0f))  /* 250 samples */
+
+#define DUAL_MIN_CHAIN          5       /* Ticks in chain before epoch is trusted */
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct dual_station_detector dual_station_detector_t;
+
+/** Tick or minute marker credited to one station */
+typedef struct {
+    wwv_station_t station;
+    int tick_number;            /* Per-station count (ticks or markers) */
+    bool is_marker;             /* 800 ms minute marker instead of 5 ms tick */
+    double timestamp_ms;        /* TRAILING EDGE - frame where energy dropped */
+    double leading_edge_ms;     /* LEADING EDGE - from matched filter peak */
+    float duration_ms;
+    float peak_energy;
+    float noise_floor;          /* Station energy noise floor */
+    float corr_peak;            /* Own matched filter peak */
+    float corr_ratio;           /* Own matched filter peak / own noise floor */
+    float dominance;            /* Own matched filter peak / other station's peak */
+    float interval_ms;          /* Leading edge to previous tick (0 if first) */
+    int chain_length;           /* Consecutive on-second ticks */
+    float epoch_ms;             /* Station second boundary, 0-1000 ms */
+} station_tick_event_t;
+
+typedef void (*station_tick_callback_fn)(const station_tick_event_t *event, void *user_data);
+
+/** Relative arrival of WWVH vs WWV */
+typedef struct {
+    float delay_ms;             /* Smoothed WWVH - WWV, (-500, 500] ms */
+    float raw_delay_ms;         /* Latest unsmoothed measurement */
+    float wwv_epoch_ms;
+    float wwvh_epoch_ms;
+    int wwv_chain;
+    int wwvh_chain;
+    int measurements;
+} station_delay_event_t;
+
+typedef void (*station_delay_callback_fn)(const station_delay_event_t *event, void *user_data);
+
+/*============================================================================
+ * API
+ *============================================================================*/
+
+/** Create detector. csv_path may be NULL to disable logging. */
+dual_station_detector_t *dual_station_detector_create(const char *csv_path);
+void dual_station_detector_destroy(dual_station_detector_t *det);
+
+void dual_station_detector_set_tick_callback(dual_station_detector_t *det,
+                                             station_tick_callback_fn callback,
+                                             void *user_data);
+void dual_station_detector_set_delay_callback(dual_station_detector_t *det,
+                                              station_delay_callback_fn callback,
+                                              void *user_data);
+
+/**
+ * Process one 50 kHz sample
+ * @return true if either station produced a tick or marker on this sample
+ */
+bool dual_station_detector_process_sample(dual_station_detector_t *det,
+                                          float i_sample, float q_sample);
+
+/* Per-station state */
+int dual_station_detector_get_tick_count(dual_station_detector_t *det, wwv_station_t station);
+int dual_station_detector_get_marker_count(dual_station_detector_t *det, wwv_station_t station);
+int dual_station_detector_get_rejected_count(dual_station_detector_t *det, wwv_station_t station);
+int dual_station_detector_get_chain_length(dual_station_detector_t *det, wwv_station_t station);
+bool dual_station_detector_get_epoch(dual_station_detector_t *det, wwv_station_t station,
+                                     float *epoch_ms);
+float dual_station_detector_get_threshold(dual_station_detector_t *det, wwv_station_t station);
+float dual_station_detector_get_noise_floor(dual_station_detector_t *det, wwv_station_t station);
+
+/* Flash state for UI (frames remaining, decrement once per display frame) */
+int dual_station_detector_get_flash_frames(dual_station_detector_t *det, wwv_station_t station);
+void dual_station_detector_decrement_flash(dual_station_detector_t *det, wwv_station_t station);
+
+/** Smoothed WWVH - WWV delay. Returns false until both epochs are locked. */
+bool dual_station_detector_get_relative_delay(dual_station_detector_t *det, float *delay_ms);
+
+void dual_station_detector_set_enabled(dual_station_detector_t *det, bool enabled);
+bool dual_station_detector_get_enabled(dual_station_detector_t *det);
+
+/** Hold both stations' noise floors (blanked or settling input upstream) */
+void dual_station_detector_set_hold(dual_station_detector_t *det, bool hold);
+
+/** Samples processed (50 kHz) */
+uint64_t dual_station_detector_get_sample_count(dual_station_detector_t *det);
+
+void dual_station_detector_print_stats(dual_station_detector_t *det);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DUAL_STATION_DETECTOR_H */
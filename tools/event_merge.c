@@ -0,0 +1,224 @@
+/**
+ * @file event_merge.c
+ * @brief Deterministic merge of timestamped detector events
+ *
+ * Each producer owns a single-producer/single-consumer ring. The consumer
+ * repeatedly picks the smallest (sample, producer) head across all rings
+ * and delivers it only if no producer with an empty ring could still emit
+ * something that sorts before it - which its watermark rules out.
+ *
+ * The producer releases the ring tail before it releases a watermark, and
+ * the consumer acquires the watermark before it looks at the tail, so a
+ * watermark the consumer has seen always covers events it can also see.
+ */
+
+#include "event_merge.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+#define CACHE_LINE  64
+
+typedef struct {
+    /* Producer side */
+    atomic_size_t tail;
+    atomic_uint_least64_t watermark;
+    atomic_uint_least64_t full_waits;
+    uint64_t last_sample;               /* Producer-private ordering check */
+    uint32_t seq;
+    char pad0[CACHE_LINE];
+
+    /* Consumer side */
+    atomic_size_t head;
+    char pad1[CACHE_LINE];
+
+    merge_event_t *slots;
+} merge_queue_t;
+
+struct event_merge {
+    int num_producers;
+    size_t capacity;                    /* Power of 2 */
+    size_t mask;
+    atomic_uint_least64_t delivered;
+    merge_queue_t queues[EVENT_MERGE_MAX_PRODUCERS];
+};
+
+/*============================================================================
+ * Create / Destroy
+ *============================================================================*/
+
+event_merge_t *event_merge_create(int num_producers, int queue_capacity) {
+    if (num_producers < 1 || num_producers > EVENT_MERGE_MAX_PRODUCERS || queue_capacity < 1) {
+        return NULL;
+    }
+
+    event_merge_t *merge = (event_merge_t *)calloc(1, sizeof(event_merge_t));
+    if (!merge) return NULL;
+
+    size_t capacity = 1;
+    while (capacity < (size_t)queue_capacity) capacity <<= 1;
+
+    merge->num_producers = num_producers;
+    merge->capacity = capacity;
+    merge->mask = capacity - 1;
+    atomic_init(&merge->delivered, 0);
+
+    for (int p = 0; p < num_producers; p++) {
+        merge_queue_t *q = &merge->queues[p];
+        q->slots = (merge_event_t *)calloc(capacity, sizeof(merge_event_t));
+        if (!q->slots) {
+            event_merge_destroy(merge);
+            return NULL;
+        }
+        atomic_init(&q->tail, 0);
+        atomic_init(&q->head, 0);
+        atomic_init(&q->watermark, 0);
+        atomic_init(&q->full_waits, 0);
+    }
+
+    return merge;
+}
+
+void event_merge_destroy(event_merge_t *merge) {
+    if (!merge) return;
+    for (int p = 0; p < merge->num_producers; p++) {
+        free(merge->queues[p].slots);
+    }
+    free(merge);
+}
+
+/*============================================================================
+ * Producer Side
+ *============================================================================*/
+
+bool event_merge_push(event_merge_t *merge, int producer, uint64_t sample,
+                      uint16_t type, const void *payload, size_t size) {
+    if (!merge || producer < 0 || producer >= merge->num_producers) return false;
+    if (size > EVENT_MERGE_PAYLOAD_SIZE || (size && !payload)) return false;
+
+    merge_queue_t *q = &merge->queues[producer];
+    if (sample < q->last_sample ||
+        sample < atomic_load_explicit(&q->watermark, memory_order_relaxed)) {
+        return false;
+    }
+
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (tail - head >= merge->capacity) {
+        atomic_fetch_add_explicit(&q->full_waits, 1, memory_order_relaxed);
+        return false;
+    }
+
+    merge_event_t *ev = &q->slots[tail & merge->mask];
+    ev->sample = sample;
+    ev->seq = q->seq++;
+    ev->producer = (uint16_t)producer;
+    ev->type = type;
+    if (size) memcpy(ev->payload.bytes, payload, size);
+
+    q->last_sample = sample;
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+void event_merge_advance(event_merge_t *merge, int producer, uint64_t watermark) {
+    if (!merge || producer < 0 || producer >= merge->num_producers) return;
+    merge_queue_t *q = &merge->queues[producer];
+    if (watermark > atomic_load_explicit(&q->watermark, memory_order_relaxed)) {
+        atomic_store_explicit(&q->watermark, watermark, memory_order_release);
+    }
+}
+
+void event_merge_close(event_merge_t *merge, int producer) {
+    event_merge_advance(merge, producer, UINT64_MAX);
+}
+
+/*============================================================================
+ * Consumer Side
+ *============================================================================*/
+
+int event_merge_drain(event_merge_t *merge, event_merge_fn fn, void *user_data) {
+    if (!merge || !fn) return 0;
+
+    int delivered = 0;
+    uint64_t watermark[EVENT_MERGE_MAX_PRODUCERS];
+    const merge_event_t *front[EVENT_MERGE_MAX_PRODUCERS];
+
+    for (;;) {
+        /* Snapshot every producer: watermark first, then ring contents */
+        int best = -1;
+        for (int p = 0; p < merge->num_producers; p++) {
+            merge_queue_t *q = &merge->queues[p];
+            watermark[p] = atomic_load_explicit(&q->watermark, memory_order_acquire);
+            size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+            size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+            front[p] = (tail != head) ? &q->slots[head & merge->mask] : NULL;
+
+            /* Lower rank wins ties, so strict < keeps the earlier producer */
+            if (front[p] && (best < 0 || front[p]->sample < front[best]->sample)) {
+                best = p;
+            }
+        }
+        if (best < 0) break;
+
+        /* An idle producer may still emit at or below its watermark */
+        uint64_t sample = front[best]->sample;
+        bool safe = true;
+        for (int p = 0; p < merge->num_producers && safe; p++) {
+            if (p == best || front[p]) continue;
+            if (watermark[p] < sample || (watermark[p] == sample && p < best)) {
+                safe = false;
+            }
+        }
+        if (!safe) break;
+
+        fn(front[best], user_data);
+
+        merge_queue_t *q = &merge->queues[best];
+        size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+        atomic_store_explicit(&q->head, head + 1, memory_order_release);
+        delivered++;
+    }
+
+    if (delivered) {
+        atomic_fetch_add_explicit(&merge->delivered, (uint64_t)delivered, memory_order_relaxed);
+    }
+    return delivered;
+}
+
+uint64_t event_merge_watermark(event_merge_t *merge) {
+    if (!merge) return 0;
+    uint64_t low = UINT64_MAX;
+    for (int p = 0; p < merge->num_producers; p++) {
+        uint64_t w = atomic_load_explicit(&merge->queues[p].watermark, memory_order_acquire);
+        if (w < low) low = w;
+    }
+    return low;
+}
+
+size_t event_merge_pending(event_merge_t *merge) {
+    if (!merge) return 0;
+    size_t pending = 0;
+    for (int p = 0; p < merge->num_producers; p++) {
+        merge_queue_t *q = &merge->queues[p];
+        pending += atomic_load_explicit(&q->tail, memory_order_acquire) -
+                   atomic_load_explicit(&q->head, memory_order_acquire);
+    }
+    return pending;
+}
+
+void event_merge_get_stats(event_merge_t *merge, uint64_t *delivered, uint64_t *full_waits) {
+    if (!merge) return;
+    if (delivered) *delivered = atomic_load_explicit(&merge->delivered, memory_order_relaxed);
+    if (full_waits) {
+        uint64_t waits = 0;
+        for (int p = 0; p < merge->num_producers; p++) {
+            waits += atomic_load_explicit(&merge->queues[p].full_waits, memory_order_relaxed);
+        }
+        *full_waits = waits;
+    }
+}
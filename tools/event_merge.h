@@ -0,0 +1,120 @@
+/**
+ * @file event_merge.h
+ * @brief Deterministic merge of timestamped detector events
+ *
+ * Detector paths that run on separate threads emit events into their own
+ * single-producer queues, stamped with the input sample index they were
+ * produced at. Each producer also publishes a watermark: a promise that it
+ * will never again emit an event below that sample index. A single
+ * consumer drains the queues in (sample, producer, sequence) order, and
+ * only as far as every producer's watermark allows, so the correlators
+ * see exactly the callback order a serial run would have produced -
+ * regardless of how the threads were scheduled.
+ *
+ * Producer rank breaks ties: at the same sample index, producer 0's events
+ * are delivered before producer 1's. Register producers in the order the
+ * serial loop ran them.
+ *
+ * Threading: one thread per producer, one consumer thread. Lock-free.
+ */
+
+#ifndef EVENT_MERGE_H
+#define EVENT_MERGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define EVENT_MERGE_MAX_PRODUCERS   4
+#define EVENT_MERGE_PAYLOAD_SIZE    48      /* Bytes - fits every detector event struct */
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct event_merge event_merge_t;
+
+typedef struct {
+    uint64_t sample;                    /* Input sample index of the event */
+    uint32_t seq;                       /* Per-producer sequence number */
+    uint16_t producer;                  /* Producer rank (tie-break order) */
+    uint16_t type;                      /* Caller-defined event type */
+    union {
+        uint8_t bytes[EVENT_MERGE_PAYLOAD_SIZE];
+        double  align;                  /* Payload may hold any detector struct */
+    } payload;
+} merge_event_t;
+
+typedef void (*event_merge_fn)(const merge_event_t *event, void *user_data);
+
+/*============================================================================
+ * API
+ *============================================================================*/
+
+/**
+ * @brief Create a merge stage
+ * @param num_producers   1 .. EVENT_MERGE_MAX_PRODUCERS
+ * @param queue_capacity  Events per producer queue (rounded up to a power of 2)
+ */
+event_merge_t *event_merge_create(int num_producers, int queue_capacity);
+
+void event_merge_destroy(event_merge_t *merge);
+
+/**
+ * @brief Queue an event (producer thread)
+ *
+ * Sample indices must not decrease within a producer and must not be below
+ * the producer's current watermark.
+ *
+ * @return false if the queue is full (retry after the consumer drains) or
+ *         the event breaks the ordering contract
+ */
+bool event_merge_push(event_merge_t *merge, int producer, uint64_t sample,
+                      uint16_t type, const void *payload, size_t size);
+
+/**
+ * @brief Promise no further events below a sample index (producer thread)
+ */
+void event_merge_advance(event_merge_t *merge, int producer, uint64_t watermark);
+
+/**
+ * @brief Producer is finished - never holds back the merge again
+ */
+void event_merge_close(event_merge_t *merge, int producer);
+
+/**
+ * @brief Deliver every event that is safe to deliver, in order (consumer thread)
+ * @return Number of events delivered
+ */
+int event_merge_drain(event_merge_t *merge, event_merge_fn fn, void *user_data);
+
+/**
+ * @brief Lowest watermark across producers
+ */
+uint64_t event_merge_watermark(event_merge_t *merge);
+
+/**
+ * @brief Events queued but not yet delivered (approximate while producers run)
+ */
+size_t event_merge_pending(event_merge_t *merge);
+
+/**
+ * @brief Delivery statistics
+ * @param delivered   Total events delivered
+ * @param full_waits  Pushes refused because a queue was full
+ */
+void event_merge_get_stats(event_merge_t *merge, uint64_t *delivered, uint64_t *full_waits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EVENT_MERGE_H */
@@ -0,0 +1,289 @@
+/**
+ * @file fft_filter_bank.c
+ * @brief Overlap-save FFT filter bank implementation
+ *
+ * Block layout (N = fft_size, L = N/2 new samples, M = L + 1 taps):
+ *
+ *   in[0 .. L-1]   previous L inputs (history, zeros at start)
+ *   in[L .. N-1]   new inputs
+ *
+ * After the circular convolution the last L points are the valid linear
+ * outputs. Decimating by D keeps every D-th of those, which in the
+ * frequency domain is summing the D aliases of each of N/D bins.
+ */
+
+#include "fft_filter_bank.h"
+#include "kiss_fft.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Hamming window: ~53 dB stopband, transition width ~3.3 * fs / taps */
+#define TRANSITION_FACTOR   3.3f
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+typedef struct {
+    int decimation;
+    int small_size;             /* N / decimation */
+    float *taps;                /* M real coefficients (for response queries) */
+    kiss_fft_cpx *H;            /* N-point response, pre-scaled by 1/N */
+    kiss_fft_cfg ifft;          /* small_size-point inverse */
+    kiss_fft_cpx *folded;
+    kiss_fft_cpx *time;
+    float *out;                 /* 2 * L / decimation */
+    int out_count;
+    uint64_t out_position;      /* Input position of out[0] */
+} band_t;
+
+struct fft_filter_bank {
+    float sample_rate;
+    int fft_size;               /* N */
+    int block;                  /* L = N / 2 */
+    int taps;                   /* M = L + 1 */
+
+    kiss_fft_cfg fft;
+    kiss_fft_cpx *in;
+    kiss_fft_cpx *spectrum;
+    int fill;
+    uint64_t pushed;            /* Inputs since create/reset */
+    int skip;                   /* Raw outputs still to drop for zero-phase alignment */
+    bool started;
+
+    band_t bands[FFT_BANK_MAX_BANDS];
+    int num_bands;
+};
+
+/*============================================================================
+ * Filter Design
+ *============================================================================*/
+
+/* Ideal lowpass with cutoff fc (normalized to fs) at tap offset m */
+static double ideal_lowpass(double fc, double m) {
+    if (fc <= 0.0) return 0.0;
+    if (m == 0.0) return 2.0 * fc;
+    return sin(2.0 * M_PI * fc * m) / (M_PI * m);
+}
+
+static double taps_response(const float *taps, int n, double f_norm) {
+    double re = 0.0, im = 0.0;
+    for (int k = 0; k < n; k++) {
+        re += taps[k] * cos(2.0 * M_PI * f_norm * k);
+        im -= taps[k] * sin(2.0 * M_PI * f_norm * k);
+    }
+    return sqrt(re * re + im * im);
+}
+
+static void design_band(float *taps, int n, double f_lo, double f_hi) {
+    double center = (n - 1) / 2.0;
+    for (int k = 0; k < n; k++) {
+        double m = k - center;
+        double w = 0.54 - 0.46 * cos(2.0 * M_PI * k / (n - 1));
+        taps[k] = (float)(w * (ideal_lowpass(f_hi, m) - ideal_lowpass(f_lo, m)));
+    }
+
+    /* Unity gain at DC (lowpass) or mid-band (bandpass) */
+    double g = taps_response(taps, n, f_lo > 0.0 ? (f_lo + f_hi) / 2.0 : 0.0);
+    if (g > 0.0) {
+        for (int k = 0; k < n; k++) taps[k] = (float)(taps[k] / g);
+    }
+}
+
+/*============================================================================
+ * Public API Implementation
+ *============================================================================*/
+
+fft_filter_bank_t *fft_filter_bank_create(float sample_rate, int fft_size) {
+    if (sample_rate <= 0.0f || fft_size < 64 || (fft_size & (fft_size - 1)) != 0) return NULL;
+
+    fft_filter_bank_t *bank = calloc(1, sizeof(fft_filter_bank_t));
+    if (!bank) return NULL;
+
+    bank->sample_rate = sample_rate;
+    bank->fft_size = fft_size;
+    bank->block = fft_size / 2;
+    bank->taps = bank->block + 1;
+    bank->skip = bank->block / 2;
+
+    bank->fft = kiss_fft_alloc(fft_size, 0, NULL, NULL);
+    bank->in = calloc(fft_size, sizeof(kiss_fft_cpx));
+    bank->spectrum = calloc(fft_size, sizeof(kiss_fft_cpx));
+    if (!bank->fft || !bank->in || !bank->spectrum) {
+        fft_filter_bank_destroy(bank);
+        return NULL;
+    }
+    return bank;
+}
+
+void fft_filter_bank_destroy(fft_filter_bank_t *bank) {
+    if (!bank) return;
+    for (int b = 0; b < bank->num_bands; b++) {
+        band_t *band = &bank->bands[b];
+        free(band->taps);
+        free(band->H);
+        if (band->ifft) kiss_fft_free(band->ifft);
+        free(band->folded);
+        free(band->time);
+        free(band->out);
+    }
+    if (bank->fft) kiss_fft_free(bank->fft);
+    free(bank->in);
+    free(bank->spectrum);
+    free(bank);
+}
+
+int fft_filter_bank_add_band(fft_filter_bank_t *bank, float low_hz, float high_hz,
+                             int decimation) {
+    if (!bank || bank->started || bank->num_bands >= FFT_BANK_MAX_BANDS) return -1;
+    if (low_hz < 0.0f || high_hz <= low_hz) return -1;
+    if (decimation < 1 || (decimation & (decimation - 1)) != 0 ||
+        decimation > bank->block / 2) return -1;
+
+    float fs = bank->sample_rate;
+    float tw = TRANSITION_FACTOR * fs / bank->taps;
+    float f_lo = low_hz > tw / 2.0f ? low_hz - tw / 2.0f : 0.0f;
+    float f_hi = high_hz + tw / 2.0f;
+    if (f_hi >= fs / 2.0f) return -1;
+
+    /* Aliases of the stopband must not land in the passband */
+    if (fs / decimation < 2.0f * high_hz + tw) return -1;
+
+    band_t *band = &bank->bands[bank->num_bands];
+    int n = bank->fft_size;
+    band->decimation = decimation;
+    band->small_size = n / decimation;
+    band->taps = calloc(bank->taps, sizeof(float));
+    band->H = calloc(n, sizeof(kiss_fft_cpx));
+    band->ifft = kiss_fft_alloc(band->small_size, 1, NULL, NULL);
+    band->folded = calloc(band->small_size, sizeof(kiss_fft_cpx));
+    band->time = calloc(band->small_size, sizeof(kiss_fft_cpx));
+    band->out = calloc(2 * (bank->block / decimation), sizeof(float));
+    if (!band->taps || !band->H || !band->ifft || !band->folded || !band->time || !band->out) {
+        free(band->taps);
+        free(band->H);
+        if (band->ifft) kiss_fft_free(band->ifft);
+        free(band->folded);
+        free(band->time);
+        free(band->out);
+        memset(band, 0, sizeof(*band));
+        return -1;
+    }
+
+    design_band(band->taps, bank->taps, f_lo / fs, f_hi / fs);
+
+    /* H = FFT(taps zero-padded to N) / N, so the inverse needs no scaling */
+    for (int k = 0; k < bank->taps; k++) {
+        band->H[k].r = band->taps[k] / (float)n;
+    }
+    kiss_fft(bank->fft, band->H, band->H);      /* kiss_fft allows in-place */
+
+    return bank->num_bands++;
+}
+
+static void process_block(fft_filter_bank_t *bank) {
+    int n = bank->fft_size;
+    int l = bank->block;
+
+    kiss_fft(bank->fft, bank->in, bank->spectrum);
+
+    for (int b = 0; b < bank->num_bands; b++) {
+        band_t *band = &bank->bands[b];
+        int ns = band->small_size;
+
+        /* Multiply by H and fold the D aliases onto N/D bins */
+        for (int m = 0; m < ns; m++) {
+            float re = 0.0f, im = 0.0f;
+            for (int k = m; k < n; k += ns) {
+                const kiss_fft_cpx x = bank->spectrum[k];
+                const kiss_fft_cpx h = band->H[k];
+                re += x.r * h.r - x.i * h.i;
+                im += x.r * h.i + x.i * h.r;
+            }
+            band->folded[m].r = re;
+            band->folded[m].i = im;
+        }
+        kiss_fft(band->ifft, band->folded, band->time);
+
+        /* Valid outputs are the last L raw points = last ns/2 decimated */
+        int first = ns / 2 + bank->skip / band->decimation;
+        band->out_count = ns - first;
+        band->out_position = bank->pushed - (uint64_t)(l / 2) -
+                             (uint64_t)band->out_count * (uint64_t)band->decimation;
+        for (int k = 0; k < band->out_count; k++) {
+            band->out[2 * k] = band->time[first + k].r;
+            band->out[2 * k + 1] = band->time[first + k].i;
+        }
+    }
+    bank->skip = 0;
+
+    memmove(bank->in, bank->in + l, l * sizeof(kiss_fft_cpx));
+    bank->fill = 0;
+}
+
+bool fft_filter_bank_push(fft_filter_bank_t *bank, float i_sample, float q_sample) {
+    if (!bank) return false;
+    bank->started = true;
+
+    kiss_fft_cpx *slot = &bank->in[bank->block + bank->fill];
+    slot->r = i_sample;
+    slot->i = q_sample;
+    bank->pushed++;
+    if (++bank->fill < bank->block) return false;
+
+    process_block(bank);
+    return true;
+}
+
+const float *fft_filter_bank_output(const fft_filter_bank_t *bank, int band, int *count) {
+    if (!bank || band < 0 || band >= bank->num_bands) {
+        if (count) *count = 0;
+        return NULL;
+    }
+    if (count) *count = bank->bands[band].out_count;
+    return bank->bands[band].out;
+}
+
+void fft_filter_bank_reset(fft_filter_bank_t *bank) {
+    if (!bank) return;
+    memset(bank->in, 0, bank->fft_size * sizeof(kiss_fft_cpx));
+    bank->fill = 0;
+    bank->pushed = 0;
+    bank->skip = bank->block / 2;
+    for (int b = 0; b < bank->num_bands; b++) {
+        bank->bands[b].out_count = 0;
+        bank->bands[b].out_position = 0;
+    }
+}
+
+uint64_t fft_filter_bank_output_position(const fft_filter_bank_t *bank, int band) {
+    if (!bank || band < 0 || band >= bank->num_bands) return 0;
+    return bank->bands[band].out_position;
+}
+
+int fft_filter_bank_decimation(const fft_filter_bank_t *bank, int band) {
+    if (!bank || band < 0 || band >= bank->num_bands) return 1;
+    return bank->bands[band].decimation;
+}
+
+float fft_filter_bank_output_rate(const fft_filter_bank_t *bank, int band) {
+    if (!bank || band < 0 || band >= bank->num_bands) return 0.0f;
+    return bank->sample_rate / bank->bands[band].decimation;
+}
+
+int fft_filter_bank_latency_samples(const fft_filter_bank_t *bank) {
+    /* Worst case: first sample of a block waits for the rest of it, plus
+     * the half-filter look-ahead that zero-phase alignment needs */
+    return bank ? bank->block + bank->block / 2 : 0;
+}
+
+float fft_filter_bank_response(const fft_filter_bank_t *bank, int band, float freq_hz) {
+    if (!bank || band < 0 || band >= bank->num_bands) return 0.0f;
+    return (float)taps_response(bank->bands[band].taps, bank->taps,
+                                fabsf(freq_hz) / bank->sample_rate);
+}
@@ -0,0 +1,114 @@
+/**
+ * @file fft_filter_bank.h
+ * @brief Overlap-save FFT filter bank for the 50 kHz detector path
+ *
+ * Replaces per-sample biquad channels with linear-phase FIR bands that all
+ * share one forward FFT per block:
+ *
+ *   block of L new I/Q samples -> N-point FFT (N = 2L, L = taps - 1)
+ *     -> per band: multiply by H, fold to N/D bins, N/D-point IFFT
+ *     -> L/D decimated outputs
+ *
+ * Each band is a real-coefficient windowed-sinc bandpass (or lowpass when
+ * low_hz is 0), so like the biquads it passes +f and -f of the complex
+ * input. Folding the spectrum before the inverse FFT is the same as keeping
+ * every D-th output, so a narrow band pays only for its own small IFFT.
+ *
+ * Outputs are zero-phase aligned: the constant FIR group delay is removed
+ * by dropping the first (taps - 1) / 2 outputs, so output sample n is the
+ * filtered input at sample n. Downstream timestamps carry no filter delay
+ * for any frequency in the band.
+ *
+ * Samples go in one at a time; outputs come out a block at a time.
+ */
+
+#ifndef FFT_FILTER_BANK_H
+#define FFT_FILTER_BANK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define FFT_BANK_DEFAULT_FFT_SIZE   2048    /* 1025 taps, 1024-sample blocks */
+#define FFT_BANK_MAX_BANDS          8
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct fft_filter_bank fft_filter_bank_t;
+
+/*============================================================================
+ * Public API
+ *============================================================================*/
+
+/**
+ * Create a filter bank
+ * @param sample_rate  Input rate in Hz
+ * @param fft_size     Power of two >= 64; taps = fft_size / 2 + 1
+ */
+fft_filter_bank_t *fft_filter_bank_create(float sample_rate, int fft_size);
+void fft_filter_bank_destroy(fft_filter_bank_t *bank);
+
+/**
+ * Add a band (before the first sample)
+ * @param low_hz      Lower passband edge (0 = lowpass)
+ * @param high_hz     Upper passband edge
+ * @param decimation  Output decimation, power of two; must keep the band
+ *                    and its transition below the output Nyquist
+ * @return Band index, or -1 if the band or decimation is invalid
+ *
+ * Passband edges are flat; the Hamming transition (~3.3 * fs / taps wide)
+ * sits outside them.
+ */
+int fft_filter_bank_add_band(fft_filter_bank_t *bank, float low_hz, float high_hz,
+                             int decimation);
+
+/**
+ * Feed one input sample
+ * @return true when a new block of outputs is ready for every band
+ */
+bool fft_filter_bank_push(fft_filter_bank_t *bank, float i_sample, float q_sample);
+
+/**
+ * Outputs of the last completed block, interleaved I/Q
+ * @param count  Output pairs (fewer on the first block, which is trimmed
+ *               for zero-phase alignment)
+ */
+const float *fft_filter_bank_output(const fft_filter_bank_t *bank, int band, int *count);
+
+/**
+ * Input position of the last block's first output
+ * @return Samples pushed since create/reset before the input that output
+ *         is aligned to; later outputs of the block step by the band's
+ *         decimation
+ */
+uint64_t fft_filter_bank_output_position(const fft_filter_bank_t *bank, int band);
+
+/** Output decimation of a band (1 if the band is invalid) */
+int fft_filter_bank_decimation(const fft_filter_bank_t *bank, int band);
+
+/** Clear history and realign (call on reconnect); bands are kept */
+void fft_filter_bank_reset(fft_filter_bank_t *bank);
+
+/** Output rate of a band in Hz */
+float fft_filter_bank_output_rate(const fft_filter_bank_t *bank, int band);
+
+/** Input samples between a sample arriving and its output being available */
+int fft_filter_bank_latency_samples(const fft_filter_bank_t *bank);
+
+/** Magnitude response of a band's designed filter at freq_hz (linear) */
+float fft_filter_bank_response(const fft_filter_bank_t *bank, int band, float freq_hz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFT_FILTER_BANK_H */
@@ -0,0 +1,314 @@
+/**
+ * @file iq_client_bench.c
+ * @brief Throughput benchmark: iq_client vs. per-field recv_exact parsing
+ *
+ * Starts a loopback PHXI server thread that streams S16 frames as fast as
+ * the socket takes them, then reads the same stream twice:
+ *
+ *   exact   - the old waterfall/signal_splitter pattern: recv the magic,
+ *             the rest of the header, then the payload (3 recv loops/frame)
+ *   client  - iq_client_next(), chunked reads parsed in place
+ *
+ * With --host, the client pass runs against a live server instead
+ * (sdr_server, or signal_relay for FT32) for the given number of frames;
+ * --mcast does the same against a signal_relay multicast group.
+ *
+ * Usage:
+ *   iq_client_bench                         # 20000 frames x 8192 samples
+ *   iq_client_bench -n 50000 -s 2048        # Smaller frames, more of them
+ *   iq_client_bench --host localhost:4536   # Live sdr_server
+ *   iq_client_bench --mcast 239.255.44.10   # signal_relay --multicast
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "iq_client.h"
+#include "relay_mcast.h"
+#include "version.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+typedef SOCKET socket_t;
+#define socket_close closesocket
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <time.h>
+typedef int socket_t;
+#define socket_close close
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define DEFAULT_FRAMES      20000
+#define DEFAULT_SAMPLES     8192            /* sdr_server IQ_FRAME_SAMPLES */
+#define SEND_CHUNK          (256 * 1024)
+
+static double now_sec(void) {
+#ifdef _WIN32
+    LARGE_INTEGER f, c;
+    QueryPerformanceFrequency(&f);
+    QueryPerformanceCounter(&c);
+    return (double)c.QuadPart / (double)f.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+/*============================================================================
+ * Loopback Server
+ *============================================================================*/
+
+typedef struct {
+    socket_t listener;
+    int port;
+    uint32_t frames;
+    uint32_t samples;
+} server_t;
+
+static void *server_thread(void *arg) {
+    server_t *s = (server_t *)arg;
+    size_t frame_bytes = 16 + (size_t)s->samples * 4;
+    uint8_t *chunk = (uint8_t *)malloc(SEND_CHUNK + frame_bytes);
+    if (!chunk) return NULL;
+
+    /* One connection per pass */
+    for (int pass = 0; pass < 2; pass++) {
+        socket_t conn = accept(s->listener, NULL, NULL);
+
+        uint32_t hdr[8] = { 0x50485849, 1, 2000000, 1, 10000000, 0, 40, 2 };
+        send(conn, (const char *)hdr, sizeof(hdr), 0);
+
+        size_t fill = 0;
+        for (uint32_t k = 0; k < s->frames; k++) {
+            uint32_t fh[4] = { 0x49514451, k, s->samples, 0 };
+            memcpy(chunk + fill, fh, sizeof(fh));
+            memset(chunk + fill + 16, (int)(k & 0x7F), (size_t)s->samples * 4);
+            fill += frame_bytes;
+            if (fill >= SEND_CHUNK || k + 1 == s->frames) {
+                size_t off = 0;
+                while (off < fill) {
+                    int n = send(conn, (const char *)chunk + off, (int)(fill - off), 0);
+                    if (n <= 0) break;
+                    off += (size_t)n;
+                }
+                fill = 0;
+            }
+        }
+        socket_close(conn);
+    }
+    free(chunk);
+    return NULL;
+}
+
+static bool server_start(server_t *s, pthread_t *thread) {
+    s->listener = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(s->listener, (struct sockaddr *)&addr, sizeof(addr)) != 0) return false;
+    if (listen(s->listener, 1) != 0) return false;
+    socklen_t alen = sizeof(addr);
+    getsockname(s->listener, (struct sockaddr *)&addr, &alen);
+    s->port = ntohs(addr.sin_port);
+    return pthread_create(thread, NULL, server_thread, s) == 0;
+}
+
+/*============================================================================
+ * Baseline: recv_exact per field
+ *============================================================================*/
+
+static bool recv_exact(socket_t sock, void *buf, size_t len, uint64_t *calls) {
+    size_t total = 0;
+    while (total < len) {
+        int n = recv(sock, (char *)buf + total, (int)(len - total), 0);
+        (*calls)++;
+        if (n <= 0) return false;
+        total += (size_t)n;
+    }
+    return true;
+}
+
+static void run_exact(int port, uint32_t frames, uint32_t samples) {
+    socket_t sock = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons((uint16_t)port);
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "exact: connect failed\n");
+        return;
+    }
+
+    uint8_t *payload = (uint8_t *)malloc((size_t)samples * 4);
+    uint32_t hdr[8], fh[4];
+    uint64_t calls = 0, bytes = 0, checksum = 0;
+    uint32_t got = 0;
+
+    double t0 = now_sec();
+    if (recv_exact(sock, hdr, sizeof(hdr), &calls)) {
+        while (got < frames) {
+            if (!recv_exact(sock, &fh[0], 4, &calls)) break;
+            if (!recv_exact(sock, &fh[1], 12, &calls)) break;
+            size_t n = (size_t)fh[2] * 4;
+            if (!recv_exact(sock, payload, n, &calls)) break;
+            checksum += payload[0];
+            bytes += 16 + n;
+            got++;
+        }
+    }
+    double dt = now_sec() - t0;
+    socket_close(sock);
+    free(payload);
+
+    printf("  exact : %6u frames  %8.1f MB/s  %9.0f frames/s  %.3f recv/frame  (sum %llu)\n",
+           got, bytes / dt / 1e6, got / dt, got ? (double)calls / got : 0.0,
+           (unsigned long long)checksum);
+}
+
+/*============================================================================
+ * iq_client
+ *============================================================================*/
+
+static void run_client(const char *host, int port, bool mcast, uint32_t frames) {
+    iq_client_t *c = mcast ? iq_client_create_mcast(host, port, NULL)
+                           : iq_client_create(host, port, 0);
+    if (!c) {
+        fprintf(stderr, "client: create failed\n");
+        return;
+    }
+
+    iq_client_frame_t f;
+    uint64_t checksum = 0;
+    uint32_t got = 0;
+    double t0 = 0.0;
+    int idle = 0;
+
+    while (got < frames && idle < 50) {
+        iq_client_status_t st = iq_client_next(c, &f, 100);
+        if (st == IQ_CLIENT_FRAME) {
+            if (got == 0) t0 = now_sec();
+            checksum += ((const uint8_t *)f.samples)[0];
+            got++;
+            idle = 0;
+        } else if (st == IQ_CLIENT_DISCONNECTED) {
+            if (got > 0) break;
+            idle++;
+        } else if (st == IQ_CLIENT_TIMEOUT) {
+            idle++;
+        }
+    }
+    double dt = now_sec() - t0;
+
+    iq_client_stats_t stats;
+    iq_client_get_stats(c, &stats);
+    iq_client_destroy(c);
+
+    printf("  client: %6u frames  %8.1f MB/s  %9.0f frames/s  %.3f recv/frame  (sum %llu, lost %llu)\n",
+           got, stats.bytes / dt / 1e6, got / dt, got ? (double)stats.recv_calls / got : 0.0,
+           (unsigned long long)checksum, (unsigned long long)stats.frames_lost);
+    if (mcast) {
+        printf("          %llu packets recovered, %llu samples zero-filled\n",
+               (unsigned long long)stats.packets_recovered, (unsigned long long)stats.samples_lost);
+    }
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  -n FRAMES            Frames per pass (default: %d)\n", DEFAULT_FRAMES);
+    printf("  -s SAMPLES           I/Q pairs per frame, loopback only (default: %d)\n", DEFAULT_SAMPLES);
+    printf("  --host HOST[:PORT]   Benchmark iq_client against a live server\n");
+    printf("  --mcast GROUP[:PORT] Benchmark iq_client on a relay multicast group\n");
+    printf("  -h, --help           Show this help\n");
+}
+
+int main(int argc, char *argv[]) {
+    print_version("Phoenix SDR - I/Q Client Benchmark");
+
+    uint32_t frames = DEFAULT_FRAMES;
+    uint32_t samples = DEFAULT_SAMPLES;
+    char host[256] = "";
+    int port = 4536;
+    bool mcast = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            frames = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            samples = (uint32_t)atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--host") == 0 || strcmp(argv[i], "--mcast") == 0) && i + 1 < argc) {
+            if (strcmp(argv[i], "--mcast") == 0) {
+                mcast = true;
+                port = RELAY_MCAST_PORT;
+            }
+            strncpy(host, argv[++i], sizeof(host) - 1);
+            char *colon = strchr(host, ':');
+            if (colon) {
+                *colon = '\0';
+                port = atoi(colon + 1);
+            }
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (samples == 0 || (size_t)samples * 4 + 16 > IQ_CLIENT_MAX_FRAME_BYTES) {
+        fprintf(stderr, "Frame size out of range\n");
+        return 1;
+    }
+
+#ifdef _WIN32
+    WSADATA wsa;
+    WSAStartup(MAKEWORD(2, 2), &wsa);
+#endif
+
+    if (host[0]) {
+        printf("%s %s:%d, %u frames\n", mcast ? "Multicast group" : "Live server", host, port, frames);
+        run_client(host, port, mcast, frames);
+    } else {
+        server_t server = { 0 };
+        pthread_t thread;
+        server.frames = frames;
+        server.samples = samples;
+        if (!server_start(&server, &thread)) {
+            fprintf(stderr, "Failed to start loopback server\n");
+            return 1;
+        }
+        printf("Loopback, %u frames x %u samples (%.1f MB per pass)\n",
+               frames, samples, frames * (16.0 + samples * 4.0) / 1e6);
+        run_exact(server.port, frames, samples);
+        run_client("127.0.0.1", server.port, false, frames);
+        pthread_join(thread, NULL);
+        socket_close(server.listener);
+    }
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file iq_encoding_bench.c
+ * @brief Quality vs. bandwidth and throughput of the relay sample encodings
+ *
+ * For each encoding (f32, s16, s8, ulaw) on a few representative signals:
+ *
+ *   - bytes per I/Q pair and the link rate at 50 kHz / 12 kHz
+ *   - round-trip SNR (signal / encoding error)
+ *   - encode and decode throughput, vector path vs. scalar reference
+ *
+ * Usage:
+ *   iq_encoding_bench                 # 2048-pair frames (signal_splitter size)
+ *   iq_encoding_bench -s 8192 -n 500  # Larger frames, fewer of them
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "iq_encoding.h"
+#include "version.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define DEFAULT_SAMPLES     2048            /* signal_splitter RELAY_FRAME_SIZE */
+#define DEFAULT_FRAMES      2000
+#define PI                  3.14159265358979
+
+static double now_sec(void) {
+#ifdef _WIN32
+    LARGE_INTEGER f, c;
+    QueryPerformanceFrequency(&f);
+    QueryPerformanceCounter(&c);
+    return (double)c.QuadPart / (double)f.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+/*============================================================================
+ * Test Signals
+ *============================================================================*/
+
+typedef enum {
+    SIG_TONE,           /* Strong carrier + weak noise */
+    SIG_NOISE,          /* Band noise only */
+    SIG_FADING,         /* Carrier with 40 dB slow fade across the frame */
+    SIG_COUNT
+} signal_kind_t;
+
+static const char *signal_name(signal_kind_t k) {
+    switch (k) {
+        case SIG_TONE:   return "tone + noise";
+        case SIG_NOISE:  return "noise";
+        case SIG_FADING: return "40 dB fade";
+        default:         return "?";
+    }
+}
+
+static void make_signal(signal_kind_t kind, float *iq, uint32_t n) {
+    uint32_t lcg = 12345;
+    for (uint32_t k = 0; k < n; k++) {
+        float nz[2];
+        for (int j = 0; j < 2; j++) {
+            lcg = lcg * 1664525u + 1013904223u;
+            nz[j] = (float)(lcg >> 8) / 16777216.0f - 0.5f;
+        }
+        double ph = 2.0 * PI * 0.0123 * k;
+        float amp = 0.5f;
+        if (kind == SIG_FADING) amp *= (float)pow(10.0, -2.0 * k / n);   /* 0 to -40 dB */
+
+        if (kind == SIG_NOISE) {
+            iq[2 * k] = 0.2f * nz[0];
+            iq[2 * k + 1] = 0.2f * nz[1];
+        } else {
+            iq[2 * k] = amp * (float)cos(ph) + 0.001f * nz[0];
+            iq[2 * k + 1] = amp * (float)sin(ph) + 0.001f * nz[1];
+        }
+    }
+}
+
+/*============================================================================
+ * Throughput
+ *============================================================================*/
+
+typedef size_t (*encode_fn)(iq_encoding_t, const float *, uint32_t, uint8_t *, float *);
+typedef void (*decode_fn)(iq_encoding_t, const uint8_t *, uint32_t, float, float *);
+
+/* Million I/Q pairs per second */
+static double time_encode(encode_fn fn, iq_encoding_t enc, const float *iq, uint32_t n,
+                          uint8_t *out, uint32_t frames) {
+    float scale;
+    double t0 = now_sec();
+    for (uint32_t f = 0; f < frames; f++) fn(enc, iq, n, out, &scale);
+    return (double)n * frames / (now_sec() - t0) / 1e6;
+}
+
+static double time_decode(decode_fn fn, iq_encoding_t enc, const uint8_t *in, uint32_t n,
+                          float scale, float *out, uint32_t frames) {
+    double t0 = now_sec();
+    for (uint32_t f = 0; f < frames; f++) fn(enc, in, n, scale, out);
+    return (double)n * frames / (now_sec() - t0) / 1e6;
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  -s SAMPLES   I/Q pairs per frame (default: %d)\n", DEFAULT_SAMPLES);
+    printf("  -n FRAMES    Frames per throughput run (default: %d)\n", DEFAULT_FRAMES);
+    printf("  -h, --help   Show this help\n");
+}
+
+int main(int argc, char *argv[]) {
+    print_version("Phoenix SDR - I/Q Encoding Benchmark");
+
+    uint32_t samples = DEFAULT_SAMPLES;
+    uint32_t frames = DEFAULT_FRAMES;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            samples = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            frames = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (samples == 0 || samples > 1000000 || frames == 0) {
+        fprintf(stderr, "Frame size out of range\n");
+        return 1;
+    }
+
+    float *iq = (float *)malloc((size_t)samples * 2 * sizeof(float));
+    float *back = (float *)malloc((size_t)samples * 2 * sizeof(float));
+    uint8_t *payload = (uint8_t *)malloc((size_t)samples * 8);
+    if (!iq || !back || !payload) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    printf("Frame: %u I/Q pairs\n\n", samples);
+    printf("Quality vs. bandwidth\n");
+    printf("  %-5s %9s %7s %11s %11s", "enc", "B/pair", "size", "50 kHz", "12 kHz");
+    for (int k = 0; k < SIG_COUNT; k++) printf("  %13s", signal_name((signal_kind_t)k));
+    printf("\n");
+
+    for (int e = 0; e < IQ_ENC_COUNT; e++) {
+        iq_enc_quality_t q;
+        printf("  %-5s", iq_enc_name((iq_encoding_t)e));
+        for (int k = 0; k < SIG_COUNT; k++) {
+            make_signal((signal_kind_t)k, iq, samples);
+            iq_enc_measure((iq_encoding_t)e, iq, samples, &q);
+            if (k == 0) {
+                printf(" %9.2f %6.0f%% %7.0f kB/s %7.0f kB/s", q.bytes_per_pair, q.ratio * 100.0,
+                       (16.0 / samples + q.bytes_per_pair) * 50000 / 1000.0,
+                       (16.0 / samples + q.bytes_per_pair) * 12000 / 1000.0);
+            }
+            if (isinf(q.snr_db)) printf("  %13s", "lossless");
+            else printf("  %10.1f dB", q.snr_db);
+        }
+        printf("\n");
+    }
+
+    printf("\nThroughput (M pairs/s, vector / scalar)\n");
+    make_signal(SIG_TONE, iq, samples);
+    for (int e = 0; e < IQ_ENC_COUNT; e++) {
+        iq_encoding_t enc = (iq_encoding_t)e;
+        float scale;
+        iq_enc_encode(enc, iq, samples, payload, &scale);
+
+        double ev = time_encode(iq_enc_encode, enc, iq, samples, payload, frames);
+        double es = time_encode(iq_enc_encode_scalar, enc, iq, samples, payload, frames);
+        double dv = time_decode(iq_enc_decode, enc, payload, samples, scale, back, frames);
+        double ds = time_decode(iq_enc_decode_scalar, enc, payload, samples, scale, back, frames);
+        printf("  %-5s encode %8.1f / %8.1f   decode %8.1f / %8.1f\n",
+               iq_enc_name(enc), ev, es, dv, ds);
+    }
+
+    free(iq);
+    free(back);
+    free(payload);
+    return 0;
+}
@@ -0,0 +1,798 @@
+/**
+ * @file iqr_convert.c
+ * @brief Bulk conversion between .iqr recordings and interchange formats
+ *
+ * Streams I/Q files of any size through a three-stage pipeline - reader,
+ * converter, writer - each on its own thread, passing large aligned blocks
+ * through bounded queues. Disk reads, sample conversion and disk writes
+ * overlap, so a conversion runs at the speed of the slowest stage instead
+ * of the sum of all three.
+ *
+ * Formats: iqr, wav (RF64 above 4 GB), sigmf, cf32, cs16 - in either
+ * direction. Optional decimation to 48 kHz and UTC time-range slicing
+ * using the recording's .meta start time.
+ *
+ * Usage:
+ *   iqr_convert rec.iqr rec.wav                         # 2 MSPS stereo WAV
+ *   iqr_convert rec.iqr rec.sigmf-data                  # SigMF with .meta timing
+ *   iqr_convert -d rec.iqr rec_48k.cf32                 # Decimated float
+ *   iqr_convert -s 14:31:00 -e 14:33:00 rec.iqr cut.iqr # Two-minute slice
+ *   iqr_convert -r 2000000 -c 10e6 capture.cs16 rec.iqr # Raw back to .iqr
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #include <malloc.h>
+    #define file_seek   _fseeki64
+    #define file_tell   _ftelli64
+#else
+    #include <time.h>
+    #define file_seek   fseeko
+    #define file_tell   ftello
+#endif
+
+#include "version.h"
+#include "iq_recorder.h"
+#include "iqr_meta.h"
+#include "iqr_export.h"
+#include "decimator.h"
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define DEFAULT_BLOCK_KB    4096        /* Read size per block */
+#define POOL_BLOCKS         4           /* Blocks in flight per pool */
+#define BLOCK_ALIGN         4096        /* Page/sector alignment for bulk I/O */
+#define DECIM_CHUNK         65536       /* Max input samples per decim call */
+#define MAX_META_BYTES      (16 * 1024 * 1024)
+#define WAV_PROBE_BYTES     65536
+
+/*============================================================================
+ * Block Queue
+ *============================================================================*/
+
+typedef struct block_queue block_queue_t;
+
+typedef struct {
+    void   *data;
+    size_t  bytes;                      /* Valid bytes */
+    size_t  capacity;
+    block_queue_t *home;                /* Free pool to return to */
+} block_t;
+
+/* Bounded FIFO; capacity covers every block that can exist, so push never waits */
+struct block_queue {
+    block_t *items[2 * POOL_BLOCKS];
+    int head;
+    int count;
+    bool closed;                        /* No more pushes - drain then NULL */
+    bool aborted;                       /* Pop returns NULL immediately */
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+};
+
+static void queue_init(block_queue_t *q) {
+    memset(q, 0, sizeof(*q));
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->cond, NULL);
+}
+
+static void queue_destroy(block_queue_t *q) {
+    pthread_mutex_destroy(&q->lock);
+    pthread_cond_destroy(&q->cond);
+}
+
+static void queue_push(block_queue_t *q, block_t *b) {
+    pthread_mutex_lock(&q->lock);
+    q->items[(q->head + q->count) % (2 * POOL_BLOCKS)] = b;
+    q->count++;
+    pthread_cond_signal(&q->cond);
+    pthread_mutex_unlock(&q->lock);
+}
+
+static block_t *queue_pop(block_queue_t *q) {
+    block_t *b = NULL;
+    pthread_mutex_lock(&q->lock);
+    while (q->count == 0 && !q->closed && !q->aborted) {
+        pthread_cond_wait(&q->cond, &q->lock);
+    }
+    if (q->count > 0 && !q->aborted) {
+        b = q->items[q->head];
+        q->head = (q->head + 1) % (2 * POOL_BLOCKS);
+        q->count--;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return b;
+}
+
+static void queue_set_flag(block_queue_t *q, bool abort) {
+    pthread_mutex_lock(&q->lock);
+    if (abort) q->aborted = true;
+    else q->closed = true;
+    pthread_cond_broadcast(&q->cond);
+    pthread_mutex_unlock(&q->lock);
+}
+
+static void *block_alloc(size_t size) {
+#ifdef _WIN32
+    return _aligned_malloc(size, BLOCK_ALIGN);
+#else
+    void *p = NULL;
+    return posix_memalign(&p, BLOCK_ALIGN, size) == 0 ? p : NULL;
+#endif
+}
+
+static void block_free(void *p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+/*============================================================================
+ * Conversion Job
+ *============================================================================*/
+
+typedef struct {
+    iqr_format_t fmt;
+    char path[1024];                    /* Sample data file */
+    FILE *file;
+    uint64_t data_offset;
+    iqr_stream_info_t info;
+    iqr_meta_t meta;
+    bool has_meta;
+} input_t;
+
+typedef struct {
+    iqr_format_t fmt;
+    char path[1024];                    /* Sample data file */
+    char meta_path[1024];               /* SigMF .sigmf-meta */
+    FILE *file;
+    iqr_stream_info_t info;
+} output_t;
+
+typedef struct {
+    input_t  in;
+    output_t out;
+
+    uint64_t first_sample;              /* Slice start in the input */
+    uint64_t samples_to_read;
+    bool     decimate;
+    size_t   block_bytes;
+
+    block_queue_t in_free, in_full;     /* Reader <-> converter */
+    block_queue_t out_free, out_full;   /* Converter <-> writer */
+
+    decim_state_t *decim;
+    int16_t *scratch;                   /* Interleaved cs16 for the decimator */
+    int16_t *xi, *xq;
+
+    atomic_bool failed;
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+} job_t;
+
+static void job_abort(job_t *job, const char *what) {
+    if (!atomic_exchange(&job->failed, true)) {
+        fprintf(stderr, "Error: %s\n", what);
+    }
+    queue_set_flag(&job->in_free, true);
+    queue_set_flag(&job->in_full, true);
+    queue_set_flag(&job->out_free, true);
+    queue_set_flag(&job->out_full, true);
+}
+
+static double now_sec(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+static int64_t file_size(FILE *f) {
+    int64_t pos = file_tell(f);
+    if (file_seek(f, 0, SEEK_END) != 0) return -1;
+    int64_t size = file_tell(f);
+    file_seek(f, pos, SEEK_SET);
+    return size;
+}
+
+/* Strip a SigMF extension: "x.sigmf-data" / "x.sigmf-meta" / "x.sigmf" -> "x" */
+static void sigmf_base(const char *path, char *base, size_t size) {
+    static const char *exts[] = { ".sigmf-data", ".sigmf-meta", ".sigmf" };
+    snprintf(base, size, "%s", path);
+    size_t n = strlen(base);
+    for (int i = 0; i < 3; i++) {
+        size_t m = strlen(exts[i]);
+        if (n > m && strcmp(base + n - m, exts[i]) == 0) {
+            base[n - m] = '\0';
+            return;
+        }
+    }
+}
+
+/*============================================================================
+ * Input
+ *============================================================================*/
+
+static bool open_input(input_t *in, const char *path, double raw_rate, double freq) {
+    char base[1000];
+
+    if (in->fmt == IQR_FMT_SIGMF) {
+        char meta_path[1040];
+        sigmf_base(path, base, sizeof(base));
+        snprintf(in->path, sizeof(in->path), "%s.sigmf-data", base);
+        snprintf(meta_path, sizeof(meta_path), "%s.sigmf-meta", base);
+
+        FILE *mf = fopen(meta_path, "rb");
+        if (!mf) {
+            fprintf(stderr, "Error: cannot open %s\n", meta_path);
+            return false;
+        }
+        char *json = malloc(MAX_META_BYTES + 1);
+        size_t n = json ? fread(json, 1, MAX_META_BYTES, mf) : 0;
+        fclose(mf);
+        if (!json) return false;
+        json[n] = '\0';
+        bool ok = iqr_sigmf_parse_meta(json, &in->info);
+        free(json);
+        if (!ok) {
+            fprintf(stderr, "Error: %s: unsupported datatype or missing sample_rate\n", meta_path);
+            return false;
+        }
+    } else {
+        snprintf(in->path, sizeof(in->path), "%s", path);
+    }
+
+    in->file = fopen(in->path, "rb");
+    if (!in->file) {
+        fprintf(stderr, "Error: cannot open %s\n", in->path);
+        return false;
+    }
+    /* Large unbuffered transfers straight into the aligned blocks */
+    setvbuf(in->file, NULL, _IONBF, 0);
+    int64_t size = file_size(in->file);
+    if (size < 0) {
+        fprintf(stderr, "Error: cannot size %s\n", in->path);
+        return false;
+    }
+
+    uint64_t declared = 0;
+
+    switch (in->fmt) {
+    case IQR_FMT_IQR: {
+        iqr_header_t hdr;
+        if (fread(&hdr, sizeof(hdr), 1, in->file) != 1 ||
+            memcmp(hdr.magic, IQR_MAGIC, 4) != 0 || hdr.version != IQR_VERSION) {
+            fprintf(stderr, "Error: %s is not an IQR v%d file\n", in->path, IQR_VERSION);
+            return false;
+        }
+        in->data_offset = IQR_HEADER_SIZE;
+        in->info.type = IQR_SAMPLE_CS16;
+        in->info.sample_rate_hz = hdr.sample_rate_hz;
+        in->info.center_freq_hz = hdr.center_freq_hz;
+        in->info.bandwidth_khz = hdr.bandwidth_khz;
+        in->info.gain_reduction = hdr.gain_reduction;
+        in->info.lna_state = hdr.lna_state;
+        in->info.start_time_us = hdr.start_time_us;
+        declared = hdr.sample_count;    /* 0 if the recorder never closed */
+
+        /* .meta carries the GPS-disciplined start time when there was a fix */
+        in->has_meta = (iqr_meta_read(path, &in->meta) == 0);
+        if (in->has_meta && in->meta.start_time_us != 0) {
+            in->info.start_time_us = in->meta.start_time_us;
+        }
+        break;
+    }
+
+    case IQR_FMT_WAV: {
+        uint8_t probe[WAV_PROBE_BYTES];
+        size_t n = fread(probe, 1, sizeof(probe), in->file);
+        iqr_wav_info_t wav;
+        if (!iqr_wav_parse_header(probe, n, &wav)) {
+            fprintf(stderr, "Error: %s is not a 2-channel 16-bit PCM or float WAV\n", in->path);
+            return false;
+        }
+        in->data_offset = wav.data_offset;
+        in->info.type = wav.type;
+        in->info.sample_rate_hz = wav.sample_rate;
+        in->info.center_freq_hz = freq;
+        declared = wav.data_bytes / iqr_sample_bytes(wav.type);
+        break;
+    }
+
+    case IQR_FMT_SIGMF:
+        in->data_offset = 0;
+        if (freq > 0) in->info.center_freq_hz = freq;
+        break;
+
+    case IQR_FMT_CF32:
+    case IQR_FMT_CS16:
+        if (raw_rate <= 0) {
+            fprintf(stderr, "Error: raw input needs -r <sample rate>\n");
+            return false;
+        }
+        in->data_offset = 0;
+        in->info.type = (in->fmt == IQR_FMT_CF32) ? IQR_SAMPLE_CF32 : IQR_SAMPLE_CS16;
+        in->info.sample_rate_hz = raw_rate;
+        in->info.center_freq_hz = freq;
+        break;
+
+    default:
+        return false;
+    }
+
+    /* Trust the file size over a header that was never finalized */
+    uint64_t available = ((uint64_t)size > in->data_offset)
+                       ? ((uint64_t)size - in->data_offset) / iqr_sample_bytes(in->info.type) : 0;
+    in->info.sample_count = (declared > 0 && declared < available) ? declared : available;
+    return true;
+}
+
+/*============================================================================
+ * Output
+ *============================================================================*/
+
+static bool write_header(output_t *out, uint64_t data_bytes) {
+    if (out->fmt == IQR_FMT_IQR) {
+        iqr_header_t hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.magic, IQR_MAGIC, 4);
+        hdr.version = IQR_VERSION;
+        hdr.sample_rate_hz = out->info.sample_rate_hz;
+        hdr.center_freq_hz = out->info.center_freq_hz;
+        hdr.bandwidth_khz = out->info.bandwidth_khz;
+        hdr.gain_reduction = out->info.gain_reduction;
+        hdr.lna_state = out->info.lna_state;
+        hdr.start_time_us = out->info.start_time_us;
+        hdr.sample_count = data_bytes / iqr_sample_bytes(IQR_SAMPLE_CS16);
+        return fwrite(&hdr, sizeof(hdr), 1, out->file) == 1;
+    }
+    if (out->fmt == IQR_FMT_WAV) {
+        uint8_t hdr[IQR_WAV_HEADER_SIZE];
+        iqr_wav_build_header(hdr, (uint32_t)(out->info.sample_rate_hz + 0.5), out->info.type, data_bytes);
+        return fwrite(hdr, sizeof(hdr), 1, out->file) == 1;
+    }
+    return true;
+}
+
+static bool open_output(output_t *out, const char *path) {
+    if (out->fmt == IQR_FMT_SIGMF) {
+        char base[1000];
+        sigmf_base(path, base, sizeof(base));
+        snprintf(out->path, sizeof(out->path), "%s.sigmf-data", base);
+        snprintf(out->meta_path, sizeof(out->meta_path), "%s.sigmf-meta", base);
+    } else {
+        snprintf(out->path, sizeof(out->path), "%s", path);
+    }
+
+    out->file = fopen(out->path, "wb");
+    if (!out->file) {
+        fprintf(stderr, "Error: cannot create %s\n", out->path);
+        return false;
+    }
+    setvbuf(out->file, NULL, _IONBF, 0);
+    return write_header(out, 0);
+}
+
+/* Shift the source .meta timing to the slice and write it next to a new .iqr */
+static void write_iqr_meta(const job_t *job) {
+    iqr_meta_t m = job->in.meta;
+    const iqr_stream_info_t *info = &job->out.info;
+
+    m.sample_rate_hz = info->sample_rate_hz;
+    m.center_freq_hz = info->center_freq_hz;
+    m.bandwidth_khz = info->bandwidth_khz;
+    m.gain_reduction = info->gain_reduction;
+    m.lna_state = info->lna_state;
+    m.start_time_us = info->start_time_us;
+    iqr_format_utc(m.start_time_us, m.start_time_iso, sizeof(m.start_time_iso));
+    int64_t sec_of_min = (m.start_time_us / 1000000) % 60;
+    m.start_second = (int)sec_of_min;
+    m.offset_to_next_minute = 60.0 - (double)(m.start_time_us % 60000000) * 1e-6;
+    m.sample_count = info->sample_count;
+    m.duration_sec = (double)info->sample_count / info->sample_rate_hz;
+    m.end_time_us = m.start_time_us + (int64_t)(m.duration_sec * 1e6);
+    iqr_format_utc(m.end_time_us, m.end_time_iso, sizeof(m.end_time_iso));
+    m.recording_complete = true;
+
+    iqr_meta_write_end(job->out.path, &m);
+}
+
+static bool finish_output(job_t *job) {
+    output_t *out = &job->out;
+    out->info.sample_count = job->bytes_written / iqr_sample_bytes(out->info.type);
+
+    bool ok = true;
+    if (out->fmt == IQR_FMT_IQR || out->fmt == IQR_FMT_WAV) {
+        ok = file_seek(out->file, 0, SEEK_SET) == 0 && write_header(out, job->bytes_written);
+    }
+    if (fclose(out->file) != 0) ok = false;
+    out->file = NULL;
+
+    if (ok && out->fmt == IQR_FMT_SIGMF) {
+        FILE *mf = fopen(out->meta_path, "w");
+        ok = mf && iqr_sigmf_write_meta(mf, &out->info, job->in.has_meta ? &job->in.meta : NULL,
+                                        job->first_sample) == 0;
+        if (mf && fclose(mf) != 0) ok = false;
+    }
+    if (ok && out->fmt == IQR_FMT_IQR && job->in.has_meta) {
+        write_iqr_meta(job);
+    }
+    return ok;
+}
+
+/*============================================================================
+ * Pipeline Stages
+ *============================================================================*/
+
+static void *reader_thread(void *arg) {
+    job_t *job = (job_t *)arg;
+    const size_t sample_bytes = iqr_sample_bytes(job->in.info.type);
+    uint64_t remaining = job->samples_to_read * sample_bytes;
+
+    while (remaining > 0) {
+        block_t *b = queue_pop(&job->in_free);
+        if (!b) break;
+
+        size_t want = (remaining < b->capacity) ? (size_t)remaining : b->capacity;
+        size_t got = fread(b->data, 1, want, job->in.file);
+        got -= got % sample_bytes;
+        if (got == 0) {
+            queue_push(b->home, b);
+            if (ferror(job->in.file)) job_abort(job, "read failed");
+            break;
+        }
+        b->bytes = got;
+        remaining -= got;
+        job->bytes_read += got;
+        queue_push(&job->in_full, b);
+    }
+
+    queue_set_flag(&job->in_full, false);
+    return NULL;
+}
+
+/* Decimate one block of input into cf32 at 48 kHz */
+static size_t decimate_block(job_t *job, const block_t *in, float *out, size_t out_max) {
+    size_t values = in->bytes / (job->in.info.type == IQR_SAMPLE_CF32 ? sizeof(float) : sizeof(int16_t));
+    const int16_t *s16 = (const int16_t *)in->data;
+    if (job->in.info.type == IQR_SAMPLE_CF32) {
+        iqr_convert_f32_s16((const float *)in->data, job->scratch, values);
+        s16 = job->scratch;
+    }
+
+    size_t samples = values / 2;
+    size_t produced = 0;
+    for (size_t pos = 0; pos < samples; pos += DECIM_CHUNK) {
+        size_t n = (samples - pos < DECIM_CHUNK) ? samples - pos : DECIM_CHUNK;
+        for (size_t k = 0; k < n; k++) {
+            job->xi[k] = s16[2 * (pos + k)];
+            job->xq[k] = s16[2 * (pos + k) + 1];
+        }
+        size_t count = 0;
+        decim_error_t err = decim_process_int16(job->decim, job->xi, job->xq, n,
+                                                (decim_complex_t *)out + produced,
+                                                out_max - produced, &count);
+        if (err != DECIM_OK) {
+            job_abort(job, decim_strerror(err));
+            return produced;
+        }
+        produced += count;
+    }
+    return produced;
+}
+
+static void *converter_thread(void *arg) {
+    job_t *job = (job_t *)arg;
+    const iqr_sample_type_t in_type = job->in.info.type;
+    const iqr_sample_type_t out_type = job->out.info.type;
+
+    for (;;) {
+        block_t *in = queue_pop(&job->in_full);
+        if (!in) break;
+
+        /* Same representation: hand the block straight to the writer */
+        if (!job->decimate && in_type == out_type) {
+            queue_push(&job->out_full, in);
+            continue;
+        }
+
+        block_t *out = queue_pop(&job->out_free);
+        if (!out) {
+            queue_push(in->home, in);
+            break;
+        }
+
+        if (job->decimate) {
+            float *f32 = (float *)out->data;
+            size_t max_samples = out->capacity / (2 * sizeof(float));
+            size_t n = decimate_block(job, in, f32, max_samples);
+            if (out_type == IQR_SAMPLE_CS16) {
+                /* In place: int16 output never overtakes the float input */
+                iqr_convert_f32_s16(f32, (int16_t *)out->data, 2 * n);
+            }
+            out->bytes = n * iqr_sample_bytes(out_type);
+        } else if (in_type == IQR_SAMPLE_CS16) {
+            size_t values = in->bytes / sizeof(int16_t);
+            iqr_convert_s16_f32((const int16_t *)in->data, (float *)out->data, values);
+            out->bytes = values * sizeof(float);
+        } else {
+            size_t values = in->bytes / sizeof(float);
+            iqr_convert_f32_s16((const float *)in->data, (int16_t *)out->data, values);
+            out->bytes = values * sizeof(int16_t);
+        }
+
+        queue_push(in->home, in);
+        queue_push(&job->out_full, out);
+    }
+
+    queue_set_flag(&job->out_full, false);
+    return NULL;
+}
+
+static void *writer_thread(void *arg) {
+    job_t *job = (job_t *)arg;
+
+    for (;;) {
+        block_t *b = queue_pop(&job->out_full);
+        if (!b) break;
+
+        if (b->bytes > 0 && fwrite(b->data, 1, b->bytes, job->out.file) != b->bytes) {
+            queue_push(b->home, b);
+            job_abort(job, "write failed (disk full?)");
+            break;
+        }
+        job->bytes_written += b->bytes;
+        queue_push(b->home, b);
+    }
+    return NULL;
+}
+
+/*============================================================================
+ * Job Setup
+ *============================================================================*/
+
+static bool alloc_pool(block_queue_t *pool, block_t *blocks, size_t capacity) {
+    for (int i = 0; i < POOL_BLOCKS; i++) {
+        blocks[i].data = block_alloc(capacity);
+        if (!blocks[i].data) return false;
+        blocks[i].capacity = capacity;
+        blocks[i].home = pool;
+        queue_push(pool, &blocks[i]);
+    }
+    return true;
+}
+
+static void free_pool(block_t *blocks) {
+    for (int i = 0; i < POOL_BLOCKS; i++) {
+        if (blocks[i].data) block_free(blocks[i].data);
+    }
+}
+
+static bool run_pipeline(job_t *job) {
+    static block_t in_blocks[POOL_BLOCKS], out_blocks[POOL_BLOCKS];
+    const size_t in_sample_bytes = iqr_sample_bytes(job->in.info.type);
+    const size_t block_samples = job->block_bytes / in_sample_bytes;
+    const size_t out_capacity = block_samples * iqr_sample_bytes(IQR_SAMPLE_CF32);
+    bool ok = false;
+
+    queue_init(&job->in_free);
+    queue_init(&job->in_full);
+    queue_init(&job->out_free);
+    queue_init(&job->out_full);
+
+    if (!alloc_pool(&job->in_free, in_blocks, block_samples * in_sample_bytes) ||
+        !alloc_pool(&job->out_free, out_blocks, out_capacity)) {
+        fprintf(stderr, "Error: out of memory for I/O blocks\n");
+        goto done;
+    }
+
+    if (job->decimate) {
+        decim_error_t err = decim_create(&job->decim, job->in.info.sample_rate_hz, DECIM_OUTPUT_RATE);
+        job->scratch = malloc(block_samples * 2 * sizeof(int16_t));
+        job->xi = malloc(DECIM_CHUNK * sizeof(int16_t));
+        job->xq = malloc(DECIM_CHUNK * sizeof(int16_t));
+        if (err != DECIM_OK || !job->scratch || !job->xi || !job->xq) {
+            fprintf(stderr, "Error: decimator: %s (input must be 2 MSPS)\n", decim_strerror(err));
+            goto done;
+        }
+    }
+
+    if (file_seek(job->in.file, (int64_t)(job->in.data_offset + job->first_sample * in_sample_bytes),
+                  SEEK_SET) != 0) {
+        fprintf(stderr, "Error: seek failed\n");
+        goto done;
+    }
+
+    pthread_t reader, converter, writer;
+    pthread_create(&reader, NULL, reader_thread, job);
+    pthread_create(&converter, NULL, converter_thread, job);
+    pthread_create(&writer, NULL, writer_thread, job);
+    pthread_join(reader, NULL);
+    pthread_join(converter, NULL);
+    pthread_join(writer, NULL);
+
+    ok = !atomic_load(&job->failed);
+
+done:
+    free_pool(in_blocks);
+    free_pool(out_blocks);
+    if (job->decim) decim_destroy(job->decim);
+    free(job->scratch);
+    free(job->xi);
+    free(job->xq);
+    queue_destroy(&job->in_free);
+    queue_destroy(&job->in_full);
+    queue_destroy(&job->out_free);
+    queue_destroy(&job->out_full);
+    return ok;
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+static void print_usage(const char *prog) {
+    printf("Phoenix SDR IQR Converter v%s\n", PHOENIX_VERSION_STRING);
+    printf("Usage: %s [options] <input> <output>\n\n", prog);
+    printf("Formats: iqr, wav, sigmf, cf32, cs16 (taken from the file extension)\n\n");
+    printf("Options:\n");
+    printf("  -f <fmt>        Input format (overrides extension)\n");
+    printf("  -t <fmt>        Output format (overrides extension)\n");
+    printf("  -T <cs16|cf32>  Sample type for wav/sigmf output (default: input type)\n");
+    printf("  -r <hz>         Sample rate of raw cf32/cs16 input\n");
+    printf("  -c <hz>         Center frequency for raw, wav or sigmf input\n");
+    printf("  -d              Decimate 2 MSPS input to 48 kHz (float output unless cs16/iqr)\n");
+    printf("  -s <utc>        Slice start: YYYY-MM-DDTHH:MM:SS[.ffffff]Z or HH:MM:SS[.ffffff]\n");
+    printf("  -e <utc>        Slice end (exclusive), same forms\n");
+    printf("  -b <kb>         I/O block size in KB (default: %d)\n", DEFAULT_BLOCK_KB);
+    printf("  -q              Quiet - no summary\n");
+    printf("  -h              Show this help\n\n");
+    printf("Time-of-day slice bounds are taken on the recording's UTC date; the\n");
+    printf("start time comes from the .meta file (GPS when it had a fix).\n\n");
+    printf("Examples:\n");
+    printf("  %s rec.iqr rec.wav\n", prog);
+    printf("  %s -d -s 14:31:00 -e 14:33:00 rec.iqr cut.sigmf-data\n", prog);
+    printf("  %s -r 2000000 -c 10e6 capture.cs16 capture.iqr\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    static job_t job;
+    const char *in_path = NULL, *out_path = NULL;
+    const char *start_text = NULL, *end_text = NULL, *type_text = NULL;
+    iqr_format_t in_fmt = IQR_FMT_UNKNOWN, out_fmt = IQR_FMT_UNKNOWN;
+    double raw_rate = 0, freq = 0;
+    long block_kb = DEFAULT_BLOCK_KB;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+        else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) in_fmt = iqr_format_from_name(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) out_fmt = iqr_format_from_name(argv[++i]);
+        else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) type_text = argv[++i];
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) raw_rate = atof(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) freq = atof(argv[++i]);
+        else if (strcmp(argv[i], "-d") == 0) job.decimate = true;
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) start_text = argv[++i];
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) end_text = argv[++i];
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) block_kb = atol(argv[++i]);
+        else if (strcmp(argv[i], "-q") == 0) quiet = true;
+        else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+        else if (!in_path) in_path = argv[i];
+        else if (!out_path) out_path = argv[i];
+        else {
+            fprintf(stderr, "Unexpected argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (!in_path || !out_path) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (in_fmt == IQR_FMT_UNKNOWN) in_fmt = iqr_format_from_path(in_path);
+    if (out_fmt == IQR_FMT_UNKNOWN) out_fmt = iqr_format_from_path(out_path);
+    if (in_fmt == IQR_FMT_UNKNOWN || out_fmt == IQR_FMT_UNKNOWN) {
+        fprintf(stderr, "Error: cannot tell %s format - use -f/-t\n",
+                in_fmt == IQR_FMT_UNKNOWN ? "input" : "output");
+        return 1;
+    }
+    if (block_kb < 64) block_kb = 64;
+    job.block_bytes = (size_t)block_kb * 1024;
+
+    job.in.fmt = in_fmt;
+    if (!open_input(&job.in, in_path, raw_rate, freq)) return 1;
+    const iqr_stream_info_t *src = &job.in.info;
+
+    /* Slice */
+    int64_t from_us = 0, to_us = 0;
+    if ((start_text && !iqr_parse_utc(start_text, src->start_time_us, &from_us)) ||
+        (end_text && !iqr_parse_utc(end_text, src->start_time_us, &to_us))) {
+        fprintf(stderr, "Error: bad UTC time (use YYYY-MM-DDTHH:MM:SS[.ffffff]Z or HH:MM:SS)\n");
+        return 1;
+    }
+    if ((from_us || to_us) && src->start_time_us == 0) {
+        fprintf(stderr, "Error: input has no start time - cannot slice by UTC\n");
+        return 1;
+    }
+    if (!iqr_slice_range(src, from_us, to_us, &job.first_sample, &job.samples_to_read)) {
+        fprintf(stderr, "Error: time range selects no samples\n");
+        return 1;
+    }
+
+    /* Output description */
+    job.out.fmt = out_fmt;
+    job.out.info = *src;
+    job.out.info.sample_count = 0;
+    if (src->start_time_us != 0) {
+        job.out.info.start_time_us = src->start_time_us +
+            (int64_t)((double)job.first_sample * 1e6 / src->sample_rate_hz + 0.5);
+    }
+    if (job.decimate) {
+        job.out.info.sample_rate_hz = DECIM_OUTPUT_RATE;
+        job.out.info.type = IQR_SAMPLE_CF32;
+    }
+    if (type_text) {
+        if (strcmp(type_text, "cf32") == 0) job.out.info.type = IQR_SAMPLE_CF32;
+        else if (strcmp(type_text, "cs16") == 0) job.out.info.type = IQR_SAMPLE_CS16;
+        else {
+            fprintf(stderr, "Error: -T takes cs16 or cf32\n");
+            return 1;
+        }
+    }
+    if (out_fmt == IQR_FMT_IQR || out_fmt == IQR_FMT_CS16) job.out.info.type = IQR_SAMPLE_CS16;
+    if (out_fmt == IQR_FMT_CF32) job.out.info.type = IQR_SAMPLE_CF32;
+
+    if (!open_output(&job.out, out_path)) return 1;
+
+    double t0 = now_sec();
+    bool ok = run_pipeline(&job) && finish_output(&job);
+    double elapsed = now_sec() - t0;
+
+    fclose(job.in.file);
+    if (job.out.file) fclose(job.out.file);
+    if (!ok) {
+        fprintf(stderr, "Conversion failed\n");
+        return 1;
+    }
+
+    if (!quiet) {
+        const iqr_stream_info_t *o = &job.out.info;
+        char iso[40] = "unknown";
+        if (o->start_time_us) iqr_format_utc(o->start_time_us, iso, sizeof(iso));
+        printf("%s (%s) -> %s (%s %s)\n", in_path, iqr_format_name(in_fmt), job.out.path,
+               iqr_format_name(out_fmt), o->type == IQR_SAMPLE_CF32 ? "cf32" : "cs16");
+        printf("  Samples:  %llu at %.0f Hz (%.2f s)\n", (unsigned long long)o->sample_count,
+               o->sample_rate_hz, (double)o->sample_count / o->sample_rate_hz);
+        printf("  Start:    %s (source sample %llu)\n", iso, (unsigned long long)job.first_sample);
+        printf("  Read:     %.1f MB in %.2f s (%.0f MB/s)\n", job.bytes_read / 1e6, elapsed,
+               elapsed > 0 ? job.bytes_read / 1e6 / elapsed : 0.0);
+    }
+    return 0;
+}
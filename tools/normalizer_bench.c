@@ -0,0 +1,185 @@
+/**
+ * @file normalizer_bench.c
+ * @brief Block slow AGC vs. the per-sample normalize() it replaced
+ *
+ * Runs the same input through block_normalizer_process() and the
+ * per-sample reference and reports:
+ *
+ *   - throughput of each (M pairs/s) and the speedup
+ *   - worst output difference after the first chunk, and once settled
+ *
+ * Usage:
+ *   normalizer_bench                  # 256-pair calls (waterfall stage size)
+ *   normalizer_bench -s 4096 -n 500   # Larger calls, fewer of them
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "block_normalizer.h"
+#include "version.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define DEFAULT_SAMPLES     (BLOCK_NORM_CHUNK * 4)  /* waterfall DETECTOR_STAGE_SAMPLES */
+#define DEFAULT_FRAMES      20000
+#define EQUIV_SAMPLES       (50000 * 4)             /* 4 s at 50 kHz */
+#define PI                  3.14159265358979
+
+static double now_sec(void) {
+#ifdef _WIN32
+    LARGE_INTEGER f, c;
+    QueryPerformanceFrequency(&f);
+    QueryPerformanceCounter(&c);
+    return (double)c.QuadPart / (double)f.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+/*============================================================================
+ * Test Signal
+ *============================================================================*/
+
+/* Carrier plus noise with a 40 dB fade in and back out over n pairs */
+static void make_signal(float *iq, int n) {
+    uint32_t lcg = 12345;
+    for (int k = 0; k < n; k++) {
+        float nz[2];
+        for (int j = 0; j < 2; j++) {
+            lcg = lcg * 1664525u + 1013904223u;
+            nz[j] = (float)(lcg >> 8) / 16777216.0f - 0.5f;
+        }
+        double ph = 2.0 * PI * 0.02 * k;
+        float amp = 0.5f * (float)pow(10.0, -2.0 * fabs(sin(PI * k / n)));
+        iq[2 * k] = amp * (float)cos(ph) + 0.01f * nz[0];
+        iq[2 * k + 1] = amp * (float)sin(ph) + 0.01f * nz[1];
+    }
+}
+
+/* Worst |a/b - 1| over pairs [from, to), by magnitude */
+static double worst_error(const float *a, const float *b, int from, int to) {
+    double worst = 0.0;
+    for (int k = from; k < to; k++) {
+        double ma = hypot(a[2 * k], a[2 * k + 1]);
+        double mb = hypot(b[2 * k], b[2 * k + 1]);
+        if (mb < 1e-3) continue;
+        double e = fabs(ma / mb - 1.0);
+        if (e > worst) worst = e;
+    }
+    return worst;
+}
+
+/*============================================================================
+ * Throughput
+ *============================================================================*/
+
+typedef void (*normalize_fn)(block_normalizer_t *, float *, int);
+
+/* Million I/Q pairs per second; each call works on a fresh copy of the input */
+static double time_normalizer(normalize_fn fn, const float *iq, float *work, int n, int frames) {
+    block_normalizer_t bn;
+    block_normalizer_init(&bn);
+    double t0 = now_sec();
+    for (int f = 0; f < frames; f++) {
+        memcpy(work, iq, (size_t)n * 2 * sizeof(float));
+        fn(&bn, work, n);
+    }
+    return (double)n * frames / (now_sec() - t0) / 1e6;
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  -s SAMPLES   I/Q pairs per call (default: %d)\n", DEFAULT_SAMPLES);
+    printf("  -n FRAMES    Calls per throughput run (default: %d)\n", DEFAULT_FRAMES);
+    printf("  -h, --help   Show this help\n");
+}
+
+int main(int argc, char *argv[]) {
+    print_version("Phoenix SDR - Normalizer Benchmark");
+
+    int samples = DEFAULT_SAMPLES;
+    int frames = DEFAULT_FRAMES;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            samples = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (samples <= 0 || samples > 1000000 || frames <= 0) {
+        fprintf(stderr, "Call size out of range\n");
+        return 1;
+    }
+
+    float *ref = (float *)malloc((size_t)EQUIV_SAMPLES * 2 * sizeof(float));
+    float *blk = (float *)malloc((size_t)EQUIV_SAMPLES * 2 * sizeof(float));
+    float *input = (float *)malloc((size_t)samples * 2 * sizeof(float));
+    float *work = (float *)malloc((size_t)samples * 2 * sizeof(float));
+    if (!ref || !blk || !input || !work) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    /* Equivalence: whole run through each path, block path in -s sized calls */
+    block_normalizer_t a, b;
+    block_normalizer_init(&a);
+    block_normalizer_init(&b);
+    make_signal(ref, EQUIV_SAMPLES);
+    memcpy(blk, ref, (size_t)EQUIV_SAMPLES * 2 * sizeof(float));
+    block_normalizer_process_per_sample(&a, ref, EQUIV_SAMPLES);
+    for (int pos = 0; pos < EQUIV_SAMPLES; pos += samples) {
+        int n = (EQUIV_SAMPLES - pos < samples) ? EQUIV_SAMPLES - pos : samples;
+        block_normalizer_process(&b, blk + 2 * pos, n);
+    }
+
+    printf("Call: %d I/Q pairs, chunk %d\n\n", samples, BLOCK_NORM_CHUNK);
+    printf("Equivalence (4 s, 40 dB fade)\n");
+    printf("  worst difference after first chunk  %7.3f%%\n",
+           100.0 * worst_error(blk, ref, BLOCK_NORM_CHUNK, EQUIV_SAMPLES));
+    printf("  worst difference after warmup       %7.3f%%\n",
+           100.0 * worst_error(blk, ref, BLOCK_NORM_WARMUP_SAMPLES, EQUIV_SAMPLES));
+    printf("  final level (block / per-sample)    %9.5f\n",
+           block_normalizer_level(&b) / block_normalizer_level(&a));
+
+    /* Throughput: the input is the same fade compressed into one call */
+    make_signal(input, samples);
+
+    double vs = time_normalizer(block_normalizer_process, input, work, samples, frames);
+    double ps = time_normalizer(block_normalizer_process_per_sample, input, work, samples, frames);
+    printf("\nThroughput (M pairs/s)\n");
+    printf("  block       %8.1f\n", vs);
+    printf("  per-sample  %8.1f\n", ps);
+    printf("  speedup     %8.2fx\n", vs / ps);
+
+    free(ref);
+    free(blk);
+    free(input);
+    free(work);
+    return 0;
+}
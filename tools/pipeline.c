@@ -0,0 +1,864 @@
+/**
+ * @file pipeline.c
+ * @brief sdr_server, signal_splitter and signal_relay in one process
+ *
+ * Three threads, one per stage:
+ *
+ *   source   sdr_manager device thread. '>': its sink copies each block
+ *            into the source queue. '|': its raw PHXI port, as sdr_server.
+ *   split    split_stage.c on the source's S16 blocks (or a phxi client's
+ *            frames), cut into PIPELINE_FRAME_SIZE relay frames. '>': into
+ *            the split queue. '|': FT32 streams to the relay ports, as
+ *            signal_splitter. A blank stage is split_stage's blanker.
+ *   relay    Two relay_fanout_t on the detector and display ports, as
+ *            signal_relay. '>': frames straight from the split queue.
+ *
+ * Every hop is bounded - a full queue or socket holds the stage before it
+ * up - so nothing is dropped inside the pipeline; only the relay's client
+ * rings overflow, as they do in signal_relay.
+ */
+
+#include "pipeline.h"
+#include "split_stage.h"
+#include "iq_client.h"
+#include "iq_events.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+typedef int socklen_t;
+#define socket_close closesocket
+#define sleep_ms(ms) Sleep(ms)
+#define SEND_FLAGS 0
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#define socket_close close
+#define sleep_ms(ms) usleep((ms) * 1000)
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+#endif
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+#define POLL_MS             100         /* Split stage: longest wait for input */
+#define RELAY_POLL_MS       5           /* Relay stage: longest wait for frames or sockets */
+#define RELAY_DRAIN_MAX     16          /* Frames from the queue between socket checks */
+#define RELAY_RECV_BUFFER   65536       /* As signal_relay */
+#define STATS_MS            100         /* Relay stats copied out this often */
+
+enum { STREAM_DET = 0, STREAM_DISP = 1 };
+
+/* One split output on its way to the relay */
+typedef struct {
+    float    frame[PIPELINE_FRAME_SIZE * 2];
+    uint32_t fill;
+    uint32_t sequence;
+    uint32_t sample_rate;
+    relay_socket_t sock;            /* '|': connection to the relay port */
+} split_path_t;
+
+struct pipeline {
+    pipeline_desc_t desc;
+    pipeline_options_t opt;
+    const pipeline_stage_t *source;
+    const pipeline_stage_t *relay;
+
+    /* Source */
+    sdr_manager_t *mgr;
+    pipe_queue_t  *source_q;        /* '>' source -> split */
+    uint32_t       source_seq;
+
+    /* Split */
+    iq_client_t   *client;          /* '|' source -> split, or phxi */
+    split_stage_t *split;
+    bool           blanking;
+    iq_conditioner_t conditioner;
+    bool           events;
+    float          convert[SPLIT_MAX_BLOCK * 2];
+    float          det_out[SPLIT_DETECTOR_OUT_MAX * 2];
+    float          disp_out[SPLIT_DISPLAY_OUT_MAX * 2];
+    split_path_t   paths[2];
+    pipe_queue_t  *split_q;         /* '>' split -> relay */
+
+    /* Relay */
+    relay_fanout_t *fanout[2];
+    relay_socket_t  listeners[2];
+    relay_socket_t  sources[2];     /* '|': adopted split connections */
+    int             ports[2];
+    uint8_t         recv_buf[RELAY_RECV_BUFFER];
+
+    pthread_t split_thread;
+    pthread_t relay_thread;
+    bool split_started;
+    bool relay_started;
+    atomic_bool running;
+    atomic_bool source_linked;
+    atomic_int  relay_linked;       /* Sources adopted */
+
+    atomic_uint_fast64_t samples_in;
+    atomic_uint_fast64_t det_samples;
+    atomic_uint_fast64_t disp_samples;
+    atomic_uint_fast64_t frames_lost;
+    atomic_uint_fast64_t blanked;
+    atomic_uint_fast64_t impulses;
+
+    pthread_mutex_t stats_lock;     /* relay_stats */
+    relay_fanout_stats_t relay_stats[2];
+};
+
+static const char *const g_stream_names[2] = { "DETECTOR", "DISPLAY" };
+
+static uint64_t now_ms(void) {
+#ifdef _WIN32
+    return GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)(ts.tv_nsec / 1000000);
+#endif
+}
+
+/*============================================================================
+ * Description
+ *============================================================================*/
+
+static bool is_source(pipeline_stage_type_t t) {
+    return t == PIPE_STAGE_TONE || t == PIPE_STAGE_REPLAY || t == PIPE_STAGE_RSP || t == PIPE_STAGE_PHXI;
+}
+
+static bool parse_int(const char *s, int lo, int hi, int *out) {
+    char *end;
+    long v = strtol(s, &end, 10);
+    if (end == s || *end != '\0' || v < lo || v > hi) return false;
+    *out = (int)v;
+    return true;
+}
+
+/* One stage token, trimmed; false with a reason in err */
+static bool parse_stage(char *tok, pipeline_stage_t *st, char *err, size_t err_size) {
+    char *arg = strchr(tok, ':');
+    if (arg) *arg++ = '\0';
+
+    memset(st, 0, sizeof(*st));
+    if (strcmp(tok, "tone") == 0) {
+        st->type = PIPE_STAGE_TONE;
+        st->tone_hz = 1000.0;
+        if (arg) {
+            char *end;
+            st->tone_hz = strtod(arg, &end);
+            if (end == arg || *end != '\0') {
+                snprintf(err, err_size, "bad tone offset '%s'", arg);
+                return false;
+            }
+        }
+    } else if (strcmp(tok, "replay") == 0) {
+        st->type = PIPE_STAGE_REPLAY;
+        if (!arg || !*arg) {
+            snprintf(err, err_size, "replay needs a file (replay:PATH)");
+            return false;
+        }
+        snprintf(st->path, sizeof(st->path), "%s", arg);
+    } else if (strcmp(tok, "rsp") == 0) {
+        int idx = 0;
+        st->type = PIPE_STAGE_RSP;
+        if (arg && !parse_int(arg, 0, SDR_MANAGER_MAX_DEVICES - 1, &idx)) {
+            snprintf(err, err_size, "bad RSP index '%s'", arg);
+            return false;
+        }
+        st->device_idx = (unsigned)idx;
+    } else if (strcmp(tok, "phxi") == 0) {
+        char *port = arg ? strrchr(arg, ':') : NULL;
+        st->type = PIPE_STAGE_PHXI;
+        if (!port || port == arg || !parse_int(port + 1, 1, 65535, &st->port)) {
+            snprintf(err, err_size, "phxi needs HOST:PORT");
+            return false;
+        }
+        *port = '\0';
+        snprintf(st->host, sizeof(st->host), "%s", arg);
+    } else if (strcmp(tok, "blank") == 0) {
+        st->type = PIPE_STAGE_BLANK;
+        st->blank_threshold = NB_DEFAULT_THRESHOLD;
+        if (arg) {
+            char *end;
+            st->blank_threshold = strtof(arg, &end);
+            if (end == arg || *end != '\0' || !(st->blank_threshold > 0.0f)) {
+                snprintf(err, err_size, "bad blank threshold '%s'", arg);
+                return false;
+            }
+        }
+    } else if (strcmp(tok, "split") == 0) {
+        st->type = PIPE_STAGE_SPLIT;
+        if (arg) {
+            snprintf(err, err_size, "split takes no arguments");
+            return false;
+        }
+    } else if (strcmp(tok, "relay") == 0) {
+        char *disp = arg ? strchr(arg, ':') : NULL;
+        st->type = PIPE_STAGE_RELAY;
+        st->det_port = PIPELINE_DEFAULT_DET_PORT;
+        st->disp_port = PIPELINE_DEFAULT_DISP_PORT;
+        if (disp) *disp++ = '\0';
+        if ((arg && !parse_int(arg, 0, 65535, &st->det_port)) ||
+            (disp && !parse_int(disp, 0, 65535, &st->disp_port))) {
+            snprintf(err, err_size, "bad relay port");
+            return false;
+        }
+    } else {
+        snprintf(err, err_size, "unknown stage '%s'", tok);
+        return false;
+    }
+    return true;
+}
+
+bool pipeline_parse(const char *text, pipeline_desc_t *desc, char *err, size_t err_size) {
+    char scratch[64];
+    char buf[1024];
+    if (!err) {
+        err = scratch;
+        err_size = sizeof(scratch);
+    }
+    err[0] = '\0';
+    memset(desc, 0, sizeof(*desc));
+
+    if (!text || strlen(text) >= sizeof(buf)) {
+        snprintf(err, err_size, "description missing or too long");
+        return false;
+    }
+    snprintf(buf, sizeof(buf), "%s", text);
+
+    char *p = buf;
+    for (;;) {
+        char *end = p + strcspn(p, ">|");
+        char link = *end;
+        *end = '\0';
+
+        /* Trim */
+        while (isspace((unsigned char)*p)) p++;
+        char *t = p + strlen(p);
+        while (t > p && isspace((unsigned char)t[-1])) *--t = '\0';
+
+        if (!*p) {
+            snprintf(err, err_size, "empty stage");
+            return false;
+        }
+        if (desc->n_stages == PIPELINE_MAX_STAGES) {
+            snprintf(err, err_size, "more than %d stages", PIPELINE_MAX_STAGES);
+            return false;
+        }
+        if (!parse_stage(p, &desc->stages[desc->n_stages], err, err_size)) return false;
+        if (!link) {
+            desc->n_stages++;
+            break;
+        }
+        desc->links[desc->n_stages++] = link == '>' ? PIPE_LINK_QUEUE : PIPE_LINK_TCP;
+        p = end + 1;
+    }
+
+    /* SOURCE, [blank,] split, relay */
+    const pipeline_stage_t *s = desc->stages;
+    int n = desc->n_stages;
+    bool blank = n == 4 && s[1].type == PIPE_STAGE_BLANK;
+    if ((n != 3 && !blank) || !is_source(s[0].type) ||
+        s[n - 2].type != PIPE_STAGE_SPLIT || s[n - 1].type != PIPE_STAGE_RELAY) {
+        snprintf(err, err_size, "expected SOURCE LINK [blank >] split LINK relay");
+        return false;
+    }
+    if (blank && desc->links[1] != PIPE_LINK_QUEUE) {
+        snprintf(err, err_size, "blank runs on the split thread; link it to split with '>'");
+        return false;
+    }
+    if (s[0].type == PIPE_STAGE_PHXI && desc->links[0] != PIPE_LINK_TCP) {
+        snprintf(err, err_size, "a phxi source is a network edge; link it with '|'");
+        return false;
+    }
+    return true;
+}
+
+void pipeline_format(const pipeline_desc_t *desc, char *buf, size_t size) {
+    size_t len = 0;
+    buf[0] = '\0';
+
+    for (int k = 0; k < desc->n_stages && len < size; k++) {
+        const pipeline_stage_t *st = &desc->stages[k];
+        char stage[320];
+        switch (st->type) {
+            case PIPE_STAGE_TONE:   snprintf(stage, sizeof(stage), "tone:%g", st->tone_hz); break;
+            case PIPE_STAGE_REPLAY: snprintf(stage, sizeof(stage), "replay:%s", st->path); break;
+            case PIPE_STAGE_RSP:    snprintf(stage, sizeof(stage), "rsp:%u", st->device_idx); break;
+            case PIPE_STAGE_PHXI:   snprintf(stage, sizeof(stage), "phxi:%.255s:%d", st->host, st->port); break;
+            case PIPE_STAGE_BLANK:  snprintf(stage, sizeof(stage), "blank:%g", st->blank_threshold); break;
+            case PIPE_STAGE_SPLIT:  snprintf(stage, sizeof(stage), "split"); break;
+            case PIPE_STAGE_RELAY:  snprintf(stage, sizeof(stage), "relay:%d:%d", st->det_port, st->disp_port); break;
+        }
+        int n = snprintf(buf + len, size - len, "%s%s", stage,
+                         k + 1 < desc->n_stages ? (desc->links[k] == PIPE_LINK_QUEUE ? " > " : " | ") : "");
+        if (n < 0) break;
+        len += (size_t)n;
+    }
+}
+
+void pipeline_options_defaults(pipeline_options_t *opt) {
+    memset(opt, 0, sizeof(*opt));
+    opt->paced = true;
+    opt->iq_port = SDR_PORT_NONE;
+    opt->core = -1;
+    opt->queue_blocks = PIPELINE_QUEUE_BLOCKS;
+}
+
+/*============================================================================
+ * Sockets
+ *============================================================================*/
+
+static bool would_block(void) {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+static bool send_all(relay_socket_t s, const void *data, size_t len) {
+    const char *p = (const char*)data;
+    while (len > 0) {
+        int sent = send(s, p, (int)len, SEND_FLAGS);
+        if (sent <= 0) return false;
+        p += sent;
+        len -= (size_t)sent;
+    }
+    return true;
+}
+
+/* Listener on port (0: any); *bound gets the port actually bound */
+static relay_socket_t listen_on(int port, int *bound) {
+    relay_socket_t fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    int reuse = 1;
+
+    if (fd == RELAY_SOCKET_INVALID) return RELAY_SOCKET_INVALID;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse)) != 0 ||
+        bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 10) != 0 ||
+        getsockname(fd, (struct sockaddr*)&addr, &len) != 0) {
+        socket_close(fd);
+        return RELAY_SOCKET_INVALID;
+    }
+    *bound = ntohs(addr.sin_port);
+    return fd;
+}
+
+static relay_socket_t connect_local(int port) {
+    relay_socket_t fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    struct sockaddr_in addr;
+
+    if (fd == RELAY_SOCKET_INVALID) return RELAY_SOCKET_INVALID;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons((uint16_t)port);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        socket_close(fd);
+        return RELAY_SOCKET_INVALID;
+    }
+    return fd;
+}
+
+/*============================================================================
+ * Source Stage ('>' link)
+ *============================================================================*/
+
+/* Device thread: interleave the block into the queue, waiting for room */
+static void source_sink(int device, const int16_t *xi, const int16_t *xq, uint32_t count,
+                        const decim_complex_t *decim, size_t n_decim, void *user) {
+    pipeline_t *p = (pipeline_t*)user;
+    (void)device;
+    (void)decim;
+    (void)n_decim;
+
+    pipe_block_t *b = pipe_queue_reserve(p->source_q, PIPE_QUEUE_WAIT);
+    if (!b) return;     /* Closed: shutting down */
+
+    int16_t *out = (int16_t*)b->samples;
+    for (uint32_t i = 0; i < count; i++) {
+        out[2 * i] = xi[i];
+        out[2 * i + 1] = xq[i];
+    }
+    b->stream = 0;
+    b->sample_rate = SPLIT_INPUT_RATE;
+    b->sequence = p->source_seq++;
+    b->count = count;
+    pipe_queue_commit(p->source_q);
+}
+
+/*============================================================================
+ * Split Stage
+ *============================================================================*/
+
+/* A full relay frame: into the split queue, or out to the relay port */
+static void emit_frame(pipeline_t *p, int stream) {
+    split_path_t *sp = &p->paths[stream];
+
+    if (p->split_q) {
+        pipe_block_t *b = pipe_queue_reserve(p->split_q, PIPE_QUEUE_WAIT);
+        if (b) {
+            memcpy(b->samples, sp->frame, (size_t)sp->fill * 2 * sizeof(float));
+            b->stream = (uint32_t)stream;
+            b->sample_rate = sp->sample_rate;
+            b->sequence = sp->sequence;
+            b->count = sp->fill;
+            pipe_queue_commit(p->split_q);
+        }
+    } else if (sp->sock != RELAY_SOCKET_INVALID) {
+        /* As signal_splitter: frame header, then the samples */
+        relay_data_frame_t h = { RELAY_MAGIC_DATA, sp->sequence, sp->fill, 0 };
+        if (!send_all(sp->sock, &h, sizeof(h)) ||
+            !send_all(sp->sock, sp->frame, (size_t)sp->fill * 2 * sizeof(float))) {
+            fprintf(stderr, "[PIPELINE] Split -> relay %s link lost\n", g_stream_names[stream]);
+            socket_close(sp->sock);
+            sp->sock = RELAY_SOCKET_INVALID;
+        }
+    }
+    sp->sequence++;
+    sp->fill = 0;
+}
+
+static void append(pipeline_t *p, int stream, const float *iq, size_t n) {
+    split_path_t *sp = &p->paths[stream];
+    while (n > 0) {
+        size_t take = PIPELINE_FRAME_SIZE - sp->fill;
+        if (take > n) take = n;
+        memcpy(sp->frame + (size_t)sp->fill * 2, iq, take * 2 * sizeof(float));
+        sp->fill += (uint32_t)take;
+        iq += take * 2;
+        n -= take;
+        if (sp->fill == PIPELINE_FRAME_SIZE) emit_frame(p, stream);
+    }
+}
+
+static void split_output(pipeline_t *p, uint32_t count, const split_output_t *out) {
+    noise_blanker_stats_t nb;
+    if (p->blanking && split_stage_blanker_stats(p->split, &nb)) {
+        atomic_store(&p->blanked, nb.blanked);
+        atomic_store(&p->impulses, nb.impulses);
+    }
+    atomic_fetch_add(&p->samples_in, count);
+    atomic_fetch_add(&p->det_samples, out->n_det);
+    atomic_fetch_add(&p->disp_samples, out->n_disp);
+    append(p, STREAM_DET, out->det, out->n_det);
+    append(p, STREAM_DISP, out->disp, out->n_disp);
+}
+
+static void split_s16(pipeline_t *p, const int16_t *iq, uint32_t count) {
+    split_output_t out = { p->det_out, 0, p->disp_out, 0 };
+    split_stage_process_s16(p->split, iq, count, &out);
+    split_output(p, count, &out);
+}
+
+/* A PHXI frame, as signal_splitter handles it */
+static void split_frame(pipeline_t *p, const iq_client_frame_t *f) {
+    uint32_t format = iq_client_stream(p->client)->sample_format;
+    uint32_t n = f->num_samples * 2;
+
+    if (f->num_samples > SPLIT_MAX_BLOCK) {
+        fprintf(stderr, "[PIPELINE] Source frame too large: %u samples\n", f->num_samples);
+        iq_client_disconnect(p->client);
+        return;
+    }
+    if (f->frames_lost > 0) atomic_fetch_add(&p->frames_lost, f->frames_lost);
+
+    if (format == IQ_CLIENT_FORMAT_S16 && !p->events) {
+        split_s16(p, (const int16_t*)f->samples, f->num_samples);
+        return;
+    }
+
+    if (format == IQ_CLIENT_FORMAT_S16) {
+        const int16_t *smp = (const int16_t*)f->samples;
+        for (uint32_t s = 0; s < n; s++) p->convert[s] = (float)smp[s] / 32768.0f;
+    } else if (format == IQ_CLIENT_FORMAT_F32) {
+        memcpy(p->convert, f->samples, n * sizeof(float));
+    } else {
+        const uint8_t *smp = (const uint8_t*)f->samples;
+        for (uint32_t s = 0; s < n; s++) p->convert[s] = (float)(smp[s] - 128) / 128.0f;
+    }
+    if (p->events) {
+        iq_conditioner_apply(&p->conditioner, p->convert, NULL, f->num_samples, f->events, f->n_events);
+    }
+
+    split_output_t out = { p->det_out, 0, p->disp_out, 0 };
+    split_stage_process(p->split, p->convert, f->num_samples, &out);
+    split_output(p, f->num_samples, &out);
+}
+
+static void *split_thread(void *arg) {
+    pipeline_t *p = (pipeline_t*)arg;
+
+    while (atomic_load(&p->running)) {
+        if (p->source_q) {
+            pipe_block_t *b = pipe_queue_front(p->source_q, POLL_MS);
+            if (!b) continue;
+            split_s16(p, (const int16_t*)b->samples, b->count);
+            pipe_queue_pop(p->source_q);
+            continue;
+        }
+
+        iq_client_frame_t frame;
+        switch (iq_client_next(p->client, &frame, POLL_MS)) {
+            case IQ_CLIENT_CONNECTED: {
+                const iq_client_stream_t *st = iq_client_stream(p->client);
+                p->events = st->events;
+                iq_conditioner_init(&p->conditioner, st->sample_rate);
+                atomic_store(&p->source_linked, true);
+                break;
+            }
+            case IQ_CLIENT_DISCONNECTED:
+                atomic_store(&p->source_linked, false);
+                break;
+            case IQ_CLIENT_FRAME:
+                split_frame(p, &frame);
+                break;
+            default:
+                break;
+        }
+    }
+    return NULL;
+}
+
+/*============================================================================
+ * Relay Stage
+ *============================================================================*/
+
+static void copy_relay_stats(pipeline_t *p) {
+    pthread_mutex_lock(&p->stats_lock);
+    relay_fanout_get_stats(p->fanout[STREAM_DET], &p->relay_stats[STREAM_DET]);
+    relay_fanout_get_stats(p->fanout[STREAM_DISP], &p->relay_stats[STREAM_DISP]);
+    pthread_mutex_unlock(&p->stats_lock);
+}
+
+#define FD_ADD(fd) do { FD_SET((fd), &readfds); if ((int)(fd) > max_fd) max_fd = (int)(fd); } while (0)
+
+/* One select() over listeners, sources and pending connections */
+static void relay_poll(pipeline_t *p, int timeout_ms) {
+    fd_set readfds;
+    struct timeval tv;
+    int max_fd = -1;
+
+    FD_ZERO(&readfds);
+    for (int s = 0; s < 2; s++) {
+        relay_socket_t pending[RELAY_FANOUT_PENDING_MAX];
+        int n = relay_fanout_pending_fds(p->fanout[s], pending, RELAY_FANOUT_PENDING_MAX);
+        FD_ADD(p->listeners[s]);
+        if (p->sources[s] != RELAY_SOCKET_INVALID) FD_ADD(p->sources[s]);
+        for (int i = 0; i < n; i++) FD_ADD(pending[i]);
+    }
+
+    tv.tv_sec = 0;
+    tv.tv_usec = timeout_ms * 1000;
+    if (select(max_fd + 1, &readfds, NULL, NULL, &tv) < 0) return;
+
+    for (int s = 0; s < 2; s++) {
+        relay_socket_t fd;
+        if (FD_ISSET(p->listeners[s], &readfds)) relay_fanout_accept(p->fanout[s], p->listeners[s]);
+
+        /* A source here is the split stage's '|' link; with '>' the split
+         * stage is in process and an outside source has no place */
+        while ((fd = relay_fanout_service_pending(p->fanout[s])) != RELAY_SOCKET_INVALID) {
+            if (p->split_q || p->sources[s] != RELAY_SOCKET_INVALID) {
+                fprintf(stderr, "[SOURCE-%s] Port fed by the pipeline, source refused\n", g_stream_names[s]);
+                socket_close(fd);
+                continue;
+            }
+            p->sources[s] = fd;
+            relay_fanout_reset(p->fanout[s]);
+            atomic_fetch_add(&p->relay_linked, 1);
+        }
+
+        if (p->sources[s] != RELAY_SOCKET_INVALID && FD_ISSET(p->sources[s], &readfds)) {
+            int got = (int)recv(p->sources[s], (char*)p->recv_buf, sizeof(p->recv_buf), 0);
+            if (got > 0) {
+                relay_fanout_feed(p->fanout[s], p->recv_buf, (size_t)got);
+            } else if (got == 0 || !would_block()) {
+                fprintf(stderr, "[SOURCE-%s] Connection closed\n", g_stream_names[s]);
+                socket_close(p->sources[s]);
+                p->sources[s] = RELAY_SOCKET_INVALID;
+                atomic_fetch_sub(&p->relay_linked, 1);
+            }
+        }
+    }
+}
+
+static void *relay_thread(void *arg) {
+    pipeline_t *p = (pipeline_t*)arg;
+    uint64_t last_stats = 0;
+
+    while (atomic_load(&p->running)) {
+        int wait_ms = RELAY_POLL_MS;
+
+        /* Queued frames first; the wait for them stands in for select()'s */
+        if (p->split_q) {
+            pipe_block_t *b = pipe_queue_front(p->split_q, RELAY_POLL_MS);
+            for (int k = 0; b && k < RELAY_DRAIN_MAX; k++) {
+                relay_fanout_frame(p->fanout[b->stream], b->sequence, (const float*)b->samples, b->count);
+                pipe_queue_pop(p->split_q);
+                if (k + 1 < RELAY_DRAIN_MAX) b = pipe_queue_front(p->split_q, 0);
+            }
+            wait_ms = 0;
+        }
+
+        relay_poll(p, wait_ms);
+        relay_fanout_send(p->fanout[STREAM_DET]);
+        relay_fanout_send(p->fanout[STREAM_DISP]);
+
+        uint64_t now = now_ms();
+        if (now - last_stats >= STATS_MS) {
+            copy_relay_stats(p);
+            last_stats = now;
+        }
+    }
+    copy_relay_stats(p);
+    return NULL;
+}
+
+/*============================================================================
+ * Create / Destroy
+ *============================================================================*/
+
+static bool open_source(pipeline_t *p) {
+    const pipeline_stage_t *src = p->source;
+
+    if (src->type == PIPE_STAGE_PHXI) {
+        p->client = iq_client_create(src->host, src->port, IQ_CLIENT_PROTO_PHXI);
+        return p->client != NULL;
+    }
+
+    sdr_device_spec_t spec;
+    sdr_manager_spec_defaults(&spec, src->type == PIPE_STAGE_TONE   ? SDR_BACKEND_TONE :
+                                     src->type == PIPE_STAGE_REPLAY ? SDR_BACKEND_REPLAY :
+                                                                      SDR_BACKEND_HARDWARE);
+    spec.tone_hz = src->tone_hz;
+    spec.device_idx = src->device_idx;
+    snprintf(spec.replay_path, sizeof(spec.replay_path), "%s", src->path);
+    spec.paced = p->opt.paced;
+    spec.iq_port = p->opt.iq_port;
+    spec.core = p->opt.core;
+    if (p->source_q) {
+        spec.sink = source_sink;
+        spec.sink_user = p;
+        spec.sink_raw_only = true;
+    } else if (spec.iq_port == SDR_PORT_NONE) {
+        spec.iq_port = SDR_PORT_ANY;
+    }
+
+    p->mgr = sdr_manager_create();
+    if (!p->mgr || sdr_manager_add(p->mgr, &spec) < 0) return false;
+    if (p->source_q) return true;
+
+    sdr_device_stats_t st;
+    sdr_manager_get_stats(p->mgr, 0, &st);
+    p->client = iq_client_create("127.0.0.1", st.iq_port, IQ_CLIENT_PROTO_PHXI);
+    return p->client != NULL;
+}
+
+/* '|' split -> relay: connect and announce each stream, as signal_splitter */
+static bool link_split_to_relay(pipeline_t *p) {
+    for (int s = 0; s < 2; s++) {
+        split_path_t *sp = &p->paths[s];
+        relay_stream_header_t h = { RELAY_MAGIC_FT32, sp->sample_rate, IQ_ENC_F32, 0 };
+        sp->sock = connect_local(p->ports[s]);
+        if (sp->sock == RELAY_SOCKET_INVALID || !send_all(sp->sock, &h, sizeof(h))) return false;
+    }
+    return true;
+}
+
+static bool linked(pipeline_t *p) {
+    bool source_ok = p->source_q || p->source->type == PIPE_STAGE_PHXI || atomic_load(&p->source_linked);
+    bool relay_ok = p->split_q || atomic_load(&p->relay_linked) == 2;
+    return source_ok && relay_ok;
+}
+
+pipeline_t *pipeline_create(const pipeline_desc_t *desc, const pipeline_options_t *opt) {
+    pipeline_options_t defaults;
+    if (!desc || desc->n_stages < 3 || desc->n_stages > 4) return NULL;
+    if (!opt) {
+        pipeline_options_defaults(&defaults);
+        opt = &defaults;
+    }
+
+    pipeline_t *p = (pipeline_t*)calloc(1, sizeof(pipeline_t));
+    if (!p) return NULL;
+    p->desc = *desc;
+    p->opt = *opt;
+    p->source = &p->desc.stages[0];
+    p->relay = &p->desc.stages[desc->n_stages - 1];
+    p->paths[STREAM_DET].sample_rate = SPLIT_DETECTOR_RATE;
+    p->paths[STREAM_DISP].sample_rate = SPLIT_DISPLAY_RATE;
+    for (int s = 0; s < 2; s++) {
+        p->paths[s].sock = RELAY_SOCKET_INVALID;
+        p->listeners[s] = RELAY_SOCKET_INVALID;
+        p->sources[s] = RELAY_SOCKET_INVALID;
+    }
+    pthread_mutex_init(&p->stats_lock, NULL);
+    atomic_store(&p->running, true);
+
+#ifdef _WIN32
+    WSADATA wsa;
+    WSAStartup(MAKEWORD(2, 2), &wsa);
+#endif
+
+    uint32_t blocks = opt->queue_blocks > 0 ? opt->queue_blocks : PIPELINE_QUEUE_BLOCKS;
+    if (desc->links[0] == PIPE_LINK_QUEUE) {
+        p->source_q = pipe_queue_create(blocks, SDR_MANAGER_BLOCK, 2 * sizeof(int16_t));
+    }
+    pipeline_link_t split_link = desc->links[desc->n_stages - 2];
+    if (split_link == PIPE_LINK_QUEUE) {
+        p->split_q = pipe_queue_create(blocks, PIPELINE_FRAME_SIZE, 2 * sizeof(float));
+    }
+    p->split = split_stage_create();
+    if (p->split && desc->stages[1].type == PIPE_STAGE_BLANK) {
+        noise_blanker_config_t nb;
+        noise_blanker_default_config(&nb, (float)SPLIT_INPUT_RATE);
+        nb.threshold = desc->stages[1].blank_threshold;
+        p->blanking = split_stage_set_blanker(p->split, &nb);
+        if (!p->blanking) {
+            fprintf(stderr, "[PIPELINE] Bad blanker settings\n");
+            pipeline_destroy(p);
+            return NULL;
+        }
+    }
+    p->fanout[STREAM_DET] = relay_fanout_create(g_stream_names[STREAM_DET], SPLIT_DETECTOR_RATE);
+    p->fanout[STREAM_DISP] = relay_fanout_create(g_stream_names[STREAM_DISP], SPLIT_DISPLAY_RATE);
+    if ((desc->links[0] == PIPE_LINK_QUEUE && !p->source_q) ||
+        (split_link == PIPE_LINK_QUEUE && !p->split_q) ||
+        !p->split || !p->fanout[STREAM_DET] || !p->fanout[STREAM_DISP]) {
+        fprintf(stderr, "[PIPELINE] Out of memory\n");
+        pipeline_destroy(p);
+        return NULL;
+    }
+
+    int want[2] = { p->relay->det_port, p->relay->disp_port };
+    for (int s = 0; s < 2; s++) {
+        p->listeners[s] = listen_on(want[s], &p->ports[s]);
+        if (p->listeners[s] == RELAY_SOCKET_INVALID) {
+            fprintf(stderr, "[PIPELINE] Cannot listen on %s port %d\n", g_stream_names[s], want[s]);
+            pipeline_destroy(p);
+            return NULL;
+        }
+    }
+
+    if (!open_source(p)) {
+        fprintf(stderr, "[PIPELINE] Cannot open the source\n");
+        pipeline_destroy(p);
+        return NULL;
+    }
+    if (!p->split_q && !link_split_to_relay(p)) {
+        fprintf(stderr, "[PIPELINE] Cannot link split to relay\n");
+        pipeline_destroy(p);
+        return NULL;
+    }
+
+    if (pthread_create(&p->relay_thread, NULL, relay_thread, p) != 0) {
+        pipeline_destroy(p);
+        return NULL;
+    }
+    p->relay_started = true;
+    if (pthread_create(&p->split_thread, NULL, split_thread, p) != 0) {
+        pipeline_destroy(p);
+        return NULL;
+    }
+    p->split_started = true;
+
+    uint64_t start = now_ms();
+    while (!linked(p)) {
+        if (now_ms() - start > PIPELINE_CONNECT_MS) {
+            fprintf(stderr, "[PIPELINE] TCP links did not come up\n");
+            pipeline_destroy(p);
+            return NULL;
+        }
+        sleep_ms(5);
+    }
+
+    char text[512];
+    pipeline_format(&p->desc, text, sizeof(text));
+    printf("[PIPELINE] %s (detector port %d, display port %d)\n", text, p->ports[0], p->ports[1]);
+    return p;
+}
+
+void pipeline_destroy(pipeline_t *p) {
+    if (!p) return;
+
+    /* Source first, while split and relay still drain what it sends */
+    if (p->source_q) pipe_queue_close(p->source_q);
+    sdr_manager_destroy(p->mgr);
+
+    atomic_store(&p->running, false);
+    if (p->split_q) pipe_queue_close(p->split_q);
+    if (p->split_started) pthread_join(p->split_thread, NULL);
+    if (p->relay_started) pthread_join(p->relay_thread, NULL);
+
+    iq_client_destroy(p->client);
+    for (int s = 0; s < 2; s++) {
+        if (p->paths[s].sock != RELAY_SOCKET_INVALID) socket_close(p->paths[s].sock);
+        if (p->sources[s] != RELAY_SOCKET_INVALID) socket_close(p->sources[s]);
+        if (p->listeners[s] != RELAY_SOCKET_INVALID) socket_close(p->listeners[s]);
+        relay_fanout_destroy(p->fanout[s]);
+    }
+    split_stage_destroy(p->split);
+    pipe_queue_destroy(p->source_q);
+    pipe_queue_destroy(p->split_q);
+    pthread_mutex_destroy(&p->stats_lock);
+    free(p);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+sdr_manager_t *pipeline_manager(pipeline_t *p) {
+    return p->mgr;
+}
+
+void pipeline_get_stats(pipeline_t *p, pipeline_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->linked = linked(p);
+    stats->iq_port = SDR_PORT_NONE;
+    stats->det_port = p->ports[STREAM_DET];
+    stats->disp_port = p->ports[STREAM_DISP];
+    stats->samples_in = atomic_load(&p->samples_in);
+    stats->det_samples = atomic_load(&p->det_samples);
+    stats->disp_samples = atomic_load(&p->disp_samples);
+    stats->source_frames_lost = atomic_load(&p->frames_lost);
+    stats->blanking = p->blanking;
+    stats->blanked = atomic_load(&p->blanked);
+    stats->impulses = atomic_load(&p->impulses);
+
+    if (p->mgr) {
+        sdr_device_stats_t dev;
+        if (sdr_manager_get_stats(p->mgr, 0, &dev)) stats->iq_port = dev.iq_port;
+    }
+    if (p->source_q) pipe_queue_get_stats(p->source_q, &stats->source_queue);
+    if (p->split_q) pipe_queue_get_stats(p->split_q, &stats->split_queue);
+
+    pthread_mutex_lock(&p->stats_lock);
+    stats->det = p->relay_stats[STREAM_DET];
+    stats->disp = p->relay_stats[STREAM_DISP];
+    pthread_mutex_unlock(&p->stats_lock);
+}
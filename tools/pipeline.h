@@ -0,0 +1,172 @@
+/**
+ * @file pipeline.h
+ * @brief sdr_server, signal_splitter and signal_relay in one process
+ *
+ * The usual receive chain is three processes joined by TCP:
+ *
+ *   sdr_server --PHXI S16--> signal_splitter --FT32 x2--> signal_relay --> clients
+ *
+ * A pipeline runs the same stage code on one thread per stage - the
+ * sdr_manager device thread, split_stage.c, relay_fanout.c - and a
+ * description says how each hop is made:
+ *
+ *   tone | split | relay        Loopback TCP, the processes' own wire protocols
+ *   tone > split > relay        Bounded in-memory queues (pipe_queue.h)
+ *
+ * Either way the network is kept at the edges: the device's control
+ * commands (pipeline_manager()), an optional raw I/Q port, and the relay's
+ * detector and display ports, which serve clients exactly as signal_relay
+ * does. Clients cannot tell the two apart; the frames are bit-identical.
+ *
+ * Description grammar (whitespace optional):
+ *
+ *   SOURCE LINK [blank[:K] >] split LINK relay[:DET_PORT[:DISP_PORT]]
+ *
+ *   LINK     '>' queue, '|' TCP
+ *   SOURCE   tone[:HZ]          Synthetic tone, HZ from center (1000)
+ *            replay:PATH        .iqr file, looped (PATH runs to the next link)
+ *            rsp[:IDX]          RSP by enumeration index (0)
+ *            phxi:HOST:PORT     A remote sdr_server; already a network edge,
+ *                               so it takes '|' only
+ *   blank    Impulse blanker (noise_blanker.h) at the full rate, triggering
+ *            at K x the average |x| (6). It runs on the split thread, so
+ *            its link to split is always '>'.
+ *
+ * Relay ports default to 4410 and 4411, as signal_relay; 0 binds any free
+ * port (see pipeline_stats_t).
+ *
+ * Threading: pipeline_create()/pipeline_destroy() from one thread,
+ * pipeline_get_stats() from any.
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sdr_manager.h"
+#include "pipe_queue.h"
+#include "relay_fanout.h"
+#include "noise_blanker.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define PIPELINE_MAX_STAGES         8
+#define PIPELINE_FRAME_SIZE         2048        /* Relay frame, I/Q pairs (signal_splitter RELAY_FRAME_SIZE) */
+#define PIPELINE_QUEUE_BLOCKS       16          /* Default queue depth, blocks */
+#define PIPELINE_DEFAULT_DET_PORT   4410
+#define PIPELINE_DEFAULT_DISP_PORT  4411
+#define PIPELINE_CONNECT_MS         3000        /* pipeline_create(): wait for TCP links */
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct pipeline pipeline_t;
+
+typedef enum {
+    PIPE_STAGE_TONE = 0,
+    PIPE_STAGE_REPLAY,
+    PIPE_STAGE_RSP,
+    PIPE_STAGE_PHXI,
+    PIPE_STAGE_SPLIT,
+    PIPE_STAGE_RELAY,
+    PIPE_STAGE_BLANK
+} pipeline_stage_type_t;
+
+typedef enum {
+    PIPE_LINK_QUEUE = 0,            /* '>' */
+    PIPE_LINK_TCP                   /* '|' */
+} pipeline_link_t;
+
+typedef struct {
+    pipeline_stage_type_t type;
+    double   tone_hz;               /* TONE */
+    unsigned device_idx;            /* RSP */
+    char     path[260];             /* REPLAY */
+    char     host[256];             /* PHXI */
+    int      port;                  /* PHXI */
+    float    blank_threshold;       /* BLANK */
+    int      det_port;              /* RELAY */
+    int      disp_port;
+} pipeline_stage_t;
+
+typedef struct {
+    pipeline_stage_t stages[PIPELINE_MAX_STAGES];
+    pipeline_link_t  links[PIPELINE_MAX_STAGES];    /* links[k]: stages[k] -> stages[k + 1] */
+    int n_stages;
+} pipeline_desc_t;
+
+typedef struct {
+    bool     paced;                 /* TONE/REPLAY: real time (false: as fast as the chain runs) */
+    int      iq_port;               /* Source's raw S16 PHXI port (SDR_PORT_NONE; a '|' link after
+                                       the source takes SDR_PORT_ANY if none is given) */
+    int      core;                  /* Source thread CPU, -1 = not pinned */
+    uint32_t queue_blocks;          /* '>' queue depth */
+} pipeline_options_t;
+
+typedef struct {
+    bool     linked;                /* Every TCP link connected (always true with queues) */
+    int      iq_port;               /* Bound ports, SDR_PORT_NONE if none */
+    int      det_port;
+    int      disp_port;
+    uint64_t samples_in;            /* Pairs into the split stage */
+    uint64_t det_samples;           /* Pairs out of it */
+    uint64_t disp_samples;
+    uint64_t source_frames_lost;    /* '|' from the source: sequence gaps */
+    bool     blanking;              /* A blank stage is in the description */
+    uint64_t blanked;               /* Input pairs blanked */
+    uint64_t impulses;              /* ... in this many windows */
+    pipe_queue_stats_t source_queue;    /* Valid when that link is '>' */
+    pipe_queue_stats_t split_queue;
+    relay_fanout_stats_t det;
+    relay_fanout_stats_t disp;
+} pipeline_stats_t;
+
+/*============================================================================
+ * API
+ *============================================================================*/
+
+/**
+ * @brief Parse a description (see file comment)
+ * @param err  Reason on failure (may be NULL)
+ */
+bool pipeline_parse(const char *text, pipeline_desc_t *desc, char *err, size_t err_size);
+
+/** Canonical text of a description, e.g. "tone:1000 > split > relay:4410:4411" */
+void pipeline_format(const pipeline_desc_t *desc, char *buf, size_t size);
+
+/** Paced, no raw port, not pinned, PIPELINE_QUEUE_BLOCKS */
+void pipeline_options_defaults(pipeline_options_t *opt);
+
+/**
+ * @brief Open the source, bind the relay ports and start the stages
+ *
+ * Returns once every TCP link is connected. Sources start stopped, as
+ * sdr_server does: send START through pipeline_manager().
+ *
+ * @return NULL on failure (reason printed)
+ */
+pipeline_t *pipeline_create(const pipeline_desc_t *desc, const pipeline_options_t *opt);
+
+/** Stop and join every stage, close every port (NULL safe) */
+void pipeline_destroy(pipeline_t *p);
+
+/** The source device's commands (device 0); NULL for a phxi source */
+sdr_manager_t *pipeline_manager(pipeline_t *p);
+
+void pipeline_get_stats(pipeline_t *p, pipeline_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PIPELINE_H */
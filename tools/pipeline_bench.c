@@ -0,0 +1,277 @@
+/**
+ * @file pipeline_bench.c
+ * @brief CPU per MSPS: chained TCP stages vs. the in-process pipeline
+ *
+ * Runs one pipeline description twice - every link '|' (loopback TCP, the
+ * framing, copies and syscalls of sdr_server -> signal_splitter ->
+ * signal_relay) and every link '>' (in-memory queues) - with one float32
+ * client on each relay port, and reports for each:
+ *
+ *   MSPS       Input pairs through the split stage per second
+ *   CPU        Process CPU seconds, less the two benchmark clients' own
+ *   CPU/MSPS   Cores per MSPS: CPU / wall / MSPS
+ *
+ * Unpaced by default, so the chain runs as fast as its slowest stage and
+ * the CPU figure is the whole machine's cost per sample; -r paces the
+ * source at 2 MSPS to see the real-time load instead.
+ *
+ * The '|' run keeps all three stages in one process: it has every hop's
+ * TCP work but not the separate processes' scheduling and address spaces,
+ * so it is a lower bound on the chained-process cost.
+ *
+ * Usage:
+ *   pipeline_bench                                  # Tone, 5 s per run
+ *   pipeline_bench -t 10 -r                         # Real time, 10 s per run
+ *   pipeline_bench -d "replay:wwv.iqr > split > relay:0:0"
+ *   pipeline_bench -d "tone > blank > split > relay:0:0"   # Blanker's share
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "pipeline.h"
+#include "iq_client.h"
+#include "version.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#define sleep_ms(ms) Sleep(ms)
+#else
+#include <unistd.h>
+#include <time.h>
+#define sleep_ms(ms) usleep((ms) * 1000)
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define DEFAULT_DESCRIPTION "tone:1000 > split > relay:0:0"
+#define DEFAULT_SECONDS     5.0
+#define WARMUP_MS           500
+#define CLIENT_POLL_MS      100
+
+static double now_sec(void) {
+#ifdef _WIN32
+    LARGE_INTEGER f, c;
+    QueryPerformanceFrequency(&f);
+    QueryPerformanceCounter(&c);
+    return (double)c.QuadPart / (double)f.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+#ifdef _WIN32
+static double filetime_sec(const FILETIME *ft) {
+    return (double)(((uint64_t)ft->dwHighDateTime << 32) | ft->dwLowDateTime) * 1e-7;
+}
+#endif
+
+/* User + system CPU seconds of the whole process */
+static double process_cpu_sec(void) {
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user);
+    return filetime_sec(&kernel) + filetime_sec(&user);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+/* The same for the calling thread */
+static double thread_cpu_sec(void) {
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user);
+    return filetime_sec(&kernel) + filetime_sec(&user);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+/*============================================================================
+ * Relay Clients
+ *============================================================================*/
+
+typedef struct {
+    pthread_t thread;
+    int port;
+    atomic_bool stop;
+    atomic_uint_fast64_t pairs;
+    double cpu_mark;                /* Thread CPU at the start of the measurement */
+    double cpu;                     /* ... and spent during it */
+    atomic_bool marking;
+    uint64_t frames_lost;
+} client_t;
+
+static void *client_thread(void *arg) {
+    client_t *c = (client_t*)arg;
+    iq_client_t *ic = iq_client_create("127.0.0.1", c->port, IQ_CLIENT_PROTO_FT32);
+    bool marked = false;
+    if (!ic) return NULL;
+    iq_client_set_encoding(ic, IQ_ENC_F32);
+
+    while (!atomic_load(&c->stop)) {
+        iq_client_frame_t frame;
+        if (iq_client_next(ic, &frame, CLIENT_POLL_MS) == IQ_CLIENT_FRAME) {
+            atomic_fetch_add(&c->pairs, frame.num_samples);
+        }
+        if (!marked && atomic_load(&c->marking)) {
+            c->cpu_mark = thread_cpu_sec();
+            marked = true;
+        }
+    }
+    c->cpu = marked ? thread_cpu_sec() - c->cpu_mark : 0.0;
+
+    iq_client_stats_t st;
+    iq_client_get_stats(ic, &st);
+    c->frames_lost = st.frames_lost;
+    iq_client_destroy(ic);
+    return NULL;
+}
+
+/*============================================================================
+ * One Run
+ *============================================================================*/
+
+typedef struct {
+    double msps;
+    double cpu;
+    double cpu_per_msps;
+    uint64_t client_pairs[2];
+    uint64_t lost;                  /* Client frames lost + relay ring overflows */
+} run_result_t;
+
+static bool run_once(const pipeline_desc_t *desc, bool paced, double seconds, run_result_t *r) {
+    pipeline_options_t opt;
+    pipeline_options_defaults(&opt);
+    opt.paced = paced;
+
+    char text[512];
+    pipeline_format(desc, text, sizeof(text));
+    printf("\n%s\n", text);
+
+    pipeline_t *p = pipeline_create(desc, &opt);
+    if (!p) return false;
+
+    pipeline_stats_t st;
+    pipeline_get_stats(p, &st);
+    client_t clients[2];
+    memset(clients, 0, sizeof(clients));
+    clients[0].port = st.det_port;
+    clients[1].port = st.disp_port;
+    for (int k = 0; k < 2; k++) pthread_create(&clients[k].thread, NULL, client_thread, &clients[k]);
+
+    /* Clients attached before the first sample, as in the test */
+    sdr_manager_t *mgr = pipeline_manager(p);
+    tcp_response_t resp;
+    sleep_ms(WARMUP_MS);
+    if (mgr) sdr_manager_execute(mgr, "START", &resp);
+    sleep_ms(WARMUP_MS);
+
+    pipeline_get_stats(p, &st);
+    uint64_t in0 = st.samples_in;
+    for (int k = 0; k < 2; k++) atomic_store(&clients[k].marking, true);
+    double t0 = now_sec();
+    double cpu0 = process_cpu_sec();
+
+    while (now_sec() - t0 < seconds) sleep_ms(100);
+
+    double cpu = process_cpu_sec() - cpu0;
+    double wall = now_sec() - t0;
+    pipeline_get_stats(p, &st);
+    uint64_t in = st.samples_in - in0;
+
+    if (mgr) sdr_manager_execute(mgr, "STOP", &resp);
+    for (int k = 0; k < 2; k++) {
+        atomic_store(&clients[k].stop, true);
+        pthread_join(clients[k].thread, NULL);
+        cpu -= clients[k].cpu;
+        r->client_pairs[k] = atomic_load(&clients[k].pairs);
+    }
+    r->lost = clients[0].frames_lost + clients[1].frames_lost + st.det.overflows + st.disp.overflows;
+    pipeline_destroy(p);
+
+    r->msps = (double)in / wall / 1e6;
+    r->cpu = cpu;
+    r->cpu_per_msps = r->msps > 0 ? cpu / wall / r->msps : 0.0;
+    printf("  %8.2f MSPS  %6.2f s CPU in %.2f s  %.3f cores/MSPS  (clients %llu + %llu pairs, %llu lost)\n",
+           r->msps, r->cpu, wall, r->cpu_per_msps,
+           (unsigned long long)r->client_pairs[0], (unsigned long long)r->client_pairs[1],
+           (unsigned long long)r->lost);
+    return true;
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+/* Every link as given; a phxi source keeps its network link, a blanker its queue */
+static void set_links(pipeline_desc_t *desc, pipeline_link_t link) {
+    for (int k = 0; k + 1 < desc->n_stages; k++) {
+        bool network = k == 0 && desc->stages[0].type == PIPE_STAGE_PHXI;
+        bool fused = desc->stages[k].type == PIPE_STAGE_BLANK;
+        desc->links[k] = network ? PIPE_LINK_TCP : fused ? PIPE_LINK_QUEUE : link;
+    }
+}
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  -d DESC    Pipeline description; its links are replaced (default: \"%s\")\n", DEFAULT_DESCRIPTION);
+    printf("  -t SEC     Seconds measured per run (default: %.0f)\n", DEFAULT_SECONDS);
+    printf("  -r         Real time: pace the source (default: as fast as the chain runs)\n");
+    printf("  -h         Show this help\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *text = DEFAULT_DESCRIPTION;
+    double seconds = DEFAULT_SECONDS;
+    bool paced = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            text = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0) {
+            paced = true;
+        } else {
+            print_usage(argv[0]);
+            return strcmp(argv[i], "-h") == 0 ? 0 : 1;
+        }
+    }
+
+    pipeline_desc_t desc;
+    char err[128];
+    if (!pipeline_parse(text, &desc, err, sizeof(err))) {
+        fprintf(stderr, "Bad description: %s\n", err);
+        return 1;
+    }
+    if (seconds <= 0) seconds = DEFAULT_SECONDS;
+
+    print_version("pipeline_bench");
+    printf("%s, %.0f s per run\n", paced ? "Real time" : "Unpaced", seconds);
+
+    run_result_t tcp, queue;
+    set_links(&desc, PIPE_LINK_TCP);
+    if (!run_once(&desc, paced, seconds, &tcp)) return 1;
+    set_links(&desc, PIPE_LINK_QUEUE);
+    if (!run_once(&desc, paced, seconds, &queue)) return 1;
+
+    printf("\nChained TCP %.3f cores/MSPS, in process %.3f cores/MSPS", tcp.cpu_per_msps, queue.cpu_per_msps);
+    if (queue.cpu_per_msps > 0) printf(" (%.2fx)", tcp.cpu_per_msps / queue.cpu_per_msps);
+    printf("\n");
+    return 0;
+}
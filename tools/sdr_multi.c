@@ -0,0 +1,253 @@
+/**
+ * @file sdr_multi.c
+ * @brief Several receivers behind one control port
+ *
+ * Opens N devices in one process (sdr_manager): RSPs, synthetic tones or
+ * .iqr replays. One control port takes the sdr_server command set with a
+ * device prefix (DEV <n> ...); each device has its own raw I/Q port, its
+ * own 48 kHz decimated port and its own streaming thread.
+ *
+ *   Device k:  raw S16 on iq_port + k, 48 kHz F32 on decim_port + k,
+ *              thread pinned to core + k (with -c)
+ *
+ * Unprefixed commands go to device 0, so a single-receiver client pointed
+ * at the control port and iq_port works unchanged.
+ *
+ * Usage:
+ *   sdr_multi -a                               # Every RSP found
+ *   sdr_multi -d 0 -d 1 -c 2                   # Two RSPs, threads on cores 2 and 3
+ *   sdr_multi -t 1000 -t -2500 -r wwv.iqr      # Two tones and a replay, no hardware
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <signal.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+typedef SOCKET socket_t;
+#define SOCKET_INVALID INVALID_SOCKET
+#define socket_close closesocket
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <pthread.h>
+typedef int socket_t;
+#define SOCKET_INVALID (-1)
+#define socket_close close
+#endif
+
+#include "sdr_manager.h"
+#include "version.h"
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define DEFAULT_IQ_PORT     4536
+#define DEFAULT_DECIM_PORT  4546
+#define ACCEPT_POLL_MS      200
+
+static volatile bool g_running = true;
+
+static void signal_handler(int sig) {
+    (void)sig;
+    printf("\nShutting down...\n");
+    g_running = false;
+}
+
+/*============================================================================
+ * Control Client
+ *============================================================================*/
+
+static bool wait_readable(socket_t sock, int timeout_ms) {
+    fd_set read_fds;
+    struct timeval tv;
+    FD_ZERO(&read_fds);
+    FD_SET(sock, &read_fds);
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    return select((int)(sock + 1), &read_fds, NULL, NULL, &tv) > 0;
+}
+
+static int recv_line(socket_t sock, char *buf, int buf_size) {
+    int total = 0;
+    while (total < buf_size - 1) {
+        char c;
+        if (recv(sock, &c, 1, 0) <= 0) return -1;
+        if (c == '\n') break;
+        if (c != '\r') buf[total++] = c;
+    }
+    buf[total] = '\0';
+    return total;
+}
+
+static void handle_client(socket_t client, sdr_manager_t *mgr) {
+    char line[TCP_MAX_LINE_LENGTH];
+    char reply[TCP_MAX_LINE_LENGTH + 16];
+    tcp_response_t resp;
+
+    printf("Client connected\n");
+    while (g_running) {
+        if (!wait_readable(client, ACCEPT_POLL_MS)) continue;
+
+        int len = recv_line(client, line, sizeof(line));
+        if (len < 0) {
+            printf("Client disconnected\n");
+            break;
+        }
+        if (len == 0) continue;
+
+        printf("< %s\n", line);
+        tcp_cmd_type_t type = sdr_manager_execute(mgr, line, &resp);
+        int n = tcp_format_response(&resp, reply, sizeof(reply));
+        printf("> %s", reply);
+        if (send(client, reply, n, 0) != n) break;
+        if (type == CMD_QUIT) break;
+    }
+
+    /* As sdr_server: streaming ends with the control session */
+    sdr_manager_stop_all(mgr);
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("Devices (in order, numbered from 0):\n");
+    printf("  -a          Every available RSP\n");
+    printf("  -d <idx>    RSP by enumeration index\n");
+    printf("  -t <hz>     Synthetic tone at <hz> from center, 2 MSPS\n");
+    printf("  -r <file>   Replay an .iqr file, looped, in real time\n");
+    printf("Options:\n");
+    printf("  -p <port>   Control port (default %d)\n", TCP_DEFAULT_PORT);
+    printf("  -i <port>   Raw I/Q port of device 0, +1 per device (default %d)\n", DEFAULT_IQ_PORT);
+    printf("  -m <port>   48 kHz port of device 0, +1 per device (default %d)\n", DEFAULT_DECIM_PORT);
+    printf("  -c <core>   Pin device 0's thread to <core>, +1 per device\n");
+    printf("  -h          Show this help\n");
+}
+
+int main(int argc, char *argv[]) {
+    int control_port = TCP_DEFAULT_PORT;
+    int iq_port = DEFAULT_IQ_PORT;
+    int decim_port = DEFAULT_DECIM_PORT;
+    int core = -1;
+
+    /* Ports and cores first: devices are opened in argument order below */
+    for (int i = 1; i < argc; i++) {
+        bool has_arg = i + 1 < argc;
+        if (strcmp(argv[i], "-p") == 0 && has_arg) {
+            control_port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-i") == 0 && has_arg) {
+            iq_port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-m") == 0 && has_arg) {
+            decim_port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0 && has_arg) {
+            core = atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "-t") == 0 ||
+                    strcmp(argv[i], "-r") == 0) && has_arg) {
+            i++;
+        } else if (strcmp(argv[i], "-a") != 0) {
+            print_usage(argv[0]);
+            return strcmp(argv[i], "-h") == 0 ? 0 : 1;
+        }
+    }
+
+    print_version("sdr_multi");
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+#ifndef _WIN32
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    sdr_manager_t *mgr = sdr_manager_create();
+    if (!mgr) {
+        fprintf(stderr, "Setup failed\n");
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        sdr_device_spec_t spec;
+        int k = sdr_manager_count(mgr);
+        const char *opt = argv[i];
+
+        if (strcmp(opt, "-a") == 0) {
+            sdr_manager_spec_defaults(&spec, SDR_BACKEND_HARDWARE);
+            spec.iq_port = iq_port + k;
+            spec.decim_port = decim_port + k;
+            spec.core = core >= 0 ? core + k : -1;
+            sdr_manager_add_hardware(mgr, &spec);
+            continue;
+        }
+        if (strcmp(opt, "-d") != 0 && strcmp(opt, "-t") != 0 && strcmp(opt, "-r") != 0) {
+            if (strcmp(opt, "-p") == 0 || strcmp(opt, "-i") == 0 ||
+                strcmp(opt, "-m") == 0 || strcmp(opt, "-c") == 0) i++;
+            continue;
+        }
+
+        const char *arg = argv[++i];
+        if (opt[1] == 'd') {
+            sdr_manager_spec_defaults(&spec, SDR_BACKEND_HARDWARE);
+            spec.device_idx = (unsigned int)atoi(arg);
+        } else if (opt[1] == 't') {
+            sdr_manager_spec_defaults(&spec, SDR_BACKEND_TONE);
+            spec.tone_hz = atof(arg);
+        } else {
+            sdr_manager_spec_defaults(&spec, SDR_BACKEND_REPLAY);
+            snprintf(spec.replay_path, sizeof(spec.replay_path), "%s", arg);
+        }
+        spec.iq_port = iq_port + k;
+        spec.decim_port = decim_port + k;
+        spec.core = core >= 0 ? core + k : -1;
+        if (sdr_manager_add(mgr, &spec) < 0) {
+            fprintf(stderr, "Skipping %s %s\n", opt, arg);
+        }
+    }
+
+    if (sdr_manager_count(mgr) == 0) {
+        fprintf(stderr, "No devices opened\n");
+        print_usage(argv[0]);
+        sdr_manager_destroy(mgr);
+        return 1;
+    }
+
+    socket_t listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    struct sockaddr_in addr;
+    int reuse = 1;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)control_port);
+    if (listener == SOCKET_INVALID ||
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse)) != 0 ||
+        bind(listener, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 1) != 0) {
+        fprintf(stderr, "Cannot listen on control port %d\n", control_port);
+        if (listener != SOCKET_INVALID) socket_close(listener);
+        sdr_manager_destroy(mgr);
+        return 1;
+    }
+
+    printf("%d device(s), control port %d (DEV <n> <command>)\n", sdr_manager_count(mgr), control_port);
+
+    while (g_running) {
+        if (!wait_readable(listener, ACCEPT_POLL_MS)) continue;
+        socket_t client = accept(listener, NULL, NULL);
+        if (client == SOCKET_INVALID) continue;
+        handle_client(client, mgr);
+        socket_close(client);
+    }
+
+    socket_close(listener);
+    sdr_manager_destroy(mgr);
+    printf("Server stopped\n");
+    return 0;
+}
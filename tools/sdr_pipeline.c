@@ -0,0 +1,274 @@
+/**
+ * @file sdr_pipeline.c
+ * @brief sdr_server, signal_splitter and signal_relay as one process
+ *
+ * Runs a pipeline description (pipeline.h): a source, the splitter's
+ * divergence and the relay's fan-out, each on its own thread, linked by
+ * in-memory queues ('>') or by loopback TCP in the processes' own wire
+ * protocols ('|'). The network stays at the edges:
+ *
+ *   Control port   sdr_server commands for the source (single client)
+ *   Relay ports    Detector (4410) and display (4411) streams, as signal_relay
+ *   -i <port>      Optional raw S16 PHXI port on the source, as sdr_server
+ *
+ * As sdr_server, streaming starts with START and stops when the control
+ * client goes away; -s starts it at once and keeps it going.
+ *
+ * Usage:
+ *   sdr_pipeline "rsp > split > relay"                 # One RSP, in process
+ *   sdr_pipeline -s "tone:1000 > split > relay:0:0"   # Tone, any free relay ports
+ *   sdr_pipeline "replay:wwv.iqr | split | relay"      # Same stages over loopback TCP
+ *   sdr_pipeline "phxi:rx1:4536 | split > relay"       # Split and relay a remote server
+ *   sdr_pipeline "rsp > blank > split > relay"         # Impulses blanked at 2 MHz
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+typedef SOCKET socket_t;
+#define SOCKET_INVALID INVALID_SOCKET
+#define socket_close closesocket
+#define sleep_ms(ms) Sleep(ms)
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int socket_t;
+#define SOCKET_INVALID (-1)
+#define socket_close close
+#define sleep_ms(ms) usleep((ms) * 1000)
+#endif
+
+#include "pipeline.h"
+#include "version.h"
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define ACCEPT_POLL_MS      200
+#define STATUS_INTERVAL_S   5
+
+static volatile bool g_running = true;
+static time_t g_last_status = 0;
+
+static void signal_handler(int sig) {
+    (void)sig;
+    printf("\nShutting down...\n");
+    g_running = false;
+}
+
+/*============================================================================
+ * Status
+ *============================================================================*/
+
+static void print_status(pipeline_t *p) {
+    time_t now = time(NULL);
+    if (now - g_last_status < STATUS_INTERVAL_S) return;
+    g_last_status = now;
+
+    pipeline_stats_t st;
+    pipeline_get_stats(p, &st);
+    printf("[STATUS] In=%llu DET=%llu DISP=%llu  clients DET=%d DISP=%d  overflows DET=%llu DISP=%llu%s\n",
+           (unsigned long long)st.samples_in,
+           (unsigned long long)st.det_samples, (unsigned long long)st.disp_samples,
+           st.det.clients, st.disp.clients,
+           (unsigned long long)st.det.overflows, (unsigned long long)st.disp.overflows,
+           st.linked ? "" : "  (source link down)");
+    if (st.blanking) {
+        printf("[STATUS] Blanker: %llu pairs blanked (%.3f%%) in %llu impulses\n",
+               (unsigned long long)st.blanked,
+               st.samples_in > 0 ? 100.0 * (double)st.blanked / (double)st.samples_in : 0.0,
+               (unsigned long long)st.impulses);
+    }
+    if (st.source_queue.capacity > 0 || st.split_queue.capacity > 0) {
+        printf("[STATUS] Queues: source %u/%u (high %u, full waits %llu)  split %u/%u (high %u, full waits %llu)\n",
+               st.source_queue.depth, st.source_queue.capacity, st.source_queue.high_water,
+               (unsigned long long)st.source_queue.full_waits,
+               st.split_queue.depth, st.split_queue.capacity, st.split_queue.high_water,
+               (unsigned long long)st.split_queue.full_waits);
+    }
+}
+
+/*============================================================================
+ * Control Client
+ *============================================================================*/
+
+static bool wait_readable(socket_t sock, int timeout_ms) {
+    fd_set read_fds;
+    struct timeval tv;
+    FD_ZERO(&read_fds);
+    FD_SET(sock, &read_fds);
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    return select((int)(sock + 1), &read_fds, NULL, NULL, &tv) > 0;
+}
+
+static int recv_line(socket_t sock, char *buf, int buf_size) {
+    int total = 0;
+    while (total < buf_size - 1) {
+        char c;
+        if (recv(sock, &c, 1, 0) <= 0) return -1;
+        if (c == '\n') break;
+        if (c != '\r') buf[total++] = c;
+    }
+    buf[total] = '\0';
+    return total;
+}
+
+static void handle_client(socket_t client, pipeline_t *p, bool autostart) {
+    sdr_manager_t *mgr = pipeline_manager(p);
+    char line[TCP_MAX_LINE_LENGTH];
+    char reply[TCP_MAX_LINE_LENGTH + 16];
+    tcp_response_t resp;
+
+    printf("Client connected\n");
+    while (g_running) {
+        print_status(p);
+        if (!wait_readable(client, ACCEPT_POLL_MS)) continue;
+
+        int len = recv_line(client, line, sizeof(line));
+        if (len < 0) {
+            printf("Client disconnected\n");
+            break;
+        }
+        if (len == 0) continue;
+
+        printf("< %s\n", line);
+        tcp_cmd_type_t type = sdr_manager_execute(mgr, line, &resp);
+        int n = tcp_format_response(&resp, reply, sizeof(reply));
+        printf("> %s", reply);
+        if (send(client, reply, n, 0) != n) break;
+        if (type == CMD_QUIT) break;
+    }
+
+    /* As sdr_server: streaming ends with the control session */
+    if (!autostart) sdr_manager_stop_all(mgr);
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [options] \"<description>\"\n", prog);
+    printf("Description: SOURCE LINK [blank[:K] >] split LINK relay[:DET_PORT[:DISP_PORT]]\n");
+    printf("  LINK      '>' in-memory queue, '|' loopback TCP\n");
+    printf("  SOURCE    tone[:HZ] | replay:PATH | rsp[:IDX] | phxi:HOST:PORT\n");
+    printf("  blank     Impulse blanker at K x average |x| (default %g)\n", NB_DEFAULT_THRESHOLD);
+    printf("Options:\n");
+    printf("  -p <port>   Control port (default %d)\n", TCP_DEFAULT_PORT);
+    printf("  -i <port>   Raw I/Q port on the source (default none; 0 = any)\n");
+    printf("  -c <core>   Pin the source thread to <core>\n");
+    printf("  -q <n>      Queue depth in blocks (default %d)\n", PIPELINE_QUEUE_BLOCKS);
+    printf("  -s          Start streaming now, and keep streaming without a client\n");
+    printf("  -h          Show this help\n");
+}
+
+int main(int argc, char *argv[]) {
+    int control_port = TCP_DEFAULT_PORT;
+    bool autostart = false;
+    const char *text = NULL;
+    pipeline_options_t opt;
+    pipeline_options_defaults(&opt);
+
+    for (int i = 1; i < argc; i++) {
+        bool has_arg = i + 1 < argc;
+        if (strcmp(argv[i], "-p") == 0 && has_arg) {
+            control_port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-i") == 0 && has_arg) {
+            opt.iq_port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0 && has_arg) {
+            opt.core = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-q") == 0 && has_arg) {
+            opt.queue_blocks = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0) {
+            autostart = true;
+        } else if (argv[i][0] != '-' && !text) {
+            text = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return strcmp(argv[i], "-h") == 0 ? 0 : 1;
+        }
+    }
+    if (!text) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    pipeline_desc_t desc;
+    char err[128];
+    if (!pipeline_parse(text, &desc, err, sizeof(err))) {
+        fprintf(stderr, "Bad description: %s\n", err);
+        return 1;
+    }
+
+    print_version("sdr_pipeline");
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+#ifndef _WIN32
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    pipeline_t *p = pipeline_create(&desc, &opt);
+    if (!p) {
+        fprintf(stderr, "Setup failed\n");
+        return 1;
+    }
+
+    /* A phxi source is controlled where it runs */
+    sdr_manager_t *mgr = pipeline_manager(p);
+    socket_t listener = SOCKET_INVALID;
+    if (mgr) {
+        struct sockaddr_in addr;
+        int reuse = 1;
+        listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons((uint16_t)control_port);
+        if (listener == SOCKET_INVALID ||
+            setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse)) != 0 ||
+            bind(listener, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 1) != 0) {
+            fprintf(stderr, "Cannot listen on control port %d\n", control_port);
+            if (listener != SOCKET_INVALID) socket_close(listener);
+            pipeline_destroy(p);
+            return 1;
+        }
+        printf("Control port %d\n", control_port);
+
+        if (autostart) {
+            tcp_response_t resp;
+            sdr_manager_execute(mgr, "START", &resp);
+        }
+    }
+
+    g_last_status = time(NULL);
+    while (g_running) {
+        print_status(p);
+        if (listener == SOCKET_INVALID) {
+            sleep_ms(ACCEPT_POLL_MS);
+            continue;
+        }
+        if (!wait_readable(listener, ACCEPT_POLL_MS)) continue;
+        socket_t client = accept(listener, NULL, NULL);
+        if (client == SOCKET_INVALID) continue;
+        handle_client(client, p, autostart);
+        socket_close(client);
+    }
+
+    if (listener != SOCKET_INVALID) socket_close(listener);
+    pipeline_destroy(p);
+    printf("Pipeline stopped\n");
+    return 0;
+}
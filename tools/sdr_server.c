@@ -5,8 +5,9 @@
  * TCP server for remote control of SDRplay RSP2 Pro.
  * Implements protocol defined in docs/SDR_TCP_CONTROL_INTERFACE.md
  * I/Q streaming on separate port per docs/SDR_IQ_STREAMING_INTERFACE.md
+ * Optional rtl_tcp-compatible port for stock SDR clients (-r)
  *
- * Usage: sdr_server.exe [-p port] [-i iq_port] [-T addr]
+ * Usage: sdr_server.exe [-p port] [-i iq_port] [-L latency_ms] [-r rtl_port] [-T addr]
  */
 
 #include <stdio.h>
@@ -19,25 +20,37 @@
 #ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
+#include <mstcpip.h>
 #include <windows.h>
 #include <shellapi.h>
 #include <process.h>
 #pragma comment(lib, "ws2_32.lib")
 #pragma comment(lib, "shell32.lib")
 typedef int socklen_t;
+#define socket_would_block() (WSAGetLastError() == WSAEWOULDBLOCK)
 #else
 #include <sys/socket.h>
+#include <sys/select.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <time.h>
+#include <fcntl.h>
+#include <errno.h>
 #define SOCKET int
 #define INVALID_SOCKET (-1)
 #define SOCKET_ERROR (-1)
 #define closesocket close
+#define socket_would_block() (errno == EAGAIN || errno == EWOULDBLOCK)
 #endif
 
 #include "tcp_server.h"
+#include "rtl_tcp.h"
+#include "notify_queue.h"
+#include "iq_events.h"
+#include "iq_framer.h"
 #include "phoenix_sdr.h"
 #include "version.h"
 #include <stdarg.h>
@@ -48,7 +61,9 @@ typedef int socklen_t;
 
 #define IQ_DEFAULT_PORT 4536
 #define IQ_RING_BUFFER_SIZE (4 * 1024 * 1024)  /* 4 MB ring buffer */
-#define IQ_FRAME_SAMPLES 8192                   /* Samples per frame */
+#define IQ_FRAME_SAMPLES IQ_FRAMER_MAX_SAMPLES  /* Largest frame; iq_framer picks the size */
+#define IQ_MARKER_QUEUE_SIZE 256                /* Pending in-band event markers */
+#define IQ_TONE_MAX_BLOCK 10000                 /* Test tone: 1 ms at 10 MSPS */
 
 /* Magic numbers */
 #define IQ_MAGIC_HEADER 0x50485849  /* "PHXI" */
@@ -123,9 +138,50 @@ static volatile uint32_t g_iq_frames_dropped = 0;
 static volatile uint32_t g_iq_current_flags = 0;
 static volatile bool g_iq_config_changed = false;
 
-/* Rate limiting for notifications */
-static DWORD g_last_overload_notify_time = 0;
-#define OVERLOAD_NOTIFY_COOLDOWN_MS 500  /* Min time between overload notifications */
+/* Adaptive framing (-L): frame size, coalescing and socket sizing; the last
+ * statistics window is copied out for GET_IQSTATS under g_iq_mutex */
+static uint32_t g_iq_latency_ms = IQ_FRAMER_DEFAULT_LATENCY_MS;
+static iq_framer_t *g_iq_framer = NULL;
+static iq_framer_stats_t g_iq_stats;
+static volatile uint32_t g_iq_rtt_us = 0;
+static volatile uint32_t g_iq_sndbuf = 0;
+
+/* In-band event markers (-E): positions count samples written to the ring
+ * since startup; g_iq_read_abs is the position of g_iq_read_pos */
+static bool g_iq_events_enabled = false;
+static iq_marker_queue_t *g_iq_markers = NULL;
+static volatile uint64_t g_iq_write_abs = 0;
+static volatile uint64_t g_iq_read_abs = 0;
+static volatile int32_t g_hw_gain_cdb = 0;     /* Latest hardware gain report, 0.01 dB */
+static volatile int32_t g_hw_lna_gr_db = 0;
+
+/* rtl_tcp compatibility globals (listener only created with -r) */
+#define RTL_RING_BUFFER_SIZE (2 * 1024 * 1024)  /* 2 MB of U8 interleaved I/Q */
+#define RTL_SEND_CHUNK       (16 * 1024)        /* Max bytes per send call */
+#define RTL_MAX_LAG          (RTL_RING_BUFFER_SIZE / 2)  /* Further behind: skip ahead */
+#define RTL_TONE_SAMPLES     8192               /* Test tone block when no hardware */
+
+/* Each client keeps its own position in the ring and is sent to without
+ * blocking, so a slow client never holds up the others or the writer */
+typedef struct {
+    SOCKET   sock;
+    uint8_t  cmd_buf[RTL_TCP_CMD_SIZE];         /* Partial command packet */
+    int      cmd_len;
+    uint64_t read_abs;                          /* Next ring byte to send (bytes since startup) */
+    uint32_t skips;                             /* Times skipped ahead for lagging */
+} rtl_client_t;
+
+static SOCKET g_rtl_listen_socket = INVALID_SOCKET;
+static rtl_client_t g_rtl_clients[RTL_TCP_MAX_CLIENTS];
+static volatile int g_rtl_client_count = 0;
+static bool g_rtl_started_streaming = false;    /* We issued START for rtl_tcp clients */
+static uint8_t *g_rtl_ring_buffer = NULL;
+static volatile uint64_t g_rtl_write_abs = 0;   /* Bytes written to the ring since startup */
+static volatile uint32_t g_rtl_overruns = 0;    /* Lagging-client skips, all clients */
+
+/* SDR event notifications - posted by driver callbacks, sent by the control thread */
+static notify_queue_t *g_notify = NULL;
+#define NOTIFY_POLL_MS 50               /* Control thread wakes this often to send them */
 
 /* SDR recovery tracking */
 static DWORD g_last_stop_time = 0;
@@ -133,6 +189,7 @@ static DWORD g_last_stop_time = 0;
 
 #ifdef _WIN32
 static CRITICAL_SECTION g_iq_mutex;
+static CRITICAL_SECTION g_cmd_mutex;    /* Serializes control and rtl_tcp commands */
 
 /* System tray globals */
 #define WM_TRAYICON (WM_USER + 1)
@@ -142,6 +199,7 @@ static NOTIFYICONDATAA g_nid;
 static bool g_tray_active = false;
 #else
 static pthread_mutex_t g_iq_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t g_cmd_mutex = PTHREAD_MUTEX_INITIALIZER;
 #endif
 
 /*============================================================================
@@ -239,6 +297,38 @@ int tcp_send_notification(tcp_sdr_state_t *state, const char *format, ...) {
  * I/Q Ring Buffer Functions
  *============================================================================*/
 
+/* Monotonic microseconds, for frame latency and test tone pacing */
+static uint64_t iq_now_us(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (uint64_t)(count.QuadPart / freq.QuadPart) * 1000000 +
+           (uint64_t)(count.QuadPart % freq.QuadPart) * 1000000 / (uint64_t)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)(ts.tv_nsec / 1000);
+#endif
+}
+
+static void iq_lock(void) {
+#ifdef _WIN32
+    EnterCriticalSection(&g_iq_mutex);
+#else
+    pthread_mutex_lock(&g_iq_mutex);
+#endif
+}
+
+static void iq_unlock(void) {
+#ifdef _WIN32
+    LeaveCriticalSection(&g_iq_mutex);
+#else
+    pthread_mutex_unlock(&g_iq_mutex);
+#endif
+}
+
 static bool iq_buffer_init(void) {
     g_iq_ring_buffer = (int16_t*)malloc(IQ_RING_BUFFER_SIZE);
     if (!g_iq_ring_buffer) {
@@ -250,10 +340,32 @@ static bool iq_buffer_init(void) {
     g_iq_sequence = 0;
     g_iq_frames_sent = 0;
     g_iq_frames_dropped = 0;
+    g_iq_write_abs = 0;
+    g_iq_read_abs = 0;
+    iq_now_us();    /* Latch the counter frequency before the callback thread uses it */
+    g_iq_framer = iq_framer_create(g_iq_latency_ms);
+    if (!g_iq_framer) {
+        free(g_iq_ring_buffer);
+        g_iq_ring_buffer = NULL;
+        fprintf(stderr, "Failed to allocate I/Q framer\n");
+        return false;
+    }
+    if (g_iq_events_enabled) {
+        g_iq_markers = iq_marker_queue_create(IQ_MARKER_QUEUE_SIZE);
+        if (!g_iq_markers) {
+            free(g_iq_ring_buffer);
+            g_iq_ring_buffer = NULL;
+            iq_framer_destroy(g_iq_framer);
+            g_iq_framer = NULL;
+            fprintf(stderr, "Failed to allocate I/Q event marker queue\n");
+            return false;
+        }
+    }
 #ifdef _WIN32
     InitializeCriticalSection(&g_iq_mutex);
 #endif
-    printf("I/Q ring buffer: %d KB allocated\n", IQ_RING_BUFFER_SIZE / 1024);
+    printf("I/Q ring buffer: %d KB allocated%s, latency budget %u ms\n", IQ_RING_BUFFER_SIZE / 1024,
+           g_iq_events_enabled ? ", event markers on" : "", g_iq_latency_ms);
     return true;
 }
 
@@ -262,6 +374,10 @@ static void iq_buffer_cleanup(void) {
         free(g_iq_ring_buffer);
         g_iq_ring_buffer = NULL;
     }
+    iq_marker_queue_destroy(g_iq_markers);
+    g_iq_markers = NULL;
+    iq_framer_destroy(g_iq_framer);
+    g_iq_framer = NULL;
 #ifdef _WIN32
     DeleteCriticalSection(&g_iq_mutex);
 #endif
@@ -302,7 +418,10 @@ static void iq_buffer_write(const int16_t *xi, const int16_t *xq, uint32_t count
         /* Buffer overflow - drop oldest data */
         size_t drop = count - space;
         g_iq_read_pos = (g_iq_read_pos + drop) % max_samples;
+        g_iq_read_abs += drop;
         g_iq_frames_dropped++;
+        iq_marker_queue_post(g_iq_markers, g_iq_read_abs, IQ_EVENT_DISCONTINUITY,
+                             0, (int32_t)drop);
     }
 
     /* Write interleaved I/Q data */
@@ -312,12 +431,17 @@ static void iq_buffer_write(const int16_t *xi, const int16_t *xq, uint32_t count
         g_iq_ring_buffer[pos + 1] = xq[i];
         g_iq_write_pos = (g_iq_write_pos + 1) % max_samples;
     }
+    g_iq_write_abs += count;
+    iq_framer_arrived(g_iq_framer, g_iq_write_abs, iq_now_us());
 }
 
-/* Read interleaved I/Q samples from ring buffer (called from I/Q thread) */
-static size_t iq_buffer_read(int16_t *buffer, size_t max_samples) {
+/* Read interleaved I/Q samples from ring buffer (called from I/Q thread).
+ * first_sample receives the stream position of buffer[0]. */
+static size_t iq_buffer_read(int16_t *buffer, size_t max_samples, uint64_t *first_sample) {
     if (!g_iq_ring_buffer) return 0;
 
+    *first_sample = g_iq_read_abs;
+
     size_t available = iq_buffer_available();
     size_t to_read = (available < max_samples) ? available : max_samples;
 
@@ -329,19 +453,20 @@ static size_t iq_buffer_read(int16_t *buffer, size_t max_samples) {
         buffer[i * 2 + 1] = g_iq_ring_buffer[pos + 1];
         g_iq_read_pos = (g_iq_read_pos + 1) % buffer_max;
     }
+    g_iq_read_abs += to_read;
 
     return to_read;
 }
 
 /*============================================================================
- * I/Q Streaming Thread
+ * I/Q Stream Output
  *============================================================================*/
 
 static void send_iq_header(SOCKET sock) {
     iq_stream_header_t header;
     memset(&header, 0, sizeof(header));
     header.magic = IQ_MAGIC_HEADER;
-    header.version = 1;
+    header.version = g_iq_events_enabled ? IQ_STREAM_VERSION_EVENTS : 1;
     header.sample_rate = (uint32_t)g_sdr_state.sample_rate;
     header.sample_format = IQ_FORMAT_S16;
 
@@ -356,7 +481,8 @@ static void send_iq_header(SOCKET sock) {
            header.sample_rate, header.gain_reduction, header.lna_state);
 }
 
-static void send_iq_metadata(SOCKET sock) {
+/* META goes into the batch, so it stays in order with the frames around it */
+static size_t build_iq_metadata(uint8_t *dst) {
     iq_metadata_update_t meta;
     memset(&meta, 0, sizeof(meta));
     meta.magic = IQ_MAGIC_META;
@@ -369,9 +495,173 @@ static void send_iq_metadata(SOCKET sock) {
     meta.gain_reduction = (uint32_t)g_sdr_state.gain_reduction;
     meta.lna_state = (uint32_t)g_sdr_state.lna_state;
 
-    send(sock, (const char*)&meta, sizeof(meta), 0);
+    memcpy(dst, &meta, sizeof(meta));
+    return sizeof(meta);
+}
+
+static void set_nonblocking(SOCKET sock) {
+#ifdef _WIN32
+    u_long mode = 1;
+    ioctlsocket(sock, FIONBIO, &mode);
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+#endif
+}
+
+static int send_all(SOCKET sock, const uint8_t *data, size_t len) {
+    while (len > 0) {
+        int sent = send(sock, (const char*)data, (int)len, 0);
+        if (sent <= 0) {
+            return -1;
+        }
+        data += sent;
+        len -= (size_t)sent;
+    }
+    return 0;
+}
+
+/* No hardware: 1 kHz test tone at about half scale, written to the ring in
+ * 1 ms blocks the way SDR callbacks would */
+static void iq_generate_test_tone(uint64_t now_us) {
+    static int16_t xi[IQ_TONE_MAX_BLOCK];
+    static int16_t xq[IQ_TONE_MAX_BLOCK];
+    static double phase = 0.0;
+    static uint64_t next_us = 0;
+
+    double sample_rate = (double)g_sdr_state.sample_rate;
+    double phase_inc = 2.0 * 3.14159265358979 * 1000.0 / sample_rate;
+    uint32_t block = (uint32_t)(sample_rate / 1000.0);
+    if (block > IQ_TONE_MAX_BLOCK) block = IQ_TONE_MAX_BLOCK;
+
+    /* First call, or resumed after a pause: start from now */
+    if (next_us == 0 || now_us > next_us + 100000) next_us = now_us;
+
+    while (now_us >= next_us) {
+        for (uint32_t i = 0; i < block; i++) {
+            double val = sin(phase) * 16000.0;
+            xi[i] = (int16_t)val;
+            xq[i] = (int16_t)(val * 0.5);   /* Phase shift for complex signal */
+            phase += phase_inc;
+            if (phase > 2.0 * 3.14159265358979) phase -= 2.0 * 3.14159265358979;
+        }
+        iq_buffer_write(xi, xq, block);
+        next_us += 1000;
+    }
 }
 
+/*============================================================================
+ * I/Q Socket Tuning
+ *============================================================================*/
+
+/* Smoothed RTT from the TCP stack, 0 where the platform does not report it */
+static uint32_t iq_socket_rtt_us(SOCKET sock) {
+#if defined(_WIN32) && defined(SIO_TCP_INFO)
+    DWORD version = 0;
+    DWORD bytes = 0;
+    TCP_INFO_v0 info;
+    if (WSAIoctl(sock, SIO_TCP_INFO, &version, sizeof(version), &info, sizeof(info),
+                 &bytes, NULL, NULL) == 0) {
+        return (uint32_t)info.RttUs;
+    }
+#elif defined(__linux__) && defined(TCP_INFO)
+    struct tcp_info info;
+    socklen_t len = sizeof(info);
+    if (getsockopt(sock, IPPROTO_TCP, TCP_INFO, &info, &len) == 0) {
+        return info.tcpi_rtt;
+    }
+#else
+    (void)sock;
+#endif
+    return 0;
+}
+
+/* True when a send() would not block - with TCP_NOTSENT_LOWAT, when less
+ * than two frames are waiting to go out */
+static bool iq_socket_writable(SOCKET sock) {
+    fd_set write_fds;
+    struct timeval tv = { 0, 0 };
+    FD_ZERO(&write_fds);
+    FD_SET(sock, &write_fds);
+    return select((int)(sock + 1), NULL, &write_fds, NULL, &tv) > 0;
+}
+
+/* Hold partial segments back while frames are coalesced: TCP_CORK where the
+ * stack has it, Nagle otherwise. Uncorking sends what is held. */
+static void iq_socket_cork(SOCKET sock, bool cork) {
+#ifdef TCP_CORK
+    int on = cork ? 1 : 0;
+    setsockopt(sock, IPPROTO_TCP, TCP_CORK, (const char*)&on, sizeof(on));
+#else
+    int nodelay = cork ? 0 : 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&nodelay, sizeof(nodelay));
+#endif
+}
+
+static void iq_socket_set_lowat(SOCKET sock) {
+#ifdef TCP_NOTSENT_LOWAT
+    int lowat = (int)iq_framer_notsent_lowat(g_iq_framer);
+    setsockopt(sock, IPPROTO_TCP, TCP_NOTSENT_LOWAT, (const char*)&lowat, sizeof(lowat));
+#else
+    (void)sock;
+#endif
+}
+
+/* SO_SNDBUF from the bandwidth-delay product; left alone within 25% */
+static void iq_socket_set_sndbuf(SOCKET sock, uint32_t rtt_us) {
+    size_t want = iq_framer_sndbuf(g_iq_framer, rtt_us);
+    if (g_iq_sndbuf != 0 && want * 4 < (size_t)g_iq_sndbuf * 5 && want * 4 > (size_t)g_iq_sndbuf * 3) {
+        return;
+    }
+    int size = (int)want;
+    setsockopt(sock, SOL_SOCKET, SO_SNDBUF, (const char*)&size, sizeof(size));
+    g_iq_sndbuf = (uint32_t)want;
+}
+
+/* New client: frames leave as soon as they are written, the send buffer
+ * covers the default RTT until the stack has measured one */
+static void iq_socket_tune(SOCKET sock) {
+    int nodelay = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&nodelay, sizeof(nodelay));
+    iq_socket_set_lowat(sock);
+    g_iq_rtt_us = 0;
+    g_iq_sndbuf = 0;
+    iq_socket_set_sndbuf(sock, 0);
+}
+
+/* Once per statistics window: resize for the measured RTT, publish the figures */
+static void iq_window_closed(SOCKET sock) {
+    iq_framer_stats_t stats;
+    uint32_t rtt = iq_socket_rtt_us(sock);
+    g_iq_rtt_us = rtt;
+    iq_socket_set_sndbuf(sock, rtt);
+
+    iq_framer_get_stats(g_iq_framer, &stats);
+    iq_lock();
+    g_iq_stats = stats;
+    iq_unlock();
+}
+
+/* GET_IQSTATS reply (control thread) */
+static void iq_stats_text(char *buf, size_t size) {
+    iq_framer_stats_t s;
+    iq_lock();
+    s = g_iq_stats;
+    iq_unlock();
+
+    snprintf(buf, size,
+        "CONNECTED=%d FPS=%.1f SENDS=%.1f FRAMES_PER_SEND=%.2f MBPS=%.2f SYSCALLS_PER_MB=%.1f "
+        "LAT_MS=%.2f LAT_MAX_MS=%.2f FRAME=%u SNDBUF=%u RTT_MS=%.2f FRAMES=%llu DROPPED=%u LATE=%llu",
+        g_iq_connected ? 1 : 0, s.frames_per_sec, s.sends_per_sec, s.frames_per_send,
+        s.mbytes_per_sec, s.syscalls_per_mb, s.latency_avg_ms, s.latency_max_ms,
+        s.frame_samples, g_iq_sndbuf, g_iq_rtt_us / 1000.0,
+        (unsigned long long)s.frames, g_iq_frames_dropped, (unsigned long long)s.late_sends);
+}
+
+/*============================================================================
+ * I/Q Streaming Thread
+ *============================================================================*/
+
 #ifdef _WIN32
 static DWORD WINAPI iq_stream_thread_func(void *arg)
 #else
@@ -379,9 +669,16 @@ static void *iq_stream_thread_func(void *arg)
 #endif
 {
     (void)arg;
+    /* A full batch, one more maximum frame and a META */
+    size_t batch_cap = IQ_FRAMER_BATCH_BYTES + sizeof(iq_data_frame_t) +
+                       IQ_MAX_FRAME_EVENTS * sizeof(iq_event_t) +
+                       IQ_FRAME_SAMPLES * 2 * sizeof(int16_t) + sizeof(iq_metadata_update_t);
     int16_t *frame_buffer = (int16_t*)malloc(IQ_FRAME_SAMPLES * 2 * sizeof(int16_t));
-    if (!frame_buffer) {
-        fprintf(stderr, "[IQ] Failed to allocate frame buffer\n");
+    uint8_t *batch = (uint8_t*)malloc(batch_cap);
+    if (!frame_buffer || !batch) {
+        fprintf(stderr, "[IQ] Failed to allocate frame buffers\n");
+        free(frame_buffer);
+        free(batch);
 #ifdef _WIN32
         return 0;
 #else
@@ -395,6 +692,19 @@ static void *iq_stream_thread_func(void *arg)
     int last_gain = 0;
     int last_lna = 0;
 
+    /* Gain deltas in GAIN markers are relative to the last one sent */
+    iq_event_t events[IQ_MAX_FRAME_EVENTS];
+    int32_t last_marker_gain = 0;
+    bool have_marker_gain = false;
+
+    /* Frames (and META) built but not yet sent */
+    size_t batch_len = 0;
+    uint32_t batch_frames = 0;
+    uint32_t batch_calls = 0;           /* Socket calls spent on this batch */
+    uint64_t batch_first = 0;           /* Stream position of its oldest sample */
+    bool batch_backed_up = false;
+    bool corked = false;
+
     printf("[IQ] Streaming thread started\n");
 
     while (g_running) {
@@ -434,11 +744,25 @@ static void *iq_stream_thread_func(void *arg)
             inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, sizeof(client_ip));
             printf("[IQ] Client connected from %s:%d\n", client_ip, ntohs(client_addr.sin_port));
 
+            iq_framer_set_rate(g_iq_framer, (uint32_t)g_sdr_state.sample_rate, 2 * sizeof(int16_t));
+            iq_framer_reset(g_iq_framer);
+            iq_socket_tune(new_client);
+            iq_lock();
+            memset(&g_iq_stats, 0, sizeof(g_iq_stats));
+            iq_unlock();
+            batch_len = 0;
+            batch_frames = 0;
+            batch_calls = 0;
+            batch_backed_up = false;
+            corked = false;
+
             g_iq_client_socket = new_client;
             g_iq_connected = true;
             g_iq_sequence = 0;
             g_iq_frames_sent = 0;
             g_iq_frames_dropped = 0;
+            iq_marker_queue_clear(g_iq_markers);
+            have_marker_gain = false;
 
             /* Reset config tracking */
             last_freq = g_sdr_state.freq_hz;
@@ -461,7 +785,12 @@ static void *iq_stream_thread_func(void *arg)
             continue;
         }
 
-        /* Send metadata update if config changed */
+        uint64_t now = iq_now_us();
+        if (!g_sdr_state.hardware_connected) {
+            iq_generate_test_tone(now);
+        }
+
+        /* Queue metadata update if config changed */
         if (g_iq_config_changed ||
             last_freq != g_sdr_state.freq_hz ||
             last_sample_rate != g_sdr_state.sample_rate ||
@@ -469,42 +798,62 @@ static void *iq_stream_thread_func(void *arg)
             last_lna != g_sdr_state.lna_state) {
 
             g_iq_config_changed = false;
+            if (last_sample_rate != g_sdr_state.sample_rate) {
+                iq_framer_set_rate(g_iq_framer, (uint32_t)g_sdr_state.sample_rate, 2 * sizeof(int16_t));
+                iq_socket_set_lowat(g_iq_client_socket);
+            }
             last_freq = g_sdr_state.freq_hz;
             last_sample_rate = g_sdr_state.sample_rate;
             last_gain = g_sdr_state.gain_reduction;
             last_lna = g_sdr_state.lna_state;
-            send_iq_metadata(g_iq_client_socket);
+            batch_len += build_iq_metadata(batch + batch_len);
             printf("[IQ] Config changed, sent metadata update\n");
         }
 
-        /* Read samples from ring buffer */
-        size_t samples = iq_buffer_read(frame_buffer, IQ_FRAME_SAMPLES);
-
-        /* If no samples and no hardware, generate test signal */
-        if (samples == 0 && !g_sdr_state.hardware_connected) {
-            /* Generate test signal: 1kHz tone at ~half scale */
-            static double phase = 0.0;
-            double freq_hz = 1000.0;
-            double sample_rate = (double)g_sdr_state.sample_rate;
-            double phase_inc = 2.0 * 3.14159265358979 * freq_hz / sample_rate;
-
-            for (size_t i = 0; i < IQ_FRAME_SAMPLES; i++) {
-                double val = sin(phase) * 16000.0;
-                frame_buffer[i * 2] = (int16_t)val;       /* I */
-                frame_buffer[i * 2 + 1] = (int16_t)(val * 0.5);  /* Q (phase shift for complex signal) */
-                phase += phase_inc;
-                if (phase > 2.0 * 3.14159265358979) phase -= 2.0 * 3.14159265358979;
+        /* Next frame, once the framer says it is full or has waited long enough */
+        uint32_t take = iq_framer_take(g_iq_framer, g_iq_read_abs, iq_buffer_available(), now);
+        uint64_t first_sample = 0;
+        size_t samples = take ? iq_buffer_read(frame_buffer, take, &first_sample) : 0;
+
+        if (samples > 0) {
+            int n_events = 0;
+            if (g_iq_markers) {
+                n_events = iq_marker_queue_take(g_iq_markers, first_sample, (uint32_t)samples,
+                                                events, IQ_MAX_FRAME_EVENTS);
+                for (int e = 0; e < n_events; e++) {
+                    if (events[e].type != IQ_EVENT_GAIN) continue;
+                    /* The API raises GainChange when it issues the update and flags
+                     * grChanged on the first block captured with it, so the latest
+                     * report is the gain now in effect. */
+                    int32_t gain = g_hw_gain_cdb;
+                    events[e].value = gain;
+                    events[e].aux = (int16_t)g_hw_lna_gr_db;
+                    events[e].delta = have_marker_gain ? gain - last_marker_gain : 0;
+                    last_marker_gain = gain;
+                    have_marker_gain = true;
+                }
             }
-            samples = IQ_FRAME_SAMPLES;
 
-            /* Simulate sample rate timing */
-            double frame_time_ms = (1000.0 * IQ_FRAME_SAMPLES) / sample_rate;
-#ifdef _WIN32
-            Sleep((DWORD)(frame_time_ms + 0.5));
-#else
-            usleep((useconds_t)(frame_time_ms * 1000));
-#endif
-        } else if (samples == 0) {
+            /* Frame: header | event markers | samples */
+            iq_data_frame_t frame;
+            frame.magic = IQ_MAGIC_DATA;
+            frame.sequence = g_iq_sequence++;
+            frame.num_samples = (uint32_t)samples;
+            frame.flags = g_iq_current_flags | ((uint32_t)n_events << IQ_EVENT_COUNT_SHIFT);
+            g_iq_current_flags = 0;  /* Clear flags after sending */
+
+            memcpy(batch + batch_len, &frame, sizeof(frame));
+            batch_len += sizeof(frame);
+            memcpy(batch + batch_len, events, (size_t)n_events * sizeof(iq_event_t));
+            batch_len += (size_t)n_events * sizeof(iq_event_t);
+            memcpy(batch + batch_len, frame_buffer, samples * 2 * sizeof(int16_t));
+            batch_len += samples * 2 * sizeof(int16_t);
+
+            if (batch_frames == 0) batch_first = first_sample;
+            batch_frames++;
+        }
+
+        if (batch_len == 0) {
 #ifdef _WIN32
             Sleep(1);
 #else
@@ -513,36 +862,50 @@ static void *iq_stream_thread_func(void *arg)
             continue;
         }
 
-        /* Build frame header */
-        iq_data_frame_t frame;
-        frame.magic = IQ_MAGIC_DATA;
-        frame.sequence = g_iq_sequence++;
-        frame.num_samples = (uint32_t)samples;
-        frame.flags = g_iq_current_flags;
-        g_iq_current_flags = 0;  /* Clear flags after sending */
-
-        /* Send frame header */
-        int sent = send(g_iq_client_socket, (const char*)&frame, sizeof(frame), 0);
-        if (sent != sizeof(frame)) {
-            printf("[IQ] Client disconnected (header send failed)\n");
-            closesocket(g_iq_client_socket);
-            g_iq_client_socket = INVALID_SOCKET;
-            g_iq_connected = false;
+        /* Socket still busy with the last batch: keep framing into this one */
+        bool writable = iq_socket_writable(g_iq_client_socket);
+        batch_calls++;
+        if (!writable) batch_backed_up = true;
+        if (!iq_framer_should_send(g_iq_framer, batch_len, writable)) {
+            if (samples == 0) {
+#ifdef _WIN32
+                Sleep(1);
+#else
+                usleep(1000);
+#endif
+            }
             continue;
         }
 
-        /* Send sample data */
-        size_t data_size = samples * 2 * sizeof(int16_t);
-        sent = send(g_iq_client_socket, (const char*)frame_buffer, (int)data_size, 0);
-        if (sent != (int)data_size) {
-            printf("[IQ] Client disconnected (data send failed)\n");
+        /* Corked while frames are coalesced, so full segments go out and the
+         * tail joins the next batch; a lone frame leaves at once */
+        bool cork = batch_frames > 1;
+        if (cork != corked) {
+            iq_socket_cork(g_iq_client_socket, cork);
+            corked = cork;
+            batch_calls++;
+        }
+
+        if (send_all(g_iq_client_socket, batch, batch_len) != 0) {
+            printf("[IQ] Client disconnected (send failed)\n");
             closesocket(g_iq_client_socket);
             g_iq_client_socket = INVALID_SOCKET;
             g_iq_connected = false;
             continue;
         }
+        batch_calls++;
 
-        g_iq_frames_sent++;
+        if (batch_frames > 0) {
+            g_iq_frames_sent += batch_frames;
+            if (iq_framer_sent(g_iq_framer, batch_frames, batch_len, batch_calls,
+                               batch_backed_up, batch_first, iq_now_us())) {
+                iq_window_closed(g_iq_client_socket);
+            }
+        }
+        batch_len = 0;
+        batch_frames = 0;
+        batch_calls = 0;
+        batch_backed_up = false;
     }
 
     /* Cleanup */
@@ -553,6 +916,7 @@ static void *iq_stream_thread_func(void *arg)
     g_iq_connected = false;
 
     free(frame_buffer);
+    free(batch);
     printf("[IQ] Streaming thread stopped\n");
 
 #ifdef _WIN32
@@ -562,40 +926,117 @@ static void *iq_stream_thread_func(void *arg)
 #endif
 }
 
+/*============================================================================
+ * rtl_tcp Ring Buffer Functions
+ *============================================================================*/
+
+static bool rtl_buffer_init(void) {
+    g_rtl_ring_buffer = (uint8_t*)malloc(RTL_RING_BUFFER_SIZE);
+    if (!g_rtl_ring_buffer) {
+        fprintf(stderr, "Failed to allocate rtl_tcp ring buffer\n");
+        return false;
+    }
+    g_rtl_write_abs = 0;
+    g_rtl_overruns = 0;
+    for (int i = 0; i < RTL_TCP_MAX_CLIENTS; i++) {
+        g_rtl_clients[i].sock = INVALID_SOCKET;
+        g_rtl_clients[i].cmd_len = 0;
+        g_rtl_clients[i].read_abs = 0;
+        g_rtl_clients[i].skips = 0;
+    }
+    printf("rtl_tcp ring buffer: %d KB allocated\n", RTL_RING_BUFFER_SIZE / 1024);
+    return true;
+}
+
+static void rtl_buffer_cleanup(void) {
+    if (g_rtl_ring_buffer) {
+        free(g_rtl_ring_buffer);
+        g_rtl_ring_buffer = NULL;
+    }
+}
+
+/**
+ * Convert and write samples to the rtl_tcp ring (called from SDR callback).
+ * Conversion happens once here; every rtl_tcp client is fed from the ring.
+ * The writer never waits for readers - a client that falls more than
+ * RTL_MAX_LAG behind is skipped ahead by the rtl_tcp thread.
+ */
+static void rtl_buffer_write(const int16_t *xi, const int16_t *xq, uint32_t count) {
+    if (!g_rtl_ring_buffer || g_rtl_client_count == 0) return;
+
+    size_t max_pairs = RTL_RING_BUFFER_SIZE / 2;
+    if (count > max_pairs) {
+        xi += count - max_pairs;
+        xq += count - max_pairs;
+        count = (uint32_t)max_pairs;
+    }
+
+    /* Convert straight into the ring, splitting at the wrap point */
+    size_t write = (size_t)(g_rtl_write_abs % RTL_RING_BUFFER_SIZE);
+    size_t first = (RTL_RING_BUFFER_SIZE - write) / 2;
+    if (first > count) first = count;
+    rtl_tcp_convert_s16_u8(xi, xq, g_rtl_ring_buffer + write, first);
+    if (count > first) {
+        rtl_tcp_convert_s16_u8(xi + first, xq + first, g_rtl_ring_buffer, count - first);
+    }
+    g_rtl_write_abs += (uint64_t)count * 2;
+}
+
 /*============================================================================
  * SDR Callbacks
  *============================================================================*/
 
 static void on_samples(const int16_t *xi, const int16_t *xq,
                       uint32_t count, bool reset, void *user_ctx) {
-    (void)reset; (void)user_ctx;
+    (void)user_ctx;
 
     /* Write samples to I/Q ring buffer for TCP streaming */
     if (g_iq_connected && g_sdr_state.streaming) {
+        if (reset) {
+            iq_marker_queue_post(g_iq_markers, g_iq_write_abs, IQ_EVENT_DISCONTINUITY, 0, 0);
+        }
         iq_buffer_write(xi, xq, count);
     }
-}
 
-static void on_gain_change(double gain_db, int lna_gr_db, void *user_ctx) {
-    tcp_sdr_state_t *state = (tcp_sdr_state_t*)user_ctx;
-    if (state) {
-        /* Note: lna_gr_db is LNA gain reduction in dB (0-24), NOT state index (0-8) */
-        /* We DON'T update state->gain_reduction here - it reflects what was SET by user */
-        /* The callback just reports what the hardware is actually using */
+    /* Convert once for all rtl_tcp clients */
+    if (g_rtl_client_count > 0 && g_sdr_state.streaming) {
+        rtl_buffer_write(xi, xq, count);
+    }
+}
 
-        /* Log the hardware-reported values for debugging */
-        printf("[SDR] Gain changed: GR=%.0f dB, LNA_GR=%d dB\n", gain_db, lna_gr_db);
+/* Streaming thread, just before on_samples: the change applies to xi[0] */
+static void on_stream_event(uint32_t flags, void *user_ctx) {
+    (void)user_ctx;
+    if (!g_iq_markers || !g_iq_connected) return;
 
-        /* Send notification with actual hardware values (informational only) */
-        tcp_send_notification(state, "! GAIN_CHANGE GR_ACTUAL=%d LNA_GR=%d",
-                              (int)gain_db, lna_gr_db);
+    uint64_t at = g_iq_write_abs;
+    if (flags & PSDR_STREAM_GR_CHANGED) {
+        /* Gain values are filled in by the I/Q thread when the frame is sent */
+        iq_marker_queue_post(g_iq_markers, at, IQ_EVENT_GAIN, 0, 0);
+    }
+    if (flags & PSDR_STREAM_RF_CHANGED) {
+        iq_marker_queue_post(g_iq_markers, at, IQ_EVENT_FREQ, 0, (int32_t)g_sdr_state.freq_hz);
+    }
+    if (flags & PSDR_STREAM_FS_CHANGED) {
+        iq_marker_queue_post(g_iq_markers, at, IQ_EVENT_DISCONTINUITY, 0, 0);
     }
 }
 
+/* Gain and overload callbacks run on the SDRplay event thread: no I/O, no
+ * locks - post to g_notify and return. The control thread logs and sends. */
+static void on_gain_change(double gain_db, int lna_gr_db, void *user_ctx) {
+    (void)user_ctx;
+    /* Note: lna_gr_db is LNA gain reduction in dB (0-24), NOT state index (0-8) */
+    /* We DON'T update state->gain_reduction here - it reflects what was SET by user */
+    /* The callback just reports what the hardware is actually using */
+    g_hw_gain_cdb = (int32_t)lround(gain_db * 100.0);
+    g_hw_lna_gr_db = lna_gr_db;
+    notify_post_gain(g_notify, (int)gain_db, lna_gr_db);
+}
+
 static void on_overload(bool overloaded, void *user_ctx) {
     tcp_sdr_state_t *state = (tcp_sdr_state_t*)user_ctx;
     if (state) {
-        bool was_overloaded = state->overload;
         state->overload = overloaded;
 
         /* Set I/Q stream flag */
@@ -603,17 +1044,33 @@ static void on_overload(bool overloaded, void *user_ctx) {
             g_iq_current_flags |= IQ_FLAG_OVERLOAD;
         }
 
-        /* Only notify if state changed AND rate limit not exceeded */
-        if (was_overloaded != overloaded) {
-            DWORD now = GetTickCount();
-            DWORD elapsed = now - g_last_overload_notify_time;
+        /* Event thread: placed at the next sample to be captured */
+        if (g_iq_markers && g_iq_connected) {
+            iq_marker_queue_post(g_iq_markers, g_iq_write_abs, IQ_EVENT_OVERLOAD,
+                                 0, overloaded ? 1 : 0);
+        }
 
-            if (elapsed >= OVERLOAD_NOTIFY_COOLDOWN_MS) {
-                printf("[SDR] %s\n", overloaded ? "OVERLOAD DETECTED" : "Overload cleared");
-                tcp_send_notification(state, "! OVERLOAD %s",
-                                      overloaded ? "DETECTED" : "CLEARED");
-                g_last_overload_notify_time = now;
-            }
+        notify_post_overload(g_notify, overloaded);
+    }
+}
+
+/* Control thread: log and forward pending SDR events (client may be NULL) */
+static void send_notifications(tcp_sdr_state_t *state) {
+    notify_event_t events[NOTIFY_MAX_EVENTS];
+    int n = notify_queue_drain(g_notify, events);
+
+    for (int i = 0; i < n; i++) {
+        const notify_event_t *ev = &events[i];
+        if (ev->type == NOTIFY_GAIN_CHANGE) {
+            printf("[SDR] Gain changed: GR=%d dB, LNA_GR=%d dB\n", ev->gr_db, ev->lna_gr_db);
+        } else {
+            printf("[SDR] %s\n", ev->overloaded ? "OVERLOAD DETECTED" : "Overload cleared");
+        }
+
+        if (state) {
+            char line[64];
+            notify_format(ev, line, sizeof(line));
+            tcp_send_notification(state, "%s", line);
         }
     }
 }
@@ -752,6 +1209,12 @@ static void signal_handler(int sig) {
         g_iq_listen_socket = INVALID_SOCKET;
     }
 
+    /* Close rtl_tcp listener - the rtl_tcp thread closes its clients on exit */
+    if (g_rtl_listen_socket != INVALID_SOCKET) {
+        closesocket(g_rtl_listen_socket);
+        g_rtl_listen_socket = INVALID_SOCKET;
+    }
+
     /* Close control sockets to unblock accept/recv */
     if (g_client_socket != INVALID_SOCKET) {
         closesocket(g_client_socket);
@@ -788,6 +1251,17 @@ static int send_line(SOCKET sock, const char *line) {
     return (sent == (int)len) ? 0 : -1;
 }
 
+/* Wait up to timeout_ms for data; true if readable or the socket failed */
+static bool wait_readable(SOCKET sock, int timeout_ms) {
+    fd_set read_fds;
+    struct timeval tv;
+    FD_ZERO(&read_fds);
+    FD_SET(sock, &read_fds);
+    tv.tv_sec = 0;
+    tv.tv_usec = timeout_ms * 1000;
+    return select((int)(sock + 1), &read_fds, NULL, NULL, &tv) != 0;
+}
+
 static int recv_line(SOCKET sock, char *buf, int buf_size) {
     int total = 0;
     while (total < buf_size - 1) {
@@ -817,6 +1291,27 @@ static bool init_sdr(tcp_sdr_state_t *state, int device_idx);
 static void cleanup_sdr(tcp_sdr_state_t *state);
 static bool reinit_sdr(tcp_sdr_state_t *state);
 
+/*============================================================================
+ * Command Serialization
+ *============================================================================*/
+
+/* Control client and rtl_tcp clients share one SDR - one command at a time */
+static void cmd_lock(void) {
+#ifdef _WIN32
+    EnterCriticalSection(&g_cmd_mutex);
+#else
+    pthread_mutex_lock(&g_cmd_mutex);
+#endif
+}
+
+static void cmd_unlock(void) {
+#ifdef _WIN32
+    LeaveCriticalSection(&g_cmd_mutex);
+#else
+    pthread_mutex_unlock(&g_cmd_mutex);
+#endif
+}
+
 /*============================================================================
  * Client Handler
  *============================================================================*/
@@ -829,10 +1324,19 @@ static void handle_client(SOCKET client, tcp_sdr_state_t *state) {
 
     printf("Client connected\n");
 
-    /* Enable async notifications for this client */
+    /* Enable async notifications for this client - events from before it
+     * connected are stale */
+    send_notifications(NULL);
+    notify_queue_resync(g_notify);
     tcp_notify_set_client(state, client);
 
     while (g_running) {
+        /* Send queued SDR events while waiting for the next command */
+        if (!wait_readable(client, NOTIFY_POLL_MS)) {
+            send_notifications(state);
+            continue;
+        }
+
         /* Receive command */
         int len = recv_line(client, line, sizeof(line));
         if (len < 0) {
@@ -849,10 +1353,10 @@ static void handle_client(SOCKET client, tcp_sdr_state_t *state) {
         tcp_error_t err = tcp_parse_command(line, &cmd);
 
         if (err == TCP_OK) {
-            /* Suppress notifications during command execution to ensure
-             * the command response is sent before any async notifications.
-             * This prevents ! GAIN_CHANGE from arriving before OK. */
-            state->notify_enabled = false;
+            /* Notifications are only sent from this thread between commands,
+             * so the response always goes out before any ! GAIN_CHANGE the
+             * command triggers. */
+            cmd_lock();
 
             /* Handle START cooldown - SDR needs time to reset after STOP */
             if (cmd.type == CMD_START && g_last_stop_time != 0) {
@@ -881,6 +1385,7 @@ static void handle_client(SOCKET client, tcp_sdr_state_t *state) {
             if (cmd.type == CMD_STOP && resp.error == TCP_OK) {
                 g_last_stop_time = GetTickCount();
             }
+            cmd_unlock();
         } else {
             /* Parse error */
             const char *msg = NULL;
@@ -903,8 +1408,7 @@ static void handle_client(SOCKET client, tcp_sdr_state_t *state) {
             break;
         }
 
-        /* Re-enable async notifications after response is sent */
-        state->notify_enabled = true;
+        send_notifications(state);
 
         /* Handle QUIT */
         if (cmd.type == CMD_QUIT) {
@@ -912,8 +1416,12 @@ static void handle_client(SOCKET client, tcp_sdr_state_t *state) {
         }
     }
 
-    /* Stop streaming if client disconnects */
-    if (state->streaming) {
+    /* Stop streaming if client disconnects - unless rtl_tcp clients still need it */
+    cmd_lock();
+    if (state->streaming && g_rtl_client_count > 0) {
+        printf("Streaming continues for %d rtl_tcp client(s)\n", g_rtl_client_count);
+        g_rtl_started_streaming = true;  /* Last rtl_tcp client out stops it */
+    } else if (state->streaming) {
         printf("Stopping streaming (client disconnect)\n");
         if (state->hardware_connected && state->sdr_ctx) {
             psdr_stop(state->sdr_ctx);
@@ -921,10 +1429,10 @@ static void handle_client(SOCKET client, tcp_sdr_state_t *state) {
         }
         state->streaming = false;
     }
+    cmd_unlock();
 
     /* Reset overload state for next client */
     state->overload = false;
-    g_last_overload_notify_time = 0;
 
     /* Disable async notifications */
     tcp_notify_clear_client(state);
@@ -932,6 +1440,334 @@ static void handle_client(SOCKET client, tcp_sdr_state_t *state) {
     printf("Client session cleanup complete\n");
 }
 
+/*============================================================================
+ * rtl_tcp Streaming Thread
+ *============================================================================*/
+
+/* Parse and execute a text command against the shared state (caller holds cmd_lock) */
+static void rtl_execute_line(const char *line, tcp_response_t *resp) {
+    tcp_command_t cmd;
+    tcp_error_t err = tcp_parse_command(line, &cmd);
+    if (err != TCP_OK) {
+        tcp_response_error(resp, err, NULL);
+        return;
+    }
+    tcp_execute_command(&cmd, &g_sdr_state, resp);
+}
+
+static void rtl_start_streaming(void) {
+    cmd_lock();
+    if (!g_sdr_state.streaming) {
+        if (g_last_stop_time != 0) {
+            DWORD elapsed = GetTickCount() - g_last_stop_time;
+            if (elapsed < SDR_RESTART_COOLDOWN_MS) {
+                Sleep(SDR_RESTART_COOLDOWN_MS - elapsed);
+            }
+        }
+
+        tcp_response_t resp;
+        rtl_execute_line("START", &resp);
+        if (resp.error == TCP_ERR_HARDWARE && reinit_sdr(&g_sdr_state)) {
+            rtl_execute_line("START", &resp);
+        }
+
+        if (resp.error == TCP_OK) {
+            g_rtl_started_streaming = true;
+            printf("[RTL] Streaming started for rtl_tcp clients\n");
+        } else {
+            printf("[RTL] START failed: %s\n", resp.message);
+        }
+    }
+    cmd_unlock();
+}
+
+static void rtl_stop_streaming_if_owned(void) {
+    cmd_lock();
+    /* Leave it running if a control client is attached - it owns the session now */
+    if (g_rtl_started_streaming && g_sdr_state.streaming && g_client_socket == INVALID_SOCKET) {
+        tcp_response_t resp;
+        rtl_execute_line("STOP", &resp);
+        g_last_stop_time = GetTickCount();
+        printf("[RTL] Streaming stopped (last rtl_tcp client left)\n");
+    }
+    g_rtl_started_streaming = false;
+    cmd_unlock();
+}
+
+/**
+ * Execute a mapped rtl_tcp command (caller holds cmd_lock).
+ * rtl_tcp clients change sample rate while streaming; the RSP needs a
+ * stop/start around it, which the control protocol leaves to the client.
+ */
+static void rtl_execute(tcp_command_t *cmd, tcp_response_t *resp) {
+    bool restart = (cmd->type == CMD_SET_SRATE && g_sdr_state.streaming);
+
+    if (restart) {
+        rtl_execute_line("STOP", resp);
+        if (resp->error != TCP_OK) {
+            return;
+        }
+        Sleep(SDR_RESTART_COOLDOWN_MS);
+    }
+
+    tcp_execute_command(cmd, &g_sdr_state, resp);
+
+    if (restart) {
+        tcp_response_t start_resp;
+        rtl_execute_line("START", &start_resp);
+        if (start_resp.error != TCP_OK) {
+            *resp = start_resp;
+        }
+    }
+}
+
+static void rtl_handle_packet(const uint8_t pkt[RTL_TCP_CMD_SIZE]) {
+    uint32_t param = ((uint32_t)pkt[1] << 24) | ((uint32_t)pkt[2] << 16) |
+                     ((uint32_t)pkt[3] << 8) | (uint32_t)pkt[4];
+    const char *name = rtl_tcp_cmd_name(pkt[0]);
+
+    tcp_command_t cmd;
+    tcp_error_t err = rtl_tcp_map_command(pkt, &cmd);
+    if (err == TCP_ERR_UNKNOWN) {
+        printf("[RTL] Ignoring %s %u (no RSP equivalent)\n", name, param);
+        return;
+    }
+    if (err != TCP_OK) {
+        printf("[RTL] Rejected %s %u (%s)\n", name, param,
+               err == TCP_ERR_RANGE ? "value out of range" : "invalid parameter");
+        return;
+    }
+
+    tcp_response_t resp;
+    cmd_lock();
+    rtl_execute(&cmd, &resp);
+    cmd_unlock();
+
+    printf("[RTL] %s %u -> %s\n", name, param,
+           resp.error == TCP_OK ? "OK" : resp.message);
+}
+
+static void rtl_drop_client(int slot, const char *reason) {
+    rtl_client_t *c = &g_rtl_clients[slot];
+    if (c->sock == INVALID_SOCKET) return;
+
+    closesocket(c->sock);
+    c->sock = INVALID_SOCKET;
+    c->cmd_len = 0;
+    g_rtl_client_count--;
+    printf("[RTL] Client %d %s (%d remaining, skipped ahead %u times)\n",
+           slot, reason, g_rtl_client_count, c->skips);
+
+    if (g_rtl_client_count == 0) {
+        rtl_stop_streaming_if_owned();
+    }
+}
+
+static void rtl_accept_client(void) {
+    struct sockaddr_in client_addr;
+    socklen_t client_len = sizeof(client_addr);
+    SOCKET new_client = accept(g_rtl_listen_socket, (struct sockaddr*)&client_addr, &client_len);
+    if (new_client == INVALID_SOCKET) {
+        return;
+    }
+
+    char client_ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, sizeof(client_ip));
+
+    int slot = -1;
+    for (int i = 0; i < RTL_TCP_MAX_CLIENTS; i++) {
+        if (g_rtl_clients[i].sock == INVALID_SOCKET) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0) {
+        printf("[RTL] Rejecting %s:%d (max %d clients)\n",
+               client_ip, ntohs(client_addr.sin_port), RTL_TCP_MAX_CLIENTS);
+        closesocket(new_client);
+        return;
+    }
+
+    uint8_t header[RTL_TCP_HEADER_SIZE];
+    rtl_tcp_build_header(header);
+    if (send_all(new_client, header, sizeof(header)) < 0) {
+        closesocket(new_client);
+        return;
+    }
+
+    /* Header goes out blocking; samples never do */
+    set_nonblocking(new_client);
+
+    /* New clients start from fresh samples, not whatever is left in the ring */
+    g_rtl_clients[slot].sock = new_client;
+    g_rtl_clients[slot].cmd_len = 0;
+    g_rtl_clients[slot].read_abs = g_rtl_write_abs;
+    g_rtl_clients[slot].skips = 0;
+    g_rtl_client_count++;
+    printf("[RTL] Client %d connected from %s:%d\n", slot, client_ip, ntohs(client_addr.sin_port));
+
+    rtl_start_streaming();
+}
+
+/* Read pending command bytes; returns false if the client went away */
+static bool rtl_poll_commands(rtl_client_t *c) {
+    int n = recv(c->sock, (char*)c->cmd_buf + c->cmd_len, RTL_TCP_CMD_SIZE - c->cmd_len, 0);
+    if (n <= 0) {
+        return false;
+    }
+    c->cmd_len += n;
+    if (c->cmd_len == RTL_TCP_CMD_SIZE) {
+        rtl_handle_packet(c->cmd_buf);
+        c->cmd_len = 0;
+    }
+    return true;
+}
+
+/*
+ * Send this client what it has not seen yet, without blocking. A client
+ * more than RTL_MAX_LAG behind is skipped ahead by whole I/Q pairs, so the
+ * ring region it sends from is never the one being written.
+ */
+static void rtl_send_pending(int slot, uint64_t write_abs) {
+    rtl_client_t *c = &g_rtl_clients[slot];
+    uint64_t lag = write_abs - c->read_abs;
+
+    if (lag > RTL_MAX_LAG) {
+        uint64_t skip = lag & ~(uint64_t)1;    /* Keep the client's I/Q byte phase */
+        c->read_abs += skip;
+        lag -= skip;
+        if (c->skips++ == 0) {
+            printf("[RTL] Client %d lagging, skipped %llu bytes\n", slot, (unsigned long long)skip);
+        }
+        g_rtl_overruns++;
+    }
+
+    while (lag > 0) {
+        size_t pos = (size_t)(c->read_abs % RTL_RING_BUFFER_SIZE);
+        size_t len = RTL_RING_BUFFER_SIZE - pos;
+        if (len > lag) len = (size_t)lag;
+        if (len > RTL_SEND_CHUNK) len = RTL_SEND_CHUNK;
+
+        int sent = send(c->sock, (const char*)g_rtl_ring_buffer + pos, (int)len, 0);
+        if (sent <= 0) {
+            if (sent < 0 && !socket_would_block()) {
+                rtl_drop_client(slot, "disconnected (send failed)");
+            }
+            return;
+        }
+        c->read_abs += (uint64_t)sent;
+        lag -= (uint64_t)sent;
+    }
+}
+
+/* 1 kHz test tone written to the ring like live samples (no hardware attached) */
+static void rtl_generate_test_tone(void) {
+    static double phase = 0.0;
+    int16_t xi[RTL_TONE_SAMPLES];
+    int16_t xq[RTL_TONE_SAMPLES];
+    double phase_inc = 2.0 * 3.14159265358979 * 1000.0 / (double)g_sdr_state.sample_rate;
+
+    for (size_t i = 0; i < RTL_TONE_SAMPLES; i++) {
+        xi[i] = (int16_t)(cos(phase) * 16000.0);
+        xq[i] = (int16_t)(sin(phase) * 16000.0);
+        phase += phase_inc;
+        if (phase > 2.0 * 3.14159265358979) phase -= 2.0 * 3.14159265358979;
+    }
+    rtl_buffer_write(xi, xq, RTL_TONE_SAMPLES);
+
+    /* Simulate sample rate timing */
+    double block_time_ms = (1000.0 * RTL_TONE_SAMPLES) / (double)g_sdr_state.sample_rate;
+#ifdef _WIN32
+    Sleep((DWORD)(block_time_ms + 0.5));
+#else
+    usleep((useconds_t)(block_time_ms * 1000));
+#endif
+}
+
+#ifdef _WIN32
+static DWORD WINAPI rtl_stream_thread_func(void *arg)
+#else
+static void *rtl_stream_thread_func(void *arg)
+#endif
+{
+    (void)arg;
+    printf("[RTL] rtl_tcp thread started\n");
+
+    while (g_running && g_rtl_listen_socket != INVALID_SOCKET) {
+        /* Poll for new clients and command packets, and for room on any
+         * client that still has samples to send */
+        uint64_t write_abs = g_rtl_write_abs;
+        bool sending = g_sdr_state.streaming;
+        fd_set read_fds, write_fds;
+        FD_ZERO(&read_fds);
+        FD_ZERO(&write_fds);
+        FD_SET(g_rtl_listen_socket, &read_fds);
+        SOCKET max_fd = g_rtl_listen_socket;
+        for (int i = 0; i < RTL_TCP_MAX_CLIENTS; i++) {
+            if (g_rtl_clients[i].sock != INVALID_SOCKET) {
+                FD_SET(g_rtl_clients[i].sock, &read_fds);
+                if (sending && g_rtl_clients[i].read_abs != write_abs) {
+                    FD_SET(g_rtl_clients[i].sock, &write_fds);
+                }
+                if (g_rtl_clients[i].sock > max_fd) max_fd = g_rtl_clients[i].sock;
+            }
+        }
+
+        struct timeval tv;
+        tv.tv_sec = 0;
+        tv.tv_usec = 10000;
+
+        int ready = select((int)(max_fd + 1), &read_fds, &write_fds, NULL, &tv);
+        if (ready > 0) {
+            if (FD_ISSET(g_rtl_listen_socket, &read_fds)) {
+                rtl_accept_client();
+            }
+            for (int i = 0; i < RTL_TCP_MAX_CLIENTS; i++) {
+                if (g_rtl_clients[i].sock != INVALID_SOCKET &&
+                    FD_ISSET(g_rtl_clients[i].sock, &read_fds) &&
+                    !rtl_poll_commands(&g_rtl_clients[i])) {
+                    rtl_drop_client(i, "disconnected");
+                }
+            }
+        }
+
+        if (g_rtl_client_count == 0 || !g_sdr_state.streaming) {
+            continue;
+        }
+
+        if (!g_sdr_state.hardware_connected) {
+            rtl_generate_test_tone();
+        }
+
+        write_abs = g_rtl_write_abs;
+        for (int i = 0; i < RTL_TCP_MAX_CLIENTS; i++) {
+            if (g_rtl_clients[i].sock != INVALID_SOCKET) {
+                rtl_send_pending(i, write_abs);
+            }
+        }
+    }
+
+    /* Cleanup */
+    for (int i = 0; i < RTL_TCP_MAX_CLIENTS; i++) {
+        if (g_rtl_clients[i].sock != INVALID_SOCKET) {
+            closesocket(g_rtl_clients[i].sock);
+            g_rtl_clients[i].sock = INVALID_SOCKET;
+        }
+    }
+    g_rtl_client_count = 0;
+
+    if (g_rtl_overruns > 0) {
+        printf("[RTL] %u lagging-client skips\n", g_rtl_overruns);
+    }
+    printf("[RTL] rtl_tcp thread stopped\n");
+
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
 /*============================================================================
  * Usage
  *============================================================================*/
@@ -943,12 +1779,17 @@ static void print_usage(const char *prog) {
     printf("  -i PORT    I/Q stream port (default: %d)\n", IQ_DEFAULT_PORT);
     printf("  -T ADDR    Listen address (default: 127.0.0.1)\n");
     printf("  -I         Disable I/Q streaming port\n");
+    printf("  -E         Send in-band event markers on the I/Q stream (version 2)\n");
+    printf("  -L MS      I/Q latency budget: frames shrink to keep samples under it (default: %d)\n",
+           IQ_FRAMER_DEFAULT_LATENCY_MS);
+    printf("  -r PORT    Enable rtl_tcp-compatible port (off by default, usual: %d)\n", RTL_TCP_DEFAULT_PORT);
     printf("  -d INDEX   Select SDR device index (default: 0)\n");
     printf("  -l         Log output to file (sdr_server_<version>.log)\n");
     printf("  -m         Start minimized (or hidden if -l also set)\n");
     printf("  -h         Show this help\n");
     printf("\nProtocol: See docs/SDR_TCP_CONTROL_INTERFACE.md\n");
     printf("I/Q Stream: See docs/SDR_IQ_STREAMING_INTERFACE.md\n");
+    printf("rtl_tcp:    See docs/SDR_SERVER.md\n");
 }
 
 /*============================================================================
@@ -1003,6 +1844,7 @@ static bool init_sdr(tcp_sdr_state_t *state, int device_idx) {
     state->sdr_callbacks.on_samples = on_samples;
     state->sdr_callbacks.on_gain_change = on_gain_change;
     state->sdr_callbacks.on_overload = on_overload;
+    state->sdr_callbacks.on_stream_event = on_stream_event;
     state->sdr_callbacks.user_ctx = state;
 
     /* Configure with defaults from state */
@@ -1084,6 +1926,7 @@ int main(int argc, char *argv[]) {
     int iq_port = IQ_DEFAULT_PORT;
     const char *bind_addr = "127.0.0.1";
     bool iq_enabled = true;
+    int rtl_port = 0;  /* 0 = rtl_tcp listener disabled */
     int device_idx = 0;
 
     /* Parse arguments */
@@ -1094,6 +1937,17 @@ int main(int argc, char *argv[]) {
             iq_port = atoi(argv[++i]);
         } else if (strcmp(argv[i], "-I") == 0) {
             iq_enabled = false;
+        } else if (strcmp(argv[i], "-E") == 0) {
+            g_iq_events_enabled = true;
+        } else if (strcmp(argv[i], "-L") == 0 && i + 1 < argc) {
+            int ms = atoi(argv[++i]);
+            if (ms < 1 || ms > 1000) {
+                fprintf(stderr, "Latency budget must be 1-1000 ms\n");
+                return 1;
+            }
+            g_iq_latency_ms = (uint32_t)ms;
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            rtl_port = atoi(argv[++i]);
         } else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) {
             bind_addr = argv[++i];
         } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
@@ -1154,8 +2008,16 @@ int main(int argc, char *argv[]) {
     /* Initialize SDR state */
     tcp_state_defaults(&g_sdr_state);
 
-    /* Initialize notification mutex */
+    /* Initialize notification mutex and SDR event queue */
     tcp_notify_init(&g_sdr_state);
+    g_notify = notify_queue_create();
+    if (!g_notify) {
+        fprintf(stderr, "Failed to allocate notification queue\n");
+        return 1;
+    }
+#ifdef _WIN32
+    InitializeCriticalSection(&g_cmd_mutex);
+#endif
 
     /* Initialize SDR hardware */
     g_sdr_device_idx = device_idx;  /* Save for reinit */
@@ -1178,6 +2040,7 @@ int main(int argc, char *argv[]) {
             socket_cleanup();
             return 1;
         }
+        g_sdr_state.iq_stats = iq_stats_text;
     }
 
     /* Set up signal handler */
@@ -1288,6 +2151,36 @@ int main(int argc, char *argv[]) {
         printf("I/Q streaming: DISABLED\n");
     }
 
+    /* Create rtl_tcp listen socket (optional - failures here are not fatal) */
+    HANDLE rtl_thread = NULL;
+    if (rtl_port > 0 && rtl_buffer_init()) {
+        g_rtl_listen_socket = socket(AF_INET, SOCK_STREAM, 0);
+        if (g_rtl_listen_socket != INVALID_SOCKET) {
+            setsockopt(g_rtl_listen_socket, SOL_SOCKET, SO_REUSEADDR, (char*)&optval, sizeof(optval));
+
+            struct sockaddr_in rtl_addr;
+            memset(&rtl_addr, 0, sizeof(rtl_addr));
+            rtl_addr.sin_family = AF_INET;
+            rtl_addr.sin_port = htons((unsigned short)rtl_port);
+            inet_pton(AF_INET, bind_addr, &rtl_addr.sin_addr);
+
+            if (bind(g_rtl_listen_socket, (struct sockaddr*)&rtl_addr, sizeof(rtl_addr)) == SOCKET_ERROR ||
+                listen(g_rtl_listen_socket, RTL_TCP_MAX_CLIENTS) == SOCKET_ERROR) {
+                fprintf(stderr, "Warning: rtl_tcp port %s:%d unavailable\n", bind_addr, rtl_port);
+                closesocket(g_rtl_listen_socket);
+                g_rtl_listen_socket = INVALID_SOCKET;
+            }
+        }
+
+        if (g_rtl_listen_socket != INVALID_SOCKET) {
+            printf("rtl_tcp port: %s:%d (U8, up to %d clients)\n", bind_addr, rtl_port, RTL_TCP_MAX_CLIENTS);
+            rtl_thread = CreateThread(NULL, 0, rtl_stream_thread_func, NULL, 0, NULL);
+            if (!rtl_thread) {
+                fprintf(stderr, "Failed to create rtl_tcp thread\n");
+            }
+        }
+    }
+
     printf("Hardware: %s\n", g_sdr_state.hardware_connected ? "CONNECTED" : "NOT CONNECTED");
 
     printf("Press Ctrl+C to stop\n\n");
@@ -1311,6 +2204,7 @@ int main(int argc, char *argv[]) {
 
         int ready = select((int)(g_listen_socket + 1), &read_fds, NULL, NULL, &tv);
         if (ready <= 0) {
+            send_notifications(NULL);  /* No client - just log SDR events */
             continue;  /* Timeout or error, loop to check g_running and process messages */
         }
 
@@ -1342,6 +2236,10 @@ int main(int argc, char *argv[]) {
         WaitForSingleObject(iq_thread, 2000);
         CloseHandle(iq_thread);
     }
+    if (rtl_thread) {
+        WaitForSingleObject(rtl_thread, 2000);
+        CloseHandle(rtl_thread);
+    }
 
     /* Cleanup */
 #ifdef _WIN32
@@ -1351,11 +2249,19 @@ int main(int argc, char *argv[]) {
 #endif
     cleanup_sdr(&g_sdr_state);
     tcp_notify_cleanup(&g_sdr_state);
+    notify_queue_destroy(g_notify);
     iq_buffer_cleanup();
+    rtl_buffer_cleanup();
+#ifdef _WIN32
+    DeleteCriticalSection(&g_cmd_mutex);
+#endif
 
     if (g_iq_listen_socket != INVALID_SOCKET) {
         closesocket(g_iq_listen_socket);
     }
+    if (g_rtl_listen_socket != INVALID_SOCKET) {
+        closesocket(g_rtl_listen_socket);
+    }
     if (g_listen_socket != INVALID_SOCKET) {
         closesocket(g_listen_socket);
     }
@@ -13,6 +13,26 @@
  *   - Continue broadcasting if splitter disconnects
  *   - Send stream header to new clients
  *
+ * Connections on a stream port are told apart by their first bytes: an
+ * FT32 header makes it the source, an iq_enc_request_t makes it a client
+ * with that sample encoding (iq_encoding.h), and a connection that stays
+ * silent for RELAY_FANOUT_PENDING_MS is a float32 client.
+ *
+ * Each source frame is reassembled, decoded once if the source is encoded,
+ * and encoded once per encoding in use - not once per client. Clients on
+ * the source's own encoding get its payload untouched.
+ *
+ * The framing, per-encoding fan-out and client rings live in relay_fanout.c,
+ * shared with the in-process pipeline (pipeline.h); this file keeps the
+ * listeners, source connections and the control relay.
+ *
+ * Multicast (--multicast):
+ *   - Each DATA frame also goes out once to a UDP multicast group
+ *     (detector on PORT, display on PORT+1) as MTU-sized datagrams with
+ *     XOR parity packets, plus a 1 s beacon - see relay_mcast.h
+ *   - LAN displays join the group (iq_client_create_mcast) instead of
+ *     each taking a TCP copy
+ *
  * Target Platform: Linux (DigitalOcean droplet)
  */
 
@@ -30,27 +50,9 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <fcntl.h>
+#include <math.h>
 
-/*============================================================================
- * Protocol Definitions (must match signal_splitter.c)
- *============================================================================*/
-
-#define MAGIC_FT32  0x46543332  /* "FT32" - Float32 stream header */
-#define MAGIC_DATA  0x44415441  /* "DATA" - Float32 data frame */
-
-typedef struct {
-    uint32_t magic;           /* 0x46543332 = "FT32" */
-    uint32_t sample_rate;     /* Hz (50000 or 12000) */
-    uint32_t reserved1;
-    uint32_t reserved2;
-} relay_stream_header_t;
-
-typedef struct {
-    uint32_t magic;           /* 0x44415441 = "DATA" */
-    uint32_t sequence;        /* Frame counter */
-    uint32_t num_samples;     /* I/Q pairs in frame */
-    uint32_t reserved;
-} relay_data_frame_t;
+#include "relay_fanout.h"
 
 /*============================================================================
  * Configuration
@@ -59,204 +61,8 @@ typedef struct {
 #define DETECTOR_PORT       4410
 #define DISPLAY_PORT        4411
 #define CONTROL_PORT        4409
-#define MAX_CLIENTS         100
-#define CLIENT_BUFFER_SIZE  (50000 * 30)  /* 30 sec @ 50kHz (worst case) */
 #define STATUS_INTERVAL_SEC 5
-
-/*============================================================================
- * Client Ring Buffer
- *============================================================================*/
-
-typedef struct {
-    uint8_t *data;
-    size_t capacity;
-    size_t write_idx;
-    size_t read_idx;
-    size_t count;
-    uint64_t overflows;
-    uint64_t bytes_sent;
-} client_buffer_t;
-
-static client_buffer_t* client_buffer_create(size_t capacity) {
-    client_buffer_t *cb = (client_buffer_t*)malloc(sizeof(client_buffer_t));
-    if (!cb) return NULL;
-
-    cb->data = (uint8_t*)malloc(capacity);
-    if (!cb->data) {
-        free(cb);
-        return NULL;
-    }
-
-    cb->capacity = capacity;
-    cb->write_idx = 0;
-    cb->read_idx = 0;
-    cb->count = 0;
-    cb->overflows = 0;
-    cb->bytes_sent = 0;
-    return cb;
-}
-
-static void client_buffer_destroy(client_buffer_t *cb) {
-    if (cb) {
-        free(cb->data);
-        free(cb);
-    }
-}
-
-static size_t client_buffer_write(client_buffer_t *cb, const uint8_t *data, size_t len) {
-    size_t written = 0;
-
-    while (written < len) {
-        if (cb->count >= cb->capacity) {
-            /* Overflow - discard oldest byte */
-            cb->read_idx = (cb->read_idx + 1) % cb->capacity;
-            cb->overflows++;
-        } else {
-            cb->count++;
-        }
-
-        cb->data[cb->write_idx] = data[written];
-        cb->write_idx = (cb->write_idx + 1) % cb->capacity;
-        written++;
-    }
-
-    return written;
-}
-
-static size_t client_buffer_read(client_buffer_t *cb, uint8_t *data, size_t len) {
-    size_t to_read = (len < cb->count) ? len : cb->count;
-    size_t read_count = 0;
-
-    while (read_count < to_read) {
-        data[read_count] = cb->data[cb->read_idx];
-        cb->read_idx = (cb->read_idx + 1) % cb->capacity;
-        read_count++;
-    }
-
-    cb->count -= read_count;
-    cb->bytes_sent += read_count;
-    return read_count;
-}
-
-/*============================================================================
- * Client Management
- *============================================================================*/
-
-typedef struct {
-    int fd;
-    struct sockaddr_in addr;
-    client_buffer_t *buffer;
-    bool header_sent;
-    time_t connected_time;
-    uint64_t frames_sent;
-} client_t;
-
-typedef struct {
-    client_t clients[MAX_CLIENTS];
-    int count;
-    relay_stream_header_t stream_header;
-    uint64_t total_clients_served;
-    uint64_t total_bytes_relayed;
-    uint64_t total_frames_relayed;
-} client_list_t;
-
-static void client_list_init(client_list_t *list, uint32_t sample_rate) {
-    memset(list, 0, sizeof(client_list_t));
-    list->stream_header.magic = MAGIC_FT32;
-    list->stream_header.sample_rate = sample_rate;
-    list->stream_header.reserved1 = 0;
-    list->stream_header.reserved2 = 0;
-}
-
-static int client_list_add(client_list_t *list, int fd, struct sockaddr_in *addr) {
-    if (list->count >= MAX_CLIENTS) return -1;
-
-    client_t *client = &list->clients[list->count];
-    client->fd = fd;
-    client->addr = *addr;
-    client->buffer = client_buffer_create(CLIENT_BUFFER_SIZE);
-    if (!client->buffer) {
-        close(fd);
-        return -1;
-    }
-
-    client->header_sent = false;
-    client->connected_time = time(NULL);
-    client->frames_sent = 0;
-
-    list->count++;
-    list->total_clients_served++;
-
-    fprintf(stderr, "[CLIENT] New connection from %s:%d (total: %d)\n",
-            inet_ntoa(addr->sin_addr), ntohs(addr->sin_port), list->count);
-
-    return list->count - 1;
-}
-
-static void client_list_remove(client_list_t *list, int idx) {
-    if (idx < 0 || idx >= list->count) return;
-
-    client_t *client = &list->clients[idx];
-
-    fprintf(stderr, "[CLIENT] Disconnecting %s:%d (sent: %llu bytes, %llu frames)\n",
-            inet_ntoa(client->addr.sin_addr), ntohs(client->addr.sin_port),
-            (unsigned long long)client->buffer->bytes_sent,
-            (unsigned long long)client->frames_sent);
-
-    close(client->fd);
-    client_buffer_destroy(client->buffer);
-
-    /* Shift remaining clients */
-    for (int i = idx; i < list->count - 1; i++) {
-        list->clients[i] = list->clients[i + 1];
-    }
-    list->count--;
-}
-
-static void client_list_broadcast(client_list_t *list, const uint8_t *data, size_t len) {
-    for (int i = 0; i < list->count; i++) {
-        client_buffer_write(list->clients[i].buffer, data, len);
-    }
-    list->total_bytes_relayed += len;
-}
-
-static void client_list_send_pending(client_list_t *list) {
-    for (int i = list->count - 1; i >= 0; i--) {
-        client_t *client = &list->clients[i];
-
-        /* Send header if not sent yet */
-        if (!client->header_sent) {
-            ssize_t sent = send(client->fd, &list->stream_header, sizeof(list->stream_header), MSG_NOSIGNAL);
-            if (sent == sizeof(list->stream_header)) {
-                client->header_sent = true;
-            } else if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
-                client_list_remove(list, i);
-                continue;
-            }
-        }
-
-        /* Send buffered data */
-        if (client->buffer->count > 0) {
-            uint8_t chunk[8192];
-            size_t to_send = (client->buffer->count < sizeof(chunk)) ? client->buffer->count : sizeof(chunk);
-            size_t read_count = client_buffer_read(client->buffer, chunk, to_send);
-
-            ssize_t sent = send(client->fd, chunk, read_count, MSG_NOSIGNAL);
-            if (sent < 0) {
-                if (errno != EAGAIN && errno != EWOULDBLOCK) {
-                    client_list_remove(list, i);
-                    continue;
-                } else {
-                    /* Put data back in buffer */
-                    client_buffer_write(client->buffer, chunk, read_count);
-                }
-            } else if (sent < (ssize_t)read_count) {
-                /* Partial send - put remainder back */
-                client_buffer_write(client->buffer, chunk + sent, read_count - sent);
-            }
-        }
-    }
-}
+#define PENDING_FDS         RELAY_FANOUT_PENDING_MAX
 
 /*============================================================================
  * Global State
@@ -270,9 +76,8 @@ static int g_detector_source_fd = -1;
 static int g_display_source_fd = -1;
 static int g_control_source_fd = -1;  /* signal_splitter connection */
 static int g_control_client_fd = -1;  /* remote client connection */
-static client_list_t g_detector_clients;
-static client_list_t g_display_clients;
-static client_list_t g_display_clients;
+static relay_fanout_t *g_detector_stream;
+static relay_fanout_t *g_display_stream;
 static time_t g_start_time;
 static time_t g_last_status_time;
 
@@ -331,37 +136,29 @@ static void set_nonblocking(int fd) {
 }
 
 /*============================================================================
- * Stream Source Handling
+ * Stream Connections
  *============================================================================*/
 
-static bool handle_source_connection(int *source_fd, int listen_fd, const char *stream_name) {
-    struct sockaddr_in addr;
-    socklen_t addr_len = sizeof(addr);
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)(ts.tv_nsec / 1000000);
+}
 
-    int fd = accept(listen_fd, (struct sockaddr*)&addr, &addr_len);
-    if (fd < 0) {
-        if (errno != EAGAIN && errno != EWOULDBLOCK) {
-            perror("accept");
+/* Sort new connections into sources and clients; a new source replaces the old one */
+static void service_pending(relay_fanout_t *rf, int *source_fd, const char *stream_name) {
+    int fd;
+    while ((fd = relay_fanout_service_pending(rf)) >= 0) {
+        if (*source_fd >= 0) {
+            fprintf(stderr, "[SOURCE-%s] Replacing previous source\n", stream_name);
+            close(*source_fd);
         }
-        return false;
-    }
-
-    /* If we already have a source, close the old one */
-    if (*source_fd >= 0) {
-        fprintf(stderr, "[SOURCE-%s] Replacing connection from %s:%d\n",
-                stream_name, inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
-        close(*source_fd);
-    } else {
-        fprintf(stderr, "[SOURCE-%s] New connection from %s:%d\n",
-                stream_name, inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
+        *source_fd = fd;
+        relay_fanout_reset(rf);
     }
-
-    set_nonblocking(fd);
-    *source_fd = fd;
-    return true;
 }
 
-static bool receive_and_relay(int source_fd, client_list_t *clients, const char *stream_name) {
+static bool receive_and_relay(int source_fd, relay_fanout_t *rf, const char *stream_name) {
     uint8_t buffer[65536];
     ssize_t received = recv(source_fd, buffer, sizeof(buffer), 0);
 
@@ -378,8 +175,8 @@ static bool receive_and_relay(int source_fd, client_list_t *clients, const char
         return false;
     }
 
-    /* Broadcast to all clients */
-    client_list_broadcast(clients, buffer, received);
+    /* Frame, encode and queue for clients */
+    relay_fanout_feed(rf, buffer, received);
 
     return true;
 }
@@ -431,6 +228,7 @@ static void forward_control_data(int from_fd, int to_fd, const char *label) {
  * Status Reporting
  *============================================================================*/
 
+
 static void print_status(void) {
     time_t now = time(NULL);
     if (now - g_last_status_time < STATUS_INTERVAL_SEC) return;
@@ -440,23 +238,46 @@ static void print_status(void) {
 
     fprintf(stderr, "\n[STATUS] Uptime: %ld sec\n", (long)uptime);
 
-    fprintf(stderr, "[STATUS] Detector: source=%s clients=%d (total_served=%llu)\n",
-            g_detector_source_fd >= 0 ? "UP" : "DOWN",
-            g_detector_clients.count,
-            (unsigned long long)g_detector_clients.total_clients_served);
-
-    fprintf(stderr, "[STATUS]   Relayed: %llu bytes, %llu frames\n",
-            (unsigned long long)g_detector_clients.total_bytes_relayed,
-            (unsigned long long)g_detector_clients.total_frames_relayed);
+    relay_fanout_t *ms[2] = { g_detector_stream, g_display_stream };
+    const char *ms_name[2] = { "Detector", "Display" };
+    int source_fd[2] = { g_detector_source_fd, g_display_source_fd };
+    relay_fanout_stats_t st[2];
+
+    for (int i = 0; i < 2; i++) {
+        relay_fanout_get_stats(ms[i], &st[i]);
+        fprintf(stderr, "[STATUS] %s: source=%s clients=%d (total_served=%llu)\n",
+                ms_name[i], source_fd[i] >= 0 ? "UP" : "DOWN",
+                st[i].clients, (unsigned long long)st[i].clients_served);
+        fprintf(stderr, "[STATUS]   Relayed: %llu bytes, %llu frames\n",
+                (unsigned long long)st[i].bytes_in, (unsigned long long)st[i].frames);
+    }
 
-    fprintf(stderr, "[STATUS] Display: source=%s clients=%d (total_served=%llu)\n",
-            g_display_source_fd >= 0 ? "UP" : "DOWN",
-            g_display_clients.count,
-            (unsigned long long)g_display_clients.total_clients_served);
+    /* Bandwidth vs. quality per encoding, SNR measured on the latest frame */
+    for (int i = 0; i < 2; i++) {
+        for (int e = 0; e < IQ_ENC_COUNT; e++) {
+            if (st[i].enc_bytes[e] == 0) continue;
+            iq_enc_quality_t q;
+            char snr[32] = "-";
+            if (relay_fanout_measure(ms[i], (iq_encoding_t)e, &q)) {
+                if (isinf(q.snr_db)) snprintf(snr, sizeof(snr), "lossless");
+                else snprintf(snr, sizeof(snr), "%.1f dB SNR", q.snr_db);
+            }
+            fprintf(stderr, "[STATUS]   %s %-4s: %d clients, %llu bytes (%.0f%% of f32), %s\n",
+                    ms_name[i], iq_enc_name((iq_encoding_t)e), st[i].enc_clients[e],
+                    (unsigned long long)st[i].enc_bytes[e],
+                    100.0 * (double)st[i].enc_bytes[e] / (double)st[i].enc_f32_bytes[e], snr);
+        }
+    }
 
-    fprintf(stderr, "[STATUS]   Relayed: %llu bytes, %llu frames\n",
-            (unsigned long long)g_display_clients.total_bytes_relayed,
-            (unsigned long long)g_display_clients.total_frames_relayed);
+    for (int i = 0; i < 2; i++) {
+        relay_mcast_tx_stats_t mst;
+        if (!relay_fanout_mcast_stats(ms[i], &mst)) continue;
+        fprintf(stderr, "[STATUS] Multicast %s: %llu frames, %llu data + %llu parity packets, "
+                "%llu errors, %llu resyncs\n", ms_name[i],
+                (unsigned long long)mst.frames, (unsigned long long)mst.data_packets,
+                (unsigned long long)mst.parity_packets, (unsigned long long)mst.send_errors,
+                (unsigned long long)st[i].resyncs);
+    }
 
     fprintf(stderr, "[STATUS] Control: source=%s client=%s\n",
             g_control_source_fd >= 0 ? "UP" : "DOWN",
@@ -470,6 +291,7 @@ static void print_status(void) {
 static void run(void) {
     fd_set readfds;
     struct timeval tv;
+    uint64_t last_beacon_ms = 0;
 
     while (g_running) {
         FD_ZERO(&readfds);
@@ -501,6 +323,17 @@ static void run(void) {
             if (g_control_client_fd > max_fd) max_fd = g_control_client_fd;
         }
 
+        /* New stream connections waiting to identify themselves */
+        relay_fanout_t *streams[2] = { g_detector_stream, g_display_stream };
+        for (int s = 0; s < 2; s++) {
+            int pending[PENDING_FDS];
+            int n = relay_fanout_pending_fds(streams[s], pending, PENDING_FDS);
+            for (int i = 0; i < n; i++) {
+                FD_SET(pending[i], &readfds);
+                if (pending[i] > max_fd) max_fd = pending[i];
+            }
+        }
+
         /* Select with 100ms timeout */
         tv.tv_sec = 0;
         tv.tv_usec = 100000;
@@ -513,13 +346,15 @@ static void run(void) {
             break;
         }
 
-        /* Accept new source connections */
+        /* Accept new stream connections, then sort them into sources and clients */
         if (FD_ISSET(g_detector_listen_fd, &readfds)) {
-            handle_source_connection(&g_detector_source_fd, g_detector_listen_fd, "DETECTOR");
+            relay_fanout_accept(g_detector_stream, g_detector_listen_fd);
         }
         if (FD_ISSET(g_display_listen_fd, &readfds)) {
-            handle_source_connection(&g_display_source_fd, g_display_listen_fd, "DISPLAY");
+            relay_fanout_accept(g_display_stream, g_display_listen_fd);
         }
+        service_pending(g_detector_stream, &g_detector_source_fd, "DETECTOR");
+        service_pending(g_display_stream, &g_display_source_fd, "DISPLAY");
 
         /* Accept control connections */
         if (FD_ISSET(g_control_listen_fd, &readfds)) {
@@ -550,13 +385,13 @@ static void run(void) {
 
         /* Receive from sources and relay */
         if (g_detector_source_fd >= 0 && FD_ISSET(g_detector_source_fd, &readfds)) {
-            if (!receive_and_relay(g_detector_source_fd, &g_detector_clients, "DETECTOR")) {
+            if (!receive_and_relay(g_detector_source_fd, g_detector_stream, "DETECTOR")) {
                 close(g_detector_source_fd);
                 g_detector_source_fd = -1;
             }
         }
         if (g_display_source_fd >= 0 && FD_ISSET(g_display_source_fd, &readfds)) {
-            if (!receive_and_relay(g_display_source_fd, &g_display_clients, "DISPLAY")) {
+            if (!receive_and_relay(g_display_source_fd, g_display_stream, "DISPLAY")) {
                 close(g_display_source_fd);
                 g_display_source_fd = -1;
             }
@@ -566,45 +401,104 @@ static void run(void) {
         if (g_control_source_fd >= 0 && g_control_client_fd >= 0) {
             /* Client → Source (commands from remote user to SDR) */
             if (FD_ISSET(g_control_client_fd, &readfds)) {
-                forward_control_data(g_control_client_fd, g_control_source_fd,
-                                     &g_control_client_fd, "CLIENT→SOURCE");
+                forward_control_data(g_control_client_fd, g_control_source_fd, "CLIENT→SOURCE");
             }
             /* Source → Client (responses from SDR to remote user) */
             if (FD_ISSET(g_control_source_fd, &readfds)) {
-                forward_control_data(g_control_source_fd, g_control_client_fd,
-                                     &g_control_source_fd, "SOURCE→CLIENT");
+                forward_control_data(g_control_source_fd, g_control_client_fd, "SOURCE→CLIENT");
             }
         }
 
         /* Send pending data to clients */
-        client_list_send_pending(&g_detector_clients);
-        client_list_send_pending(&g_display_clients);
+        relay_fanout_send(g_detector_stream);
+        relay_fanout_send(g_display_stream);
+
+        /* Multicast beacon (stream header for late joiners, liveness) */
+        uint64_t now = now_ms();
+        if (now - last_beacon_ms >= RELAY_MCAST_BEACON_MS) {
+            relay_fanout_beacon(g_detector_stream);
+            relay_fanout_beacon(g_display_stream);
+            last_beacon_ms = now;
+        }
 
         /* Status reporting */
         print_status();
     }
 }
 
+
 /*============================================================================
  * Main
  *============================================================================*/
 
+static void print_usage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  --multicast [GROUP[:PORT]]  Also send both streams to a UDP multicast group\n");
+    printf("                              (default %s:%d, display on PORT+1)\n",
+           RELAY_MCAST_GROUP, RELAY_MCAST_PORT);
+    printf("  --mcast-if ADDR             Local interface address to send from\n");
+    printf("  --mcast-ttl N               Multicast TTL (default: %d)\n", RELAY_MCAST_TTL);
+    printf("  --fec N                     Data packets per parity packet, power of 2,\n");
+    printf("                              0 = off (default: %d)\n", RELAY_MCAST_FEC_GROUP);
+    printf("  -h, --help                  Show this help\n");
+}
+
 int main(int argc, char *argv[]) {
-    (void)argc;
-    (void)argv;
+    bool mcast = false;
+    char mcast_group[64] = RELAY_MCAST_GROUP;
+    int mcast_port = RELAY_MCAST_PORT;
+    const char *mcast_if = NULL;
+    int mcast_ttl = RELAY_MCAST_TTL;
+    int fec = RELAY_MCAST_FEC_GROUP;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--multicast") == 0) {
+            mcast = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                strncpy(mcast_group, argv[++i], sizeof(mcast_group) - 1);
+                char *colon = strchr(mcast_group, ':');
+                if (colon) {
+                    *colon = '\0';
+                    mcast_port = atoi(colon + 1);
+                }
+            }
+        } else if (strcmp(argv[i], "--mcast-if") == 0 && i + 1 < argc) {
+            mcast_if = argv[++i];
+        } else if (strcmp(argv[i], "--mcast-ttl") == 0 && i + 1 < argc) {
+            mcast_ttl = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--fec") == 0 && i + 1 < argc) {
+            fec = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
 
     printf("Phoenix SDR Signal Relay\n");
     printf("Detector stream: port %d (50 kHz float32 I/Q)\n", DETECTOR_PORT);
     printf("Display stream:  port %d (12 kHz float32 I/Q)\n", DISPLAY_PORT);
-    printf("Control relay:   port %d (text commands)\n\n", CONTROL_PORT);
+    printf("Control relay:   port %d (text commands)\n", CONTROL_PORT);
+    if (mcast) {
+        printf("Multicast:       %s:%d / %d (float32 I/Q datagrams)\n",
+               mcast_group, mcast_port, mcast_port + 1);
+    }
+    printf("\n");
 
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
     signal(SIGPIPE, SIG_IGN);  /* Ignore broken pipe */
 
-    /* Initialize client lists */
-    client_list_init(&g_detector_clients, 50000);
-    client_list_init(&g_display_clients, 12000);
+    /* Initialize stream fan-outs */
+    g_detector_stream = relay_fanout_create("DETECTOR", 50000);
+    g_display_stream = relay_fanout_create("DISPLAY", 12000);
+    if (!g_detector_stream || !g_display_stream) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
 
     /* Create listen sockets */
     g_detector_listen_fd = create_listen_socket(DETECTOR_PORT);
@@ -620,6 +514,13 @@ int main(int argc, char *argv[]) {
     set_nonblocking(g_display_listen_fd);
     set_nonblocking(g_control_listen_fd);
 
+    if (mcast) {
+        if (!relay_fanout_open_mcast(g_detector_stream, mcast_group, mcast_port, mcast_if, mcast_ttl, fec) ||
+            !relay_fanout_open_mcast(g_display_stream, mcast_group, mcast_port + 1, mcast_if, mcast_ttl, fec)) {
+            return 1;
+        }
+    }
+
     g_start_time = time(NULL);
     g_last_status_time = g_start_time;
 
@@ -640,14 +541,8 @@ int main(int argc, char *argv[]) {
     close(g_display_listen_fd);
     close(g_control_listen_fd);
 
-    for (int i = 0; i < g_detector_clients.count; i++) {
-        close(g_detector_clients.clients[i].fd);
-        client_buffer_destroy(g_detector_clients.clients[i].buffer);
-    }
-    for (int i = 0; i < g_display_clients.count; i++) {
-        close(g_display_clients.clients[i].fd);
-        client_buffer_destroy(g_display_clients.clients[i].buffer);
-    }
+    relay_fanout_destroy(g_detector_stream);
+    relay_fanout_destroy(g_display_stream);
 
     fprintf(stderr, "[SHUTDOWN] Done.\n");
     return 0;
@@ -3,17 +3,26 @@
  * @brief Split 2 MHz I/Q from SDR server into detector (50kHz) and display (12kHz) paths
  *
  * Architecture:
- *   TCP Client → sdr_server:4536 (receives 2 MHz I/Q)
+ *   iq_client → sdr_server:4536 (receives 2 MHz I/Q)
  *   ↓
- *   Signal Divergence (exact copy of waterfall.c divergence)
+ *   In-band event markers (stream version 2): rescale gain steps, blank overload
+ *   ↓
+ *   --blank: impulse noise blanker at 2 MHz (noise_blanker.h)
+ *   ↓
+ *   Signal Divergence (split_stage.c, exact copy of waterfall.c divergence)
  *   ├─ Detector Path: 5kHz lowpass → decimate 40:1 → 50kHz
  *   └─ Display Path:  5kHz lowpass → decimate 166:1 → 12kHz
  *   ↓
  *   TCP Client → relay_server:4410 (detector stream, float32 I/Q)
  *   TCP Client → relay_server:4411 (display stream, float32 I/Q)
+ *   (--encoding s16|s8|ulaw sends a compact encoding instead, see iq_encoding.h)
+ *
+ * Built with -DPHOENIX_FIXED_POINT (build.ps1 -FixedPoint) both paths run
+ * the Q15 front end from dsp_q15.h instead: CIC + Q15 FIR, no floating
+ * point per input sample, for receive nodes without a fast FPU.
  *
  * Connection Tolerance:
- *   - sdr_server disconnect: stop processing, retry every 5 sec
+ *   - sdr_server disconnect: stop processing, iq_client retries with backoff
  *   - relay disconnect: buffer to ring (30 sec), retry every 5 sec
  *   - Graceful shutdown on SIGINT/SIGTERM
  *   - Status reporting every 5 seconds
@@ -28,7 +37,13 @@
 #include <signal.h>
 #include <time.h>
 
-#include "waterfall_dsp.h"
+#ifdef PHOENIX_FIXED_POINT
+#include "dsp_q15.h"
+#endif
+#include "split_stage.h"
+#include "iq_events.h"
+#include "iq_client.h"
+#include "iq_encoding.h"
 #include "version.h"
 
 #ifdef _WIN32
@@ -63,28 +78,7 @@ typedef int socket_t;
  * Protocol Definitions
  *============================================================================*/
 
-/* SDR Server Protocol (MAGIC_IQDQ from sdr_server.c) */
-#define MAGIC_PHXI  0x50485849  /* "PHXI" - Stream header */
-#define MAGIC_IQDQ  0x49514451  /* "IQDQ" - Data frame */
-#define MAGIC_META  0x4D455441  /* "META" - Metadata */
-
-typedef struct {
-    uint32_t magic;           /* 0x50485849 = "PHXI" */
-    uint32_t version;         /* Protocol version (1) */
-    uint32_t sample_rate;     /* Hz (e.g., 2000000) */
-    uint32_t sample_format;   /* 1=S16, 2=F32, 3=U8 */
-    uint32_t center_freq_lo;  /* Low 32 bits of freq */
-    uint32_t center_freq_hi;  /* High 32 bits of freq */
-    uint32_t gain_reduction;  /* dB */
-    uint32_t lna_state;       /* 0-8 */
-} iq_stream_header_t;
-
-typedef struct {
-    uint32_t magic;           /* 0x49514451 = "IQDQ" */
-    uint32_t sequence;        /* Frame counter */
-    uint32_t num_samples;     /* I/Q pairs in frame */
-    uint32_t flags;           /* Status flags */
-} iq_data_frame_t;
+/* SDR Server Protocol (PHXI / IQDQ / META): parsed by iq_client */
 
 /* Relay Server Protocol (float32 streams) */
 #define MAGIC_FT32  0x46543332  /* "FT32" - Float32 stream header */
@@ -111,15 +105,14 @@ typedef struct {
 #define SDR_SAMPLE_RATE         2000000     /* 2 MHz from SDR */
 #define DETECTOR_SAMPLE_RATE    50000       /* 50 kHz detector path */
 #define DISPLAY_SAMPLE_RATE     12000       /* 12 kHz display path */
-#define DETECTOR_DECIMATION     40          /* 2MHz / 50kHz */
-#define DISPLAY_DECIMATION      166         /* 2MHz / 12kHz (approx) */
-#define FILTER_CUTOFF           5000.0f     /* 5 kHz lowpass */
 
+#define SDR_FRAME_MAX           SPLIT_MAX_BLOCK /* Largest IQDQ frame accepted */
 #define RELAY_FRAME_SIZE        2048        /* Samples per relay frame */
 #define DETECTOR_BUFFER_SIZE    (50000 * 30)  /* 30 sec @ 50kHz = 1.5M samples */
 #define DISPLAY_BUFFER_SIZE     (12000 * 30)  /* 30 sec @ 12kHz = 360k samples */
 
 #define RECONNECT_DELAY_MS      5000        /* 5 seconds between reconnect attempts */
+#define SDR_POLL_MS             100         /* Longest wait for SDR data per loop */
 #define STATUS_INTERVAL_MS      5000        /* 5 seconds between status reports */
 
 #define DEFAULT_SDR_HOST        "localhost"
@@ -204,11 +197,13 @@ static volatile bool g_running = true;
 static volatile bool g_shutdown_requested = false;
 
 /* SDR connection */
-static socket_t g_sdr_socket = SOCKET_INVALID;
+static iq_client_t *g_sdr_client = NULL;
 static char g_sdr_host[256] = DEFAULT_SDR_HOST;
 static int g_sdr_port = DEFAULT_SDR_PORT;
 static bool g_sdr_connected = false;
 static uint32_t g_sdr_sample_rate = SDR_SAMPLE_RATE;
+static bool g_sdr_events = false;           /* Server sends in-band event markers */
+static iq_conditioner_t g_conditioner;
 
 /* Relay connections */
 static socket_t g_relay_det_socket = SOCKET_INVALID;
@@ -229,13 +224,12 @@ static int g_relay_ctrl_port = DEFAULT_RELAY_CTRL_PORT;
 static bool g_sdr_ctrl_connected = false;
 static bool g_relay_ctrl_connected = false;
 
-/* DSP State - exact copy of waterfall.c */
-static wf_lowpass_t g_detector_lowpass_i;
-static wf_lowpass_t g_detector_lowpass_q;
-static wf_lowpass_t g_display_lowpass_i;
-static wf_lowpass_t g_display_lowpass_q;
-static int g_detector_decim_counter = 0;
-static int g_display_decim_counter = 0;
+/* DSP State - divergence lives in split_stage.c (shared with sdr_pipeline) */
+static split_stage_t *g_split = NULL;
+static float g_split_det[SPLIT_DETECTOR_OUT_MAX * 2];
+static float g_split_disp[SPLIT_DISPLAY_OUT_MAX * 2];
+static bool g_blank = false;
+static float g_blank_threshold = NB_DEFAULT_THRESHOLD;
 
 /* Ring buffers for relay disconnect tolerance */
 static ring_buffer_t *g_detector_ring = NULL;
@@ -244,6 +238,8 @@ static ring_buffer_t *g_display_ring = NULL;
 /* Relay output buffers */
 static float g_detector_frame[RELAY_FRAME_SIZE * 2];  /* I/Q pairs */
 static float g_display_frame[RELAY_FRAME_SIZE * 2];
+static iq_encoding_t g_relay_encoding = IQ_ENC_F32;
+static uint8_t g_encoded_frame[RELAY_FRAME_SIZE * 2 * sizeof(float)];
 static int g_detector_frame_idx = 0;
 static int g_display_frame_idx = 0;
 
@@ -316,16 +312,6 @@ static socket_t tcp_connect(const char *host, int port) {
     return sock;
 }
 
-static bool tcp_recv_exact(socket_t sock, void *buf, size_t len) {
-    size_t total = 0;
-    while (total < len) {
-        int n = recv(sock, (char*)buf + total, (int)(len - total), 0);
-        if (n <= 0) return false;
-        total += n;
-    }
-    return true;
-}
-
 static bool tcp_send_exact(socket_t sock, const void *buf, size_t len) {
     size_t total = 0;
     while (total < len) {
@@ -340,49 +326,18 @@ static bool tcp_send_exact(socket_t sock, const void *buf, size_t len) {
  * SDR Connection
  *============================================================================*/
 
-static bool connect_to_sdr(void) {
-    if (g_sdr_connected) return true;
+static void on_sdr_connected(void) {
+    const iq_client_stream_t *st = iq_client_stream(g_sdr_client);
 
-    fprintf(stderr, "[SDR] Connecting to %s:%d...\n", g_sdr_host, g_sdr_port);
+    g_sdr_sample_rate = st->sample_rate;
+    g_sdr_events = st->events;
+    iq_conditioner_init(&g_conditioner, st->sample_rate);
 
-    g_sdr_socket = tcp_connect(g_sdr_host, g_sdr_port);
-    if (g_sdr_socket == SOCKET_INVALID) {
-        fprintf(stderr, "[SDR] Connection failed\n");
-        return false;
-    }
-
-    /* Receive stream header */
-    iq_stream_header_t header;
-    if (!tcp_recv_exact(g_sdr_socket, &header, sizeof(header))) {
-        fprintf(stderr, "[SDR] Failed to receive header\n");
-        socket_close(g_sdr_socket);
-        g_sdr_socket = SOCKET_INVALID;
-        return false;
-    }
-
-    if (header.magic != MAGIC_PHXI) {
-        fprintf(stderr, "[SDR] Invalid header magic: 0x%08X\n", header.magic);
-        socket_close(g_sdr_socket);
-        g_sdr_socket = SOCKET_INVALID;
-        return false;
-    }
-
-    g_sdr_sample_rate = header.sample_rate;
-
-    fprintf(stderr, "[SDR] Connected: %u Hz, format=%u, freq=%llu Hz\n",
-            header.sample_rate, header.sample_format,
-            ((uint64_t)header.center_freq_hi << 32) | header.center_freq_lo);
+    fprintf(stderr, "[SDR] Connected: %u Hz, format=%u, freq=%llu Hz%s\n",
+            st->sample_rate, st->sample_format, (unsigned long long)st->center_freq,
+            g_sdr_events ? ", event markers" : "");
 
     g_sdr_connected = true;
-    return true;
-}
-
-static void disconnect_from_sdr(void) {
-    if (g_sdr_socket != SOCKET_INVALID) {
-        socket_close(g_sdr_socket);
-        g_sdr_socket = SOCKET_INVALID;
-    }
-    g_sdr_connected = false;
 }
 
 /*============================================================================
@@ -404,7 +359,7 @@ static bool connect_to_relay_detector(void) {
     relay_stream_header_t header = {
         .magic = MAGIC_FT32,
         .sample_rate = DETECTOR_SAMPLE_RATE,
-        .reserved1 = 0,
+        .reserved1 = (uint32_t)g_relay_encoding,
         .reserved2 = 0
     };
 
@@ -415,7 +370,7 @@ static bool connect_to_relay_detector(void) {
         return false;
     }
 
-    fprintf(stderr, "[RELAY-DET] Connected: %u Hz float32 I/Q\n", DETECTOR_SAMPLE_RATE);
+    fprintf(stderr, "[RELAY-DET] Connected: %u Hz %s I/Q\n", DETECTOR_SAMPLE_RATE, iq_enc_name(g_relay_encoding));
     g_relay_det_connected = true;
     g_relay_det_sequence = 0;
     return true;
@@ -436,7 +391,7 @@ static bool connect_to_relay_display(void) {
     relay_stream_header_t header = {
         .magic = MAGIC_FT32,
         .sample_rate = DISPLAY_SAMPLE_RATE,
-        .reserved1 = 0,
+        .reserved1 = (uint32_t)g_relay_encoding,
         .reserved2 = 0
     };
 
@@ -447,7 +402,7 @@ static bool connect_to_relay_display(void) {
         return false;
     }
 
-    fprintf(stderr, "[RELAY-DISP] Connected: %u Hz float32 I/Q\n", DISPLAY_SAMPLE_RATE);
+    fprintf(stderr, "[RELAY-DISP] Connected: %u Hz %s I/Q\n", DISPLAY_SAMPLE_RATE, iq_enc_name(g_relay_encoding));
     g_relay_disp_connected = true;
     g_relay_disp_sequence = 0;
     return true;
@@ -543,6 +498,19 @@ static void forward_control_data(socket_t from_sock, socket_t to_sock, const cha
  * Relay Frame Transmission
  *============================================================================*/
 
+/* Encode a frame for the relay link; F32 goes out as-is */
+static const void *encode_relay_frame(const float *frame, size_t num_samples, relay_data_frame_t *hdr,
+                                      size_t *data_len) {
+    if (g_relay_encoding == IQ_ENC_F32) {
+        *data_len = num_samples * 2 * sizeof(float);
+        return frame;
+    }
+    float scale;
+    *data_len = iq_enc_encode(g_relay_encoding, frame, (uint32_t)num_samples, g_encoded_frame, &scale);
+    memcpy(&hdr->reserved, &scale, sizeof(scale));
+    return g_encoded_frame;
+}
+
 static bool send_detector_frame(void) {
     if (!g_relay_det_connected || g_detector_frame_idx == 0) return true;
 
@@ -553,6 +521,9 @@ static bool send_detector_frame(void) {
         .reserved = 0
     };
 
+    size_t data_len;
+    const void *payload = encode_relay_frame(g_detector_frame, g_detector_frame_idx, &frame_hdr, &data_len);
+
     /* Send frame header */
     if (!tcp_send_exact(g_relay_det_socket, &frame_hdr, sizeof(frame_hdr))) {
         fprintf(stderr, "[RELAY-DET] Send failed, disconnecting\n");
@@ -562,9 +533,8 @@ static bool send_detector_frame(void) {
         return false;
     }
 
-    /* Send float32 I/Q data */
-    size_t data_len = g_detector_frame_idx * 2 * sizeof(float);
-    if (!tcp_send_exact(g_relay_det_socket, g_detector_frame, data_len)) {
+    /* Send I/Q data */
+    if (!tcp_send_exact(g_relay_det_socket, payload, data_len)) {
         fprintf(stderr, "[RELAY-DET] Send failed, disconnecting\n");
         socket_close(g_relay_det_socket);
         g_relay_det_socket = SOCKET_INVALID;
@@ -587,6 +557,9 @@ static bool send_display_frame(void) {
         .reserved = 0
     };
 
+    size_t data_len;
+    const void *payload = encode_relay_frame(g_display_frame, g_display_frame_idx, &frame_hdr, &data_len);
+
     /* Send frame header */
     if (!tcp_send_exact(g_relay_disp_socket, &frame_hdr, sizeof(frame_hdr))) {
         fprintf(stderr, "[RELAY-DISP] Send failed, disconnecting\n");
@@ -596,9 +569,8 @@ static bool send_display_frame(void) {
         return false;
     }
 
-    /* Send float32 I/Q data */
-    size_t data_len = g_display_frame_idx * 2 * sizeof(float);
-    if (!tcp_send_exact(g_relay_disp_socket, g_display_frame, data_len)) {
+    /* Send I/Q data */
+    if (!tcp_send_exact(g_relay_disp_socket, payload, data_len)) {
         fprintf(stderr, "[RELAY-DISP] Send failed, disconnecting\n");
         socket_close(g_relay_disp_socket);
         g_relay_disp_socket = SOCKET_INVALID;
@@ -688,37 +660,30 @@ static void output_display_sample(float i, float q) {
 }
 
 /*============================================================================
- * Signal Processing (exact copy from waterfall.c:2151-2238)
+ * Signal Processing (divergence in split_stage.c)
  *============================================================================*/
 
-static void process_iq_samples(const int16_t *samples, uint32_t num_samples) {
-    for (uint32_t s = 0; s < num_samples; s++) {
-        /* Normalize to [-1, 1] (exact copy of waterfall.c) */
-        float i_raw = (float)samples[s * 2] / 32768.0f;
-        float q_raw = (float)samples[s * 2 + 1] / 32768.0f;
-
-        g_samples_received++;
-
-        /* ===== DETECTOR PATH (50 kHz) ===== */
-        float det_i = wf_lowpass_process(&g_detector_lowpass_i, i_raw);
-        float det_q = wf_lowpass_process(&g_detector_lowpass_q, q_raw);
-
-        g_detector_decim_counter++;
-        if (g_detector_decim_counter >= DETECTOR_DECIMATION) {
-            g_detector_decim_counter = 0;
-            output_detector_sample(det_i, det_q);
-        }
+static void output_split(const split_output_t *out) {
+    for (size_t k = 0; k < out->n_det; k++) {
+        output_detector_sample(out->det[k * 2], out->det[k * 2 + 1]);
+    }
+    for (size_t k = 0; k < out->n_disp; k++) {
+        output_display_sample(out->disp[k * 2], out->disp[k * 2 + 1]);
+    }
+}
 
-        /* ===== DISPLAY PATH (12 kHz) ===== */
-        float disp_i = wf_lowpass_process(&g_display_lowpass_i, i_raw);
-        float disp_q = wf_lowpass_process(&g_display_lowpass_q, q_raw);
+static void process_iq_samples(const float *samples, uint32_t num_samples) {
+    split_output_t out = { g_split_det, 0, g_split_disp, 0 };
+    g_samples_received += num_samples;
+    split_stage_process(g_split, samples, num_samples, &out);
+    output_split(&out);
+}
 
-        g_display_decim_counter++;
-        if (g_display_decim_counter >= DISPLAY_DECIMATION) {
-            g_display_decim_counter = 0;
-            output_display_sample(disp_i, disp_q);
-        }
-    }
+static void process_iq_s16(const int16_t *iq, uint32_t num_samples) {
+    split_output_t out = { g_split_det, 0, g_split_disp, 0 };
+    g_samples_received += num_samples;
+    split_stage_process_s16(g_split, iq, num_samples, &out);
+    output_split(&out);
 }
 
 /*============================================================================
@@ -742,6 +707,21 @@ static void print_status(void) {
             (unsigned long long)g_detector_samples_sent,
             (unsigned long long)g_display_samples_sent);
 
+    if (g_sdr_events && g_conditioner.events > 0) {
+        fprintf(stderr, "[STATUS] Events: %llu, blanked=%llu, gain comp=%.2f dB\n",
+                (unsigned long long)g_conditioner.events,
+                (unsigned long long)g_conditioner.samples_blanked,
+                -g_conditioner.gain_offset_cdb / 100.0f);
+    }
+
+    noise_blanker_stats_t nb;
+    if (split_stage_blanker_stats(g_split, &nb)) {
+        fprintf(stderr, "[STATUS] Blanker: %llu pairs blanked (%.3f%%) in %llu impulses, level %u\n",
+                (unsigned long long)nb.blanked,
+                nb.pairs > 0 ? 100.0 * (double)nb.blanked / (double)nb.pairs : 0.0,
+                (unsigned long long)nb.impulses, nb.level);
+    }
+
     size_t det_buffered = ring_buffer_available(g_detector_ring);
     size_t disp_buffered = ring_buffer_available(g_display_ring);
 
@@ -770,26 +750,17 @@ static void print_status(void) {
 
 static void run(void) {
     time_t last_reconnect = 0;
-    int16_t *sample_buffer = (int16_t*)malloc(8192 * 2 * sizeof(int16_t));
-    if (!sample_buffer) {
+    float *float_buffer = (float*)malloc(SDR_FRAME_MAX * 2 * sizeof(float));
+    if (!float_buffer) {
         fprintf(stderr, "Failed to allocate sample buffer\n");
         return;
     }
 
+    fprintf(stderr, "[SDR] Connecting to %s:%d...\n", g_sdr_host, g_sdr_port);
+
     while (g_running) {
         time_t now = time(NULL);
 
-        /* Try to connect/reconnect */
-        if (!g_sdr_connected && (now - last_reconnect >= (RECONNECT_DELAY_MS / 1000))) {
-            if (connect_to_sdr()) {
-                last_reconnect = now;
-            } else {
-                last_reconnect = now;
-                Sleep(1000);
-                continue;
-            }
-        }
-
         if (!g_relay_det_connected && strlen(g_relay_host) > 0 &&
             (now - last_reconnect >= (RECONNECT_DELAY_MS / 1000))) {
             connect_to_relay_detector();
@@ -823,38 +794,76 @@ static void run(void) {
             forward_control_data(g_sdr_ctrl_socket, g_relay_ctrl_socket, "SDR->RELAY");
         }
 
-        /* Receive and process data from SDR */
-        if (g_sdr_connected) {
-            iq_data_frame_t frame;
-            if (!tcp_recv_exact(g_sdr_socket, &frame, sizeof(frame))) {
-                fprintf(stderr, "[SDR] Connection lost\n");
-                disconnect_from_sdr();
-                continue;
-            }
+        /* Receive and process data from SDR (iq_client reconnects with backoff) */
+        iq_client_frame_t frame;
+        switch (iq_client_next(g_sdr_client, &frame, SDR_POLL_MS)) {
+            case IQ_CLIENT_CONNECTED:
+                on_sdr_connected();
+                break;
+
+            case IQ_CLIENT_DISCONNECTED:
+                fprintf(stderr, g_sdr_connected ? "[SDR] Connection lost\n" : "[SDR] Connection failed\n");
+                g_sdr_connected = false;
+                break;
+
+            case IQ_CLIENT_META:
+                fprintf(stderr, "[SDR] Metadata update: rate=%u, freq=%llu Hz\n",
+                        iq_client_stream(g_sdr_client)->sample_rate,
+                        (unsigned long long)iq_client_stream(g_sdr_client)->center_freq);
+                break;
+
+            case IQ_CLIENT_FRAME: {
+                if (frame.num_samples > SDR_FRAME_MAX) {
+                    fprintf(stderr, "[SDR] Frame too large: %u samples\n", frame.num_samples);
+                    iq_client_disconnect(g_sdr_client);
+                    g_sdr_connected = false;
+                    break;
+                }
+                if (frame.frames_lost > 0) {
+                    fprintf(stderr, "[SDR] %u frames lost before seq %u\n",
+                            frame.frames_lost, frame.sequence);
+                }
 
-            if (frame.magic != MAGIC_IQDQ) {
-                fprintf(stderr, "[SDR] Invalid frame magic: 0x%08X\n", frame.magic);
-                disconnect_from_sdr();
-                continue;
-            }
+                /* Normalize to [-1, 1] (exact copy of waterfall.c), straight
+                 * from the client's receive buffer */
+                uint32_t n = frame.num_samples * 2;
+                uint32_t format = iq_client_stream(g_sdr_client)->sample_format;
+                /* Unconditioned S16 goes to the split stage as received (the
+                 * Q15 front end takes it without a float round trip) */
+                if (format == IQ_CLIENT_FORMAT_S16 && !g_sdr_events) {
+                    process_iq_s16((const int16_t *)frame.samples, frame.num_samples);
+                    break;
+                }
+                if (format == IQ_CLIENT_FORMAT_S16) {
+                    const int16_t *smp = (const int16_t *)frame.samples;
+                    for (uint32_t s = 0; s < n; s++) float_buffer[s] = (float)smp[s] / 32768.0f;
+                } else if (format == IQ_CLIENT_FORMAT_F32) {
+                    memcpy(float_buffer, frame.samples, n * sizeof(float));
+                } else {
+                    const uint8_t *smp = (const uint8_t *)frame.samples;
+                    for (uint32_t s = 0; s < n; s++) float_buffer[s] = (float)(smp[s] - 128) / 128.0f;
+                }
+
+                /* Undo gain steps and blank overload at the exact samples */
+                if (g_sdr_events) {
+                    iq_conditioner_apply(&g_conditioner, float_buffer, NULL,
+                                         frame.num_samples, frame.events, frame.n_events);
+                }
 
-            /* Receive sample data */
-            size_t sample_bytes = frame.num_samples * 2 * sizeof(int16_t);
-            if (!tcp_recv_exact(g_sdr_socket, sample_buffer, sample_bytes)) {
-                fprintf(stderr, "[SDR] Failed to receive samples\n");
-                disconnect_from_sdr();
-                continue;
+                /* Process samples */
+                process_iq_samples(float_buffer, frame.num_samples);
+                break;
             }
 
-            /* Process samples */
-            process_iq_samples(sample_buffer, frame.num_samples);
+            default:
+                break;
         }
 
         /* Print status */
         print_status();
     }
 
-    free(sample_buffer);
+    free(float_buffer);
 
     /* Flush remaining frames on shutdown */
     if (g_shutdown_requested) {
@@ -879,6 +888,9 @@ static void print_usage(const char *prog) {
     printf("  --relay-det PORT       Relay detector port (default: %d)\n", DEFAULT_RELAY_PORT_DET);
     printf("  --relay-disp PORT      Relay display port (default: %d)\n", DEFAULT_RELAY_PORT_DISP);
     printf("  --relay-ctrl PORT      Relay control port (default: %d)\n", DEFAULT_RELAY_CTRL_PORT);
+    printf("  --encoding ENC         Relay link encoding: f32, s16, s8, ulaw (default: f32)\n");
+    printf("  --blank                Blank impulses at 2 MHz before the split\n");
+    printf("  --blank-threshold K    Trigger at K x average |x| (default: %g)\n", NB_DEFAULT_THRESHOLD);
     printf("  -h, --help             Show this help\n\n");
     printf("Streams:\n");
     printf("  Input:  SDR server @ HOST:PORT (2 MHz I/Q, int16)\n");
@@ -903,6 +915,17 @@ int main(int argc, char *argv[]) {
             g_relay_det_port = atoi(argv[++i]);
         } else if (strcmp(argv[i], "--relay-disp") == 0 && i + 1 < argc) {
             g_relay_disp_port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--encoding") == 0 && i + 1 < argc) {
+            if (!iq_enc_parse(argv[++i], &g_relay_encoding)) {
+                fprintf(stderr, "Unknown encoding: %s\n\n", argv[i]);
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--blank") == 0) {
+            g_blank = true;
+        } else if (strcmp(argv[i], "--blank-threshold") == 0 && i + 1 < argc) {
+            g_blank = true;
+            g_blank_threshold = (float)atof(argv[++i]);
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             print_usage(argv[0]);
             return 0;
@@ -921,8 +944,8 @@ int main(int argc, char *argv[]) {
 
     fprintf(stderr, "Signal Splitter Configuration:\n");
     fprintf(stderr, "  SDR:     %s:%d\n", g_sdr_host, g_sdr_port);
-    fprintf(stderr, "  Relay:   %s:%d (detector), %s:%d (display)\n",
-            g_relay_host, g_relay_det_port, g_relay_host, g_relay_disp_port);
+    fprintf(stderr, "  Relay:   %s:%d (detector), %s:%d (display), %s samples\n",
+            g_relay_host, g_relay_det_port, g_relay_host, g_relay_disp_port, iq_enc_name(g_relay_encoding));
     fprintf(stderr, "  Buffers: Detector=%d sec, Display=%d sec\n\n",
             DETECTOR_BUFFER_SIZE / DETECTOR_SAMPLE_RATE,
             DISPLAY_BUFFER_SIZE / DISPLAY_SAMPLE_RATE);
@@ -938,11 +961,37 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    /* Initialize DSP (exact copy of waterfall.c initialization) */
-    wf_lowpass_init(&g_detector_lowpass_i, FILTER_CUTOFF, (float)SDR_SAMPLE_RATE);
-    wf_lowpass_init(&g_detector_lowpass_q, FILTER_CUTOFF, (float)SDR_SAMPLE_RATE);
-    wf_lowpass_init(&g_display_lowpass_i, FILTER_CUTOFF, (float)SDR_SAMPLE_RATE);
-    wf_lowpass_init(&g_display_lowpass_q, FILTER_CUTOFF, (float)SDR_SAMPLE_RATE);
+    g_sdr_client = iq_client_create(g_sdr_host, g_sdr_port, IQ_CLIENT_PROTO_PHXI);
+    if (!g_sdr_client) {
+        fprintf(stderr, "Failed to create SDR client\n");
+        return 1;
+    }
+
+    g_split = split_stage_create();
+    if (!g_split) {
+        fprintf(stderr, "Failed to create split stage\n");
+        return 1;
+    }
+    if (g_blank) {
+        noise_blanker_config_t nb_cfg;
+        noise_blanker_default_config(&nb_cfg, (float)SDR_SAMPLE_RATE);
+        nb_cfg.threshold = g_blank_threshold;
+        if (!split_stage_set_blanker(g_split, &nb_cfg)) {
+            fprintf(stderr, "Bad blanker threshold: %g\n", g_blank_threshold);
+            return 1;
+        }
+        fprintf(stderr, "[STARTUP] Noise blanker: %g x average |x|, %g us look-ahead, %g us hang\n",
+                g_blank_threshold, nb_cfg.lookahead_us, nb_cfg.hang_us);
+    }
+#ifdef PHOENIX_FIXED_POINT
+    q15_frontend_config_t fe_cfg;
+    q15_frontend_default_config(&fe_cfg, SDR_SAMPLE_RATE, DETECTOR_SAMPLE_RATE);
+    fprintf(stderr, "[STARTUP] Q15 detector path: CIC %d x%d, FIR %d taps / %d\n",
+            fe_cfg.cic_decimation, fe_cfg.cic_order, fe_cfg.fir_taps, fe_cfg.fir_decimation);
+    q15_frontend_default_config(&fe_cfg, SDR_SAMPLE_RATE, DISPLAY_SAMPLE_RATE);
+    fprintf(stderr, "[STARTUP] Q15 display path:  CIC %d x%d, FIR %d taps / %d\n",
+            fe_cfg.cic_decimation, fe_cfg.cic_order, fe_cfg.fir_taps, fe_cfg.fir_decimation);
+#endif
 
     /* Create ring buffers */
     g_detector_ring = ring_buffer_create(DETECTOR_BUFFER_SIZE);
@@ -960,11 +1009,12 @@ int main(int argc, char *argv[]) {
 
     /* Cleanup */
     fprintf(stderr, "\n[SHUTDOWN] Closing connections...\n");
-    disconnect_from_sdr();
+    iq_client_destroy(g_sdr_client);
     disconnect_from_relay();
     disconnect_from_control();
     ring_buffer_destroy(g_detector_ring);
     ring_buffer_destroy(g_display_ring);
+    split_stage_destroy(g_split);
     tcp_cleanup();
 
     fprintf(stderr, "[SHUTDOWN] Done.\n");
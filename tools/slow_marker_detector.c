@@ -10,7 +10,6 @@
 #include <stdio.h>
 #include <math.h>
 
-#define HZ_PER_BIN      ((float)SLOW_MARKER_SAMPLE_RATE / SLOW_MARKER_FFT_SIZE)  /* 5.86 Hz */
 #define FRAME_MS        85.0f   /* Effective frame rate with 50% overlap */
 
 /* Threshold: accumulated energy must be 2x noise (10-frame sum) */
@@ -18,6 +17,12 @@
 #define NOISE_ADAPT_RATE        0.02f
 
 struct slow_marker_detector {
+    /* Spectrum layout of the caller's FFT (fixed at create) */
+    int fft_size;
+    float hz_per_bin;           /* 5.86 Hz at 12 kHz / 2048 */
+    int center_bin;             /* bin 170 at defaults */
+    int bin_span;               /* ±8 bins at defaults */
+
     /* Accumulator ring buffer */
     float energy_history[SLOW_MARKER_ACCUM_FRAMES];
     int history_idx;
@@ -40,14 +45,30 @@ struct slow_marker_detector {
 };
 
 slow_marker_detector_t *slow_marker_detector_create(void) {
+    return slow_marker_detector_create_rate(SLOW_MARKER_SAMPLE_RATE, SLOW_MARKER_FFT_SIZE);
+}
+
+slow_marker_detector_t *slow_marker_detector_create_rate(int sample_rate, int fft_size) {
+    if (sample_rate <= 0 || fft_size < 64 || (fft_size & (fft_size - 1)) != 0) return NULL;
+
     slow_marker_detector_t *smd = calloc(1, sizeof(*smd));
     if (!smd) return NULL;
 
+    smd->fft_size = fft_size;
+    smd->hz_per_bin = (float)sample_rate / fft_size;
+    smd->center_bin = (int)(SLOW_MARKER_TARGET_HZ / smd->hz_per_bin + 0.5f);
+    smd->bin_span = (int)(SLOW_MARKER_BANDWIDTH_HZ / 2.0f / smd->hz_per_bin + 0.5f);
+    if (smd->bin_span < 1) smd->bin_span = 1;
+    if (smd->center_bin + 3 * smd->bin_span >= fft_size / 2) {
+        free(smd);
+        return NULL;
+    }
+
     smd->noise_floor = 0.01f;
     smd->threshold = smd->noise_floor * SLOW_THRESHOLD_MULT * SLOW_MARKER_ACCUM_FRAMES;
 
     printf("[SLOW_MARKER] Created: %.1f Hz/bin, %d-frame accumulator (%.0fms)\n",
-           HZ_PER_BIN, SLOW_MARKER_ACCUM_FRAMES, SLOW_MARKER_ACCUM_FRAMES * FRAME_MS);
+           smd->hz_per_bin, SLOW_MARKER_ACCUM_FRAMES, SLOW_MARKER_ACCUM_FRAMES * FRAME_MS);
 
     return smd;
 }
@@ -62,8 +83,9 @@ void slow_marker_detector_process_fft(slow_marker_detector_t *smd,
     if (!smd || !fft_out) return;
 
     /* Extract tight 1000 Hz bucket energy */
-    int center_bin = (int)(SLOW_MARKER_TARGET_HZ / HZ_PER_BIN + 0.5f);  /* bin 170 */
-    int bin_span = (int)(SLOW_MARKER_BANDWIDTH_HZ / 2.0f / HZ_PER_BIN + 0.5f);  /* ±8 bins */
+    const int center_bin = smd->center_bin;
+    const int bin_span = smd->bin_span;
+    const int fft_size = smd->fft_size;
 
     float signal_energy = 0.0f;
     float noise_energy = 0.0f;
@@ -72,29 +94,29 @@ void slow_marker_detector_process_fft(slow_marker_detector_t *smd,
     /* Signal bucket: 950-1050 Hz */
     for (int b = -bin_span; b <= bin_span; b++) {
         int bin = center_bin + b;
-        if (bin >= 0 && bin < SLOW_MARKER_FFT_SIZE / 2) {
+        if (bin >= 0 && bin < fft_size / 2) {
             float re = fft_out[bin].r;
             float im = fft_out[bin].i;
-            signal_energy += sqrtf(re * re + im * im) / SLOW_MARKER_FFT_SIZE;
+            signal_energy += sqrtf(re * re + im * im) / fft_size;
         }
     }
 
     /* Noise estimate from adjacent buckets (800-900 Hz and 1100-1200 Hz) */
     for (int offset = -3; offset <= -2; offset++) {  /* Below signal */
         int bin = center_bin + offset * bin_span;
-        if (bin >= 0 && bin < SLOW_MARKER_FFT_SIZE / 2) {
+        if (bin >= 0 && bin < fft_size / 2) {
             float re = fft_out[bin].r;
             float im = fft_out[bin].i;
-            noise_energy += sqrtf(re * re + im * im) / SLOW_MARKER_FFT_SIZE;
+            noise_energy += sqrtf(re * re + im * im) / fft_size;
             noise_bins++;
         }
     }
     for (int offset = 2; offset <= 3; offset++) {  /* Above signal */
         int bin = center_bin + offset * bin_span;
-        if (bin >= 0 && bin < SLOW_MARKER_FFT_SIZE / 2) {
+        if (bin >= 0 && bin < fft_size / 2) {
             float re = fft_out[bin].r;
             float im = fft_out[bin].i;
-            noise_energy += sqrtf(re * re + im * im) / SLOW_MARKER_FFT_SIZE;
+            noise_energy += sqrtf(re * re + im * im) / fft_size;
             noise_bins++;
         }
     }
@@ -21,7 +21,7 @@ extern "C" {
  * Configuration
  *============================================================================*/
 
-#define SLOW_MARKER_SAMPLE_RATE     12000       /* Display stream rate */
+#define SLOW_MARKER_SAMPLE_RATE     12000       /* Default: display stream rate */
 #define SLOW_MARKER_FFT_SIZE        2048        /* 5.86 Hz/bin resolution */
 #define SLOW_MARKER_TARGET_HZ       1000        /* Center frequency */
 #define SLOW_MARKER_BANDWIDTH_HZ    100         /* Tight ±50 Hz bucket */
@@ -48,6 +48,10 @@ typedef void (*slow_marker_callback_fn)(const slow_marker_frame_t *frame, void *
  *============================================================================*/
 
 slow_marker_detector_t *slow_marker_detector_create(void);
+
+/* For a spectrum from another stream: bins derived from the caller's FFT.
+ * NULL if fft_size is not a power of two or the noise buckets don't fit. */
+slow_marker_detector_t *slow_marker_detector_create_rate(int sample_rate, int fft_size);
 void slow_marker_detector_destroy(slow_marker_detector_t *smd);
 
 /* Feed from display path (called every 85ms effective) */
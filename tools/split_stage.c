@@ -0,0 +1,168 @@
+/**
+ * @file split_stage.c
+ * @brief signal_splitter's divergence as a block stage
+ */
+
+#include "split_stage.h"
+#include "dsp_q15.h"
+#include <stdlib.h>
+
+#ifndef PHOENIX_FIXED_POINT
+#include "waterfall_dsp.h"
+#endif
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+struct split_stage {
+    noise_blanker_t *blanker;
+    int16_t blanked[SPLIT_MAX_BLOCK * 2];
+#ifdef PHOENIX_FIXED_POINT
+    q15_frontend_t *detector_fe;
+    q15_frontend_t *display_fe;
+    int16_t input[SPLIT_MAX_BLOCK * 2];
+    int16_t detector_out[SPLIT_DETECTOR_OUT_MAX * 2];
+    int16_t display_out[SPLIT_DISPLAY_OUT_MAX * 2];
+#else
+    wf_lowpass_t detector_lowpass_i;
+    wf_lowpass_t detector_lowpass_q;
+    wf_lowpass_t display_lowpass_i;
+    wf_lowpass_t display_lowpass_q;
+    int detector_decim_counter;
+    int display_decim_counter;
+    float input[SPLIT_MAX_BLOCK * 2];
+#endif
+};
+
+/*============================================================================
+ * Create / Destroy
+ *============================================================================*/
+
+split_stage_t *split_stage_create(void) {
+    split_stage_t *s = (split_stage_t *)calloc(1, sizeof(split_stage_t));
+    if (!s) return NULL;
+
+#ifdef PHOENIX_FIXED_POINT
+    q15_frontend_config_t cfg;
+    q15_frontend_default_config(&cfg, SPLIT_INPUT_RATE, SPLIT_DETECTOR_RATE);
+    s->detector_fe = q15_frontend_create(&cfg);
+    q15_frontend_default_config(&cfg, SPLIT_INPUT_RATE, SPLIT_DISPLAY_RATE);
+    s->display_fe = q15_frontend_create(&cfg);
+    if (!s->detector_fe || !s->display_fe) {
+        split_stage_destroy(s);
+        return NULL;
+    }
+#else
+    wf_lowpass_init(&s->detector_lowpass_i, SPLIT_FILTER_CUTOFF, (float)SPLIT_INPUT_RATE);
+    wf_lowpass_init(&s->detector_lowpass_q, SPLIT_FILTER_CUTOFF, (float)SPLIT_INPUT_RATE);
+    wf_lowpass_init(&s->display_lowpass_i, SPLIT_FILTER_CUTOFF, (float)SPLIT_INPUT_RATE);
+    wf_lowpass_init(&s->display_lowpass_q, SPLIT_FILTER_CUTOFF, (float)SPLIT_INPUT_RATE);
+#endif
+    return s;
+}
+
+void split_stage_destroy(split_stage_t *s) {
+    if (!s) return;
+    noise_blanker_destroy(s->blanker);
+#ifdef PHOENIX_FIXED_POINT
+    q15_frontend_destroy(s->detector_fe);
+    q15_frontend_destroy(s->display_fe);
+#endif
+    free(s);
+}
+
+bool split_stage_set_blanker(split_stage_t *s, const noise_blanker_config_t *cfg) {
+    noise_blanker_destroy(s->blanker);
+    s->blanker = cfg ? noise_blanker_create(cfg) : NULL;
+    return !cfg || s->blanker;
+}
+
+bool split_stage_blanker_stats(split_stage_t *s, noise_blanker_stats_t *stats) {
+    if (!s->blanker) return false;
+    noise_blanker_get_stats(s->blanker, stats);
+    return true;
+}
+
+/*============================================================================
+ * Processing
+ *============================================================================*/
+
+#ifdef PHOENIX_FIXED_POINT
+
+void split_stage_process_s16(split_stage_t *s, const int16_t *iq, uint32_t count, split_output_t *out) {
+    if (s->blanker) {
+        noise_blanker_process(s->blanker, iq, s->blanked, count);
+        iq = s->blanked;
+    }
+
+    size_t det = q15_frontend_process(s->detector_fe, iq, count, s->detector_out, SPLIT_DETECTOR_OUT_MAX);
+    for (size_t k = 0; k < det * 2; k++) out->det[k] = s->detector_out[k] / 32768.0f;
+    out->n_det = det;
+
+    size_t disp = q15_frontend_process(s->display_fe, iq, count, s->display_out, SPLIT_DISPLAY_OUT_MAX);
+    for (size_t k = 0; k < disp * 2; k++) out->disp[k] = s->display_out[k] / 32768.0f;
+    out->n_disp = disp;
+}
+
+void split_stage_process(split_stage_t *s, const float *iq, uint32_t count, split_output_t *out) {
+    q15_from_float(iq, s->input, (size_t)count * 2);
+    split_stage_process_s16(s, s->input, count, out);
+}
+
+#else
+
+static void split_float(split_stage_t *s, const float *iq, uint32_t count, split_output_t *out) {
+    size_t det = 0;
+    size_t disp = 0;
+
+    for (uint32_t n = 0; n < count; n++) {
+        float i_raw = iq[n * 2];
+        float q_raw = iq[n * 2 + 1];
+
+        /* ===== DETECTOR PATH (50 kHz) ===== */
+        float det_i = wf_lowpass_process(&s->detector_lowpass_i, i_raw);
+        float det_q = wf_lowpass_process(&s->detector_lowpass_q, q_raw);
+
+        if (++s->detector_decim_counter >= SPLIT_DETECTOR_DECIMATION) {
+            s->detector_decim_counter = 0;
+            out->det[det * 2] = det_i;
+            out->det[det * 2 + 1] = det_q;
+            det++;
+        }
+
+        /* ===== DISPLAY PATH (12 kHz) ===== */
+        float disp_i = wf_lowpass_process(&s->display_lowpass_i, i_raw);
+        float disp_q = wf_lowpass_process(&s->display_lowpass_q, q_raw);
+
+        if (++s->display_decim_counter >= SPLIT_DISPLAY_DECIMATION) {
+            s->display_decim_counter = 0;
+            out->disp[disp * 2] = disp_i;
+            out->disp[disp * 2 + 1] = disp_q;
+            disp++;
+        }
+    }
+
+    out->n_det = det;
+    out->n_disp = disp;
+}
+
+void split_stage_process_s16(split_stage_t *s, const int16_t *iq, uint32_t count, split_output_t *out) {
+    if (s->blanker) {
+        noise_blanker_process(s->blanker, iq, s->blanked, count);
+        iq = s->blanked;
+    }
+    for (uint32_t n = 0; n < count * 2; n++) s->input[n] = (float)iq[n] / 32768.0f;
+    split_float(s, s->input, count, out);
+}
+
+void split_stage_process(split_stage_t *s, const float *iq, uint32_t count, split_output_t *out) {
+    if (s->blanker) {
+        q15_from_float(iq, s->blanked, (size_t)count * 2);
+        split_stage_process_s16(s, s->blanked, count, out);
+        return;
+    }
+    split_float(s, iq, count, out);
+}
+
+#endif
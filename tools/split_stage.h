@@ -0,0 +1,97 @@
+/**
+ * @file split_stage.h
+ * @brief signal_splitter's divergence as a block stage: 2 MHz I/Q in,
+ *        detector (50 kHz) and display (12 kHz) I/Q out
+ *
+ * The same per-sample chain signal_splitter has always run (P1 in
+ * copilot-instructions.md), moved here so the splitter and the in-process
+ * pipeline share it:
+ *
+ *   Float build:          5 kHz Butterworth lowpass per path (waterfall_dsp),
+ *                         every 40th / 166th output kept
+ *   PHOENIX_FIXED_POINT:  a Q15 front end per path (dsp_q15.h)
+ *
+ * An optional impulse blanker (noise_blanker.h) runs on the 2 MHz input
+ * ahead of both paths; with it, float input is quantized to S16 first.
+ *
+ * Output is interleaved float I/Q normalized to +/-1. State carries across
+ * calls, so any block split of the input gives the same output.
+ *
+ * Threading: one thread per stage.
+ */
+
+#ifndef SPLIT_STAGE_H
+#define SPLIT_STAGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "noise_blanker.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define SPLIT_INPUT_RATE            2000000
+#define SPLIT_DETECTOR_RATE         50000
+#define SPLIT_DISPLAY_RATE          12000
+#define SPLIT_DETECTOR_DECIMATION   40          /* 2 MHz / 50 kHz */
+#define SPLIT_DISPLAY_DECIMATION    166         /* 2 MHz / 12 kHz (approx) */
+#define SPLIT_FILTER_CUTOFF         5000.0f     /* 5 kHz lowpass */
+
+#define SPLIT_MAX_BLOCK             8192        /* Input pairs per call */
+#define SPLIT_DETECTOR_OUT_MAX      (SPLIT_MAX_BLOCK / SPLIT_DETECTOR_DECIMATION + 1)
+#define SPLIT_DISPLAY_OUT_MAX       (SPLIT_MAX_BLOCK / SPLIT_DISPLAY_DECIMATION + 1)
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct split_stage split_stage_t;
+
+/** One call's output; det and disp hold *_OUT_MAX pairs */
+typedef struct {
+    float  *det;
+    size_t  n_det;
+    float  *disp;
+    size_t  n_disp;
+} split_output_t;
+
+/*============================================================================
+ * API
+ *============================================================================*/
+
+split_stage_t *split_stage_create(void);
+void split_stage_destroy(split_stage_t *s);
+
+/**
+ * @brief Blank impulses ahead of both paths, delaying them by the look-ahead
+ * @param cfg  NULL turns the blanker off
+ * @return     false if cfg is invalid (the blanker is then off)
+ */
+bool split_stage_set_blanker(split_stage_t *s, const noise_blanker_config_t *cfg);
+
+/** @return false if the blanker is off */
+bool split_stage_blanker_stats(split_stage_t *s, noise_blanker_stats_t *stats);
+
+/** Float I/Q normalized to +/-1, at most SPLIT_MAX_BLOCK pairs */
+void split_stage_process(split_stage_t *s, const float *iq, uint32_t count, split_output_t *out);
+
+/**
+ * @brief Raw S16 I/Q, at most SPLIT_MAX_BLOCK pairs
+ *
+ * Float build: scaled by 1/32768 as signal_splitter does. Fixed point:
+ * straight into the Q15 front ends.
+ */
+void split_stage_process_s16(split_stage_t *s, const int16_t *iq, uint32_t count, split_output_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPLIT_STAGE_H */
@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include "subcarrier_frontend.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -98,6 +99,17 @@ typedef void (*subcarrier_callback_fn)(const subcarrier_frame_t *frame, void *us
  */
 subcarrier_detector_t *subcarrier_detector_create(const char *csv_path);
 
+/**
+ * Create an instance that consumes blocks from a shared front end
+ * @param frontend  Front end fed by the caller (NULL = private, same as _create)
+ * @param csv_path  Path for CSV log file (NULL to disable logging)
+ *
+ * With a shared front end the process_sample calls are no-ops; feed the
+ * front end instead. Destroy this instance before the front end.
+ */
+subcarrier_detector_t *subcarrier_detector_create_shared(subcarrier_frontend_t *frontend,
+                                                         const char *csv_path);
+
 /**
  * Destroy a subcarrier detector instance
  */
@@ -125,7 +137,7 @@ void subcarrier_detector_process_sample(subcarrier_detector_t *det,
 
 /**
  * Alternative: Feed pre-decimated samples at 2.4 kHz
- * Use this if decimation happens elsewhere
+ * Use this if decimation happens elsewhere (private front end only)
  */
 void subcarrier_detector_process_sample_2400(subcarrier_detector_t *det,
                                              float i_sample, float q_sample);
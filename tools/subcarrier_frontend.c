@@ -0,0 +1,300 @@
+/**
+ * @file subcarrier_frontend.c
+ * @brief Shared 100 Hz BCD subcarrier front end implementation
+ *
+ * The filter, Goertzel and noise floor code moved here unchanged from
+ * bcd_envelope.c / subcarrier_detector.c, so consumers see the same numbers
+ * they computed on their own before.
+ */
+
+#include "subcarrier_frontend.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*============================================================================
+ * Internal State
+ *============================================================================*/
+
+typedef struct {
+    subcarrier_block_fn fn;
+    void *user_data;
+} subscriber_t;
+
+struct subcarrier_frontend {
+    /* Decimation (12 kHz -> 2.4 kHz) */
+    int decim_counter;
+
+    /* Anti-alias lowpass filter (applied at 12 kHz, before decimation)
+     * Cutoff 500 Hz rejects 1000 Hz tick energy that would otherwise
+     * alias into the 100 Hz detection bin when decimating to 2.4 kHz. */
+    float aa_lpf_i_x1, aa_lpf_i_x2;  /* I channel filter state */
+    float aa_lpf_i_y1, aa_lpf_i_y2;
+    float aa_lpf_q_x1, aa_lpf_q_x2;  /* Q channel filter state */
+    float aa_lpf_q_y1, aa_lpf_q_y2;
+    float aa_lpf_b0, aa_lpf_b1, aa_lpf_b2;  /* Filter coefficients (shared) */
+    float aa_lpf_a1, aa_lpf_a2;
+
+    /* DC blocker state (y[n] = x[n] - x[n-1] + alpha * y[n-1]) */
+    float dc_prev_in_i;
+    float dc_prev_in_q;
+    float dc_prev_out_i;
+    float dc_prev_out_q;
+
+    /* Goertzel state */
+    float goertzel_coeff;       /* 2 * cos(2*pi*k/N) */
+    float g_s1_i, g_s2_i;       /* I channel state */
+    float g_s1_q, g_s2_q;       /* Q channel state */
+    int block_index;            /* Sample counter within block */
+
+    /* Noise floor estimation (ring buffer of recent magnitudes) */
+    float mag_history[SUBCARRIER_FE_HISTORY];   /* ~2.5 seconds at 100 Hz update */
+    int mag_history_idx;
+    int mag_history_count;
+    float noise_floor;
+    float noise_floor_db;
+
+    uint64_t block_count;
+
+    subscriber_t subscribers[SUBCARRIER_FE_MAX_SUBSCRIBERS];
+    int num_subscribers;
+};
+
+/*============================================================================
+ * Anti-Alias Lowpass Filter
+ *============================================================================*/
+
+/**
+ * Initialize 2nd-order Butterworth lowpass filter coefficients
+ */
+static void aa_lpf_init(subcarrier_frontend_t *fe, float cutoff_hz, float sample_rate) {
+    float w0 = 2.0f * M_PI * cutoff_hz / sample_rate;
+    float alpha = sinf(w0) / (2.0f * 0.7071f);  /* Q = 0.7071 for Butterworth */
+    float cos_w0 = cosf(w0);
+
+    float a0 = 1.0f + alpha;
+    fe->aa_lpf_b0 = (1.0f - cos_w0) / 2.0f / a0;
+    fe->aa_lpf_b1 = (1.0f - cos_w0) / a0;
+    fe->aa_lpf_b2 = (1.0f - cos_w0) / 2.0f / a0;
+    fe->aa_lpf_a1 = -2.0f * cos_w0 / a0;
+    fe->aa_lpf_a2 = (1.0f - alpha) / a0;
+}
+
+static inline float aa_lpf_process_i(subcarrier_frontend_t *fe, float x) {
+    float y = fe->aa_lpf_b0 * x
+            + fe->aa_lpf_b1 * fe->aa_lpf_i_x1
+            + fe->aa_lpf_b2 * fe->aa_lpf_i_x2
+            - fe->aa_lpf_a1 * fe->aa_lpf_i_y1
+            - fe->aa_lpf_a2 * fe->aa_lpf_i_y2;
+    fe->aa_lpf_i_x2 = fe->aa_lpf_i_x1;
+    fe->aa_lpf_i_x1 = x;
+    fe->aa_lpf_i_y2 = fe->aa_lpf_i_y1;
+    fe->aa_lpf_i_y1 = y;
+    return y;
+}
+
+static inline float aa_lpf_process_q(subcarrier_frontend_t *fe, float x) {
+    float y = fe->aa_lpf_b0 * x
+            + fe->aa_lpf_b1 * fe->aa_lpf_q_x1
+            + fe->aa_lpf_b2 * fe->aa_lpf_q_x2
+            - fe->aa_lpf_a1 * fe->aa_lpf_q_y1
+            - fe->aa_lpf_a2 * fe->aa_lpf_q_y2;
+    fe->aa_lpf_q_x2 = fe->aa_lpf_q_x1;
+    fe->aa_lpf_q_x1 = x;
+    fe->aa_lpf_q_y2 = fe->aa_lpf_q_y1;
+    fe->aa_lpf_q_y1 = y;
+    return y;
+}
+
+/*============================================================================
+ * Goertzel Helpers
+ *
+ * Separate Goertzel filters on I and Q, magnitudes combined afterwards.
+ * A complex Goertzel would capture the +/-100 Hz phasor coherently; this
+ * is the path both consumers were tuned against, so it stays.
+ *============================================================================*/
+
+static float goertzel_init_coeff(int block_size, float target_freq, float sample_rate) {
+    float k = (block_size * target_freq) / sample_rate;
+    float omega = (2.0f * M_PI * k) / block_size;
+    return 2.0f * cosf(omega);
+}
+
+static inline void goertzel_process_sample(float sample, float coeff,
+                                           float *s1, float *s2) {
+    float s0 = sample + coeff * (*s1) - (*s2);
+    *s2 = *s1;
+    *s1 = s0;
+}
+
+static float goertzel_magnitude(float s1, float s2, float coeff) {
+    float mag_sq = s1*s1 + s2*s2 - coeff*s1*s2;
+    return sqrtf(mag_sq > 0 ? mag_sq : 0);
+}
+
+/*============================================================================
+ * DC Blocker
+ *============================================================================*/
+
+/**
+ * Single-pole DC blocker: y[n] = x[n] - x[n-1] + alpha * y[n-1]
+ * With alpha=0.995 at 2400 Hz: cutoff ~2 Hz
+ */
+static inline float dc_block(float input, float *prev_in, float *prev_out, float alpha) {
+    float output = input - *prev_in + alpha * (*prev_out);
+    *prev_in = input;
+    *prev_out = output;
+    return output;
+}
+
+/*============================================================================
+ * Noise Floor Estimation
+ *============================================================================*/
+
+/**
+ * Lower percentile of recent magnitudes, so signal energy stays out of the
+ * noise estimate
+ */
+static float estimate_noise_floor(subcarrier_frontend_t *fe) {
+    if (fe->mag_history_count < 10) {
+        return 1e-6f;  /* Not enough data yet */
+    }
+
+    /* Copy and sort (simple insertion sort for small N) */
+    float sorted[SUBCARRIER_FE_HISTORY];
+    int n = fe->mag_history_count;
+
+    memcpy(sorted, fe->mag_history, n * sizeof(float));
+
+    for (int i = 1; i < n; i++) {
+        float key = sorted[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > key) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = key;
+    }
+
+    int idx = (n * SUBCARRIER_FE_NOISE_PERCENTILE) / 100;
+    if (idx >= n) idx = n - 1;
+
+    return sorted[idx];
+}
+
+/*============================================================================
+ * Public API Implementation
+ *============================================================================*/
+
+subcarrier_frontend_t *subcarrier_frontend_create(void) {
+    subcarrier_frontend_t *fe = calloc(1, sizeof(subcarrier_frontend_t));
+    if (!fe) return NULL;
+
+    aa_lpf_init(fe, SUBCARRIER_FE_AA_CUTOFF_HZ, (float)SUBCARRIER_FE_INPUT_RATE);
+    fe->goertzel_coeff = goertzel_init_coeff(SUBCARRIER_FE_BLOCK_SIZE,
+                                              SUBCARRIER_FE_TARGET_FREQ_HZ,
+                                              SUBCARRIER_FE_SAMPLE_RATE);
+    fe->noise_floor = 1e-6f;
+    return fe;
+}
+
+void subcarrier_frontend_destroy(subcarrier_frontend_t *fe) {
+    free(fe);
+}
+
+bool subcarrier_frontend_subscribe(subcarrier_frontend_t *fe,
+                                   subcarrier_block_fn fn, void *user_data) {
+    if (!fe || !fn || fe->num_subscribers >= SUBCARRIER_FE_MAX_SUBSCRIBERS) return false;
+    fe->subscribers[fe->num_subscribers].fn = fn;
+    fe->subscribers[fe->num_subscribers].user_data = user_data;
+    fe->num_subscribers++;
+    return true;
+}
+
+void subcarrier_frontend_unsubscribe(subcarrier_frontend_t *fe,
+                                     subcarrier_block_fn fn, void *user_data) {
+    if (!fe) return;
+    for (int i = 0; i < fe->num_subscribers; i++) {
+        if (fe->subscribers[i].fn == fn && fe->subscribers[i].user_data == user_data) {
+            memmove(&fe->subscribers[i], &fe->subscribers[i + 1],
+                    (fe->num_subscribers - i - 1) * sizeof(subscriber_t));
+            fe->num_subscribers--;
+            return;
+        }
+    }
+}
+
+void subcarrier_frontend_process_sample(subcarrier_frontend_t *fe,
+                                        float i_sample, float q_sample) {
+    if (!fe) return;
+
+    /* Anti-alias filter BEFORE decimation (at 12 kHz rate) - without it
+     * 1000 Hz tick energy aliases into the 100 Hz bin */
+    float i_filtered = aa_lpf_process_i(fe, i_sample);
+    float q_filtered = aa_lpf_process_q(fe, q_sample);
+
+    /* Decimate: keep every 5th sample (12 kHz -> 2.4 kHz) */
+    fe->decim_counter++;
+    if (fe->decim_counter < SUBCARRIER_FE_DECIMATION) {
+        return;
+    }
+    fe->decim_counter = 0;
+
+    subcarrier_frontend_process_sample_2400(fe, i_filtered, q_filtered);
+}
+
+void subcarrier_frontend_process_sample_2400(subcarrier_frontend_t *fe,
+                                             float i_sample, float q_sample) {
+    if (!fe) return;
+
+    float i_blocked = dc_block(i_sample, &fe->dc_prev_in_i, &fe->dc_prev_out_i,
+                               SUBCARRIER_FE_DC_ALPHA);
+    float q_blocked = dc_block(q_sample, &fe->dc_prev_in_q, &fe->dc_prev_out_q,
+                               SUBCARRIER_FE_DC_ALPHA);
+
+    goertzel_process_sample(i_blocked, fe->goertzel_coeff, &fe->g_s1_i, &fe->g_s2_i);
+    goertzel_process_sample(q_blocked, fe->goertzel_coeff, &fe->g_s1_q, &fe->g_s2_q);
+
+    if (++fe->block_index < SUBCARRIER_FE_BLOCK_SIZE) return;
+
+    /* End of block */
+    fe->block_index = 0;
+    fe->block_count++;
+
+    float mag_i = goertzel_magnitude(fe->g_s1_i, fe->g_s2_i, fe->goertzel_coeff);
+    float mag_q = goertzel_magnitude(fe->g_s1_q, fe->g_s2_q, fe->goertzel_coeff);
+    float magnitude = sqrtf(mag_i * mag_i + mag_q * mag_q);
+
+    fe->g_s1_i = fe->g_s2_i = 0;
+    fe->g_s1_q = fe->g_s2_q = 0;
+
+    fe->mag_history[fe->mag_history_idx] = magnitude;
+    fe->mag_history_idx = (fe->mag_history_idx + 1) % SUBCARRIER_FE_HISTORY;
+    if (fe->mag_history_count < SUBCARRIER_FE_HISTORY) fe->mag_history_count++;
+
+    if ((fe->block_count % SUBCARRIER_FE_NOISE_INTERVAL) == 0) {
+        fe->noise_floor = estimate_noise_floor(fe);
+        fe->noise_floor_db = 20.0f * log10f(fe->noise_floor + 1e-10f);
+    }
+
+    subcarrier_block_t block = {
+        .block_count = fe->block_count,
+        .timestamp_ms = (float)fe->block_count * SUBCARRIER_FE_BLOCK_MS,
+        .mag_i = mag_i,
+        .mag_q = mag_q,
+        .magnitude = magnitude,
+        .noise_floor = fe->noise_floor,
+        .noise_floor_db = fe->noise_floor_db
+    };
+    for (int i = 0; i < fe->num_subscribers; i++) {
+        fe->subscribers[i].fn(&block, fe->subscribers[i].user_data);
+    }
+}
+
+uint64_t subcarrier_frontend_get_block_count(const subcarrier_frontend_t *fe) {
+    return fe ? fe->block_count : 0;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file subcarrier_frontend.h
+ * @brief Shared 100 Hz BCD subcarrier front end
+ *
+ * bcd_envelope and subcarrier_detector both need the same signal path:
+ *
+ *   12 kHz I/Q -> 500 Hz anti-alias LPF -> decimate by 5 -> 2400 Hz
+ *             -> DC blocker -> Goertzel at 100 Hz over 24-sample blocks
+ *             -> sorted-percentile noise floor over the last 256 blocks
+ *
+ * This object runs that path once and hands each completed 10 ms block to
+ * every subscriber. Consumers keep only their own smoothing, status and
+ * logging, so running both costs one front end instead of two.
+ *
+ * A consumer created without a front end gets a private one, so the
+ * single-consumer API is unchanged.
+ */
+
+#ifndef SUBCARRIER_FRONTEND_H
+#define SUBCARRIER_FRONTEND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define SUBCARRIER_FE_INPUT_RATE        12000   /* Display path rate */
+#define SUBCARRIER_FE_DECIMATION        5       /* 12 kHz -> 2.4 kHz */
+#define SUBCARRIER_FE_SAMPLE_RATE       2400
+#define SUBCARRIER_FE_AA_CUTOFF_HZ      500.0f  /* Rejects 500/600/1000 Hz tones */
+#define SUBCARRIER_FE_TARGET_FREQ_HZ    100
+#define SUBCARRIER_FE_BLOCK_SIZE        24      /* 10 ms at 2400 Hz */
+#define SUBCARRIER_FE_BLOCK_MS          10.0f
+#define SUBCARRIER_FE_DC_ALPHA          0.995f
+#define SUBCARRIER_FE_HISTORY           256     /* Magnitudes kept for noise floor */
+#define SUBCARRIER_FE_NOISE_PERCENTILE  10      /* Lower percentile for floor */
+#define SUBCARRIER_FE_NOISE_INTERVAL    10      /* Blocks between floor updates */
+#define SUBCARRIER_FE_MAX_SUBSCRIBERS   4
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct subcarrier_frontend subcarrier_frontend_t;
+
+/** One completed Goertzel block (every 10 ms) */
+typedef struct {
+    uint64_t block_count;       /* 1-based */
+    float timestamp_ms;         /* block_count * 10 ms */
+    float mag_i;                /* 100 Hz magnitude, I channel */
+    float mag_q;                /* 100 Hz magnitude, Q channel */
+    float magnitude;            /* sqrt(mag_i^2 + mag_q^2) */
+    float noise_floor;          /* Percentile floor (linear) */
+    float noise_floor_db;
+} subcarrier_block_t;
+
+typedef void (*subcarrier_block_fn)(const subcarrier_block_t *block, void *user_data);
+
+/*============================================================================
+ * Public API
+ *============================================================================*/
+
+subcarrier_frontend_t *subcarrier_frontend_create(void);
+void subcarrier_frontend_destroy(subcarrier_frontend_t *fe);
+
+/**
+ * Add a block consumer; blocks are delivered in subscription order
+ * @return false if the subscriber table is full
+ */
+bool subcarrier_frontend_subscribe(subcarrier_frontend_t *fe,
+                                   subcarrier_block_fn fn, void *user_data);
+
+/** Remove a consumer added with the same fn / user_data */
+void subcarrier_frontend_unsubscribe(subcarrier_frontend_t *fe,
+                                     subcarrier_block_fn fn, void *user_data);
+
+/** Feed one 12 kHz sample (filtered and decimated internally) */
+void subcarrier_frontend_process_sample(subcarrier_frontend_t *fe,
+                                        float i_sample, float q_sample);
+
+/** Feed one pre-decimated 2.4 kHz sample */
+void subcarrier_frontend_process_sample_2400(subcarrier_frontend_t *fe,
+                                             float i_sample, float q_sample);
+
+/** Blocks completed so far */
+uint64_t subcarrier_frontend_get_block_count(const subcarrier_frontend_t *fe);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SUBCARRIER_FRONTEND_H */
@@ -5,6 +5,10 @@
  * Groups consecutive ticks into correlation chains. A chain continues
  * as long as ticks arrive within 1050ms of each other. Tracks drift
  * from nominal 1000ms interval.
+ *
+ * Tick records and chain stats live in fixed rings, so a week-long run
+ * uses the same memory as the first hour. Chain interval statistics are
+ * updated incrementally (Welford) and never rescan history.
  */
 
 #include "tick_correlator.h"
@@ -15,34 +19,39 @@
 #include <stdio.h>
 #include <math.h>
 #include <time.h>
-
-/*============================================================================
- * Configuration
- *============================================================================*/
-
-#define MAX_CHAINS          1000    /* Max chains to track stats for */
-#define MAX_TICKS_STORED    10000   /* Max ticks to keep in memory */
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
 
 /*============================================================================
  * Internal State
  *============================================================================*/
 
+typedef struct {
+    chain_stats_t stats;
+    int interval_n;             /* Welford state for the interval stats */
+    double interval_mean;
+    double interval_m2;
+} chain_slot_t;
+
 struct tick_correlator {
-    /* Tick storage */
+    /* Tick storage (ring, newest record at tick_count - 1) */
     tick_record_t *ticks;
-    int tick_count;
+    int tick_count;             /* Total ticks seen */
     int tick_capacity;
 
-    /* Chain tracking */
-    chain_stats_t *chains;
+    /* Chain tracking (ring indexed by chain_id) */
+    chain_slot_t *chains;
     int chain_count;
     int chain_capacity;
 
     /* Current chain state */
     int current_chain_id;
     int current_chain_length;
-    float current_chain_start_ms;
-    float last_tick_ms;
+    double current_chain_start_ms;
+    double last_tick_ms;
     float cumulative_drift_ms;
 
     /* Overall stats */
@@ -52,6 +61,8 @@ struct tick_correlator {
 
     /* Logging */
     FILE *csv_file;
+    FILE *spill_file;
+    int ticks_spilled;
     time_t start_time;
 
     /* Epoch callback */
@@ -67,7 +78,7 @@ struct tick_correlator {
     struct {
         bool active;                    /* Tracking loop engaged */
         int retained_chain_id;          /* Chain to reattach to */
-        float predicted_next_ms;        /* When we expect next tick */
+        double predicted_next_ms;       /* When we expect next tick */
         float discipline_window_ms;     /* Acceptance window (4σ) */
         float last_std_dev_ms;          /* For discipline monitoring */
         int consecutive_misses;         /* Count prediction failures */
@@ -82,7 +93,51 @@ struct tick_correlator {
  * Internal Functions
  *============================================================================*/
 
-static void start_new_chain(tick_correlator_t *tc, float timestamp_ms) {
+/* Stats slot for a chain, or NULL once it has aged out of the ring */
+static chain_slot_t *find_chain(tick_correlator_t *tc, int chain_id) {
+    if (chain_id <= 0 || chain_id > tc->chain_count) return NULL;
+    chain_slot_t *slot = &tc->chains[(chain_id - 1) % tc->chain_capacity];
+    return (slot->stats.chain_id == chain_id) ? slot : NULL;
+}
+
+static int64_t get_unix_ms(void) {
+#ifdef _WIN32
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    uint64_t t = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+    return (int64_t)((t - 116444736000000000ULL) / 10000);  /* 100ns since 1601 -> ms since 1970 */
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+#endif
+}
+
+static void spill_record(tick_correlator_t *tc, const tick_record_t *tr) {
+    if (!tc->spill_file) return;
+
+    tick_spill_record_t rec;
+    rec.timestamp_ms = tr->timestamp_ms;
+    rec.wall_time_ms = tr->wall_time_ms;
+    rec.tick_num = tr->tick_num;
+    rec.energy_peak = tr->energy_peak;
+    rec.duration_ms = tr->duration_ms;
+    rec.interval_ms = tr->interval_ms;
+    rec.avg_interval_ms = tr->avg_interval_ms;
+    rec.noise_floor = tr->noise_floor;
+    rec.corr_peak = tr->corr_peak;
+    rec.corr_ratio = tr->corr_ratio;
+    rec.chain_id = tr->chain_id;
+    rec.chain_position = tr->chain_position;
+    rec.chain_start_ms = tr->chain_start_ms;
+    rec.drift_ms = tr->drift_ms;
+
+    if (fwrite(&rec, sizeof(rec), 1, tc->spill_file) == 1) {
+        tc->ticks_spilled++;
+    }
+}
+
+static void start_new_chain(tick_correlator_t *tc, double timestamp_ms) {
     tc->chain_count++;
     tc->current_chain_id = tc->chain_count;
     tc->current_chain_length = 0;
@@ -94,37 +149,38 @@ static void start_new_chain(tick_correlator_t *tc, float timestamp_ms) {
     tc->recent_interval_count = 0;
     memset(tc->recent_intervals, 0, sizeof(tc->recent_intervals));
 
-    /* Initialize chain stats */
-    if (tc->chain_count <= tc->chain_capacity) {
-        chain_stats_t *cs = &tc->chains[tc->chain_count - 1];
-        cs->chain_id = tc->current_chain_id;
-        cs->tick_count = 0;
-        cs->inferred_count = 0;
-        cs->start_ms = timestamp_ms;
-        cs->end_ms = timestamp_ms;
-        cs->total_drift_ms = 0.0f;
-        cs->avg_interval_ms = 0.0f;
-        cs->min_interval_ms = 99999.0f;
-        cs->max_interval_ms = 0.0f;
-    }
+    /* Initialize chain stats, reusing the oldest slot once the ring is full */
+    chain_slot_t *slot = &tc->chains[(tc->chain_count - 1) % tc->chain_capacity];
+    memset(slot, 0, sizeof(*slot));
+    chain_stats_t *cs = &slot->stats;
+    cs->chain_id = tc->current_chain_id;
+    cs->start_ms = timestamp_ms;
+    cs->end_ms = timestamp_ms;
+    cs->min_interval_ms = 99999.0f;
+    cs->max_interval_ms = 0.0f;
 }
 
-static void update_chain_stats(tick_correlator_t *tc, float interval_ms, float timestamp_ms) {
-    if (tc->current_chain_id <= 0 || tc->current_chain_id > tc->chain_capacity) return;
+static void update_chain_stats(tick_correlator_t *tc, float interval_ms, double timestamp_ms) {
+    chain_slot_t *slot = find_chain(tc, tc->current_chain_id);
+    if (!slot) return;
 
-    chain_stats_t *cs = &tc->chains[tc->current_chain_id - 1];
+    chain_stats_t *cs = &slot->stats;
     cs->tick_count = tc->current_chain_length;
     cs->end_ms = timestamp_ms;
     cs->total_drift_ms = tc->cumulative_drift_ms;
 
-    /* Update interval stats */
-    if (interval_ms > 0) {
+    /* Update interval stats - the first tick's interval is the gap before the chain */
+    if (interval_ms > 0 && tc->current_chain_length > 1) {
         if (interval_ms < cs->min_interval_ms) cs->min_interval_ms = interval_ms;
         if (interval_ms > cs->max_interval_ms) cs->max_interval_ms = interval_ms;
 
-        /* Running average */
-        float n = (float)cs->tick_count;
-        cs->avg_interval_ms = ((n - 1.0f) * cs->avg_interval_ms + interval_ms) / n;
+        /* Welford running mean/variance */
+        slot->interval_n++;
+        double delta = interval_ms - slot->interval_mean;
+        slot->interval_mean += delta / slot->interval_n;
+        slot->interval_m2 += delta * (interval_ms - slot->interval_mean);
+        cs->avg_interval_ms = (float)slot->interval_mean;
+        cs->std_interval_ms = (float)sqrt(slot->interval_m2 / slot->interval_n);
     }
 }
 
@@ -137,12 +193,12 @@ tick_correlator_t *tick_correlator_create(const char *csv_path) {
     if (!tc) return NULL;
 
     /* Allocate tick storage */
-    tc->tick_capacity = MAX_TICKS_STORED;
+    tc->tick_capacity = CORR_TICK_HISTORY;
     tc->ticks = (tick_record_t *)calloc(tc->tick_capacity, sizeof(tick_record_t));
 
     /* Allocate chain storage */
-    tc->chain_capacity = MAX_CHAINS;
-    tc->chains = (chain_stats_t *)calloc(tc->chain_capacity, sizeof(chain_stats_t));
+    tc->chain_capacity = CORR_CHAIN_HISTORY;
+    tc->chains = (chain_slot_t *)calloc(tc->chain_capacity, sizeof(chain_slot_t));
 
     if (!tc->ticks || !tc->chains) {
         tick_correlator_destroy(tc);
@@ -150,7 +206,7 @@ tick_correlator_t *tick_correlator_create(const char *csv_path) {
     }
 
     tc->start_time = time(NULL);
-    tc->last_tick_ms = -99999.0f;  /* Force new chain on first tick */
+    tc->last_tick_ms = -99999.0;   /* Force new chain on first tick */
 
     /* Initialize epoch callback */
     tc->epoch_callback = NULL;
@@ -162,7 +218,7 @@ tick_correlator_t *tick_correlator_create(const char *csv_path) {
     /* Initialize prediction tracking state */
     tc->tracking.active = false;
     tc->tracking.retained_chain_id = 0;
-    tc->tracking.predicted_next_ms = 0.0f;
+    tc->tracking.predicted_next_ms = 0.0;
     tc->tracking.discipline_window_ms = 0.0f;
     tc->tracking.last_std_dev_ms = 0.0f;
     tc->tracking.consecutive_misses = 0;
@@ -201,6 +257,14 @@ void tick_correlator_destroy(tick_correlator_t *tc) {
     if (!tc) return;
 
     if (tc->csv_file) fclose(tc->csv_file);
+    if (tc->spill_file) {
+        /* Flush what is still in the ring so the log holds every tick */
+        int first = (tc->tick_count > tc->tick_capacity) ? tc->tick_count - tc->tick_capacity : 0;
+        for (int i = first; i < tc->tick_count; i++) {
+            spill_record(tc, &tc->ticks[i % tc->tick_capacity]);
+        }
+        fclose(tc->spill_file);
+    }
     free(tc->ticks);
     free(tc->chains);
     free(tc);
@@ -208,7 +272,7 @@ void tick_correlator_destroy(tick_correlator_t *tc) {
 
 void tick_correlator_add_tick(tick_correlator_t *tc,
                               const char *time_str,
-                              float timestamp_ms,
+                              double timestamp_ms,
                               int tick_num,
                               const char *expected,
                               float energy_peak,
@@ -220,14 +284,14 @@ void tick_correlator_add_tick(tick_correlator_t *tc,
                               float corr_ratio) {
     if (!tc) return;
 
-    /* Calculate interval from last tick */
-    float actual_interval = timestamp_ms - tc->last_tick_ms;
+    /* Interval from last tick: subtract in double, then the interval fits a float */
+    float actual_interval = (float)(timestamp_ms - tc->last_tick_ms);
 
     /* Prediction-based tracking: check if tick matches prediction from established discipline */
     bool prediction_match = false;
     if (tc->tracking.active && tc->last_tick_ms > 0) {
-        float predicted_next = tc->last_tick_ms + CORR_NOMINAL_INTERVAL;
-        float prediction_error = fabsf(timestamp_ms - predicted_next);
+        double predicted_next = tc->last_tick_ms + CORR_NOMINAL_INTERVAL;
+        float prediction_error = (float)fabs(timestamp_ms - predicted_next);
 
         /* Require BOTH timestamp AND interval discipline:
          * - Timestamp within discipline window (±10ms typical)
@@ -284,9 +348,8 @@ void tick_correlator_add_tick(tick_correlator_t *tc,
         drift_this_tick = (actual_interval - 2000.0f) / 2.0f;
         tc->total_correlated++;
         /* Increment inferred count for this chain */
-        if (tc->current_chain_id > 0 && tc->current_chain_id <= tc->chain_capacity) {
-            tc->chains[tc->current_chain_id - 1].inferred_count++;
-        }
+        chain_slot_t *slot = find_chain(tc, tc->current_chain_id);
+        if (slot) slot->stats.inferred_count++;
     } else if (tc->current_chain_id == 0) {
         /* First tick or after uncorrelated - start new chain */
         start_new_chain(tc, timestamp_ms);
@@ -323,16 +386,19 @@ void tick_correlator_add_tick(tick_correlator_t *tc,
     /* Calculate epoch when we have 4+ correlated intervals (5+ ticks in chain)
      * NOTE: 5 ticks = 4 intervals, sufficient for std_dev calculation */
     if (tc->current_chain_length >= 5 && tc->recent_interval_count >= 4 && tc->epoch_callback) {
-        /* Calculate std_dev from recent intervals */
+        /* Calculate std_dev from recent intervals (two-pass: sum_sq - mean^2
+         * cancels badly in float around 1000ms) */
         float sum = 0, sum_sq = 0;
         int n = tc->recent_interval_count;
         for (int i = 0; i < n; i++) {
             sum += tc->recent_intervals[i];
-            sum_sq += tc->recent_intervals[i] * tc->recent_intervals[i];
         }
         float mean = sum / n;
-        float variance = (sum_sq / n) - (mean * mean);
-        float std_dev_ms = sqrtf(variance > 0 ? variance : 0);
+        for (int i = 0; i < n; i++) {
+            float d = tc->recent_intervals[i] - mean;
+            sum_sq += d * d;
+        }
+        float std_dev_ms = sqrtf(sum_sq / n);
 
         /* Calculate confidence (1.0 when std_dev=0, 0.0 when std_dev≥50ms) */
         float confidence = 1.0f - (std_dev_ms / 50.0f);
@@ -359,7 +425,7 @@ void tick_correlator_add_tick(tick_correlator_t *tc,
 
         /* Only call if confidence is reasonable (std_dev < 10ms) */
         if (confidence > tc->epoch_confidence_threshold) {
-            float epoch_offset_ms = fmodf(timestamp_ms, 1000.0f);
+            float epoch_offset_ms = (float)fmod(timestamp_ms, 1000.0);
             if (epoch_offset_ms < 0) epoch_offset_ms += 1000.0f;
             tc->epoch_callback(epoch_offset_ms, std_dev_ms, confidence, tc->epoch_callback_user_data);
 
@@ -376,11 +442,14 @@ void tick_correlator_add_tick(tick_correlator_t *tc,
         }
     }
 
-    /* Store tick record */
-    if (tc->tick_count < tc->tick_capacity) {
-        tick_record_t *tr = &tc->ticks[tc->tick_count];
+    /* Store tick record, spilling the one it replaces */
+    {
+        tick_record_t *tr = &tc->ticks[tc->tick_count % tc->tick_capacity];
+        if (tc->tick_count >= tc->tick_capacity) spill_record(tc, tr);
+        memset(tr, 0, sizeof(*tr));
 
         strncpy(tr->time_str, time_str, sizeof(tr->time_str) - 1);
+        tr->wall_time_ms = get_unix_ms();
         tr->timestamp_ms = timestamp_ms;
         tr->tick_num = tick_num;
         strncpy(tr->expected, expected, sizeof(tr->expected) - 1);
@@ -437,15 +506,47 @@ float tick_correlator_get_current_drift(tick_correlator_t *tc) {
 
 chain_stats_t tick_correlator_get_chain_stats(tick_correlator_t *tc, int chain_id) {
     chain_stats_t empty = {0};
-    if (!tc || chain_id <= 0 || chain_id > tc->chain_count) return empty;
-    return tc->chains[chain_id - 1];
+    chain_slot_t *slot = tc ? find_chain(tc, chain_id) : NULL;
+    return slot ? slot->stats : empty;
+}
+
+int tick_correlator_get_tick_count(tick_correlator_t *tc) {
+    return tc ? tc->tick_count : 0;
+}
+
+bool tick_correlator_get_tick(tick_correlator_t *tc, int age, tick_record_t *out) {
+    if (!tc || !out || age < 0 || age >= tc->tick_count || age >= tc->tick_capacity) return false;
+    *out = tc->ticks[(tc->tick_count - 1 - age) % tc->tick_capacity];
+    return true;
+}
+
+bool tick_correlator_set_spill_file(tick_correlator_t *tc, const char *path) {
+    if (!tc) return false;
+    if (tc->spill_file) {
+        fclose(tc->spill_file);
+        tc->spill_file = NULL;
+    }
+    if (!path) return true;
+
+    tc->spill_file = fopen(path, "wb");
+    if (!tc->spill_file) return false;
+
+    tick_spill_header_t hdr;
+    hdr.magic = TICK_SPILL_MAGIC;
+    hdr.version = TICK_SPILL_VERSION;
+    hdr.record_size = sizeof(tick_spill_record_t);
+    hdr.start_time = (int64_t)tc->start_time;
+    fwrite(&hdr, sizeof(hdr), 1, tc->spill_file);
+    return true;
 }
 
 void tick_correlator_print_stats(tick_correlator_t *tc) {
     if (!tc) return;
 
     printf("\n=== TICK CORRELATION STATS ===\n");
-    printf("Total ticks: %d\n", tc->tick_count);
+    printf("Total ticks: %d (%d in memory, %d spilled)\n", tc->tick_count,
+           tc->tick_count < tc->tick_capacity ? tc->tick_count : tc->tick_capacity,
+           tc->ticks_spilled);
     printf("Chains: %d\n", tc->chain_count);
     printf("Correlated: %d  Uncorrelated: %d\n",
            tc->total_correlated, tc->total_uncorrelated);
@@ -460,11 +561,14 @@ void tick_correlator_print_stats(tick_correlator_t *tc) {
     /* Show top chains */
     printf("\nTop chains by length:\n");
     int shown = 0;
-    for (int i = tc->chain_count - 1; i >= 0 && shown < 5; i--) {
-        chain_stats_t *cs = &tc->chains[i];
+    for (int id = tc->chain_count; id > 0 && shown < 5; id--) {
+        chain_slot_t *slot = find_chain(tc, id);
+        if (!slot) break;
+        chain_stats_t *cs = &slot->stats;
         if (cs->tick_count > 1) {
-            printf("  Chain #%d: %d ticks, avg=%.1fms, drift=%.1fms\n",
-                   cs->chain_id, cs->tick_count, cs->avg_interval_ms, cs->total_drift_ms);
+            printf("  Chain #%d: %d ticks, avg=%.1fms, sd=%.2fms, drift=%.1fms\n",
+                   cs->chain_id, cs->tick_count, cs->avg_interval_ms, cs->std_interval_ms,
+                   cs->total_drift_ms);
             shown++;
         }
     }
@@ -5,6 +5,10 @@
  * Groups consecutive ticks into correlation chains when they fall
  * within 1050ms of each other. Tracks chain statistics and outputs
  * correlated tick data to CSV.
+ *
+ * Memory is constant: the most recent CORR_TICK_HISTORY ticks and
+ * CORR_CHAIN_HISTORY chains are kept in rings. Older tick records can be
+ * spilled to a compact binary log (tick_correlator_set_spill_file).
  */
 
 #ifndef TICK_CORRELATOR_H
@@ -23,6 +27,9 @@ typedef struct tick_correlator tick_correlator_t;
 #define CORR_MIN_INTERVAL_MS    998.0f    /* Min expected interval (proven discipline) */
 #define CORR_NOMINAL_INTERVAL   1000.0f   /* Expected tick interval */
 
+#define CORR_TICK_HISTORY       10000     /* Tick records kept in memory (~2.8 hours) */
+#define CORR_CHAIN_HISTORY      1000      /* Chains whose stats stay queryable */
+
 /*============================================================================
  * Tick Record (matches tick_detector CSV output + correlation fields)
  *============================================================================*/
@@ -30,7 +37,8 @@ typedef struct tick_correlator tick_correlator_t;
 typedef struct {
     /* From tick_detector */
     char time_str[16];          /* Wall clock HH:MM:SS */
-    float timestamp_ms;         /* ms since start */
+    int64_t wall_time_ms;       /* Unix time when added, ms */
+    double timestamp_ms;        /* ms since start (double: exact to the sample for years) */
     int tick_num;               /* Tick number from detector */
     char expected[16];          /* WWV expected event */
     float energy_peak;          /* Peak energy */
@@ -44,7 +52,7 @@ typedef struct {
     /* Correlation fields */
     int chain_id;               /* Correlation chain ID (0 = uncorrelated) */
     int chain_position;         /* Position within chain (1, 2, 3...) */
-    float chain_start_ms;       /* Timestamp of chain start */
+    double chain_start_ms;      /* Timestamp of chain start */
     float drift_ms;             /* Cumulative drift from nominal */
 } tick_record_t;
 
@@ -60,14 +68,53 @@ typedef struct {
      * than breaking the chain, we allow single-skip intervals and track how many
      * were inferred. Higher inferred_count = lower chain quality. Added v1.0.1+19. */
     int inferred_count;
-    float start_ms;
-    float end_ms;
+    double start_ms;
+    double end_ms;
     float total_drift_ms;       /* Accumulated drift from nominal */
-    float avg_interval_ms;
+    float avg_interval_ms;      /* Mean of in-chain intervals (excludes the gap before tick 1) */
+    float std_interval_ms;      /* Standard deviation of in-chain intervals */
     float min_interval_ms;
     float max_interval_ms;
 } chain_stats_t;
 
+/*============================================================================
+ * Spill Log (binary, little-endian)
+ *
+ *   tick_spill_header_t | tick_spill_record_t ...
+ *
+ * Records are written oldest first as they age out of the in-memory ring,
+ * and the ring is flushed on destroy, so the file holds every tick.
+ *============================================================================*/
+
+#define TICK_SPILL_MAGIC        0x54584850  /* "PHXT" */
+#define TICK_SPILL_VERSION      2           /* 2: double timestamps, Unix wall time */
+
+#pragma pack(push, 1)
+typedef struct {
+    uint32_t magic;             /* TICK_SPILL_MAGIC */
+    uint16_t version;           /* TICK_SPILL_VERSION */
+    uint16_t record_size;       /* sizeof(tick_spill_record_t) */
+    int64_t  start_time;        /* Unix time the correlator was created */
+} tick_spill_header_t;
+
+typedef struct {
+    double   timestamp_ms;
+    int64_t  wall_time_ms;      /* Unix time, ms */
+    int32_t  tick_num;
+    float    energy_peak;
+    float    duration_ms;
+    float    interval_ms;
+    float    avg_interval_ms;
+    float    noise_floor;
+    float    corr_peak;
+    float    corr_ratio;
+    int32_t  chain_id;
+    int32_t  chain_position;
+    double   chain_start_ms;
+    float    drift_ms;
+} tick_spill_record_t;
+#pragma pack(pop)
+
 /*============================================================================
  * API
  *============================================================================*/
@@ -79,7 +126,7 @@ void tick_correlator_destroy(tick_correlator_t *tc);
 /* Add tick from detector (call for each tick event) */
 void tick_correlator_add_tick(tick_correlator_t *tc,
                               const char *time_str,
-                              float timestamp_ms,
+                              double timestamp_ms,
                               int tick_num,
                               const char *expected,
                               float energy_peak,
@@ -94,7 +141,14 @@ void tick_correlator_add_tick(tick_correlator_t *tc,
 int tick_correlator_get_chain_count(tick_correlator_t *tc);
 int tick_correlator_get_current_chain_length(tick_correlator_t *tc);
 float tick_correlator_get_current_drift(tick_correlator_t *tc);
-chain_stats_t tick_correlator_get_chain_stats(tick_correlator_t *tc, int chain_id);
+chain_stats_t tick_correlator_get_chain_stats(tick_correlator_t *tc, int chain_id);  /* Zeroed once aged out */
+
+/* Total ticks seen, and a retained record by age (0 = newest); false once aged out */
+int tick_correlator_get_tick_count(tick_correlator_t *tc);
+bool tick_correlator_get_tick(tick_correlator_t *tc, int age, tick_record_t *out);
+
+/* Spill aged tick records to a binary log (NULL to stop); returns false if the file can't be opened */
+bool tick_correlator_set_spill_file(tick_correlator_t *tc, const char *path);
 
 /* Print summary */
 void tick_correlator_print_stats(tick_correlator_t *tc);
@@ -3,7 +3,7 @@
  * @brief WWV tick pulse detector implementation
  *
  * Self-contained module with:
- *   - Own 256-point FFT (5.3ms frames for 5ms pulse detection)
+ *   - Own FFT sized for ~5ms frames at the input rate (256 points at 50kHz)
  *   - Own sample buffer
  *   - Adaptive threshold state machine
  *   - CSV logging
@@ -21,6 +21,7 @@
 #include "tick_comb_filter.h"
 #include "waterfall_telemetry.h"
 #include "kiss_fft.h"
+#include "detector_rate.h"
 #include "version.h"
 #include <stdlib.h>
 #include <string.h>
@@ -31,9 +32,6 @@
  * Internal Configuration
  *============================================================================*/
 
-#define FRAME_DURATION_MS   ((float)TICK_FFT_SIZE * 1000.0f / TICK_SAMPLE_RATE)
-#define HZ_PER_BIN          ((float)TICK_SAMPLE_RATE / TICK_FFT_SIZE)
-
 /* Detection timing */
 #define TICK_MIN_DURATION_MS    2.0f
 #define TICK_MAX_DURATION_MS    50.0f
@@ -51,7 +49,7 @@
 /* Correlation thresholds */
 #define CORR_THRESHOLD_MULT     5.0f    /* Correlation must be 5x noise floor */
 #define CORR_NOISE_ADAPT        0.01f   /* Noise floor adaptation rate */
-#define CORR_DECIMATION         8       /* Compute correlation every N samples */
+#define CORR_STEP_MS            0.16f   /* Compute correlation every 0.16ms (8 samples at 50kHz) */
 #define MARKER_CORR_RATIO       15.0f   /* Corr ratio above this = minute marker */
 #define MARKER_MIN_DURATION_MS  600.0f  /* Marker must be at least 600ms (tightened from 500ms) */
 #define MARKER_MAX_DURATION_MS_CHECK 1500.0f  /* Marker should be under 1500ms */
@@ -65,7 +63,10 @@
 #define TICK_HISTORY_SIZE       30
 #define TICK_AVG_WINDOW_MS      15000.0f
 
-#define MS_TO_FRAMES(ms)    ((int)((ms) / FRAME_DURATION_MS + 0.5f))
+/* Matched filter lengths with specialized kernels (5ms at 50k, 48k, 12k) */
+#define TEMPLATE_LEN_50K        250
+#define TEMPLATE_LEN_48K        240
+#define TEMPLATE_LEN_12K        60
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846f
@@ -96,6 +97,14 @@ typedef struct {
 } tick_gate_t;
 
 struct tick_detector {
+    /* Input rate profile (fixed at create) */
+    detector_rate_t rate;
+    int template_len;           /* Matched filter length in samples */
+    int corr_size;              /* Correlation ring size (power of two >= template_len) */
+    int corr_decimation;        /* Samples between correlations */
+    int center_bin;             /* TICK_TARGET_FREQ_HZ bin */
+    int bin_span;               /* +/- bins for TICK_BANDWIDTH_HZ */
+
     /* FFT resources */
     kiss_fft_cfg fft_cfg;
     kiss_fft_cpx *fft_in;
@@ -110,7 +119,7 @@ struct tick_detector {
     /* Matched filter resources */
     float *template_i;          /* Cosine template */
     float *template_q;          /* Sine template */
-    float *corr_buf_i;          /* Circular buffer for correlation */
+    float *corr_buf_i;          /* Circular buffer for correlation, mirrored (2 x corr_size) */
     float *corr_buf_q;
     int corr_buf_idx;           /* Write position in circular buffer */
     int corr_sample_count;      /* Total samples received */
@@ -144,13 +153,14 @@ struct tick_detector {
     bool warmup_complete;
 
     /* History for interval averaging */
-    float tick_timestamps_ms[TICK_HISTORY_SIZE];
+    double tick_timestamps_ms[TICK_HISTORY_SIZE];
     int tick_history_idx;
     int tick_history_count;
 
     /* UI feedback */
     int flash_frames_remaining;
     bool detection_enabled;
+    bool hold;                  /* Noise floors frozen */
 
     /* Tunable parameters (runtime adjustable via UDP commands) */
     float threshold_multiplier;     /* Detection sensitivity (1.0-5.0, default 2.0) */
@@ -189,7 +199,7 @@ struct tick_detector {
 /**
  * Check if timing gate is open (tick expected in this window)
  */
-static bool is_gate_open(tick_detector_t *td, float current_ms) {
+static bool is_gate_open(tick_detector_t *td, double current_ms) {
     if (!td->gate.enabled) {
         return true;  /* Gate disabled - always open */
     }
@@ -198,7 +208,7 @@ static bool is_gate_open(tick_detector_t *td, float current_ms) {
         return true;  /* Recovery mode - gate bypassed to re-acquire ticks */
     }
 
-    float ms_into_second = fmodf(current_ms - td->gate.epoch_ms, 1000.0f);
+    float ms_into_second = (float)fmod(current_ms - td->gate.epoch_ms, 1000.0);
     if (ms_into_second < 0) {
         ms_into_second += 1000.0f;
     }
@@ -211,10 +221,11 @@ static bool is_gate_open(tick_detector_t *td, float current_ms) {
  * Generate matched filter template: windowed 1000Hz tone
  */
 static void generate_template(tick_detector_t *td) {
-    for (int i = 0; i < TICK_TEMPLATE_SAMPLES; i++) {
-        float t = (float)i / TICK_SAMPLE_RATE;
+    int n = td->template_len;
+    for (int i = 0; i < n; i++) {
+        float t = (float)i / td->rate.sample_rate;
         /* Hann window for smooth edges */
-        float window = 0.5f * (1.0f - cosf(2.0f * M_PI * i / (TICK_TEMPLATE_SAMPLES - 1)));
+        float window = 0.5f * (1.0f - cosf(2.0f * M_PI * i / (n - 1)));
         /* Complex tone at target frequency */
         td->template_i[i] = cosf(2.0f * M_PI * TICK_TARGET_FREQ_HZ * t) * window;
         td->template_q[i] = sinf(2.0f * M_PI * TICK_TARGET_FREQ_HZ * t) * window;
@@ -222,71 +233,75 @@ static void generate_template(tick_detector_t *td) {
 }
 
 /**
- * Compute correlation magnitude at current buffer position
- * Returns magnitude of complex correlation
+ * Complex correlation of n contiguous samples with the template.
+ * Four partial sums break the add chain so the loop vectorizes; called
+ * with a constant n it also unrolls with no remainder loop.
  */
-static float compute_correlation(tick_detector_t *td) {
-    float sum_i = 0.0f;
-    float sum_q = 0.0f;
-
-    /* Correlate template with buffer (complex multiply and accumulate) */
-    for (int i = 0; i < TICK_TEMPLATE_SAMPLES; i++) {
-        /* Index into circular buffer, starting from oldest sample */
-        int buf_idx = (td->corr_buf_idx - TICK_TEMPLATE_SAMPLES + i + TICK_CORR_BUFFER_SIZE) % TICK_CORR_BUFFER_SIZE;
-
-        float sig_i = td->corr_buf_i[buf_idx];
-        float sig_q = td->corr_buf_q[buf_idx];
-        float tpl_i = td->template_i[i];
-        float tpl_q = td->template_q[i];
-
-        /* Complex multiply: (sig_i + j*sig_q) * (tpl_i - j*tpl_q) */
-        sum_i += sig_i * tpl_i + sig_q * tpl_q;
-        sum_q += sig_q * tpl_i - sig_i * tpl_q;
+static inline float correlate(const float *restrict sig_i, const float *restrict sig_q,
+                              const float *restrict tpl_i, const float *restrict tpl_q,
+                              int n) {
+    float acc_i[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    float acc_q[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        for (int k = 0; k < 4; k++) {
+            /* Complex multiply: (sig_i + j*sig_q) * (tpl_i - j*tpl_q) */
+            acc_i[k] += sig_i[i + k] * tpl_i[i + k] + sig_q[i + k] * tpl_q[i + k];
+            acc_q[k] += sig_q[i + k] * tpl_i[i + k] - sig_i[i + k] * tpl_q[i + k];
+        }
+    }
+    for (; i < n; i++) {
+        acc_i[0] += sig_i[i] * tpl_i[i] + sig_q[i] * tpl_q[i];
+        acc_q[0] += sig_q[i] * tpl_i[i] - sig_i[i] * tpl_q[i];
     }
 
+    float sum_i = (acc_i[0] + acc_i[1]) + (acc_i[2] + acc_i[3]);
+    float sum_q = (acc_q[0] + acc_q[1]) + (acc_q[2] + acc_q[3]);
     return sqrtf(sum_i * sum_i + sum_q * sum_q);
 }
 
-static float calculate_bucket_energy(tick_detector_t *td) {
-    int center_bin = (int)(TICK_TARGET_FREQ_HZ / HZ_PER_BIN + 0.5f);
-    int bin_span = (int)(TICK_BANDWIDTH_HZ / HZ_PER_BIN + 0.5f);
-    if (bin_span < 1) bin_span = 1;
-
-    float pos_energy = 0.0f;
-    float neg_energy = 0.0f;
-
-    for (int b = -bin_span; b <= bin_span; b++) {
-        int pos_bin = center_bin + b;
-        int neg_bin = TICK_FFT_SIZE - center_bin + b;
-
-        if (pos_bin >= 0 && pos_bin < TICK_FFT_SIZE) {
-            float re = td->fft_out[pos_bin].r;
-            float im = td->fft_out[pos_bin].i;
-            pos_energy += sqrtf(re * re + im * im) / TICK_FFT_SIZE;
-        }
-        if (neg_bin >= 0 && neg_bin < TICK_FFT_SIZE) {
-            float re = td->fft_out[neg_bin].r;
-            float im = td->fft_out[neg_bin].i;
-            neg_energy += sqrtf(re * re + im * im) / TICK_FFT_SIZE;
-        }
+/**
+ * Compute correlation magnitude at current buffer position
+ * Returns magnitude of complex correlation
+ *
+ * The ring is mirrored, so the newest template_len samples are always
+ * contiguous. Common rates get a constant-length kernel.
+ */
+static float compute_correlation(tick_detector_t *td) {
+    int start = td->corr_buf_idx + td->corr_size - td->template_len;
+    const float *sig_i = td->corr_buf_i + start;
+    const float *sig_q = td->corr_buf_q + start;
+
+    switch (td->template_len) {
+        case TEMPLATE_LEN_50K:
+            return correlate(sig_i, sig_q, td->template_i, td->template_q, TEMPLATE_LEN_50K);
+        case TEMPLATE_LEN_48K:
+            return correlate(sig_i, sig_q, td->template_i, td->template_q, TEMPLATE_LEN_48K);
+        case TEMPLATE_LEN_12K:
+            return correlate(sig_i, sig_q, td->template_i, td->template_q, TEMPLATE_LEN_12K);
+        default:
+            return correlate(sig_i, sig_q, td->template_i, td->template_q, td->template_len);
     }
+}
 
-    return pos_energy + neg_energy;
+static float calculate_bucket_energy(tick_detector_t *td) {
+    return detector_rate_bucket_energy(&td->rate, td->fft_out, td->center_bin, td->bin_span);
 }
 
-static float calculate_avg_interval(tick_detector_t *td, float current_time_ms) {
+static float calculate_avg_interval(tick_detector_t *td, double current_time_ms) {
     if (td->tick_history_count < 2) return 0.0f;
 
-    float cutoff = current_time_ms - TICK_AVG_WINDOW_MS;
-    float sum = 0.0f;
+    double cutoff = current_time_ms - TICK_AVG_WINDOW_MS;
+    double sum = 0.0;
     int count = 0;
-    float prev_time = -1.0f;
+    double prev_time = -1.0;
 
     for (int i = 0; i < td->tick_history_count; i++) {
         int idx = (td->tick_history_idx - td->tick_history_count + i + TICK_HISTORY_SIZE) % TICK_HISTORY_SIZE;
-        float t = td->tick_timestamps_ms[idx];
+        double t = td->tick_timestamps_ms[idx];
         if (t >= cutoff) {
-            if (prev_time >= 0.0f) {
+            if (prev_time >= 0.0) {
                 sum += (t - prev_time);
                 count++;
             }
@@ -294,15 +309,15 @@ static float calculate_avg_interval(tick_detector_t *td, float current_time_ms)
         }
     }
 
-    return (count > 0) ? (sum / count) : 0.0f;
+    return (count > 0) ? (float)(sum / count) : 0.0f;
 }
 
 /**
  * Get wall clock time string for CSV output
  * Format: HH:MM:SS
  */
-static void get_wall_time_str(tick_detector_t *td, float timestamp_ms, char *buf, size_t buflen) {
-    time_t event_time = td->start_time + (time_t)(timestamp_ms / 1000.0f);
+static void get_wall_time_str(tick_detector_t *td, double timestamp_ms, char *buf, size_t buflen) {
+    time_t event_time = td->start_time + (time_t)(timestamp_ms / 1000.0);
     struct tm *tm_info = localtime(&event_time);
     strftime(buf, buflen, "%H:%M:%S", tm_info);
 }
@@ -313,7 +328,7 @@ static void run_state_machine(tick_detector_t *td) {
 
     /* Warmup phase - fast adaptation to establish baseline */
     if (!td->warmup_complete) {
-        td->noise_floor += TICK_WARMUP_ADAPT_RATE * (energy - td->noise_floor);
+        if (!td->hold) td->noise_floor += TICK_WARMUP_ADAPT_RATE * (energy - td->noise_floor);
         if (td->noise_floor < 0.0001f) td->noise_floor = 0.0001f;
         td->threshold_high = td->noise_floor * td->threshold_multiplier;
         td->threshold_low = td->threshold_high * TICK_HYSTERESIS_RATIO;
@@ -329,7 +344,7 @@ static void run_state_machine(tick_detector_t *td) {
     /* Gate recovery check - if gating enabled but no ticks for too long, enter recovery mode */
     if (td->gate.enabled && !td->gate.recovery_mode && td->state == STATE_IDLE) {
         float since_last_gated_tick_ms = (td->gate.last_tick_frame_gated > 0) ?
-            (frame - td->gate.last_tick_frame_gated) * FRAME_DURATION_MS : 0.0f;
+            (frame - td->gate.last_tick_frame_gated) * td->rate.frame_ms : 0.0f;
         if (td->gate.last_tick_frame_gated > 0 && since_last_gated_tick_ms >= GATE_RECOVERY_MS) {
             td->gate.recovery_mode = true;
             printf("[TICK] Gate recovery mode ENABLED (%.1fs without tick)\n",
@@ -338,7 +353,7 @@ static void run_state_machine(tick_detector_t *td) {
     }
 
     /* Adaptive noise floor - asymmetric: fast down, slow up */
-    if (td->state == STATE_IDLE && energy < td->threshold_high) {
+    if (td->state == STATE_IDLE && energy < td->threshold_high && !td->hold) {
         if (energy < td->noise_floor) {
             td->noise_floor = td->noise_floor * td->adapt_alpha_down + energy * (1.0f - td->adapt_alpha_down);
         } else {
@@ -355,7 +370,7 @@ static void run_state_machine(tick_detector_t *td) {
         case STATE_IDLE:
             if (energy > td->threshold_high) {
                 /* Check timing gate before transitioning */
-                float current_ms = frame * FRAME_DURATION_MS;
+                double current_ms = (double)frame * td->rate.frame_ms;
                 if (!is_gate_open(td, current_ms)) {
                     /* Gate closed - ignore this detection (BCD harmonic) */
                     break;
@@ -379,10 +394,10 @@ static void run_state_machine(tick_detector_t *td) {
 
             if (energy < td->threshold_low) {
                 /* Signal dropped - classify based on duration */
-                float duration_ms = td->tick_duration_frames * FRAME_DURATION_MS;
+                float duration_ms = td->tick_duration_frames * td->rate.frame_ms;
                 float interval_ms = (td->last_tick_frame > 0) ?
-                    (td->tick_start_frame - td->last_tick_frame) * FRAME_DURATION_MS : 0.0f;
-                float timestamp_ms = frame * FRAME_DURATION_MS;
+                    (td->tick_start_frame - td->last_tick_frame) * td->rate.frame_ms : 0.0f;
+                double timestamp_ms = (double)frame * td->rate.frame_ms;
                 float corr_ratio = (td->corr_noise_floor > 0.001f) ?
                     td->corr_peak / td->corr_noise_floor : 0.0f;
 
@@ -398,7 +413,7 @@ static void run_state_machine(tick_detector_t *td) {
                  * This handles startup and recovery from fading (missed markers)
                  */
                 float since_last_marker_ms = (td->last_marker_frame > 0) ?
-                    (td->tick_start_frame - td->last_marker_frame) * FRAME_DURATION_MS : MARKER_MIN_INTERVAL_MS + 1000.0f;
+                    (td->tick_start_frame - td->last_marker_frame) * td->rate.frame_ms : MARKER_MIN_INTERVAL_MS + 1000.0f;
                 bool valid_marker_interval = (since_last_marker_ms >= MARKER_MIN_INTERVAL_MS);
 
                 if (is_marker_duration && valid_marker_interval) {
@@ -410,7 +425,7 @@ static void run_state_machine(tick_detector_t *td) {
                      * Leading edge = trailing edge - duration - filter delay.
                      * timestamp_ms is when energy dropped below threshold (trailing edge).
                      * The actual WWV marker START is the on-time reference. */
-                    float leading_edge_ms = timestamp_ms - duration_ms - TICK_FILTER_DELAY_MS;
+                    float leading_edge_ms = (float)(timestamp_ms - duration_ms - TICK_FILTER_DELAY_MS);
 
                     printf("[%7.1fs] *** MINUTE MARKER #%-3d ***  dur=%.0fms  corr=%.1f  since=%.1fs  start=%.1fms\n",
                            timestamp_ms / 1000.0f, td->markers_detected,
@@ -444,7 +459,7 @@ static void run_state_machine(tick_detector_t *td) {
                     if (td->marker_callback) {
                         tick_marker_event_t event = {
                             .marker_number = td->markers_detected,
-                            .timestamp_ms = timestamp_ms,
+                            .timestamp_ms = (float)timestamp_ms,
                             .start_timestamp_ms = leading_edge_ms,  /* LEADING EDGE - on-time marker */
                             .duration_ms = duration_ms,
                             .corr_ratio = corr_ratio,
@@ -535,15 +550,15 @@ static void run_state_machine(tick_detector_t *td) {
                 }
 
                 td->state = STATE_COOLDOWN;
-                td->cooldown_frames = MS_TO_FRAMES(TICK_COOLDOWN_MS);
+                td->cooldown_frames = detector_rate_frames(&td->rate, TICK_COOLDOWN_MS);
 
-            } else if (td->tick_duration_frames * FRAME_DURATION_MS > MARKER_MAX_DURATION_MS) {
+            } else if (td->tick_duration_frames * td->rate.frame_ms > MARKER_MAX_DURATION_MS) {
                 /* Pulse WAY too long (>1s) - something is wrong, bail out */
                 td->ticks_rejected++;
                 printf("[%7.1fs] REJECTED: pulse >1s, bailing out\n",
-                       frame * FRAME_DURATION_MS / 1000.0f);
+                       frame * td->rate.frame_ms / 1000.0f);
                 td->state = STATE_COOLDOWN;
-                td->cooldown_frames = MS_TO_FRAMES(TICK_COOLDOWN_MS);
+                td->cooldown_frames = detector_rate_frames(&td->rate, TICK_COOLDOWN_MS);
             }
             break;
 
@@ -560,27 +575,46 @@ static void run_state_machine(tick_detector_t *td) {
  *============================================================================*/
 
 tick_detector_t *tick_detector_create(const char *csv_path) {
+    return tick_detector_create_rate(csv_path, TICK_SAMPLE_RATE);
+}
+
+tick_detector_t *tick_detector_create_rate(const char *csv_path, int sample_rate) {
     tick_detector_t *td = (tick_detector_t *)calloc(1, sizeof(tick_detector_t));
     if (!td) return NULL;
 
+    /* Derive FFT, template and correlation sizes from the input rate */
+    if (!detector_rate_init(&td->rate, sample_rate, TICK_SAMPLE_RATE, TICK_FFT_SIZE)) {
+        free(td);
+        return NULL;
+    }
+    int fft_size = td->rate.fft_size;
+    td->template_len = detector_rate_samples(&td->rate, TICK_PULSE_MS);
+    td->corr_size = 1;
+    while (td->corr_size < td->template_len) td->corr_size *= 2;
+    td->corr_decimation = detector_rate_samples(&td->rate, CORR_STEP_MS);
+    if (td->corr_decimation < 1) td->corr_decimation = 1;
+    td->center_bin = detector_rate_bin(&td->rate, TICK_TARGET_FREQ_HZ);
+    td->bin_span = detector_rate_bin(&td->rate, TICK_BANDWIDTH_HZ);
+    if (td->bin_span < 1) td->bin_span = 1;
+
     /* Allocate FFT */
-    td->fft_cfg = kiss_fft_alloc(TICK_FFT_SIZE, 0, NULL, NULL);
+    td->fft_cfg = kiss_fft_alloc(fft_size, 0, NULL, NULL);
     if (!td->fft_cfg) {
         free(td);
         return NULL;
     }
 
-    td->fft_in = (kiss_fft_cpx *)malloc(TICK_FFT_SIZE * sizeof(kiss_fft_cpx));
-    td->fft_out = (kiss_fft_cpx *)malloc(TICK_FFT_SIZE * sizeof(kiss_fft_cpx));
-    td->window_func = (float *)malloc(TICK_FFT_SIZE * sizeof(float));
-    td->i_buffer = (float *)malloc(TICK_FFT_SIZE * sizeof(float));
-    td->q_buffer = (float *)malloc(TICK_FFT_SIZE * sizeof(float));
+    td->fft_in = (kiss_fft_cpx *)malloc(fft_size * sizeof(kiss_fft_cpx));
+    td->fft_out = (kiss_fft_cpx *)malloc(fft_size * sizeof(kiss_fft_cpx));
+    td->window_func = (float *)malloc(fft_size * sizeof(float));
+    td->i_buffer = (float *)malloc(fft_size * sizeof(float));
+    td->q_buffer = (float *)malloc(fft_size * sizeof(float));
 
     /* Allocate matched filter resources */
-    td->template_i = (float *)malloc(TICK_TEMPLATE_SAMPLES * sizeof(float));
-    td->template_q = (float *)malloc(TICK_TEMPLATE_SAMPLES * sizeof(float));
-    td->corr_buf_i = (float *)malloc(TICK_CORR_BUFFER_SIZE * sizeof(float));
-    td->corr_buf_q = (float *)malloc(TICK_CORR_BUFFER_SIZE * sizeof(float));
+    td->template_i = (float *)malloc(td->template_len * sizeof(float));
+    td->template_q = (float *)malloc(td->template_len * sizeof(float));
+    td->corr_buf_i = (float *)malloc(2 * td->corr_size * sizeof(float));
+    td->corr_buf_q = (float *)malloc(2 * td->corr_size * sizeof(float));
 
     if (!td->fft_in || !td->fft_out || !td->window_func || !td->i_buffer || !td->q_buffer ||
         !td->template_i || !td->template_q || !td->corr_buf_i || !td->corr_buf_q) {
@@ -589,19 +623,19 @@ tick_detector_t *tick_detector_create(const char *csv_path) {
     }
 
     /* Initialize window function (Hann) */
-    for (int i = 0; i < TICK_FFT_SIZE; i++) {
-        td->window_func[i] = 0.5f * (1.0f - cosf(2.0f * M_PI * i / (TICK_FFT_SIZE - 1)));
+    for (int i = 0; i < fft_size; i++) {
+        td->window_func[i] = 0.5f * (1.0f - cosf(2.0f * M_PI * i / (fft_size - 1)));
     }
 
     /* Initialize buffers */
-    memset(td->i_buffer, 0, TICK_FFT_SIZE * sizeof(float));
-    memset(td->q_buffer, 0, TICK_FFT_SIZE * sizeof(float));
+    memset(td->i_buffer, 0, fft_size * sizeof(float));
+    memset(td->q_buffer, 0, fft_size * sizeof(float));
     td->buffer_idx = 0;
 
     /* Initialize matched filter */
     generate_template(td);
-    memset(td->corr_buf_i, 0, TICK_CORR_BUFFER_SIZE * sizeof(float));
-    memset(td->corr_buf_q, 0, TICK_CORR_BUFFER_SIZE * sizeof(float));
+    memset(td->corr_buf_i, 0, 2 * td->corr_size * sizeof(float));
+    memset(td->corr_buf_q, 0, 2 * td->corr_size * sizeof(float));
     td->corr_buf_idx = 0;
     td->corr_sample_count = 0;
     td->corr_noise_floor = 0.0f;
@@ -652,8 +686,8 @@ tick_detector_t *tick_detector_create(const char *csv_path) {
         }
     }
 
-    printf("[TICK] Detector created: FFT=%d (%.1fms), matched filter=%d samples (%.1fms)\n",
-           TICK_FFT_SIZE, FRAME_DURATION_MS, TICK_TEMPLATE_SAMPLES, TICK_PULSE_MS);
+    printf("[TICK] Detector created: %dHz, FFT=%d (%.1fms), matched filter=%d samples (%.1fms)\n",
+           td->rate.sample_rate, fft_size, td->rate.frame_ms, td->template_len, TICK_PULSE_MS);
     printf("[TICK] Target: %dHz ±%dHz, logging to %s\n",
            TICK_TARGET_FREQ_HZ, TICK_BANDWIDTH_HZ, csv_path ? csv_path : "(disabled)");
 
@@ -694,19 +728,23 @@ void tick_detector_set_marker_callback(tick_detector_t *td, tick_marker_callback
 bool tick_detector_process_sample(tick_detector_t *td, float i_sample, float q_sample) {
     if (!td || !td->detection_enabled) return false;
 
-    /* Always feed correlation buffer (sample-by-sample) */
+    /* Always feed correlation buffer (sample-by-sample, both mirror halves) */
     td->corr_buf_i[td->corr_buf_idx] = i_sample;
     td->corr_buf_q[td->corr_buf_idx] = q_sample;
-    td->corr_buf_idx = (td->corr_buf_idx + 1) % TICK_CORR_BUFFER_SIZE;
+    td->corr_buf_i[td->corr_buf_idx + td->corr_size] = i_sample;
+    td->corr_buf_q[td->corr_buf_idx + td->corr_size] = q_sample;
+    td->corr_buf_idx = (td->corr_buf_idx + 1) & (td->corr_size - 1);
     td->corr_sample_count++;
 
     /* Compute correlation every N samples (for efficiency) */
-    if (td->corr_sample_count >= TICK_TEMPLATE_SAMPLES &&
-        (td->corr_sample_count % CORR_DECIMATION) == 0) {
+    if (td->corr_sample_count >= td->template_len &&
+        (td->corr_sample_count % td->corr_decimation) == 0) {
         float corr = compute_correlation(td);
 
         /* Update correlation noise floor (slow adaptation) */
-        if (corr < td->corr_noise_floor || td->corr_noise_floor < 0.001f) {
+        if (td->hold) {
+            /* Blanked or settling input - keep the floor */
+        } else if (corr < td->corr_noise_floor || td->corr_noise_floor < 0.001f) {
             td->corr_noise_floor += CORR_NOISE_ADAPT * (corr - td->corr_noise_floor);
         } else if (td->state == STATE_IDLE) {
             td->corr_noise_floor += (CORR_NOISE_ADAPT * 0.1f) * (corr - td->corr_noise_floor);
@@ -731,7 +769,7 @@ bool tick_detector_process_sample(tick_detector_t *td, float i_sample, float q_s
     td->buffer_idx++;
 
     /* Not enough samples yet */
-    if (td->buffer_idx < TICK_FFT_SIZE) {
+    if (td->buffer_idx < td->rate.fft_size) {
         return false;
     }
 
@@ -739,7 +777,7 @@ bool tick_detector_process_sample(tick_detector_t *td, float i_sample, float q_s
     td->buffer_idx = 0;
 
     /* Apply window and load FFT input */
-    for (int i = 0; i < TICK_FFT_SIZE; i++) {
+    for (int i = 0; i < td->rate.fft_size; i++) {
         td->fft_in[i].r = td->i_buffer[i] * td->window_func[i];
         td->fft_in[i].i = td->q_buffer[i] * td->window_func[i];
     }
@@ -772,6 +810,10 @@ void tick_detector_set_enabled(tick_detector_t *td, bool enabled) {
     if (td) td->detection_enabled = enabled;
 }
 
+void tick_detector_set_hold(tick_detector_t *td, bool hold) {
+    if (td) td->hold = hold;
+}
+
 bool tick_detector_get_enabled(tick_detector_t *td) {
     return td ? td->detection_enabled : false;
 }
@@ -811,16 +853,17 @@ int tick_detector_get_tick_count(tick_detector_t *td) {
 void tick_detector_print_stats(tick_detector_t *td) {
     if (!td) return;
 
-    float elapsed = td->frame_count * FRAME_DURATION_MS / 1000.0f;
-    float current_time_ms = td->frame_count * FRAME_DURATION_MS;
+    float elapsed = td->frame_count * td->rate.frame_ms / 1000.0f;
+    double current_time_ms = (double)td->frame_count * td->rate.frame_ms;
     float detecting = td->warmup_complete ?
-        (elapsed - TICK_WARMUP_FRAMES * FRAME_DURATION_MS / 1000.0f) : 0.0f;
+        (elapsed - TICK_WARMUP_FRAMES * td->rate.frame_ms / 1000.0f) : 0.0f;
     int expected = (int)detecting;
     float rate = (expected > 0) ? (100.0f * td->ticks_detected / expected) : 0.0f;
     float avg_interval = calculate_avg_interval(td, current_time_ms);
 
     printf("\n=== TICK DETECTOR STATS ===\n");
-    printf("FFT: %d (%.1fms), Matched filter: %d samples\n", TICK_FFT_SIZE, FRAME_DURATION_MS, TICK_TEMPLATE_SAMPLES);
+    printf("Rate: %d Hz  FFT: %d (%.1fms), Matched filter: %d samples\n",
+           td->rate.sample_rate, td->rate.fft_size, td->rate.frame_ms, td->template_len);
     printf("Target: %d Hz +/-%d Hz\n", TICK_TARGET_FREQ_HZ, TICK_BANDWIDTH_HZ);
     printf("Elapsed: %.1fs  Detected: %d  Expected: %d  Rate: %.1f%%\n",
            elapsed, td->ticks_detected, expected, rate);
@@ -841,7 +884,7 @@ void tick_detector_log_metadata(tick_detector_t *td, uint64_t center_freq,
     strftime(time_str, sizeof(time_str), "%H:%M:%S", localtime(&now));
 
     /* Get timestamp in ms since detector start */
-    float timestamp_ms = td->frame_count * FRAME_DURATION_MS;
+    float timestamp_ms = td->frame_count * td->rate.frame_ms;
 
     /* Log as special META row */
     fprintf(td->csv_file, "%s,%.1f,META,0,freq=%llu rate=%u GR=%u LNA=%u,0,0,0,0,0,0\n",
@@ -862,7 +905,7 @@ void tick_detector_log_display_gain(tick_detector_t *td, float display_gain_db)
     strftime(time_str, sizeof(time_str), "%H:%M:%S", localtime(&now));
 
     /* Get timestamp in ms since detector start */
-    float timestamp_ms = td->frame_count * FRAME_DURATION_MS;
+    float timestamp_ms = td->frame_count * td->rate.frame_ms;
 
     /* Log as special GAIN row */
     fprintf(td->csv_file, "%s,%.1f,GAIN,0,display_gain=%.1f,0,0,0,0,0,0,0\n",
@@ -871,7 +914,15 @@ void tick_detector_log_display_gain(tick_detector_t *td, float display_gain_db)
 }
 
 float tick_detector_get_frame_duration_ms(void) {
-    return FRAME_DURATION_MS;
+    return (float)TICK_FFT_SIZE * 1000.0f / TICK_SAMPLE_RATE;
+}
+
+float tick_detector_get_frame_ms(tick_detector_t *td) {
+    return td ? td->rate.frame_ms : tick_detector_get_frame_duration_ms();
+}
+
+int tick_detector_get_sample_rate(tick_detector_t *td) {
+    return td ? td->rate.sample_rate : TICK_SAMPLE_RATE;
 }
 
 /*============================================================================
@@ -28,14 +28,19 @@ extern "C" {
  *============================================================================*/
 
 #define TICK_FFT_SIZE           256     /* 5.12ms frames at 50kHz - matches 5ms WWV pulse */
-#define TICK_SAMPLE_RATE        50000   /* Expected input sample rate (2MHz/40 = exact) */
+#define TICK_SAMPLE_RATE        50000   /* Default input sample rate (2MHz/40 = exact) */
 #define TICK_TARGET_FREQ_HZ     1000    /* Frequency bucket to watch */
 #define TICK_BANDWIDTH_HZ       100     /* Width of detection bucket */
 
 /* Matched filter template */
 #define TICK_PULSE_MS           5.0f    /* WWV tick pulse duration */
-#define TICK_TEMPLATE_SAMPLES   ((int)(TICK_PULSE_MS * TICK_SAMPLE_RATE / 1000.0f))  /* 240 samples */
-#define TICK_CORR_BUFFER_SIZE   512     /* Must be > TICK_TEMPLATE_SAMPLES */
+#define TICK_TEMPLATE_SAMPLES   ((int)(TICK_PULSE_MS * TICK_SAMPLE_RATE / 1000.0f))  /* 250 samples */
+
+/*
+ * Other input rates: tick_detector_create_rate() scales the FFT to the
+ * power of two nearest 5.12ms and the template to 5ms of samples. 48kHz
+ * and 12kHz (like 50kHz) run constant-length matched filter kernels.
+ */
 
 /*============================================================================
  * Detector State (opaque to caller)
@@ -49,7 +54,7 @@ typedef struct tick_detector tick_detector_t;
 
 typedef struct {
     int tick_number;
-    float timestamp_ms;
+    double timestamp_ms;        /* ms since start; a float would step by 2 ms after 4.6 h */
     float interval_ms;
     float duration_ms;
     float peak_energy;
@@ -69,6 +74,7 @@ typedef void (*tick_callback_fn)(const tick_event_t *event, void *user_data);
 #define TICK_ACTUAL_DURATION_MS    5.0f     /* WWV spec: 5ms pulse */
 #define MARKER_ACTUAL_DURATION_MS  800.0f   /* WWV spec: 800ms pulse */
 #define TICK_FILTER_DELAY_MS       3.0f     /* Filter group delay (2.55ms Hann + 0.32ms Butterworth + 0.13ms decimation) */
+                                            /* Sync band adds none: fft_filter_bank output is zero-phase */
 
 typedef struct {
     int marker_number;
@@ -92,6 +98,14 @@ typedef void (*tick_marker_callback_fn)(const tick_marker_event_t *event, void *
  */
 tick_detector_t *tick_detector_create(const char *csv_path);
 
+/**
+ * Create a tick detector for a given input rate
+ * @param csv_path     Path for CSV log file (NULL to disable logging)
+ * @param sample_rate  Input rate in Hz (DETECTOR_RATE_MIN..MAX)
+ * @return             Detector instance or NULL on failure / bad rate
+ */
+tick_detector_t *tick_detector_create_rate(const char *csv_path, int sample_rate);
+
 /**
  * Destroy a tick detector instance
  */
@@ -141,6 +155,12 @@ void tick_detector_decrement_flash(tick_detector_t *td);
 void tick_detector_set_enabled(tick_detector_t *td, bool enabled);
 bool tick_detector_get_enabled(tick_detector_t *td);
 
+/**
+ * Hold the noise floor (blanked or settling input upstream)
+ * While set, the floor and thresholds stay put; detection still runs.
+ */
+void tick_detector_set_hold(tick_detector_t *td, bool hold);
+
 /**
  * Get current state for display
  */
@@ -175,8 +195,12 @@ void tick_detector_log_display_gain(tick_detector_t *td, float display_gain_db);
 
 /**
  * Get timing info for display
+ * get_frame_duration_ms() is the default-rate frame; get_frame_ms() is
+ * the instance's own
  */
 float tick_detector_get_frame_duration_ms(void);
+float tick_detector_get_frame_ms(tick_detector_t *td);
+int tick_detector_get_sample_rate(tick_detector_t *td);
 
 /**
  * Epoch source - tracks where epoch timing came from
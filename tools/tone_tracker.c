@@ -10,6 +10,7 @@
 
 #include "tone_tracker.h"
 #include "kiss_fft.h"
+#include "detector_rate.h"
 #include "version.h"
 #include <stdlib.h>
 #include <string.h>
@@ -35,6 +36,7 @@
 
 struct tone_tracker {
     float nominal_hz;           /* 500 or 600 */
+    detector_rate_t rate;       /* FFT scaled to keep ~2.93 Hz/bin at any rate */
 
     /* Sample buffer */
     float *buffer_i;
@@ -156,9 +158,12 @@ static float estimate_noise_floor(float *mag, int fft_size, int exclude_bin, int
  *============================================================================*/
 
 static void measure_tone(tone_tracker_t *tt) {
+    const int fft_size = tt->rate.fft_size;
+    const float hz_per_bin = tt->rate.hz_per_bin;
+
     /* Apply window and load FFT input */
-    for (int i = 0; i < TONE_FFT_SIZE; i++) {
-        int idx = (tt->buffer_idx + i) % TONE_FFT_SIZE;
+    for (int i = 0; i < fft_size; i++) {
+        int idx = (tt->buffer_idx + i) & (fft_size - 1);
         tt->fft_in[i].r = tt->buffer_i[idx] * tt->window[i];
         tt->fft_in[i].i = tt->buffer_q[idx] * tt->window[i];
     }
@@ -167,7 +172,7 @@ static void measure_tone(tone_tracker_t *tt) {
     kiss_fft(tt->fft_cfg, tt->fft_in, tt->fft_out);
 
     /* Calculate magnitudes */
-    for (int i = 0; i < TONE_FFT_SIZE; i++) {
+    for (int i = 0; i < fft_size; i++) {
         float re = tt->fft_out[i].r;
         float im = tt->fft_out[i].i;
         tt->magnitudes[i] = sqrtf(re * re + im * im);
@@ -180,7 +185,7 @@ static void measure_tone(tone_tracker_t *tt) {
         float peak_mag = tt->magnitudes[0];
 
         /* Search positive frequencies (bins 1 to SEARCH_BINS) */
-        for (int i = 1; i <= SEARCH_BINS && i < TONE_FFT_SIZE/2; i++) {
+        for (int i = 1; i <= SEARCH_BINS && i < fft_size/2; i++) {
             if (tt->magnitudes[i] > peak_mag) {
                 peak_mag = tt->magnitudes[i];
                 peak_bin = i;
@@ -188,7 +193,7 @@ static void measure_tone(tone_tracker_t *tt) {
         }
 
         /* Search negative frequencies (bins FFT_SIZE-1 down to FFT_SIZE-SEARCH_BINS) */
-        for (int i = TONE_FFT_SIZE - 1; i >= TONE_FFT_SIZE - SEARCH_BINS; i--) {
+        for (int i = fft_size - 1; i >= fft_size - SEARCH_BINS; i--) {
             if (tt->magnitudes[i] > peak_mag) {
                 peak_mag = tt->magnitudes[i];
                 peak_bin = i;
@@ -196,16 +201,16 @@ static void measure_tone(tone_tracker_t *tt) {
         }
 
         /* Convert bin to Hz (handle negative frequencies) */
-        float peak_frac = parabolic_peak(tt->magnitudes, peak_bin, TONE_FFT_SIZE);
+        float peak_frac = parabolic_peak(tt->magnitudes, peak_bin, fft_size);
         float measured_hz;
-        if (peak_bin < TONE_FFT_SIZE / 2) {
-            measured_hz = peak_frac * TONE_HZ_PER_BIN;
+        if (peak_bin < fft_size / 2) {
+            measured_hz = peak_frac * hz_per_bin;
         } else {
-            measured_hz = (peak_frac - TONE_FFT_SIZE) * TONE_HZ_PER_BIN;
+            measured_hz = (peak_frac - fft_size) * hz_per_bin;
         }
 
         /* Estimate noise floor (away from carrier) */
-        float noise_floor = estimate_noise_floor(tt->magnitudes, TONE_FFT_SIZE, 0, SEARCH_BINS + 5);
+        float noise_floor = estimate_noise_floor(tt->magnitudes, fft_size, 0, SEARCH_BINS + 5);
         tt->noise_floor_linear = noise_floor;  /* Store for marker detector baseline */
         tt->snr_db = 20.0f * log10f(peak_mag / (noise_floor + 1e-10f));
         tt->valid = (tt->snr_db >= MIN_SNR_DB);
@@ -225,27 +230,27 @@ static void measure_tone(tone_tracker_t *tt) {
     /* Normal case for 500/600 Hz tones */
 
     /* Find expected bin locations */
-    int nominal_bin = (int)(tt->nominal_hz / TONE_HZ_PER_BIN + 0.5f);
-    int lsb_center = TONE_FFT_SIZE - nominal_bin;
+    int nominal_bin = (int)(tt->nominal_hz / hz_per_bin + 0.5f);
+    int lsb_center = fft_size - nominal_bin;
 
     /* Find USB peak (positive frequency) */
     int usb_peak_bin = find_peak_bin(tt->magnitudes,
                                       nominal_bin - SEARCH_BINS,
                                       nominal_bin + SEARCH_BINS,
-                                      TONE_FFT_SIZE);
-    float usb_peak_frac = parabolic_peak(tt->magnitudes, usb_peak_bin, TONE_FFT_SIZE);
+                                      fft_size);
+    float usb_peak_frac = parabolic_peak(tt->magnitudes, usb_peak_bin, fft_size);
     float usb_peak_mag = tt->magnitudes[usb_peak_bin];
 
     /* Find LSB peak (negative frequency) */
     int lsb_peak_bin = find_peak_bin(tt->magnitudes,
                                       lsb_center - SEARCH_BINS,
                                       lsb_center + SEARCH_BINS,
-                                      TONE_FFT_SIZE);
-    float lsb_peak_frac = parabolic_peak(tt->magnitudes, lsb_peak_bin, TONE_FFT_SIZE);
+                                      fft_size);
+    float lsb_peak_frac = parabolic_peak(tt->magnitudes, lsb_peak_bin, fft_size);
     float lsb_peak_mag = tt->magnitudes[lsb_peak_bin];
 
     /* Estimate noise floor */
-    float noise_floor = estimate_noise_floor(tt->magnitudes, TONE_FFT_SIZE,
+    float noise_floor = estimate_noise_floor(tt->magnitudes, fft_size,
                                               nominal_bin, SEARCH_BINS + 5);
     tt->noise_floor_linear = noise_floor;  /* Store for marker detector baseline */
 
@@ -258,8 +263,8 @@ static void measure_tone(tone_tracker_t *tt) {
 
     if (tt->valid) {
         /* Sideband spacing method for best accuracy */
-        float usb_hz = usb_peak_frac * TONE_HZ_PER_BIN;
-        float lsb_hz = (TONE_FFT_SIZE - lsb_peak_frac) * TONE_HZ_PER_BIN;
+        float usb_hz = usb_peak_frac * hz_per_bin;
+        float lsb_hz = (fft_size - lsb_peak_frac) * hz_per_bin;
 
         /* Average both sidebands */
         tt->measured_hz = (usb_hz + lsb_hz) / 2.0f;
@@ -286,7 +291,7 @@ static void log_measurement(tone_tracker_t *tt) {
     char time_str[16];
     strftime(time_str, sizeof(time_str), "%H:%M:%S", tm_info);
 
-    float timestamp_ms = tt->frame_count * TONE_FRAME_MS;
+    float timestamp_ms = tt->frame_count * tt->rate.frame_ms;
 
     fprintf(tt->csv_file, "%s,%.1f,%.3f,%.3f,%.2f,%.1f,%s\n",
             time_str,
@@ -304,19 +309,29 @@ static void log_measurement(tone_tracker_t *tt) {
  *============================================================================*/
 
 tone_tracker_t *tone_tracker_create(float nominal_hz, const char *csv_path) {
+    return tone_tracker_create_rate(nominal_hz, csv_path, TONE_SAMPLE_RATE);
+}
+
+tone_tracker_t *tone_tracker_create_rate(float nominal_hz, const char *csv_path, int sample_rate) {
     tone_tracker_t *tt = (tone_tracker_t *)calloc(1, sizeof(tone_tracker_t));
     if (!tt) return NULL;
 
+    if (!detector_rate_init(&tt->rate, sample_rate, TONE_SAMPLE_RATE, TONE_FFT_SIZE)) {
+        free(tt);
+        return NULL;
+    }
+    int fft_size = tt->rate.fft_size;
+
     tt->nominal_hz = nominal_hz;
     tt->start_time = time(NULL);
 
     /* Allocate buffers */
-    tt->buffer_i = (float *)calloc(TONE_FFT_SIZE, sizeof(float));
-    tt->buffer_q = (float *)calloc(TONE_FFT_SIZE, sizeof(float));
-    tt->fft_in = (kiss_fft_cpx *)malloc(TONE_FFT_SIZE * sizeof(kiss_fft_cpx));
-    tt->fft_out = (kiss_fft_cpx *)malloc(TONE_FFT_SIZE * sizeof(kiss_fft_cpx));
-    tt->window = (float *)malloc(TONE_FFT_SIZE * sizeof(float));
-    tt->magnitudes = (float *)malloc(TONE_FFT_SIZE * sizeof(float));
+    tt->buffer_i = (float *)calloc(fft_size, sizeof(float));
+    tt->buffer_q = (float *)calloc(fft_size, sizeof(float));
+    tt->fft_in = (kiss_fft_cpx *)malloc(fft_size * sizeof(kiss_fft_cpx));
+    tt->fft_out = (kiss_fft_cpx *)malloc(fft_size * sizeof(kiss_fft_cpx));
+    tt->window = (float *)malloc(fft_size * sizeof(float));
+    tt->magnitudes = (float *)malloc(fft_size * sizeof(float));
 
     if (!tt->buffer_i || !tt->buffer_q || !tt->fft_in ||
         !tt->fft_out || !tt->window || !tt->magnitudes) {
@@ -325,14 +340,14 @@ tone_tracker_t *tone_tracker_create(float nominal_hz, const char *csv_path) {
     }
 
     /* Initialize FFT */
-    tt->fft_cfg = kiss_fft_alloc(TONE_FFT_SIZE, 0, NULL, NULL);
+    tt->fft_cfg = kiss_fft_alloc(fft_size, 0, NULL, NULL);
     if (!tt->fft_cfg) {
         tone_tracker_destroy(tt);
         return NULL;
     }
 
     /* Generate window */
-    generate_blackman_harris(tt->window, TONE_FFT_SIZE);
+    generate_blackman_harris(tt->window, fft_size);
 
     /* Open CSV file */
     if (csv_path) {
@@ -346,14 +361,14 @@ tone_tracker_t *tone_tracker_create(float nominal_hz, const char *csv_path) {
                     nominal_hz, PHOENIX_VERSION_FULL);
             fprintf(tt->csv_file, "# Started: %s\n", time_str);
             fprintf(tt->csv_file, "# FFT: %d-pt, %.2f Hz/bin, %.1f ms frame\n",
-                    TONE_FFT_SIZE, TONE_HZ_PER_BIN, TONE_FRAME_MS);
+                    fft_size, tt->rate.hz_per_bin, tt->rate.frame_ms);
             fprintf(tt->csv_file, "time,timestamp_ms,measured_hz,offset_hz,offset_ppm,snr_db,valid\n");
             fflush(tt->csv_file);
         }
     }
 
-    printf("[TONE] Tracker created for %.0f Hz (%.2f Hz/bin, %.1f ms frame)\n",
-           nominal_hz, TONE_HZ_PER_BIN, TONE_FRAME_MS);
+    printf("[TONE] Tracker created for %.0f Hz at %d Hz (%.2f Hz/bin, %.1f ms frame)\n",
+           nominal_hz, sample_rate, tt->rate.hz_per_bin, tt->rate.frame_ms);
 
     return tt;
 }
@@ -378,11 +393,11 @@ void tone_tracker_process_sample(tone_tracker_t *tt, float i, float q) {
     /* Store sample in circular buffer */
     tt->buffer_i[tt->buffer_idx] = i;
     tt->buffer_q[tt->buffer_idx] = q;
-    tt->buffer_idx = (tt->buffer_idx + 1) % TONE_FFT_SIZE;
+    tt->buffer_idx = (tt->buffer_idx + 1) & (tt->rate.fft_size - 1);
     tt->samples_collected++;
 
     /* Process when buffer is full */
-    if (tt->samples_collected >= TONE_FFT_SIZE) {
+    if (tt->samples_collected >= tt->rate.fft_size) {
         tt->samples_collected = 0;
 
         measure_tone(tt);
@@ -416,6 +431,10 @@ uint64_t tone_tracker_get_frame_count(tone_tracker_t *tt) {
     return tt ? tt->frame_count : 0;
 }
 
+float tone_tracker_get_frame_ms(tone_tracker_t *tt) {
+    return tt ? tt->rate.frame_ms : TONE_FRAME_MS;
+}
+
 float tone_tracker_get_noise_floor(tone_tracker_t *tt) {
     return tt ? tt->noise_floor_linear : 0.0f;
 }
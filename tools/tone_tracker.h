@@ -19,7 +19,7 @@ typedef struct tone_tracker tone_tracker_t;
  * Configuration
  *============================================================================*/
 
-#define TONE_SAMPLE_RATE        12000       /* Match display path */
+#define TONE_SAMPLE_RATE        12000       /* Default: match display path */
 #define TONE_FFT_SIZE           4096        /* 2.93 Hz/bin */
 #define TONE_HZ_PER_BIN         ((float)TONE_SAMPLE_RATE / TONE_FFT_SIZE)
 #define TONE_FRAME_MS           ((float)TONE_FFT_SIZE * 1000.0f / TONE_SAMPLE_RATE)
@@ -32,9 +32,13 @@ typedef struct tone_tracker tone_tracker_t;
 
 /* Create tracker for specific nominal frequency (500 or 600 Hz) */
 tone_tracker_t *tone_tracker_create(float nominal_hz, const char *csv_path);
+
+/* Same, for another input rate: FFT scaled to keep TONE_HZ_PER_BIN
+ * (16384 points at 48 kHz). NULL if sample_rate is out of range. */
+tone_tracker_t *tone_tracker_create_rate(float nominal_hz, const char *csv_path, int sample_rate);
 void tone_tracker_destroy(tone_tracker_t *tt);
 
-/* Feed samples (from 12 kHz display path) */
+/* Feed samples (12 kHz display path, or the rate given at create) */
 void tone_tracker_process_sample(tone_tracker_t *tt, float i, float q);
 
 /* Query results */
@@ -45,6 +49,7 @@ float tone_tracker_get_snr_db(tone_tracker_t *tt);
 float tone_tracker_get_noise_floor(tone_tracker_t *tt);
 bool tone_tracker_is_valid(tone_tracker_t *tt);
 uint64_t tone_tracker_get_frame_count(tone_tracker_t *tt);
+float tone_tracker_get_frame_ms(tone_tracker_t *tt);
 
 /* Global subcarrier noise floor - exported for marker detector baseline */
 extern float g_subcarrier_noise_floor;
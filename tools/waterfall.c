@@ -13,12 +13,16 @@
 #include <string.h>
 #include <math.h>
 #include <time.h>
+#include <stdatomic.h>
 
 #include <SDL.h>
 #include "kiss_fft.h"
 #include "version.h"
 /* wwv_detector_manager.h available for future refactoring - see note below */
 #include "tick_detector.h"
+#include "dual_station_detector.h"
+#include "detector_params.h"
+#include "event_merge.h"
 #include "marker_detector.h"
 #include "sync_detector.h"
 #include "tone_tracker.h"
@@ -32,7 +36,11 @@
 #include "bcd_correlator.h"
 #include "waterfall_flash.h"
 #include "waterfall_telemetry.h"
-#include "channel_filters.h"
+#include "fft_filter_bank.h"
+#include "cmd_table.h"
+#include "block_normalizer.h"
+#include "iq_events.h"
+#include "iq_client.h"
 
 /*============================================================================
  * WWV Subcarrier Tone Schedule (minutes past the hour)
@@ -79,56 +87,16 @@ typedef int socket_t;
 #define Sleep(ms) usleep((ms) * 1000)
 #endif
 
-/* TCP recv result codes */
-typedef enum {
-    RECV_OK = 0,
-    RECV_TIMEOUT,
-    RECV_ERROR
-} recv_result_t;
-
 /*============================================================================
  * TCP Configuration and Protocol
  *============================================================================*/
 
 #define DEFAULT_IQ_PORT         4536
 
-#define MAGIC_PHXI  0x50485849
-#define MAGIC_IQDQ  0x49514451
-#define MAGIC_META  0x4D455441
-
-#define IQ_FORMAT_S16   1
-#define IQ_FORMAT_F32   2
-#define IQ_FORMAT_U8    3
-
-#pragma pack(push, 1)
-typedef struct {
-    uint32_t magic;
-    uint32_t version;
-    uint32_t sample_rate;
-    uint32_t sample_format;
-    uint32_t center_freq_lo;
-    uint32_t center_freq_hi;
-    uint32_t reserved[2];
-} iq_stream_header_t;
-
-typedef struct {
-    uint32_t magic;
-    uint32_t sequence;
-    uint32_t num_samples;
-    uint32_t flags;
-} iq_data_frame_t;
-
-typedef struct {
-    uint32_t magic;
-    uint32_t sample_rate;
-    uint32_t sample_format;
-    uint32_t center_freq_lo;
-    uint32_t center_freq_hi;
-    uint32_t gain_reduction;
-    uint32_t lna_state;
-    uint32_t reserved;
-} iq_metadata_update_t;
-#pragma pack(pop)
+#define IQ_FORMAT_S16   IQ_CLIENT_FORMAT_S16
+#define IQ_FORMAT_F32   IQ_CLIENT_FORMAT_F32
+#define IQ_FORMAT_U8    IQ_CLIENT_FORMAT_U8
+#define IQ_POLL_MS      100     /* Longest wait for I/Q data per main loop pass */
 
 /* TCP state */
 static bool g_tcp_mode = true;
@@ -136,9 +104,12 @@ static bool g_stdin_mode = false;
 static bool g_test_pattern = false;  /* Generate synthetic 1000Hz test tone */
 static bool g_log_csv = false;  /* Enable CSV logging (default: UDP only) */
 static bool g_reload_debug = false;  /* Reload tuned parameters from waterfall.ini */
+static bool g_detector_thread_enabled = false;  /* Run 50 kHz detector path on its own thread */
+static bool g_dual_station_enabled = false;  /* WWV/WWVH detector replaces the tick detector */
+static const char *g_tick_spill_path = NULL;  /* Binary log of aged tick correlator records */
 static char g_tcp_host[256] = "localhost";
 static int g_iq_port = DEFAULT_IQ_PORT;
-static socket_t g_iq_sock = SOCKET_INVALID;
+static iq_client_t *g_iq_client = NULL;
 static uint32_t g_tcp_sample_rate = 2000000;
 static uint64_t g_test_sample_count = 0;  /* Phase accumulator for test pattern */
 static uint32_t g_tcp_sample_format = IQ_FORMAT_S16;
@@ -152,11 +123,9 @@ static bool g_tcp_streaming = false;
  *============================================================================*/
 #define CMD_PORT            3006
 #define CMD_MAX_LEN         512
-#define CMD_RATE_LIMIT_PER_SEC  10
+#define CMD_MAX_PER_FRAME   1024    /* Datagrams drained per display frame */
 
 static socket_t g_cmd_sock = SOCKET_INVALID;
-static uint32_t g_cmd_count_this_sec = 0;
-static time_t g_cmd_rate_limit_sec = 0;
 
 /* Decimation factors (computed from TCP sample rate) */
 static int g_detector_decimation = 1;   /* 2 MHz → 48 kHz */
@@ -243,19 +212,39 @@ static lowpass_t g_detector_lowpass_q;
 static bool g_detector_dsp_initialized = false;
 static int g_detector_decim_counter = 0;
 
-/* Channel filters - Parallel sync/data architecture */
-static sync_channel_t g_sync_channel_i;
-static sync_channel_t g_sync_channel_q;
-static data_channel_t g_data_channel_i;
-static data_channel_t g_data_channel_q;
+/* Channel filters - Parallel sync/data bands from one overlap-save FFT.
+ * Linear phase, zero-phase aligned: detectors see no filter group delay. */
+static fft_filter_bank_t *g_channel_bank = NULL;
+static int g_sync_band = -1;    /* 800-1400 Hz: ticks/markers (WWV 1000, WWVH 1200) */
+static int g_data_band = -1;    /* 0-150 Hz: BCD subcarrier, every 32nd sample */
+
+/* 1562.5 Hz data channel: BCD FFTs shrink from 2048/256 to 64/8 points
+ * with the same frames and bins as at 50 kHz */
+#define BCD_SUBBAND_DECIMATION  32
 
 /* Signal normalizer - Slow AGC for gain-independent operation */
+static block_normalizer_t g_normalizer;
+static bool g_detector_held = false;   /* Input since last decimated sample was held */
+static int g_bank_hold_left = 0;        /* Held samples still inside the channel bank's window */
+
+/* Decimated samples waiting for the block normalizer, with the input
+ * sample and display frame each one's events are stamped with */
+#define DETECTOR_STAGE_SAMPLES  (BLOCK_NORM_CHUNK * 4)
+
 typedef struct {
-    float level;
-    int warmup;
-} normalizer_t;
+    int count;
+    float iq[DETECTOR_STAGE_SAMPLES * 2];
+    uint64_t sample[DETECTOR_STAGE_SAMPLES];
+    uint64_t frame_num[DETECTOR_STAGE_SAMPLES];
+    uint8_t held[DETECTOR_STAGE_SAMPLES];
+} detector_stage_t;
 
-static normalizer_t g_normalizer = {0.01f, 0};
+static detector_stage_t g_detector_stage;
+
+/* In-band event markers (stream version 2) */
+static bool g_iq_events = false;
+static iq_conditioner_t g_conditioner;
+static int g_display_hold_left = 0;     /* Held samples still inside the FFT window */
 
 /* Periodic sync check tracking */
 #define PERIODIC_CHECK_INTERVAL_SAMPLES  5000  /* 100ms at 50kHz */
@@ -360,19 +349,6 @@ static int g_selected_param = 0;
 
 static int g_effective_sample_rate = SAMPLE_RATE;
 
-/*============================================================================
- * Signal Normalization (Step 5: WWV Tick/BCD Separation)
- *============================================================================*/
-
-static float normalize(normalizer_t *n, float i, float q) {
-    float mag = sqrtf(i*i + q*q);
-    float alpha = (n->warmup < 50000) ? 0.01f : 0.0001f;  /* Fast warmup, then slow */
-    n->level += alpha * (mag - n->level);
-    n->warmup++;
-    if (n->level < 0.0001f) n->level = 0.0001f;
-    return 1.0f / n->level;
-}
-
 /*============================================================================
  * TCP Helper Functions
  *============================================================================*/
@@ -392,64 +368,6 @@ static void tcp_cleanup(void) {
 #endif
 }
 
-static socket_t tcp_connect(const char *host, int port) {
-    struct addrinfo hints, *result, *rp;
-    char port_str[16];
-    socket_t sock = SOCKET_INVALID;
-
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_family = AF_INET;
-    hints.ai_socktype = SOCK_STREAM;
-
-    snprintf(port_str, sizeof(port_str), "%d", port);
-
-    if (getaddrinfo(host, port_str, &hints, &result) != 0) {
-        fprintf(stderr, "Failed to resolve host: %s\n", host);
-        return SOCKET_INVALID;
-    }
-
-    for (rp = result; rp != NULL; rp = rp->ai_next) {
-        sock = socket(rp->ai_family, rp->ai_socktype, rp->ai_protocol);
-        if (sock == SOCKET_INVALID) continue;
-
-        if (connect(sock, rp->ai_addr, (int)rp->ai_addrlen) == 0) {
-            break;
-        }
-
-        socket_close(sock);
-        sock = SOCKET_INVALID;
-    }
-
-    freeaddrinfo(result);
-    return sock;
-}
-
-static recv_result_t tcp_recv_exact_ex(socket_t sock, void *buf, int n) {
-    char *ptr = (char *)buf;
-    int remaining = n;
-
-    while (remaining > 0) {
-        int received = recv(sock, ptr, remaining, 0);
-        if (received > 0) {
-            ptr += received;
-            remaining -= received;
-        } else if (received == 0) {
-            return RECV_ERROR;
-        } else {
-            int err = socket_errno;
-            if (err == EWOULDBLOCK_VAL || err == ETIMEDOUT_VAL) {
-                return RECV_TIMEOUT;
-            }
-            return RECV_ERROR;
-        }
-    }
-    return RECV_OK;
-}
-
-static bool tcp_recv_exact(socket_t sock, void *buf, int n) {
-    return tcp_recv_exact_ex(sock, buf, n) == RECV_OK;
-}
-
 static bool parse_tcp_arg(const char *arg) {
     char *colon = strchr(arg, ':');
     if (colon) {
@@ -465,407 +383,188 @@ static bool parse_tcp_arg(const char *arg) {
     return true;
 }
 
-/* Forward declarations for functions that use g_tick_detector (defined after detector globals) */
+/* Forward declarations for functions that use g_param_store (defined after detector globals) */
 static void save_tick_params_to_ini(void);
 static void load_tick_params_from_ini(void);
-static void set_tick_threshold(float mult);
-static void set_tick_adapt_down(float alpha);
-static void set_tick_adapt_up(float alpha);
-static void set_tick_min_duration(float ms);
-static void set_corr_epoch_confidence(float threshold);
-static void set_corr_max_misses(int max_misses);
-static void set_marker_threshold(float mult);
-static void set_marker_adapt_rate(float rate);
-static void set_marker_min_duration(float ms);
-static void set_sync_weight_tick(float weight);
-static void set_sync_weight_marker(float weight);
-static void set_sync_weight_p_marker(float weight);
-static void set_sync_weight_tick_hole(float weight);
-static void set_sync_weight_combined(float weight);
-static void set_sync_locked_threshold(float threshold);
-static void set_sync_min_retain(float threshold);
-static void set_sync_tentative_init(float threshold);
-static void set_sync_decay_normal(float decay);
-static void set_sync_decay_recovering(float decay);
-static void set_sync_tick_tolerance(float ms);
-static void set_sync_marker_tolerance(float ms);
-static void set_sync_p_marker_tolerance(float ms);
+static void set_detector_param(const char *section, const char *key, const char *label, float value);
+static void commit_detector_params(void);
 
 /*============================================================================
- * UDP Command Processor
+ * UDP Command Grammar
  *============================================================================*/
-static void process_modem_command(const char *cmd_buf, int len) {
-    /* Rate limiting check */
-    time_t now = time(NULL);
-    if (now != g_cmd_rate_limit_sec) {
-        g_cmd_rate_limit_sec = now;
-        g_cmd_count_this_sec = 0;
-    }
-    if (g_cmd_count_this_sec >= CMD_RATE_LIMIT_PER_SEC) {
-        telem_sendf(TELEM_RESP, "ERR RATE_LIMIT exceeded (%d/sec)\n", CMD_RATE_LIMIT_PER_SEC);
-        return;
-    }
-    g_cmd_count_this_sec++;
-
-    /* Null-terminate and log */
-    char cmd_str[CMD_MAX_LEN + 1];
-    int copy_len = (len < CMD_MAX_LEN) ? len : CMD_MAX_LEN;
-    memcpy(cmd_str, cmd_buf, copy_len);
-    cmd_str[copy_len] = '\0';
-
-    /* Remove trailing newline */
-    char *nl = strchr(cmd_str, '\n');
-    if (nl) *nl = '\0';
-    char *cr = strchr(cmd_str, '\r');
-    if (cr) *cr = '\0';
-
-    telem_sendf(TELEM_CTRL, "%s\n", cmd_str);
-
-    /* Parse command */
-    char cmd_name[64];
-    float value;
-    int parsed = sscanf(cmd_str, "%63s %f", cmd_name, &value);
-
-    if (parsed < 1) {
-        telem_sendf(TELEM_RESP, "ERR PARSE empty command\n");
-        return;
-    }
-
-    /* Telemetry control commands (working) */
-    if (strcmp(cmd_name, "ENABLE_TELEM") == 0) {
-        char channel_name[64];
-        if (sscanf(cmd_str, "%*s %63s", channel_name) == 1) {
-            if (strcmp(channel_name, "TICK") == 0) telem_enable(TELEM_TICKS);
-            else if (strcmp(channel_name, "MARK") == 0) telem_enable(TELEM_MARKERS);
-            else if (strcmp(channel_name, "SYNC") == 0) telem_enable(TELEM_SYNC);
-            else if (strcmp(channel_name, "CORR") == 0) telem_enable(TELEM_CORR);
-            else if (strcmp(channel_name, "CONS") == 0) telem_enable(TELEM_CONSOLE);
-            else {
-                telem_sendf(TELEM_RESP, "ERR UNKNOWN_CHANNEL %s\n", channel_name);
-                return;
-            }
-            telem_sendf(TELEM_RESP, "OK ENABLED %s\n", channel_name);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE ENABLE_TELEM requires channel name\n");
-        }
-        return;
-    }
-
-    if (strcmp(cmd_name, "DISABLE_TELEM") == 0) {
-        char channel_name[64];
-        if (sscanf(cmd_str, "%*s %63s", channel_name) == 1) {
-            if (strcmp(channel_name, "TICK") == 0) telem_disable(TELEM_TICKS);
-            else if (strcmp(channel_name, "MARK") == 0) telem_disable(TELEM_MARKERS);
-            else if (strcmp(channel_name, "SYNC") == 0) telem_disable(TELEM_SYNC);
-            else if (strcmp(channel_name, "CORR") == 0) telem_disable(TELEM_CORR);
-            else if (strcmp(channel_name, "CONS") == 0) telem_disable(TELEM_CONSOLE);
-            else {
-                telem_sendf(TELEM_RESP, "ERR UNKNOWN_CHANNEL %s\n", channel_name);
-                return;
-            }
-            telem_sendf(TELEM_RESP, "OK DISABLED %s\n", channel_name);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE DISABLE_TELEM requires channel name\n");
-        }
-        return;
-    }
-
-/* Tick detector parameter commands (fully functional) */
-    if (strcmp(cmd_name, "SET_TICK_THRESHOLD") == 0) {
-        if (parsed == 2) {
-            set_tick_threshold(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_TICK_THRESHOLD requires numeric value\n");
-        }
-        return;
-    }
-
-    if (strcmp(cmd_name, "SET_TICK_ADAPT_DOWN") == 0) {
-        if (parsed == 2) {
-            set_tick_adapt_down(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_TICK_ADAPT_DOWN requires numeric value\n");
-        }
-        return;
-    }
 
-    if (strcmp(cmd_name, "SET_TICK_ADAPT_UP") == 0) {
-        if (parsed == 2) {
-            set_tick_adapt_up(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_TICK_ADAPT_UP requires numeric value\n");
-        }
-        return;
-    }
-
-    if (strcmp(cmd_name, "SET_TICK_MIN_DURATION") == 0) {
-        if (parsed == 2) {
-            set_tick_min_duration(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_TICK_MIN_DURATION requires numeric value\n");
-        }
-        return;
-    }
-
-    /* Tick correlator parameter commands */
-    if (strcmp(cmd_name, "SET_CORR_CONFIDENCE") == 0) {
-        if (parsed == 2) {
-            set_corr_epoch_confidence(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_CORR_CONFIDENCE requires numeric value\n");
-        }
-        return;
-    }
-
-    if (strcmp(cmd_name, "SET_CORR_MAX_MISSES") == 0) {
-        if (parsed == 2) {
-            set_corr_max_misses((int)value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_CORR_MAX_MISSES requires numeric value\n");
-        }
-        return;
-    }
-
-    /* Marker detector parameter commands */
-    if (strcmp(cmd_name, "SET_MARKER_THRESHOLD") == 0) {
-        if (parsed == 2) {
-            set_marker_threshold(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_MARKER_THRESHOLD requires numeric value\n");
-        }
-        return;
-    }
-
-    if (strcmp(cmd_name, "SET_MARKER_ADAPT_RATE") == 0) {
-        if (parsed == 2) {
-            set_marker_adapt_rate(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_MARKER_ADAPT_RATE requires numeric value\n");
-        }
-        return;
-    }
-
-    if (strcmp(cmd_name, "SET_MARKER_MIN_DURATION") == 0) {
-        if (parsed == 2) {
-            set_marker_min_duration(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_MARKER_MIN_DURATION requires numeric value\n");
-        }
-        return;
-    }
-
-    /* Sync detector parameter commands */
-    if (strcmp(cmd_name, "SET_SYNC_WEIGHT_TICK") == 0) {
-        if (parsed == 2) {
-            set_sync_weight_tick(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_SYNC_WEIGHT_TICK requires numeric value\n");
-        }
-        return;
-    }
-
-    if (strcmp(cmd_name, "SET_SYNC_WEIGHT_MARKER") == 0) {
-        if (parsed == 2) {
-            set_sync_weight_marker(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_SYNC_WEIGHT_MARKER requires numeric value\n");
-        }
-        return;
-    }
-
-    if (strcmp(cmd_name, "SET_SYNC_WEIGHT_P_MARKER") == 0) {
-        if (parsed == 2) {
-            set_sync_weight_p_marker(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_SYNC_WEIGHT_P_MARKER requires numeric value\n");
-        }
-        return;
-    }
-
-    if (strcmp(cmd_name, "SET_SYNC_WEIGHT_TICK_HOLE") == 0) {
-        if (parsed == 2) {
-            set_sync_weight_tick_hole(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_SYNC_WEIGHT_TICK_HOLE requires numeric value\n");
-        }
-        return;
-    }
-
-    if (strcmp(cmd_name, "SET_SYNC_WEIGHT_COMBINED") == 0) {
-        if (parsed == 2) {
-            set_sync_weight_combined(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_SYNC_WEIGHT_COMBINED requires numeric value\n");
-        }
-        return;
-    }
-
-    if (strcmp(cmd_name, "SET_SYNC_LOCKED_THRESHOLD") == 0) {
-        if (parsed == 2) {
-            set_sync_locked_threshold(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_SYNC_LOCKED_THRESHOLD requires numeric value\n");
-        }
-        return;
-    }
+typedef enum {
+    WF_CMD_ENABLE_TELEM,
+    WF_CMD_DISABLE_TELEM,
+    WF_CMD_SET_PARAM
+} wf_cmd_id_t;
 
-    if (strcmp(cmd_name, "SET_SYNC_MIN_RETAIN") == 0) {
-        if (parsed == 2) {
-            set_sync_min_retain(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_SYNC_MIN_RETAIN requires numeric value\n");
-        }
-        return;
-    }
+/* SET_* target: parameter store section/key and the label echoed back */
+typedef struct {
+    const char *section;
+    const char *key;
+    const char *label;
+} wf_param_ref_t;
+
+static const char *const g_telem_channel_names[] = { "TICK", "MARK", "SYNC", "CORR", "CONS", NULL };
+static const uint32_t g_telem_channel_bits[] = {
+    TELEM_TICKS, TELEM_MARKERS, TELEM_SYNC, TELEM_CORR, TELEM_CONSOLE
+};
+
+#define WF_PARAM_CMD(name, arg, section, key, label) \
+    { name, WF_CMD_SET_PARAM, 1, 1, { arg }, &(const wf_param_ref_t){ section, key, label } }
+
+static const cmd_spec_t g_wf_commands[] = {
+    /* Telemetry control */
+    { "ENABLE_TELEM",  WF_CMD_ENABLE_TELEM,  1, 1, { CMD_SPEC_CHOICE(g_telem_channel_names) }, NULL },
+    { "DISABLE_TELEM", WF_CMD_DISABLE_TELEM, 1, 1, { CMD_SPEC_CHOICE(g_telem_channel_names) }, NULL },
+
+    /* Tick detector; ranges are enforced by the parameter store */
+    WF_PARAM_CMD("SET_TICK_THRESHOLD", CMD_SPEC_FLOAT(0, 0),
+                 "tick_detector", "threshold_multiplier", "threshold_multiplier"),
+    WF_PARAM_CMD("SET_TICK_ADAPT_DOWN", CMD_SPEC_FLOAT(0, 0),
+                 "tick_detector", "adapt_alpha_down", "adapt_alpha_down"),
+    WF_PARAM_CMD("SET_TICK_ADAPT_UP", CMD_SPEC_FLOAT(0, 0),
+                 "tick_detector", "adapt_alpha_up", "adapt_alpha_up"),
+    WF_PARAM_CMD("SET_TICK_MIN_DURATION", CMD_SPEC_FLOAT(0, 0),
+                 "tick_detector", "min_duration_ms", "min_duration_ms"),
+
+    /* Tick correlator */
+    WF_PARAM_CMD("SET_CORR_CONFIDENCE", CMD_SPEC_FLOAT(0, 0),
+                 "tick_correlator", "epoch_confidence_threshold", "epoch_confidence_threshold"),
+    WF_PARAM_CMD("SET_CORR_MAX_MISSES", CMD_SPEC_INT(0, 0),
+                 "tick_correlator", "max_consecutive_misses", "max_consecutive_misses"),
+
+    /* Marker detector */
+    WF_PARAM_CMD("SET_MARKER_THRESHOLD", CMD_SPEC_FLOAT(0, 0),
+                 "marker_detector", "threshold_multiplier", "marker_threshold_multiplier"),
+    WF_PARAM_CMD("SET_MARKER_ADAPT_RATE", CMD_SPEC_FLOAT(0, 0),
+                 "marker_detector", "noise_adapt_rate", "marker_noise_adapt_rate"),
+    WF_PARAM_CMD("SET_MARKER_MIN_DURATION", CMD_SPEC_FLOAT(0, 0),
+                 "marker_detector", "min_duration_ms", "marker_min_duration_ms"),
+
+    /* Sync detector */
+    WF_PARAM_CMD("SET_SYNC_WEIGHT_TICK", CMD_SPEC_FLOAT(0, 0),
+                 "sync_detector", "weight_tick", "weight_tick"),
+    WF_PARAM_CMD("SET_SYNC_WEIGHT_MARKER", CMD_SPEC_FLOAT(0, 0),
+                 "sync_detector", "weight_marker", "weight_marker"),
+    WF_PARAM_CMD("SET_SYNC_WEIGHT_P_MARKER", CMD_SPEC_FLOAT(0, 0),
+                 "sync_detector", "weight_p_marker", "weight_p_marker"),
+    WF_PARAM_CMD("SET_SYNC_WEIGHT_TICK_HOLE", CMD_SPEC_FLOAT(0, 0),
+                 "sync_detector", "weight_tick_hole", "weight_tick_hole"),
+    WF_PARAM_CMD("SET_SYNC_WEIGHT_COMBINED", CMD_SPEC_FLOAT(0, 0),
+                 "sync_detector", "weight_combined_hole_marker", "weight_combined_hole_marker"),
+    WF_PARAM_CMD("SET_SYNC_LOCKED_THRESHOLD", CMD_SPEC_FLOAT(0, 0),
+                 "sync_detector", "confidence_locked_threshold", "confidence_locked_threshold"),
+    WF_PARAM_CMD("SET_SYNC_MIN_RETAIN", CMD_SPEC_FLOAT(0, 0),
+                 "sync_detector", "confidence_min_retain", "confidence_min_retain"),
+    WF_PARAM_CMD("SET_SYNC_TENTATIVE_INIT", CMD_SPEC_FLOAT(0, 0),
+                 "sync_detector", "confidence_tentative_init", "confidence_tentative_init"),
+    WF_PARAM_CMD("SET_SYNC_DECAY_NORMAL", CMD_SPEC_FLOAT(0, 0),
+                 "sync_detector", "confidence_decay_normal", "confidence_decay_normal"),
+    WF_PARAM_CMD("SET_SYNC_DECAY_RECOVERING", CMD_SPEC_FLOAT(0, 0),
+                 "sync_detector", "confidence_decay_recovering", "confidence_decay_recovering"),
+    WF_PARAM_CMD("SET_SYNC_TICK_TOLERANCE", CMD_SPEC_FLOAT(0, 0),
+                 "sync_detector", "tick_phase_tolerance_ms", "tick_phase_tolerance_ms"),
+    WF_PARAM_CMD("SET_SYNC_MARKER_TOLERANCE", CMD_SPEC_FLOAT(0, 0),
+                 "sync_detector", "marker_tolerance_ms", "marker_tolerance_ms"),
+    WF_PARAM_CMD("SET_SYNC_P_MARKER_TOLERANCE", CMD_SPEC_FLOAT(0, 0),
+                 "sync_detector", "p_marker_tolerance_ms", "p_marker_tolerance_ms"),
+};
+
+#define NUM_WF_COMMANDS ((int)(sizeof(g_wf_commands) / sizeof(g_wf_commands[0])))
+
+static cmd_table_t g_wf_command_table;
 
-    if (strcmp(cmd_name, "SET_SYNC_TENTATIVE_INIT") == 0) {
-        if (parsed == 2) {
-            set_sync_tentative_init(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_SYNC_TENTATIVE_INIT requires numeric value\n");
-        }
-        return;
-    }
+/*============================================================================
+ * UDP Command Processor
+ *============================================================================*/
 
-    if (strcmp(cmd_name, "SET_SYNC_DECAY_NORMAL") == 0) {
-        if (parsed == 2) {
-            set_sync_decay_normal(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_SYNC_DECAY_NORMAL requires numeric value\n");
-        }
-        return;
-    }
+/* One datagram, NUL-terminated; tokenized in place */
+static void process_modem_command(char *cmd_str) {
+    /* Remove trailing newline and log */
+    cmd_str[strcspn(cmd_str, "\r\n")] = '\0';
+    telem_sendf(TELEM_CTRL, "%s\n", cmd_str);
 
-    if (strcmp(cmd_name, "SET_SYNC_DECAY_RECOVERING") == 0) {
-        if (parsed == 2) {
-            set_sync_decay_recovering(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_SYNC_DECAY_RECOVERING requires numeric value\n");
-        }
-        return;
-    }
+    cmd_parsed_t cmd;
+    cmd_table_status_t st = cmd_table_parse(&g_wf_command_table, cmd_str, &cmd);
 
-    if (strcmp(cmd_name, "SET_SYNC_TICK_TOLERANCE") == 0) {
-        if (parsed == 2) {
-            set_sync_tick_tolerance(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_SYNC_TICK_TOLERANCE requires numeric value\n");
-        }
-        return;
-    }
+    switch (st) {
+        case CMD_TABLE_OK:
+            break;
+        case CMD_TABLE_ERR_EMPTY:
+            telem_sendf(TELEM_RESP, "ERR PARSE empty command\n");
+            return;
+        case CMD_TABLE_ERR_UNKNOWN:
+            telem_sendf(TELEM_RESP, "ERR UNKNOWN_CMD %s\n", cmd.name);
+            return;
+        case CMD_TABLE_ERR_CHOICE:
+            telem_sendf(TELEM_RESP, "ERR UNKNOWN_CHANNEL %s\n", cmd.argv[cmd.bad_arg].text);
+            return;
+        default:
+            telem_sendf(TELEM_RESP, "ERR PARSE %s requires %s\n", cmd.spec->name,
+                        cmd.spec->id == WF_CMD_SET_PARAM ? "numeric value" : "channel name");
+            return;
+    }
+
+    switch ((wf_cmd_id_t)cmd.spec->id) {
+        case WF_CMD_ENABLE_TELEM:
+            telem_enable(g_telem_channel_bits[cmd.argv[0].choice]);
+            telem_sendf(TELEM_RESP, "OK ENABLED %s\n", g_telem_channel_names[cmd.argv[0].choice]);
+            break;
 
-    if (strcmp(cmd_name, "SET_SYNC_MARKER_TOLERANCE") == 0) {
-        if (parsed == 2) {
-            set_sync_marker_tolerance(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_SYNC_MARKER_TOLERANCE requires numeric value\n");
-        }
-        return;
-    }
+        case WF_CMD_DISABLE_TELEM:
+            telem_disable(g_telem_channel_bits[cmd.argv[0].choice]);
+            telem_sendf(TELEM_RESP, "OK DISABLED %s\n", g_telem_channel_names[cmd.argv[0].choice]);
+            break;
 
-    if (strcmp(cmd_name, "SET_SYNC_P_MARKER_TOLERANCE") == 0) {
-        if (parsed == 2) {
-            set_sync_p_marker_tolerance(value);
-        } else {
-            telem_sendf(TELEM_RESP, "ERR PARSE SET_SYNC_P_MARKER_TOLERANCE requires numeric value\n");
+        case WF_CMD_SET_PARAM: {
+            const wf_param_ref_t *ref = (const wf_param_ref_t *)cmd.spec->data;
+            set_detector_param(ref->section, ref->key, ref->label, (float)cmd.argv[0].f);
+            break;
         }
-        return;
     }
-
-    /* Unknown command */
-    telem_sendf(TELEM_RESP, "ERR UNKNOWN_CMD %s\n", cmd_name);
 }
 
-static bool tcp_reconnect(void) {
-    if (g_iq_sock != SOCKET_INVALID) {
-        socket_close(g_iq_sock);
-        g_iq_sock = SOCKET_INVALID;
-    }
-
+/* Connection lost: the client reconnects on its own, the DSP starts over */
+static void tcp_stream_lost(void) {
     g_detector_dsp_initialized = false;
     g_display_dsp_initialized = false;
     g_detector_decim_counter = 0;
     g_display_decim_counter = 0;
 
     /* Reset normalizer */
-    g_normalizer.level = 0.01f;
-    g_normalizer.warmup = 0;
-
-    printf("\n*** CONNECTION LOST - Reconnecting to %s:%d ***\n", g_tcp_host, g_iq_port);
-
-    int retry_count = 0;
-    while (g_iq_sock == SOCKET_INVALID) {
-        g_iq_sock = tcp_connect(g_tcp_host, g_iq_port);
-        if (g_iq_sock == SOCKET_INVALID) {
-            retry_count++;
-            if (retry_count == 1) {
-                printf("Waiting for server...\n");
-            } else if (retry_count % 10 == 0) {
-                printf("Still waiting... (%d attempts)\n", retry_count);
-            }
-            Sleep(1000);
-
-            SDL_Event event;
-            while (SDL_PollEvent(&event)) {
-                if (event.type == SDL_QUIT ||
-                    (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE)) {
-                    printf("User quit during reconnect\n");
-                    return false;
-                }
-            }
-        }
-    }
-
-    printf("*** RECONNECTED to %s:%d ***\n", g_tcp_host, g_iq_port);
-
-#ifdef _WIN32
-    DWORD timeout_ms = 5000;
-    setsockopt(g_iq_sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout_ms, sizeof(timeout_ms));
-#else
-    struct timeval tv = { .tv_sec = 5, .tv_usec = 0 };
-    setsockopt(g_iq_sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-#endif
-
-    iq_stream_header_t header;
-    if (!tcp_recv_exact(g_iq_sock, &header, sizeof(header))) {
-        fprintf(stderr, "Failed to read I/Q stream header after reconnect\n");
-        socket_close(g_iq_sock);
-        g_iq_sock = SOCKET_INVALID;
-        return tcp_reconnect();
-    }
+    block_normalizer_reset(&g_normalizer);
+    g_detector_held = false;
+    g_bank_hold_left = 0;
+    g_detector_stage.count = 0;
+    g_display_hold_left = 0;
+}
 
-    if (header.magic != MAGIC_PHXI) {
-        fprintf(stderr, "Invalid header magic after reconnect: 0x%08X\n", header.magic);
-        socket_close(g_iq_sock);
-        g_iq_sock = SOCKET_INVALID;
-        return tcp_reconnect();
-    }
+/* Stream header received: take the rate/format from it */
+static void tcp_stream_start(void) {
+    const iq_client_stream_t *st = iq_client_stream(g_iq_client);
 
-    g_tcp_sample_rate = header.sample_rate;
-    g_tcp_sample_format = header.sample_format;
-    g_tcp_center_freq = ((uint64_t)header.center_freq_hi << 32) | header.center_freq_lo;
+    g_tcp_sample_rate = st->sample_rate;
+    g_tcp_sample_format = st->sample_format;
+    g_tcp_center_freq = st->center_freq;
+    g_iq_events = st->events;
+    iq_conditioner_init(&g_conditioner, g_tcp_sample_rate);
 
-    printf("Stream header: rate=%u Hz, format=%u, freq=%llu Hz\n",
-           g_tcp_sample_rate, g_tcp_sample_format, (unsigned long long)g_tcp_center_freq);
+    printf("Stream: rate=%u Hz, format=%u, freq=%llu Hz%s\n",
+           g_tcp_sample_rate, g_tcp_sample_format, (unsigned long long)g_tcp_center_freq,
+           g_iq_events ? ", event markers" : "");
 
-    /* Recalculate decimation factors */
+    /* Calculate decimation factors for both paths */
     g_detector_decimation = g_tcp_sample_rate / DETECTOR_SAMPLE_RATE;
     if (g_detector_decimation < 1) g_detector_decimation = 1;
+
     g_display_decimation = g_tcp_sample_rate / DISPLAY_SAMPLE_RATE;
     if (g_display_decimation < 1) g_display_decimation = 1;
-    g_decimation_factor = g_detector_decimation;
 
-#ifdef _WIN32
-    timeout_ms = 100;
-    setsockopt(g_iq_sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout_ms, sizeof(timeout_ms));
-#else
-    tv.tv_sec = 0;
-    tv.tv_usec = 100000;
-    setsockopt(g_iq_sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-#endif
-
-    printf("Ready for I/Q data.\n\n");
-    return true;
+    /* Legacy compatibility */
+    g_decimation_factor = g_detector_decimation;
+    g_effective_sample_rate = g_tcp_sample_rate / g_detector_decimation;
 }
 
 static void print_usage(const char *progname) {
@@ -878,7 +577,10 @@ static void print_usage(const char *progname) {
     printf("  -x, --pos-x X           Set window X position (default: centered)\n");
     printf("  -y, --pos-y Y           Set window Y position (default: centered)\n");
     printf("  -l, --log-csv           Enable CSV file logging (default: UDP telemetry only)\n");
-    printf("  --reload-debug          Reload tuned parameters from waterfall.ini\n");
+    printf("  --reload-debug          Load tuned parameters from waterfall.ini and reload on change\n");
+    printf("  --detector-thread       Run the 50 kHz detector path on its own thread\n");
+    printf("  --dual-station          Separate WWV/WWVH ticks (replaces the single-station tick detector)\n");
+    printf("  --tick-spill FILE       Spill aged tick correlation records to a binary log\n");
     printf("  -h, --help              Show this help\n\n");
     printf("UDP Telemetry:          Broadcast on port 3005 (always enabled)\n");
     printf("Control Interface:      Type commands in console (freq, gain, status, etc.)\n");
@@ -897,7 +599,9 @@ static void print_usage(const char *progname) {
  *============================================================================*/
 
 static tick_detector_t *g_tick_detector = NULL;
+static dual_station_detector_t *g_dual_station = NULL;  /* --dual-station: WWV/WWVH in place of tick detector */
 static marker_detector_t *g_marker_detector = NULL;
+static subcarrier_frontend_t *g_subcarrier_fe = NULL;  /* 100 Hz front end shared by subcarrier consumers */
 static bcd_envelope_t *g_bcd_envelope = NULL;  /* DEPRECATED: Use bcd_time/freq_detector + bcd_correlator */
 static bcd_decoder_t *g_bcd_decoder = NULL;    /* DEPRECATED: Use bcd_correlator */
 static sync_detector_t *g_sync_detector = NULL;
@@ -915,347 +619,202 @@ static tone_tracker_t *g_tone_600 = NULL;
 static tick_correlator_t *g_tick_correlator = NULL;
 
 /*============================================================================
- * Tick Detector Parameter Control (calls setters + persists to INI)
+ * Detector Parameter Control
+ *
+ * Commands and INI reloads never touch detectors directly: they edit a copy
+ * of the current snapshot and publish it to g_param_store. The sample loop
+ * picks up the new snapshot at the next block boundary (apply_detector_params).
  *============================================================================*/
 
-static void set_tick_threshold(float mult) {
-    if (tick_detector_set_threshold_mult(g_tick_detector, mult)) {
-        save_tick_params_to_ini();
-        telem_sendf(TELEM_RESP, "OK threshold_multiplier=%.3f\n", mult);
-    } else {
-        telem_sendf(TELEM_RESP, "ERR 400 Invalid threshold_multiplier=%.3f (range 1.0-5.0)\n", mult);
-    }
+#define PARAMS_INI_PATH     "waterfall.ini"
+#define PARAMS_AUDIT_PATH   "waterfall_params.log"
+
+static detector_param_store_t *g_param_store = NULL;
+static uint32_t g_params_applied_version = 0;   /* Sample loop side */
+static time_t g_params_ini_check_sec = 0;       /* INI watch runs once per second */
+
+static void detector_path_sync(void);
+
+/* Read the detectors' compiled-in defaults into a snapshot */
+static void capture_detector_params(detector_params_t *p) {
+    memset(p, 0, sizeof(*p));
+    p->tick_threshold_mult = tick_detector_get_threshold_mult(g_tick_detector);
+    p->tick_adapt_alpha_down = tick_detector_get_adapt_alpha_down(g_tick_detector);
+    p->tick_adapt_alpha_up = tick_detector_get_adapt_alpha_up(g_tick_detector);
+    p->tick_min_duration_ms = tick_detector_get_min_duration_ms(g_tick_detector);
+
+    p->corr_epoch_confidence = tick_correlator_get_epoch_confidence(g_tick_correlator);
+    p->corr_max_misses = tick_correlator_get_max_misses(g_tick_correlator);
+
+    p->marker_threshold_mult = marker_detector_get_threshold_mult(g_marker_detector);
+    p->marker_noise_adapt_rate = marker_detector_get_noise_adapt_rate(g_marker_detector);
+    p->marker_min_duration_ms = marker_detector_get_min_duration_ms(g_marker_detector);
+
+    p->sync_weight_tick = sync_detector_get_weight_tick(g_sync_detector);
+    p->sync_weight_marker = sync_detector_get_weight_marker(g_sync_detector);
+    p->sync_weight_p_marker = sync_detector_get_weight_p_marker(g_sync_detector);
+    p->sync_weight_tick_hole = sync_detector_get_weight_tick_hole(g_sync_detector);
+    p->sync_weight_combined = sync_detector_get_weight_combined(g_sync_detector);
+    p->sync_locked_threshold = sync_detector_get_locked_threshold(g_sync_detector);
+    p->sync_min_retain = sync_detector_get_min_retain(g_sync_detector);
+    p->sync_tentative_init = sync_detector_get_tentative_init(g_sync_detector);
+    p->sync_decay_normal = sync_detector_get_decay_normal(g_sync_detector);
+    p->sync_decay_recovering = sync_detector_get_decay_recovering(g_sync_detector);
+    p->sync_tick_tolerance_ms = sync_detector_get_tick_tolerance(g_sync_detector);
+    p->sync_marker_tolerance_ms = sync_detector_get_marker_tolerance(g_sync_detector);
+    p->sync_p_marker_tolerance_ms = sync_detector_get_p_marker_tolerance(g_sync_detector);
 }
 
-static void set_tick_adapt_down(float alpha) {
-    if (tick_detector_set_adapt_alpha_down(g_tick_detector, alpha)) {
-        save_tick_params_to_ini();
-        telem_sendf(TELEM_RESP, "OK adapt_alpha_down=%.6f\n", alpha);
-    } else {
-        telem_sendf(TELEM_RESP, "ERR 400 Invalid adapt_alpha_down=%.6f (range 0.9-0.999)\n", alpha);
-    }
+/* Push a whole snapshot into the detectors - sample loop only, between blocks */
+static void apply_detector_params(const detector_params_t *p) {
+    tick_detector_set_threshold_mult(g_tick_detector, p->tick_threshold_mult);
+    tick_detector_set_adapt_alpha_down(g_tick_detector, p->tick_adapt_alpha_down);
+    tick_detector_set_adapt_alpha_up(g_tick_detector, p->tick_adapt_alpha_up);
+    tick_detector_set_min_duration_ms(g_tick_detector, p->tick_min_duration_ms);
+
+    tick_correlator_set_epoch_confidence(g_tick_correlator, p->corr_epoch_confidence);
+    tick_correlator_set_max_misses(g_tick_correlator, p->corr_max_misses);
+
+    marker_detector_set_threshold_mult(g_marker_detector, p->marker_threshold_mult);
+    marker_detector_set_noise_adapt_rate(g_marker_detector, p->marker_noise_adapt_rate);
+    marker_detector_set_min_duration_ms(g_marker_detector, p->marker_min_duration_ms);
+
+    sync_detector_set_weight_tick(g_sync_detector, p->sync_weight_tick);
+    sync_detector_set_weight_marker(g_sync_detector, p->sync_weight_marker);
+    sync_detector_set_weight_p_marker(g_sync_detector, p->sync_weight_p_marker);
+    sync_detector_set_weight_tick_hole(g_sync_detector, p->sync_weight_tick_hole);
+    sync_detector_set_weight_combined(g_sync_detector, p->sync_weight_combined);
+    sync_detector_set_locked_threshold(g_sync_detector, p->sync_locked_threshold);
+    sync_detector_set_min_retain(g_sync_detector, p->sync_min_retain);
+    sync_detector_set_tentative_init(g_sync_detector, p->sync_tentative_init);
+    sync_detector_set_decay_normal(g_sync_detector, p->sync_decay_normal);
+    sync_detector_set_decay_recovering(g_sync_detector, p->sync_decay_recovering);
+    sync_detector_set_tick_tolerance(g_sync_detector, p->sync_tick_tolerance_ms);
+    sync_detector_set_marker_tolerance(g_sync_detector, p->sync_marker_tolerance_ms);
+    sync_detector_set_p_marker_tolerance(g_sync_detector, p->sync_p_marker_tolerance_ms);
 }
 
-static void set_tick_adapt_up(float alpha) {
-    if (tick_detector_set_adapt_alpha_up(g_tick_detector, alpha)) {
-        save_tick_params_to_ini();
-        telem_sendf(TELEM_RESP, "OK adapt_alpha_up=%.6f\n", alpha);
-    } else {
-        telem_sendf(TELEM_RESP, "ERR 400 Invalid adapt_alpha_up=%.6f (range 0.001-0.1)\n", alpha);
+/* Block boundary: adopt a newer snapshot if one was published */
+static void poll_detector_params(void) {
+    detector_params_t p;
+    if (detector_param_store_poll(g_param_store, &g_params_applied_version, &p)) {
+        detector_path_sync();
+        apply_detector_params(&p);
+        telem_sendf(TELEM_CONSOLE, "[PARAM] Applied parameter set v%u\n", p.version);
     }
 }
 
-static void set_tick_min_duration(float ms) {
-    if (tick_detector_set_min_duration_ms(g_tick_detector, ms)) {
-        save_tick_params_to_ini();
-        telem_sendf(TELEM_RESP, "OK min_duration_ms=%.2f\n", ms);
-    } else {
-        telem_sendf(TELEM_RESP, "ERR 400 Invalid min_duration_ms=%.2f (range 1.0-10.0)\n", ms);
+/* UDP SETs edit one draft; commit_detector_params() publishes and persists
+ * it once per drained burst. g_cmd_base is the snapshot the draft started
+ * from, so the edits can be replayed if an INI reload publishes first. */
+static detector_params_t g_cmd_draft;
+static detector_params_t g_cmd_base;
+static bool g_cmd_draft_open = false;
+static bool g_cmd_draft_dirty = false;
+
+/* Edit one parameter in the draft, respond with the given label */
+static void set_detector_param(const char *section, const char *key, const char *label, float value) {
+    const detector_param_desc_t *desc = detector_params_find(section, key);
+    if (!desc || !g_param_store) {
+        telem_sendf(TELEM_RESP, "ERR 500 Parameter store unavailable for %s\n", label);
+        return;
     }
-}
-
-static void set_corr_epoch_confidence(float threshold) {
-    tick_correlator_set_epoch_confidence(g_tick_correlator, threshold);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK epoch_confidence_threshold=%.3f\n", threshold);
-}
-
-static void set_corr_max_misses(int max_misses) {
-    tick_correlator_set_max_misses(g_tick_correlator, max_misses);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK max_consecutive_misses=%d\n", max_misses);
-}
 
-static void set_marker_threshold(float mult) {
-    marker_detector_set_threshold_mult(g_marker_detector, mult);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK marker_threshold_multiplier=%.3f\n", mult);
-}
-
-static void set_marker_adapt_rate(float rate) {
-    marker_detector_set_noise_adapt_rate(g_marker_detector, rate);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK marker_noise_adapt_rate=%.6f\n", rate);
-}
-
-static void set_marker_min_duration(float ms) {
-    marker_detector_set_min_duration_ms(g_marker_detector, ms);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK marker_min_duration_ms=%.2f\n", ms);
-}
-
-static void set_sync_weight_tick(float weight) {
-    sync_detector_set_weight_tick(g_sync_detector, weight);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK weight_tick=%.3f\n", weight);
-}
-
-static void set_sync_weight_marker(float weight) {
-    sync_detector_set_weight_marker(g_sync_detector, weight);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK weight_marker=%.3f\n", weight);
-}
-
-static void set_sync_weight_p_marker(float weight) {
-    sync_detector_set_weight_p_marker(g_sync_detector, weight);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK weight_p_marker=%.3f\n", weight);
-}
-
-static void set_sync_weight_tick_hole(float weight) {
-    sync_detector_set_weight_tick_hole(g_sync_detector, weight);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK weight_tick_hole=%.3f\n", weight);
-}
-
-static void set_sync_weight_combined(float weight) {
-    sync_detector_set_weight_combined(g_sync_detector, weight);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK weight_combined_hole_marker=%.3f\n", weight);
-}
-
-static void set_sync_locked_threshold(float threshold) {
-    sync_detector_set_locked_threshold(g_sync_detector, threshold);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK confidence_locked_threshold=%.3f\n", threshold);
-}
-
-static void set_sync_min_retain(float threshold) {
-    sync_detector_set_min_retain(g_sync_detector, threshold);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK confidence_min_retain=%.3f\n", threshold);
-}
-
-static void set_sync_tentative_init(float threshold) {
-    sync_detector_set_tentative_init(g_sync_detector, threshold);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK confidence_tentative_init=%.3f\n", threshold);
-}
-
-static void set_sync_decay_normal(float decay) {
-    sync_detector_set_decay_normal(g_sync_detector, decay);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK confidence_decay_normal=%.4f\n", decay);
-}
-
-static void set_sync_decay_recovering(float decay) {
-    sync_detector_set_decay_recovering(g_sync_detector, decay);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK confidence_decay_recovering=%.4f\n", decay);
-}
+    if (!g_cmd_draft_open) {
+        detector_param_store_snapshot(g_param_store, &g_cmd_draft);
+        g_cmd_base = g_cmd_draft;
+        g_cmd_draft_open = true;
+    }
+    if (detector_params_set(&g_cmd_draft, desc, value) != DETECTOR_PARAM_OK) {
+        telem_sendf(TELEM_RESP, "ERR 400 Invalid %s=%g (range %g-%g)\n",
+                    label, value, desc->min, desc->max);
+        return;
+    }
+    g_cmd_draft_dirty = true;
 
-static void set_sync_tick_tolerance(float ms) {
-    sync_detector_set_tick_tolerance(g_sync_detector, ms);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK tick_phase_tolerance_ms=%.1f\n", ms);
+    char value_str[32];
+    detector_params_format(&g_cmd_draft, desc, value_str, sizeof(value_str));
+    telem_sendf(TELEM_RESP, "OK %s=%s\n", label, value_str);
 }
 
-static void set_sync_marker_tolerance(float ms) {
-    sync_detector_set_marker_tolerance(g_sync_detector, ms);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK marker_tolerance_ms=%.1f\n", ms);
+/* Move the burst's edits onto the current snapshot after a publish conflict */
+static void rebase_cmd_draft(void) {
+    detector_params_t old_base = g_cmd_base;
+    detector_params_t edits = g_cmd_draft;
+    detector_param_store_snapshot(g_param_store, &g_cmd_base);
+    g_cmd_draft = g_cmd_base;
+    for (int i = 0; i < detector_params_count(); i++) {
+        const detector_param_desc_t *desc = detector_params_desc(i);
+        float value = detector_params_get(&edits, desc);
+        if (value != detector_params_get(&old_base, desc)) {
+            detector_params_set(&g_cmd_draft, desc, value);
+        }
+    }
 }
 
-static void set_sync_p_marker_tolerance(float ms) {
-    sync_detector_set_p_marker_tolerance(g_sync_detector, ms);
-    save_tick_params_to_ini();
-    telem_sendf(TELEM_RESP, "OK p_marker_tolerance_ms=%.1f\n", ms);
+/* End of a command burst: publish, persist */
+static void commit_detector_params(void) {
+    if (g_cmd_draft_dirty) {
+        while (detector_param_store_publish(g_param_store, &g_cmd_draft, "udp") ==
+               DETECTOR_PARAM_STORE_CONFLICT) {
+            rebase_cmd_draft();
+        }
+        save_tick_params_to_ini();
+    }
+    g_cmd_draft_open = false;
+    g_cmd_draft_dirty = false;
 }
 
 /*============================================================================
  * INI File Persistence for Tunable Parameters
  *============================================================================*/
-
-static void save_tick_params_to_ini(void) {
-    FILE *f = fopen("waterfall.ini", "w");
-    if (!f) {
-        telem_sendf(TELEM_CONSOLE, "[WARN] Could not write waterfall.ini\n");
-        return;
-    }
-
-    fprintf(f, "[tick_detector]\n");
-    fprintf(f, "threshold_multiplier=%.3f\n", tick_detector_get_threshold_mult(g_tick_detector));
-    fprintf(f, "adapt_alpha_down=%.6f\n", tick_detector_get_adapt_alpha_down(g_tick_detector));
-    fprintf(f, "adapt_alpha_up=%.6f\n", tick_detector_get_adapt_alpha_up(g_tick_detector));
-    fprintf(f, "min_duration_ms=%.2f\n", tick_detector_get_min_duration_ms(g_tick_detector));
-
-    fprintf(f, "\n[tick_correlator]\n");
-    fprintf(f, "epoch_confidence_threshold=%.3f\n", tick_correlator_get_epoch_confidence(g_tick_correlator));
-    fprintf(f, "max_consecutive_misses=%d\n", tick_correlator_get_max_misses(g_tick_correlator));
-
-    fprintf(f, "\n[marker_detector]\n");
-    fprintf(f, "threshold_multiplier=%.3f\n", marker_detector_get_threshold_mult(g_marker_detector));
-    fprintf(f, "noise_adapt_rate=%.6f\n", marker_detector_get_noise_adapt_rate(g_marker_detector));
-    fprintf(f, "min_duration_ms=%.2f\n", marker_detector_get_min_duration_ms(g_marker_detector));
-
-    fprintf(f, "\n[sync_detector]\n");
-    fprintf(f, "weight_tick=%.3f\n", sync_detector_get_weight_tick(g_sync_detector));
-    fprintf(f, "weight_marker=%.3f\n", sync_detector_get_weight_marker(g_sync_detector));
-    fprintf(f, "weight_p_marker=%.3f\n", sync_detector_get_weight_p_marker(g_sync_detector));
-    fprintf(f, "weight_tick_hole=%.3f\n", sync_detector_get_weight_tick_hole(g_sync_detector));
-    fprintf(f, "weight_combined_hole_marker=%.3f\n", sync_detector_get_weight_combined(g_sync_detector));
-    fprintf(f, "confidence_locked_threshold=%.3f\n", sync_detector_get_locked_threshold(g_sync_detector));
-    fprintf(f, "confidence_min_retain=%.3f\n", sync_detector_get_min_retain(g_sync_detector));
-    fprintf(f, "confidence_tentative_init=%.3f\n", sync_detector_get_tentative_init(g_sync_detector));
-    fprintf(f, "confidence_decay_normal=%.4f\n", sync_detector_get_decay_normal(g_sync_detector));
-    fprintf(f, "confidence_decay_recovering=%.4f\n", sync_detector_get_decay_recovering(g_sync_detector));
-    fprintf(f, "tick_phase_tolerance_ms=%.1f\n", sync_detector_get_tick_tolerance(g_sync_detector));
-    fprintf(f, "marker_tolerance_ms=%.1f\n", sync_detector_get_marker_tolerance(g_sync_detector));
-    fprintf(f, "p_marker_tolerance_ms=%.1f\n", sync_detector_get_p_marker_tolerance(g_sync_detector));
-
-    fclose(f);
-}
-
-static void load_tick_params_from_ini(void) {
-    FILE *f = fopen("waterfall.ini", "r");
-    if (!f) {
-        telem_sendf(TELEM_CONSOLE, "[INIT] No waterfall.ini found, using defaults\n");
-        return;
-    }
-
-    char line[256];
-    bool in_tick_section = false;
-    bool in_corr_section = false;
-    bool in_marker_section = false;
-    bool in_sync_section = false;
-    int params_loaded = 0;
-
-    while (fgets(line, sizeof(line), f)) {
-        /* Check for section header */
-        if (strstr(line, "[tick_detector]")) {
-            in_tick_section = true;
-            in_corr_section = false;
-            in_marker_section = false;
-            continue;
-        }
-        if (strstr(line, "[tick_correlator]")) {
-            in_tick_section = false;
-            in_corr_section = true;
-            in_marker_section = false;
-            continue;
-        }
-        if (strstr(line, "[marker_detector]")) {
-            in_tick_section = false;
-            in_corr_section = false;
-            in_marker_section = true;
-            in_sync_section = false;
-            continue;
-        }
-        if (strstr(line, "[sync_detector]")) {
-            in_tick_section = false;
-            in_corr_section = false;
-            in_marker_section = false;
-            in_sync_section = true;
-            continue;
-        }
-        if (line[0] == '[') {
-            in_tick_section = false;
-            in_corr_section = false;
-            in_marker_section = false;
-            in_sync_section = false;
-            continue;
-        }
-
-        /* Parse key=value */
-        char *eq = strchr(line, '=');
-        if (!eq) continue;
-
-        float value = (float)atof(eq + 1);
-
-        if (in_tick_section) {
-            if (strstr(line, "threshold_multiplier=")) {
-                if (tick_detector_set_threshold_mult(g_tick_detector, value)) {
-                    params_loaded++;
-                } else {
-                    telem_sendf(TELEM_CONSOLE, "[WARN] Invalid threshold_multiplier=%.3f in INI, using default\n", value);
-                }
-            } else if (strstr(line, "adapt_alpha_down=")) {
-                if (tick_detector_set_adapt_alpha_down(g_tick_detector, value)) {
-                    params_loaded++;
-                } else {
-                    telem_sendf(TELEM_CONSOLE, "[WARN] Invalid adapt_alpha_down=%.6f in INI, using default\n", value);
-                }
-            } else if (strstr(line, "adapt_alpha_up=")) {
-                if (tick_detector_set_adapt_alpha_up(g_tick_detector, value)) {
-                    params_loaded++;
-                } else {
-                    telem_sendf(TELEM_CONSOLE, "[WARN] Invalid adapt_alpha_up=%.6f in INI, using default\n", value);
-                }
-            } else if (strstr(line, "min_duration_ms=")) {
-                if (tick_detector_set_min_duration_ms(g_tick_detector, value)) {
-                    params_loaded++;
-                } else {
-                    telem_sendf(TELEM_CONSOLE, "[WARN] Invalid min_duration_ms=%.2f in INI, using default\n", value);
-                }
-            }
-        } else if (in_corr_section) {
-            if (strstr(line, "epoch_confidence_threshold=")) {
-                tick_correlator_set_epoch_confidence(g_tick_correlator, value);
-                params_loaded++;
-            } else if (strstr(line, "max_consecutive_misses=")) {
-                tick_correlator_set_max_misses(g_tick_correlator, (int)value);
-                params_loaded++;
-            }
-        } else if (in_marker_section) {
-            if (strstr(line, "threshold_multiplier=")) {
-                marker_detector_set_threshold_mult(g_marker_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "noise_adapt_rate=")) {
-                marker_detector_set_noise_adapt_rate(g_marker_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "min_duration_ms=")) {
-                marker_detector_set_min_duration_ms(g_marker_detector, value);
-                params_loaded++;
-            }
-        } else if (in_sync_section) {
-            if (strstr(line, "weight_tick=")) {
-                sync_detector_set_weight_tick(g_sync_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "weight_marker=")) {
-                sync_detector_set_weight_marker(g_sync_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "weight_p_marker=")) {
-                sync_detector_set_weight_p_marker(g_sync_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "weight_tick_hole=")) {
-                sync_detector_set_weight_tick_hole(g_sync_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "weight_combined_hole_marker=")) {
-                sync_detector_set_weight_combined(g_sync_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "confidence_locked_threshold=")) {
-                sync_detector_set_locked_threshold(g_sync_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "confidence_min_retain=")) {
-                sync_detector_set_min_retain(g_sync_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "confidence_tentative_init=")) {
-                sync_detector_set_tentative_init(g_sync_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "confidence_decay_normal=")) {
-                sync_detector_set_decay_normal(g_sync_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "confidence_decay_recovering=")) {
-                sync_detector_set_decay_recovering(g_sync_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "tick_phase_tolerance_ms=")) {
-                sync_detector_set_tick_tolerance(g_sync_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "marker_tolerance_ms=")) {
-                sync_detector_set_marker_tolerance(g_sync_detector, value);
-                params_loaded++;
-            } else if (strstr(line, "p_marker_tolerance_ms=")) {
-                sync_detector_set_p_marker_tolerance(g_sync_detector, value);
-                params_loaded++;
-            }
-        }
+
+static void save_tick_params_to_ini(void) {
+    if (!detector_param_store_save_ini(g_param_store)) {
+        telem_sendf(TELEM_CONSOLE, "[WARN] Could not write %s\n", PARAMS_INI_PATH);
     }
+}
+
+static void load_tick_params_from_ini(void) {
+    detector_params_t draft;
+    detector_param_store_snapshot(g_param_store, &draft);
 
-    fclose(f);
+    int rejected = 0;
+    int params_loaded = detector_params_load_ini(PARAMS_INI_PATH, &draft, &rejected);
+    if (params_loaded < 0) {
+        telem_sendf(TELEM_CONSOLE, "[INIT] No %s found, using defaults\n", PARAMS_INI_PATH);
+        return;
+    }
+    if (rejected > 0) {
+        telem_sendf(TELEM_CONSOLE, "[WARN] %d out-of-range value(s) in %s, using defaults\n",
+                    rejected, PARAMS_INI_PATH);
+    }
 
+    detector_param_store_publish(g_param_store, &draft, "ini");
     if (params_loaded > 0) {
-        telem_sendf(TELEM_CONSOLE, "[INIT] Loaded %d debug parameters from waterfall.ini\n", params_loaded);
+        telem_sendf(TELEM_CONSOLE, "[INIT] Loaded %d debug parameters from %s\n", params_loaded, PARAMS_INI_PATH);
+    }
+}
+
+/* Create the store from detector defaults - call once all tunable detectors exist */
+static bool init_param_store(void) {
+    detector_params_t initial;
+    capture_detector_params(&initial);
+
+    g_param_store = detector_param_store_create(&initial, PARAMS_AUDIT_PATH);
+    if (!g_param_store) {
+        return false;
+    }
+    detector_param_store_watch_ini(g_param_store, PARAMS_INI_PATH);
+
+    /* Load tuned parameters from INI if --reload-debug flag set */
+    if (g_reload_debug) {
+        load_tick_params_from_ini();
     }
+
+    /* Apply before the first sample so detectors start on the loaded set */
+    poll_detector_params();
+    return true;
 }
 
 /*============================================================================
@@ -1495,6 +1054,489 @@ static void on_bcd_freq_event(const bcd_freq_event_t *event, void *user_data) {
     }
 }
 
+/*============================================================================
+ * Detector Event Merge
+ *
+ * Detector callbacks do not drive the correlators directly. They queue a
+ * copy of the event stamped with the input sample index, and the main loop
+ * delivers the merged stream in sample order (event_merge.c). Serial and
+ * --detector-thread runs therefore feed sync_detector, marker_correlator,
+ * bcd_correlator and tick_correlator in exactly the same order.
+ *
+ * Producer rank follows the serial loop: for each input sample the 50 kHz
+ * detector path runs before the display path.
+ *============================================================================*/
+
+enum {
+    PRODUCER_DETECTOR = 0,              /* 50 kHz path: tick, marker, BCD time/freq */
+    PRODUCER_DISPLAY,                   /* 12 kHz path: slow marker */
+    NUM_PRODUCERS
+};
+
+typedef enum {
+    WF_EVT_TICK,
+    WF_EVT_TICK_MARKER,
+    WF_EVT_MARKER,
+    WF_EVT_SLOW_MARKER,
+    WF_EVT_BCD_TIME,
+    WF_EVT_BCD_FREQ,
+    WF_EVT_PERIODIC_CHECK
+} wf_event_type_t;
+
+_Static_assert(sizeof(tick_event_t) <= EVENT_MERGE_PAYLOAD_SIZE, "tick_event_t too large");
+_Static_assert(sizeof(tick_marker_event_t) <= EVENT_MERGE_PAYLOAD_SIZE, "tick_marker_event_t too large");
+_Static_assert(sizeof(marker_event_t) <= EVENT_MERGE_PAYLOAD_SIZE, "marker_event_t too large");
+_Static_assert(sizeof(slow_marker_frame_t) <= EVENT_MERGE_PAYLOAD_SIZE, "slow_marker_frame_t too large");
+_Static_assert(sizeof(bcd_time_event_t) <= EVENT_MERGE_PAYLOAD_SIZE, "bcd_time_event_t too large");
+_Static_assert(sizeof(bcd_freq_event_t) <= EVENT_MERGE_PAYLOAD_SIZE, "bcd_freq_event_t too large");
+
+#define EVENT_QUEUE_CAPACITY    4096    /* Events per producer (~minutes of normal traffic) */
+
+static event_merge_t *g_event_merge = NULL;
+static uint64_t g_input_samples = 0;            /* Input samples consumed (main thread) */
+static uint64_t g_detector_sample_index = 0;    /* Sample on the detector path (detector thread) */
+
+/* Channel bank outputs are zero-phase aligned but come out a block late:
+ * remember the input sample of each bank input, so sync/data events are
+ * stamped with the sample their output belongs to */
+#define BANK_SAMPLE_RING        FFT_BANK_DEFAULT_FFT_SIZE   /* > block + look-ahead */
+static uint64_t g_bank_input_sample[BANK_SAMPLE_RING];
+static uint64_t g_bank_pushed = 0;              /* Bank inputs since reset */
+static uint64_t g_bank_next_position = 0;       /* Bank input of the next block's first output */
+static uint64_t g_bank_sample_index = 0;        /* Input sample of the output being fed */
+static uint64_t g_bank_watermark = 0;
+
+/* Input sample of the next bank output: no detector event can be stamped
+ * below it any more */
+static uint64_t detector_path_watermark(void) {
+    if (g_bank_next_position < g_bank_pushed) {
+        uint64_t s = g_bank_input_sample[g_bank_next_position % BANK_SAMPLE_RING];
+        if (s > g_bank_watermark) g_bank_watermark = s;
+    }
+    return g_bank_watermark;
+}
+
+static void channel_bank_reset(void) {
+    fft_filter_bank_reset(g_channel_bank);
+    g_bank_pushed = 0;
+    g_bank_next_position = 0;
+    g_bank_hold_left = 0;
+}
+
+/* Detector thread state (--detector-thread) */
+#define DETECTOR_BLOCK_SAMPLES  4096
+#define DETECTOR_RING_BLOCKS    64      /* ~130 ms of input at 2 MSPS */
+
+typedef struct {
+    uint64_t first_sample;
+    uint64_t frame_num;                 /* Display frame the block arrived in */
+    int count;
+    float iq[DETECTOR_BLOCK_SAMPLES * 2];
+    uint8_t hold[DETECTOR_BLOCK_SAMPLES];  /* Event markers: freeze adaptation */
+} detector_block_t;
+
+static SDL_Thread *g_detector_thread = NULL;
+static detector_block_t *g_detector_ring = NULL;
+static atomic_size_t g_detector_ring_head;      /* Next block the worker runs */
+static atomic_size_t g_detector_ring_tail;      /* Next block main fills */
+static atomic_bool g_detector_thread_stop;
+static void drain_detector_events(void);
+
+/* Queue an event; in threaded mode wait for the consumer if the queue is full */
+static void queue_detector_event(int producer, uint64_t sample, wf_event_type_t type,
+                                 const void *event, size_t size) {
+    while (!event_merge_push(g_event_merge, producer, sample, (uint16_t)type, event, size)) {
+        if (g_detector_thread_enabled) {
+            SDL_Delay(1);
+        } else {
+            /* Serial: nothing below this sample can still arrive from the pushing
+             * path, nor below the bank's next output from the detector path */
+            event_merge_advance(g_event_merge, PRODUCER_DETECTOR,
+                                producer == PRODUCER_DETECTOR ? sample : detector_path_watermark());
+            event_merge_advance(g_event_merge, PRODUCER_DISPLAY, sample);
+            drain_detector_events();
+        }
+    }
+}
+
+static void queue_tick_event(const tick_event_t *event, void *user_data) {
+    (void)user_data;
+    queue_detector_event(PRODUCER_DETECTOR, g_bank_sample_index, WF_EVT_TICK, event, sizeof(*event));
+}
+
+static void queue_tick_marker(const tick_marker_event_t *event, void *user_data) {
+    (void)user_data;
+    queue_detector_event(PRODUCER_DETECTOR, g_bank_sample_index, WF_EVT_TICK_MARKER, event, sizeof(*event));
+}
+
+/* --dual-station: WWV pulses stand in for tick detector events. WWVH is
+ * logged and sent as STATION telemetry by the detector itself. */
+static void queue_station_tick(const station_tick_event_t *event, void *user_data) {
+    (void)user_data;
+    if (event->station != WWV_STATION_WWV) return;
+
+    if (event->is_marker) {
+        tick_marker_event_t marker = {
+            .marker_number = event->tick_number,
+            .timestamp_ms = (float)event->timestamp_ms,
+            .start_timestamp_ms = (float)event->leading_edge_ms,
+            .duration_ms = event->duration_ms,
+            .corr_ratio = event->corr_ratio,
+            .interval_ms = event->interval_ms
+        };
+        queue_tick_marker(&marker, NULL);
+    } else {
+        /* Matched filter leading edge, not the frame-quantized trailing edge */
+        tick_event_t tick = {
+            .tick_number = event->tick_number,
+            .timestamp_ms = event->leading_edge_ms,
+            .interval_ms = event->interval_ms,
+            .duration_ms = event->duration_ms,
+            .peak_energy = event->peak_energy,
+            .avg_interval_ms = 0.0f,            /* Not tracked per station */
+            .noise_floor = event->noise_floor,
+            .corr_peak = event->corr_peak,
+            .corr_ratio = event->corr_ratio
+        };
+        queue_tick_event(&tick, NULL);
+    }
+}
+
+static void queue_marker_event(const marker_event_t *event, void *user_data) {
+    (void)user_data;
+    queue_detector_event(PRODUCER_DETECTOR, g_bank_sample_index, WF_EVT_MARKER, event, sizeof(*event));
+}
+
+static void queue_bcd_time_event(const bcd_time_event_t *event, void *user_data) {
+    (void)user_data;
+    queue_detector_event(PRODUCER_DETECTOR, g_bank_sample_index, WF_EVT_BCD_TIME, event, sizeof(*event));
+}
+
+static void queue_bcd_freq_event(const bcd_freq_event_t *event, void *user_data) {
+    (void)user_data;
+    queue_detector_event(PRODUCER_DETECTOR, g_bank_sample_index, WF_EVT_BCD_FREQ, event, sizeof(*event));
+}
+
+/* Display FFT runs after the block, so its frames belong to the last sample consumed */
+static void queue_slow_marker_frame(const slow_marker_frame_t *frame, void *user_data) {
+    (void)user_data;
+    queue_detector_event(PRODUCER_DISPLAY, g_input_samples - 1, WF_EVT_SLOW_MARKER, frame, sizeof(*frame));
+}
+
+static void dispatch_detector_event(const merge_event_t *event, void *user_data) {
+    (void)user_data;
+    const void *p = event->payload.bytes;
+
+    switch ((wf_event_type_t)event->type) {
+        case WF_EVT_TICK:
+            on_tick_event((const tick_event_t *)p, NULL);
+            break;
+        case WF_EVT_TICK_MARKER:
+            on_tick_marker((const tick_marker_event_t *)p, NULL);
+            break;
+        case WF_EVT_MARKER:
+            on_marker_event((const marker_event_t *)p, NULL);
+            break;
+        case WF_EVT_SLOW_MARKER:
+            on_slow_marker_frame((const slow_marker_frame_t *)p, NULL);
+            break;
+        case WF_EVT_BCD_TIME:
+            on_bcd_time_event((const bcd_time_event_t *)p, g_bcd_correlator);
+            break;
+        case WF_EVT_BCD_FREQ:
+            on_bcd_freq_event((const bcd_freq_event_t *)p, g_bcd_correlator);
+            break;
+        case WF_EVT_PERIODIC_CHECK: {
+            float timestamp_ms;
+            memcpy(&timestamp_ms, p, sizeof(timestamp_ms));
+            if (g_sync_detector) {
+                sync_detector_periodic_check(g_sync_detector, timestamp_ms);
+            }
+            break;
+        }
+    }
+}
+
+static void drain_detector_events(void) {
+    event_merge_drain(g_event_merge, dispatch_detector_event, NULL);
+}
+
+/*============================================================================
+ * Detector Path (50 kHz)
+ *
+ * Runs inline on the main thread, or on its own thread with
+ * --detector-thread. The main thread hands over input in blocks that never
+ * span a display frame, and only touches detector state (parameter apply,
+ * metadata, key commands) after detector_path_sync() has emptied the ring.
+ * The display reads a few detector fields (flash counters, threshold,
+ * noise floor) unsynchronized - those are drawing hints only.
+ *============================================================================*/
+
+/* One normalized sample through the channel bank and the detectors */
+static void detector_path_detect(float det_i, float det_q, bool held, uint64_t frame_num) {
+    /* A held input smears over half a filter either side of it, so a block
+     * is held while one is inside the last FFT's worth of input */
+    if (held) {
+        g_bank_hold_left = FFT_BANK_DEFAULT_FFT_SIZE;
+    } else if (g_bank_hold_left > 0) {
+        g_bank_hold_left--;
+    }
+
+    /* Channel bank emits a block of filtered samples per FFT; events raised
+     * while feeding an output are stamped with that output's input sample */
+    g_bank_input_sample[g_bank_pushed++ % BANK_SAMPLE_RING] = g_detector_sample_index;
+    if (fft_filter_bank_push(g_channel_bank, det_i, det_q)) {
+        int n_sync, n_data;
+        const float *sync = fft_filter_bank_output(g_channel_bank, g_sync_band, &n_sync);
+        const float *data = fft_filter_bank_output(g_channel_bank, g_data_band, &n_data);
+        uint64_t sync_pos = fft_filter_bank_output_position(g_channel_bank, g_sync_band);
+        uint64_t data_pos = fft_filter_bank_output_position(g_channel_bank, g_data_band);
+        int sync_step = fft_filter_bank_decimation(g_channel_bank, g_sync_band);
+        int data_step = fft_filter_bank_decimation(g_channel_bank, g_data_band);
+        g_bank_next_position = sync_pos + (uint64_t)n_sync * (uint64_t)sync_step;
+
+        /* Noise floors frozen across blanked/settling input, like the normalizer */
+        bool hold = g_bank_hold_left > 0;
+        if (g_dual_station) {
+            dual_station_detector_set_hold(g_dual_station, hold);
+        } else {
+            tick_detector_set_hold(g_tick_detector, hold);
+        }
+        if (g_bcd_time_detector) bcd_time_detector_set_hold(g_bcd_time_detector, hold);
+        if (g_bcd_freq_detector) bcd_freq_detector_set_hold(g_bcd_freq_detector, hold);
+
+        /* Both bands cover the same span: feed them in input order, sync
+         * first on a tie, so events leave in sample order */
+        int ks = 0, kd = 0;
+        while (ks < n_sync || kd < n_data) {
+            uint64_t ps = sync_pos + (uint64_t)ks * (uint64_t)sync_step;
+            uint64_t pd = data_pos + (uint64_t)kd * (uint64_t)data_step;
+            if (kd >= n_data || (ks < n_sync && ps <= pd)) {
+                /* Sync channel to tick/marker detectors (1000 Hz tones) */
+                float sync_i = sync[2 * ks], sync_q = sync[2 * ks + 1];
+                g_bank_sample_index = g_bank_input_sample[ps % BANK_SAMPLE_RING];
+                if (g_dual_station) {
+                    dual_station_detector_process_sample(g_dual_station, sync_i, sync_q);
+                } else {
+                    tick_detector_process_sample(g_tick_detector, sync_i, sync_q);
+                }
+                marker_detector_process_sample(g_marker_detector, sync_i, sync_q);
+                ks++;
+            } else {
+                /* Data subband to BCD detectors (100 Hz subcarrier) */
+                float data_i = data[2 * kd], data_q = data[2 * kd + 1];
+                g_bank_sample_index = g_bank_input_sample[pd % BANK_SAMPLE_RING];
+                if (g_bcd_time_detector) bcd_time_detector_process_sample(g_bcd_time_detector, data_i, data_q);
+                if (g_bcd_freq_detector) bcd_freq_detector_process_sample(g_bcd_freq_detector, data_i, data_q);
+                kd++;
+            }
+        }
+    }
+
+    /* Periodic signal check for sync detector */
+    g_periodic_check_counter++;
+    if (g_periodic_check_counter >= PERIODIC_CHECK_INTERVAL_SAMPLES) {
+        g_periodic_check_counter = 0;
+        float timestamp_ms = (float)(frame_num * DISPLAY_EFFECTIVE_MS);
+        queue_detector_event(PRODUCER_DETECTOR, detector_path_watermark(), WF_EVT_PERIODIC_CHECK,
+                             &timestamp_ms, sizeof(timestamp_ms));
+    }
+}
+
+/* Normalize the staged samples as a block, then run the detectors on them.
+ * Must run before the detector producer is advanced past the staged samples. */
+static void detector_path_run_stage(void) {
+    detector_stage_t *st = &g_detector_stage;
+
+    /* Slow AGC - level frozen across blanked/settling input */
+    for (int s = 0; s < st->count; ) {
+        int run = 1;
+        while (s + run < st->count && st->held[s + run] == st->held[s]) run++;
+        if (st->held[s]) {
+            block_normalizer_hold(&g_normalizer, st->iq + 2 * s, run);
+        } else {
+            block_normalizer_process(&g_normalizer, st->iq + 2 * s, run);
+        }
+        s += run;
+    }
+
+    for (int s = 0; s < st->count; s++) {
+        g_detector_sample_index = st->sample[s];
+        detector_path_detect(st->iq[2 * s], st->iq[2 * s + 1], st->held[s] != 0, st->frame_num[s]);
+    }
+    st->count = 0;
+}
+
+static void detector_path_sample(float i_raw, float q_raw, bool hold, uint64_t frame_num) {
+    float det_i = lowpass_process(&g_detector_lowpass_i, i_raw);
+    float det_q = lowpass_process(&g_detector_lowpass_q, q_raw);
+    if (hold) g_detector_held = true;
+
+    g_detector_decim_counter++;
+    if (g_detector_decim_counter < g_detector_decimation) {
+        return;
+    }
+    g_detector_decim_counter = 0;
+
+    detector_stage_t *st = &g_detector_stage;
+    st->iq[2 * st->count] = det_i;
+    st->iq[2 * st->count + 1] = det_q;
+    st->sample[st->count] = g_detector_sample_index;
+    st->frame_num[st->count] = frame_num;
+    st->held[st->count] = g_detector_held ? 1 : 0;
+    g_detector_held = false;
+    if (++st->count == DETECTOR_STAGE_SAMPLES) {
+        detector_path_run_stage();
+    }
+}
+
+static void detector_path_run_block(const detector_block_t *blk) {
+    for (int s = 0; s < blk->count; s++) {
+        g_detector_sample_index = blk->first_sample + (uint64_t)s;
+        detector_path_sample(blk->iq[s * 2], blk->iq[s * 2 + 1], blk->hold[s] != 0, blk->frame_num);
+    }
+    detector_path_run_stage();
+    event_merge_advance(g_event_merge, PRODUCER_DETECTOR, detector_path_watermark());
+}
+
+static int detector_thread_main(void *arg) {
+    (void)arg;
+    for (;;) {
+        size_t head = atomic_load_explicit(&g_detector_ring_head, memory_order_relaxed);
+        size_t tail = atomic_load_explicit(&g_detector_ring_tail, memory_order_acquire);
+        if (head == tail) {
+            if (atomic_load(&g_detector_thread_stop)) break;
+            SDL_Delay(1);
+            continue;
+        }
+        detector_block_t *blk = &g_detector_ring[head % DETECTOR_RING_BLOCKS];
+        detector_path_run_block(blk);
+        blk->count = 0;
+        atomic_store_explicit(&g_detector_ring_head, head + 1, memory_order_release);
+    }
+    return 0;
+}
+
+/* Block being filled by the main thread, NULL if none */
+static detector_block_t *detector_ring_slot(void) {
+    size_t tail = atomic_load_explicit(&g_detector_ring_tail, memory_order_relaxed);
+    while (tail - atomic_load_explicit(&g_detector_ring_head, memory_order_acquire) >= DETECTOR_RING_BLOCKS) {
+        /* Worker may be waiting on a full event queue - keep delivering */
+        drain_detector_events();
+        SDL_Delay(1);
+    }
+    return &g_detector_ring[tail % DETECTOR_RING_BLOCKS];
+}
+
+static void detector_ring_publish(void) {
+    size_t tail = atomic_load_explicit(&g_detector_ring_tail, memory_order_relaxed);
+    atomic_store_explicit(&g_detector_ring_tail, tail + 1, memory_order_release);
+}
+
+static bool detector_path_start(void) {
+    g_event_merge = event_merge_create(NUM_PRODUCERS, EVENT_QUEUE_CAPACITY);
+    if (!g_event_merge) return false;
+
+    if (!g_detector_thread_enabled) return true;
+
+    g_detector_ring = (detector_block_t *)calloc(DETECTOR_RING_BLOCKS, sizeof(detector_block_t));
+    if (!g_detector_ring) return false;
+    atomic_init(&g_detector_ring_head, 0);
+    atomic_init(&g_detector_ring_tail, 0);
+    atomic_init(&g_detector_thread_stop, false);
+
+    g_detector_thread = SDL_CreateThread(detector_thread_main, "detector", NULL);
+    if (!g_detector_thread) {
+        fprintf(stderr, "Failed to start detector thread: %s\n", SDL_GetError());
+        return false;
+    }
+    printf("Detector path: own thread, events merged in sample order\n");
+    return true;
+}
+
+/* Main thread, once per input sample */
+static void detector_path_feed(float i_raw, float q_raw, bool hold, uint64_t frame_num) {
+    if (!g_detector_thread_enabled) {
+        g_detector_sample_index = g_input_samples;
+        detector_path_sample(i_raw, q_raw, hold, frame_num);
+        return;
+    }
+
+    detector_block_t *blk = detector_ring_slot();
+    if (blk->count == 0) {
+        blk->first_sample = g_input_samples;
+        blk->frame_num = frame_num;
+    }
+    blk->iq[blk->count * 2] = i_raw;
+    blk->iq[blk->count * 2 + 1] = q_raw;
+    blk->hold[blk->count] = hold ? 1 : 0;
+    if (++blk->count == DETECTOR_BLOCK_SAMPLES) {
+        detector_ring_publish();
+    }
+}
+
+/* Main thread, end of each input frame: hand off, advance, deliver */
+static void detector_path_flush(void) {
+    if (g_detector_thread_enabled) {
+        detector_block_t *blk = detector_ring_slot();
+        if (blk->count > 0) detector_ring_publish();
+    } else {
+        detector_path_run_stage();
+        event_merge_advance(g_event_merge, PRODUCER_DETECTOR, detector_path_watermark());
+    }
+
+    /* Display FFT for this frame (if any) is stamped at the last sample */
+    if (g_input_samples > 0) {
+        event_merge_advance(g_event_merge, PRODUCER_DISPLAY, g_input_samples - 1);
+    }
+    drain_detector_events();
+}
+
+/* Wait until the worker has run every handed-off block */
+static void detector_path_sync(void) {
+    if (!g_detector_thread_enabled || !g_detector_ring) return;
+    size_t tail = atomic_load_explicit(&g_detector_ring_tail, memory_order_relaxed);
+    while (atomic_load_explicit(&g_detector_ring_head, memory_order_acquire) != tail) {
+        drain_detector_events();
+        SDL_Delay(1);
+    }
+    drain_detector_events();
+}
+
+static void detector_path_stop(void) {
+    detector_path_sync();
+    if (g_detector_thread) {
+        atomic_store(&g_detector_thread_stop, true);
+        SDL_WaitThread(g_detector_thread, NULL);
+        g_detector_thread = NULL;
+    }
+    if (g_event_merge) {
+        event_merge_close(g_event_merge, PRODUCER_DETECTOR);
+        event_merge_close(g_event_merge, PRODUCER_DISPLAY);
+        drain_detector_events();
+    }
+}
+
+/*============================================================================
+ * Dual Station Flash Sources
+ *============================================================================*/
+
+static int wwv_flash_frames(void *ctx) {
+    return dual_station_detector_get_flash_frames((dual_station_detector_t *)ctx, WWV_STATION_WWV);
+}
+
+static void wwv_decrement_flash(void *ctx) {
+    dual_station_detector_decrement_flash((dual_station_detector_t *)ctx, WWV_STATION_WWV);
+}
+
+static int wwvh_flash_frames(void *ctx) {
+    return dual_station_detector_get_flash_frames((dual_station_detector_t *)ctx, WWV_STATION_WWVH);
+}
+
+static void wwvh_decrement_flash(void *ctx) {
+    dual_station_detector_decrement_flash((dual_station_detector_t *)ctx, WWV_STATION_WWVH);
+}
+
 /*============================================================================
  * Color Mapping
  *============================================================================*/
@@ -1563,6 +1605,12 @@ int main(int argc, char *argv[]) {
             g_log_csv = true;
         } else if (strcmp(argv[i], "--reload-debug") == 0) {
             g_reload_debug = true;
+        } else if (strcmp(argv[i], "--detector-thread") == 0) {
+            g_detector_thread_enabled = true;
+        } else if (strcmp(argv[i], "--dual-station") == 0) {
+            g_dual_station_enabled = true;
+        } else if (strcmp(argv[i], "--tick-spill") == 0 && i + 1 < argc) {
+            g_tick_spill_path = argv[++i];
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             print_usage(argv[0]);
             return 0;
@@ -1581,71 +1629,26 @@ int main(int argc, char *argv[]) {
             return 1;
         }
 
-        int retry_count = 0;
-        while (g_iq_sock == SOCKET_INVALID) {
-            g_iq_sock = tcp_connect(g_tcp_host, g_iq_port);
-            if (g_iq_sock == SOCKET_INVALID) {
-                retry_count++;
-                if (retry_count == 1) {
-                    printf("Waiting for server on %s:%d...\n", g_tcp_host, g_iq_port);
-                } else if (retry_count % 10 == 0) {
-                    printf("Still waiting... (%d attempts)\n", retry_count);
-                }
-                Sleep(1000);
-            }
-        }
-        printf("\n*** CONNECTED to %s:%d ***\n\n", g_tcp_host, g_iq_port);
-
-#ifdef _WIN32
-        DWORD timeout_ms = 5000;
-        setsockopt(g_iq_sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout_ms, sizeof(timeout_ms));
-#else
-        struct timeval tv = { .tv_sec = 5, .tv_usec = 0 };
-        setsockopt(g_iq_sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-#endif
-
-        printf("Waiting for stream header...\n");
-        iq_stream_header_t header;
-        if (!tcp_recv_exact(g_iq_sock, &header, sizeof(header))) {
-            fprintf(stderr, "Failed to read I/Q stream header\n");
-            socket_close(g_iq_sock);
+        g_iq_client = iq_client_create(g_tcp_host, g_iq_port, IQ_CLIENT_PROTO_PHXI);
+        if (!g_iq_client) {
+            fprintf(stderr, "Failed to create I/Q client\n");
             tcp_cleanup();
             return 1;
         }
 
-        if (header.magic != MAGIC_PHXI) {
-            fprintf(stderr, "Invalid header magic: 0x%08X\n", header.magic);
-            socket_close(g_iq_sock);
-            tcp_cleanup();
-            return 1;
+        /* Block until the stream header arrives; the client retries with backoff */
+        int waited_sec = 0;
+        iq_client_frame_t first;
+        iq_client_status_t st;
+        while ((st = iq_client_next(g_iq_client, &first, 1000)) != IQ_CLIENT_CONNECTED) {
+            if (st == IQ_CLIENT_DISCONNECTED) {
+                printf("Waiting for server on %s:%d...\n", g_tcp_host, g_iq_port);
+            } else if (st == IQ_CLIENT_TIMEOUT && ++waited_sec % 10 == 0) {
+                printf("Still waiting... (%d s)\n", waited_sec);
+            }
         }
-
-        g_tcp_sample_rate = header.sample_rate;
-        g_tcp_sample_format = header.sample_format;
-        g_tcp_center_freq = ((uint64_t)header.center_freq_hi << 32) | header.center_freq_lo;
-
-        printf("Stream: rate=%u Hz, format=%u, freq=%llu Hz\n",
-               g_tcp_sample_rate, g_tcp_sample_format, (unsigned long long)g_tcp_center_freq);
-
-#ifdef _WIN32
-        timeout_ms = 100;
-        setsockopt(g_iq_sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout_ms, sizeof(timeout_ms));
-#else
-        tv.tv_sec = 0;
-        tv.tv_usec = 100000;
-        setsockopt(g_iq_sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-#endif
-
-        /* Calculate decimation factors for both paths */
-        g_detector_decimation = g_tcp_sample_rate / DETECTOR_SAMPLE_RATE;
-        if (g_detector_decimation < 1) g_detector_decimation = 1;
-
-        g_display_decimation = g_tcp_sample_rate / DISPLAY_SAMPLE_RATE;
-        if (g_display_decimation < 1) g_display_decimation = 1;
-
-        /* Legacy compatibility */
-        g_decimation_factor = g_detector_decimation;
-        g_effective_sample_rate = g_tcp_sample_rate / g_detector_decimation;
+        printf("\n*** CONNECTED to %s:%d ***\n\n", g_tcp_host, g_iq_port);
+        tcp_stream_start();
 
         printf("Detector path: %d:1 -> %d Hz\n", g_detector_decimation, DETECTOR_SAMPLE_RATE);
         printf("Display path:  %d:1 -> %d Hz (%.1f Hz/bin, %.1f ms effective)\n",
@@ -1743,6 +1746,7 @@ int main(int argc, char *argv[]) {
     memset(g_iq_buffer, 0, DISPLAY_FFT_SIZE * sizeof(iq_sample_t));
     g_iq_buffer_idx = 0;
     memset(pixels, 0, g_window_width * g_window_height * 3);
+    block_normalizer_init(&g_normalizer);
 
     /* Blackman-Harris window for display FFT (better sidelobe suppression) */
     float *window_func = (float *)malloc(DISPLAY_FFT_SIZE * sizeof(float));
@@ -1753,15 +1757,22 @@ int main(int argc, char *argv[]) {
     printf("Resolution: %.1f Hz/bin, %.1f ms effective update\n", DISPLAY_HZ_PER_BIN, DISPLAY_EFFECTIVE_MS);
     printf("Keys: +/- gain, D=detect toggle, S=stats, Q/Esc quit\n\n");
 
-    g_tick_detector = tick_detector_create(g_log_csv ? "wwv_ticks.csv" : NULL);
-    if (!g_tick_detector) {
-        fprintf(stderr, "Failed to create tick detector\n");
+    /* Sync band stays at 50 kHz for the tick matched filter; the data band
+     * only needs a few hundred Hz, so the BCD detectors take a subband */
+    g_channel_bank = fft_filter_bank_create((float)DETECTOR_SAMPLE_RATE, FFT_BANK_DEFAULT_FFT_SIZE);
+    if (g_channel_bank) {
+        g_sync_band = fft_filter_bank_add_band(g_channel_bank, 800.0f, 1400.0f, 1);
+        g_data_band = fft_filter_bank_add_band(g_channel_bank, 0.0f, 150.0f, BCD_SUBBAND_DECIMATION);
+    }
+    if (g_sync_band < 0 || g_data_band < 0) {
+        fprintf(stderr, "Failed to create channel filter bank\n");
         return 1;
     }
 
-    /* Load tuned parameters from INI if --reload-debug flag set */
-    if (g_reload_debug) {
-        load_tick_params_from_ini();
+    g_tick_detector = tick_detector_create_rate(g_log_csv ? "wwv_ticks.csv" : NULL, DETECTOR_SAMPLE_RATE);
+    if (!g_tick_detector) {
+        fprintf(stderr, "Failed to create tick detector\n");
+        return 1;
     }
 
     g_marker_detector = marker_detector_create(g_log_csv ? "wwv_markers.csv" : NULL);
@@ -1769,6 +1780,16 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "Failed to create marker detector\n");
         return 1;
     }
+    /* WWV/WWVH separation - takes over the sync path from the tick detector, which
+     * is still created for epoch/parameter plumbing but is not fed samples */
+    if (g_dual_station_enabled) {
+        g_dual_station = dual_station_detector_create(g_log_csv ? "wwv_dual_station.csv" : NULL);
+        if (!g_dual_station) {
+            fprintf(stderr, "Failed to create dual station detector\n");
+            return 1;
+        }
+    }
+
     /* DISABLED: Subcarrier baseline doesn't work - 500/600 Hz energy is ~720x lower
      * than 1000 Hz energy due to different frequency characteristics. Using it causes
      * baseline to collapse to ~2.5, making everything look like a marker.
@@ -1780,16 +1801,19 @@ int main(int argc, char *argv[]) {
      */
 
     /* Create slow marker detector */
-    g_slow_marker = slow_marker_detector_create();
+    g_slow_marker = slow_marker_detector_create_rate(DISPLAY_SAMPLE_RATE, DISPLAY_FFT_SIZE);
     if (!g_slow_marker) {
         fprintf(stderr, "Failed to create slow marker detector\n");
         return 1;
     }
-    slow_marker_detector_set_callback(g_slow_marker, on_slow_marker_frame, NULL);
+    slow_marker_detector_set_callback(g_slow_marker, queue_slow_marker_frame, NULL);
 
     /* DEPRECATED: Create BCD envelope tracker (100 Hz)
      * Use bcd_time_detector + bcd_freq_detector + bcd_correlator instead */
-    g_bcd_envelope = bcd_envelope_create(g_log_csv ? "wwv_bcd.csv" : NULL);
+    g_subcarrier_fe = subcarrier_frontend_create();
+    g_bcd_envelope = g_subcarrier_fe
+        ? bcd_envelope_create_shared(g_subcarrier_fe, g_log_csv ? "wwv_bcd.csv" : NULL)
+        : NULL;
     if (!g_bcd_envelope) {
         fprintf(stderr, "Failed to create BCD envelope tracker\n");
         return 1;
@@ -1806,13 +1830,15 @@ int main(int argc, char *argv[]) {
      * bcd_decoder_set_symbol_callback(g_bcd_decoder, on_bcd_symbol, NULL); */
 
     /* Create BCD dual-path detectors (robust symbol demodulator) */
-    g_bcd_time_detector = bcd_time_detector_create(g_log_csv ? "logs/wwv_bcd_time.csv" : NULL);
-    g_bcd_freq_detector = bcd_freq_detector_create(g_log_csv ? "logs/wwv_bcd_freq.csv" : NULL);
+    g_bcd_time_detector = bcd_time_detector_create_subband(g_log_csv ? "logs/wwv_bcd_time.csv" : NULL,
+                                                           DETECTOR_SAMPLE_RATE, BCD_SUBBAND_DECIMATION);
+    g_bcd_freq_detector = bcd_freq_detector_create_subband(g_log_csv ? "logs/wwv_bcd_freq.csv" : NULL,
+                                                           DETECTOR_SAMPLE_RATE, BCD_SUBBAND_DECIMATION);
     g_bcd_correlator = bcd_correlator_create(g_log_csv ? "logs/wwv_bcd_corr.csv" : NULL);
     if (g_bcd_time_detector && g_bcd_freq_detector && g_bcd_correlator) {
-        /* Wire time and freq detectors to correlator via wrapper callbacks */
-        bcd_time_detector_set_callback(g_bcd_time_detector, on_bcd_time_event, g_bcd_correlator);
-        bcd_freq_detector_set_callback(g_bcd_freq_detector, on_bcd_freq_event, g_bcd_correlator);
+        /* Wire time and freq detectors to correlator via the event merge */
+        bcd_time_detector_set_callback(g_bcd_time_detector, queue_bcd_time_event, NULL);
+        bcd_freq_detector_set_callback(g_bcd_freq_detector, queue_bcd_freq_event, NULL);
         /* NOTE: Sync source linked below after g_sync_detector is created */
     }
 
@@ -1830,9 +1856,12 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "Failed to create sync detector\n");
         return 1;
     }
-    tick_detector_set_marker_callback(g_tick_detector, on_tick_marker, NULL);
-    tick_detector_set_callback(g_tick_detector, on_tick_event, NULL);
-    marker_detector_set_callback(g_marker_detector, on_marker_event, NULL);
+    tick_detector_set_marker_callback(g_tick_detector, queue_tick_marker, NULL);
+    tick_detector_set_callback(g_tick_detector, queue_tick_event, NULL);
+    if (g_dual_station) {
+        dual_station_detector_set_tick_callback(g_dual_station, queue_station_tick, NULL);
+    }
+    marker_detector_set_callback(g_marker_detector, queue_marker_event, NULL);
 
     /* Link BCD correlator to sync detector for window-based demodulation
      * Correlator will only emit symbols when sync is LOCKED */
@@ -1846,24 +1875,43 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "Failed to create tick correlator\n");
         return 1;
     }
+    if (g_tick_spill_path && !tick_correlator_set_spill_file(g_tick_correlator, g_tick_spill_path)) {
+        fprintf(stderr, "Warning: cannot open tick spill log %s\n", g_tick_spill_path);
+    }
 
     /* Wire tick chain epoch callback */
     tick_correlator_set_epoch_callback(g_tick_correlator, on_tick_chain_epoch, NULL);
 
+    /* Versioned parameter store - all tunable detectors exist now */
+    if (!init_param_store()) {
+        fprintf(stderr, "Failed to create detector parameter store\n");
+        return 1;
+    }
+
+    /* Event merge (and detector thread if requested) - all callbacks are wired */
+    if (!detector_path_start()) {
+        fprintf(stderr, "Failed to start detector path\n");
+        return 1;
+    }
+
     /* g_channel_csv removed - use UDP telemetry (TELEM_CHANNEL) instead */
 
     /* g_subcarrier_csv removed - use UDP telemetry (TELEM_SUBCAR) instead */
 
     /* Create tone trackers for receiver characterization */
-    g_tone_carrier = tone_tracker_create(0.0f, g_log_csv ? "wwv_carrier.csv" : NULL);
-    g_tone_500 = tone_tracker_create(500.0f, g_log_csv ? "wwv_tone_500.csv" : NULL);
-    g_tone_600 = tone_tracker_create(600.0f, g_log_csv ? "wwv_tone_600.csv" : NULL);
+    g_tone_carrier = tone_tracker_create_rate(0.0f, g_log_csv ? "wwv_carrier.csv" : NULL, DISPLAY_SAMPLE_RATE);
+    g_tone_500 = tone_tracker_create_rate(500.0f, g_log_csv ? "wwv_tone_500.csv" : NULL, DISPLAY_SAMPLE_RATE);
+    g_tone_600 = tone_tracker_create_rate(600.0f, g_log_csv ? "wwv_tone_600.csv" : NULL, DISPLAY_SAMPLE_RATE);
 
     /* Initialize UDP telemetry broadcast */
     telem_init(3005);
     /* All channels enabled by default in telem_init() */
 
     /* Initialize UDP command listener */
+    if (!cmd_table_build(&g_wf_command_table, g_wf_commands, NUM_WF_COMMANDS)) {
+        fprintf(stderr, "[CMD] Command table failed to build\n");
+        return 1;
+    }
     g_cmd_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
     if (g_cmd_sock != SOCKET_INVALID) {
         struct sockaddr_in cmd_addr;
@@ -1885,8 +1933,8 @@ int main(int argc, char *argv[]) {
             int flags = fcntl(g_cmd_sock, F_GETFL, 0);
             fcntl(g_cmd_sock, F_SETFL, flags | O_NONBLOCK);
 #endif
-            printf("[CMD] UDP command listener on localhost:%d (rate limit: %d/sec)\n",
-                   CMD_PORT, CMD_RATE_LIMIT_PER_SEC);
+            printf("[CMD] UDP command listener on localhost:%d (up to %d/frame)\n",
+                   CMD_PORT, CMD_MAX_PER_FRAME);
         }
     } else {
         fprintf(stderr, "[CMD] Failed to create UDP command socket\n");
@@ -1903,15 +1951,30 @@ int main(int argc, char *argv[]) {
     flash_init();
     flash_register(&(flash_source_t){
         .name = "tick",
-        .get_flash_frames = (int (*)(void*))tick_detector_get_flash_frames,
-        .decrement_flash = (void (*)(void*))tick_detector_decrement_flash,
-        .ctx = g_tick_detector,
+        .get_flash_frames = g_dual_station ? wwv_flash_frames :
+                            (int (*)(void*))tick_detector_get_flash_frames,
+        .decrement_flash = g_dual_station ? wwv_decrement_flash :
+                           (void (*)(void*))tick_detector_decrement_flash,
+        .ctx = g_dual_station ? (void *)g_dual_station : (void *)g_tick_detector,
         .freq_hz = 1000,
         .band_half_width = 2,       /* 100 Hz bandwidth → ~4 pixels at current zoom */
         .band_r = 180, .band_g = 0, .band_b = 255,  /* Purple */
         .bar_index = 4,
         .bar_r = 180, .bar_g = 0, .bar_b = 255
     });
+    if (g_dual_station) {
+        flash_register(&(flash_source_t){
+            .name = "wwvh",
+            .get_flash_frames = wwvh_flash_frames,
+            .decrement_flash = wwvh_decrement_flash,
+            .ctx = g_dual_station,
+            .freq_hz = 1200,
+            .band_half_width = 2,
+            .band_r = 255, .band_g = 140, .band_b = 0,  /* Orange */
+            .bar_index = 5,
+            .bar_r = 255, .bar_g = 140, .bar_b = 0
+        });
+    }
     flash_register(&(flash_source_t){
         .name = "marker",
         .get_flash_frames = (int (*)(void*))marker_detector_get_flash_frames,
@@ -1929,13 +1992,17 @@ int main(int argc, char *argv[]) {
     bool running = true;
 
     while (running) {
-        /* Poll UDP command socket (non-blocking) */
+        /* Drain the UDP command socket (non-blocking); parameter SETs in
+         * the burst are published together */
         if (g_cmd_sock != SOCKET_INVALID) {
-            char cmd_buf[CMD_MAX_LEN];
-            int n = recvfrom(g_cmd_sock, cmd_buf, sizeof(cmd_buf) - 1, 0, NULL, NULL);
-            if (n > 0) {
-                process_modem_command(cmd_buf, n);
+            char cmd_buf[CMD_MAX_LEN + 1];
+            for (int c = 0; c < CMD_MAX_PER_FRAME; c++) {
+                int n = recvfrom(g_cmd_sock, cmd_buf, CMD_MAX_LEN, 0, NULL, NULL);
+                if (n <= 0) break;
+                cmd_buf[n] = '\0';
+                process_modem_command(cmd_buf);
             }
+            commit_detector_params();
         }
 
         SDL_Event event;
@@ -1943,6 +2010,7 @@ int main(int argc, char *argv[]) {
             if (event.type == SDL_QUIT) {
                 running = false;
             } else if (event.type == SDL_KEYDOWN) {
+                detector_path_sync();
                 if (event.key.keysym.sym == SDLK_ESCAPE || event.key.keysym.sym == SDLK_q) {
                     running = false;
                 } else if (event.key.keysym.sym == SDLK_PLUS || event.key.keysym.sym == SDLK_EQUALS || event.key.keysym.sym == SDLK_KP_PLUS) {
@@ -1958,13 +2026,32 @@ int main(int argc, char *argv[]) {
                 } else if (event.key.keysym.sym == SDLK_d) {
                     bool enabled = !tick_detector_get_enabled(g_tick_detector);
                     tick_detector_set_enabled(g_tick_detector, enabled);
+                    if (g_dual_station) dual_station_detector_set_enabled(g_dual_station, enabled);
                     printf("Tick detection: %s\n", enabled ? "ENABLED" : "DISABLED");
                 } else if (event.key.keysym.sym == SDLK_s) {
-                    tick_detector_print_stats(g_tick_detector);
+                    if (g_dual_station) {
+                        dual_station_detector_print_stats(g_dual_station);
+                    } else {
+                        tick_detector_print_stats(g_tick_detector);
+                    }
                 }
             }
         }
 
+        /* Block boundary: pick up published parameter changes */
+        if (g_reload_debug) {
+            time_t now_sec = time(NULL);
+            if (now_sec != g_params_ini_check_sec) {
+                g_params_ini_check_sec = now_sec;
+                uint32_t version = detector_param_store_check_ini(g_param_store);
+                if (version) {
+                    telem_sendf(TELEM_CONSOLE, "[PARAM] %s changed on disk, published v%u\n",
+                                PARAMS_INI_PATH, version);
+                }
+            }
+        }
+        poll_detector_params();
+
         bool got_samples = false;
         int samples_collected = 0;
 
@@ -1985,10 +2072,7 @@ int main(int argc, char *argv[]) {
             if (!g_detector_dsp_initialized) {
                 lowpass_init(&g_detector_lowpass_i, DETECTOR_FILTER_CUTOFF, (float)g_tcp_sample_rate);
                 lowpass_init(&g_detector_lowpass_q, DETECTOR_FILTER_CUTOFF, (float)g_tcp_sample_rate);
-                sync_channel_init(&g_sync_channel_i);
-                sync_channel_init(&g_sync_channel_q);
-                data_channel_init(&g_data_channel_i);
-                data_channel_init(&g_data_channel_q);
+                channel_bank_reset();
                 g_detector_dsp_initialized = true;
             }
             if (!g_display_dsp_initialized) {
@@ -2002,35 +2086,7 @@ int main(int argc, char *argv[]) {
                 float q_raw = (float)test_samples[s * 2 + 1] / 32768.0f;
 
                 /* DETECTOR PATH */
-                float det_i = lowpass_process(&g_detector_lowpass_i, i_raw);
-                float det_q = lowpass_process(&g_detector_lowpass_q, q_raw);
-
-                g_detector_decim_counter++;
-                if (g_detector_decim_counter >= g_detector_decimation) {
-                    g_detector_decim_counter = 0;
-                    float norm_factor = normalize(&g_normalizer, det_i, det_q);
-                    det_i *= norm_factor;
-                    det_q *= norm_factor;
-
-                    float sync_i = sync_channel_process(&g_sync_channel_i, det_i);
-                    float sync_q = sync_channel_process(&g_sync_channel_q, det_q);
-                    float data_i = data_channel_process(&g_data_channel_i, det_i);
-                    float data_q = data_channel_process(&g_data_channel_q, det_q);
-
-                    tick_detector_process_sample(g_tick_detector, sync_i, sync_q);
-                    marker_detector_process_sample(g_marker_detector, sync_i, sync_q);
-                    if (g_bcd_time_detector) bcd_time_detector_process_sample(g_bcd_time_detector, data_i, data_q);
-                    if (g_bcd_freq_detector) bcd_freq_detector_process_sample(g_bcd_freq_detector, data_i, data_q);
-
-                    g_periodic_check_counter++;
-                    if (g_periodic_check_counter >= PERIODIC_CHECK_INTERVAL_SAMPLES) {
-                        g_periodic_check_counter = 0;
-                        if (g_sync_detector) {
-                            float timestamp_ms = (float)(frame_num * DISPLAY_EFFECTIVE_MS);
-                            sync_detector_periodic_check(g_sync_detector, timestamp_ms);
-                        }
-                    }
-                }
+                detector_path_feed(i_raw, q_raw, false, frame_num);
 
                 /* DISPLAY PATH */
                 float disp_i = lowpass_process(&g_display_lowpass_i, i_raw);
@@ -2044,34 +2100,35 @@ int main(int argc, char *argv[]) {
                     g_display_buffer_idx = (g_display_buffer_idx + 1) % DISPLAY_FFT_SIZE;
                     g_display_new_samples++;
                 }
+                g_input_samples++;
             }
+            detector_path_flush();
         } else if (g_tcp_mode) {
             while (samples_collected < DISPLAY_OVERLAP && running) {
-                uint32_t magic;
-                recv_result_t result = tcp_recv_exact_ex(g_iq_sock, &magic, 4);
-                if (result == RECV_TIMEOUT) {
+                iq_client_frame_t frame;
+                iq_client_status_t result = iq_client_next(g_iq_client, &frame, IQ_POLL_MS);
+                if (result == IQ_CLIENT_TIMEOUT) {
                     break;
                 }
-                if (result == RECV_ERROR) {
-                    if (!tcp_reconnect()) {
-                        running = false;
-                    }
+                if (result == IQ_CLIENT_DISCONNECTED) {
+                    detector_path_sync();
+                    tcp_stream_lost();
+                    printf("\n*** CONNECTION LOST - Reconnecting to %s:%d ***\n", g_tcp_host, g_iq_port);
                     break;
                 }
+                if (result == IQ_CLIENT_CONNECTED) {
+                    printf("*** RECONNECTED to %s:%d ***\n", g_tcp_host, g_iq_port);
+                    tcp_stream_start();
+                    continue;
+                }
 
-                if (magic == MAGIC_META) {
-                    iq_metadata_update_t meta;
-                    meta.magic = magic;
-                    if (tcp_recv_exact_ex(g_iq_sock, ((char*)&meta) + 4, sizeof(meta) - 4) != RECV_OK) {
-                        if (!tcp_reconnect()) {
-                            running = false;
-                        }
-                        break;
-                    }
-                    g_tcp_sample_rate = meta.sample_rate;
-                    g_tcp_center_freq = ((uint64_t)meta.center_freq_hi << 32) | meta.center_freq_lo;
-                    g_tcp_gain_reduction = meta.gain_reduction;
-                    g_tcp_lna_state = meta.lna_state;
+                if (result == IQ_CLIENT_META) {
+                    const iq_client_stream_t *meta = iq_client_stream(g_iq_client);
+                    detector_path_sync();
+                    g_tcp_sample_rate = meta->sample_rate;
+                    g_tcp_center_freq = meta->center_freq;
+                    g_tcp_gain_reduction = meta->gain_reduction;
+                    g_tcp_lna_state = meta->lna_state;
 
                     /* Recalculate decimation factors */
                     g_detector_decimation = g_tcp_sample_rate / DETECTOR_SAMPLE_RATE;
@@ -2098,49 +2155,21 @@ int main(int argc, char *argv[]) {
                     continue;
                 }
 
-                if (magic != MAGIC_IQDQ) {
-                    fprintf(stderr, "Unknown frame magic: 0x%08X\n", magic);
-                    continue;
-                }
-
-                iq_data_frame_t frame;
-                frame.magic = magic;
-                if (tcp_recv_exact_ex(g_iq_sock, ((char*)&frame) + 4, sizeof(frame) - 4) != RECV_OK) {
-                    if (!tcp_reconnect()) {
-                        running = false;
-                    }
-                    break;
-                }
-
-                int bytes_per_sample = (g_tcp_sample_format == IQ_FORMAT_S16) ? 4 :
-                                       (g_tcp_sample_format == IQ_FORMAT_F32) ? 8 : 2;
-                int data_bytes = frame.num_samples * bytes_per_sample;
-
-                static uint8_t *iq_buffer = NULL;
-                static int iq_buffer_size = 0;
-                if (data_bytes > iq_buffer_size) {
-                    iq_buffer = (uint8_t *)realloc(iq_buffer, data_bytes);
-                    iq_buffer_size = data_bytes;
-                }
-
-                if (tcp_recv_exact_ex(g_iq_sock, iq_buffer, data_bytes) != RECV_OK) {
-                    if (!tcp_reconnect()) {
-                        running = false;
-                    }
-                    break;
-                }
+                /* Event markers sit between the header and the samples */
+                const iq_event_t *events = frame.events;
+                uint32_t n_events = g_iq_events ? frame.n_events : 0;
+                const uint8_t *iq_buffer = (const uint8_t *)frame.samples;
 
                 /* Initialize DSP paths on first data */
                 if (!g_detector_dsp_initialized) {
                     lowpass_init(&g_detector_lowpass_i, DETECTOR_FILTER_CUTOFF, (float)g_tcp_sample_rate);
                     lowpass_init(&g_detector_lowpass_q, DETECTOR_FILTER_CUTOFF, (float)g_tcp_sample_rate);
-                    sync_channel_init(&g_sync_channel_i);
-                    sync_channel_init(&g_sync_channel_q);
-                    data_channel_init(&g_data_channel_i);
-                    data_channel_init(&g_data_channel_q);
+                    channel_bank_reset();
                     g_detector_dsp_initialized = true;
                     printf("Detector DSP: lowpass @ %.0f Hz\n", DETECTOR_FILTER_CUTOFF);
-                    printf("Channel filters: Sync 800-1400 Hz, Data 0-150 Hz\n");
+                    printf("Channel filters: Sync 800-1400 Hz, Data 0-150 Hz (%d-pt overlap-save, %.1f ms latency)\n",
+                           FFT_BANK_DEFAULT_FFT_SIZE,
+                           1000.0f * fft_filter_bank_latency_samples(g_channel_bank) / DETECTOR_SAMPLE_RATE);
                 }
                 if (!g_display_dsp_initialized) {
                     lowpass_init(&g_display_lowpass_i, DISPLAY_FILTER_CUTOFF, (float)g_tcp_sample_rate);
@@ -2149,11 +2178,50 @@ int main(int argc, char *argv[]) {
                     printf("Display DSP: lowpass @ %.0f Hz\n", DISPLAY_FILTER_CUTOFF);
                 }
 
+                /* With event markers, condition the whole frame first: gain steps
+                 * undone and overload blanked at the exact samples, and the held
+                 * samples freeze the normalizer, the detectors' noise floors and the
+                 * display AGC */
+                static float *cond_iq = NULL;
+                static uint8_t *cond_hold = NULL;
+                static uint32_t cond_size = 0;
+                bool conditioned = g_iq_events;
+                if (conditioned && frame.num_samples > cond_size) {
+                    /* On allocation failure this frame goes through unconditioned */
+                    float *grown_iq = (float *)realloc(cond_iq, frame.num_samples * 2 * sizeof(float));
+                    if (grown_iq) cond_iq = grown_iq;
+                    uint8_t *grown_hold = grown_iq ? (uint8_t *)realloc(cond_hold, frame.num_samples) : NULL;
+                    if (grown_hold) cond_hold = grown_hold;
+                    if (grown_iq && grown_hold) {
+                        cond_size = frame.num_samples;
+                    } else {
+                        fprintf(stderr, "Out of memory conditioning %u samples, frame not conditioned\n",
+                                frame.num_samples);
+                        conditioned = false;
+                    }
+                }
+                if (conditioned) {
+                    for (uint32_t s = 0; s < frame.num_samples * 2; s++) {
+                        cond_iq[s] = (g_tcp_sample_format == IQ_FORMAT_S16) ?
+                                     (float)((const int16_t *)iq_buffer)[s] / 32768.0f :
+                                     (g_tcp_sample_format == IQ_FORMAT_F32) ?
+                                     ((const float *)iq_buffer)[s] :
+                                     (float)(iq_buffer[s] - 128);
+                    }
+                    iq_conditioner_apply(&g_conditioner, cond_iq, cond_hold,
+                                         frame.num_samples, events, n_events);
+                }
+
                 for (uint32_t s = 0; s < frame.num_samples; s++) {
                     float i_raw, q_raw;
-
-                    if (g_tcp_sample_format == IQ_FORMAT_S16) {
-                        int16_t *samples = (int16_t *)iq_buffer;
+                    bool hold = false;
+
+                    if (conditioned) {
+                        i_raw = cond_iq[s * 2];
+                        q_raw = cond_iq[s * 2 + 1];
+                        hold = cond_hold[s] != 0;
+                    } else if (g_tcp_sample_format == IQ_FORMAT_S16) {
+                        const int16_t *samples = (const int16_t *)iq_buffer;
                         /* Normalize S16 to [-1, 1] range. Without this, raw int16 values
                          * (-32768 to +32767) become floats of the same magnitude, causing
                          * energy values ~10^9 instead of ~1. Adaptive thresholds self-adjust
@@ -2162,7 +2230,7 @@ int main(int argc, char *argv[]) {
                         i_raw = (float)samples[s * 2] / 32768.0f;
                         q_raw = (float)samples[s * 2 + 1] / 32768.0f;
                     } else if (g_tcp_sample_format == IQ_FORMAT_F32) {
-                        float *samples = (float *)iq_buffer;
+                        const float *samples = (const float *)iq_buffer;
                         i_raw = samples[s * 2];
                         q_raw = samples[s * 2 + 1];
                     } else {
@@ -2174,44 +2242,7 @@ int main(int argc, char *argv[]) {
                      * DETECTOR PATH (48 kHz)
                      * Parallel filter architecture - WWV Tick/BCD Separation
                      *========================================================*/
-                    float det_i = lowpass_process(&g_detector_lowpass_i, i_raw);
-                    float det_q = lowpass_process(&g_detector_lowpass_q, q_raw);
-
-                    g_detector_decim_counter++;
-                    if (g_detector_decim_counter >= g_detector_decimation) {
-                        g_detector_decim_counter = 0;
-
-                        /* Signal normalization (slow AGC) */
-                        float norm_factor = normalize(&g_normalizer, det_i, det_q);
-                        det_i *= norm_factor;
-                        det_q *= norm_factor;
-
-                        /* SYNC CHANNEL: 800-1400 Hz bandpass for ticks/markers */
-                        float sync_i = sync_channel_process(&g_sync_channel_i, det_i);
-                        float sync_q = sync_channel_process(&g_sync_channel_q, det_q);
-
-                        /* DATA CHANNEL: 0-150 Hz lowpass for BCD subcarrier */
-                        float data_i = data_channel_process(&g_data_channel_i, det_i);
-                        float data_q = data_channel_process(&g_data_channel_q, det_q);
-
-                        /* Feed sync channel to tick/marker detectors (1000 Hz tones) */
-                        tick_detector_process_sample(g_tick_detector, sync_i, sync_q);
-                        marker_detector_process_sample(g_marker_detector, sync_i, sync_q);
-
-                        /* Feed data channel to BCD detectors (100 Hz subcarrier) */
-                        if (g_bcd_time_detector) bcd_time_detector_process_sample(g_bcd_time_detector, data_i, data_q);
-                        if (g_bcd_freq_detector) bcd_freq_detector_process_sample(g_bcd_freq_detector, data_i, data_q);
-
-                        /* Periodic signal check for sync detector */
-                        g_periodic_check_counter++;
-                        if (g_periodic_check_counter >= PERIODIC_CHECK_INTERVAL_SAMPLES) {
-                            g_periodic_check_counter = 0;
-                            if (g_sync_detector) {
-                                float timestamp_ms = (float)(frame_num * DISPLAY_EFFECTIVE_MS);
-                                sync_detector_periodic_check(g_sync_detector, timestamp_ms);
-                            }
-                        }
-                    }
+                    detector_path_feed(i_raw, q_raw, hold, frame_num);
 
                     /*========================================================
                      * DISPLAY PATH (12 kHz)
@@ -2229,12 +2260,17 @@ int main(int argc, char *argv[]) {
                         g_display_buffer[g_display_buffer_idx].q = disp_q;
                         g_display_buffer_idx = (g_display_buffer_idx + 1) % DISPLAY_FFT_SIZE;
                         g_display_new_samples++;
+                        if (hold) {
+                            g_display_hold_left = DISPLAY_FFT_SIZE;
+                        } else if (g_display_hold_left > 0) {
+                            g_display_hold_left--;
+                        }
 
                         /* Feed tone trackers (same 12 kHz samples) */
                         tone_tracker_process_sample(g_tone_carrier, disp_i, disp_q);
                         tone_tracker_process_sample(g_tone_500, disp_i, disp_q);
                         tone_tracker_process_sample(g_tone_600, disp_i, disp_q);
-                        bcd_envelope_process_sample(g_bcd_envelope, disp_i, disp_q);  /* DEPRECATED */
+                        subcarrier_frontend_process_sample(g_subcarrier_fe, disp_i, disp_q);
 
                         /* DEPRECATED: Feed BCD decoder with envelope data
                          * Use bcd_correlator callback instead */
@@ -2256,7 +2292,9 @@ int main(int argc, char *argv[]) {
                             samples_collected = DISPLAY_OVERLAP;  /* Signal ready for FFT */
                         }
                     }
+                    g_input_samples++;
                 }
+                detector_path_flush();
             }
             got_samples = (samples_collected >= DISPLAY_OVERLAP);
         } else {
@@ -2285,6 +2323,7 @@ int main(int argc, char *argv[]) {
         if (g_slow_marker) {
             float timestamp_ms = frame_num * DISPLAY_EFFECTIVE_MS;
             slow_marker_detector_process_fft(g_slow_marker, fft_out, timestamp_ms);
+            drain_detector_events();
         }
 
         /* Calculate magnitudes with FFT shift (DC in center) */
@@ -2317,15 +2356,18 @@ int main(int argc, char *argv[]) {
             if (db < frame_min) frame_min = db;
         }
 
-        if (frame_max > g_peak_db) {
-            g_peak_db += AGC_ATTACK * (frame_max - g_peak_db);
-        } else {
-            g_peak_db += AGC_DECAY * (frame_max - g_peak_db);
-        }
-        if (frame_min < g_floor_db) {
-            g_floor_db += AGC_ATTACK * (frame_min - g_floor_db);
-        } else {
-            g_floor_db += AGC_DECAY * (frame_min - g_floor_db);
+        /* Frozen while the FFT window holds blanked or settling samples */
+        if (g_display_hold_left == 0) {
+            if (frame_max > g_peak_db) {
+                g_peak_db += AGC_ATTACK * (frame_max - g_peak_db);
+            } else {
+                g_peak_db += AGC_DECAY * (frame_max - g_peak_db);
+            }
+            if (frame_min < g_floor_db) {
+                g_floor_db += AGC_ATTACK * (frame_min - g_floor_db);
+            } else {
+                g_floor_db += AGC_DECAY * (frame_min - g_floor_db);
+            }
         }
 
         /* Scroll waterfall down by 1 row */
@@ -2537,7 +2579,10 @@ int main(int argc, char *argv[]) {
             /* For 1000 Hz bar: show adaptive threshold (cyan) and noise floor (green) */
             if (f == 4) {
                 /* Cyan = threshold */
-                float thresh_db = 20.0f * log10f(tick_detector_get_threshold(g_tick_detector) + 1e-10f);
+                float thresh = g_dual_station ?
+                    dual_station_detector_get_threshold(g_dual_station, WWV_STATION_WWV) :
+                    tick_detector_get_threshold(g_tick_detector);
+                float thresh_db = 20.0f * log10f(thresh + 1e-10f);
                 float thresh_norm = (thresh_db - (-80.0f)) / 60.0f;
                 if (thresh_norm < 0.0f) thresh_norm = 0.0f;
                 if (thresh_norm > 1.0f) thresh_norm = 1.0f;
@@ -2555,7 +2600,10 @@ int main(int argc, char *argv[]) {
                 }
 
                 /* Green = noise floor */
-                float noise_db = 20.0f * log10f(tick_detector_get_noise_floor(g_tick_detector) + 1e-10f);
+                float noise = g_dual_station ?
+                    dual_station_detector_get_noise_floor(g_dual_station, WWV_STATION_WWV) :
+                    tick_detector_get_noise_floor(g_tick_detector);
+                float noise_db = 20.0f * log10f(noise + 1e-10f);
                 float noise_norm = (noise_db - (-80.0f)) / 60.0f;
                 if (noise_norm < 0.0f) noise_norm = 0.0f;
                 if (noise_norm > 1.0f) noise_norm = 1.0f;
@@ -2590,13 +2638,19 @@ int main(int argc, char *argv[]) {
         frame_num++;
     }
 
+    detector_path_stop();
+
     printf("\n");
     tick_detector_print_stats(g_tick_detector);
     marker_detector_print_stats(g_marker_detector);
     tick_correlator_print_stats(g_tick_correlator);
+    dual_station_detector_print_stats(g_dual_station);
     tick_detector_destroy(g_tick_detector);
+    fft_filter_bank_destroy(g_channel_bank);
+    dual_station_detector_destroy(g_dual_station);
     marker_detector_destroy(g_marker_detector);
     bcd_envelope_destroy(g_bcd_envelope);
+    subcarrier_frontend_destroy(g_subcarrier_fe);
     bcd_decoder_destroy(g_bcd_decoder);
     /* BCD dual-path detectors (robust symbol demodulator) */
     if (g_bcd_time_detector) bcd_time_detector_destroy(g_bcd_time_detector);
@@ -2606,6 +2660,9 @@ int main(int argc, char *argv[]) {
     marker_correlator_destroy(g_marker_correlator);
     sync_detector_destroy(g_sync_detector);
     tick_correlator_destroy(g_tick_correlator);
+    detector_param_store_destroy(g_param_store);
+    event_merge_destroy(g_event_merge);
+    free(g_detector_ring);
     tone_tracker_destroy(g_tone_carrier);
     tone_tracker_destroy(g_tone_500);
     tone_tracker_destroy(g_tone_600);
@@ -2618,9 +2675,7 @@ int main(int argc, char *argv[]) {
     }
 
     if (g_tcp_mode && !g_test_pattern) {
-        if (g_iq_sock != SOCKET_INVALID) {
-            socket_close(g_iq_sock);
-        }
+        iq_client_destroy(g_iq_client);
         tcp_cleanup();
     }
 
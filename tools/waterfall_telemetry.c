@@ -71,6 +71,7 @@ static const char *g_channel_prefixes[] = {
     "CONS",  /* TELEM_CONSOLE (console messages) */
     "CTRL",  /* TELEM_CTRL (control commands) */
     "RESP",  /* TELEM_RESP (command responses) */
+    "DUAL",  /* TELEM_STATION (WWV/WWVH separation) */
 };
 
 /*============================================================================
@@ -93,6 +94,7 @@ static int get_channel_index(telem_channel_t channel) {
         case TELEM_CONSOLE: return 12;
         case TELEM_CTRL:    return 13;
         case TELEM_RESP:    return 14;
+        case TELEM_STATION: return 15;
         default:            return 0;
     }
 }
@@ -49,7 +49,8 @@ typedef enum {
     TELEM_CONSOLE   = (1 << 11), /* Console/status messages (buffered) */
     TELEM_CTRL      = (1 << 12), /* Control commands received (from controller) */
     TELEM_RESP      = (1 << 13), /* Responses to control commands (to controller) */
-    TELEM_ALL       = 0x3FFF     /* All channels */
+    TELEM_STATION   = (1 << 14), /* WWV/WWVH dual-station ticks and relative delay */
+    TELEM_ALL       = 0x7FFF     /* All channels */
 } telem_channel_t;
 
 /*============================================================================
@@ -0,0 +1,318 @@
+/**
+ * @file wwv_blocks.c
+ * @brief Block-processing wrappers around the WWV detectors
+ *
+ * The front end is waterfall's detector path without the display side:
+ * detector_path_sample() / detector_path_run_stage() with the blanking
+ * holds left out, since recordings carry no in-band events.
+ */
+
+#include "wwv_blocks.h"
+#include "waterfall_dsp.h"
+#include "block_normalizer.h"
+#include "fft_filter_bank.h"
+#include "tick_detector.h"
+#include "marker_detector.h"
+#include "bcd_time_detector.h"
+#include "bcd_freq_detector.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define BANK_BLOCK  (FFT_BANK_DEFAULT_FFT_SIZE / 2)     /* Inputs per bank output block */
+
+/*============================================================================
+ * Front End
+ *============================================================================*/
+
+struct wwv_front_end {
+    int32_t input_rate;
+    int decimation;
+    int decim_counter;
+    wf_lowpass_t lp_i, lp_q;
+    block_normalizer_t normalizer;
+
+    float stage[2 * WWV_FRONT_END_STAGE];
+    int staged;
+
+    fft_filter_bank_t *bank;
+    int sync_band;
+    int data_band;
+};
+
+int32_t wwv_blocks_abi_version(void) {
+    return WWV_BLOCKS_ABI_VERSION;
+}
+
+wwv_front_end_t *wwv_front_end_create(int32_t input_rate) {
+    if (input_rate < WWV_DETECTOR_RATE || input_rate % WWV_DETECTOR_RATE != 0) return NULL;
+
+    wwv_front_end_t *fe = (wwv_front_end_t *)calloc(1, sizeof(*fe));
+    if (!fe) return NULL;
+    fe->input_rate = input_rate;
+    fe->decimation = input_rate / WWV_DETECTOR_RATE;
+
+    fe->bank = fft_filter_bank_create((float)WWV_DETECTOR_RATE, FFT_BANK_DEFAULT_FFT_SIZE);
+    if (!fe->bank) {
+        free(fe);
+        return NULL;
+    }
+    fe->sync_band = fft_filter_bank_add_band(fe->bank, 800.0f, 1400.0f, 1);
+    fe->data_band = fft_filter_bank_add_band(fe->bank, 0.0f, 150.0f, WWV_DATA_DECIMATION);
+    if (fe->sync_band < 0 || fe->data_band < 0) {
+        wwv_front_end_destroy(fe);
+        return NULL;
+    }
+
+    block_normalizer_init(&fe->normalizer);
+    wwv_front_end_reset(fe);
+    return fe;
+}
+
+void wwv_front_end_destroy(wwv_front_end_t *fe) {
+    if (!fe) return;
+    fft_filter_bank_destroy(fe->bank);
+    free(fe);
+}
+
+void wwv_front_end_reset(wwv_front_end_t *fe) {
+    wf_lowpass_init(&fe->lp_i, WWV_DETECTOR_CUTOFF, (float)fe->input_rate);
+    wf_lowpass_init(&fe->lp_q, WWV_DETECTOR_CUTOFF, (float)fe->input_rate);
+    block_normalizer_reset(&fe->normalizer);
+    fft_filter_bank_reset(fe->bank);
+    fe->decim_counter = 0;
+    fe->staged = 0;
+}
+
+size_t wwv_front_end_max_output(const wwv_front_end_t *fe, int32_t channel, size_t pairs) {
+    /* Decimated samples, plus a stage and a bank block that may be waiting */
+    size_t blocks = (pairs / (size_t)fe->decimation + 1 + WWV_FRONT_END_STAGE) / BANK_BLOCK + 1;
+    return channel == WWV_CHANNEL_DATA ? blocks * (BANK_BLOCK / WWV_DATA_DECIMATION)
+                                       : blocks * BANK_BLOCK;
+}
+
+static void append(float *dst, size_t *n, const float *src, int count) {
+    memcpy(dst + 2 * *n, src, (size_t)count * 2 * sizeof(float));
+    *n += (size_t)count;
+}
+
+/* Normalize a full stage as one block, then split it into the channels */
+static void run_stage(wwv_front_end_t *fe, float *sync, size_t *n_sync, float *data, size_t *n_data) {
+    block_normalizer_process(&fe->normalizer, fe->stage, fe->staged);
+
+    for (int s = 0; s < fe->staged; s++) {
+        if (!fft_filter_bank_push(fe->bank, fe->stage[2 * s], fe->stage[2 * s + 1])) continue;
+
+        int count;
+        const float *out = fft_filter_bank_output(fe->bank, fe->sync_band, &count);
+        append(sync, n_sync, out, count);
+        out = fft_filter_bank_output(fe->bank, fe->data_band, &count);
+        append(data, n_data, out, count);
+    }
+    fe->staged = 0;
+}
+
+static void front_end_sample(wwv_front_end_t *fe, float i_raw, float q_raw,
+                             float *sync, size_t *n_sync, float *data, size_t *n_data) {
+    float det_i = wf_lowpass_process(&fe->lp_i, i_raw);
+    float det_q = wf_lowpass_process(&fe->lp_q, q_raw);
+
+    if (++fe->decim_counter < fe->decimation) return;
+    fe->decim_counter = 0;
+
+    fe->stage[2 * fe->staged] = det_i;
+    fe->stage[2 * fe->staged + 1] = det_q;
+    if (++fe->staged == WWV_FRONT_END_STAGE) {
+        run_stage(fe, sync, n_sync, data, n_data);
+    }
+}
+
+void wwv_front_end_process_s16(wwv_front_end_t *fe, const int16_t *iq, size_t pairs,
+                               float *sync, size_t *n_sync, float *data, size_t *n_data) {
+    *n_sync = *n_data = 0;
+    for (size_t n = 0; n < pairs; n++) {
+        front_end_sample(fe, (float)iq[2 * n] / 32768.0f, (float)iq[2 * n + 1] / 32768.0f,
+                         sync, n_sync, data, n_data);
+    }
+}
+
+void wwv_front_end_process_f32(wwv_front_end_t *fe, const float *iq, size_t pairs,
+                               float *sync, size_t *n_sync, float *data, size_t *n_data) {
+    *n_sync = *n_data = 0;
+    for (size_t n = 0; n < pairs; n++) {
+        front_end_sample(fe, iq[2 * n], iq[2 * n + 1], sync, n_sync, data, n_data);
+    }
+}
+
+/*============================================================================
+ * Detector Blocks
+ *============================================================================*/
+
+struct wwv_block {
+    int32_t kind;
+    tick_detector_t *tick;
+    marker_detector_t *marker;
+    bcd_time_detector_t *bcd_time;
+    bcd_freq_detector_t *bcd_freq;
+
+    uint64_t samples;
+
+    wwv_block_event_t *events;
+    size_t head;                /* Oldest event not yet taken */
+    size_t count;
+    size_t capacity;
+};
+
+static wwv_block_event_t *new_event(wwv_block_t *b, int32_t kind) {
+    if (b->count == b->capacity) {
+        size_t cap = b->capacity ? 2 * b->capacity : 64;
+        wwv_block_event_t *grown = (wwv_block_event_t *)realloc(b->events, cap * sizeof(*grown));
+        if (!grown) return NULL;
+        b->events = grown;
+        b->capacity = cap;
+    }
+    wwv_block_event_t *e = &b->events[b->count++];
+    memset(e, 0, sizeof(*e));
+    e->sample = b->samples;
+    e->kind = kind;
+    return e;
+}
+
+static void on_tick(const tick_event_t *event, void *user_data) {
+    wwv_block_event_t *e = new_event((wwv_block_t *)user_data, WWV_EVENT_TICK);
+    if (!e) return;
+    e->number = event->tick_number;
+    e->timestamp_ms = event->timestamp_ms;
+    e->duration_ms = event->duration_ms;
+    e->energy = event->peak_energy;
+    e->baseline = event->noise_floor;
+    e->score = event->corr_ratio;
+    e->interval_ms = event->interval_ms;
+}
+
+static void on_tick_marker(const tick_marker_event_t *event, void *user_data) {
+    wwv_block_event_t *e = new_event((wwv_block_t *)user_data, WWV_EVENT_TICK_MARKER);
+    if (!e) return;
+    e->number = event->marker_number;
+    e->timestamp_ms = event->timestamp_ms;
+    e->duration_ms = event->duration_ms;
+    e->score = event->corr_ratio;
+    e->interval_ms = event->interval_ms;
+}
+
+static void on_marker(const marker_event_t *event, void *user_data) {
+    wwv_block_event_t *e = new_event((wwv_block_t *)user_data, WWV_EVENT_MARKER);
+    if (!e) return;
+    e->number = event->marker_number;
+    e->timestamp_ms = event->timestamp_ms;
+    e->duration_ms = event->duration_ms;
+    e->energy = event->accumulated_energy;
+    e->baseline = event->peak_energy;
+    e->interval_ms = event->since_last_marker_sec * 1000.0f;
+}
+
+static void on_bcd_time(const bcd_time_event_t *event, void *user_data) {
+    wwv_block_event_t *e = new_event((wwv_block_t *)user_data, WWV_EVENT_BCD_TIME);
+    if (!e) return;
+    e->timestamp_ms = event->timestamp_ms;
+    e->duration_ms = event->duration_ms;
+    e->energy = event->peak_energy;
+    e->baseline = event->noise_floor;
+    e->score = event->snr_db;
+}
+
+static void on_bcd_freq(const bcd_freq_event_t *event, void *user_data) {
+    wwv_block_event_t *e = new_event((wwv_block_t *)user_data, WWV_EVENT_BCD_FREQ);
+    if (!e) return;
+    e->timestamp_ms = event->timestamp_ms;
+    e->duration_ms = event->duration_ms;
+    e->energy = event->accumulated_energy;
+    e->baseline = event->baseline_energy;
+    e->score = event->snr_db;
+}
+
+wwv_block_t *wwv_block_create(int32_t kind, int32_t sample_rate, int32_t decimation) {
+    if (decimation < 1) return NULL;
+
+    wwv_block_t *b = (wwv_block_t *)calloc(1, sizeof(*b));
+    if (!b) return NULL;
+    b->kind = kind;
+
+    switch (kind) {
+        case WWV_BLOCK_TICK:
+            if (decimation != 1) break;
+            b->tick = tick_detector_create_rate(NULL, sample_rate);
+            if (!b->tick) break;
+            tick_detector_set_callback(b->tick, on_tick, b);
+            tick_detector_set_marker_callback(b->tick, on_tick_marker, b);
+            return b;
+
+        case WWV_BLOCK_MARKER:
+            if (sample_rate != WWV_DETECTOR_RATE || decimation != 1) break;
+            b->marker = marker_detector_create(NULL);
+            if (!b->marker) break;
+            marker_detector_set_callback(b->marker, on_marker, b);
+            return b;
+
+        case WWV_BLOCK_BCD_TIME:
+            b->bcd_time = decimation > 1
+                ? bcd_time_detector_create_subband(NULL, sample_rate, decimation)
+                : bcd_time_detector_create_rate(NULL, sample_rate);
+            if (!b->bcd_time) break;
+            bcd_time_detector_set_callback(b->bcd_time, on_bcd_time, b);
+            return b;
+
+        case WWV_BLOCK_BCD_FREQ:
+            b->bcd_freq = decimation > 1
+                ? bcd_freq_detector_create_subband(NULL, sample_rate, decimation)
+                : bcd_freq_detector_create_rate(NULL, sample_rate);
+            if (!b->bcd_freq) break;
+            bcd_freq_detector_set_callback(b->bcd_freq, on_bcd_freq, b);
+            return b;
+
+        default:
+            break;
+    }
+
+    free(b);
+    return NULL;
+}
+
+void wwv_block_destroy(wwv_block_t *b) {
+    if (!b) return;
+    if (b->tick) tick_detector_destroy(b->tick);
+    if (b->marker) marker_detector_destroy(b->marker);
+    if (b->bcd_time) bcd_time_detector_destroy(b->bcd_time);
+    if (b->bcd_freq) bcd_freq_detector_destroy(b->bcd_freq);
+    free(b->events);
+    free(b);
+}
+
+size_t wwv_block_process(wwv_block_t *b, const float *iq, size_t pairs) {
+    for (size_t n = 0; n < pairs; n++, b->samples++) {
+        float i = iq[2 * n], q = iq[2 * n + 1];
+        switch (b->kind) {
+            case WWV_BLOCK_TICK:     tick_detector_process_sample(b->tick, i, q); break;
+            case WWV_BLOCK_MARKER:   marker_detector_process_sample(b->marker, i, q); break;
+            case WWV_BLOCK_BCD_TIME: bcd_time_detector_process_sample(b->bcd_time, i, q); break;
+            case WWV_BLOCK_BCD_FREQ: bcd_freq_detector_process_sample(b->bcd_freq, i, q); break;
+        }
+    }
+    return b->count - b->head;
+}
+
+size_t wwv_block_pending(const wwv_block_t *b) {
+    return b->count - b->head;
+}
+
+size_t wwv_block_take_events(wwv_block_t *b, wwv_block_event_t *out, size_t max) {
+    size_t n = b->count - b->head;
+    if (n > max) n = max;
+    if (n > 0) memcpy(out, b->events + b->head, n * sizeof(*out));
+    b->head += n;
+    if (b->head == b->count) b->head = b->count = 0;
+    return n;
+}
+
+uint64_t wwv_block_samples(const wwv_block_t *b) {
+    return b->samples;
+}
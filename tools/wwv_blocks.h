@@ -0,0 +1,173 @@
+/**
+ * @file wwv_blocks.h
+ * @brief Block-processing wrappers around the WWV detectors (stable C ABI)
+ *
+ * The detectors take one sample per call and report through callbacks.
+ * These wrappers take buffers and hand back fixed-layout event records, so
+ * callers that cannot take callbacks cheaply - the Python bindings in
+ * python/phoenix_sdr, iqr_detect - drive them with a few calls per block.
+ *
+ *   int16 or float I/Q at the recording rate
+ *     -> wwv_front_end: waterfall detector path (5 kHz lowpass, decimate to
+ *        50 kHz, block slow AGC, channel bank)
+ *     -> sync channel (800-1400 Hz, 50 kHz)  -> tick, marker blocks
+ *     -> data channel (0-150 Hz, 50 kHz / 32) -> bcd_time, bcd_freq blocks
+ *
+ * Output does not depend on how the input is split into calls: the AGC
+ * runs on fixed stages of WWV_FRONT_END_STAGE samples, as in waterfall,
+ * and each detector sees the same sample sequence either way.
+ *
+ * Everything here uses fixed-width types and plain structs so the layout
+ * can be declared from another language without a C compiler; a change to
+ * wwv_block_event_t or a signature below is an ABI change
+ * (WWV_BLOCKS_ABI_VERSION).
+ */
+
+#ifndef WWV_BLOCKS_H
+#define WWV_BLOCKS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+#define WWV_BLOCKS_ABI_VERSION      1
+
+#define WWV_DETECTOR_RATE           50000       /* waterfall DETECTOR_SAMPLE_RATE */
+#define WWV_DETECTOR_CUTOFF         5000.0f     /* waterfall DETECTOR_FILTER_CUTOFF */
+#define WWV_DATA_DECIMATION         32          /* waterfall BCD_SUBBAND_DECIMATION */
+#define WWV_FRONT_END_STAGE         256         /* waterfall DETECTOR_STAGE_SAMPLES */
+
+/* Front end channels */
+#define WWV_CHANNEL_SYNC            0           /* Ticks / markers, 50 kHz */
+#define WWV_CHANNEL_DATA            1           /* BCD subcarrier, 1562.5 Hz */
+
+/* Detector kinds (wwv_block_create) */
+#define WWV_BLOCK_TICK              0
+#define WWV_BLOCK_MARKER            1
+#define WWV_BLOCK_BCD_TIME          2
+#define WWV_BLOCK_BCD_FREQ          3
+
+/* Event kinds (wwv_block_event_t.kind); a tick block reports both */
+#define WWV_EVENT_TICK              0
+#define WWV_EVENT_TICK_MARKER       1
+#define WWV_EVENT_MARKER            2
+#define WWV_EVENT_BCD_TIME          3
+#define WWV_EVENT_BCD_FREQ          4
+
+/*============================================================================
+ * Types
+ *============================================================================*/
+
+typedef struct wwv_front_end wwv_front_end_t;
+typedef struct wwv_block wwv_block_t;
+
+/**
+ * One detector event (40 bytes, no padding)
+ *
+ *   field        TICK          TICK_MARKER   MARKER           BCD_TIME     BCD_FREQ
+ *   number       tick_number   marker_number marker_number    0            0
+ *   timestamp_ms timestamp_ms  timestamp_ms  timestamp_ms     pulse start  pulse start
+ *   duration_ms  duration_ms   duration_ms   duration_ms      duration_ms  duration_ms
+ *   energy       peak_energy   0             accumulated      peak_energy  accumulated
+ *   baseline     noise_floor   0             peak_energy      noise_floor  baseline
+ *   score        corr_ratio    corr_ratio    0                snr_db       snr_db
+ *   interval_ms  interval_ms   interval_ms   since_last * 1000 0           0
+ */
+typedef struct {
+    uint64_t sample;            /* Block input sample being processed when it fired */
+    int32_t  kind;              /* WWV_EVENT_* */
+    int32_t  number;
+    float    timestamp_ms;
+    float    duration_ms;
+    float    energy;
+    float    baseline;
+    float    score;
+    float    interval_ms;
+} wwv_block_event_t;
+
+_Static_assert(sizeof(wwv_block_event_t) == 40, "wwv_block_event_t must be 40 bytes");
+
+/*============================================================================
+ * Front End
+ *============================================================================*/
+
+int32_t wwv_blocks_abi_version(void);
+
+/**
+ * Create the detector path for an input rate
+ * @param input_rate  Hz, a multiple of WWV_DETECTOR_RATE
+ * @return NULL on a bad rate or allocation failure
+ */
+wwv_front_end_t *wwv_front_end_create(int32_t input_rate);
+void wwv_front_end_destroy(wwv_front_end_t *fe);
+
+/** Back to the state after create (new recording) */
+void wwv_front_end_reset(wwv_front_end_t *fe);
+
+/**
+ * Most output pairs one call with `pairs` inputs can produce on a channel;
+ * size the sync / data buffers with this
+ */
+size_t wwv_front_end_max_output(const wwv_front_end_t *fe, int32_t channel, size_t pairs);
+
+/**
+ * Run interleaved I/Q through the detector path
+ * @param iq      int16 pairs (scaled by 1/32768, as waterfall does)
+ * @param sync    Receives sync-channel pairs (interleaved float)
+ * @param n_sync  Receives the number written
+ * @param data    Receives data-channel pairs
+ * @param n_data  Receives the number written
+ */
+void wwv_front_end_process_s16(wwv_front_end_t *fe, const int16_t *iq, size_t pairs,
+                               float *sync, size_t *n_sync, float *data, size_t *n_data);
+
+/** Same for float pairs, full scale 1.0 */
+void wwv_front_end_process_f32(wwv_front_end_t *fe, const float *iq, size_t pairs,
+                               float *sync, size_t *n_sync, float *data, size_t *n_data);
+
+/*============================================================================
+ * Detector Blocks
+ *============================================================================*/
+
+/**
+ * Create a detector block
+ * @param kind         WWV_BLOCK_*
+ * @param sample_rate  Full channel rate (WWV_DETECTOR_RATE for the front end's channels)
+ * @param decimation   Input is every decimation-th sample of the channel:
+ *                     1 for tick/marker, WWV_DATA_DECIMATION (or 1) for BCD
+ * @return NULL if the detector does not support that rate / decimation
+ *         (marker_detector is fixed at 50 kHz, undecimated)
+ */
+wwv_block_t *wwv_block_create(int32_t kind, int32_t sample_rate, int32_t decimation);
+void wwv_block_destroy(wwv_block_t *b);
+
+/**
+ * Feed interleaved float pairs
+ * @return Events waiting (from this and earlier calls)
+ */
+size_t wwv_block_process(wwv_block_t *b, const float *iq, size_t pairs);
+
+/** Events waiting to be taken */
+size_t wwv_block_pending(const wwv_block_t *b);
+
+/**
+ * Move up to max waiting events into out, oldest first
+ * @return Events written
+ */
+size_t wwv_block_take_events(wwv_block_t *b, wwv_block_event_t *out, size_t max);
+
+/** Input pairs fed since create */
+uint64_t wwv_block_samples(const wwv_block_t *b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WWV_BLOCKS_H */
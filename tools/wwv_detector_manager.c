@@ -16,6 +16,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 /*============================================================================
  * Internal State
@@ -59,9 +60,22 @@ static void on_tick_event(const tick_event_t *event, void *user_data) {
     
     /* Feed correlator */
     if (mgr->tick_correlator) {
-        tick_correlator_add_tick(mgr->tick_correlator, 
+        time_t now = time(NULL);
+        char time_str[16];
+        strftime(time_str, sizeof(time_str), "%H:%M:%S", localtime(&now));
+        
+        tick_correlator_add_tick(mgr->tick_correlator,
+                                  time_str,
                                   event->timestamp_ms,
-                                  event->duration_ms);
+                                  event->tick_number,
+                                  "TICK",
+                                  event->peak_energy,
+                                  event->duration_ms,
+                                  event->interval_ms,
+                                  event->avg_interval_ms,
+                                  event->noise_floor,
+                                  event->corr_peak,
+                                  event->corr_ratio);
     }
     
     /* Forward to external callback */
@@ -138,20 +152,30 @@ wwv_detector_manager_t *wwv_detector_manager_create(const wwv_detector_config_t
     if (!mgr) return NULL;
     
     char path[512];
+    int detector_rate = config->detector_sample_rate > 0 ?
+                        config->detector_sample_rate : TICK_SAMPLE_RATE;
+    int display_rate = config->display_sample_rate > 0 ?
+                       config->display_sample_rate : TONE_SAMPLE_RATE;
+    int display_fft = config->display_fft_size > 0 ?
+                      config->display_fft_size : SLOW_MARKER_FFT_SIZE;
     
-    printf("\n[DETECTOR_MGR] Creating WWV detector manager...\n");
+    printf("\n[DETECTOR_MGR] Creating WWV detector manager (%d Hz / %d Hz)...\n",
+           detector_rate, display_rate);
     
     /* Detector path components */
     if (config->enable_tick_detector) {
         snprintf(path, sizeof(path), "%s/wwv_ticks.csv", config->output_dir);
-        mgr->tick_detector = tick_detector_create(path);
+        mgr->tick_detector = tick_detector_create_rate(path, detector_rate);
         if (mgr->tick_detector) {
             tick_detector_set_callback(mgr->tick_detector, on_tick_event, mgr);
             tick_detector_set_marker_callback(mgr->tick_detector, on_tick_marker_event, mgr);
         }
     }
     
-    if (config->enable_marker_detector) {
+    if (config->enable_marker_detector && detector_rate != MARKER_SAMPLE_RATE) {
+        printf("[DETECTOR_MGR] marker_detector needs %d Hz input, skipped at %d Hz\n",
+               MARKER_SAMPLE_RATE, detector_rate);
+    } else if (config->enable_marker_detector) {
         snprintf(path, sizeof(path), "%s/wwv_markers.csv", config->output_dir);
         mgr->marker_detector = marker_detector_create(path);
         if (mgr->marker_detector) {
@@ -176,17 +200,17 @@ wwv_detector_manager_t *wwv_detector_manager_create(const wwv_detector_config_t
     /* Display path components */
     if (config->enable_tone_trackers) {
         snprintf(path, sizeof(path), "%s/wwv_carrier.csv", config->output_dir);
-        mgr->tone_carrier = tone_tracker_create(0.0f, path);
+        mgr->tone_carrier = tone_tracker_create_rate(0.0f, path, display_rate);
         
         snprintf(path, sizeof(path), "%s/wwv_tone_500.csv", config->output_dir);
-        mgr->tone_500 = tone_tracker_create(500.0f, path);
+        mgr->tone_500 = tone_tracker_create_rate(500.0f, path, display_rate);
         
         snprintf(path, sizeof(path), "%s/wwv_tone_600.csv", config->output_dir);
-        mgr->tone_600 = tone_tracker_create(600.0f, path);
+        mgr->tone_600 = tone_tracker_create_rate(600.0f, path, display_rate);
     }
     
     if (config->enable_slow_marker) {
-        mgr->slow_marker = slow_marker_detector_create();
+        mgr->slow_marker = slow_marker_detector_create_rate(display_rate, display_fft);
         if (mgr->slow_marker) {
             slow_marker_detector_set_callback(mgr->slow_marker, on_slow_marker_frame, mgr);
         }
@@ -303,9 +327,16 @@ wwv_sync_status_t wwv_detector_manager_get_sync_status(wwv_detector_manager_t *m
     wwv_sync_status_t status = {0};
     
     if (mgr && mgr->sync_detector) {
-        status.is_synced = sync_detector_is_synced(mgr->sync_detector);
-        status.confidence = sync_detector_get_confidence(mgr->sync_detector);
-        status.drift_ppm = sync_detector_get_drift(mgr->sync_detector);
+        status.is_synced = sync_detector_get_state(mgr->sync_detector) == SYNC_LOCKED;
+        status.confidence = (int)(sync_detector_get_confidence(mgr->sync_detector) * 100.0f + 0.5f);
+    }
+    
+    /* Drift of the current tick chain over its length: ms per tick -> ppm */
+    if (mgr && mgr->tick_correlator) {
+        int length = tick_correlator_get_current_chain_length(mgr->tick_correlator);
+        if (length > 1) {
+            status.drift_ppm = tick_correlator_get_current_drift(mgr->tick_correlator) * 1000.0f / (float)(length - 1);
+        }
     }
     
     if (mgr) {
@@ -380,7 +411,12 @@ void wwv_detector_manager_print_stats(wwv_detector_manager_t *mgr) {
     }
     
     if (mgr->sync_detector) {
-        sync_detector_print_stats(mgr->sync_detector);
+        static const char *names[] = { "ACQUIRING", "TENTATIVE", "LOCKED", "RECOVERING" };
+        sync_state_t state = sync_detector_get_state(mgr->sync_detector);
+        printf("Sync: %s, confidence %.2f, %d confirmed markers\n",
+               (unsigned)state < sizeof(names) / sizeof(names[0]) ? names[state] : "?",
+               sync_detector_get_confidence(mgr->sync_detector),
+               sync_detector_get_confirmed_count(mgr->sync_detector));
     }
     
     printf("================================================================================\n");
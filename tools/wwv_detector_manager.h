@@ -54,6 +54,13 @@ typedef struct {
     bool enable_tone_trackers;
     bool enable_correlators;
     bool enable_slow_marker;        /* Display-path marker verification */
+
+    /* Input rates (0 = default 50 kHz / 12 kHz). Tick detector and tone
+     * trackers size their FFTs for the rate given; marker_detector is
+     * fixed at 50 kHz and is skipped on any other detector rate. */
+    int detector_sample_rate;
+    int display_sample_rate;
+    int display_fft_size;           /* Caller's display FFT (0 = 2048) */
 } wwv_detector_config_t;
 
 /* Default config - all enabled */
@@ -64,7 +71,10 @@ typedef struct {
     .enable_sync_detector = true, \
     .enable_tone_trackers = true, \
     .enable_correlators = true, \
-    .enable_slow_marker = true \
+    .enable_slow_marker = true, \
+    .detector_sample_rate = 0, \
+    .display_sample_rate = 0, \
+    .display_fft_size = 0 \
 }
 
 /*============================================================================
@@ -122,14 +132,14 @@ void wwv_detector_manager_destroy(wwv_detector_manager_t *mgr);
  *============================================================================*/
 
 /**
- * Process detector-path I/Q sample (50 kHz)
+ * Process detector-path I/Q sample (50 kHz, or config detector_sample_rate)
  * Feeds: tick_detector, marker_detector
  */
 void wwv_detector_manager_process_detector_sample(wwv_detector_manager_t *mgr,
                                                    float i_sample, float q_sample);
 
 /**
- * Process display-path I/Q sample (12 kHz)
+ * Process display-path I/Q sample (12 kHz, or config display_sample_rate)
  * Feeds: tone_trackers
  */
 void wwv_detector_manager_process_display_sample(wwv_detector_manager_t *mgr,